@@ -64,6 +64,14 @@
  */
 #define COMMUNICATION_PROTOCOL RAW_SERIAL
 
+/* Socket serial buffers (ESP3DLIB_ENV with SOCKET_SERIAL only)
+ * Ring sizes must be a power of 2, complete lines are sent at once,
+ * data without end of line is sent after S2S_FLUSHTIMEOUT (ms)
+ */
+// #define S2S_TX_RING_SIZE 4096
+// #define S2S_RX_RING_SIZE 1024
+// #define S2S_FLUSHTIMEOUT 20
+
 /* Main Serial port / Ouptut 
  * which serial ESP use to communicate to printer (ESP32 has 3 serials
  * available, ESP8266 only 2) USE_SERIAL_0 //for ESP8266/32, also used by
@@ -123,6 +131,11 @@
  */
 #define WIFI_FEATURE
 
+/* WiFi scan
+ * Scan results are reused during this time (ms) before a new scan
+ */
+// #define ESP3D_WIFI_SCAN_TTL 30000
+
 /* Enable APSTA mode
  * Allows simultaneous AP and STA operation (mode 6)
  */
@@ -173,6 +186,12 @@
  */
 //#define BLUETOOTH_FEATURE
 
+/* Bluetooth buffers
+ * Receive ring (power of 2) and send buffer sizes
+ */
+// #define ESP3D_BT_RX_RING_SIZE 1024
+// #define ESP3D_BT_TX_BUFFER_SIZE 512
+
 /************************************
  *
  * Channels of ESP3D
@@ -195,6 +214,14 @@
  */
 #define DISABLE_TELNET_WELCOME_MESSAGE
 
+/* Telnet sessions
+ * Number of simultaneous telnet clients (max 8)
+ * Size of the output ring shared by the clients (power of 2), a client
+ * lagging more than this behind is disconnected
+ */
+// #define ESP3D_TELNET_MAX_CLIENTS 3
+// #define ESP3D_TELNET_TX_RING_SIZE 4096
+
 /* Use Websocket server
  * Enable websocket communications
  */
@@ -232,6 +259,12 @@
  */
 #define MDNS_FEATURE
 
+/* mDNS discovery cache
+ * Other ESP3D kept and time between 2 discoveries (ms)
+ */
+// #define ESP3D_MDNS_MAX_PEERS 16
+// #define ESP3D_MDNS_REFRESH_INTERVAL 60000
+
 /* Use Simple Service Discovery Protocol
  * It is supported on Windows out of the box
  */
@@ -355,6 +388,18 @@
  */
 // #define ESP_FLAG_SHARED_SD_VALUE 0
 
+/* SD shared lease idle time
+ * Time in ms the SD card stays on ESP side after last access,
+ * so a burst of accesses does not remount the card each time
+ * 0 gives the card back to the printer immediately
+ */
+// #define ESP_SD_LEASE_IDLE_TIME 2000
+
+/* SD upload write buffer (bytes)
+ * Must be a multiple of 512, uploads are written to card by blocks of this size
+ */
+// #define ESP_SD_WRITE_BUFFER_SIZE 4096
+
 /* SD card CS pin
  * The pin used to select SD card in SPI mode
  */
@@ -527,6 +572,13 @@
  */
 // #define SENSOR__UNIT "C"
 
+/* Sensor history
+ * Entries kept of samples, of 1 minute and of 15 minutes min/avg/max
+ */
+// #define ESP3D_SENSOR_HISTORY_RAW_SIZE 180
+// #define ESP3D_SENSOR_HISTORY_MINUTE_SIZE 60
+// #define ESP3D_SENSOR_HISTORY_QUARTER_SIZE 96
+
 /************************************
  *
  * Camera settings
@@ -622,6 +674,12 @@
  */
 //#define ESP_LUA_INTERPRETER_FEATURE
 
+/* Lua memory pool size (bytes)
+ * Scripts cannot use more, pool is in PSRAM if available
+ * 0 = scripts use system heap
+ */
+// #define ESP_LUA_ARENA_SIZE 65536
+
 /* Hook when got IP
  * Commands to run on event
  * Separate commands with ';'
@@ -639,6 +697,74 @@
  */
 #define GCODE_HOST_FEATURE
 
+/* Printer state Feature
+ * Parse printer answers to keep temperatures, position and progress
+ * and query printer at regular interval, clients use [ESP230] or /state
+ */
+// #define PRINTER_STATE_FEATURE
+
+/* Printer state query interval
+ * Time between 2 queries sent to printer (ms), 0 to disable
+ */
+// #define ESP3D_PRINTER_STATE_INTERVAL 3000
+
+/* G-code minifier Feature
+ * Commands streamed by G-code host are sent without comments, spaces and
+ * useless zeros, lines with string parameters are kept as they are
+ */
+// #define GCODE_MINIFIER_FEATURE
+
+/* G-code minifier modal motion
+ * Also drop G0/G1 when same as previous motion line, Grbl and grblHAL only
+ */
+// #define GCODE_MINIFIER_MODAL_MOTION
+
+/* MeatPack Feature
+ * Files streamed by G-code host are packed (about 2 characters per byte)
+ * when the printer accepts it, Marlin only, needs RAW_SERIAL
+ */
+// #define MEATPACK_FEATURE
+
+/* MeatPack answer timeout
+ * Time to wait for printer to report MeatPack state (ms)
+ */
+// #define ESP3D_MEATPACK_TIMEOUT 2000
+
+/* G-code index Feature
+ * Layers of G-code files are indexed when uploaded (HTTP, FTP, WebDAV)
+ * or with [ESP702], index is saved as <filename>.gidx next to the file
+ * and gives layer progress, ETA and start at layer/offset to G-code host
+ */
+// #define GCODE_INDEX_FEATURE
+
+/* G-code index size
+ * Layers kept in index, more layers are decimated (1 of 2, 1 of 4...)
+ */
+// #define ESP3D_GCODE_INDEX_MAX_LAYERS 1024
+
+/* Print journal Feature
+ * Position and state of G-code host print are recorded on ESP Filesystem
+ * so an interrupted print can be resumed with [ESP703]
+ */
+// #define PRINT_JOURNAL_FEATURE
+
+/* Print journal frequency
+ * A record is written every N acknowledged lines or every N ms
+ */
+// #define ESP3D_PRINT_JOURNAL_LINES 100
+// #define ESP3D_PRINT_JOURNAL_INTERVAL 10000
+
+/* Print queue Feature
+ * Queue of files printed one after the other, managed with [ESP704] and
+ * /queue, next file is opened before current one ends
+ */
+// #define PRINT_QUEUE_FEATURE
+
+/* Print queue size
+ * Number of jobs the queue can hold
+ */
+// #define ESP3D_PRINT_QUEUE_SIZE 16
+
 /* Settings location
  * SETTINGS_IN_EEPROM //ESP8266/ESP32
  * SETTINGS_IN_PREFERENCES //ESP32 only
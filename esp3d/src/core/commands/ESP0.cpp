@@ -103,7 +103,8 @@ const char* help[] = {
 #endif  // SD_DEVICE
 #ifdef SENSOR_DEVICE
     "[ESP210](type=NONE/xxx) (interval=xxxx) - display and read/set SENSOR "
-    "info",
+    "info, HISTORY (since=xxxx) (resolution=raw/1m/15m) - display SENSOR "
+    "history",
 #endif  // SENSOR_DEVICE
 #if defined(PRINTER_HAS_DISPLAY)
     "[ESP212](text) - display (text) to printer screen status",
@@ -115,13 +116,17 @@ const char* help[] = {
 #endif  // DISPLAY_TOUCH_DRIVER
 #endif  // DISPLAY_DEVICE
     "[ESP220] - Show used pins",
+#if defined(PRINTER_STATE_FEATURE)
+    "[ESP230](interval=xxxx) - display printer state / set query interval",
+#endif  // PRINTER_STATE_FEATURE
 #ifdef BUZZER_DEVICE
     "[ESP250]F=(frequency) D=(duration) - play sound on buzzer",
 #endif  // BUZZER_DEVICE
     "[ESP290](delay in ms) - do a pause",
 #if defined(ESP_LUA_INTERPRETER_FEATURE)
     "[ESP300]<filename> - execute Lua script",
-    "[ESP301]action=<PAUSE/RESUME/ABORT> - query and control ESP300 execution",
+    "[ESP301]action=<PAUSE/RESUME/ABORT> gc=<INC/GEN> - query and control "
+    "ESP300 execution",
 #endif  // ESP_LUA_INTERPRETER_FEATURE
     "[ESP400] - display ESP3D settings in JSON",
     "[ESP401]P=(position) T=(type) V=(value) - Set specific setting",
@@ -130,12 +135,13 @@ const char* help[] = {
     "ON, OFF",
 #endif  // SD_UPDATE_FEATURE
 #if defined(WIFI_FEATURE)
-    "[ESP410]display available AP list (limited to 30) in plain/JSON",
+    "[ESP410]<REFRESH> display available AP list (limited to 30) in plain/JSON",
 #endif  // WIFI_FEATURE
     "[ESP420]display ESP3D current status in plain/JSON",
+    "[ESP421](RESET) - display/reset ESP commands statistics in plain/JSON",
     "[ESP444](Cmd) - set ESP3D state (RESET/RESTART)",
 #ifdef MDNS_FEATURE
-    "[ESP450]display ESP3D list on network",
+    "[ESP450](REFRESH) - display ESP3D list on network",
 #endif  // MDNS_FEATURE
 #if defined(AUTHENTICATION_FEATURE)
     "[ESP500]display authentication level",
@@ -154,6 +160,17 @@ const char* help[] = {
     "[ESP700](filename) - read ESP Filesystem file",
     "[ESP701]action=(PAUSE/RESUME/ABORT) - query and control ESP700 stream",
 #endif  // GCODE_HOST_FEATURE
+#if defined(GCODE_INDEX_FEATURE)
+    "[ESP702](filename) (layer=xxx/offset=xxx) - index file / process it from "
+    "layer or offset",
+#endif  // GCODE_INDEX_FEATURE
+#if defined(PRINT_JOURNAL_FEATURE)
+    "[ESP703]action=(RESUME/CLEAR) - query / resume / clear interrupted print",
+#endif  // PRINT_JOURNAL_FEATURE
+#if defined(PRINT_QUEUE_FEATURE)
+    "[ESP704](add=filename priority=xxx) (remove=id) "
+    "(action=PAUSE/RESUME/CLEAR) - list / edit / control print queue",
+#endif  // PRINT_QUEUE_FEATURE
 #if defined(FILESYSTEM_FEATURE)
     "[ESP710]FORMATFS - Format ESP Filesystem",
 #endif  // FILESYSTEM_FEATURE
@@ -174,6 +191,8 @@ const char* help[] = {
     "[ESP780](path)  - List Global Filesystem",
     "[ESP790](Action)=(path) - rmdir / remove / mkdir / exists / create on "
     "Global Filesystem (path)",
+    "[ESP791](remove/copy/move=(path))(to=(path))(id=(job))(cancel=(job)) - "
+    "background jobs on Global Filesystem",
 #endif  // GLOBAL_FILESYSTEM_FEATURE
     "[ESP800](time=YYYY-MM-DDTHH:mm:ss)(version=3.0.0-a11)(setup=0/1) - "
     "display FW Informations /set time",
@@ -266,6 +285,9 @@ const uint cmdlist[] = {
 #endif  // DISPLAY_TOUCH_DRIVER
 #endif  // DISPLAY_DEVICE
     220,
+#if defined(PRINTER_STATE_FEATURE)
+    230,
+#endif  // PRINTER_STATE_FEATURE
 #ifdef BUZZER_DEVICE
     250,
 #endif  // BUZZER_DEVICE
@@ -280,7 +302,7 @@ const uint cmdlist[] = {
 #if defined(WIFI_FEATURE)
     410,
 #endif  // WIFI_FEATURE
-    420, 444,
+    420, 421, 444,
 #ifdef MDNS_FEATURE
     450,
 #endif  // MDNS_FEATURE
@@ -293,6 +315,15 @@ const uint cmdlist[] = {
 #if defined(GCODE_HOST_FEATURE)
     700, 701,
 #endif  // GCODE_HOST_FEATURE
+#if defined(GCODE_INDEX_FEATURE)
+    702,
+#endif  // GCODE_INDEX_FEATURE
+#if defined(PRINT_JOURNAL_FEATURE)
+    703,
+#endif  // PRINT_JOURNAL_FEATURE
+#if defined(PRINT_QUEUE_FEATURE)
+    704,
+#endif  // PRINT_QUEUE_FEATURE
 #if defined(FILESYSTEM_FEATURE)
     710,
 #endif  // FILESYSTEM_FEATURE
@@ -306,7 +337,7 @@ const uint cmdlist[] = {
     740, 750,
 #endif  // SD_DEVICE
 #if defined(GLOBAL_FILESYSTEM_FEATURE)
-    780, 790,
+    780, 790, 791,
 #endif  // GLOBAL_FILESYSTEM_FEATURE
     800,
 #if COMMUNICATION_PROTOCOL != SOCKET_SERIAL
@@ -349,6 +380,7 @@ void ESP3DCommands::ESP0(int cmd_params_pos, ESP3DMessage* msg) {
     if (!dispatch(msg, "Help corrupted")) {
       esp3d_log_e("Error sending command to clients");
     }
+    esp3d_message_manager.deleteMsg(msg);
     return;
   }
   tmpstr = get_clean_param(msg, cmd_params_pos);
@@ -360,7 +392,9 @@ void ESP3DCommands::ESP0(int cmd_params_pos, ESP3DMessage* msg) {
       tmpstr = "[List of ESP3D commands]\n";
     }
     msg->type = ESP3DMessageType::head;
-    if (!dispatch(msg, tmpstr.c_str())) {
+    bool sent = dispatch(msg, tmpstr.c_str());
+    esp3d_message_manager.deleteMsg(msg);
+    if (!sent) {
       esp3d_log_e("Error sending command to clients");
       return;
     }
@@ -416,8 +450,9 @@ void ESP3DCommands::ESP0(int cmd_params_pos, ESP3DMessage* msg) {
         }
         msg->type = ESP3DMessageType::unique;
         if (!dispatch(msg, tmpstr.c_str())) {
-          return;
+          esp3d_log_e("Error sending answer to clients");
         }
+        esp3d_message_manager.deleteMsg(msg);
         return;
       }
     }
@@ -434,7 +469,8 @@ void ESP3DCommands::ESP0(int cmd_params_pos, ESP3DMessage* msg) {
     }
     msg->type = ESP3DMessageType::unique;
     if (!dispatch(msg, tmpstr.c_str())) {
-      return;
+      esp3d_log_e("Error sending answer to clients");
     }
+    esp3d_message_manager.deleteMsg(msg);
   }
 }
\ No newline at end of file
@@ -51,13 +51,6 @@ void ESP3DCommands::ESP102(int cmd_params_pos, ESP3DMessage* msg) {
   bool json = hasTag(msg, cmd_params_pos, "json");
   String tmpstr;
   uint8_t byteValue = (uint8_t)-1;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   tmpstr = get_clean_param(msg, cmd_params_pos);
   if (tmpstr.length() == 0) {
     byteValue = ESP3DSettings::readByte(static_cast<int>(ESP3DSettingIndex::esp3d_sta_ip_mode));
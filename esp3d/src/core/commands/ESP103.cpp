@@ -48,13 +48,6 @@ void ESP3DCommands::ESP103(int cmd_params_pos, ESP3DMessage* msg) {
       ESP3DSettingIndex::esp3d_sta_mask_value,
       ESP3DSettingIndex::esp3d_sta_gateway_value,
       ESP3DSettingIndex::esp3d_sta_dns_value};
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   tmpstr = get_clean_param(msg, cmd_params_pos);
   if (tmpstr.length() == 0) {
     if (json) {
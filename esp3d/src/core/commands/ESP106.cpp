@@ -39,13 +39,6 @@ void ESP3DCommands::ESP106(int cmd_params_pos, ESP3DMessage* msg) {
   bool clearSetting = hasTag(msg, cmd_params_pos, "NOPASSWORD");
   bool json = hasTag(msg, cmd_params_pos, "json");
   String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   tmpstr = get_clean_param(msg, cmd_params_pos);
   if (tmpstr.length() == 0) {
     hasError = true;
@@ -40,13 +40,6 @@ void ESP3DCommands::ESP111(int cmd_params_pos, ESP3DMessage* msg) {
   bool respjson = json;
   bool showAll = hasTag(msg, cmd_params_pos, "ALL");
   String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   tmpstr = get_param(msg, cmd_params_pos, "OUTPUT=");
   if (tmpstr == "PRINTER") {
     msg->target = ESP3DClientType::remote_screen;
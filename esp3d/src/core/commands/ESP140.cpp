@@ -51,13 +51,6 @@ void ESP3DCommands::ESP140(int cmd_params_pos, ESP3DMessage* msg) {
       ESP3DSettingIndex::esp3d_internet_time,
       (ESP3DSettingIndex)-1,
   };
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   tmpstr = get_clean_param(msg, cmd_params_pos);
   if (tmpstr.length() == 0) {
     if (json) {
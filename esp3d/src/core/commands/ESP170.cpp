@@ -73,12 +73,6 @@ void ESP3DCommands::ESP170(int cmd_params_pos, ESP3DMessage* msg) {
   bool json = hasTag(msg, cmd_params_pos, "json");
   String tmpstr;
 
-#ifdef AUTHENTICATION_FEATURE
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   if (!esp3d_camera.started()) {
     hasError = true;
     error_msg = "No camera initialized";
@@ -46,13 +46,6 @@ void ESP3DCommands::ESP171(int cmd_params_pos, ESP3DMessage* msg) {
   String tmpstr;
   bool json = hasTag(msg, cmd_params_pos, "json");
 
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   if (!esp3d_camera.started()) {
     hasError = true;
     error_msg = "No camera initialized";
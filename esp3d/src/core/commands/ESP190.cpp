@@ -42,13 +42,6 @@ void ESP3DCommands::ESP190(int cmd_params_pos, ESP3DMessage* msg) {
   bool stateOFF = hasTag(msg, cmd_params_pos, "OFF");
   bool has_param = false;
   String tmpstr;
-#ifdef AUTHENTICATION_FEATURE
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   tmpstr = get_clean_param(msg, cmd_params_pos);
   ESP3DState setting_mode = (ESP3DState)ESP3DSettings::readByte(static_cast<int>(ESP3DSettingIndex::esp3d_webdav_on));
   if (tmpstr.length() == 0) {
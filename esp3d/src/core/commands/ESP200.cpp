@@ -40,13 +40,6 @@ void ESP3DCommands::ESP200(int cmd_params_pos, ESP3DMessage* msg) {
   bool refreshsd = hasTag(msg, cmd_params_pos, "REFRESH");
   bool json = hasTag(msg, cmd_params_pos, "json");
   String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   if (releasesd) {
     ESP_SD::releaseFS();
     ok_msg = "SD card released";
@@ -68,13 +68,6 @@ void ESP3DCommands::ESP201(int cmd_params_pos, ESP3DMessage* msg) {
     isANALOG = false;  // default value
   }
   bool json = hasTag(msg, cmd_params_pos, "json");
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   if (P.length() == 0) {
     hasError = true;
     error_msg = "Missing pin";
@@ -39,13 +39,6 @@ void ESP3DCommands::ESP202(int cmd_params_pos, ESP3DMessage* msg) {
   String speed = get_param(msg, cmd_params_pos, "SPEED=");
   bool json = hasTag(msg, cmd_params_pos, "json");
   String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
 
   if (speed.length() == 0) {  // Get
     esp3d_log("Reading SD speed divider");
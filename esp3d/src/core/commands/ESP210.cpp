@@ -22,18 +22,20 @@
 #include "../../modules/authentication/authentication_service.h"
 #include "../../modules/sensor/sensor.h"
 #include "../esp3d_commands.h"
+#include "../esp3d_json_writer.h"
 #include "../esp3d_settings.h"
 
 #define COMMAND_ID 210
 // Get Sensor Value / type/Set Sensor type
 //[ESP210]<type=NONE/xxx> <interval=XXX in millisec> json=<no> pwd=<admin
 // password>
+// Get Sensor history
+//[ESP210]HISTORY <since=XXX in millisec> <resolution=raw/1m/15m> json=<no>
+// pwd=<user password>
 void ESP3DCommands::ESP210(int cmd_params_pos, ESP3DMessage* msg) {
   ESP3DClientType target = msg->origin;
   ESP3DRequest requestId = msg->request_id;
-  (void)requestId;
   msg->target = target;
-  msg->origin = ESP3DClientType::command;
   bool hasError = false;
   String error_msg = "Invalid parameters";
   String ok_msg = "ok";
@@ -41,13 +43,36 @@ void ESP3DCommands::ESP210(int cmd_params_pos, ESP3DMessage* msg) {
   String sint = get_param(msg, cmd_params_pos, "interval=");
   bool json = hasTag(msg, cmd_params_pos, "json");
   String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
+  if (hasTag(msg, cmd_params_pos, "HISTORY")) {
+    ESP3DSensorResolution resolution;
+    String since = get_param(msg, cmd_params_pos, "since=");
+    if (!ESP3DSensorHistory::getResolution(
+            get_param(msg, cmd_params_pos, "resolution="), resolution)) {
+      dispatchAnswer(msg, COMMAND_ID, json, false, "Invalid resolution");
+      esp3d_message_manager.deleteMsg(msg);
+      return;
+    }
+    // Answer is streamed, history can be bigger than any buffer
+    ESP3DSensorCursor cursor;
+    esp3d_sensor.history().initCursor(cursor, resolution,
+                                      strtoul(since.c_str(), nullptr, 10),
+                                      json);
+    ESP3DJsonWriter writer(target, requestId, msg->authentication_level,
+                           json);
+    char buffer[128];
+    size_t len;
+    while (!writer.hasError() &&
+           (len = esp3d_sensor.history().read(cursor, buffer,
+                                              sizeof(buffer) - 1)) > 0) {
+      buffer[len] = '\0';
+      writer.write(buffer);
+    }
+    if (!writer.end()) {
+      esp3d_log_e("Error sending response to clients");
+    }
+    esp3d_message_manager.deleteMsg(msg);
     return;
   }
-#endif                                              // AUTHENTICATION_FEATURE
   if (stype.length() == 0 && sint.length() == 0) {  // Get
     String s;
     if (json) {
@@ -80,6 +105,7 @@ void ESP3DCommands::ESP210(int cmd_params_pos, ESP3DMessage* msg) {
 #if defined(AUTHENTICATION_FEATURE)
     if (msg->authentication_level != ESP3DAuthenticationLevel::admin) {
       dispatchAuthenticationError(msg, COMMAND_ID, json);
+      esp3d_message_manager.deleteMsg(msg);
       return;
     }
 #endif  // AUTHENTICATION_FEATURE
@@ -126,9 +152,10 @@ void ESP3DCommands::ESP210(int cmd_params_pos, ESP3DMessage* msg) {
       }
     }
   }
-  if (!dispatchAnswer(msg, COMMAND_ID, json, hasError,
+  if (!dispatchAnswer(msg, COMMAND_ID, json, !hasError,
                       hasError ? error_msg.c_str() : ok_msg.c_str())) {
     esp3d_log_e("Error sending response to clients");
   }
+  esp3d_message_manager.deleteMsg(msg);
 }
 #endif  // SENSOR_DEVICE
@@ -37,13 +37,6 @@ void ESP3DCommands::ESP220(int cmd_params_pos, ESP3DMessage* msg) {
   String error_msg = "Invalid parameters";
   String ok_msg = "ok";
   bool json = hasTag(msg, cmd_params_pos, "json");
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   String tmpstr = get_clean_param(msg, cmd_params_pos);
   if (tmpstr.length() != 0) {
     hasError = true;
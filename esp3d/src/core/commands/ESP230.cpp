@@ -0,0 +1,66 @@
+/*
+ ESP230.cpp - ESP3D command class
+
+ Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with This code; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "../../include/esp3d_config.h"
+#if defined(PRINTER_STATE_FEATURE)
+#include "../../modules/authentication/authentication_service.h"
+#include "../../modules/printer_state/printer_state.h"
+#include "../esp3d_commands.h"
+#include "../esp3d_settings.h"
+
+#define COMMAND_ID 230
+
+// Get printer state (temperatures, position, progress) from cache
+// so clients do not need to query the printer themselves
+// Set interval between 2 queries sent to printer, 0 to disable
+//[ESP230]<interval=XXX in millisec> json=<no> pwd=<user/admin password>
+void ESP3DCommands::ESP230(int cmd_params_pos, ESP3DMessage* msg) {
+  ESP3DClientType target = msg->origin;
+  msg->target = target;
+  msg->origin = ESP3DClientType::command;
+  bool hasError = false;
+  String error_msg = "Invalid parameters";
+  String ok_msg = "ok";
+  bool json = hasTag(msg, cmd_params_pos, "json");
+  String sint = get_param(msg, cmd_params_pos, "interval=");
+  if (sint.length() == 0) {  // Get
+    ok_msg = esp3d_printer_state.toString(json);
+  } else {
+#if defined(AUTHENTICATION_FEATURE)
+    if (msg->authentication_level != ESP3DAuthenticationLevel::admin) {
+      dispatchAuthenticationError(msg, COMMAND_ID, json);
+      return;
+    }
+#endif  // AUTHENTICATION_FEATURE
+    char* end;
+    uint32_t interval = strtoul(sint.c_str(), &end, 10);
+    if (*end != '\0') {
+      hasError = true;
+      error_msg = "Invalid interval";
+      esp3d_log_e("%s", error_msg.c_str());
+    } else {
+      esp3d_printer_state.setInterval(interval);
+    }
+  }
+  if (!dispatchAnswer(msg, COMMAND_ID, json, hasError,
+                      hasError ? error_msg.c_str() : ok_msg.c_str())) {
+    esp3d_log_e("Error sending response to clients");
+  }
+}
+#endif  // PRINTER_STATE_FEATURE
@@ -48,13 +48,6 @@ void ESP3DCommands::ESP250(int cmd_params_pos, ESP3DMessage* msg) {
   }
   bool json = hasTag(msg, cmd_params_pos, "json");
   String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
 
   if (freq == -1 && duration == 0) {
     esp3d_buzzer.beep();
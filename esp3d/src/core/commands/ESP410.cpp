@@ -21,6 +21,7 @@
 #if defined(WIFI_FEATURE)
 #include "../../modules/authentication/authentication_service.h"
 #include "../../modules/wifi/wificonfig.h"
+#include "../../modules/wifi/wifiscan.h"
 #include "../esp3d_commands.h"
 #include "../esp3d_settings.h"
 #include "../esp3d_string.h"
@@ -31,8 +32,6 @@
 void ESP3DCommands::ESP410(int cmd_params_pos, ESP3DMessage* msg) {
   ESP3DClientType target = msg->origin;
   ESP3DRequest requestId = msg->request_id;
-  msg->target = target;
-  msg->origin = ESP3DClientType::command;
 
   bool hasError = false;
   String error_msg = "Invalid parameters";
@@ -42,160 +41,138 @@ void ESP3DCommands::ESP410(int cmd_params_pos, ESP3DMessage* msg) {
 
   esp3d_log("Processing [ESP410] command, json=%d", json);
 
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    esp3d_log_e("Authentication error for [ESP410]");
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif
-
+  bool refresh = hasTag(msg, cmd_params_pos, "REFRESH");
   tmpstr = get_clean_param(msg, cmd_params_pos);
-  if (tmpstr.length() != 0) {
-    hasError = true;
-    error_msg = "This command doesn't take parameters";
-    esp3d_log_e("%s", error_msg.c_str());
-    if (!dispatchAnswer(msg, COMMAND_ID, json, hasError, error_msg.c_str())) {
-      esp3d_log_e("Error sending response to clients");
-    }
-    return;
-  }
-
   WiFiMode_t currentMode = WiFi.getMode();
   esp3d_log("Current WiFi mode: %d (%s)", currentMode,
             currentMode == WIFI_STA ? "STA" :
             currentMode == WIFI_AP ? "AP" :
             currentMode == WIFI_AP_STA ? "AP_STA" : "OFF");
-
-  if (currentMode == WIFI_STA || currentMode == WIFI_AP || currentMode == WIFI_AP_STA) {
-    int n = 0;
-    uint8_t total = 0;
-    String configuredSSID = ESP3DSettings::readString(static_cast<int>(ESP3DSettingIndex::esp3d_sta_ssid));
-    bool ssidFound = false;
-
-    tmpstr = json ? "{\"cmd\":\"410\",\"status\":\"ok\",\"data\":[" : "Start Scan\n";
-    msg->type = ESP3DMessageType::head;
-    esp3d_log("Sending scan header: %s", tmpstr.c_str());
-    if (!dispatch(msg, tmpstr.c_str(), target, requestId, ESP3DMessageType::head, msg->authentication_level)) {
-      esp3d_log_e("Error sending response header to clients");
+  if (tmpstr.length() != 0 && !refresh) {
+    hasError = true;
+    error_msg = "Invalid parameter";
+  } else if (currentMode != WIFI_STA && currentMode != WIFI_AP &&
+             currentMode != WIFI_AP_STA) {
+    hasError = true;
+    error_msg = "WiFi not enabled";
+  } else if (!refresh && WiFiScan::isValid()) {
+    // Recent results are sent at once
+    esp3d_log("Using WiFi scan results from %d ms ago", WiFiScan::age());
+    dispatchWiFiScan(target, requestId, msg->authentication_level, json);
+    esp3d_message_manager.deleteMsg(msg);
+    return;
+  } else if (target == ESP3DClientType::http) {
+    // Http request is answered only once, so results are waited for as
+    // WebUI does not ask again
+    if (WiFiScan::scan()) {
+      dispatchWiFiScan(target, requestId, msg->authentication_level, json);
+      esp3d_message_manager.deleteMsg(msg);
       return;
     }
+    hasError = true;
+    error_msg = "WiFi scan failed";
+  } else if (!WiFiScan::start()) {
+    hasError = true;
+    error_msg = "WiFi scan failed";
+  } else if (!WiFiScan::addRequest(target, requestId,
+                                   msg->authentication_level, json)) {
+    hasError = true;
+    error_msg = "Too many scan requests";
+  } else {
+    // Other clients get the results when scan is done
+    esp3d_message_manager.deleteMsg(msg);
+    return;
+  }
+  if (hasError) {
+    esp3d_log_e("%s", error_msg.c_str());
+  }
+  if (!dispatchAnswer(msg, COMMAND_ID, json, !hasError,
+                      hasError ? error_msg.c_str() : ok_msg.c_str())) {
+    esp3d_log_e("Error sending response to clients");
+  }
+  esp3d_message_manager.deleteMsg(msg);
+}
 
-    // Switch to AP_STA if needed
-    bool switchedMode = false;
-    if (currentMode == WIFI_AP) {
-      esp3d_log("Switching to WIFI_AP_STA for scanning");
-      if (!WiFi.mode(WIFI_AP_STA)) {
-        hasError = true;
-        error_msg = "Failed to switch to AP_STA mode";
-        esp3d_log_e("%s", error_msg.c_str());
-        if (!dispatchAnswer(msg, COMMAND_ID, json, hasError, error_msg.c_str())) {
-          esp3d_log_e("Error sending mode switch error to clients");
-        }
-        return;
-      }
-      switchedMode = true;
-    }
+bool ESP3DCommands::dispatchWiFiScan(
+    ESP3DClientType target, ESP3DRequest requestId,
+    ESP3DAuthenticationLevel authentication_level, bool json) {
+  String tmpstr;
+  if (WiFiScan::hasFailed()) {
+    ESP3DMessage msg;
+    msg.data = nullptr;
+    msg.size = 0;
+    msg.origin = target;
+    msg.target = target;
+    msg.authentication_level = authentication_level;
+    msg.request_id = requestId;
+    msg.type = ESP3DMessageType::unique;
+    esp3d_log_e("WiFi scan failed");
+    return dispatchAnswer(&msg, COMMAND_ID, json, false, "WiFi scan failed");
+  }
+  String configuredSSID = ESP3DSettings::readString(static_cast<int>(ESP3DSettingIndex::esp3d_sta_ssid));
+  bool ssidFound = false;
+
+  tmpstr = json ? "{\"cmd\":\"410\",\"status\":\"ok\",\"data\":[" : "Start Scan\n";
+  esp3d_log("Sending scan header: %s", tmpstr.c_str());
+  if (!dispatch(nullptr, tmpstr.c_str(), target, requestId, ESP3DMessageType::head, authentication_level)) {
+    esp3d_log_e("Error sending response header to clients");
+    return false;
+  }
 
-    esp3d_log("Starting WiFi scan");
-    n = WiFi.scanNetworks();
-    esp3d_log("Scan completed, found %d networks", n);
-
-    if (n < 0) {
-      hasError = true;
-      error_msg = "WiFi scan failed";
-      esp3d_log_e("%s", error_msg.c_str());
-      if (!dispatchAnswer(msg, COMMAND_ID, json, hasError, error_msg.c_str())) {
-        esp3d_log_e("Error sending scan failure to clients");
-      }
-      if (switchedMode) {
-        esp3d_log("Restoring WiFi mode to AP");
-        WiFi.mode(currentMode);
-      }
-      return;
+  for (uint8_t i = 0; i < WiFiScan::count(); ++i) {
+    const ESP3DWiFiNetwork* network = WiFiScan::network(i);
+    tmpstr = "";
+    if (i > 0 && json) tmpstr += ",";
+
+    if (json) {
+      tmpstr += "{\"SSID\":\"";
+      tmpstr += esp3d_string::encodeString(network->ssid);
+      tmpstr += "\",\"SIGNAL\":\"";
+    } else {
+      tmpstr += network->ssid;
+      tmpstr += "\t";
     }
 
-    for (int i = 0; i < n; ++i) {
-      if (WiFi.RSSI(i) < MIN_RSSI) {
-        esp3d_log("Skipping network %s, RSSI %d < MIN_RSSI %d", WiFi.SSID(i).c_str(), WiFi.RSSI(i), MIN_RSSI);
-        continue;
-      }
-
-      String ssid = WiFi.SSID(i);
-      tmpstr = "";
-      if (total++ > 0 && json) tmpstr += ",";
-
-      if (json) {
-        tmpstr += "{\"SSID\":\"";
-        tmpstr += esp3d_string::encodeString(ssid.c_str());
-        tmpstr += "\",\"SIGNAL\":\"";
-      } else {
-        tmpstr += ssid;
-        tmpstr += "\t";
-      }
-
-      tmpstr += String(WiFiConfig::getSignal(WiFi.RSSI(i)));
-      if (!json) tmpstr += "%";
-
-      if (json) {
-        tmpstr += "\",\"IS_PROTECTED\":\"";
-        tmpstr += (WiFi.encryptionType(i) == ENC_TYPE_NONE) ? "0" : "1";
-        tmpstr += "\"}";
-      } else {
-        tmpstr += (WiFi.encryptionType(i) == ENC_TYPE_NONE) ? "\tOpen\n" : "\tSecure\n";
-      }
-
-      esp3d_log("Network %d: %s, Signal: %s, Protected: %s",
-                i, ssid.c_str(), String(WiFiConfig::getSignal(WiFi.RSSI(i))).c_str(),
-                WiFi.encryptionType(i) == ENC_TYPE_NONE ? "Open" : "Secure");
-
-      if (!dispatch(msg, tmpstr.c_str(), target, requestId, ESP3DMessageType::core, msg->authentication_level)) {
-        esp3d_log_e("Error sending network %d to clients", i);
-      }
-
-      if (ssid == configuredSSID) {
-        ssidFound = true;
-      }
+    tmpstr += String(WiFiConfig::getSignal(network->rssi));
+    if (!json) tmpstr += "%";
+
+    if (json) {
+      tmpstr += "\",\"IS_PROTECTED\":\"";
+      tmpstr += network->isProtected ? "1" : "0";
+      tmpstr += "\"}";
+    } else {
+      tmpstr += network->isProtected ? "\tSecure\n" : "\tOpen\n";
     }
 
-    // Report configured SSID status
-    tmpstr = json ? String("{\"ConfiguredSSID\":\"") + String(esp3d_string::encodeString(configuredSSID.c_str())) + "\"," :
-                    String("Configured SSID: ") + configuredSSID + "\n";
-    tmpstr += json ? "\"Found\":\"" + String(ssidFound ? "yes" : "no") + "\"," :
-                    "Found: " + String(ssidFound ? "yes" : "no") + "\n";
-    tmpstr += json ? "\"Connected\":\"" + String(WiFi.isConnected() ? "yes" : "no") + "\"}" :
-                    "Connected: " + String(WiFi.isConnected() ? "yes" : "no") + "\n";
-    esp3d_log("Configured SSID: %s, Found: %s, Connected: %s",
-              configuredSSID.c_str(), ssidFound ? "yes" : "no", WiFi.isConnected() ? "yes" : "no");
-    if (!dispatch(msg, tmpstr.c_str(), target, requestId, ESP3DMessageType::core, msg->authentication_level)) {
-      esp3d_log_e("Error sending configured SSID status to clients");
+    if (!dispatch(nullptr, tmpstr.c_str(), target, requestId, ESP3DMessageType::core, authentication_level)) {
+      esp3d_log_e("Error sending network %d to clients", i);
     }
 
-    // Restore mode if changed
-    if (switchedMode) {
-      esp3d_log("Restoring WiFi mode to %d", currentMode);
-      if (!WiFi.mode(currentMode)) {
-        esp3d_log_e("Failed to restore WiFi mode to %d", currentMode);
-      }
+    if (configuredSSID == network->ssid) {
+      ssidFound = true;
     }
+  }
 
-    WiFi.scanDelete();
-    esp3d_log("Scan results deleted");
+  // Report configured SSID status
+  tmpstr = json ? String("{\"ConfiguredSSID\":\"") + String(esp3d_string::encodeString(configuredSSID.c_str())) + "\"," :
+                  String("Configured SSID: ") + configuredSSID + "\n";
+  tmpstr += json ? "\"Found\":\"" + String(ssidFound ? "yes" : "no") + "\"," :
+                  "Found: " + String(ssidFound ? "yes" : "no") + "\n";
+  tmpstr += json ? "\"Connected\":\"" + String(WiFi.isConnected() ? "yes" : "no") + "\"}" :
+                  "Connected: " + String(WiFi.isConnected() ? "yes" : "no") + "\n";
+  esp3d_log("Configured SSID: %s, Found: %s, Connected: %s",
+            configuredSSID.c_str(), ssidFound ? "yes" : "no", WiFi.isConnected() ? "yes" : "no");
+  if (!dispatch(nullptr, tmpstr.c_str(), target, requestId, ESP3DMessageType::core, authentication_level)) {
+    esp3d_log_e("Error sending configured SSID status to clients");
+  }
 
-    tmpstr = json ? "]}" : "End Scan\n";
-    esp3d_log("Sending scan footer: %s", tmpstr.c_str());
-    if (!dispatch(msg, tmpstr.c_str(), target, requestId, ESP3DMessageType::tail, msg->authentication_level)) {
-      esp3d_log_e("Error sending scan footer to clients");
-    }
-  } else {
-    hasError = true;
-    error_msg = "WiFi not enabled";
-    esp3d_log_e("%s", error_msg.c_str());
-    if (!dispatchAnswer(msg, COMMAND_ID, json, hasError, error_msg.c_str())) {
-      esp3d_log_e("Error sending WiFi not enabled response to clients");
-    }
+  tmpstr = json ? "]}" : "End Scan\n";
+  esp3d_log("Sending scan footer: %s", tmpstr.c_str());
+  if (!dispatch(nullptr, tmpstr.c_str(), target, requestId, ESP3DMessageType::tail, authentication_level)) {
+    esp3d_log_e("Error sending scan footer to clients");
+    return false;
   }
+  return true;
 }
 
-#endif  // WIFI_FEATURE
\ No newline at end of file
+#endif  // WIFI_FEATURE
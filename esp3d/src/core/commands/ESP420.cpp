@@ -20,6 +20,7 @@
 #include "../../include/esp3d_config.h"
 #include "../../modules/authentication/authentication_service.h"
 #include "../esp3d_commands.h"
+#include "../esp3d_json_writer.h"
 #include "../esp3d_settings.h"
 #include "../esp3d_string.h"
 #include "../../core/esp3d_log.h" // Added for enhanced logging
@@ -90,6 +91,9 @@
 #if defined(USB_SERIAL_FEATURE)
 #include "../../modules/usb-serial/usb_serial_service.h"
 #endif  // USB_SERIAL_FEATURE
+#if COMMUNICATION_PROTOCOL == MKS_SERIAL
+#include "../../modules/mks/mks_service.h"
+#endif  // COMMUNICATION_PROTOCOL == MKS_SERIAL
 
 #define COMMAND_ID 420
 
@@ -108,33 +112,22 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
 
   esp3d_log("Processing [ESP420] command, json=%d, addPreTag=%d", json, addPreTag);
 
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    esp3d_log_e("Authentication error for [ESP420]");
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
-
+  ESP3DJsonWriter writer(target, requestId, msg->authentication_level, json);
+  // Answer is sent by writer, message is not needed anymore
+  esp3d_message_manager.deleteMsg(msg);
   if (json) {
-    tmpstr = "{\"cmd\":\"420\",\"status\":\"ok\",\"data\":[";
+    writer.beginObject();
+    writer.add("cmd", "420");
+    writer.add("status", "ok");
+    writer.beginArray("data");
   } else {
-    if (addPreTag) {
-      tmpstr = "<pre>\n";
-    } else {
-      tmpstr = "Configuration:\n";
-    }
-  }
-  msg->type = ESP3DMessageType::head;
-  if (!dispatch(msg, tmpstr.c_str())) {
-    esp3d_log_e("Error sending response header to clients");
-    return;
+    writer.write(addPreTag ? "<pre>\n" : "Configuration:\n");
   }
 
   // Chip ID
-  tmpstr = ESP3DHal::getChipID();
+  tmpstr = String(ESP3DHal::getChipID());
   esp3d_log("Chip ID: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "chip id", tmpstr.c_str(), target, requestId, true)) {
+  if (!dispatchIdValue(writer, "chip id", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching chip id");
     return;
   }
@@ -142,7 +135,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   // CPU Freq
   tmpstr = String(ESP.getCpuFreqMHz()) + "Mhz";
   esp3d_log("CPU Freq: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "CPU Freq", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "CPU Freq", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching CPU Freq");
     return;
   }
@@ -151,7 +144,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   if (ESP3DHal::has_temperature_sensor()) {
     tmpstr = String(ESP3DHal::temperature(), 1) + "C";
     esp3d_log("CPU Temp: %s", tmpstr.c_str());
-    if (!dispatchIdValue(json, "CPU Temp", tmpstr.c_str(), target, requestId, false)) {
+    if (!dispatchIdValue(writer, "CPU Temp", tmpstr.c_str())) {
       esp3d_log_e("Error dispatching CPU Temp");
       return;
     }
@@ -165,7 +158,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
 #endif  // BOARD_HAS_PSRAM
 #endif  // ARDUINO_ARCH_ESP32
   esp3d_log("Free Memory: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "free mem", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "free mem", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching free mem");
     return;
   }
@@ -176,7 +169,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   tmpstr = String(ESP.getChipModel()) + "-" + String(ESP.getChipRevision()) + "-" + String(ESP.getChipCores()) + "@";
 #endif  // ARDUINO_ARCH_ESP32
   esp3d_log("FW arch: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "FW arch", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "FW arch", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching FW arch");
     return;
   }
@@ -184,7 +177,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   // SDK Version
   tmpstr = ESP.getSdkVersion();
   esp3d_log("SDK Version: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "SDK", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "SDK", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching SDK version");
     return;
   }
@@ -192,7 +185,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   // Arduino Version
   tmpstr = ESP3DHal::arduinoVersion();
   esp3d_log("Arduino Version: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "Arduino", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "Arduino", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching Arduino version");
     return;
   }
@@ -200,7 +193,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   // Flash size
   tmpstr = esp3d_string::formatBytes(ESP.getFlashChipSize());
   esp3d_log("Flash size: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "flash size", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "flash size", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching flash size");
     return;
   }
@@ -209,7 +202,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   // Update space
   tmpstr = esp3d_string::formatBytes(ESP_FileSystem::max_update_size());
   esp3d_log("Size for update: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "size for update", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "size for update", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching size for update");
     return;
   }
@@ -219,14 +212,14 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   // FileSystem type
   tmpstr = ESP_FileSystem::FilesystemName();
   esp3d_log("FS type: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "FS type", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "FS type", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching FS type");
     return;
   }
   // FileSystem capacity
   tmpstr = String(esp3d_string::formatBytes(ESP_FileSystem::usedBytes())) + "/" + String(esp3d_string::formatBytes(ESP_FileSystem::totalBytes()));
   esp3d_log("FS usage: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "FS usage", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "FS usage", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching FS usage");
     return;
   }
@@ -236,14 +229,14 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   tmpstr = (esp3d_commands.getOutputClient() == ESP3DClientType::usb_serial) ? "usb port" : 
            (esp3d_commands.getOutputClient() == ESP3DClientType::serial) ? "serial port" : "???";
   esp3d_log("Output: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "output", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "output", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching output");
     return;
   }
   if (esp3d_commands.getOutputClient() == ESP3DClientType::usb_serial) {
     tmpstr = String(esp3d_usb_serial_service.baudRate());
     esp3d_log("USB Serial Baud: %s", tmpstr.c_str());
-    if (!dispatchIdValue(json, "baud", tmpstr.c_str(), target, requestId, false)) {
+    if (!dispatchIdValue(writer, "baud", tmpstr.c_str())) {
       esp3d_log_e("Error dispatching USB serial baud");
       return;
     }
@@ -251,7 +244,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   if (esp3d_usb_serial_service.isConnected()) {
     tmpstr = esp3d_usb_serial_service.getVIDString() + ":" + esp3d_usb_serial_service.getPIDString();
     esp3d_log("Vid/Pid: %s", tmpstr.c_str());
-    if (!dispatchIdValue(json, "Vid/Pid", tmpstr.c_str(), target, requestId, false)) {
+    if (!dispatchIdValue(writer, "Vid/Pid", tmpstr.c_str())) {
       esp3d_log_e("Error dispatching Vid/Pid");
       return;
     }
@@ -262,19 +255,29 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   if (esp3d_commands.getOutputClient() == ESP3DClientType::serial) {
     tmpstr = String(esp3d_serial_service.baudRate());
     esp3d_log("Serial Baud: %s", tmpstr.c_str());
-    if (!dispatchIdValue(json, "baud", tmpstr.c_str(), target, requestId, false)) {
+    if (!dispatchIdValue(writer, "baud", tmpstr.c_str())) {
       esp3d_log_e("Error dispatching serial baud");
       return;
     }
   }
 #endif  // COMMUNICATION_PROTOCOL == RAW_SERIAL || MKS_SERIAL
 
+#if COMMUNICATION_PROTOCOL == MKS_SERIAL
+  // Last MKS upload speed
+  tmpstr = String(esp3d_string::formatBytes(MKSService::uploadRate())) + "/s";
+  esp3d_log("MKS upload: %s", tmpstr.c_str());
+  if (!dispatchIdValue(writer, "mks upload", tmpstr.c_str())) {
+    esp3d_log_e("Error dispatching MKS upload speed");
+    return;
+  }
+#endif  // COMMUNICATION_PROTOCOL == MKS_SERIAL
+
 #if defined(WIFI_FEATURE)
   if (WiFi.getMode() != WIFI_OFF) {
     // Sleep mode
     tmpstr = WiFiConfig::getSleepModeString();
     esp3d_log("Sleep mode: %s", tmpstr.c_str());
-    if (!dispatchIdValue(json, "sleep mode", tmpstr.c_str(), target, requestId, false)) {
+    if (!dispatchIdValue(writer, "sleep mode", tmpstr.c_str())) {
       esp3d_log_e("Error dispatching sleep mode");
       return;
     }
@@ -285,7 +288,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   // Wifi enabled
   tmpstr = (WiFi.getMode() == WIFI_OFF) ? "OFF" : "ON";
   esp3d_log("WiFi enabled: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "wifi", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "wifi", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching WiFi enabled status");
     return;
   }
@@ -295,7 +298,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   // Ethernet enabled
   tmpstr = (EthConfig::started()) ? "ON" : "OFF";
   esp3d_log("Ethernet enabled: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "ethernet", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "ethernet", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching Ethernet enabled status");
     return;
   }
@@ -305,7 +308,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   // BT enabled
   tmpstr = (bt_service.started()) ? "ON" : "OFF";
   esp3d_log("Bluetooth enabled: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "bt", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "bt", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching Bluetooth enabled status");
     return;
   }
@@ -315,7 +318,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   // Hostname
   tmpstr = NetConfig::hostname();
   esp3d_log("Hostname: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "hostname", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "hostname", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching hostname");
     return;
   }
@@ -329,7 +332,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   tmpstr = "ON";
   #endif  // ARDUINO_ARCH_ESP8266
   esp3d_log("SSDP: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "SSDP", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "SSDP", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching SSDP status");
     return;
   }
@@ -339,7 +342,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   // MDNS enabled
   tmpstr = esp3d_mDNS.started() ? "ON" : "OFF";
   esp3d_log("MDNS: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "MDNS", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "MDNS", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching MDNS status");
     return;
   }
@@ -351,7 +354,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
     // HTTP port
     tmpstr = String(HTTP_Server::port());
     esp3d_log("HTTP port: %s", tmpstr.c_str());
-    if (!dispatchIdValue(json, "HTTP port", tmpstr.c_str(), target, requestId, false)) {
+    if (!dispatchIdValue(writer, "HTTP port", tmpstr.c_str())) {
       esp3d_log_e("Error dispatching HTTP port");
       return;
     }
@@ -360,7 +363,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
     if (WiFi.getMode() == WIFI_AP_STA && WiFi.isConnected()) {
       tmpstr = WiFi.localIP().toString() + ":" + String(HTTP_Server::port());
       esp3d_log("HTTP STA accessibility: %s", tmpstr.c_str());
-      if (!dispatchIdValue(json, "HTTP STA address", tmpstr.c_str(), target, requestId, false)) {
+      if (!dispatchIdValue(writer, "HTTP STA address", tmpstr.c_str())) {
         esp3d_log_e("Error dispatching HTTP STA address");
         return;
       }
@@ -374,7 +377,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
     // Telnet port
     tmpstr = String(telnet_server.port());
     esp3d_log("Telnet port: %s", tmpstr.c_str());
-    if (!dispatchIdValue(json, "Telnet port", tmpstr.c_str(), target, requestId, false)) {
+    if (!dispatchIdValue(writer, "Telnet port", tmpstr.c_str())) {
       esp3d_log_e("Error dispatching Telnet port");
       return;
     }
@@ -383,7 +386,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
     if (WiFi.getMode() == WIFI_AP_STA && WiFi.isConnected()) {
       tmpstr = WiFi.localIP().toString() + ":" + String(telnet_server.port());
       esp3d_log("Telnet STA accessibility: %s", tmpstr.c_str());
-      if (!dispatchIdValue(json, "Telnet STA address", tmpstr.c_str(), target, requestId, false)) {
+      if (!dispatchIdValue(writer, "Telnet STA address", tmpstr.c_str())) {
         esp3d_log_e("Error dispatching Telnet STA address");
         return;
       }
@@ -392,11 +395,21 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
     if (telnet_server.isConnected()) {
       tmpstr = telnet_server.clientIPAddress();
       esp3d_log("Telnet client IP: %s", tmpstr.c_str());
-      if (!dispatchIdValue(json, "Telnet Client", tmpstr.c_str(), target, requestId, false)) {
+      if (!dispatchIdValue(writer, "Telnet Client", tmpstr.c_str())) {
         esp3d_log_e("Error dispatching Telnet client IP");
         return;
       }
     }
+    tmpstr = String(telnet_server.clientsCount()) + "/" +
+             String(ESP3D_TELNET_MAX_CLIENTS);
+    if (telnet_server.droppedClients() > 0) {
+      tmpstr += " (" + String(telnet_server.droppedClients()) + " dropped)";
+    }
+    if (!dispatchIdValue(writer, "Telnet clients", tmpstr.c_str())) {
+      esp3d_log_e("Error dispatching Telnet clients");
+      return;
+    }
+  }
 #endif  // TELNET_FEATURE
 
 #if defined(WEBDAV_FEATURE)
@@ -404,7 +417,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
     // WebDav port
     tmpstr = String(webdav_server.port());
     esp3d_log("WebDav port: %s", tmpstr.c_str());
-    if (!dispatchIdValue(json, "WebDav port", tmpstr.c_str(), target, requestId, false)) {
+    if (!dispatchIdValue(writer, "WebDav port", tmpstr.c_str())) {
       esp3d_log_e("Error dispatching WebDav port");
       return;
     }
@@ -413,7 +426,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
     if (WiFi.getMode() == WIFI_AP_STA && WiFi.isConnected()) {
       tmpstr = WiFi.localIP().toString() + ":" + String(webdav_server.port());
       esp3d_log("WebDav STA accessibility: %s", tmpstr.c_str());
-      if (!dispatchIdValue(json, "WebDav STA address", tmpstr.c_str(), target, requestId, false)) {
+      if (!dispatchIdValue(writer, "WebDav STA address", tmpstr.c_str())) {
         esp3d_log_e("Error dispatching WebDav STA address");
         return;
       }
@@ -427,7 +440,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
     // FTP ports
     tmpstr = String(ftp_server.ctrlport()) + "," + String(ftp_server.dataactiveport()) + "," + String(ftp_server.datapassiveport());
     esp3d_log("FTP ports: %s", tmpstr.c_str());
-    if (!dispatchIdValue(json, "Ftp ports", tmpstr.c_str(), target, requestId, false)) {
+    if (!dispatchIdValue(writer, "Ftp ports", tmpstr.c_str())) {
       esp3d_log_e("Error dispatching FTP ports");
       return;
     }
@@ -436,7 +449,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
     if (WiFi.getMode() == WIFI_AP_STA && WiFi.isConnected()) {
       tmpstr = WiFi.localIP().toString() + ":" + String(ftp_server.ctrlport());
       esp3d_log("FTP STA accessibility: %s", tmpstr.c_str());
-      if (!dispatchIdValue(json, "FTP STA address", tmpstr.c_str(), target, requestId, false)) {
+      if (!dispatchIdValue(writer, "FTP STA address", tmpstr.c_str())) {
         esp3d_log_e("Error dispatching FTP STA address");
         return;
       }
@@ -450,7 +463,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
     // Websocket port
     tmpstr = String(websocket_data_server.port());
     esp3d_log("Websocket port: %s", tmpstr.c_str());
-    if (!dispatchIdValue(json, "Websocket port", tmpstr.c_str(), target, requestId, false)) {
+    if (!dispatchIdValue(writer, "Websocket port", tmpstr.c_str())) {
       esp3d_log_e("Error dispatching Websocket port");
       return;
     }
@@ -459,7 +472,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
     if (WiFi.getMode() == WIFI_AP_STA && WiFi.isConnected()) {
       tmpstr = WiFi.localIP().toString() + ":" + String(websocket_data_server.port());
       esp3d_log("Websocket STA accessibility: %s", tmpstr.c_str());
-      if (!dispatchIdValue(json, "Websocket STA address", tmpstr.c_str(), target, requestId, false)) {
+      if (!dispatchIdValue(writer, "Websocket STA address", tmpstr.c_str())) {
         esp3d_log_e("Error dispatching Websocket STA address");
         return;
       }
@@ -472,7 +485,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
   if (esp3d_camera.started()) {
     tmpstr = String(esp3d_camera.GetModelString()) + "(" + String(esp3d_camera.GetModel()) + ")";
     esp3d_log("Camera name: %s", tmpstr.c_str());
-    if (!dispatchIdValue(json, "camera name", tmpstr.c_str(), target, requestId, false)) {
+    if (!dispatchIdValue(writer, "camera name", tmpstr.c_str())) {
       esp3d_log_e("Error dispatching camera name");
       return;
     }
@@ -482,7 +495,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
 #if defined(DISPLAY_DEVICE)
   tmpstr = esp3d_display.getModelString();
   esp3d_log("Display: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "display", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "display", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching display");
     return;
   }
@@ -491,7 +504,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
 #if defined(SENSOR_DEVICE)
   tmpstr = esp3d_sensor.getTypeString();
   esp3d_log("Sensor Type: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "sensor type", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "sensor type", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching sensor type");
     return;
   }
@@ -500,7 +513,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
 #if defined(BUZZER_DEVICE)
   tmpstr = (esp3d_buzzer.started()) ? "ON" : "OFF";
   esp3d_log("Buzzer: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "buzzer", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "buzzer", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching buzzer status");
     return;
   }
@@ -509,16 +522,25 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
 #if defined(SD_DEVICE)
   tmpstr = (ESP_SD::getState(true) == ESP_SDCARD_NOT_PRESENT) ? "Not present" : "Present";
   esp3d_log("SD Card: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "sd card", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "sd card", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching SD card status");
     return;
   }
+#if SD_DEVICE_CONNECTION == ESP_SHARED_SD
+  tmpstr = String(ESP_SD::mountsPerMinute()) + " mount/min, bus wait " +
+           String(ESP_SD::busWaitTime()) + "ms";
+  esp3d_log("Shared SD: %s", tmpstr.c_str());
+  if (!dispatchIdValue(writer, "shared sd", tmpstr.c_str())) {
+    esp3d_log_e("Error dispatching shared SD stats");
+    return;
+  }
+#endif  // SD_DEVICE_CONNECTION == ESP_SHARED_SD
 #endif  // SD_DEVICE
 
 #if defined(TIMESTAMP_FEATURE)
   tmpstr = timeService.getCurrentTime();
   esp3d_log("Time: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "time", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "time", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching time");
     return;
   }
@@ -527,7 +549,7 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
 #if defined(NOTIFICATION_FEATURE)
   tmpstr = notificationsservice.getTypeString();
   esp3d_log("Notification Type: %s", tmpstr.c_str());
-  if (!dispatchIdValue(json, "notification type", tmpstr.c_str(), target, requestId, false)) {
+  if (!dispatchIdValue(writer, "notification type", tmpstr.c_str())) {
     esp3d_log_e("Error dispatching notification type");
     return;
   }
@@ -535,20 +557,13 @@ void ESP3DCommands::ESP420(int cmd_params_pos, ESP3DMessage* msg) {
 
   // End of response
   if (json) {
-    tmpstr = "]}";
+    writer.endArray();
+    writer.endObject();
   } else {
-    if (addPreTag) {
-      tmpstr = "</pre>";
-    } else {
-      tmpstr = "ok\n";
-    }
+    writer.write(addPreTag ? "</pre>" : "ok\n");
   }
-  esp3d_log("Sending response footer: %s", tmpstr.c_str());
-  msg->type = ESP3DMessageType::tail;
-  if (!dispatch(msg, tmpstr.c_str())) {
+  if (!writer.end()) {
     esp3d_log_e("Error sending response footer to clients");
-    return;
   }
 }
 #endif  // ESP_SAVE_SETTINGS
-}
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*
+ ESP421.cpp - ESP3D command class
+
+ Copyright (c) 2014 Luc Lebosse. All rights reserved.
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with This code; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "../../include/esp3d_config.h"
+#include "../../modules/authentication/authentication_service.h"
+#include "../esp3d_commands.h"
+#include "../esp3d_settings.h"
+
+#define COMMAND_ID 421
+// Get commands statistics: calls, average and max duration in us
+//[ESP421]<RESET> json=<no> pwd=<admin password>
+void ESP3DCommands::ESP421(int cmd_params_pos, ESP3DMessage* msg) {
+  ESP3DClientType target = msg->origin;
+  ESP3DRequest requestId = msg->request_id;
+  (void)requestId;
+  msg->target = target;
+  msg->origin = ESP3DClientType::command;
+  bool hasError = false;
+  String error_msg = "Invalid parameters";
+  String ok_msg = "ok";
+  bool json = hasTag(msg, cmd_params_pos, "json");
+  String tmpstr;
+  tmpstr = get_clean_param(msg, cmd_params_pos);
+  if (tmpstr.length() == 0) {
+    ESP3DCommandEntry entry;
+    bool first = true;
+    ok_msg = json ? "{\"commands\":[" : "";
+    for (uint8_t i = 0; i < commandsCount(); i++) {
+      const ESP3DCommandStats* stats = getCommandStats(i);
+      if (!stats || stats->calls == 0 || !getCommandEntry(i, &entry)) {
+        continue;
+      }
+      if (json) {
+        if (!first) {
+          ok_msg += ",";
+        }
+        ok_msg += "{\"id\":\"";
+        ok_msg += String(entry.id);
+        ok_msg += "\",\"calls\":\"";
+        ok_msg += String(stats->calls);
+        ok_msg += "\",\"avg\":\"";
+        ok_msg += String(stats->totalTime / stats->calls);
+        ok_msg += "\",\"max\":\"";
+        ok_msg += String(stats->maxTime);
+        ok_msg += "\"}";
+      } else {
+        ok_msg += "[ESP";
+        ok_msg += String(entry.id);
+        ok_msg += "]: calls ";
+        ok_msg += String(stats->calls);
+        ok_msg += ", avg ";
+        ok_msg += String(stats->totalTime / stats->calls);
+        ok_msg += "us, max ";
+        ok_msg += String(stats->maxTime);
+        ok_msg += "us\n";
+      }
+      first = false;
+    }
+    if (json) {
+      ok_msg += "]}";
+    } else if (first) {
+      ok_msg = "No statistics";
+    }
+  } else if (tmpstr == "RESET") {
+#if defined(AUTHENTICATION_FEATURE)
+    if (msg->authentication_level != ESP3DAuthenticationLevel::admin) {
+      msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
+      dispatchAuthenticationError(msg, COMMAND_ID, json);
+      return;
+    }
+#endif  // AUTHENTICATION_FEATURE
+    resetCommandStats();
+  } else {
+    esp3d_log_e("Got %s", tmpstr.c_str());
+    hasError = true;
+  }
+
+  if (!dispatchAnswer(msg, COMMAND_ID, json, !hasError,
+                      hasError ? error_msg.c_str() : ok_msg.c_str())) {
+    esp3d_log_e("Error sending response to clients");
+  }
+}
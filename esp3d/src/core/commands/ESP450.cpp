@@ -22,11 +22,13 @@
 #include "../../modules/authentication/authentication_service.h"
 #include "../../modules/mDNS/mDNS.h"
 #include "../esp3d_commands.h"
+#include "../esp3d_json_writer.h"
 #include "../esp3d_settings.h"
 
 // Get available ESP3D list
 // output is JSON or plain text according parameter
-//[ESP450]json=<no>
+// list comes from discovery cache, REFRESH forces a new discovery
+//[ESP450]<REFRESH> json=<no>
 #define COMMAND_ID 450
 void ESP3DCommands::ESP450(int cmd_params_pos, ESP3DMessage* msg) {
   ESP3DClientType target = msg->origin;
@@ -36,13 +38,6 @@ void ESP3DCommands::ESP450(int cmd_params_pos, ESP3DMessage* msg) {
   bool json = hasTag(msg, cmd_params_pos, "json");
   String tmpstr;
 
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
-
   if (!(WiFi.getMode() == WIFI_STA || WiFi.getMode() == WIFI_AP)) {
     tmpstr = "Network not enabled";
     if (!dispatch(msg, format_response(COMMAND_ID, json, false, tmpstr.c_str()),
@@ -52,92 +47,67 @@ void ESP3DCommands::ESP450(int cmd_params_pos, ESP3DMessage* msg) {
     return;
   }
 
+  // Answer from discovery cache, query network only if asked or never done
+  if (hasTag(msg, cmd_params_pos, "REFRESH") || !esp3d_mDNS.hasPeers()) {
+    if (esp3d_mDNS.refresh()) {
+      esp3d_mDNS.waitRefresh();
+    }
+  }
+  ESP3DJsonWriter writer(target, requestId, msg->authentication_level, json);
+  esp3d_message_manager.deleteMsg(msg);
   if (json) {
-    tmpstr = "{\"cmd\":\"450\",\"status\":\"ok\",\"data\":[";
-
+    writer.beginObject();
+    writer.add("cmd", "450");
+    writer.add("status", "ok");
+    writer.beginArray("data");
   } else {
-    tmpstr = "Start Scan\n";
-  }
-  msg->type = ESP3DMessageType::head;
-  if (!dispatch(msg, tmpstr.c_str(), target, requestId, ESP3DMessageType::head, msg->authentication_level)) {
-    esp3d_log_e("Error sending response to clients");
-    return;
+    writer.write("Start Scan\n");
   }
-
-  uint16_t count = esp3d_mDNS.servicesCount();
-  uint16_t nbListed = 0;
+  uint8_t count = esp3d_mDNS.peersCount();
   esp3d_log("Total : %d", count);
-  for (uint16_t i = 0; i < count; i++) {
-    if (strlen(esp3d_mDNS.answerHostname(i)) == 0) {
-      continue;
-    }
+  for (uint8_t i = 0; i < count && !writer.hasError(); i++) {
+    const ESP3DmDNSPeer* peer = esp3d_mDNS.peer(i);
     // Currently esp3d support only IPV4 and only one address per device
-
-    tmpstr = "";
-
     if (json) {
-      if (nbListed > 0) {
-        tmpstr += ",";
+      writer.beginObject();
+      writer.add("Hostname", peer->hostname);
+      writer.add("IP", peer->ip);
+      writer.add("port", String(peer->port).c_str());
+      writer.beginArray("TxT");
+      for (uint8_t t = 0; t < peer->txtCount; t++) {
+        writer.beginObject();
+        writer.add("key", peer->txtKey[t]);
+        writer.add("value", peer->txtValue[t]);
+        writer.endObject();
       }
-
-      tmpstr += "{\"Hostname\":\"";
-    }
-    tmpstr += esp3d_mDNS.answerHostname(i);
-    if (json) {
-      tmpstr += "\",\"IP\":\"";
+      writer.endArray();
+      writer.endObject();
     } else {
-      tmpstr += " (";
-    }
-    tmpstr += esp3d_mDNS.answerIP(i);
-    if (json) {
-      tmpstr += "\",\"port\":\"";
-      tmpstr += String(esp3d_mDNS.answerPort(i));
-      tmpstr += "\",\"TxT\":[";
-
-    } else {
-      tmpstr += ":";
-      tmpstr += String(esp3d_mDNS.answerPort(i));
-      tmpstr += ") ";
-    }
-    uint16_t nbtxt = esp3d_mDNS.answerTxtCount(i);
-    for (uint8_t t = 0; t < nbtxt; t++) {
-      if (t != 0) {
-        tmpstr += ",";
-      }
-      if (json) {
-        tmpstr += "{\"key\":\"";
-      }
-      tmpstr += esp3d_mDNS.answerTxtKey(i, t);
-      if (json) {
-        tmpstr += "\",\"value\":\"";
-      } else {
-        tmpstr += "=";
-      }
-      tmpstr += esp3d_mDNS.answerTxt(i, t);
-      if (json) {
-        tmpstr += "\"}";
+      writer.write(peer->hostname);
+      writer.write(" (");
+      writer.write(peer->ip);
+      writer.write(":");
+      writer.write(String(peer->port).c_str());
+      writer.write(") ");
+      for (uint8_t t = 0; t < peer->txtCount; t++) {
+        if (t != 0) {
+          writer.write(",");
+        }
+        writer.write(peer->txtKey[t]);
+        writer.write("=");
+        writer.write(peer->txtValue[t]);
       }
+      writer.write("\n");
     }
-
-    if (json) {
-      tmpstr += "]}";
-    } else {
-      tmpstr += "\n";
-    }
-    if (!dispatch(msg, tmpstr.c_str(), target, requestId, ESP3DMessageType::core, msg->authentication_level)) {
-      esp3d_log_e("Error sending answer to clients");
-    }
-
-    nbListed++;
   }
-
   // end of list
   if (json) {
-    tmpstr = "]}";
+    writer.endArray();
+    writer.endObject();
   } else {
-    tmpstr = "End Scan\n";
+    writer.write("End Scan\n");
   }
-  if (!dispatch(msg, tmpstr.c_str(), target, requestId, ESP3DMessageType::tail, msg->authentication_level)) {
+  if (!writer.end()) {
     esp3d_log_e("Error sending answer to clients");
   }
 }
@@ -37,13 +37,6 @@ void ESP3DCommands::ESP510(int cmd_params_pos, ESP3DMessage* msg) {
   String ok_msg = "ok";
   bool json = hasTag(msg, cmd_params_pos, "json");
   String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level != ESP3DAuthenticationLevel::admin) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   tmpstr = get_clean_param(msg, cmd_params_pos);
   if (tmpstr.length() == 0) {
     const ESP3DSettingDescription* settingPtr =
@@ -55,12 +48,6 @@ void ESP3DCommands::ESP510(int cmd_params_pos, ESP3DMessage* msg) {
       error_msg = "This setting is unknown";
     }
   } else {
-#if defined(AUTHENTICATION_FEATURE)
-    if (msg->authentication_level != ESP3DAuthenticationLevel::admin) {
-      dispatchAuthenticationError(msg, COMMAND_ID, json);
-      return;
-    }
-#endif  // AUTHENTICATION_FEATURE
     if (ESP3DSettings::isValidByteSetting((uint8_t)tmpstr.toInt(),
                                           ESP3DSettingIndex::esp3d_session_timeout)) {
       esp3d_log("Value %s is valid", tmpstr.c_str());
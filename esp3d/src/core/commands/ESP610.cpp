@@ -41,14 +41,6 @@ void ESP3DCommands::ESP110(int cmd_params_pos, ESP3DMessage* msg) {
   String tmpstr;
   uint8_t byteValue = (uint8_t)-1;
 
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif
-
   tmpstr = get_clean_param(msg, cmd_params_pos);
 
   // Query current mode
@@ -40,13 +40,6 @@ void ESP3DCommands::ESP701(int cmd_params_pos, ESP3DMessage* msg) {
   bool json = hasTag(msg, cmd_params_pos, "json");
   bool hasClearError = hasTag(msg, cmd_params_pos, "CLEAR_ERROR");
   String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   tmpstr = get_clean_param(msg, cmd_params_pos);
   if (tmpstr.length() == 0) {
     // give status
@@ -66,6 +59,21 @@ void ESP3DCommands::ESP701(int cmd_params_pos, ESP3DMessage* msg) {
           if (esp3d_gcode_host.getFSType() != TYPE_SCRIPT_STREAM) {
             ok_msg += "\",\"name\":\"" + String(esp3d_gcode_host.fileName());
           }
+#if defined(GCODE_INDEX_FEATURE)
+          if (esp3d_gcode_host.hasIndex()) {
+            ok_msg += "\",\"layer\":\"" +
+                      String(esp3d_gcode_host.currentLayer()) +
+                      "\",\"layers\":\"" +
+                      String(esp3d_gcode_host.layersCount()) +
+                      "\",\"z\":\"" + String(esp3d_gcode_host.currentZ(), 2);
+            if (esp3d_gcode_host.totalTime() > 0) {
+              ok_msg += "\",\"elapsed\":\"" +
+                        String(esp3d_gcode_host.elapsedTime()) +
+                        "\",\"remaining\":\"" +
+                        String(esp3d_gcode_host.remainingTime());
+            }
+          }
+#endif  // GCODE_INDEX_FEATURE
           ok_msg += "\"}";
         } else {
           ok_msg = "processing";
@@ -0,0 +1,94 @@
+/*
+ ESP702.cpp - ESP3D command class
+
+ Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with This code; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "../../include/esp3d_config.h"
+#if defined(GCODE_INDEX_FEATURE)
+#include "../../modules/authentication/authentication_service.h"
+#include "../../modules/filesystem/esp_globalFS.h"
+#include "../../modules/gcode_host/gcode_host.h"
+#include "../esp3d_commands.h"
+#include "../esp3d_settings.h"
+
+#define COMMAND_ID 702
+
+// Index local file in background, or process it from a layer / an offset
+//[ESP702]<filename> layer=<n> offset=<n>
+void ESP3DCommands::ESP702(int cmd_params_pos, ESP3DMessage* msg) {
+  ESP3DClientType target = msg->origin;
+  ESP3DRequest requestId = msg->request_id;
+  (void)requestId;
+  msg->target = target;
+  bool hasError = false;
+  String error_msg = "Invalid parameters";
+  String ok_msg = "ok";
+  bool json = hasTag(msg, cmd_params_pos, "json");
+  bool hasLayer = false;
+  bool hasOffset = false;
+  String filename;
+  filename = get_clean_param(msg, cmd_params_pos);
+  String layer = get_param(msg, cmd_params_pos, "layer=", &hasLayer);
+  String offset = get_param(msg, cmd_params_pos, "offset=", &hasOffset);
+  if (filename.length() == 0 || filename.indexOf('=') != -1) {
+    hasError = true;
+    error_msg = "Missing parameter";
+    esp3d_log_e("%s", error_msg.c_str());
+  } else if (hasLayer || hasOffset) {
+    if (hasLayer && hasOffset) {
+      hasError = true;
+    } else if (esp3d_gcode_host.getStatus() != HOST_NO_STREAM) {
+      hasError = true;
+      error_msg = "Streaming already in progress";
+    } else if (!esp3d_gcode_host.processFileFrom(
+                   filename.c_str(), hasOffset ? offset.toInt() : 0,
+                   hasLayer ? layer.toInt() : -1,
+                   msg->authentication_level)) {
+      hasError = true;
+      error_msg = "Error processing file";
+      esp3d_log_e("%s", error_msg.c_str());
+    }
+  } else {
+    // index is built by a background job, progress is given by [ESP791]
+    String path = filename;
+    if (path[0] != '/') {
+      path = "/" + path;
+    }
+#if defined(FILESYSTEM_FEATURE)
+    if (ESP_GBFS::getFSType(path.c_str()) == FS_UNKNOWN) {
+      path = ESP_FLASH_FS_HEADER + path;
+    }
+#endif  // FILESYSTEM_FEATURE
+    uint16_t id = ESP_GBFS::addJob(ESP_GBFSJobType::index, path.c_str());
+    if (id == 0) {
+      hasError = true;
+      error_msg = "Cannot index file";
+      esp3d_log_e("%s", error_msg.c_str());
+    } else if (json) {
+      ok_msg = "{\"id\":\"" + String(id) + "\"}";
+    } else {
+      ok_msg = "Job " + String(id) + " queued";
+    }
+  }
+  if (!dispatchAnswer(msg, COMMAND_ID, json, !hasError,
+                      hasError ? error_msg.c_str() : ok_msg.c_str())) {
+    esp3d_log_e("Error sending response to clients");
+  }
+  esp3d_message_manager.deleteMsg(msg);
+}
+
+#endif  // GCODE_INDEX_FEATURE
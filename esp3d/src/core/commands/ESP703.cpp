@@ -0,0 +1,91 @@
+/*
+ ESP703.cpp - ESP3D command class
+
+ Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with This code; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "../../include/esp3d_config.h"
+#if defined(PRINT_JOURNAL_FEATURE)
+#include "../../modules/authentication/authentication_service.h"
+#include "../../modules/gcode_host/gcode_host.h"
+#include "../../modules/gcode_host/print_journal.h"
+#include "../esp3d_commands.h"
+#include "../esp3d_settings.h"
+
+#define COMMAND_ID 703
+
+// Query / resume / clear print journal
+//[ESP703]action=<RESUME/CLEAR>
+void ESP3DCommands::ESP703(int cmd_params_pos, ESP3DMessage* msg) {
+  ESP3DClientType target = msg->origin;
+  ESP3DRequest requestId = msg->request_id;
+  (void)requestId;
+  msg->target = target;
+  msg->origin = ESP3DClientType::command;
+  bool hasError = false;
+  String error_msg = "Invalid parameters";
+  String ok_msg = "ok";
+  bool json = hasTag(msg, cmd_params_pos, "json");
+  bool hasAction = false;
+  ESP3DPrintJournalHeader header;
+  ESP3DPrintJournalRecord record;
+  String action = get_param(msg, cmd_params_pos, "action=", &hasAction);
+  action.toUpperCase();
+  if (!hasAction) {
+    if (ESP3DPrintJournal::read(header, record)) {
+      String filename = header.fsType == TYPE_SD_STREAM ? "/SD" : "/FS";
+      filename += header.fileName;
+      if (json) {
+        ok_msg = "{\"file\":\"" + filename + "\",\"offset\":\"" +
+                 String(record.offset) + "\",\"line\":\"" +
+                 String(record.line) + "\",\"z\":\"" + String(record.z, 2) +
+                 "\",\"feedrate\":\"" + String(record.feedrate, 0) +
+                 "\",\"hotend\":\"" + String(record.hotendTemperature, 1) +
+                 "\",\"bed\":\"" + String(record.bedTemperature, 1) + "\"}";
+      } else {
+        ok_msg = filename + " offset " + String(record.offset) + " line " +
+                 String(record.line) + " Z " + String(record.z, 2);
+      }
+    } else {
+      hasError = true;
+      error_msg = "No print to recover";
+    }
+  } else if (action == "RESUME") {
+    if (esp3d_gcode_host.getStatus() != HOST_NO_STREAM) {
+      hasError = true;
+      error_msg = "Streaming already in progress";
+    } else if (!esp3d_gcode_host.recover(msg->authentication_level)) {
+      hasError = true;
+      error_msg = "Cannot recover print";
+      esp3d_log_e("%s", error_msg.c_str());
+    }
+  } else if (action == "CLEAR") {
+    if (esp3d_gcode_host.getStatus() != HOST_NO_STREAM) {
+      hasError = true;
+      error_msg = "Streaming in progress";
+    } else {
+      ESP3DPrintJournal::clear();
+    }
+  } else {
+    hasError = true;
+  }
+  if (!dispatchAnswer(msg, COMMAND_ID, json, !hasError,
+                      hasError ? error_msg.c_str() : ok_msg.c_str())) {
+    esp3d_log_e("Error sending response to clients");
+  }
+}
+
+#endif  // PRINT_JOURNAL_FEATURE
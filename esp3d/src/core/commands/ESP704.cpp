@@ -0,0 +1,102 @@
+/*
+ ESP704.cpp - ESP3D command class
+
+ Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with This code; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "../../include/esp3d_config.h"
+#if defined(PRINT_QUEUE_FEATURE)
+#include "../../modules/authentication/authentication_service.h"
+#include "../../modules/gcode_host/gcode_host.h"
+#include "../esp3d_commands.h"
+#include "../esp3d_settings.h"
+
+#define COMMAND_ID 704
+
+// List / add / remove print jobs of queue and control it
+//[ESP704]add=<filename> priority=<0-255>
+//[ESP704]remove=<id>
+//[ESP704]action=<PAUSE/RESUME/CLEAR>
+void ESP3DCommands::ESP704(int cmd_params_pos, ESP3DMessage* msg) {
+  ESP3DClientType target = msg->origin;
+  ESP3DRequest requestId = msg->request_id;
+  (void)requestId;
+  msg->target = target;
+  msg->origin = ESP3DClientType::command;
+  bool hasError = false;
+  String error_msg = "Invalid parameters";
+  String ok_msg = "ok";
+  bool json = hasTag(msg, cmd_params_pos, "json");
+  bool hasAdd = false;
+  bool hasPriority = false;
+  bool hasRemove = false;
+  bool hasAction = false;
+  ESP3DPrintQueue& queue = esp3d_gcode_host.queue();
+  String filename = get_param(msg, cmd_params_pos, "add=", &hasAdd);
+  String priority = get_param(msg, cmd_params_pos, "priority=", &hasPriority);
+  String id = get_param(msg, cmd_params_pos, "remove=", &hasRemove);
+  String action = get_param(msg, cmd_params_pos, "action=", &hasAction);
+  action.toUpperCase();
+  if (hasAdd + hasRemove + hasAction > 1 || (hasPriority && !hasAdd)) {
+    hasError = true;
+  } else if (hasAdd) {
+    long value = hasPriority ? priority.toInt() : 0;
+    uint32_t jobId = 0;
+    if (filename.length() == 0 || value < 0 || value > 255) {
+      hasError = true;
+    } else if ((jobId = esp3d_gcode_host.queueFile(
+                    filename.c_str(), msg->authentication_level, value)) ==
+               0) {
+      hasError = true;
+      error_msg = "Cannot queue file";
+      esp3d_log_e("%s", error_msg.c_str());
+    } else {
+      ok_msg = json ? "{\"id\":\"" + String(jobId) + "\"}" : String(jobId);
+    }
+  } else if (hasRemove) {
+    uint32_t jobId = id.toInt();
+    ESP3DPrintJob job;
+    if (!queue.find(jobId, job)) {
+      hasError = true;
+      error_msg = "No such job";
+    } else if (static_cast<uint8_t>(msg->authentication_level) < job.auth) {
+      // job of admin cannot be removed by user
+      msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
+      dispatchAuthenticationError(msg, COMMAND_ID, json);
+      return;
+    } else {
+      queue.remove(jobId);
+    }
+  } else if (hasAction) {
+    if (action == "PAUSE") {
+      esp3d_gcode_host.pauseQueue();
+    } else if (action == "RESUME") {
+      queue.setPaused(false);
+    } else if (action == "CLEAR") {
+      queue.clear();
+    } else {
+      hasError = true;
+    }
+  } else {
+    ok_msg = queue.toString(json, esp3d_gcode_host.currentJobId());
+  }
+  if (!dispatchAnswer(msg, COMMAND_ID, json, !hasError,
+                      hasError ? error_msg.c_str() : ok_msg.c_str())) {
+    esp3d_log_e("Error sending response to clients");
+  }
+}
+
+#endif  // PRINT_QUEUE_FEATURE
@@ -40,13 +40,6 @@ void ESP3DCommands::ESP720(int cmd_params_pos, ESP3DMessage* msg) {
   // prepare answer msg
   msg->target = msg->origin;
   msg->origin = ESP3DClientType::command;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
 
   ESP3DMessage msgInfo;
   esp3d_log("Copy msg infos");
@@ -21,6 +21,9 @@
 #if defined(FILESYSTEM_FEATURE)
 #include "../../modules/authentication/authentication_service.h"
 #include "../../modules/filesystem/esp_filesystem.h"
+#if defined(GCODE_INDEX_FEATURE)
+#include "../../modules/gcode_host/gcode_index.h"
+#endif  // GCODE_INDEX_FEATURE
 #include "../esp3d_commands.h"
 #include "../esp3d_settings.h"
 
@@ -41,13 +44,6 @@ void ESP3DCommands::ESP730(int cmd_params_pos, ESP3DMessage* msg) {
   String tmpstr;
   const char* cmdList[] = {"rmdir=", "remove=", "mkdir=", "exists=", "create="};
   uint8_t cmdListSize = sizeof(cmdList) / sizeof(char*);
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   uint8_t i;
   for (i = 0; i < cmdListSize && !hasError; i++) {
     tmpstr = get_param(msg, cmd_params_pos, cmdList[i]);
@@ -71,6 +67,9 @@ void ESP3DCommands::ESP730(int cmd_params_pos, ESP3DMessage* msg) {
             hasError = true;
             error_msg = "remove failed";
           }
+#if defined(GCODE_INDEX_FEATURE)
+          ESP3DGcodeIndex::removeFor<ESP_FileSystem>(tmpstr.c_str());
+#endif  // GCODE_INDEX_FEATURE
           break;
         case 2:
           if (!ESP_FileSystem::mkdir(tmpstr.c_str())) {
@@ -22,6 +22,7 @@
 #include "../../modules/authentication/authentication_service.h"
 #include "../../modules/filesystem/esp_sd.h"
 #include "../esp3d_commands.h"
+#include "../esp3d_json_writer.h"
 #include "../esp3d_settings.h"
 #include "../esp3d_string.h"
 
@@ -32,24 +33,13 @@
 // List SD Filesystem
 //[ESP740]<Root> json=<no> pwd=<admin password>
 void ESP3DCommands::ESP740(int cmd_params_pos, ESP3DMessage* msg) {
-  bool hasError = false;
   String error_msg = "Path inccorrect";
-  String ok_msg = "ok";
   bool json = hasTag(msg, cmd_params_pos, "json");
   String tmpstr;
   // prepare answer msg
   msg->target = msg->origin;
   msg->origin = ESP3DClientType::command;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
 
-  ESP3DMessage msgInfo;
-  esp3d_message_manager.copyMsgInfos(&msgInfo, *msg);
   tmpstr = get_clean_param(msg, cmd_params_pos);
 
   if (tmpstr.length() == 0) {
@@ -58,188 +48,146 @@ void ESP3DCommands::ESP740(int cmd_params_pos, ESP3DMessage* msg) {
 
   if (ESP_SD::accessFS()) {
     if (ESP_SD::getState(true) == ESP_SDCARD_NOT_PRESENT) {
-      hasError = true;
       error_msg = "No SD card";
       esp3d_log_e("%s", error_msg.c_str());
-      if (!dispatchAnswer(msg, COMMAND_ID, json, hasError,
-                          hasError ? error_msg.c_str() : ok_msg.c_str())) {
+      if (!dispatchAnswer(msg, COMMAND_ID, json, false,
+                          error_msg.c_str())) {
         esp3d_log_e("Error sending response to clients");
       }
     } else {
       ESP_SD::setState(ESP_SDCARD_BUSY);
       ESP_SDFile f;
       f = ESP_SD::open(tmpstr.c_str(), ESP_FILE_READ);
-      if (f) {
-        if (json) {
-          ok_msg = "{\"cmd\":\"740\",\"status\":\"ok\",\"data\":{\"path\":\"";
-          ok_msg += tmpstr.c_str();
-          ok_msg += "\",\"files\":[";
-
-        } else {
-          ok_msg = "Directory on SD : ";
-          ok_msg += tmpstr.c_str();
-          ok_msg += "\n";
-        }
-        msg->type = ESP3DMessageType::head;
-        if (!dispatch(msg, ok_msg.c_str())) {
+      // card can be removed while opening: answer error before streaming
+      // anything, so client never gets a truncated "ok"
+      if (f && ESP_SD::getState(true) == ESP_SDCARD_NOT_PRESENT) {
+        f.close();
+        error_msg = "No SD card";
+        esp3d_log_e("%s", error_msg.c_str());
+        if (!dispatchAnswer(msg, COMMAND_ID, json, false,
+                            error_msg.c_str())) {
           esp3d_log_e("Error sending response to clients");
-          hasError = true;
         }
-        if (ESP_SD::getState(true) == ESP_SDCARD_NOT_PRESENT) {
-          hasError = true;
-          error_msg = "No SD card";
-          esp3d_log_e("%s", error_msg.c_str());
+      } else if (f) {
+        ESP3DJsonWriter writer(msg->target, msg->request_id,
+                               msg->authentication_level, json);
+        if (json) {
+          writer.beginObject();
+          writer.add("cmd", "740");
+          writer.add("status", "ok");
+          writer.beginObject("data");
+          writer.add("path", tmpstr.c_str());
+          writer.beginArray("files");
+        } else {
+          writer.write("Directory on SD : ");
+          writer.write(tmpstr.c_str());
+          writer.write("\n");
         }
-        if (!hasError) {
-          uint nbDirs = 0;
-          uint nbFiles = 0;
-          uint64_t totalSpace = ESP_SD::totalBytes();
-          uint64_t usedSpace = ESP_SD::usedBytes();
-          uint64_t freeSpace = ESP_SD::freeBytes();
+        uint nbDirs = 0;
+        uint nbFiles = 0;
+        uint64_t totalSpace = ESP_SD::totalBytes();
+        uint64_t usedSpace = ESP_SD::usedBytes();
+        uint64_t freeSpace = ESP_SD::freeBytes();
 
-          ESP_SDFile sub;
-          sub = f.openNextFile();
-          while (sub && !hasError) {
-            if (sub.isDirectory()) {
-              ok_msg = "";
-              nbDirs++;
-              if (json) {
-                ok_msg = "";
-                if (nbDirs > 1) {
-                  ok_msg += ",";
-                }
-                ok_msg += "{\"name\":\"";
-                ok_msg += sub.name();
-                ok_msg += "\",\"size\":\"-1\"}";
-              } else {
-                ok_msg = "[DIR] \t";
-                ok_msg += sub.name();
-              }
-              if (!json) {
-                ok_msg += "\n";
-              }
-              ESP3DMessage* newMsg = esp3d_message_manager.copyMsgInfos(msgInfo);
-              if (newMsg) {
-                newMsg->type = ESP3DMessageType::core;
-                if (!dispatch(newMsg, ok_msg.c_str())) {
-                  esp3d_log_e("Error sending response to clients");
-                  hasError = true;
-                }
-              } else {
-                esp3d_log_e("Error creating message");
-                hasError = true;
-              }
+        ESP_SDFile sub;
+        sub = f.openNextFile();
+        while (sub && !writer.hasError()) {
+          if (sub.isDirectory()) {
+            nbDirs++;
+            if (json) {
+              writer.beginObject();
+              writer.add("name", sub.name());
+              writer.add("size", "-1");
+              writer.endObject();
+            } else {
+              writer.write("[DIR] \t");
+              writer.write(sub.name());
+              writer.write("\n");
             }
-            sub.close();
-            sub = f.openNextFile();
           }
-          f.close();
-          f = ESP_SD::open(tmpstr.c_str(), ESP_FILE_READ);
-          // Check files
+          sub.close();
           sub = f.openNextFile();
-          while (sub && !hasError) {
-            if (!sub.isDirectory()) {
-              nbFiles++;
-              String time = "";
-              ok_msg = "";
+        }
+        f.close();
+        f = ESP_SD::open(tmpstr.c_str(), ESP_FILE_READ);
+        // Check files
+        sub = f.openNextFile();
+        while (sub && !writer.hasError()) {
+          if (!sub.isDirectory()) {
+            nbFiles++;
+            String time = "";
 #ifdef SD_TIMESTAMP_FEATURE
-              time = timeService.getDateTime((time_t)sub.getLastWrite());
+            time = timeService.getDateTime((time_t)sub.getLastWrite());
 #endif  // SD_TIMESTAMP_FEATURE
-              if (json) {
-                ok_msg = "";
-                if (nbDirs > 0 || nbFiles > 1) {
-                  ok_msg += ",";
-                }
-                ok_msg += "{\"name\":\"";
-                ok_msg += sub.name();
-                ok_msg += "\",\"size\":\"";
-                ok_msg += esp3d_string::formatBytes(sub.size());
-                if (time.length() > 0) {
-                  ok_msg += "\",\"time\":\"";
-                  ok_msg += time;
-                }
-                ok_msg += "\"}";
-              } else {
-                ok_msg += "     \t ";
-                ok_msg += sub.name();
-                ok_msg += " \t";
-                ok_msg += esp3d_string::formatBytes(sub.size());
-                ok_msg += " \t";
-                ok_msg += time;
-              }
-              if (!json) {
-                ok_msg += "\n";
-              }
-              ESP3DMessage* newMsg = esp3d_message_manager.copyMsgInfos(msgInfo);
-              if (newMsg) {
-                newMsg->type = ESP3DMessageType::core;
-                if (!dispatch(newMsg, ok_msg.c_str())) {
-                  esp3d_log_e("Error sending response to clients");
-                  hasError = true;
-                }
-              } else {
-                esp3d_log_e("Error creating message");
-                hasError = true;
+            if (json) {
+              writer.beginObject();
+              writer.add("name", sub.name());
+              writer.add("size", esp3d_string::formatBytes(sub.size()));
+              if (time.length() > 0) {
+                writer.add("time", time.c_str());
               }
+              writer.endObject();
+            } else {
+              writer.write("     \t ");
+              writer.write(sub.name());
+              writer.write(" \t");
+              writer.write(esp3d_string::formatBytes(sub.size()));
+              writer.write(" \t");
+              writer.write(time.c_str());
+              writer.write("\n");
             }
-            sub.close();
-            sub = f.openNextFile();
           }
-          // end of json
-          if (json) {
-            ok_msg = "], \"total\":\"";
-            ok_msg += esp3d_string::formatBytes(totalSpace);
-            ok_msg += "\",\"used\":\"";
-            ok_msg += esp3d_string::formatBytes(usedSpace);
-            ok_msg += "\",\"occupation\":\"";
-            if (totalSpace == 0) {
-              totalSpace = 1;
-            }
-            uint occupation = round(100.0 * usedSpace / totalSpace);
-            if ((occupation < 1) && (usedSpace > 0)) {
-              occupation = 1;
-            }
-            ok_msg += String(occupation);
-            ok_msg += "\"}}";
-
-          } else {
-            ok_msg = "Files: ";
-            ok_msg += String(nbFiles);
-            ok_msg += ", Dirs :";
-            ok_msg += String(nbDirs);
-            ok_msg += "\nTotal: ";
-            ok_msg += esp3d_string::formatBytes(totalSpace);
-            ok_msg += ", Used: ";
-            ok_msg += esp3d_string::formatBytes(usedSpace);
-            ok_msg += ", Available: ";
-            ok_msg += esp3d_string::formatBytes(freeSpace);
-            ok_msg += "\n";
+          sub.close();
+          sub = f.openNextFile();
+        }
+        // end of json
+        if (json) {
+          writer.endArray();
+          writer.add("total", esp3d_string::formatBytes(totalSpace));
+          writer.add("used", esp3d_string::formatBytes(usedSpace));
+          if (totalSpace == 0) {
+            totalSpace = 1;
           }
-
-          ESP3DMessage* newMsg = esp3d_message_manager.copyMsgInfos(msgInfo);
-          newMsg->type = ESP3DMessageType::tail;
-          if (!dispatch(newMsg, ok_msg.c_str())) {
-            esp3d_log_e("Error sending response to clients");
+          uint occupation = round(100.0 * usedSpace / totalSpace);
+          if ((occupation < 1) && (usedSpace > 0)) {
+            occupation = 1;
           }
-          f.close();
+          writer.add("occupation", String(occupation).c_str());
+          writer.endObject();
+          writer.endObject();
+        } else {
+          writer.write("Files: ");
+          writer.write(String(nbFiles).c_str());
+          writer.write(", Dirs :");
+          writer.write(String(nbDirs).c_str());
+          writer.write("\nTotal: ");
+          writer.write(esp3d_string::formatBytes(totalSpace));
+          writer.write(", Used: ");
+          writer.write(esp3d_string::formatBytes(usedSpace));
+          writer.write(", Available: ");
+          writer.write(esp3d_string::formatBytes(freeSpace));
+          writer.write("\n");
+        }
+        f.close();
+        if (!writer.end()) {
+          esp3d_log_e("Error sending response to clients");
         }
+        esp3d_message_manager.deleteMsg(msg);
       } else {
-        hasError = true;
         error_msg = "Invalid directory";
         esp3d_log_e("%s", error_msg.c_str());
-        if (!dispatchAnswer(msg, COMMAND_ID, json, hasError,
-                            hasError ? error_msg.c_str() : ok_msg.c_str())) {
+        if (!dispatchAnswer(msg, COMMAND_ID, json, false,
+                            error_msg.c_str())) {
           esp3d_log_e("Error sending response to clients");
         }
       }
     }
     ESP_SD::releaseFS();
   } else {
-    hasError = true;
     error_msg = "FS not available";
     esp3d_log_e("%s", error_msg.c_str());
-    if (!dispatchAnswer(msg, COMMAND_ID, json, hasError,
-                        hasError ? error_msg.c_str() : ok_msg.c_str())) {
+    if (!dispatchAnswer(msg, COMMAND_ID, json, false,
+                        error_msg.c_str())) {
       esp3d_log_e("Error sending response to clients");
     }
   }
@@ -22,6 +22,7 @@
 #include "../../modules/authentication/authentication_service.h"
 #include "../../modules/filesystem/esp_globalFS.h"
 #include "../esp3d_commands.h"
+#include "../esp3d_json_writer.h"
 #include "../esp3d_settings.h"
 #include "../esp3d_string.h"
 
@@ -40,16 +41,7 @@ void ESP3DCommands::ESP780(int cmd_params_pos, ESP3DMessage* msg) {
   // prepare answer msg
   msg->target = msg->origin;
   msg->origin = ESP3DClientType::command;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
 
-  ESP3DMessage msgInfo;
-  esp3d_message_manager.copyMsgInfos(&msgInfo, *msg);
   tmpstr = get_clean_param(msg, cmd_params_pos);
 
   if (tmpstr.length() == 0) {
@@ -61,155 +53,110 @@ void ESP3DCommands::ESP780(int cmd_params_pos, ESP3DMessage* msg) {
     ESP_GBFile f;
     f = ESP_GBFS::open(tmpstr.c_str(), ESP_FILE_READ);
     if (f) {
+      ESP3DJsonWriter writer(msg->target, msg->request_id,
+                             msg->authentication_level, json);
       if (json) {
-        ok_msg = "{\"cmd\":\"780\",\"status\":\"ok\",\"data\":{\"path\":\"";
-        ok_msg += tmpstr.c_str();
-        ok_msg += "\",\"files\":[";
-
+        writer.beginObject();
+        writer.add("cmd", "780");
+        writer.add("status", "ok");
+        writer.beginObject("data");
+        writer.add("path", tmpstr.c_str());
+        writer.beginArray("files");
       } else {
-        ok_msg = "Directory on Global FS : ";
-        ok_msg += tmpstr.c_str();
-        ok_msg += "\n";
-      }
-      msg->type = ESP3DMessageType::head;
-      if (!dispatch(msg, ok_msg.c_str())) {
-        esp3d_log_e("Error sending response to clients");
-        hasError = true;
+        writer.write("Directory on Global FS : ");
+        writer.write(tmpstr.c_str());
+        writer.write("\n");
       }
+      uint nbDirs = 0;
+      uint nbFiles = 0;
+      size_t totalSpace = ESP_GBFS::totalBytes(fsType);
+      size_t usedSpace = ESP_GBFS::usedBytes(fsType);
+      size_t freeSpace = ESP_GBFS::freeBytes(fsType);
 
-      if (!hasError) {
-        uint nbDirs = 0;
-        uint nbFiles = 0;
-        size_t totalSpace = ESP_GBFS::totalBytes(fsType);
-        size_t usedSpace = ESP_GBFS::usedBytes(fsType);
-        size_t freeSpace = ESP_GBFS::freeBytes(fsType);
-
-        ESP_GBFile sub;
-        sub = f.openNextFile();
-        while (sub && !hasError) {
-          if (sub.isDirectory()) {
-            ok_msg = "";
-            nbDirs++;
-            if (json) {
-              ok_msg = "";
-              if (nbDirs > 1) {
-                ok_msg += ",";
-              }
-              ok_msg += "{\"name\":\"";
-              ok_msg += sub.name();
-              ok_msg += "\",\"size\":\"-1\"}";
-            } else {
-              ok_msg = "[DIR] \t";
-              ok_msg += sub.name();
-            }
-            if (!json) {
-              ok_msg += "\n";
-            }
-            ESP3DMessage* newMsg = esp3d_message_manager.copyMsgInfos(msgInfo);
-            if (newMsg) {
-              newMsg->type = ESP3DMessageType::core;
-              if (!dispatch(newMsg, ok_msg.c_str())) {
-                esp3d_log_e("Error sending response to clients");
-                hasError = true;
-              }
-            } else {
-              esp3d_log_e("Error creating message");
-              hasError = true;
-            }
+      ESP_GBFile sub;
+      sub = f.openNextFile();
+      while (sub && !writer.hasError()) {
+        if (sub.isDirectory()) {
+          nbDirs++;
+          if (json) {
+            writer.beginObject();
+            writer.add("name", sub.name());
+            writer.add("size", "-1");
+            writer.endObject();
+          } else {
+            writer.write("[DIR] \t");
+            writer.write(sub.name());
+            writer.write("\n");
           }
-          sub.close();
-          sub = f.openNextFile();
         }
-        f.close();
-        f = ESP_GBFS::open(tmpstr.c_str(), ESP_FILE_READ);
-        // Check files
+        sub.close();
         sub = f.openNextFile();
-        while (sub && !hasError) {
-          if (!sub.isDirectory()) {
-            nbFiles++;
-            String time = "";
-            ok_msg = "";
+      }
+      f.close();
+      f = ESP_GBFS::open(tmpstr.c_str(), ESP_FILE_READ);
+      // Check files
+      sub = f.openNextFile();
+      while (sub && !writer.hasError()) {
+        if (!sub.isDirectory()) {
+          nbFiles++;
+          String time = "";
 #ifdef FILESYSTEM_TIMESTAMP_FEATURE
-            time = timeService.getDateTime((time_t)sub.getLastWrite());
+          time = timeService.getDateTime((time_t)sub.getLastWrite());
 #endif  // FILESYSTEM_TIMESTAMP_FEATURE
-            if (json) {
-              ok_msg = "";
-              if (nbDirs > 0 || nbFiles > 1) {
-                ok_msg += ",";
-              }
-              ok_msg += "{\"name\":\"";
-              ok_msg += sub.name();
-              ok_msg += "\",\"size\":\"";
-              ok_msg += esp3d_string::formatBytes(sub.size());
-              if (time.length() > 0) {
-                ok_msg += "\",\"time\":\"";
-                ok_msg += time;
-              }
-              ok_msg += "\"}";
-            } else {
-              ok_msg += "     \t ";
-              ok_msg += sub.name();
-              ok_msg += " \t";
-              ok_msg += esp3d_string::formatBytes(sub.size());
-              ok_msg += " \t";
-              ok_msg += time;
-            }
-            if (!json) {
-              ok_msg += "\n";
-            }
-            ESP3DMessage* newMsg = esp3d_message_manager.copyMsgInfos(msgInfo);
-            if (newMsg) {
-              newMsg->type = ESP3DMessageType::core;
-              if (!dispatch(newMsg, ok_msg.c_str())) {
-                esp3d_log_e("Error sending response to clients");
-                hasError = true;
-              }
-            } else {
-              esp3d_log_e("Error creating message");
-              hasError = true;
+          if (json) {
+            writer.beginObject();
+            writer.add("name", sub.name());
+            writer.add("size", esp3d_string::formatBytes(sub.size()));
+            if (time.length() > 0) {
+              writer.add("time", time.c_str());
             }
+            writer.endObject();
+          } else {
+            writer.write("     \t ");
+            writer.write(sub.name());
+            writer.write(" \t");
+            writer.write(esp3d_string::formatBytes(sub.size()));
+            writer.write(" \t");
+            writer.write(time.c_str());
+            writer.write("\n");
           }
-          sub.close();
-          sub = f.openNextFile();
         }
-        // end of json
-        if (json) {
-          ok_msg = "], \"total\":\"";
-          ok_msg += esp3d_string::formatBytes(totalSpace);
-          ok_msg += "\",\"used\":\"";
-          ok_msg += esp3d_string::formatBytes(usedSpace);
-          ok_msg += "\",\"occupation\":\"";
-          if (totalSpace == 0) {
-            totalSpace = 1;
-          }
-          uint occupation = round(100.0 * usedSpace / totalSpace);
-          if ((occupation < 1) && (usedSpace > 0)) {
-            occupation = 1;
-          }
-          ok_msg += String(occupation);
-          ok_msg += "\"}}";
-
-        } else {
-          ok_msg = "Files: ";
-          ok_msg += String(nbFiles);
-          ok_msg += ", Dirs :";
-          ok_msg += String(nbDirs);
-          ok_msg += "\nTotal: ";
-          ok_msg += esp3d_string::formatBytes(totalSpace);
-          ok_msg += ", Used: ";
-          ok_msg += esp3d_string::formatBytes(usedSpace);
-          ok_msg += ", Available: ";
-          ok_msg += esp3d_string::formatBytes(freeSpace);
-          ok_msg += "\n";
+        sub.close();
+        sub = f.openNextFile();
+      }
+      // end of json
+      if (json) {
+        writer.endArray();
+        writer.add("total", esp3d_string::formatBytes(totalSpace));
+        writer.add("used", esp3d_string::formatBytes(usedSpace));
+        if (totalSpace == 0) {
+          totalSpace = 1;
         }
-
-        ESP3DMessage* newMsg = esp3d_message_manager.copyMsgInfos(msgInfo);
-        newMsg->type = ESP3DMessageType::tail;
-        if (!dispatch(newMsg, ok_msg.c_str())) {
-          esp3d_log_e("Error sending response to clients");
+        uint occupation = round(100.0 * usedSpace / totalSpace);
+        if ((occupation < 1) && (usedSpace > 0)) {
+          occupation = 1;
         }
-        f.close();
+        writer.add("occupation", String(occupation).c_str());
+        writer.endObject();
+        writer.endObject();
+      } else {
+        writer.write("Files: ");
+        writer.write(String(nbFiles).c_str());
+        writer.write(", Dirs :");
+        writer.write(String(nbDirs).c_str());
+        writer.write("\nTotal: ");
+        writer.write(esp3d_string::formatBytes(totalSpace));
+        writer.write(", Used: ");
+        writer.write(esp3d_string::formatBytes(usedSpace));
+        writer.write(", Available: ");
+        writer.write(esp3d_string::formatBytes(freeSpace));
+        writer.write("\n");
+      }
+      f.close();
+      if (!writer.end()) {
+        esp3d_log_e("Error sending response to clients");
       }
+      esp3d_message_manager.deleteMsg(msg);
     } else {
       hasError = true;
       error_msg = "Invalid directory";
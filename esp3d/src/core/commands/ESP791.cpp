@@ -0,0 +1,167 @@
+/*
+ ESP791.cpp - ESP3D command class
+
+ Copyright (c) 2014 Luc Lebosse. All rights reserved.
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with This code; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "../../include/esp3d_config.h"
+#if defined(GLOBAL_FILESYSTEM_FEATURE)
+#include "../../modules/authentication/authentication_service.h"
+#include "../../modules/filesystem/esp_globalFS.h"
+#include "../esp3d_commands.h"
+#include "../esp3d_settings.h"
+
+#define COMMAND_ID 791
+
+static void addJobStatus(String& output, const ESP_GBFSJob* job, bool json) {
+  if (json) {
+    output += "{\"id\":\"";
+    output += String(job->id);
+    output += "\",\"type\":\"";
+    output += ESP_GBFS::jobTypeString(job->type);
+    output += "\",\"state\":\"";
+    output += ESP_GBFS::jobStateString(job->state);
+    output += "\",\"source\":\"";
+    output += job->source;
+    output += "\",\"destination\":\"";
+    output += job->destination;
+    output += "\",\"entries\":\"";
+    output += String(job->doneEntries);
+    output += "/";
+    output += String(job->totalEntries);
+    output += "\",\"bytes\":\"";
+    output += String((uint32_t)job->doneBytes);
+    output += "/";
+    output += String((uint32_t)job->totalBytes);
+    output += "\"}";
+  } else {
+    output += "Job ";
+    output += String(job->id);
+    output += ": ";
+    output += ESP_GBFS::jobTypeString(job->type);
+    output += " ";
+    output += job->source;
+    if (job->destination[0] != '\0') {
+      output += " to ";
+      output += job->destination;
+    }
+    output += ", ";
+    output += ESP_GBFS::jobStateString(job->state);
+    output += ", ";
+    output += String(job->doneEntries);
+    output += "/";
+    output += String(job->totalEntries);
+    output += " entries";
+    if (job->totalBytes > 0) {
+      output += ", ";
+      output += String((uint32_t)job->doneBytes);
+      output += "/";
+      output += String((uint32_t)job->totalBytes);
+      output += " bytes";
+    }
+    output += "\n";
+  }
+}
+
+// Background jobs on Global Filesystem
+// list / status / cancel / start remove, copy or move of file or directory
+//[ESP791]<remove=path> <copy=path> <move=path> <to=path> <id=job>
+// <cancel=job> json=<no> pwd=<admin password>
+void ESP3DCommands::ESP791(int cmd_params_pos, ESP3DMessage* msg) {
+  ESP3DClientType target = msg->origin;
+  ESP3DRequest requestId = msg->request_id;
+  (void)requestId;
+  msg->target = target;
+  msg->origin = ESP3DClientType::command;
+  bool hasError = false;
+  String error_msg = "Invalid parameters";
+  String ok_msg = "ok";
+  bool json = hasTag(msg, cmd_params_pos, "json");
+  String tmpstr;
+  const char* cmdList[] = {"remove=", "copy=", "move="};
+  const ESP_GBFSJobType typeList[] = {ESP_GBFSJobType::remove,
+                                      ESP_GBFSJobType::copy,
+                                      ESP_GBFSJobType::move};
+  uint8_t cmdListSize = sizeof(cmdList) / sizeof(char*);
+  uint8_t i;
+  for (i = 0; i < cmdListSize; i++) {
+    tmpstr = get_param(msg, cmd_params_pos, cmdList[i]);
+    if (tmpstr.length() != 0) {
+      break;
+    }
+  }
+  if (i < cmdListSize) {
+    // start a new job
+    String destination = get_param(msg, cmd_params_pos, "to=");
+    uint16_t id = ESP_GBFS::addJob(
+        typeList[i], tmpstr.c_str(),
+        destination.length() > 0 ? destination.c_str() : nullptr);
+    if (id == 0) {
+      hasError = true;
+      error_msg = "Job creation failed";
+    } else if (json) {
+      ok_msg = "{\"id\":\"";
+      ok_msg += String(id);
+      ok_msg += "\"}";
+    } else {
+      ok_msg = "Job ";
+      ok_msg += String(id);
+      ok_msg += " queued";
+    }
+  } else if ((tmpstr = get_param(msg, cmd_params_pos, "cancel=")).length() >
+             0) {
+    if (!ESP_GBFS::cancelJob(tmpstr.toInt())) {
+      hasError = true;
+      error_msg = "Cannot cancel job";
+    }
+  } else if ((tmpstr = get_param(msg, cmd_params_pos, "id=")).length() > 0) {
+    const ESP_GBFSJob* job = ESP_GBFS::getJob(tmpstr.toInt());
+    if (job) {
+      ok_msg = "";
+      addJobStatus(ok_msg, job, json);
+    } else {
+      hasError = true;
+      error_msg = "Unknown job";
+    }
+  } else if (get_clean_param(msg, cmd_params_pos).length() == 0) {
+    bool first = true;
+    ok_msg = json ? "{\"jobs\":[" : "";
+    for (i = 0; i < ESP_GBFS_MAX_JOBS; i++) {
+      const ESP_GBFSJob* job = ESP_GBFS::getJobByIndex(i);
+      if (!job) {
+        continue;
+      }
+      if (json && !first) {
+        ok_msg += ",";
+      }
+      addJobStatus(ok_msg, job, json);
+      first = false;
+    }
+    if (json) {
+      ok_msg += "]}";
+    } else if (first) {
+      ok_msg = "No job";
+    }
+  } else {
+    hasError = true;
+  }
+
+  if (!dispatchAnswer(msg, COMMAND_ID, json, !hasError,
+                      hasError ? error_msg.c_str() : ok_msg.c_str())) {
+    esp3d_log_e("Error sending response to clients");
+  }
+}
+#endif  // GLOBAL_FILESYSTEM_FEATURE
@@ -19,7 +19,6 @@
 */
 #include "../../include/esp3d_config.h"
 #include "../../modules/authentication/authentication_service.h"
-#include "../../modules/network/netconfig.h"
 #include "../esp3d_commands.h"
 #include "../esp3d_settings.h"
 
@@ -61,12 +60,6 @@ void ESP3DCommands::ESP800(int cmd_params_pos, ESP3DMessage* msg) {
   String setupparam = get_param(msg, cmd_params_pos, "setup=");
   bool json = hasTag(msg, cmd_params_pos, "json");
   String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
 #if defined(TIMESTAMP_FEATURE)
   // set time if internet time is not enabled
   if (!timeService.isInternetTime()) {
@@ -110,7 +103,11 @@ void ESP3DCommands::ESP800(int cmd_params_pos, ESP3DMessage* msg) {
     tmpstr = "Capabilities:\n";
   }
   msg->type = ESP3DMessageType::head;
-  if (!dispatch(msg, tmpstr.c_str())) {
+  ESP3DAuthenticationLevel auth = msg->authentication_level;
+  bool sent = dispatch(msg, tmpstr.c_str());
+  // next answers are sent without request message
+  esp3d_message_manager.deleteMsg(msg);
+  if (!sent) {
     esp3d_log_e("Error sending response to clients");
     return;
   }
@@ -132,7 +129,7 @@ void ESP3DCommands::ESP800(int cmd_params_pos, ESP3DMessage* msg) {
     return;
   }
   // FW Target ID
-  tmpstr = ESP3DSettings::GetFirmwareTarget();
+  tmpstr = String(ESP3DSettings::GetFirmwareTarget());
   if (!dispatchKeyValue(json, "FWTargetID", tmpstr.c_str(), target,
                         requestId)) {
     return;
@@ -277,11 +274,13 @@ void ESP3DCommands::ESP800(int cmd_params_pos, ESP3DMessage* msg) {
 #endif  // CAMERA_DEVICE
   // end of list
   if (json) {
-    if (!dispatch(msg, "}}", target, requestId, ESP3DMessageType::tail, msg->authentication_level)) {
+    if (!dispatch(nullptr, "}}", target, requestId,
+                  ESP3DMessageType::tail, auth)) {
       esp3d_log_e("Error sending answer to clients");
     }
   } else {
-    if (!dispatch(msg, "ok\n", target, requestId, ESP3DMessageType::tail, msg->authentication_level)) {
+    if (!dispatch(nullptr, "ok\n", target, requestId,
+                  ESP3DMessageType::tail, auth)) {
       esp3d_log_e("Error sending answer to clients");
     }
   }
@@ -39,13 +39,6 @@ void ESP3DCommands::ESP900(int cmd_params_pos, ESP3DMessage* msg) {
   bool enabled = hasTag(msg, cmd_params_pos, "ENABLE");
   bool disabled = hasTag(msg, cmd_params_pos, "DISABLE");
   String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   tmpstr = get_clean_param(msg, cmd_params_pos);
   if (tmpstr.length() == 0) {
     if (esp3d_serial_service.started()) {
@@ -41,13 +41,6 @@ void ESP3DCommands::ESP930(int cmd_params_pos, ESP3DMessage* msg) {
   bool disabled = hasTag(msg, cmd_params_pos, "DISABLE");
   bool close = hasTag(msg, cmd_params_pos, "CLOSE");
   String tmpstr;
-#if defined(AUTHENTICATION_FEATURE)
-  if (msg->authentication_level == ESP3DAuthenticationLevel::guest) {
-    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
-    dispatchAuthenticationError(msg, COMMAND_ID, json);
-    return;
-  }
-#endif  // AUTHENTICATION_FEATURE
   tmpstr = get_clean_param(msg, cmd_params_pos);
   if (tmpstr.length() == 0) {
     if (ESP3DSettings::readByte(ESP_SERIAL_BRIDGE_ON) == 1) {
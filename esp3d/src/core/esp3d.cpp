@@ -41,6 +41,12 @@
 #if defined(FILESYSTEM_FEATURE)
 #include "../modules/filesystem/esp_filesystem.h"
 #endif  // FILESYSTEM_FEATURE
+#if defined(GLOBAL_FILESYSTEM_FEATURE)
+#include "../modules/filesystem/esp_globalFS.h"
+#endif  // GLOBAL_FILESYSTEM_FEATURE
+#if defined(SD_DEVICE)
+#include "../modules/filesystem/esp_sd.h"
+#endif  // SD_DEVICE
 #ifdef CONNECTED_DEVICES_FEATURE
 #include "../modules/devices/devices_services.h"
 #endif  // CONNECTED_DEVICES_FEATURE
@@ -50,6 +56,9 @@
 #ifdef GCODE_HOST_FEATURE
 #include "../modules/gcode_host/gcode_host.h"
 #endif  // GCODE_HOST_FEATURE
+#ifdef PRINTER_STATE_FEATURE
+#include "../modules/printer_state/printer_state.h"
+#endif  // PRINTER_STATE_FEATURE
 #ifdef SD_UPDATE_FEATURE
 #include "../modules/update/update_service.h"
 #endif  // SD_UPDATE_FEATURE
@@ -135,6 +144,8 @@ bool Esp3D::begin() {
     esp3d_log_e("Error with serial service");
     res = false;
   }
+  // output client was checked before serial started
+  esp3d_commands.getOutputClient(true);
 #endif  // COMMUNICATION_PROTOCOL == RAW_SERIAL || COMMUNICATION_PROTOCOL == MKS_SERIAL
 
 #if defined(ESP_SERIAL_BRIDGE_OUTPUT)
@@ -145,6 +156,11 @@ bool Esp3D::begin() {
   }
 #endif  // ESP_SERIAL_BRIDGE_OUTPUT
 
+#if defined(PRINTER_STATE_FEATURE)
+  esp3d_log("Starting printer state");
+  esp3d_printer_state.begin();
+#endif  // PRINTER_STATE_FEATURE
+
 #if defined(FILESYSTEM_FEATURE)
   esp3d_log("Starting Filesystem feature");
   if (!ESP_FileSystem::begin()) {
@@ -231,9 +247,18 @@ void Esp3D::handle() {
 #if defined(CONNECTED_DEVICES_FEATURE)
   DevicesServices::handle();
 #endif  // CONNECTED_DEVICES_FEATURE
+#if defined(SD_DEVICE)
+  ESP_SD::handle();
+#endif  // SD_DEVICE
+#if defined(GLOBAL_FILESYSTEM_FEATURE)
+  ESP_GBFS::handle();
+#endif  // GLOBAL_FILESYSTEM_FEATURE
 #if defined(GCODE_HOST_FEATURE)
   esp3d_gcode_host.handle();
 #endif  // GCODE_HOST_FEATURE
+#if defined(PRINTER_STATE_FEATURE)
+  esp3d_printer_state.handle();
+#endif  // PRINTER_STATE_FEATURE
 #ifdef ESP_LUA_INTERPRETER_FEATURE
   esp3d_lua_interpreter.handle();
 #endif  // ESP_LUA_INTERPRETER_FEATURE
@@ -262,6 +287,9 @@ bool Esp3D::end() {
   ESP_FileSystem::end();
   esp3d_log("Filesystem stopped");
 #endif  // FILESYSTEM_FEATURE
+#if defined(PRINTER_STATE_FEATURE)
+  esp3d_printer_state.end();
+#endif  // PRINTER_STATE_FEATURE
 #if defined(USB_SERIAL_FEATURE)
   esp3d_usb_serial_service.end();
   esp3d_log("USB serial stopped");
@@ -0,0 +1,176 @@
+/*
+  esp3d_args.cpp - ESP3D commands parameters tokenizer
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "esp3d_args.h"
+
+#include "esp3d_log.h"
+
+// FNV-1a
+static uint32_t argsHash(const char* data, size_t size, size_t start) {
+  uint32_t hash = 2166136261UL;
+  for (size_t i = start; i < size; i++) {
+    hash ^= (uint8_t)data[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+void ESP3DArgs::clear() {
+  _buffer[0] = '\0';
+  _count = 0;
+  _clean = -1;
+  _truncated = false;
+  _source = nullptr;
+  _size = 0;
+  _start = 0;
+  _hash = 0;
+}
+
+bool ESP3DArgs::isParsed(const char* data, size_t size, size_t start) const {
+  return data && _source == data && _size == size && _start == start &&
+         _hash == argsHash(data, size, start);
+}
+
+bool ESP3DArgs::parse(const char* data, size_t size, size_t start) {
+  clear();
+  if (!data) {
+    return false;
+  }
+  _source = data;
+  _size = size;
+  _start = start;
+  _hash = argsHash(data, size, start);
+  size_t pos = 0;
+  size_t i = start;
+  bool truncated = false;
+  while (i < size && !truncated) {
+    // skip separators
+    while (i < size && isspace((uint8_t)data[i])) {
+      i++;
+    }
+    if (i >= size) {
+      break;
+    }
+    if (_count == ESP3D_ARGS_MAX_TOKENS || pos >= ESP3D_ARGS_BUFFER_SIZE - 1) {
+      truncated = true;
+      break;
+    }
+    size_t tokenStart = pos;
+    bool inQuote = false;
+    bool hasKey = false;
+    // quote is only allowed at token start or right after first `=`
+    bool quoteAllowed = true;
+    while (i < size) {
+      char c = data[i];
+      if (c == '\\' && i + 1 < size) {
+        c = data[++i];
+        quoteAllowed = false;
+      } else if (c == '"' && (inQuote || quoteAllowed)) {
+        inQuote = !inQuote;
+        quoteAllowed = false;
+        i++;
+        continue;
+      } else if (!inQuote && isspace((uint8_t)c)) {
+        break;
+      } else if (c == '=' && !hasKey && !inQuote) {
+        hasKey = true;
+        quoteAllowed = true;
+        _buffer[pos++] = c;
+        i++;
+        if (pos >= ESP3D_ARGS_BUFFER_SIZE - 1) {
+          truncated = true;
+          break;
+        }
+        continue;
+      } else {
+        quoteAllowed = false;
+      }
+      if (pos >= ESP3D_ARGS_BUFFER_SIZE - 1) {
+        truncated = true;
+        break;
+      }
+      _buffer[pos++] = c;
+      i++;
+    }
+    _buffer[pos++] = '\0';
+    _tokens[_count] = tokenStart;
+    const char* tok = &_buffer[tokenStart];
+    if (_clean == -1 && strcmp(tok, "json") != 0 &&
+        strncmp(tok, "json=", 5) != 0 && strncmp(tok, "pwd=", 4) != 0) {
+      _clean = _count;
+    }
+    _count++;
+  }
+  if (truncated) {
+    _truncated = true;
+    esp3d_log_e("Parameters truncated, %d tokens", _count);
+    return false;
+  }
+  return true;
+}
+
+const char* ESP3DArgs::token(uint8_t index) const {
+  if (index >= _count) {
+    return "";
+  }
+  return &_buffer[_tokens[index]];
+}
+
+const char* ESP3DArgs::get(const char* label, bool* found) const {
+  size_t len = strlen(label);
+  for (uint8_t i = 0; i < _count; i++) {
+    const char* tok = &_buffer[_tokens[i]];
+    if (strncmp(tok, label, len) == 0) {
+      if (found) {
+        *found = true;
+      }
+      return tok + len;
+    }
+  }
+  if (found) {
+    *found = false;
+  }
+  return "";
+}
+
+bool ESP3DArgs::hasTag(const char* label) const {
+  size_t len = strlen(label);
+  for (uint8_t i = 0; i < _count; i++) {
+    const char* tok = &_buffer[_tokens[i]];
+    if (strncmp(tok, label, len) != 0) {
+      continue;
+    }
+    if (tok[len] == '\0') {
+      return true;
+    }
+    if (tok[len] == '=' && tok[len + 1] != '\0') {
+      const char* value = tok + len + 1;
+      return strcasecmp(value, "YES") == 0 || strcasecmp(value, "TRUE") == 0 ||
+             strcmp(value, "1") == 0;
+    }
+  }
+  return false;
+}
+
+const char* ESP3DArgs::clean() const {
+  if (_clean == -1) {
+    return "";
+  }
+  return &_buffer[_tokens[_clean]];
+}
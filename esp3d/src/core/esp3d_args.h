@@ -0,0 +1,64 @@
+/*
+  esp3d_args.h - ESP3D commands parameters tokenizer
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _ESP3D_ARGS_H
+#define _ESP3D_ARGS_H
+
+#include <Arduino.h>
+
+#include "../include/esp3d_config.h"
+
+// Parameters of one [ESPxxx] line, split once in place:
+// tokens are separated by spaces, `\` escapes next char,
+// "..." quotes a whole token or the value after `=`
+// Each token is stored unescaped and NUL terminated in _buffer
+class ESP3DArgs {
+ public:
+  ESP3DArgs() { clear(); }
+  void clear();
+  // return false if parameters were truncated
+  bool parse(const char* data, size_t size, size_t start);
+  // a buffer reused at same address with other content does not match:
+  // size and hash of parameters are compared too
+  bool isParsed(const char* data, size_t size, size_t start) const;
+  // more than ESP3D_ARGS_MAX_TOKENS or ESP3D_ARGS_BUFFER_SIZE
+  bool truncated() const { return _truncated; }
+  // label is the prefix including `=` (e.g. "pwd="), return "" if absent
+  const char* get(const char* label, bool* found = nullptr) const;
+  // label=YES/TRUE/1 or label alone
+  bool hasTag(const char* label) const;
+  // first token which is not json/pwd
+  const char* clean() const;
+  uint8_t count() const { return _count; }
+  const char* token(uint8_t index) const;
+
+ private:
+  char _buffer[ESP3D_ARGS_BUFFER_SIZE];
+  uint16_t _tokens[ESP3D_ARGS_MAX_TOKENS];
+  uint8_t _count;
+  int8_t _clean;
+  bool _truncated;
+  const char* _source;
+  size_t _size;
+  size_t _start;
+  uint32_t _hash;
+};
+
+#endif  //_ESP3D_ARGS_H
@@ -19,6 +19,8 @@
 */
 
 #include "esp3d_commands.h"
+#include "esp3d_args.h"
+#include "esp3d_json_writer.h"
 #include "../include/esp3d_config.h"
 #include "esp3d.h"
 #include "esp3d_settings.h"
@@ -216,52 +218,36 @@ const char *ESP3DCommands::format_response(uint cmdID, bool isjson, bool isok,
   return res.c_str();
 }
 
+// Parameters of the command currently executed by this task
+// handlers run synchronously so lookups use it without parsing again
+#if defined(ARDUINO_ARCH_ESP32)
+static thread_local const ESP3DArgs *currentArgs = nullptr;
+#else
+static const ESP3DArgs *currentArgs = nullptr;
+#endif  // ARDUINO_ARCH_ESP32
+
+// Parameters of the running command, or nullptr if data is something else
+static const ESP3DArgs *lookupArgs(const char *data, uint size, uint start) {
+  if (currentArgs && currentArgs->isParsed(data, size, start)) {
+    return currentArgs;
+  }
+  return nullptr;
+}
+
 bool ESP3DCommands::hasTag(ESP3DMessage *msg, uint start, const char *label) {
   if (!msg) {
     esp3d_log_e("No msg for tag %s", label);
     return false;
   }
-  String lbl = label;
-  esp3d_log("Checking message for tag %s", label);
-  uint lenLabel = strlen(label);
-  lbl += "=";
-  lbl = get_param(msg, start, lbl.c_str());
-  if (lbl.length() != 0) {
-    esp3d_log("Label is used with parameter %s", lbl.c_str());
-    lbl.toUpperCase();
-    return (lbl == "YES" || lbl == "1" || lbl == "TRUE");
-  }
-  bool prevCharIsEscaped = false;
-  bool prevCharIsspace = true;
-  for (uint i = start; i < msg->size; i++) {
-    char c = char(msg->data[i]);
-    if (c == label[0] && prevCharIsspace) {
-      uint p = 0;
-      while (i < msg->size && p < lenLabel && c == label[p]) {
-        i++;
-        p++;
-        if (i < msg->size) {
-          c = char(msg->data[i]);
-        }
-      }
-      if (p == lenLabel) {
-        if (i == msg->size || std::isspace(c)) {
-          esp3d_log("Label %s found", label);
-          return true;
-        }
-      }
-      if (std::isspace(c) && !prevCharIsEscaped) {
-        prevCharIsspace = true;
-      }
-      if (c == '\\') {
-        prevCharIsEscaped = true;
-      } else {
-        prevCharIsEscaped = false;
-      }
-    }
+  const ESP3DArgs *current =
+      lookupArgs((const char *)msg->data, msg->size, start);
+  if (current) {
+    return current->hasTag(label);
   }
-  esp3d_log("Label %s not found", label);
-  return false;
+  // outside of a command execution, parse for this call only
+  ESP3DArgs args;
+  args.parse((const char *)msg->data, msg->size, start);
+  return args.hasTag(label);
 }
 
 const char *ESP3DCommands::get_param(ESP3DMessage *msg, uint start,
@@ -273,61 +259,20 @@ const char *ESP3DCommands::get_param(ESP3DMessage *msg, uint start,
   return get_param((const char *)msg->data, msg->size, start, label, found);
 }
 
+// Returned values point in tokens of the running command, so they are only
+// available during a command execution
 const char *ESP3DCommands::get_param(const char *data, uint size, uint start,
                                      const char *label, bool *found) {
   esp3d_log("Getting param %s", label);
-  int startPos = -1;
-  uint lenLabel = strlen(label);
-  static String value;
-  bool prevCharIsEscaped = false;
-  bool prevCharIsspace = true;
-  value = "";
-  uint startp = start;
-  if (found) {
-    *found = false;
-  }
-  if (data[startp] == ' ') {
-    while (data[startp] == ' ' && startp < size) {
-      startp++;
-    }
-  }
-  for (uint i = startp; i < size; i++) {
-    char c = char(data[i]);
-    if (c == label[0] && startPos == -1 && prevCharIsspace) {
-      uint p = 0;
-      while (i < size && p < lenLabel && c == label[p]) {
-        i++;
-        p++;
-        if (i < size) {
-          c = char(data[i]);
-        }
-      }
-      if (p == lenLabel) {
-        startPos = i;
-        if (found) {
-          *found = true;
-        }
-      }
-    }
-    if (std::isspace(c) && !prevCharIsEscaped) {
-      prevCharIsspace = true;
-    }
-    if (startPos > -1 && i < size) {
-      if (c == '\\') {
-        prevCharIsEscaped = true;
-      }
-      if (std::isspace(c) && !prevCharIsEscaped) {
-        esp3d_log("Found param %s: %s", label, value.c_str());
-        return value.c_str();
-      }
-      if (c != '\\') {
-        value += c;
-        prevCharIsEscaped = false;
-      }
+  const ESP3DArgs *current = lookupArgs(data, size, start);
+  if (!current) {
+    esp3d_log_e("Param %s looked up outside of command execution", label);
+    if (found) {
+      *found = false;
     }
+    return "";
   }
-  esp3d_log("Found param %s: %s", label, value.c_str());
-  return value.c_str();
+  return current->get(label, found);
 }
 
 const char *ESP3DCommands::get_clean_param(ESP3DMessage *msg, uint start) {
@@ -335,647 +280,524 @@ const char *ESP3DCommands::get_clean_param(ESP3DMessage *msg, uint start) {
     esp3d_log_e("No message");
     return "";
   }
-  static String value;
-  bool prevCharIsEscaped = false;
-  uint startp = start;
-  while (char(msg->data[startp]) == ' ' && startp < msg->size) {
-    startp++;
-  }
-  value = "";
-  for (uint i = startp; i < msg->size; i++) {
-    char c = char(msg->data[i]);
-    if (c == '\\') {
-      prevCharIsEscaped = true;
-    }
-    if (std::isspace(c) && !prevCharIsEscaped) {
-      esp3d_log("Testing clean param: %s", value.c_str());
-      if (value == "json" || value.startsWith("json=") ||
-          value.startsWith("pwd=")) {
-        esp3d_log("Clearing param: %s", value.c_str());
-        value = "";
-      } else {
-        esp3d_log("Returning clean param: %s", value.c_str());
-        return value.c_str();
-      }
-    }
-    if (c != '\\') {
-      if ((std::isspace(c) && prevCharIsEscaped) || !std::isspace(c)) {
-        value += c;
-      }
-      prevCharIsEscaped = false;
-    }
-  }
-  esp3d_log("Testing clean param: %s", value.c_str());
-  if (value == "json" || value.startsWith("json=") ||
-      value.startsWith("pwd=")) {
-    esp3d_log("Clearing param: %s", value.c_str());
-    value = "";
+  const ESP3DArgs *current =
+      lookupArgs((const char *)msg->data, msg->size, start);
+  if (!current) {
+    esp3d_log_e("Param looked up outside of command execution");
+    return "";
   }
-  esp3d_log("Returning clean param: %s", value.c_str());
-  return value.c_str();
+  return current->clean();
 }
 
 bool ESP3DCommands::has_param(ESP3DMessage *msg, uint start) {
   return strlen(get_clean_param(msg, start)) != 0;
 }
 
-void ESP3DCommands::process(ESP3DMessage *msg) {
-  if (!msg || !msg->data || msg->size == 0) {
-    esp3d_log_e("Invalid message for processing");
-    return;
-  }
-  esp3d_log("Processing message from client %s, size: %zu",
-            GETCLIENTSTR(msg->origin), msg->size);
-
-  // Check if it's an ESP command
-  if (!is_esp_command(msg->data, msg->size)) {
-    esp3d_log("Not an ESP command");
-    dispatchAnswer(msg, 0, hasTag(msg, 0, "json"), false, "Not an ESP command");
-    return;
+#define ESP3D_COMMAND(cmdid, auth, cmdflags)                      \
+  {                                                             \
+    cmdid, &ESP3DCommands::ESP##cmdid, ESP3DAuthenticationLevel::auth, \
+        cmdflags                                                \
   }
 
-  // Extract command ID
-  String cmdStr = String((const char *)msg->data);
-  int startCmd = cmdStr.indexOf("[ESP") + 4;
-  int endCmd = cmdStr.indexOf(']', startCmd);
-  if (endCmd == -1 || startCmd == -1) {
-    esp3d_log_e("Invalid ESP command format");
-    dispatchAnswer(msg, 0, hasTag(msg, 0, "json"), false, "Invalid command format");
-    return;
-  }
-
-  String cmdIdStr = cmdStr.substring(startCmd, endCmd);
-  int cmdId = cmdIdStr.toInt();
-  int cmd_params_pos = endCmd + 1;
-
-  // Handle echo prefix if present
-  if (cmdStr.startsWith("echo: ")) {
-    cmd_params_pos += 6; // Skip "echo: "
-  }
-
-  // Execute the command
-  execute_internal_command(cmdId, cmd_params_pos, msg);
-}
-
-void ESP3DCommands::execute_internal_command(int cmd, int cmd_params_pos,
-                                             ESP3DMessage *msg) {
-  if (!msg) {
-    esp3d_log_e("No msg for cmd %d", cmd);
-    return;
-  }
-  esp3d_log("Executing command %d", cmd);
-#ifdef AUTHENTICATION_FEATURE
-  String pwd = get_param(msg, cmd_params_pos, "pwd=");
-  if (pwd.length() != 0 && (msg->origin == ESP3DClientType::serial ||
-                            msg->origin == ESP3DClientType::serial_bridge ||
-                            msg->origin == ESP3DClientType::telnet ||
-                            msg->origin == ESP3DClientType::websocket ||
-                            msg->origin == ESP3DClientType::usb_serial ||
-                            msg->origin == ESP3DClientType::bluetooth)) {
-    msg->authentication_level =
-        AuthenticationService::getAuthenticatedLevel(pwd.c_str(), msg);
-    esp3d_log("Authentication level set to %d", msg->authentication_level);
-    switch (msg->origin) {
-      case ESP3DClientType::serial:
-        esp3d_serial_service.setAuthentication(msg->authentication_level);
-        break;
-#if defined(ESP_SERIAL_BRIDGE_OUTPUT)
-      case ESP3DClientType::serial_bridge:
-        serial_bridge_service.setAuthentication(msg->authentication_level);
-        break;
-#endif  // ESP_SERIAL_BRIDGE_OUTPUT
-#if defined(USB_SERIAL_FEATURE)
-      case ESP3DClientType::usb_serial:
-        esp3d_usb_serial_service.setAuthentication(msg->authentication_level);
-        break;
-#endif  // USB_SERIAL_FEATURE
-#if defined(TELNET_FEATURE)
-      case ESP3DClientType::telnet:
-        telnet_server.setAuthentication(msg->authentication_level);
-        break;
-#endif  // TELNET_FEATURE
-#if defined(WS_DATA_FEATURE)
-      case ESP3DClientType::websocket:
-        websocket_data_server.setAuthentication(msg->authentication_level);
-        break;
-#endif  // WS_DATA_FEATURE
-#ifdef BLUETOOTH_FEATURE
-      case ESP3DClientType::bluetooth:
-        bt_service.setAuthentication(msg->authentication_level);
-        break;
-#endif  // BLUETOOTH_FEATURE
-      default:
-        break;
-    }
-  }
-#endif  // AUTHENTICATION_FEATURE
-
-  bool json = hasTag(msg, cmd_params_pos, "json");
-  esp3d_log("JSON output: %d", json);
-
-  switch (cmd) {
+// Commands table, must stay sorted by id
+// Each feature registers its commands here, at compile time
+static constexpr ESP3DCommandEntry esp3dCommandsTable[] PROGMEM = {
     // ESP3D Help
-    case 0:
-      esp3d_log("Processing [ESP0]");
-      ESP0(cmd_params_pos, msg);
-      break;
-
+    ESP3D_COMMAND(0, guest, ESP3D_CMD_FLAG_NONE),
 #if defined(WIFI_FEATURE)
     // STA SSID
-    case 100:
-      esp3d_log("Processing [ESP100]");
-      ESP100(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(100, user, ESP3D_CMD_FLAG_SETTING),
     // STA Password
-    case 101:
-      esp3d_log("Processing [ESP101]");
-      ESP101(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(101, admin, ESP3D_CMD_FLAG_SETTING),
     // Change STA IP mode (DHCP/STATIC)
-    case 102:
-      esp3d_log("Processing [ESP102]");
-      ESP102(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(102, user, ESP3D_CMD_FLAG_SETTING),
     // Change STA IP/Mask/GW
-    case 103:
-      esp3d_log("Processing [ESP103]");
-      ESP103(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(103, user, ESP3D_CMD_FLAG_SETTING),
     // Set fallback mode
-    case 104:
-      esp3d_log("Processing [ESP104]");
-      ESP104(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(104, user, ESP3D_CMD_FLAG_SETTING),
     // AP SSID
-    case 105:
-      esp3d_log("Processing [ESP105]");
-      ESP105(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(105, user, ESP3D_CMD_FLAG_SETTING),
     // AP Password
-    case 106:
-      esp3d_log("Processing [ESP106]");
-      ESP106(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(106, user, ESP3D_CMD_FLAG_SETTING),
     // Change AP IP
-    case 107:
-      esp3d_log("Processing [ESP107]");
-      ESP107(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(107, user, ESP3D_CMD_FLAG_SETTING),
     // Change AP channel
-    case 108:
-      esp3d_log("Processing [ESP108]");
-      ESP108(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(108, user, ESP3D_CMD_FLAG_SETTING),
 #endif  // WIFI_FEATURE
-
 #if defined(WIFI_FEATURE) || defined(BLUETOOTH_FEATURE) || defined(ETH_FEATURE)
     // Set radio state
-    case 110:
-      esp3d_log("Processing [ESP110]");
-      ESP110(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(110, user, ESP3D_CMD_FLAG_SETTING | ESP3D_CMD_FLAG_SLOW),
 #endif  // WIFI_FEATURE || BLUETOOTH_FEATURE || ETH_FEATURE
-
 #if defined(WIFI_FEATURE) || defined(ETH_FEATURE)
     // Get current IP
-    case 111:
-      esp3d_log("Processing [ESP111]");
-      ESP111(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(111, user, ESP3D_CMD_FLAG_NONE),
 #endif  // WIFI_FEATURE || ETH_FEATURE
-
 #if defined(WIFI_FEATURE) || defined(ETH_FEATURE) || defined(BT_FEATURE)
     // Get/Set hostname
-    case 112:
-      esp3d_log("Processing [ESP112]");
-      ESP112(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(112, user, ESP3D_CMD_FLAG_SETTING),
     // Get/Set boot Network state
-    case 114:
-      esp3d_log("Processing [ESP114]");
-      ESP114(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(114, user, ESP3D_CMD_FLAG_SETTING),
     // Get/Set immediate Network state
-    case 115:
-      esp3d_log("Processing [ESP115]");
-      ESP115(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(115, user, ESP3D_CMD_FLAG_SLOW),
 #endif  // WIFI_FEATURE || ETH_FEATURE || BT_FEATURE
-
 #if defined(ETH_FEATURE)
     // Change ETH STA IP mode
-    case 116:
-      esp3d_log("Processing [ESP116]");
-      ESP116(cmd_params_pos, msg); // Fixed: Changed from ESP102 to ESP116
-      break;
+    ESP3D_COMMAND(116, user, ESP3D_CMD_FLAG_SETTING),
     // Change ETH STA IP/Mask/GW
-    case 117:
-      esp3d_log("Processing [ESP117]");
-      ESP117(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(117, user, ESP3D_CMD_FLAG_SETTING),
     // Set fallback mode
-    case 118:
-      esp3d_log("Processing [ESP118]");
-      ESP118(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(118, user, ESP3D_CMD_FLAG_SETTING),
 #endif  // ETH_FEATURE
-
 #ifdef HTTP_FEATURE
     // Set HTTP state
-    case 120:
-      esp3d_log("Processing [ESP120]");
-      ESP120(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(120, user, ESP3D_CMD_FLAG_SETTING),
     // Set HTTP port
-    case 121:
-      esp3d_log("Processing [ESP121]");
-      ESP121(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(121, user, ESP3D_CMD_FLAG_SETTING),
 #endif  // HTTP_FEATURE
-
 #ifdef TELNET_FEATURE
     // Set Telnet state
-    case 130:
-      esp3d_log("Processing [ESP130]");
-      ESP130(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(130, user, ESP3D_CMD_FLAG_SETTING),
     // Set Telnet port
-    case 131:
-      esp3d_log("Processing [ESP131]");
-      ESP131(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(131, user, ESP3D_CMD_FLAG_SETTING),
 #endif  // TELNET_FEATURE
-
 #ifdef TIMESTAMP_FEATURE
     // Sync/Set/Get time
-    case 140:
-      esp3d_log("Processing [ESP140]");
-      ESP140(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(140, user, ESP3D_CMD_FLAG_SETTING | ESP3D_CMD_FLAG_SLOW),
 #endif  // TIMESTAMP_FEATURE
-
     // Get/Set boot delay
-    case 150:
-      esp3d_log("Processing [ESP150]");
-      ESP150(cmd_params_pos, msg);
-      break;
-
+    ESP3D_COMMAND(150, user, ESP3D_CMD_FLAG_SETTING),
 #ifdef WS_DATA_FEATURE
     // Set WebSocket state
-    case 160:
-      esp3d_log("Processing [ESP160]");
-      ESP160(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(160, user, ESP3D_CMD_FLAG_SETTING),
     // Set WebSocket port
-    case 161:
-      esp3d_log("Processing [ESP161]");
-      ESP161(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(161, user, ESP3D_CMD_FLAG_SETTING),
 #endif  // WS_DATA_FEATURE
-
 #ifdef CAMERA_DEVICE
     // Get/Set Camera settings
-    case 170:
-      esp3d_log("Processing [ESP170]");
-      ESP170(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(170, user, ESP3D_CMD_FLAG_NONE),
     // Save frame
-    case 171:
-      esp3d_log("Processing [ESP171]");
-      ESP171(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(171, user, ESP3D_CMD_FLAG_SLOW),
 #endif  // CAMERA_DEVICE
-
 #ifdef FTP_FEATURE
     // Set FTP state
-    case 180:
-      esp3d_log("Processing [ESP180]");
-      ESP180(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(180, user, ESP3D_CMD_FLAG_SETTING),
     // Set/Get FTP ports
-    case 181:
-      esp3d_log("Processing [ESP181]");
-      ESP181(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(181, user, ESP3D_CMD_FLAG_SETTING),
 #endif  // FTP_FEATURE
-
 #ifdef WEBDAV_FEATURE
     // Set WebDAV state
-    case 190:
-      esp3d_log("Processing [ESP190]");
-      ESP190(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(190, user, ESP3D_CMD_FLAG_SETTING),
     // Set/Get WebDAV port
-    case 191:
-      esp3d_log("Processing [ESP191]");
-      ESP191(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(191, user, ESP3D_CMD_FLAG_SETTING),
 #endif  // WEBDAV_FEATURE
-
 #if defined(SD_DEVICE)
     // Get/Set SD Card Status
-    case 200:
-      esp3d_log("Processing [ESP200]");
-      ESP200(cmd_params_pos, msg);
-      break;
-#if SD_DEVICE != ESP_SDIO
-    // Get/Set SD card Speed
-    case 202:
-      esp3d_log("Processing [ESP202]");
-      ESP202(cmd_params_pos, msg);
-      break;
-#endif  // SD_DEVICE != ESP_SDIO
-#ifdef SD_UPDATE_FEATURE
-    // Get/Set SD Check at boot
-    case 402:
-      esp3d_log("Processing [ESP402]");
-      ESP402(cmd_params_pos, msg);
-      break;
-#endif  // SD_UPDATE_FEATURE
+    ESP3D_COMMAND(200, user, ESP3D_CMD_FLAG_NONE),
 #endif  // SD_DEVICE
-
 #ifdef DIRECT_PIN_FEATURE
     // Get/Set pin value
-    case 201:
-      esp3d_log("Processing [ESP201]");
-      ESP201(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(201, user, ESP3D_CMD_FLAG_NONE),
 #endif  // DIRECT_PIN_FEATURE
-
+#if defined(SD_DEVICE) && SD_DEVICE != ESP_SDIO
+    // Get/Set SD card Speed
+    ESP3D_COMMAND(202, user, ESP3D_CMD_FLAG_SETTING),
+#endif  // SD_DEVICE && SD_DEVICE != ESP_SDIO
 #ifdef SENSOR_DEVICE
     // Get/Set SENSOR
-    case 210:
-      esp3d_log("Processing [ESP210]");
-      ESP210(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(210, user, ESP3D_CMD_FLAG_SETTING),
 #endif  // SENSOR_DEVICE
-
 #if defined(PRINTER_HAS_DISPLAY)
     // Output to printer screen
-    case 212:
-      esp3d_log("Processing [ESP212]");
-      ESP212(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(212, user, ESP3D_CMD_FLAG_NONE),
 #endif  // PRINTER_HAS_DISPLAY
-
 #if defined(DISPLAY_DEVICE)
     // Output to ESP screen
-    case 214:
-      esp3d_log("Processing [ESP214]");
-      ESP214(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(214, user, ESP3D_CMD_FLAG_NONE),
 #if defined(DISPLAY_TOUCH_DRIVER)
     // Touch Calibration
-    case 215:
-      esp3d_log("Processing [ESP215]");
-      ESP215(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(215, guest, ESP3D_CMD_FLAG_SETTING | ESP3D_CMD_FLAG_SLOW),
 #endif  // DISPLAY_TOUCH_DRIVER
 #endif  // DISPLAY_DEVICE
-
+    // Show pins
+    ESP3D_COMMAND(220, user, ESP3D_CMD_FLAG_NONE),
+#if defined(PRINTER_STATE_FEATURE)
+    // Get printer state / Set query interval
+    ESP3D_COMMAND(230, user, ESP3D_CMD_FLAG_NONE),
+#endif  // PRINTER_STATE_FEATURE
 #ifdef BUZZER_DEVICE
     // Play sound
-    case 250:
-      esp3d_log("Processing [ESP250]");
-      ESP250(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(250, user, ESP3D_CMD_FLAG_NONE),
 #endif  // BUZZER_DEVICE
-
-    // Show pins
-    case 220:
-      esp3d_log("Processing [ESP220]");
-      ESP220(cmd_params_pos, msg);
-      break;
-
     // Delay command
-    case 290:
-      esp3d_log("Processing [ESP290]");
-      ESP290(cmd_params_pos, msg);
-      break;
-
+    ESP3D_COMMAND(290, user, ESP3D_CMD_FLAG_SLOW),
 #if defined(ESP_LUA_INTERPRETER_FEATURE)
     // Execute Lua script
-    case 300:
-      esp3d_log("Processing [ESP300]");
-      ESP300(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(300, user, ESP3D_CMD_FLAG_NONE),
     // Query and Control ESP300
-    case 301:
-      esp3d_log("Processing [ESP301]");
-      ESP301(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(301, user, ESP3D_CMD_FLAG_NONE),
 #endif  // ESP_LUA_INTERPRETER_FEATURE
-
     // Get full ESP3D settings
-    case 400:
-      esp3d_log("Processing [ESP400]");
-      ESP400(cmd_params_pos, msg);
-      break;
-
+    ESP3D_COMMAND(400, user, ESP3D_CMD_FLAG_NONE),
     // Set EEPROM setting
-    case 401:
-      esp3d_log("Processing [ESP401]");
-      ESP401(cmd_params_pos, msg);
-      break;
-
+    ESP3D_COMMAND(401, admin, ESP3D_CMD_FLAG_SETTING),
+#if defined(SD_DEVICE) && defined(SD_UPDATE_FEATURE)
+    // Get/Set SD Check at boot
+    ESP3D_COMMAND(402, user, ESP3D_CMD_FLAG_SETTING),
+#endif  // SD_DEVICE && SD_UPDATE_FEATURE
 #if defined(WIFI_FEATURE)
     // Get available AP list
-    case 410:
-      esp3d_log("Processing [ESP410]");
-      ESP410(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(410, user, ESP3D_CMD_FLAG_SLOW),
 #endif  // WIFI_FEATURE
-
+#if defined(ESP_SAVE_SETTINGS)
     // Get ESP current status
-    case 420:
-      esp3d_log("Processing [ESP420]");
-      ESP420(cmd_params_pos, msg);
-      break;
-
+    ESP3D_COMMAND(420, user, ESP3D_CMD_FLAG_NONE),
+#endif  // ESP_SAVE_SETTINGS
+    // Get commands statistics
+    ESP3D_COMMAND(421, user, ESP3D_CMD_FLAG_NONE),
     // Set ESP State
-    case 444:
-      esp3d_log("Processing [ESP444]");
-      ESP444(cmd_params_pos, msg);
-      break;
-
+    ESP3D_COMMAND(444, admin, ESP3D_CMD_FLAG_SLOW),
 #ifdef MDNS_FEATURE
     // Get ESP3D list
-    case 450:
-      esp3d_log("Processing [ESP450]");
-      ESP450(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(450, user, ESP3D_CMD_FLAG_SLOW),
 #endif  // MDNS_FEATURE
-
 #ifdef AUTHENTICATION_FEATURE
     // Get current authentication level
-    case 500:
-      esp3d_log("Processing [ESP500]");
-      ESP500(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(500, guest, ESP3D_CMD_FLAG_NONE),
     // Set/display session timeout
-    case 510:
-      esp3d_log("Processing [ESP510]");
-      ESP510(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(510, admin, ESP3D_CMD_FLAG_SETTING),
     // Change admin password
-    case 550:
-      esp3d_log("Processing [ESP550]");
-      ESP550(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(550, admin, ESP3D_CMD_FLAG_SETTING),
     // Change user password
-    case 555:
-      esp3d_log("Processing [ESP555]");
-      ESP555(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(555, user, ESP3D_CMD_FLAG_SETTING),
 #endif  // AUTHENTICATION_FEATURE
-
 #if defined(NOTIFICATION_FEATURE)
     // Send Notification
-    case 600:
-      esp3d_log("Processing [ESP600]");
-      ESP600(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(600, user, ESP3D_CMD_FLAG_SLOW),
     // Set/Get Notification settings
-    case 610:
-      esp3d_log("Processing [ESP610]");
-      ESP610(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(610, user, ESP3D_CMD_FLAG_SETTING),
     // Send Notification using URL
-    case 620:
-      esp3d_log("Processing [ESP620]");
-      ESP620(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(620, user, ESP3D_CMD_FLAG_SLOW),
 #endif  // NOTIFICATION_FEATURE
-
+#if defined(GCODE_HOST_FEATURE)
+    // Open local file
+    ESP3D_COMMAND(700, user, ESP3D_CMD_FLAG_NONE),
+    // Get Status and Control ESP700
+    ESP3D_COMMAND(701, user, ESP3D_CMD_FLAG_NONE),
+#endif  // GCODE_HOST_FEATURE
+#if defined(GCODE_INDEX_FEATURE)
+    // Index local file / process it from layer or offset
+    ESP3D_COMMAND(702, user, ESP3D_CMD_FLAG_SLOW),
+#endif  // GCODE_INDEX_FEATURE
+#if defined(PRINT_JOURNAL_FEATURE)
+    // Query / resume / clear print journal
+    ESP3D_COMMAND(703, user, ESP3D_CMD_FLAG_SLOW),
+#endif  // PRINT_JOURNAL_FEATURE
+#if defined(PRINT_QUEUE_FEATURE)
+    // List / add / remove queued print jobs and control queue
+    ESP3D_COMMAND(704, user, ESP3D_CMD_FLAG_SLOW),
+#endif  // PRINT_QUEUE_FEATURE
 #if defined(FILESYSTEM_FEATURE)
     // Format ESP Filesystem
-    case 710:
-      esp3d_log("Processing [ESP710]");
-      ESP710(cmd_params_pos, msg);
-      break;
-    // List ESP Filesystem
-    case 720:
-      esp3d_log("Processing [ESP720]");
-      ESP720(cmd_params_pos, msg);
-      break;
-    // Action on ESP Filesystem
-    case 730:
-      esp3d_log("Processing [ESP730]");
-      ESP730(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(710, admin, ESP3D_CMD_FLAG_SLOW),
 #endif  // FILESYSTEM_FEATURE
-
 #if defined(SD_DEVICE)
     // Format SD Filesystem
-    case 715:
-      esp3d_log("Processing [ESP715]");
-      ESP715(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(715, admin, ESP3D_CMD_FLAG_SLOW),
 #endif  // SD_DEVICE
-
-#if defined(GCODE_HOST_FEATURE)
-    // Open local file
-    case 700:
-      esp3d_log("Processing [ESP700]");
-      ESP700(cmd_params_pos, msg);
-      break;
-    // Get Status and Control ESP700
-    case 701:
-      esp3d_log("Processing [ESP701]");
-      ESP701(cmd_params_pos, msg);
-      break;
-#endif  // GCODE_HOST_FEATURE
-
+#if defined(FILESYSTEM_FEATURE)
+    // List ESP Filesystem
+    ESP3D_COMMAND(720, user, ESP3D_CMD_FLAG_NONE),
+    // Action on ESP Filesystem
+    ESP3D_COMMAND(730, user, ESP3D_CMD_FLAG_NONE),
+#endif  // FILESYSTEM_FEATURE
 #if defined(SD_DEVICE)
     // List SD Filesystem
-    case 740:
-      esp3d_log("Processing [ESP740]");
-      ESP740(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(740, user, ESP3D_CMD_FLAG_NONE),
     // Action on SD Filesystem
-    case 750:
-      esp3d_log("Processing [ESP750]");
-      ESP750(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(750, user, ESP3D_CMD_FLAG_NONE),
 #endif  // SD_DEVICE
-
 #if defined(GLOBAL_FILESYSTEM_FEATURE)
     // Global FS Actions
-    case 780:
-      esp3d_log("Processing [ESP780]");
-      ESP780(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(780, user, ESP3D_CMD_FLAG_NONE),
     // Global FS Control
-    case 790:
-      esp3d_log("Processing [ESP790]");
-      ESP790(cmd_params_pos, msg);
-      break;
+    ESP3D_COMMAND(790, user, ESP3D_CMD_FLAG_NONE),
+    // Global FS background jobs
+    ESP3D_COMMAND(791, user, ESP3D_CMD_FLAG_NONE),
 #endif  // GLOBAL_FILESYSTEM_FEATURE
-
-    // System Commands
-    case 800:
-      esp3d_log("Processing [ESP800]");
-      ESP800(cmd_params_pos, msg);
-      break;
-
+    // FW informations
+    ESP3D_COMMAND(800, user, ESP3D_CMD_FLAG_NONE),
 #if COMMUNICATION_PROTOCOL != SOCKET_SERIAL
-    // Serial Commands
-    case 900:
-      esp3d_log("Processing [ESP900]");
-      ESP900(cmd_params_pos, msg);
-      break;
-    case 901:
-      esp3d_log("Processing [ESP901]");
-      ESP901(cmd_params_pos, msg);
-      break;
+    // Serial state
+    ESP3D_COMMAND(900, user, ESP3D_CMD_FLAG_NONE),
+    // Serial baud rate
+    ESP3D_COMMAND(901, user, ESP3D_CMD_FLAG_SETTING),
 #endif  // COMMUNICATION_PROTOCOL != SOCKET_SERIAL
-
 #if defined(USB_SERIAL_FEATURE)
-    // USB Serial Commands
-    case 902:
-      esp3d_log("Processing [ESP902]");
-      ESP902(cmd_params_pos, msg);
-      break;
-    case 950:
-      esp3d_log("Processing [ESP950]");
-      ESP950(cmd_params_pos, msg);
-      break;
+    // USB Serial baud rate
+    ESP3D_COMMAND(902, user, ESP3D_CMD_FLAG_SETTING),
 #endif  // USB_SERIAL_FEATURE
-
-#if defined(ESP_SERIAL_BRIDGE_OUTPUT)
-    // Serial Bridge Commands
-    case 930:
-      esp3d_log("Processing [ESP930]");
-      ESP930(cmd_params_pos, msg);
-      break;
-    case 931:
-      esp3d_log("Processing [ESP931]");
-      ESP931(cmd_params_pos, msg);
-      break;
-#endif  // ESP_SERIAL_BRIDGE_OUTPUT
-
 #ifdef BUZZER_DEVICE
-    // Buzzer Commands
-    case 910:
-      esp3d_log("Processing [ESP910]");
-      ESP910(cmd_params_pos, msg);
-      break;
+    // Buzzer state
+    ESP3D_COMMAND(910, user, ESP3D_CMD_FLAG_SETTING),
 #endif  // BUZZER_DEVICE
-
+#if defined(ESP_SERIAL_BRIDGE_OUTPUT)
+    // Serial bridge state
+    ESP3D_COMMAND(930, user, ESP3D_CMD_FLAG_SETTING),
+    // Serial bridge baud rate
+    ESP3D_COMMAND(931, user, ESP3D_CMD_FLAG_SETTING),
+#endif  // ESP_SERIAL_BRIDGE_OUTPUT
+#if defined(USB_SERIAL_FEATURE)
+    // Client output
+    ESP3D_COMMAND(950, user, ESP3D_CMD_FLAG_SETTING),
+#endif  // USB_SERIAL_FEATURE
 #if defined(ARDUINO_ARCH_ESP32) &&                             \
     (CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32S2 || \
      CONFIG_IDF_TARGET_ESP32C3)
-    // Platform-specific Commands
-    case 999:
-      esp3d_log("Processing [ESP999]");
-      ESP999(cmd_params_pos, msg);
-      break;
+    // Quiet boot
+    ESP3D_COMMAND(999, guest, ESP3D_CMD_FLAG_SETTING),
 #endif  // ARDUINO_ARCH_ESP32
+};
 
-    default:
-      esp3d_log_e("Unknown command %d", cmd);
-      dispatchAnswer(msg, cmd, json, false, "Unknown command");
-      break;
+#define ESP3D_COMMANDS_COUNT \
+  (sizeof(esp3dCommandsTable) / sizeof(ESP3DCommandEntry))
+#define ESP3D_NO_COMMAND 0xFF
+
+static_assert(ESP3D_COMMANDS_COUNT < ESP3D_NO_COMMAND,
+              "Too many commands for index table");
+
+static constexpr bool isCommandsTableSorted(size_t i = 1) {
+  return (i >= ESP3D_COMMANDS_COUNT)
+             ? true
+             : (esp3dCommandsTable[i - 1].id < esp3dCommandsTable[i].id) &&
+                   (esp3dCommandsTable[i].id <= ESP3D_MAX_COMMAND_ID) &&
+                   isCommandsTableSorted(i + 1);
+}
+static_assert(isCommandsTableSorted(),
+              "Commands table must be sorted by id without duplicate");
+
+// Direct id -> table position lookup, built at compile time
+struct ESP3DCommandIndex {
+  uint8_t slot[ESP3D_MAX_COMMAND_ID + 1];
+};
+
+static constexpr ESP3DCommandIndex buildCommandIndex() {
+  ESP3DCommandIndex index = {};
+  for (size_t i = 0; i <= ESP3D_MAX_COMMAND_ID; i++) {
+    index.slot[i] = ESP3D_NO_COMMAND;
+  }
+  for (size_t i = 0; i < ESP3D_COMMANDS_COUNT; i++) {
+    index.slot[esp3dCommandsTable[i].id] = i;
+  }
+  return index;
+}
+
+static const ESP3DCommandIndex esp3dCommandsIndex PROGMEM =
+    buildCommandIndex();
+
+static ESP3DCommandStats esp3dCommandsStats[ESP3D_COMMANDS_COUNT];
+
+uint8_t ESP3DCommands::commandsCount() { return ESP3D_COMMANDS_COUNT; }
+
+bool ESP3DCommands::getCommandEntry(uint8_t index, ESP3DCommandEntry *entry) {
+  if (index >= ESP3D_COMMANDS_COUNT || !entry) {
+    return false;
+  }
+  memcpy_P(entry, &esp3dCommandsTable[index], sizeof(ESP3DCommandEntry));
+  return true;
+}
+
+const ESP3DCommandStats *ESP3DCommands::getCommandStats(uint8_t index) {
+  if (index >= ESP3D_COMMANDS_COUNT) {
+    return nullptr;
+  }
+  return &esp3dCommandsStats[index];
+}
+
+void ESP3DCommands::resetCommandStats() {
+  memset(esp3dCommandsStats, 0, sizeof(esp3dCommandsStats));
+}
+
+// Parse [ESPxxx] header in place, no allocation
+// cmdParamsPos is set to first char after ']'
+bool ESP3DCommands::parseCommandId(const uint8_t *data, size_t size,
+                                   int *cmdId, int *cmdParamsPos) {
+  size_t pos = 0;
+  if (size >= 6 && memcmp(data, "echo: ", 6) == 0) {
+    pos = 6;
+  }
+  if (size < pos + 5 || memcmp(&data[pos], "[ESP", 4) != 0) {
+    return false;
+  }
+  pos += 4;
+  int id = 0;
+  uint8_t digits = 0;
+  while (pos < size && data[pos] >= '0' && data[pos] <= '9') {
+    id = (id * 10) + (data[pos] - '0');
+    digits++;
+    pos++;
+    if (digits > 3) {
+      return false;
+    }
+  }
+  if (pos >= size || data[pos] != ']') {
+    return false;
+  }
+  *cmdId = id;
+  *cmdParamsPos = pos + 1;
+  return true;
+}
+
+void ESP3DCommands::process(ESP3DMessage *msg) {
+  if (!msg || !msg->data || msg->size == 0) {
+    esp3d_log_e("Invalid message for processing");
+    return;
+  }
+  esp3d_log("Processing message from client %s, size: %zu",
+            GETCLIENTSTR(msg->origin), msg->size);
+
+  // Check if it's an ESP command
+  if (!is_esp_command(msg->data, msg->size)) {
+    if (msg->origin == getOutputClient()) {
+#if defined(GCODE_HOST_FEATURE)
+      // Printer answer acknowledges command streamed by gcode host
+      if (esp3d_gcode_host.dispatch(msg)) {
+        return;
+      }
+#endif  // GCODE_HOST_FEATURE
+      // Never answer printer output, answer would be sent to printer
+      esp3d_message_manager.deleteMsg(msg);
+      return;
+    }
+    if (msg->target == getOutputClient()) {
+      // G-code from client or gcode host goes to printer
+      if (!dispatch(msg)) {
+        esp3d_message_manager.deleteMsg(msg);
+      }
+      return;
+    }
+    esp3d_log("Not an ESP command");
+    dispatchAnswer(msg, 0, hasTag(msg, 0, "json"), false, "Not an ESP command");
+    esp3d_message_manager.deleteMsg(msg);
+    return;
+  }
+
+  int cmdId = 0;
+  int cmd_params_pos = 0;
+  if (!parseCommandId(msg->data, msg->size, &cmdId, &cmd_params_pos)) {
+    esp3d_log_e("Invalid ESP command format");
+    dispatchAnswer(msg, 0, hasTag(msg, 0, "json"), false, "Invalid command format");
+    return;
+  }
+
+  // Execute the command
+  execute_internal_command(cmdId, cmd_params_pos, msg);
+}
+
+void ESP3DCommands::execute_internal_command(int cmd, int cmd_params_pos,
+                                             ESP3DMessage *msg) {
+  if (!msg) {
+    esp3d_log_e("No msg for cmd %d", cmd);
+    return;
+  }
+  esp3d_log("Executing command %d", cmd);
+  uint8_t slot = ESP3D_NO_COMMAND;
+  if (cmd >= 0 && cmd <= ESP3D_MAX_COMMAND_ID) {
+    slot = pgm_read_byte(&esp3dCommandsIndex.slot[cmd]);
+  }
+  if (slot == ESP3D_NO_COMMAND) {
+    esp3d_log_e("Unknown command %d", cmd);
+    dispatchAnswer(msg, cmd, hasTag(msg, cmd_params_pos, "json"), false,
+                   "Unknown command");
+    return;
+  }
+  ESP3DCommandEntry entry;
+  memcpy_P(&entry, &esp3dCommandsTable[slot], sizeof(ESP3DCommandEntry));
+  // Split parameters once, all lookups of the handler use this
+  ESP3DArgs args;
+  args.parse((const char *)msg->data, msg->size, cmd_params_pos);
+  if (args.truncated()) {
+    // never run a command with part of its parameters
+    esp3d_log_e("Too many parameters for command %d", cmd);
+    dispatchAnswer(msg, cmd, args.hasTag("json"), false,
+                   "Too many parameters");
+    return;
+  }
+  const ESP3DArgs *previousArgs = currentArgs;
+  currentArgs = &args;
+#ifdef AUTHENTICATION_FEATURE
+  // Only clients without session can authenticate using pwd=
+  if (msg->origin == ESP3DClientType::serial ||
+      msg->origin == ESP3DClientType::serial_bridge ||
+      msg->origin == ESP3DClientType::telnet ||
+      msg->origin == ESP3DClientType::websocket ||
+      msg->origin == ESP3DClientType::usb_serial ||
+      msg->origin == ESP3DClientType::bluetooth) {
+    const char *pwd = args.get("pwd=");
+    if (pwd[0] != '\0') {
+      msg->authentication_level =
+          AuthenticationService::getAuthenticatedLevel(pwd, msg);
+      esp3d_log("Authentication level set to %d", msg->authentication_level);
+      switch (msg->origin) {
+        case ESP3DClientType::serial:
+          esp3d_serial_service.setAuthentication(msg->authentication_level);
+          break;
+#if defined(ESP_SERIAL_BRIDGE_OUTPUT)
+        case ESP3DClientType::serial_bridge:
+          serial_bridge_service.setAuthentication(msg->authentication_level);
+          break;
+#endif  // ESP_SERIAL_BRIDGE_OUTPUT
+#if defined(USB_SERIAL_FEATURE)
+        case ESP3DClientType::usb_serial:
+          esp3d_usb_serial_service.setAuthentication(msg->authentication_level);
+          break;
+#endif  // USB_SERIAL_FEATURE
+#if defined(TELNET_FEATURE)
+        case ESP3DClientType::telnet:
+          telnet_server.setAuthentication(msg->authentication_level);
+          break;
+#endif  // TELNET_FEATURE
+#if defined(WS_DATA_FEATURE)
+        case ESP3DClientType::websocket:
+          websocket_data_server.setAuthentication(msg->authentication_level);
+          break;
+#endif  // WS_DATA_FEATURE
+#ifdef BLUETOOTH_FEATURE
+        case ESP3DClientType::bluetooth:
+          bt_service.setAuthentication(msg->authentication_level);
+          break;
+#endif  // BLUETOOTH_FEATURE
+        default:
+          break;
+      }
+    }
+  }
+  // Reject early if level is too low for any use of the command
+  uint8_t level = static_cast<uint8_t>(msg->authentication_level);
+  if (msg->authentication_level == ESP3DAuthenticationLevel::not_authenticated) {
+    level = static_cast<uint8_t>(ESP3DAuthenticationLevel::guest);
+  }
+  if (level < static_cast<uint8_t>(entry.level)) {
+    esp3d_log_e("Authentication level too low for command %d", cmd);
+    msg->authentication_level = ESP3DAuthenticationLevel::not_authenticated;
+    dispatchAuthenticationError(msg, cmd, args.hasTag("json"));
+    currentArgs = previousArgs;
+    return;
+  }
+#endif  // AUTHENTICATION_FEATURE
+
+  uint32_t startTime = micros();
+  (this->*entry.handler)(cmd_params_pos, msg);
+  uint32_t duration = micros() - startTime;
+  currentArgs = previousArgs;
+  ESP3DCommandStats &stats = esp3dCommandsStats[slot];
+  stats.calls++;
+  stats.totalTime += duration;
+  if (duration > stats.maxTime) {
+    stats.maxTime = duration;
+  }
+  if (duration > ESP3D_CMD_SLOW_THRESHOLD_US &&
+      !(entry.flags & ESP3D_CMD_FLAG_SLOW)) {
+    esp3d_log_e("Command %d took %d us", cmd, duration);
   }
 }
 
@@ -986,15 +808,15 @@ bool ESP3DCommands::dispatchAnswer(ESP3DMessage *msg, uint cmdID, bool json,
     return false;
   }
   String response = format_response(cmdID, json, isOk, answer);
-  ESP3DMessage *newMsg = new ESP3DMessage();
+  ESP3DMessage *newMsg = esp3d_message_manager.newMsg();
   if (!newMsg) {
     esp3d_log_e("Cannot create response message");
     return false;
   }
-  newMsg->data = new uint8_t[response.length() + 1];
+  newMsg->data = (uint8_t *)malloc(response.length() + 1);
   if (!newMsg->data) {
     esp3d_log_e("Cannot allocate response data");
-    delete newMsg;
+    esp3d_message_manager.deleteMsg(newMsg);
     return false;
   }
   newMsg->size = response.length();
@@ -1036,14 +858,12 @@ bool ESP3DCommands::dispatchAnswer(ESP3DMessage *msg, uint cmdID, bool json,
 #endif  // BLUETOOTH_FEATURE
     default:
       esp3d_log_e("Unsupported client type for response: %d", msg->origin);
-      delete[] newMsg->data;
-      delete newMsg;
+      esp3d_message_manager.deleteMsg(newMsg);
       return false;
   }
   if (!success) {
     esp3d_log_e("Failed to send message to client %d", msg->origin);
-    delete[] newMsg->data;
-    delete newMsg;
+    esp3d_message_manager.deleteMsg(newMsg);
     return false;
   }
   return true;
@@ -1083,15 +903,15 @@ bool ESP3DCommands::dispatch(ESP3DMessage *msg, const char *sbuf) {
     esp3d_log_e("Invalid message or buffer");
     return false;
   }
-  ESP3DMessage *newMsg = new ESP3DMessage();
+  ESP3DMessage *newMsg = esp3d_message_manager.newMsg();
   if (!newMsg) {
     esp3d_log_e("Cannot create dispatch message");
     return false;
   }
-  newMsg->data = new uint8_t[strlen(sbuf) + 1];
+  newMsg->data = (uint8_t *)malloc(strlen(sbuf) + 1);
   if (!newMsg->data) {
     esp3d_log_e("Cannot allocate dispatch data");
-    delete newMsg;
+    esp3d_message_manager.deleteMsg(newMsg);
     return false;
   }
   newMsg->size = strlen(sbuf);
@@ -1134,19 +954,42 @@ bool ESP3DCommands::dispatch(ESP3DMessage *msg, const char *sbuf) {
 #endif  // BLUETOOTH_FEATURE
     default:
       esp3d_log_e("Unsupported client type for dispatch: %d", msg->target);
-      delete[] newMsg->data;
-      delete newMsg;
+      esp3d_message_manager.deleteMsg(newMsg);
       return false;
   }
   if (!success) {
     esp3d_log_e("Failed to dispatch message to client %d", msg->target);
-    delete[] newMsg->data;
-    delete newMsg;
+    esp3d_message_manager.deleteMsg(newMsg);
     return false;
   }
   return true;
 }
 
+bool ESP3DCommands::dispatch(ESP3DMessage *msg, const char *sbuf,
+                             ESP3DClientType target, ESP3DRequest requestId,
+                             ESP3DMessageType type,
+                             ESP3DAuthenticationLevel authentication_level) {
+  if (!sbuf) {
+    esp3d_log_e("Invalid buffer");
+    return false;
+  }
+  return dispatch((uint8_t *)sbuf, strlen(sbuf), target, requestId, type,
+                  msg ? msg->origin : ESP3DClientType::command,
+                  authentication_level);
+}
+
+bool ESP3DCommands::dispatch(const char *sbuf, ESP3DClientType target,
+                             ESP3DRequest requestId, ESP3DMessageType type,
+                             ESP3DClientType origin,
+                             ESP3DAuthenticationLevel authentication_level) {
+  if (!sbuf) {
+    esp3d_log_e("Invalid buffer");
+    return false;
+  }
+  return dispatch((uint8_t *)sbuf, strlen(sbuf), target, requestId, type,
+                  origin, authentication_level);
+}
+
 bool ESP3DCommands::dispatch(uint8_t *sbuf, size_t size, ESP3DClientType target,
                              ESP3DRequest requestId, ESP3DMessageType type,
                              ESP3DClientType origin,
@@ -1155,15 +998,15 @@ bool ESP3DCommands::dispatch(uint8_t *sbuf, size_t size, ESP3DClientType target,
     esp3d_log_e("Invalid buffer");
     return false;
   }
-  ESP3DMessage *newMsg = new ESP3DMessage();
+  ESP3DMessage *newMsg = esp3d_message_manager.newMsg();
   if (!newMsg) {
     esp3d_log_e("Cannot create dispatch message");
     return false;
   }
-  newMsg->data = new uint8_t[size + 1];
+  newMsg->data = (uint8_t *)malloc(size + 1);
   if (!newMsg->data) {
     esp3d_log_e("Cannot allocate dispatch data");
-    delete newMsg;
+    esp3d_message_manager.deleteMsg(newMsg);
     return false;
   }
   newMsg->size = size;
@@ -1207,14 +1050,12 @@ bool ESP3DCommands::dispatch(uint8_t *sbuf, size_t size, ESP3DClientType target,
 #endif  // BLUETOOTH_FEATURE
     default:
       esp3d_log_e("Unsupported client type for dispatch: %d", target);
-      delete[] newMsg->data;
-      delete newMsg;
+      esp3d_message_manager.deleteMsg(newMsg);
       return false;
   }
   if (!success) {
     esp3d_log_e("Failed to dispatch message to client %d", target);
-    delete[] newMsg->data;
-    delete newMsg;
+    esp3d_message_manager.deleteMsg(newMsg);
     return false;
   }
   return true;
@@ -1225,15 +1066,15 @@ bool ESP3DCommands::dispatch(ESP3DMessage *msg, uint8_t *sbuf, size_t len) {
     esp3d_log_e("Invalid message or buffer");
     return false;
   }
-  ESP3DMessage *newMsg = new ESP3DMessage();
+  ESP3DMessage *newMsg = esp3d_message_manager.newMsg();
   if (!newMsg) {
     esp3d_log_e("Cannot create dispatch message");
     return false;
   }
-  newMsg->data = new uint8_t[len + 1];
+  newMsg->data = (uint8_t *)malloc(len + 1);
   if (!newMsg->data) {
     esp3d_log_e("Cannot allocate dispatch data");
-    delete newMsg;
+    esp3d_message_manager.deleteMsg(newMsg);
     return false;
   }
   newMsg->size = len;
@@ -1276,14 +1117,12 @@ bool ESP3DCommands::dispatch(ESP3DMessage *msg, uint8_t *sbuf, size_t len) {
 #endif  // BLUETOOTH_FEATURE
     default:
       esp3d_log_e("Unsupported client type for dispatch: %d", msg->target);
-      delete[] newMsg->data;
-      delete newMsg;
+      esp3d_message_manager.deleteMsg(newMsg);
       return false;
   }
   if (!success) {
     esp3d_log_e("Failed to dispatch message to client %d", msg->target);
-    delete[] newMsg->data;
-    delete newMsg;
+    esp3d_message_manager.deleteMsg(newMsg);
     return false;
   }
   return true;
@@ -1335,73 +1174,54 @@ bool ESP3DCommands::dispatch(ESP3DMessage *msg) {
   return true;
 }
 
-bool ESP3DCommands::dispatchSetting(bool json, const char *filter,
+bool ESP3DCommands::dispatchSetting(ESP3DJsonWriter &writer, const char *filter,
                                     ESP3DSettingIndex index, const char *help,
                                     const char **optionValues,
                                     const char **optionLabels,
                                     uint32_t maxsize, uint32_t minsize,
                                     uint32_t minsize2, uint8_t precision,
-                                    const char *unit, bool needRestart,
-                                    ESP3DClientType target,
-                                    ESP3DRequest requestId, bool isFirst) {
-  String response;
-  if (json) {
-    response = isFirst ? "" : ",";
-    response += "{\"filter\":\"";
-    response += filter;
-    response += "\",\"id\":\"";
-    response += String(static_cast<uint32_t>(index));
-    response += "\",\"help\":\"";
-    response += help;
-    response += "\",\"value\":\"";
-    String value = ESP3DSettings::readString(static_cast<int>(index));
-    response += value;
-    response += "\",\"options\":";
+                                    const char *unit, bool needRestart) {
+  String value = ESP3DSettings::readString(static_cast<int>(index));
+  if (writer.isJson()) {
+    writer.beginObject();
+    writer.add("filter", filter);
+    writer.add("id", static_cast<uint32_t>(index));
+    writer.add("help", help);
+    writer.add("value", value.c_str());
+    writer.beginArray("options");
     if (optionValues && optionLabels) {
-      response += "[";
-      for (uint i = 0; optionValues[i] != nullptr; i++) {
-        if (i > 0) response += ",";
-        response += "{\"label\":\"";
-        response += optionLabels[i];
-        response += "\",\"value\":\"";
-        response += optionValues[i];
-        response += "\"}";
+      for (uint32_t i = 0; i < maxsize; i++) {
+        writer.beginObject();
+        writer.add("label", optionLabels[i]);
+        writer.add("value", optionValues[i]);
+        writer.endObject();
       }
-      response += "]";
-    } else {
-      response += "[]";
     }
-    response += ",\"maxsize\":";
-    response += String(maxsize);
-    response += ",\"minsize\":";
-    response += String(minsize);
-    response += ",\"minsize2\":";
-    response += String(minsize2);
-    response += ",\"precision\":";
-    response += String(precision);
-    response += ",\"unit\":\"";
-    if (unit) response += unit;
-    response += "\",\"restart\":";
-    response += needRestart ? "true" : "false";
-    response += "}";
+    writer.endArray();
+    writer.add("maxsize", maxsize);
+    writer.add("minsize", minsize);
+    writer.add("minsize2", minsize2);
+    writer.add("precision", static_cast<uint32_t>(precision));
+    writer.add("unit", unit ? unit : "");
+    writer.addRaw("restart", needRestart ? "true" : "false");
+    writer.endObject();
   } else {
-    response = help;
-    response += ": ";
-    response += ESP3DSettings::readString(static_cast<int>(index));
+    writer.write(help);
+    writer.write(": ");
+    writer.write(value.c_str());
     if (optionValues && optionLabels) {
-      response += " [";
-      for (uint i = 0; optionValues[i] != nullptr; i++) {
-        if (i > 0) response += ", ";
-        response += optionLabels[i];
-        response += "=";
-        response += optionValues[i];
+      writer.write(" [");
+      for (uint32_t i = 0; i < maxsize; i++) {
+        if (i > 0) writer.write(", ");
+        writer.write(optionLabels[i]);
+        writer.write("=");
+        writer.write(optionValues[i]);
       }
-      response += "]";
+      writer.write("]");
     }
-    response += "\n";
+    writer.write("\n");
   }
-  return dispatch(nullptr, response.c_str(), target, requestId,
-                  isFirst ? ESP3DMessageType::head : ESP3DMessageType::core, ESP3DAuthenticationLevel::guest);
+  return !writer.hasError();
 }
 
 bool ESP3DCommands::dispatchAuthenticationError(ESP3DMessage *msg, uint cmdid,
@@ -1411,15 +1231,15 @@ bool ESP3DCommands::dispatchAuthenticationError(ESP3DMessage *msg, uint cmdid,
     return false;
   }
   String response = format_response(cmdid, json, false, "Authentication error");
-  ESP3DMessage *newMsg = new ESP3DMessage();
+  ESP3DMessage *newMsg = esp3d_message_manager.newMsg();
   if (!newMsg) {
     esp3d_log_e("Cannot create authentication error message");
     return false;
   }
-  newMsg->data = new uint8_t[response.length() + 1];
+  newMsg->data = (uint8_t *)malloc(response.length() + 1);
   if (!newMsg->data) {
     esp3d_log_e("Cannot allocate authentication error data");
-    delete newMsg;
+    esp3d_message_manager.deleteMsg(newMsg);
     return false;
   }
   newMsg->size = response.length();
@@ -1462,14 +1282,12 @@ bool ESP3DCommands::dispatchAuthenticationError(ESP3DMessage *msg, uint cmdid,
 #endif  // BLUETOOTH_FEATURE
     default:
       esp3d_log_e("Unsupported client type for authentication error: %d", msg->target);
-      delete[] newMsg->data;
-      delete newMsg;
+      esp3d_message_manager.deleteMsg(newMsg);
       return false;
   }
   if (!success) {
     esp3d_log_e("Failed to dispatch authentication error to client %d", msg->target);
-    delete[] newMsg->data;
-    delete newMsg;
+    esp3d_message_manager.deleteMsg(newMsg);
     return false;
   }
   return true;
@@ -1527,6 +1345,45 @@ bool ESP3DCommands::dispatchKeyValue(bool json, const char *key, const char *val
                   isFirst ? ESP3DMessageType::head : ESP3DMessageType::core, ESP3DAuthenticationLevel::guest);
 }
 
+bool ESP3DCommands::dispatchIdValue(ESP3DJsonWriter &writer, const char *Id,
+                                    const char *value) {
+  if (!Id || !value) {
+    esp3d_log_e("Invalid Id or value");
+    return false;
+  }
+  if (writer.isJson()) {
+    writer.beginObject();
+    writer.add("id", Id);
+    writer.add("value", value);
+    writer.endObject();
+  } else {
+    writer.write(Id);
+    writer.write("=");
+    writer.write(value);
+    writer.write("\n");
+  }
+  return !writer.hasError();
+}
+
+bool ESP3DCommands::dispatchKeyValue(ESP3DJsonWriter &writer, const char *key,
+                                     const char *value, bool nested) {
+  if (!key || !value) {
+    esp3d_log_e("Invalid key or value");
+    return false;
+  }
+  if (writer.isJson()) {
+    if (nested) writer.beginObject();
+    writer.add(key, value);
+    if (nested) writer.endObject();
+  } else {
+    writer.write(key);
+    writer.write("=");
+    writer.write(value);
+    writer.write("\n");
+  }
+  return !writer.hasError();
+}
+
 bool ESP3DCommands::formatCommand(char *cmd, size_t len) {
   if (!cmd || len == 0) {
     esp3d_log_e("Invalid command or length");
@@ -108,6 +108,37 @@ enum ESP3DNetworkMode : uint8_t {
   ESP_NO_NETWORK = 8
 };
 
+// Highest id usable in [ESPxxx] commands
+#define ESP3D_MAX_COMMAND_ID 999
+
+// Command table flags
+#define ESP3D_CMD_FLAG_NONE 0x00
+// Command may legitimately block the loop (scan, format, delay...)
+#define ESP3D_CMD_FLAG_SLOW 0x01
+// Command changes persistent settings
+#define ESP3D_CMD_FLAG_SETTING 0x02
+
+// Commands taking longer than this are reported, unless flagged as slow
+#define ESP3D_CMD_SLOW_THRESHOLD_US 50000
+
+class ESP3DCommands;
+class ESP3DJsonWriter;
+typedef void (ESP3DCommands::*ESP3DCommandHandler)(int cmd_params_pos,
+                                                   ESP3DMessage* msg);
+
+struct ESP3DCommandEntry {
+  uint16_t id;
+  ESP3DCommandHandler handler;
+  ESP3DAuthenticationLevel level;  // minimum level to run the command
+  uint8_t flags;
+};
+
+struct ESP3DCommandStats {
+  uint32_t calls;
+  uint32_t totalTime;  // in us
+  uint32_t maxTime;    // in us
+};
+
 class ESP3DCommands {
  public:
   ESP3DCommands();
@@ -128,20 +159,31 @@ class ESP3DCommands {
                 ESP3DClientType origin, ESP3DAuthenticationLevel authentication_level = ESP3DAuthenticationLevel::guest);
   bool dispatch(ESP3DMessage* msg, const char* sbuf, ESP3DClientType target, ESP3DRequest requestId,
                 ESP3DMessageType type, ESP3DAuthenticationLevel authentication_level);
+  bool dispatch(const char* sbuf, ESP3DClientType target, ESP3DRequest requestId, ESP3DMessageType type,
+                ESP3DClientType origin, ESP3DAuthenticationLevel authentication_level = ESP3DAuthenticationLevel::guest);
   bool dispatchIdValue(bool json, const char* Id, const char* value, ESP3DClientType target, ESP3DRequest requestId,
                        bool isFirst = false);
   bool dispatchKeyValue(bool json, const char* key, const char* value, ESP3DClientType target, ESP3DRequest requestId,
                         bool nested = false, bool isFirst = false);
-  bool dispatchSetting(bool json, const char* filter, ESP3DSettingIndex index, const char* help,
+  bool dispatchIdValue(ESP3DJsonWriter& writer, const char* Id, const char* value);
+  bool dispatchKeyValue(ESP3DJsonWriter& writer, const char* key, const char* value, bool nested = false);
+  // when options are provided, maxsize is the number of options
+  bool dispatchSetting(ESP3DJsonWriter& writer, const char* filter, ESP3DSettingIndex index, const char* help,
                       const char** optionValues, const char** optionLabels, uint32_t maxsize, uint32_t minsize,
-                      uint32_t minsize2, uint8_t precision, const char* unit, bool needRestart,
-                      ESP3DClientType target, ESP3DRequest requestId, bool isFirst = false);
+                      uint32_t minsize2, uint8_t precision, const char* unit, bool needRestart);
   bool dispatchAuthenticationError(ESP3DMessage* msg, uint cmdid, bool json);
   bool dispatchAnswer(ESP3DMessage* msg, uint cmdID, bool json, bool isOk, const char* answer);
   bool formatCommand(char* cmd, size_t len);
   const char* format_response(uint cmdID, bool isjson, bool isok, const char* message);
   ESP3DClientType getOutputClient(bool fromSettings = false);
   void execute_internal_command(int cmd, int cmd_params_pos, ESP3DMessage* msg);
+  static bool parseCommandId(const uint8_t* data, size_t size, int* cmdId,
+                             int* cmdParamsPos);
+  // Command table access, index is position in table not command id
+  uint8_t commandsCount();
+  bool getCommandEntry(uint8_t index, ESP3DCommandEntry* entry);
+  const ESP3DCommandStats* getCommandStats(uint8_t index);
+  void resetCommandStats();
 
   // Command-specific functions
   void ESP0(int cmd_params_pos, ESP3DMessage* msg);
@@ -156,6 +198,10 @@ class ESP3DCommands {
   void ESP107(int cmd_params_pos, ESP3DMessage* msg);
   void ESP108(int cmd_params_pos, ESP3DMessage* msg);
   void ESP410(int cmd_params_pos, ESP3DMessage* msg);
+  // Send last WiFi scan results, used when a background scan completes
+  bool dispatchWiFiScan(ESP3DClientType target, ESP3DRequest requestId,
+                        ESP3DAuthenticationLevel authentication_level,
+                        bool json);
 #endif  // WIFI_FEATURE
 #if defined(WIFI_FEATURE) || defined(BLUETOOTH_FEATURE) || defined(ETH_FEATURE)
   void ESP110(int cmd_params_pos, ESP3DMessage* msg);
@@ -224,6 +270,9 @@ class ESP3DCommands {
 #endif  // DISPLAY_TOUCH_DRIVER
 #endif  // DISPLAY_DEVICE
   void ESP220(int cmd_params_pos, ESP3DMessage* msg);
+#if defined(PRINTER_STATE_FEATURE)
+  void ESP230(int cmd_params_pos, ESP3DMessage* msg);
+#endif  // PRINTER_STATE_FEATURE
 #ifdef BUZZER_DEVICE
   void ESP250(int cmd_params_pos, ESP3DMessage* msg);
 #endif  // BUZZER_DEVICE
@@ -237,6 +286,7 @@ class ESP3DCommands {
 #if defined(ESP_SAVE_SETTINGS)
   void ESP420(int cmd_params_pos, ESP3DMessage* msg);
 #endif  // ESP_SAVE_SETTINGS
+  void ESP421(int cmd_params_pos, ESP3DMessage* msg);
   void ESP444(int cmd_params_pos, ESP3DMessage* msg);
 #ifdef MDNS_FEATURE
   void ESP450(int cmd_params_pos, ESP3DMessage* msg);
@@ -255,6 +305,15 @@ class ESP3DCommands {
 #if defined(GCODE_HOST_FEATURE)
   void ESP700(int cmd_params_pos, ESP3DMessage* msg);
   void ESP701(int cmd_params_pos, ESP3DMessage* msg);
+#if defined(GCODE_INDEX_FEATURE)
+  void ESP702(int cmd_params_pos, ESP3DMessage* msg);
+#endif  // GCODE_INDEX_FEATURE
+#if defined(PRINT_JOURNAL_FEATURE)
+  void ESP703(int cmd_params_pos, ESP3DMessage* msg);
+#endif  // PRINT_JOURNAL_FEATURE
+#if defined(PRINT_QUEUE_FEATURE)
+  void ESP704(int cmd_params_pos, ESP3DMessage* msg);
+#endif  // PRINT_QUEUE_FEATURE
 #endif  // GCODE_HOST_FEATURE
 #if defined(FILESYSTEM_FEATURE)
   void ESP710(int cmd_params_pos, ESP3DMessage* msg);
@@ -269,6 +328,7 @@ class ESP3DCommands {
 #if defined(GLOBAL_FILESYSTEM_FEATURE)
   void ESP780(int cmd_params_pos, ESP3DMessage* msg);
   void ESP790(int cmd_params_pos, ESP3DMessage* msg);
+  void ESP791(int cmd_params_pos, ESP3DMessage* msg);
 #endif  // GLOBAL_FILESYSTEM_FEATURE
   void ESP800(int cmd_params_pos, ESP3DMessage* msg);
 #if COMMUNICATION_PROTOCOL != SOCKET_SERIAL
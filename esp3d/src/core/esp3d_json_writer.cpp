@@ -0,0 +1,230 @@
+/*
+  esp3d_json_writer.cpp - ESP3D streamed responses writer
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "esp3d_json_writer.h"
+
+#include "esp3d_commands.h"
+#include "esp3d_hal.h"
+#include "esp3d_log.h"
+
+ESP3DJsonWriter::ESP3DJsonWriter(ESP3DClientType target,
+                                 ESP3DRequest requestId,
+                                 ESP3DAuthenticationLevel level, bool json)
+    : _target(target),
+      _requestId(requestId),
+      _level(level),
+      _json(json),
+      _error(false),
+      _started(false),
+      _ended(false),
+      _depth(0),
+      _hasItem(0),
+      _len(0) {}
+
+ESP3DJsonWriter::~ESP3DJsonWriter() {
+  if (!_ended) {
+    end();
+  }
+}
+
+bool ESP3DJsonWriter::flush(bool last) {
+  if (_error) {
+    return false;
+  }
+  if (_len == 0 && !last) {
+    return true;
+  }
+  ESP3DMessageType type;
+  if (last) {
+    type = _started ? ESP3DMessageType::tail : ESP3DMessageType::unique;
+  } else {
+    type = _started ? ESP3DMessageType::core : ESP3DMessageType::head;
+  }
+  // tail message cannot be empty
+  if (_len == 0) {
+    _buffer[_len++] = last && _json ? ' ' : '\n';
+  }
+  // Client may be busy sending previous chunk, so retry until timeout
+  uint32_t start = millis();
+  while (!esp3d_commands.dispatch((uint8_t*)_buffer, _len, _target,
+                                  _requestId, type, ESP3DClientType::command,
+                                  _level)) {
+    if (millis() - start > ESP3D_JSON_WRITER_TIMEOUT) {
+      esp3d_log_e("Client %d not ready, response dropped", _target);
+      _error = true;
+      return false;
+    }
+    ESP3DHal::wait(10);
+  }
+  _started = true;
+  _len = 0;
+  return true;
+}
+
+bool ESP3DJsonWriter::put(char c) {
+  if (_len == ESP3D_JSON_WRITER_BUFFER_SIZE && !flush(false)) {
+    return false;
+  }
+  _buffer[_len++] = c;
+  return true;
+}
+
+bool ESP3DJsonWriter::write(const char* s) {
+  if (!s) {
+    return !_error;
+  }
+  while (*s) {
+    if (!put(*s++)) {
+      return false;
+    }
+  }
+  return !_error;
+}
+
+bool ESP3DJsonWriter::writeEscaped(const char* s) {
+  if (!s) {
+    return !_error;
+  }
+  static const char hex[] = "0123456789abcdef";
+  for (; *s; s++) {
+    uint8_t c = (uint8_t)*s;
+    bool done;
+    switch (c) {
+      case '"':
+      case '\\':
+        done = put('\\') && put(c);
+        break;
+      case '\n':
+        done = put('\\') && put('n');
+        break;
+      case '\r':
+        done = put('\\') && put('r');
+        break;
+      case '\t':
+        done = put('\\') && put('t');
+        break;
+      default:
+        if (c < 0x20) {
+          done = put('\\') && put('u') && put('0') && put('0') &&
+                 put(hex[c >> 4]) && put(hex[c & 0x0F]);
+        } else {
+          done = put(c);
+        }
+        break;
+    }
+    if (!done) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ESP3DJsonWriter::separator() {
+  if (_depth == 0) {
+    return true;
+  }
+  uint32_t bit = 1UL << ((_depth - 1) & 31);
+  if (_hasItem & bit) {
+    return put(',');
+  }
+  _hasItem |= bit;
+  return true;
+}
+
+bool ESP3DJsonWriter::writeKey(const char* key) {
+  if (!separator()) {
+    return false;
+  }
+  if (!key) {
+    return true;
+  }
+  return put('"') && writeEscaped(key) && put('"') && put(':');
+}
+
+bool ESP3DJsonWriter::beginObject(const char* key) {
+  if (!_json) {
+    return !_error;
+  }
+  if (!writeKey(key) || !put('{')) {
+    return false;
+  }
+  _depth++;
+  _hasItem &= ~(1UL << ((_depth - 1) & 31));
+  return true;
+}
+
+bool ESP3DJsonWriter::endObject() {
+  if (!_json) {
+    return !_error;
+  }
+  if (_depth > 0) {
+    _depth--;
+  }
+  return put('}');
+}
+
+bool ESP3DJsonWriter::beginArray(const char* key) {
+  if (!_json) {
+    return !_error;
+  }
+  if (!writeKey(key) || !put('[')) {
+    return false;
+  }
+  _depth++;
+  _hasItem &= ~(1UL << ((_depth - 1) & 31));
+  return true;
+}
+
+bool ESP3DJsonWriter::endArray() {
+  if (!_json) {
+    return !_error;
+  }
+  if (_depth > 0) {
+    _depth--;
+  }
+  return put(']');
+}
+
+bool ESP3DJsonWriter::add(const char* key, const char* value) {
+  if (!_json) {
+    return !_error;
+  }
+  return writeKey(key) && put('"') && writeEscaped(value) && put('"');
+}
+
+bool ESP3DJsonWriter::addRaw(const char* key, const char* value) {
+  if (!_json) {
+    return !_error;
+  }
+  return writeKey(key) && write(value);
+}
+
+bool ESP3DJsonWriter::add(const char* key, uint32_t value) {
+  char tmp[11];
+  snprintf(tmp, sizeof(tmp), "%u", (unsigned int)value);
+  return addRaw(key, tmp);
+}
+
+bool ESP3DJsonWriter::end() {
+  if (_ended) {
+    return !_error;
+  }
+  _ended = true;
+  return flush(true);
+}
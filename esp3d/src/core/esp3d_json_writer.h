@@ -0,0 +1,75 @@
+/*
+  esp3d_json_writer.h - ESP3D streamed responses writer
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _ESP3D_JSON_WRITER_H
+#define _ESP3D_JSON_WRITER_H
+
+#include <Arduino.h>
+
+#include "../include/esp3d_config.h"
+#include "esp3d_message.h"
+
+// Stream a response to one client using a fixed size buffer:
+// data is sent as head/core/tail messages each time the buffer is full,
+// so the heap used does not depend on the response size.
+// JSON helpers take care of separators and escaping, they do nothing
+// when the response is plain text, use write() for plain text.
+class ESP3DJsonWriter {
+ public:
+  ESP3DJsonWriter(ESP3DClientType target, ESP3DRequest requestId,
+                  ESP3DAuthenticationLevel level, bool json = true);
+  ~ESP3DJsonWriter();
+  bool isJson() const { return _json; }
+  bool hasError() const { return _error; }
+  // write as is
+  bool write(const char* s);
+  // write JSON string content
+  bool writeEscaped(const char* s);
+  bool beginObject(const char* key = nullptr);
+  bool endObject();
+  bool beginArray(const char* key = nullptr);
+  bool endArray();
+  // "key":"value", key is null for array item
+  bool add(const char* key, const char* value);
+  // "key":value, value is written as is (number, boolean)
+  bool addRaw(const char* key, const char* value);
+  bool add(const char* key, uint32_t value);
+  // send what is left as final message
+  bool end();
+
+ private:
+  bool put(char c);
+  bool flush(bool last);
+  bool separator();
+  bool writeKey(const char* key);
+  ESP3DClientType _target;
+  ESP3DRequest _requestId;
+  ESP3DAuthenticationLevel _level;
+  bool _json;
+  bool _error;
+  bool _started;
+  bool _ended;
+  uint8_t _depth;
+  uint32_t _hasItem;  // one bit per nesting level
+  size_t _len;
+  char _buffer[ESP3D_JSON_WRITER_BUFFER_SIZE];
+};
+
+#endif  //_ESP3D_JSON_WRITER_H
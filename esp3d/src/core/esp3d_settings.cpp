@@ -77,6 +77,11 @@
 #include "../modules/lua_interpreter/lua_interpreter_service.h"
 #endif  // ESP_LUA_INTERPRETER_FEATURE
 
+#ifndef STRINGIFY
+#define STRINGIFY(x) #x
+#endif  // STRINGIFY
+#define STRING(x) STRINGIFY(x)
+
 // Current Settings Version
 #define CURRENT_SETTINGS_VERSION "ESP3D05"
 
@@ -374,6 +379,37 @@ bool ICACHE_FLASH_ATTR ESP3DSettings::reset(bool networkonly) {
   }
   prefs.end();
 #endif
+  // Erased storage does not read as defaults, and begin() needs the version
+  bool res = true;
+  for (uint16_t i = 0; i < sizeof(ESP3DSettingsData) / sizeof(uint16_t); i++) {
+    ESP3DSettingIndex index = static_cast<ESP3DSettingIndex>(ESP3DSettingsData[i]);
+    const ESP3DSettingDescription *query = getSettingPtr(index);
+    if (!query || index == ESP3DSettingIndex::esp3d_settings_version) {
+      continue;
+    }
+    ESP3DSettingType type = query->type;
+    const char *default_val = query->default_val;
+    int pos = static_cast<int>(index);
+    switch (type) {
+      case ESP3DSettingType::byte_t:
+        res = writeByte(pos, getDefaultByteSetting(index)) && res;
+        break;
+      case ESP3DSettingType::integer_t:
+        res = writeUint32(pos, getDefaultIntegerSetting(index)) && res;
+        break;
+      case ESP3DSettingType::ip_t:
+        res = writeIPString(pos, default_val) && res;
+        break;
+      case ESP3DSettingType::string_t:
+        res = writeString(pos, default_val) && res;
+        break;
+    }
+  }
+  res = writeString(static_cast<int>(ESP3DSettingIndex::esp3d_settings_version), CURRENT_SETTINGS_VERSION) && res;
+  if (!res) {
+    esp3d_log_e("Failed to write default settings");
+    return false;
+  }
   esp3d_log("Settings reset complete");
   return true;
 }
@@ -849,12 +885,17 @@ bool ICACHE_FLASH_ATTR ESP3DSettings::isValidByteSetting(uint8_t value, ESP3DSet
       esp3d_log_e("Invalid state: %d", value);
       break;
     case ESP3DSettingIndex::esp3d_radio_mode:
-      if (value == ESP_NO_NETWORK || value == ESP_WIFI_STA || value == ESP_WIFI_AP || value == ESP_AP_SETUP || value == ESP_BT) {
+      if (value == ESP_NO_NETWORK || value == ESP_BT
+#if defined(WIFI_FEATURE)
+          || value == ESP_WIFI_STA || value == ESP_WIFI_AP || value == ESP_AP_SETUP
+#endif  // WIFI_FEATURE
+      ) {
         esp3d_log("Valid radio mode: %d", value);
         return true;
       }
       esp3d_log_e("Invalid radio mode: %d", value);
       break;
+#if defined(WIFI_FEATURE)
     case ESP3DSettingIndex::esp3d_ap_channel:
       for (uint8_t i = 0; i < SupportedApChannelsSize; i++) {
         if (value == SupportedApChannels[i]) {
@@ -864,20 +905,22 @@ bool ICACHE_FLASH_ATTR ESP3DSettings::isValidByteSetting(uint8_t value, ESP3DSet
       }
       esp3d_log_e("Invalid AP channel: %d", value);
       break;
+#endif  // WIFI_FEATURE
     case ESP3DSettingIndex::esp3d_notification_type:
-      if (value <= (uint8_t)ESP3DNotificationsType::max) {
+      if (value <= (uint8_t)ESP3DNotificationsType::max_notifications) {
         esp3d_log("Valid notification type: %d", value);
         return true;
       }
       esp3d_log_e("Invalid notification type: %d", value);
       break;
     case ESP3DSettingIndex::esp3d_sensor_type:
-      if (value <= (uint8_t)ESP3DSensorType::max) {
+      if (value <= (uint8_t)ESP3DSensorType::max_sensor) {
         esp3d_log("Valid sensor type: %d", value);
         return true;
       }
       esp3d_log_e("Invalid sensor type: %d", value);
       break;
+#if defined(SD_DEVICE)
     case ESP3DSettingIndex::esp3d_sd_speed_div:
       for (uint8_t i = 0; i < SupportedSPIDividerSize; i++) {
         if (value == SupportedSPIDivider[i]) {
@@ -887,6 +930,7 @@ bool ICACHE_FLASH_ATTR ESP3DSettings::isValidByteSetting(uint8_t value, ESP3DSet
       }
       esp3d_log_e("Invalid SD SPI divider: %d", value);
       break;
+#endif  // SD_DEVICE
     case ESP3DSettingIndex::esp3d_output_client:
       if (value == (uint8_t)ESP3DClientType::serial || value == (uint8_t)ESP3DClientType::mks_serial || value == (uint8_t)ESP3DClientType::socket_serial) {
         esp3d_log("Valid output client: %d", value);
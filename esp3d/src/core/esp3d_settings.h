@@ -21,7 +21,7 @@
 #ifndef _ESP3D_SETTINGS_H
 #define _ESP3D_SETTINGS_H
 
-#include "../include/esp3d_defines.h"
+#include "../include/esp3d_config.h"
 #if defined(ESP_LOG_FEATURE)
 #include "../core/esp3d_log.h"
 #endif  // ESP_LOG_FEATURE
@@ -101,76 +101,7 @@
 #define MIN_SSID_LENGTH 1
 #define MIN_PASSWORD_LENGTH 8
 
-// default byte values
-#define DEFAULT_ETH_STA_FALLBACK_MODE 0
-#define DEFAULT_STA_FALLBACK_MODE 0
-#define DEFAULT_ESP_RADIO_MODE 0
-#define DEFAULT_OUTPUT_CLIENT 0
-#define DEFAULT_BUZZER_STATE 1
-#define DEFAULT_INTERNET_TIME 1
-#define DEFAULT_SETUP 0
-#define DEFAULT_VERBOSE_BOOT 0
-#define DEFAULT_STA_IP_MODE 1  // DHCP
-#define DEFAULT_AP_CHANNEL 1
-#define DEFAULT_OUTPUT_FLAG 0
-#define DEFAULT_SD_SPI_DIV 2
-#define DEFAULT_TIME_ZONE 0
-#define DEFAULT_TIME_DST 0
-#define DEFAULT_SD_MOUNT 0
-#define DEFAULT_SD_CHECK_UPDATE_AT_BOOT 0
-#define DEFAULT_SENSOR_TYPE 0
-#define DEFAULT_HTTP_ON 1
-#define DEFAULT_FTP_ON 0
-#define DEFAULT_SERIAL_BRIDGE_ON 0
-#define DEFAULT_WEBDAV_ON 0
-#define DEFAULT_TELNET_ON 0
-#define DEFAULT_WEBSOCKET_ON 0
-#define DEFAULT_NOTIFICATION_TYPE 0
-#define DEFAULT_AUTO_NOTIFICATION_STATE 0
-#define DEFAULT_SECURE_SERIAL 0
-#define DEFAULT_BOOT_RADIO_STATE 0
-#define DEFAULT_PLUGIN_DIRECT_PIN_ENABLED 0
-
-// default int values
-#define DEFAULT_ESP_INT 0
-#define DEFAULT_BAUD_RATE 115200
-#define DEFAULT_SERIAL_BRIDGE_BAUD_RATE 115200
-#define DEFAULT_HTTP_PORT 80
-#define DEFAULT_FTP_CTRL_PORT 21
-#define DEFAULT_FTP_ACTIVE_PORT 20
-#define DEFAULT_FTP_PASSIVE_PORT 55600
-#define DEFAULT_WEBSOCKET_PORT 81
-#define DEFAULT_WEBDAV_PORT 80
-#define DEFAULT_TELNET_PORT 23
-#define DEFAULT_SENSOR_INTERVAL 1000
-#define DEFAULT_BOOT_DELAY 1000
-#define DEFAULT_CALIBRATION_VALUE 0
-#define DEFAULT_CALIBRATION_DONE 0
-#define DEFAULT_SESSION_TIMEOUT 60
-
-// default string values
-#define DEFAULT_AP_SSID_VALUE "ESP3D"
-#define DEFAULT_AP_PASSWORD_VALUE "12345678"
-#define DEFAULT_STA_SSID_VALUE "NETWORK_SSID"
-#define DEFAULT_STA_PASSWORD_VALUE "12345678"
-#define DEFAULT_HOSTNAME_VALUE "esp3d"
-#define DEFAULT_ADMIN_PWD_VALUE "admin"
-#define DEFAULT_USER_PWD_VALUE "user"
-#define DEFAULT_TIME_SERVER1_VALUE "time.windows.com"
-#define DEFAULT_TIME_SERVER2_VALUE "time.google.com"
-#define DEFAULT_TIME_SERVER3_VALUE "0.pool.ntp.org"
-#define DEFAULT_SETTINGS_VERSION_VALUE "ESP3D31"
-#define DEFAULT_STA_IP_VALUE "192.168.0.254"
-#define DEFAULT_STA_GATEWAY_VALUE "192.168.0.254"
-#define DEFAULT_STA_MASK_VALUE "255.255.255.0"
-#define DEFAULT_STA_DNS_VALUE "192.168.0.254"
-#define DEFAULT_AP_IP_VALUE "192.168.0.1"
-#define DEFAULT_AP_GATEWAY_VALUE "192.168.0.1"
-#define DEFAULT_AP_MASK_VALUE "255.255.255.0"
-#define DEFAULT_AP_DNS_VALUE "192.168.0.1"
-#define DEFAULT_NOTIFICATION_TOKEN1_VALUE ""
-#define DEFAULT_NOTIFICATION_TOKEN2_VALUE ""
-#define DEFAULT_NOTIFICATION_SETTINGS_VALUE ""
+// default values are defined in esp3d_settings.cpp
 
 enum class ESP3DSettingType : uint8_t {
   byte_t = 0,
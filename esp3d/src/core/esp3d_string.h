@@ -20,6 +20,7 @@
 
 #ifndef _ESP3D_STRING_H
 #define _ESP3D_STRING_H
+#include <stdint.h>
 #include <time.h>
 namespace esp3d_string {
 const char* formatDuration(uint64_t duration);
@@ -27,7 +27,11 @@
 
 #include "../include/esp3d_defines.h"
 
-#if defined __has_include
+#if defined(ESP3D_NATIVE_CONFIGURATION)
+// host build (tools/native) brings its own configuration
+#include ESP3D_NATIVE_CONFIGURATION
+#define ESP3D_CODE_BASE "ESP3D"
+#elif defined __has_include
 #if __has_include("../../configuration.h")
 #include "../../configuration.h"
 #define ESP3D_CODE_BASE "ESP3D"
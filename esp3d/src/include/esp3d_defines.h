@@ -305,4 +305,12 @@ enum class ESP3DSettingIndex {
 // Minimum heap required for FTP operations
 #define MIN_HEAP_FOR_FTP 20000
 
+// [ESPxxx] parameters tokenizer limits
+#define ESP3D_ARGS_MAX_TOKENS 16
+#define ESP3D_ARGS_BUFFER_SIZE 512
+
+// Streamed responses chunk size and max wait for a busy client (ms)
+#define ESP3D_JSON_WRITER_BUFFER_SIZE 512
+#define ESP3D_JSON_WRITER_TIMEOUT 1000
+
 #endif  //_DEFINES_ESP3D_H
\ No newline at end of file
@@ -120,6 +120,73 @@
 #endif  //! defined(WIFI_FEATURE) && !defined(ETH_FEATURE)
 #endif  // #if defined(ESP_GOT_IP_HOOK) || defined(ESP_GOT_DATE_TIME_HOOK)
 
+/**************************
+ * Lua interpreter
+ * ***********************/
+// print() output goes to printer through G-code host, which waits for ack
+#if defined(ESP_LUA_INTERPRETER_FEATURE) && !defined(GCODE_HOST_FEATURE)
+#error GCODE_HOST_FEATURE is necessary for ESP_LUA_INTERPRETER_FEATURE
+#endif  // ESP_LUA_INTERPRETER_FEATURE && !GCODE_HOST_FEATURE
+
+/**************************
+ * G-code minifier
+ * ***********************/
+#if defined(GCODE_MINIFIER_FEATURE) && !defined(GCODE_HOST_FEATURE)
+#error GCODE_HOST_FEATURE is necessary for GCODE_MINIFIER_FEATURE
+#endif  // GCODE_MINIFIER_FEATURE && !GCODE_HOST_FEATURE
+
+/**************************
+ * G-code index
+ * ***********************/
+#if defined(GCODE_INDEX_FEATURE)
+#ifndef GCODE_HOST_FEATURE
+#error GCODE_HOST_FEATURE is necessary for GCODE_INDEX_FEATURE
+#endif  // GCODE_HOST_FEATURE
+#if !defined(FILESYSTEM_FEATURE) && !defined(SD_DEVICE)
+#error FILESYSTEM_FEATURE or SD_DEVICE is necessary for GCODE_INDEX_FEATURE
+#endif  // !FILESYSTEM_FEATURE && !SD_DEVICE
+// [ESP702] index is built by a global FS background job
+#ifndef GLOBAL_FILESYSTEM_FEATURE
+#define GLOBAL_FILESYSTEM_FEATURE
+#endif  // GLOBAL_FILESYSTEM_FEATURE
+#endif  // GCODE_INDEX_FEATURE
+
+/**************************
+ * Print journal
+ * ***********************/
+#if defined(PRINT_JOURNAL_FEATURE)
+#ifndef GCODE_HOST_FEATURE
+#error GCODE_HOST_FEATURE is necessary for PRINT_JOURNAL_FEATURE
+#endif  // GCODE_HOST_FEATURE
+#ifndef FILESYSTEM_FEATURE
+#error FILESYSTEM_FEATURE is necessary for PRINT_JOURNAL_FEATURE
+#endif  // FILESYSTEM_FEATURE
+#endif  // PRINT_JOURNAL_FEATURE
+
+/**************************
+ * Print queue
+ * ***********************/
+#if defined(PRINT_QUEUE_FEATURE)
+#ifndef GCODE_HOST_FEATURE
+#error GCODE_HOST_FEATURE is necessary for PRINT_QUEUE_FEATURE
+#endif  // GCODE_HOST_FEATURE
+#ifndef FILESYSTEM_FEATURE
+#error FILESYSTEM_FEATURE is necessary for PRINT_QUEUE_FEATURE
+#endif  // FILESYSTEM_FEATURE
+#endif  // PRINT_QUEUE_FEATURE
+
+/**************************
+ * MeatPack
+ * ***********************/
+#if defined(MEATPACK_FEATURE)
+#ifndef GCODE_HOST_FEATURE
+#error GCODE_HOST_FEATURE is necessary for MEATPACK_FEATURE
+#endif  // GCODE_HOST_FEATURE
+#if COMMUNICATION_PROTOCOL != RAW_SERIAL
+#error MEATPACK_FEATURE is only available with RAW_SERIAL
+#endif  // COMMUNICATION_PROTOCOL != RAW_SERIAL
+#endif  // MEATPACK_FEATURE
+
 /**************************
  * Filesystem
  * ***********************/
@@ -373,9 +373,9 @@ bool AuthenticationService::begin(Authwebserver *webserver) {
   update();
 #if defined(HTTP_FEATURE)
   _webserver = webserver;
-#endif  // HTTP_FEATURE
   // value is in ms but storage is in min
   _sessionTimeout = 1000 * 60 * ESP3DSettings::readByte(static_cast<int>(ESP3DSettingIndex::esp3d_session_timeout));
+#endif  // HTTP_FEATURE
   return true;
 }
 
@@ -47,7 +47,10 @@ String BTService::_btname = "";
 String BTService::_btclient = "";
 
 BTService::BTService() {
-  _buffer_size = 0;
+  _rxHead = 0;
+  _rxScan = 0;
+  _lineStart = 0;
+  _txSize = 0;
   _started = false;
 }
 
@@ -105,10 +108,9 @@ const char *BTService::clientmacAddress() { return _btclient.c_str(); }
  */
 bool BTService::begin() {
   bool res = true;
-  _buffer_size = 0;
-  _lastflush = millis();
   // stop BT Serial if active
   end();
+  _lastflush = millis();
   // Get hostname
   // this allow to adjust if necessary
   _btname = ESP3DSettings::readString(ESP_HOSTNAME);
@@ -134,7 +136,10 @@ bool BTService::begin() {
 void BTService::end() {
   flush();
   SerialBT.end();
-  _buffer_size = 0;
+  _rxHead = 0;
+  _rxScan = 0;
+  _lineStart = 0;
+  _txSize = 0;
   _started = false;
 }
 
@@ -158,25 +163,37 @@ bool BTService::started() {
  * Handle not critical actions that must be done in sync environement
  */
 void BTService::handle() {
-  // Do we have some data waiting
+  // Send what was gathered since last loop
+  flushTx();
+  // Read waiting data directly in the ring, one ring at most per loop
+  size_t total = 0;
   size_t len = SerialBT.available();
-  if (len > 0) {
-    // if yes read them
-    uint8_t *sbuf = (uint8_t *)malloc(len);
-    if (sbuf) {
-      size_t count = readBytes(sbuf, len);
-      // push to buffer
-      if (count > 0) {
-        push2buffer(sbuf, count);
-      }
-      // freen buffer
-      free(sbuf);
+  while (len > 0 && total < ESP3D_BT_RX_RING_SIZE) {
+    size_t offset = _rxHead & (ESP3D_BT_RX_RING_SIZE - 1);
+    size_t space = ESP3D_BT_RX_RING_SIZE - (_rxHead - _lineStart);
+    // Stay in contiguous part of the ring
+    if (space > ESP3D_BT_RX_RING_SIZE - offset) {
+      space = ESP3D_BT_RX_RING_SIZE - offset;
     }
+    if (len > space) {
+      len = space;
+    }
+    if (len == 0) {
+      break;
+    }
+    size_t count = readBytes(&_rxRing[offset], len);
+    if (count == 0) {
+      break;
+    }
+    _rxHead += count;
+    total += count;
+    processRing();
+    len = SerialBT.available();
   }
   // we cannot left data in buffer too long
   // in case some commands "forget" to add \n
-  if (((millis() - _lastflush) > TIMEOUT_BT_FLUSH) && (_buffer_size > 0)) {
-    flushBuffer();
+  if (((millis() - _lastflush) > TIMEOUT_BT_FLUSH) && (_rxHead != _lineStart)) {
+    flushLine(_rxHead);
   }
 }
 
@@ -191,16 +208,34 @@ ESP3DAuthenticationLevel BTService::getAuthentication() { return _auth; }
 
 void BTService::flushData(const uint8_t *data, size_t size,
                           ESP3DMessageType type) {
-  ESP3DMessage *message = esp3d_message_manager.newMsg(
-      ESP3DClientType::bluetooth, esp3d_commands.getOutputClient(), data,
-      size, _auth);
+  flushData(data, size, nullptr, 0, type);
+}
 
+// Line may be in two parts when it wraps in the ring, parts are copied
+// directly in the message
+void BTService::flushData(const uint8_t *data, size_t size,
+                          const uint8_t *data2, size_t size2,
+                          ESP3DMessageType type) {
+  ESP3DMessage *message = esp3d_message_manager.newMsg(
+      ESP3DClientType::bluetooth, esp3d_commands.getOutputClient(), _auth);
   if (message) {
+    message->data = (uint8_t *)malloc(size + size2 + 1);
+  }
+  if (message && message->data) {
+    memcpy(message->data, data, size);
+    if (size2 > 0) {
+      memcpy(&message->data[size], data2, size2);
+    }
+    message->size = size + size2;
+    message->data[message->size] = 0x0;
     message->type = type;
     esp3d_log("Process Message");
     esp3d_commands.process(message);
   } else {
     esp3d_log_e("Cannot create message");
+    if (message) {
+      esp3d_message_manager.deleteMsg(message);
+    }
   }
   _lastflush = millis();
 }
@@ -209,33 +244,85 @@ void BTService::flushChar(char c) {
   flushData((uint8_t *)&c, 1, ESP3DMessageType::realtimecmd);
 }
 
-void BTService::flushBuffer() {
-  _buffer[_buffer_size] = 0x0;
-  flushData((uint8_t *)_buffer, _buffer_size, ESP3DMessageType::unique);
-  _buffer_size = 0;
+// Send the line from _lineStart to end
+void BTService::flushLine(uint32_t end) {
+  size_t size = end - _lineStart;
+  size_t offset = _lineStart & (ESP3D_BT_RX_RING_SIZE - 1);
+  _lineStart = end;
+  if (size == 0) {
+    return;
+  }
+  if (offset + size <= ESP3D_BT_RX_RING_SIZE) {
+    flushData(&_rxRing[offset], size, ESP3DMessageType::unique);
+  } else {
+    size_t first = ESP3D_BT_RX_RING_SIZE - offset;
+    flushData(&_rxRing[offset], first, _rxRing, size - first,
+              ESP3DMessageType::unique);
+  }
 }
 
-// push collected data to buffer and proceed accordingly
-void BTService::push2buffer(uint8_t *sbuf, size_t len) {
-  if (!_buffer || !_started) {
+// Check new data of the ring, realtime commands are sent at once and
+// removed from the line, complete lines are sent
+void BTService::processRing() {
+  if (!_started) {
+    _lineStart = _rxScan = _rxHead;
     return;
   }
-  for (size_t i = 0; i < len; i++) {
+  while (_rxScan != _rxHead) {
+    uint8_t c = _rxRing[_rxScan & (ESP3D_BT_RX_RING_SIZE - 1)];
     _lastflush = millis();
-    if (esp3d_string::isRealTimeCommand(sbuf[i])) {
-      flushChar(sbuf[i]);
-    } else {
-      _buffer[_buffer_size] = sbuf[i];
-      _buffer_size++;
-      if (_buffer_size > ESP3D_BT_BUFFER_SIZE ||
-          _buffer[_buffer_size - 1] == '\n') {
-        flushBuffer();
+    if (esp3d_string::isRealTimeCommand(c)) {
+      // Move the line start over the realtime command
+      for (uint32_t p = _rxScan; p != _lineStart; p--) {
+        _rxRing[p & (ESP3D_BT_RX_RING_SIZE - 1)] =
+            _rxRing[(p - 1) & (ESP3D_BT_RX_RING_SIZE - 1)];
       }
+      _lineStart++;
+      _rxScan++;
+      flushChar(c);
+      continue;
+    }
+    _rxScan++;
+    if (c == '\n' || (_rxScan - _lineStart) > ESP3D_BT_BUFFER_SIZE) {
+      flushLine(_rxScan);
     }
   }
 }
 
+// Data are gathered to be sent in bigger chunks
 size_t BTService::writeBytes(const uint8_t *buffer, size_t size) {
+  if (_txSize + size > ESP3D_BT_TX_BUFFER_SIZE) {
+    flushTx();
+  }
+  if (size > ESP3D_BT_TX_BUFFER_SIZE && _txSize == 0) {
+    return sendBytes(buffer, size);
+  }
+  // bytes not sent yet must go first
+  if (_txSize + size > ESP3D_BT_TX_BUFFER_SIZE) {
+    return 0;
+  }
+  memcpy(&_txBuffer[_txSize], buffer, size);
+  _txSize += size;
+  return size;
+}
+
+bool BTService::flushTx() {
+  if (_txSize == 0) {
+    return true;
+  }
+  size_t sent = sendBytes(_txBuffer, _txSize);
+  if (sent > _txSize) {
+    sent = _txSize;
+  }
+  // unsent bytes are kept for next flush
+  if (sent < _txSize) {
+    memmove(_txBuffer, &_txBuffer[sent], _txSize - sent);
+  }
+  _txSize -= sent;
+  return _txSize == 0;
+}
+
+size_t BTService::sendBytes(const uint8_t *buffer, size_t size) {
   if (availableForWrite() >= size) {
     return SerialBT.write(buffer, size);
   } else {
@@ -272,7 +359,10 @@ size_t BTService::readBytes(uint8_t *sbuf, size_t len) {
   return SerialBT.readBytes(sbuf, len);
 }
 
-void BTService::flush() { SerialBT.flush(); }
+void BTService::flush() {
+  flushTx();
+  SerialBT.flush();
+}
 
 const char *BTService::hostname() { return _btname.c_str(); }
 
@@ -24,6 +24,21 @@
 
 #define ESP3D_BT_BUFFER_SIZE 512
 
+// Incoming data are read in this ring, lines are processed from it
+#ifndef ESP3D_BT_RX_RING_SIZE
+#define ESP3D_BT_RX_RING_SIZE 1024
+#endif  // ESP3D_BT_RX_RING_SIZE
+
+// Outgoing data are gathered here and sent once per loop or when full
+#ifndef ESP3D_BT_TX_BUFFER_SIZE
+#define ESP3D_BT_TX_BUFFER_SIZE 512
+#endif  // ESP3D_BT_TX_BUFFER_SIZE
+
+#if (ESP3D_BT_RX_RING_SIZE & (ESP3D_BT_RX_RING_SIZE - 1)) != 0 || \
+    ESP3D_BT_RX_RING_SIZE <= ESP3D_BT_BUFFER_SIZE
+#error "ESP3D_BT_RX_RING_SIZE must be a power of 2 bigger than ESP3D_BT_BUFFER_SIZE"
+#endif
+
 class BTService {
  public:
   BTService();
@@ -54,12 +69,22 @@ class BTService {
   static String _btname;
   static String _btclient;
   uint32_t _lastflush;
-  uint8_t _buffer[ESP3D_BT_BUFFER_SIZE + 1];  // keep space of 0x0 terminal
-  size_t _buffer_size;
-  void push2buffer(uint8_t* sbuf, size_t len);
-  void flushBuffer();
+  uint8_t _rxRing[ESP3D_BT_RX_RING_SIZE];
+  // absolute positions in ring: end of read data, next byte to check and
+  // start of current line
+  uint32_t _rxHead;
+  uint32_t _rxScan;
+  uint32_t _lineStart;
+  uint8_t _txBuffer[ESP3D_BT_TX_BUFFER_SIZE];
+  size_t _txSize;
+  void processRing();
+  void flushLine(uint32_t end);
   void flushChar(char c);
   void flushData(const uint8_t* data, size_t size, ESP3DMessageType type);
+  void flushData(const uint8_t* data, size_t size, const uint8_t* data2,
+                 size_t size2, ESP3DMessageType type);
+  bool flushTx();
+  size_t sendBytes(const uint8_t* buffer, size_t size);
   bool _started;
 };
 
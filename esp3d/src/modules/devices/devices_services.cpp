@@ -132,9 +132,6 @@ void DevicesServices::handle() {
 #ifdef RECOVERY_FEATURE
     recovery_service.handle();
 #endif  // RECOVERY_FEATURE
-#ifdef SD_DEVICE
-    ESP_SD::handle();
-#endif  // SD_DEVICE
   }
 }
 
@@ -43,6 +43,7 @@
 File tFile_handle[ESP_MAX_OPENHANDLE];
 
 bool ESP_FileSystem::_started = false;
+volatile uint32_t ESP_FileSystem::_generation = 0;
 
 bool ESP_FileSystem::begin() {
   if (_started) return true;
@@ -123,10 +124,12 @@ const char* ESP_FileSystem::FilesystemName() {
 }
 
 bool ESP_FileSystem::format() {
+  ESP_FileSystemChange change;
   return FILESYSTEM.format();
 }
 
 File ESP_FileSystem::open(const char* path, uint8_t mode) {
+  ESP_FileSystemChange change(mode != ESP_FILE_READ);
   if (!_started) return File();
   if (mode == ESP_FILE_READ) {
     return FILESYSTEM.open(path, "r");
@@ -144,21 +147,25 @@ bool ESP_FileSystem::exists(const char* path) {
 }
 
 bool ESP_FileSystem::remove(const char* path) {
+  ESP_FileSystemChange change;
   if (!_started) return false;
   return FILESYSTEM.remove(path);
 }
 
 bool ESP_FileSystem::mkdir(const char* path) {
+  ESP_FileSystemChange change;
   if (!_started) return false;
   return FILESYSTEM.mkdir(path);
 }
 
 bool ESP_FileSystem::rmdir(const char* path) {
+  ESP_FileSystemChange change;
   if (!_started) return false;
   return FILESYSTEM.rmdir(path);
 }
 
 bool ESP_FileSystem::rename(const char* oldpath, const char* newpath) {
+  ESP_FileSystemChange change;
   if (!_started) return false;
   return FILESYSTEM.rename(oldpath, newpath);
 }
@@ -335,6 +342,7 @@ bool ESP_File::seek(uint32_t pos, uint8_t mode) {
 }
 
 void ESP_File::close() {
+  ESP_FileSystemChange change(_index != -1 && _iswritemode);
   if (_index != -1) {
     tFile_handle[_index].close();
     tFile_handle[_index] = File();
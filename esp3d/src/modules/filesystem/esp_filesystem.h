@@ -88,9 +88,27 @@ class ESP_FileSystem {
   static void closeAll();
   static bool started() { return _started; }
   static uint8_t getFSType(const char *path = nullptr);
+  // Changed by any write, remove, rename or format, so content can be cached
+  static uint32_t generation() { return _generation; }
+  static void notifyChange() { _generation++; }
 
  private:
   static bool _started;
+  static volatile uint32_t _generation;
+};
+
+// Filesystem content is changed when leaving scope
+class ESP_FileSystemChange {
+ public:
+  ESP_FileSystemChange(bool changed = true) : _changed(changed) {}
+  ~ESP_FileSystemChange() {
+    if (_changed) {
+      ESP_FileSystem::notifyChange();
+    }
+  }
+
+ private:
+  bool _changed;
 };
 
 #endif  // ESP_FILESYSTEM_H
\ No newline at end of file
@@ -680,6 +680,16 @@ void ESP_GBFile::flush() {
   return;
 }
 
+bool ESP_GBFile::preAllocate(uint64_t size) {
+#ifdef SD_DEVICE
+  if (_type == FS_SD) {
+    return _sdFile.preAllocate(size);
+  }
+#endif  // SD_DEVICE
+  (void)size;
+  return false;
+}
+
 ESP_GBFile &ESP_GBFile::operator=(const ESP_GBFile &other) {
 #ifdef FILESYSTEM_FEATURE
   _flashFile = other._flashFile;
@@ -32,6 +32,68 @@
 #include "esp_sd.h"
 #endif  // SD_DEVICE
 
+// Background jobs slots (running, queued and finished ones)
+#ifndef ESP_GBFS_MAX_JOBS
+#if defined(ARDUINO_ARCH_ESP32)
+#define ESP_GBFS_MAX_JOBS 4
+#else
+#define ESP_GBFS_MAX_JOBS 2
+#endif  // ARDUINO_ARCH_ESP32
+#endif  // ESP_GBFS_MAX_JOBS
+
+// Max path length of a job, source and destination included
+#ifndef ESP_GBFS_JOB_PATH_SIZE
+#define ESP_GBFS_JOB_PATH_SIZE 256
+#endif  // ESP_GBFS_JOB_PATH_SIZE
+
+// Max depth of directories a job can walk
+#ifndef ESP_GBFS_JOB_MAX_DEPTH
+#define ESP_GBFS_JOB_MAX_DEPTH 16
+#endif  // ESP_GBFS_JOB_MAX_DEPTH
+
+// Directory handles a job keeps open (deepest levels), SD only allows a
+// few open files and copy needs two more
+#ifndef ESP_GBFS_JOB_OPEN_DIRS
+#define ESP_GBFS_JOB_OPEN_DIRS 2
+#endif  // ESP_GBFS_JOB_OPEN_DIRS
+
+// Time slice (ms) given to jobs on each loop
+#ifndef ESP_GBFS_JOB_TIME_SLICE
+#define ESP_GBFS_JOB_TIME_SLICE 20
+#endif  // ESP_GBFS_JOB_TIME_SLICE
+
+enum class ESP_GBFSJobType : uint8_t {
+  remove = 0,
+  copy,
+  move,
+#if defined(GCODE_INDEX_FEATURE)
+  // G-code layers index of a file, written next to it
+  index,
+#endif  // GCODE_INDEX_FEATURE
+};
+
+enum class ESP_GBFSJobState : uint8_t {
+  none = 0,
+  queued,
+  scanning,
+  running,
+  done,
+  failed,
+  cancelled
+};
+
+struct ESP_GBFSJob {
+  uint16_t id;
+  ESP_GBFSJobType type;
+  ESP_GBFSJobState state;
+  uint32_t totalEntries;
+  uint32_t doneEntries;
+  uint64_t totalBytes;
+  uint64_t doneBytes;
+  char source[ESP_GBFS_JOB_PATH_SIZE];
+  char destination[ESP_GBFS_JOB_PATH_SIZE];
+};
+
 class ESP_GBFile {
  public:
   ESP_GBFile();
@@ -66,6 +128,7 @@ class ESP_GBFile {
   int read();
   size_t read(uint8_t *buf, size_t size);
   void flush();
+  bool preAllocate(uint64_t size);
   ESP_GBFile openNextFile();
 
  private:
@@ -98,6 +161,16 @@ class ESP_GBFS {
   static void closeAll();
   static const char *getNextFS(bool reset = false);
   static uint8_t getFSType(const char *path);
+  // background jobs
+  static uint16_t addJob(ESP_GBFSJobType type, const char *source,
+                         const char *destination = nullptr);
+  static const ESP_GBFSJob *getJob(uint16_t id);
+  static const ESP_GBFSJob *getJobByIndex(uint8_t index);
+  static bool cancelJob(uint16_t id);
+  static bool hasActiveJob();
+  static const char *jobTypeString(ESP_GBFSJobType type);
+  static const char *jobStateString(ESP_GBFSJobState state);
+  static void handle();
 
  private:
   static const char *getRealPath(const char *path);
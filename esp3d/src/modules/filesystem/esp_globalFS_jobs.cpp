@@ -0,0 +1,727 @@
+/*
+  esp_globalFS_jobs.cpp - ESP3D global FS background jobs
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+// #define ESP_LOG_FEATURE LOG_OUTPUT_SERIAL0
+#include "../../include/esp3d_config.h"
+#if defined(GLOBAL_FILESYSTEM_FEATURE)
+#include "esp_globalFS.h"
+#if defined(GCODE_INDEX_FEATURE)
+#include "../gcode_host/gcode_index.h"
+#endif  // GCODE_INDEX_FEATURE
+
+// Jobs are processed one at a time, ESP_GBFS_JOB_TIME_SLICE ms per loop.
+// The walk keeps current paths, the number of entries already done at each
+// level and the handles of the ESP_GBFS_JOB_OPEN_DIRS deepest directories,
+// so next slice goes on reading where previous one stopped. A closed level
+// (above the window, or shared SD given back to printer) is reopened and
+// its done entries skipped.
+// An index job reads its file from _fileOffset on each slice and keeps the
+// index being built until the end of file.
+
+#if defined(ARDUINO_ARCH_ESP32)
+#define ESP_GBFS_JOB_BUFFER_SIZE 2048
+#else
+#define ESP_GBFS_JOB_BUFFER_SIZE 512
+#endif  // ARDUINO_ARCH_ESP32
+
+enum class ESP_GBFSJobPhase : uint8_t {
+  init = 0,
+  scan,
+  copy,
+  remove,
+  rename,
+#if defined(GCODE_INDEX_FEATURE)
+  index,
+#endif  // GCODE_INDEX_FEATURE
+  end
+};
+
+static ESP_GBFSJob _jobs[ESP_GBFS_MAX_JOBS];
+static uint16_t _lastJobId = 0;
+static ESP_GBFSJob *_currentJob = nullptr;
+static ESP_GBFSJobPhase _phase = ESP_GBFSJobPhase::init;
+static bool _sourceIsDir = false;
+static char _srcPath[ESP_GBFS_JOB_PATH_SIZE];
+static char _dstPath[ESP_GBFS_JOB_PATH_SIZE];
+static uint16_t _entryIndex[ESP_GBFS_JOB_MAX_DEPTH];
+static ESP_GBFile _dirs[ESP_GBFS_JOB_MAX_DEPTH];
+static uint8_t _depth = 0;
+static uint32_t _fileOffset = 0;
+#if defined(GCODE_INDEX_FEATURE)
+static ESP3DGcodeIndex _index;
+#endif  // GCODE_INDEX_FEATURE
+
+static bool isFinished(ESP_GBFSJobState state) {
+  return state == ESP_GBFSJobState::done ||
+         state == ESP_GBFSJobState::failed ||
+         state == ESP_GBFSJobState::cancelled;
+}
+
+static bool isActive(ESP_GBFSJobState state) {
+  return state == ESP_GBFSJobState::queued ||
+         state == ESP_GBFSJobState::scanning ||
+         state == ESP_GBFSJobState::running;
+}
+
+static bool hasDestination(ESP_GBFSJobType type) {
+  return type == ESP_GBFSJobType::copy || type == ESP_GBFSJobType::move;
+}
+
+// copy path without trailing '/'
+static bool setPath(char *target, const char *path) {
+  size_t len = strlen(path);
+  if (len == 0 || len >= ESP_GBFS_JOB_PATH_SIZE) {
+    return false;
+  }
+  memcpy(target, path, len + 1);
+  while (len > 1 && target[len - 1] == '/') {
+    target[--len] = '\0';
+  }
+  return true;
+}
+
+static bool appendPath(char *path, const char *name) {
+  size_t len = strlen(path);
+  size_t nameLen = strlen(name);
+  if (len + nameLen + 2 > ESP_GBFS_JOB_PATH_SIZE) {
+    esp3d_log_e("Path too long for %s", name);
+    return false;
+  }
+  path[len] = '/';
+  memcpy(path + len + 1, name, nameLen + 1);
+  return true;
+}
+
+static void parentPath(char *path) {
+  char *p = strrchr(path, '/');
+  if (p && p != path) {
+    *p = '\0';
+  }
+}
+
+static bool isRootPath(const char *path) {
+  uint8_t fsType = ESP_GBFS::getFSType(path);
+  if (fsType == FS_ROOT || fsType == FS_UNKNOWN) {
+    return true;
+  }
+  size_t len = strlen(path);
+  while (len > 1 && path[len - 1] == '/') {
+    len--;
+  }
+#if defined(FILESYSTEM_FEATURE)
+  if (fsType == FS_FLASH && len == strlen(ESP_FLASH_FS_HEADER)) {
+    return true;
+  }
+#endif  // FILESYSTEM_FEATURE
+#if defined(SD_DEVICE)
+  if (fsType == FS_SD && len == strlen(ESP_SD_FS_HEADER)) {
+    return true;
+  }
+#endif  // SD_DEVICE
+  return false;
+}
+
+static void closeDirs() {
+  for (uint8_t i = 0; i < ESP_GBFS_JOB_MAX_DEPTH; i++) {
+    if (_dirs[i].isOpen()) {
+      _dirs[i].close();
+    }
+  }
+}
+
+static void resetWalk() {
+  closeDirs();
+  setPath(_srcPath, _currentJob->source);
+  _dstPath[0] = '\0';
+  if (hasDestination(_currentJob->type)) {
+    setPath(_dstPath, _currentJob->destination);
+  }
+  _depth = 0;
+  _entryIndex[0] = 0;
+  _fileOffset = 0;
+}
+
+static void finishJob(ESP_GBFSJobState state) {
+  closeDirs();
+#if defined(GCODE_INDEX_FEATURE)
+  _index.clear();
+#endif  // GCODE_INDEX_FEATURE
+  _currentJob->state = state;
+  esp3d_log("Job %d %s", _currentJob->id, ESP_GBFS::jobStateString(state));
+  _currentJob = nullptr;
+  _phase = ESP_GBFSJobPhase::init;
+}
+
+static ESP_GBFSJobPhase nextPhase() {
+  switch (_phase) {
+    case ESP_GBFSJobPhase::init:
+#if defined(GCODE_INDEX_FEATURE)
+      if (_currentJob->type == ESP_GBFSJobType::index) {
+        return ESP_GBFSJobPhase::index;
+      }
+#endif  // GCODE_INDEX_FEATURE
+      if (_currentJob->type == ESP_GBFSJobType::move &&
+          ESP_GBFS::getFSType(_currentJob->source) ==
+              ESP_GBFS::getFSType(_currentJob->destination)) {
+        return ESP_GBFSJobPhase::rename;
+      }
+      if (_sourceIsDir) {
+        return ESP_GBFSJobPhase::scan;
+      }
+      // single file: nothing to scan
+      return _currentJob->type == ESP_GBFSJobType::remove
+                 ? ESP_GBFSJobPhase::remove
+                 : ESP_GBFSJobPhase::copy;
+    case ESP_GBFSJobPhase::scan:
+      return _currentJob->type == ESP_GBFSJobType::remove
+                 ? ESP_GBFSJobPhase::remove
+                 : ESP_GBFSJobPhase::copy;
+    case ESP_GBFSJobPhase::copy:
+      return _currentJob->type == ESP_GBFSJobType::move
+                 ? ESP_GBFSJobPhase::remove
+                 : ESP_GBFSJobPhase::end;
+    default:
+      return ESP_GBFSJobPhase::end;
+  }
+}
+
+static bool startPhase(ESP_GBFSJobPhase phase) {
+  // move across FS is a copy then a remove of same entries
+  if (_phase == ESP_GBFSJobPhase::scan &&
+      _currentJob->type == ESP_GBFSJobType::move) {
+    _currentJob->totalEntries *= 2;
+  }
+  _phase = phase;
+  if (phase == ESP_GBFSJobPhase::end) {
+    finishJob(ESP_GBFSJobState::done);
+    return true;
+  }
+  resetWalk();
+  if (phase != ESP_GBFSJobPhase::scan) {
+    _currentJob->state = ESP_GBFSJobState::running;
+  }
+  if (phase == ESP_GBFSJobPhase::copy && _sourceIsDir) {
+    if (!ESP_GBFS::mkdir(_dstPath)) {
+      esp3d_log_e("Cannot create %s", _dstPath);
+      return false;
+    }
+    _currentJob->doneEntries++;
+  }
+#if defined(GCODE_INDEX_FEATURE)
+  if (phase == ESP_GBFSJobPhase::index && !_index.begin()) {
+    return false;
+  }
+#endif  // GCODE_INDEX_FEATURE
+  return true;
+}
+
+// FS may be busy when job is added (e.g. from an FS handler), so source and
+// destination are only checked when job starts
+static int8_t initJob() {
+  if (hasDestination(_currentJob->type) &&
+      ESP_GBFS::exists(_currentJob->destination)) {
+    esp3d_log_e("%s already exists", _currentJob->destination);
+    return -1;
+  }
+  ESP_GBFile f = ESP_GBFS::open(_currentJob->source);
+  if (!f) {
+    esp3d_log_e("Cannot open %s", _currentJob->source);
+    return -1;
+  }
+  _sourceIsDir = f.isDirectory();
+  size_t size = f.size();
+  f.close();
+#if defined(GCODE_INDEX_FEATURE)
+  if (_currentJob->type == ESP_GBFSJobType::index && _sourceIsDir) {
+    esp3d_log_e("%s is not a file", _currentJob->source);
+    return -1;
+  }
+#endif  // GCODE_INDEX_FEATURE
+  _currentJob->totalEntries = 1;
+  if (_currentJob->type != ESP_GBFSJobType::remove && !_sourceIsDir) {
+    _currentJob->totalBytes = size;
+    if (_currentJob->type == ESP_GBFSJobType::move) {
+      _currentJob->totalEntries = 2;
+    }
+  }
+  _currentJob->state = ESP_GBFSJobState::scanning;
+  return 1;
+}
+
+// Copy current file from _fileOffset, 1 when done, 0 when slice is over,
+// -1 on error
+static int8_t copyFile(const char *source, const char *destination,
+                       uint32_t start) {
+  ESP_GBFile src = ESP_GBFS::open(source);
+  if (!src) {
+    esp3d_log_e("Cannot open %s", source);
+    return -1;
+  }
+  if (_fileOffset == 0 && ESP_GBFS::exists(destination)) {
+    ESP_GBFS::remove(destination);
+  }
+  ESP_GBFile dst = ESP_GBFS::open(
+      destination, _fileOffset == 0 ? ESP_FILE_WRITE : ESP_FILE_APPEND);
+  if (!dst) {
+    esp3d_log_e("Cannot open %s", destination);
+    src.close();
+    return -1;
+  }
+  int8_t res = 0;
+  if (_fileOffset > 0 && !src.seek(_fileOffset)) {
+    res = -1;
+  }
+  uint8_t buffer[ESP_GBFS_JOB_BUFFER_SIZE];
+  // at least one chunk per call, so job always moves forward
+  while (res == 0) {
+    size_t len = src.read(buffer, sizeof(buffer));
+    if (len == 0 || len > sizeof(buffer)) {
+      res = (len == 0) ? 1 : -1;
+    } else if (dst.write(buffer, len) != len) {
+      esp3d_log_e("Write failed on %s", destination);
+      res = -1;
+    } else {
+      _fileOffset += len;
+      _currentJob->doneBytes += len;
+      if (millis() - start >= ESP_GBFS_JOB_TIME_SLICE) {
+        break;
+      }
+    }
+  }
+  dst.close();
+  src.close();
+  if (res == 1) {
+    _fileOffset = 0;
+  }
+  return res;
+}
+
+#if defined(GCODE_INDEX_FEATURE)
+// Feed index with current file from _fileOffset, 1 when index is written,
+// 0 when slice is over, -1 on error
+static int8_t indexFile(uint32_t start) {
+  ESP_GBFile file = ESP_GBFS::open(_srcPath);
+  if (!file) {
+    esp3d_log_e("Cannot open %s", _srcPath);
+    return -1;
+  }
+  int8_t res = 0;
+  if (_fileOffset > 0 && !file.seek(_fileOffset)) {
+    res = -1;
+  }
+  uint8_t buffer[ESP_GBFS_JOB_BUFFER_SIZE];
+  while (res == 0) {
+    size_t len = file.read(buffer, sizeof(buffer));
+    if (len == 0 || len > sizeof(buffer)) {
+      res = (len == 0) ? 1 : -1;
+    } else {
+      _index.feed(buffer, len);
+      _fileOffset += len;
+      _currentJob->doneBytes += len;
+      if (millis() - start >= ESP_GBFS_JOB_TIME_SLICE) {
+        break;
+      }
+    }
+  }
+  file.close();
+  if (res == 1) {
+    _index.end();
+    esp3d_log("%s: %d layers, %d lines, %d s", _srcPath, _index.layers(),
+              _index.lines(), _index.totalTime());
+    // no layer found is not an error, file is just not indexable
+    _index.saveFor<ESP_GBFS>(_srcPath);
+    _index.clear();
+    _fileOffset = 0;
+    _currentJob->doneEntries++;
+  }
+  return res;
+}
+#endif  // GCODE_INDEX_FEATURE
+
+// Handle of current level, opened again only if it was closed
+static bool openCurrentDir() {
+  ESP_GBFile &dir = _dirs[_depth];
+  if (dir.isOpen()) {
+    return true;
+  }
+  dir = ESP_GBFS::open(_srcPath);
+  if (!dir || !dir.isDirectory()) {
+    esp3d_log_e("Cannot open %s", _srcPath);
+    if (dir.isOpen()) {
+      dir.close();
+    }
+    return false;
+  }
+  // skip entries already done, removed ones are already gone
+  if (_phase != ESP_GBFSJobPhase::remove) {
+    for (uint16_t i = 0; i < _entryIndex[_depth]; i++) {
+      ESP_GBFile entry = dir.openNextFile();
+      if (!entry) {
+        break;
+      }
+      entry.close();
+    }
+  }
+  return true;
+}
+
+// Walk the tree from where previous slice stopped, 1 when walk is done,
+// 0 when slice is over, -1 on error
+static int8_t walkTree(uint32_t start) {
+  int8_t res = 0;
+  do {
+    int8_t fileRes = 1;
+    if (_fileOffset > 0) {
+      // file partially copied by previous slice, paths are still the file ones
+      fileRes = copyFile(_srcPath, _dstPath, start);
+    } else {
+      if (!openCurrentDir()) {
+        res = -1;
+        break;
+      }
+      ESP_GBFile entry = _dirs[_depth].openNextFile();
+      // end of current directory
+      if (!entry) {
+        _dirs[_depth].close();
+        if (_phase == ESP_GBFSJobPhase::remove) {
+          if (!ESP_GBFS::rmdir(_srcPath)) {
+            esp3d_log_e("Cannot remove %s", _srcPath);
+            res = -1;
+            break;
+          }
+          _currentJob->doneEntries++;
+        }
+        if (_depth == 0) {
+          res = 1;
+          break;
+        }
+        parentPath(_srcPath);
+        if (_phase == ESP_GBFSJobPhase::copy) {
+          parentPath(_dstPath);
+        }
+        _depth--;
+        continue;
+      }
+      bool isDir = entry.isDirectory();
+      size_t size = entry.size();
+      if (!appendPath(_srcPath, entry.name()) ||
+          (_phase == ESP_GBFSJobPhase::copy &&
+           !appendPath(_dstPath, entry.name()))) {
+        entry.close();
+        res = -1;
+        break;
+      }
+      entry.close();
+      // entry is read, removed ones are gone from directory
+      if (_phase != ESP_GBFSJobPhase::remove) {
+        _entryIndex[_depth]++;
+      }
+      if (isDir) {
+        if (_depth + 1 >= ESP_GBFS_JOB_MAX_DEPTH) {
+          esp3d_log_e("Too many levels for %s", _srcPath);
+          res = -1;
+          break;
+        }
+        if (_phase == ESP_GBFSJobPhase::scan) {
+          _currentJob->totalEntries++;
+        } else if (_phase == ESP_GBFSJobPhase::copy) {
+          if (!ESP_GBFS::mkdir(_dstPath)) {
+            esp3d_log_e("Cannot create %s", _dstPath);
+            res = -1;
+            break;
+          }
+          _currentJob->doneEntries++;
+        }
+        _depth++;
+        _entryIndex[_depth] = 0;
+        // keep only deepest levels open
+        if (_depth >= ESP_GBFS_JOB_OPEN_DIRS &&
+            _dirs[_depth - ESP_GBFS_JOB_OPEN_DIRS].isOpen()) {
+          _dirs[_depth - ESP_GBFS_JOB_OPEN_DIRS].close();
+        }
+        continue;
+      }
+      if (_phase == ESP_GBFSJobPhase::scan) {
+        _currentJob->totalEntries++;
+        if (_currentJob->type != ESP_GBFSJobType::remove) {
+          _currentJob->totalBytes += size;
+        }
+      } else if (_phase == ESP_GBFSJobPhase::copy) {
+        fileRes = copyFile(_srcPath, _dstPath, start);
+      } else if (!ESP_GBFS::remove(_srcPath)) {
+        esp3d_log_e("Cannot remove %s", _srcPath);
+        fileRes = -1;
+      }
+    }
+    if (fileRes == 0) {
+      // slice is over in the middle of the file
+      break;
+    }
+    parentPath(_srcPath);
+    if (_phase == ESP_GBFSJobPhase::copy) {
+      parentPath(_dstPath);
+    }
+    if (fileRes < 0) {
+      res = -1;
+      break;
+    }
+    if (_phase != ESP_GBFSJobPhase::scan) {
+      _currentJob->doneEntries++;
+    }
+  } while (millis() - start < ESP_GBFS_JOB_TIME_SLICE);
+  return res;
+}
+
+static int8_t runPhase(uint32_t start) {
+  int8_t res = -1;
+  switch (_phase) {
+    case ESP_GBFSJobPhase::init:
+      res = initJob();
+      break;
+    case ESP_GBFSJobPhase::scan:
+      res = walkTree(start);
+      break;
+    case ESP_GBFSJobPhase::copy:
+      if (_sourceIsDir) {
+        res = walkTree(start);
+      } else {
+        res = copyFile(_srcPath, _dstPath, start);
+        if (res == 1) {
+          _currentJob->doneEntries++;
+        }
+      }
+      break;
+    case ESP_GBFSJobPhase::remove:
+      if (_sourceIsDir) {
+        res = walkTree(start);
+      } else if (ESP_GBFS::remove(_srcPath)) {
+#if defined(GCODE_INDEX_FEATURE)
+        ESP3DGcodeIndex::removeFor<ESP_GBFS>(_srcPath);
+#endif  // GCODE_INDEX_FEATURE
+        _currentJob->doneEntries++;
+        res = 1;
+      }
+      break;
+    case ESP_GBFSJobPhase::rename:
+      if (ESP_GBFS::rename(_srcPath, _dstPath)) {
+#if defined(GCODE_INDEX_FEATURE)
+        ESP3DGcodeIndex::renameFor<ESP_GBFS>(_srcPath, _dstPath);
+#endif  // GCODE_INDEX_FEATURE
+        _currentJob->doneEntries++;
+        res = 1;
+      }
+      break;
+#if defined(GCODE_INDEX_FEATURE)
+    case ESP_GBFSJobPhase::index:
+      res = indexFile(start);
+      break;
+#endif  // GCODE_INDEX_FEATURE
+    default:
+      break;
+  }
+  return res;
+}
+
+uint16_t ESP_GBFS::addJob(ESP_GBFSJobType type, const char *source,
+                          const char *destination) {
+  bool needDestination = hasDestination(type);
+  if (!source || (needDestination && !destination)) {
+    return 0;
+  }
+  char src[ESP_GBFS_JOB_PATH_SIZE];
+  char dst[ESP_GBFS_JOB_PATH_SIZE];
+  dst[0] = '\0';
+  if (!setPath(src, source) || isRootPath(src)) {
+    esp3d_log_e("Invalid source %s", source);
+    return 0;
+  }
+  if (needDestination) {
+    if (!setPath(dst, destination) || isRootPath(dst)) {
+      esp3d_log_e("Invalid destination %s", destination);
+      return 0;
+    }
+    // destination cannot be inside source
+    size_t len = strlen(src);
+    if (strncmp(src, dst, len) == 0 && (dst[len] == '\0' || dst[len] == '/')) {
+      esp3d_log_e("Destination %s is inside %s", dst, src);
+      return 0;
+    }
+  }
+  // free slot or oldest finished job
+  ESP_GBFSJob *slot = nullptr;
+  for (uint8_t i = 0; i < ESP_GBFS_MAX_JOBS; i++) {
+    if (_jobs[i].state == ESP_GBFSJobState::none) {
+      slot = &_jobs[i];
+      break;
+    }
+    if (isFinished(_jobs[i].state) && (!slot || _jobs[i].id < slot->id)) {
+      slot = &_jobs[i];
+    }
+  }
+  if (!slot) {
+    esp3d_log_e("No job slot available");
+    return 0;
+  }
+  memset(slot, 0, sizeof(ESP_GBFSJob));
+  _lastJobId++;
+  if (_lastJobId == 0) {
+    _lastJobId = 1;
+  }
+  slot->id = _lastJobId;
+  slot->type = type;
+  strcpy(slot->source, src);
+  strcpy(slot->destination, dst);
+  slot->state = ESP_GBFSJobState::queued;
+  esp3d_log("Job %d queued: %s %s %s", slot->id, jobTypeString(type), src,
+            dst);
+  return slot->id;
+}
+
+const ESP_GBFSJob *ESP_GBFS::getJob(uint16_t id) {
+  for (uint8_t i = 0; i < ESP_GBFS_MAX_JOBS && id != 0; i++) {
+    if (_jobs[i].id == id && _jobs[i].state != ESP_GBFSJobState::none) {
+      return &_jobs[i];
+    }
+  }
+  return nullptr;
+}
+
+const ESP_GBFSJob *ESP_GBFS::getJobByIndex(uint8_t index) {
+  if (index < ESP_GBFS_MAX_JOBS &&
+      _jobs[index].state != ESP_GBFSJobState::none) {
+    return &_jobs[index];
+  }
+  return nullptr;
+}
+
+// Work already done is kept, running job stops on next loop
+bool ESP_GBFS::cancelJob(uint16_t id) {
+  ESP_GBFSJob *job = (ESP_GBFSJob *)getJob(id);
+  if (!job || !isActive(job->state)) {
+    return false;
+  }
+  job->state = ESP_GBFSJobState::cancelled;
+  esp3d_log("Job %d cancelled", id);
+  return true;
+}
+
+bool ESP_GBFS::hasActiveJob() {
+  for (uint8_t i = 0; i < ESP_GBFS_MAX_JOBS; i++) {
+    if (isActive(_jobs[i].state)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const char *ESP_GBFS::jobTypeString(ESP_GBFSJobType type) {
+  switch (type) {
+    case ESP_GBFSJobType::remove:
+      return "remove";
+    case ESP_GBFSJobType::copy:
+      return "copy";
+    case ESP_GBFSJobType::move:
+      return "move";
+#if defined(GCODE_INDEX_FEATURE)
+    case ESP_GBFSJobType::index:
+      return "index";
+#endif  // GCODE_INDEX_FEATURE
+    default:
+      return "unknown";
+  }
+}
+
+const char *ESP_GBFS::jobStateString(ESP_GBFSJobState state) {
+  switch (state) {
+    case ESP_GBFSJobState::queued:
+      return "queued";
+    case ESP_GBFSJobState::scanning:
+      return "scanning";
+    case ESP_GBFSJobState::running:
+      return "running";
+    case ESP_GBFSJobState::done:
+      return "done";
+    case ESP_GBFSJobState::failed:
+      return "failed";
+    case ESP_GBFSJobState::cancelled:
+      return "cancelled";
+    default:
+      return "none";
+  }
+}
+
+void ESP_GBFS::handle() {
+  if (!_currentJob) {
+    // oldest queued job first
+    for (uint8_t i = 0; i < ESP_GBFS_MAX_JOBS; i++) {
+      if (_jobs[i].state == ESP_GBFSJobState::queued &&
+          (!_currentJob || _jobs[i].id < _currentJob->id)) {
+        _currentJob = &_jobs[i];
+      }
+    }
+    if (!_currentJob) {
+      return;
+    }
+    _phase = ESP_GBFSJobPhase::init;
+    esp3d_log("Job %d started", _currentJob->id);
+  }
+  if (_currentJob->state == ESP_GBFSJobState::cancelled) {
+    closeDirs();
+#if defined(GCODE_INDEX_FEATURE)
+    _index.clear();
+#endif  // GCODE_INDEX_FEATURE
+    _currentJob = nullptr;
+    _phase = ESP_GBFSJobPhase::init;
+    return;
+  }
+  uint8_t srcFS = getFSType(_currentJob->source);
+  uint8_t dstFS = srcFS;
+  if (hasDestination(_currentJob->type)) {
+    dstFS = getFSType(_currentJob->destination);
+  }
+  // FS busy, try again on next loop
+  if (!accessFS(srcFS)) {
+    return;
+  }
+  if (dstFS != srcFS && !accessFS(dstFS)) {
+    releaseFS(srcFS);
+    return;
+  }
+  uint32_t start = millis();
+  do {
+    int8_t res = runPhase(start);
+    if (res < 0) {
+      finishJob(ESP_GBFSJobState::failed);
+    } else if (res > 0 && !startPhase(nextPhase())) {
+      finishJob(ESP_GBFSJobState::failed);
+    }
+  } while (_currentJob && millis() - start < ESP_GBFS_JOB_TIME_SLICE);
+#if defined(SD_DEVICE) && SD_DEVICE_CONNECTION == ESP_SHARED_SD
+  // card can go back to printer once released, handles would be stale
+  if (srcFS == FS_SD) {
+    closeDirs();
+  }
+#endif  // SD_DEVICE && SD_DEVICE_CONNECTION == ESP_SHARED_SD
+  if (dstFS != srcFS) {
+    releaseFS(dstFS);
+  }
+  releaseFS(srcFS);
+}
+
+#endif  // GLOBAL_FILESYSTEM_FEATURE
@@ -24,7 +24,6 @@
 
 #include "esp_sd.h"
 
-#define ESP_MAX_SD_OPENHANDLE 4
 #if (SD_DEVICE == ESP_SD_NATIVE) && defined(ARDUINO_ARCH_ESP8266)
 #define FS_NO_GLOBALS
 #include <SD.h>
@@ -70,23 +69,56 @@ File tSDFile_handle[ESP_MAX_SD_OPENHANDLE];
 
 #if SD_DEVICE_CONNECTION == ESP_SHARED_SD
 bool ESP_SD::_enabled = false;
+uint32_t ESP_SD::_leaseTime = 0;
+uint32_t ESP_SD::_busWaitTime = 0;
+uint32_t ESP_SD::_mountsWindowStart = 0;
+uint16_t ESP_SD::_mountsCount = 0;
+uint16_t ESP_SD::_mountsPerMinute = 0;
 #if SD_CARD_TYPE == ESP_FYSETC_WIFI_PRO_SDCARD
 #include <SPI.h>
 #endif  // SD_CARD_TYPE == ESP_FYSETC_WIFI_PRO_SDCARD
+
+// Printer has priority on the card
+bool ESP_SD::printerRequestsSD() {
+#if defined(ESP_SD_CS_SENSE) && ESP_SD_CS_SENSE != -1
+  if (!digitalRead(ESP_SD_CS_SENSE)) {
+    esp3d_log("SD CS is active");
+    return true;
+  }
+#endif  // ESP_SD_CS_SENSE
+  return false;
+}
+
+void ESP_SD::updateMountsStats(bool newMount) {
+  uint32_t now = millis();
+  if (now - _mountsWindowStart >= 60000) {
+    // no activity during previous minute either
+    _mountsPerMinute =
+        (now - _mountsWindowStart >= 120000) ? 0 : _mountsCount;
+    _mountsCount = 0;
+    _mountsWindowStart = now;
+  }
+  if (newMount) {
+    _mountsCount++;
+  }
+}
+
+uint16_t ESP_SD::mountsPerMinute() {
+  updateMountsStats(false);
+  return _mountsPerMinute;
+}
+
 bool ESP_SD::enableSharedSD() {
   esp3d_log("Enable Shared SD if possible");
   if (_enabled) {
     esp3d_log("Already enabled, skip");
     return false;
   }
-#if defined(ESP_SD_CS_SENSE) && ESP_SD_CS_SENSE != -1
-  bool active_cs = !digitalRead(ESP_SD_CS_SENSE);
-  if (active_cs) {
-    esp3d_log("SD CS is active, skip");
+  if (printerRequestsSD()) {
+    esp3d_log("SD used by printer, skip");
     return false;
   }
-#endif  // ESP_SD_CS_SENSE
-
+  uint32_t start = millis();
   _enabled = true;
 #if defined(ESP_FLAG_SHARED_SD_PIN) && ESP_FLAG_SHARED_SD_PIN != -1
   // need to check if SD is in use ?
@@ -114,7 +146,10 @@ bool ESP_SD::enableSharedSD() {
     card.release();
   }
 #endif  // ESP3DLIB_ENV
-
+  if (_enabled) {
+    updateMountsStats(true);
+  }
+  _busWaitTime += millis() - start;
   return _enabled;
 }
 
@@ -129,16 +164,37 @@ bool ESP_SD::disableSharedSD() {
   SPI.end();
 #endif  // SD_CARD_TYPE == ESP_FYSETC_WIFI_PRO_SDCARD
   // do the switch
+  uint32_t start = millis();
   digitalWrite(ESP_FLAG_SHARED_SD_PIN, !ESP_FLAG_SHARED_SD_VALUE);
   ESP3DHal::wait(100);
+  _busWaitTime += millis() - start;
   return true;
 }
+
+// Give the card back to the printer
+void ESP_SD::releaseSharedSD() {
+  if (!_enabled) {
+    return;
+  }
+  esp3d_log("Release shared SD lease");
+  _enabled = false;
+#if defined(ESP_FLAG_SHARED_SD_PIN) && ESP_FLAG_SHARED_SD_PIN != -1
+  if (ESP_SD::disableSharedSD()) {
+    esp3d_log("Shared SD disabled");
+  }
+#endif  // ESP_FLAG_SHARED_SD_PIN
+#if defined(ESP3DLIB_ENV)
+  esp3d_log("Mount SD in Marlin");
+  card.mount();
+#endif  // ESP3DLIB_ENV
+}
 #endif  // SD_DEVICE_CONNECTION == ESP_SHARED_SD
 
 bool ESP_SD::_started = false;
 uint8_t ESP_SD::_state = ESP_SDCARD_NOT_PRESENT;
 uint8_t ESP_SD::_spi_speed_divider = 1;
 bool ESP_SD::_sizechanged = true;
+volatile uint32_t ESP_SD::_generation = 0;
 uint8_t ESP_SD::setState(uint8_t flag) {
   _state = flag;
   return _state;
@@ -158,7 +214,17 @@ bool ESP_SD::accessFS(uint8_t FS) {
     return false;
   }
 #if SD_DEVICE_CONNECTION == ESP_SHARED_SD
-  if (ESP_SD::enableSharedSD()) {
+  if (_enabled) {
+    // card is still on ESP side since last access
+    if (printerRequestsSD()) {
+      esp3d_log("Printer requests SD, lease released");
+      releaseSharedSD();
+      res = false;
+    } else {
+      esp3d_log("Reuse shared SD lease");
+      res = true;
+    }
+  } else if (ESP_SD::enableSharedSD()) {
     esp3d_log("Access shared SD ok");
     res = true;
   } else {
@@ -176,6 +242,9 @@ bool ESP_SD::accessFS(uint8_t FS) {
       res = false;
       // Sd is not available so release it
       ESP_SD::releaseFS(FS);
+#if SD_DEVICE_CONNECTION == ESP_SHARED_SD
+      releaseSharedSD();
+#endif  // SD_DEVICE_CONNECTION == ESP_SHARED_SD
     } else {
       esp3d_log("SD present");
       res = true;
@@ -190,20 +259,24 @@ void ESP_SD::releaseFS(uint8_t FS) {
   esp3d_log("Release SD");
   setState(ESP_SDCARD_IDLE);
 #if SD_DEVICE_CONNECTION == ESP_SHARED_SD
-  _enabled = false;
-#if defined(ESP_FLAG_SHARED_SD_PIN) && ESP_FLAG_SHARED_SD_PIN != -1
-  if (ESP_SD::disableSharedSD()) {
-    esp3d_log("Shared SD disabled");
+  // keep the card for next access, handle() gives it back when idle
+  _leaseTime = millis();
+  if (ESP_SD_LEASE_IDLE_TIME == 0) {
+    releaseSharedSD();
   }
-#endif  // ESP_FLAG_SHARED_SD_PIN
-#if defined(ESP3DLIB_ENV)
-  esp3d_log("Mount SD in Marlin");
-  card.mount();
-#endif  // ESP3DLIB_ENV
 #endif  // SD_DEVICE_CONNECTION == ESP_SHARED_SD
 }
 
-void ESP_SD::handle() {}
+void ESP_SD::handle() {
+#if SD_DEVICE_CONNECTION == ESP_SHARED_SD
+  if (_enabled && _state != ESP_SDCARD_BUSY) {
+    if ((millis() - _leaseTime >= ESP_SD_LEASE_IDLE_TIME) ||
+        printerRequestsSD()) {
+      releaseSharedSD();
+    }
+  }
+#endif  // SD_DEVICE_CONNECTION == ESP_SHARED_SD
+}
 
 ESP_SDFile::ESP_SDFile(const char* name, const char* filename, bool isdir,
                        size_t size) {
@@ -263,6 +336,24 @@ size_t ESP_SDFile::write(const uint8_t* buf, size_t size) {
   return tSDFile_handle[_index].write(buf, size);
 }
 
+// Reserve contiguous clusters for a freshly created file, so FAT is not
+// walked/updated for each cluster during upload
+// Only SdFat handles this, other backends just write as usual
+bool ESP_SDFile::preAllocate(uint64_t size) {
+  if ((_index == -1) || _isdir || !_iswritemode || size == 0) {
+    return false;
+  }
+#if (SD_DEVICE == ESP_SDFAT2)
+  if (!tSDFile_handle[_index].preAllocate(size)) {
+    esp3d_log("Preallocation of %u bytes failed", (uint32_t)size);
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif  // SD_DEVICE == ESP_SDFAT2
+}
+
 int ESP_SDFile::read() {
   if ((_index == -1) || _isdir) {
     return -1;
@@ -27,7 +27,33 @@
 
 #define ESP_SD_FS_HEADER "/SD"
 
-#define ESP_MAX_SD_OPENHANDLE 4
+// Files open at same time on SD:
+// - G-code host: streamed file + next queued file opened ahead (2)
+// - G-code index read when stream starts (1)
+// - HTTP / WebDAV upload or download (1)
+// - directory listing: directory + current entry (2)
+// - Global FS job: ESP_GBFS_JOB_OPEN_DIRS directories + copy source and
+//   destination (4)
+#ifndef ESP_MAX_SD_OPENHANDLE
+#define ESP_MAX_SD_OPENHANDLE 10
+#endif  // ESP_MAX_SD_OPENHANDLE
+
+// Time shared SD stays on ESP side after last access (ms)
+#ifndef ESP_SD_LEASE_IDLE_TIME
+#define ESP_SD_LEASE_IDLE_TIME 2000
+#endif  // ESP_SD_LEASE_IDLE_TIME
+
+// Upload write buffer, must be a multiple of the 512 bytes sector size
+#ifndef ESP_SD_WRITE_BUFFER_SIZE
+#if defined(ARDUINO_ARCH_ESP32)
+#define ESP_SD_WRITE_BUFFER_SIZE 4096
+#else
+#define ESP_SD_WRITE_BUFFER_SIZE 1024
+#endif  // ARDUINO_ARCH_ESP32
+#endif  // ESP_SD_WRITE_BUFFER_SIZE
+#if (ESP_SD_WRITE_BUFFER_SIZE % 512) != 0
+#error ESP_SD_WRITE_BUFFER_SIZE must be a multiple of 512
+#endif
 
 class ESP_SDFile {
  public:
@@ -53,6 +79,7 @@ class ESP_SDFile {
   int read();
   size_t read(uint8_t* buf, size_t size);
   void flush();
+  bool preAllocate(uint64_t size);
   ESP_SDFile openNextFile();
 
  private:
@@ -92,19 +119,49 @@ class ESP_SD {
   static void closeAll();
   static uint8_t getSPISpeedDivider() { return _spi_speed_divider; }
   static bool setSPISpeedDivider(uint8_t speeddivider);
+  // Changed by any write, remove, rename or format done by ESP3D, not by
+  // card swap or by printer on shared SD
+  static uint32_t generation() { return _generation; }
+  static void notifyChange() { _generation++; }
 #if SD_DEVICE_CONNECTION == ESP_SHARED_SD
   static bool enableSharedSD();
   static bool disableSharedSD();
   static bool isEnabled() { return _enabled; }
+  // Shared bus statistics
+  static uint16_t mountsPerMinute();
+  static uint32_t busWaitTime() { return _busWaitTime; }
 #endif  // SD_DEVICE_CONNECTION == ESP_SHARED_SD
  private:
   static bool _started;
 #if SD_DEVICE_CONNECTION == ESP_SHARED_SD
+  static bool printerRequestsSD();
+  static void releaseSharedSD();
+  static void updateMountsStats(bool newMount);
   static bool _enabled;
+  static uint32_t _leaseTime;
+  static uint32_t _busWaitTime;
+  static uint32_t _mountsWindowStart;
+  static uint16_t _mountsCount;
+  static uint16_t _mountsPerMinute;
 #endif  // SD_DEVICE_CONNECTION == ESP_SHARED_SD
   static uint8_t _state;
   static uint8_t _spi_speed_divider;
   static bool _sizechanged;
+  static volatile uint32_t _generation;
+};
+
+// SD content is changed when leaving scope
+class ESP_SDChange {
+ public:
+  ESP_SDChange(bool changed = true) : _changed(changed) {}
+  ~ESP_SDChange() {
+    if (_changed) {
+      ESP_SD::notifyChange();
+    }
+  }
+
+ private:
+  bool _changed;
 };
 
 #endif  //_ESP_SD_H
@@ -50,12 +50,14 @@ size_t ESP_FileSystem::usedBytes() {
 uint ESP_FileSystem::maxPathLength() { return 32; }
 
 bool ESP_FileSystem::rename(const char *oldpath, const char *newpath) {
+  ESP_FileSystemChange change;
   return FFat.rename(oldpath, newpath);
 }
 
 const char *ESP_FileSystem::FilesystemName() { return "FAT"; }
 
 bool ESP_FileSystem::format() {
+  ESP_FileSystemChange change;
   bool res = FFat.format();
   if (res) {
     res = begin();
@@ -64,6 +66,7 @@ bool ESP_FileSystem::format() {
 }
 
 ESP_File ESP_FileSystem::open(const char *path, uint8_t mode) {
+  ESP_FileSystemChange change(mode != ESP_FILE_READ);
   esp3d_log("open %s as %s", path, (mode == ESP_FILE_WRITE ? "write" : "read"));
   // do some check
   if (((strcmp(path, "/") == 0) &&
@@ -109,9 +112,13 @@ bool ESP_FileSystem::exists(const char *path) {
   return res;
 }
 
-bool ESP_FileSystem::remove(const char *path) { return FFat.remove(path); }
+bool ESP_FileSystem::remove(const char *path) {
+  ESP_FileSystemChange change;
+  return FFat.remove(path);
+}
 
 bool ESP_FileSystem::mkdir(const char *path) {
+  ESP_FileSystemChange change;
   String p = path;
   if (p[0] != '/') {
     p = "/" + p;
@@ -125,6 +132,7 @@ bool ESP_FileSystem::mkdir(const char *path) {
 }
 
 bool ESP_FileSystem::rmdir(const char *path) {
+  ESP_FileSystemChange change;
   String p = path;
   if (!p.startsWith("/")) {
     p = '/' + p;
@@ -238,6 +246,7 @@ bool ESP_File::seek(uint32_t pos, uint8_t mode) {
 }
 
 void ESP_File::close() {
+  ESP_FileSystemChange change(_index != -1 && _iswritemode);
   if (_index != -1) {
     esp3d_log("Closing File %s at index %d", _filename.c_str(), _index);
     esp3d_log("name: %s", _name.c_str());
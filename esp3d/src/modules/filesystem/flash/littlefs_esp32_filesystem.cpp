@@ -51,6 +51,7 @@ size_t ESP_FileSystem::usedBytes() { return LittleFS.usedBytes(); }
 uint ESP_FileSystem::maxPathLength() { return 32; }
 
 bool ESP_FileSystem::rename(const char *oldpath, const char *newpath) {
+  ESP_FileSystemChange change;
   esp3d_log("rename %s to %s", oldpath, newpath);
   return LittleFS.rename(oldpath, newpath);
 }
@@ -58,6 +59,7 @@ bool ESP_FileSystem::rename(const char *oldpath, const char *newpath) {
 const char *ESP_FileSystem::FilesystemName() { return "LittleFS"; }
 
 bool ESP_FileSystem::format() {
+  ESP_FileSystemChange change;
   bool res = LittleFS.format();
   if (res) {
     res = begin();
@@ -66,6 +68,7 @@ bool ESP_FileSystem::format() {
 }
 
 ESP_File ESP_FileSystem::open(const char *path, uint8_t mode) {
+  ESP_FileSystemChange change(mode != ESP_FILE_READ);
   esp3d_log("open %s", path);
   // do some check
   if (((strcmp(path, "/") == 0) &&
@@ -115,6 +118,7 @@ bool ESP_FileSystem::exists(const char *path) {
 }
 
 bool ESP_FileSystem::remove(const char *path) {
+  ESP_FileSystemChange change;
   String p = path;
   if (p[0] != '/') {
     p = "/" + p;
@@ -123,6 +127,7 @@ bool ESP_FileSystem::remove(const char *path) {
 }
 
 bool ESP_FileSystem::mkdir(const char *path) {
+  ESP_FileSystemChange change;
   String p = path;
   if (p[0] != '/') {
     p = "/" + p;
@@ -136,6 +141,7 @@ bool ESP_FileSystem::mkdir(const char *path) {
 }
 
 bool ESP_FileSystem::rmdir(const char *path) {
+  ESP_FileSystemChange change;
   String p = path;
   if (!p.startsWith("/")) {
     p = '/' + p;
@@ -253,6 +259,7 @@ ESP_File::ESP_File(void *handle, bool isdir, bool iswritemode,
 }
 
 void ESP_File::close() {
+  ESP_FileSystemChange change(_index != -1 && _iswritemode);
   if (_index != -1) {
     esp3d_log("Closing File at index %d", _index);
     tFile_handle[_index].close();
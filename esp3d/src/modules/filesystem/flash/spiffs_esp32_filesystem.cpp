@@ -47,12 +47,14 @@ size_t ESP_FileSystem::usedBytes() { return SPIFFS.usedBytes(); }
 uint ESP_FileSystem::maxPathLength() { return 32; }
 
 bool ESP_FileSystem::rename(const char *oldpath, const char *newpath) {
+  ESP_FileSystemChange change;
   return SPIFFS.rename(oldpath, newpath);
 }
 
 const char *ESP_FileSystem::FilesystemName() { return "SPIFFS"; }
 
 bool ESP_FileSystem::format() {
+  ESP_FileSystemChange change;
   bool res = SPIFFS.format();
   if (res) {
     res = begin();
@@ -61,6 +63,7 @@ bool ESP_FileSystem::format() {
 }
 
 ESP_File ESP_FileSystem::open(const char *path, uint8_t mode) {
+  ESP_FileSystemChange change(mode != ESP_FILE_READ);
   // do some check
   if (((strcmp(path, "/") == 0) &&
        ((mode == ESP_FILE_WRITE) || (mode == ESP_FILE_APPEND))) ||
@@ -125,6 +128,7 @@ bool ESP_FileSystem::exists(const char *path) {
 }
 
 bool ESP_FileSystem::remove(const char *path) {
+  ESP_FileSystemChange change;
   String p = path;
   if (p[0] != '/') {
     p = "/" + p;
@@ -133,6 +137,7 @@ bool ESP_FileSystem::remove(const char *path) {
 }
 
 bool ESP_FileSystem::mkdir(const char *path) {
+  ESP_FileSystemChange change;
   // Use file named . to simulate directory
   String p = path;
   if (p[p.length() - 1] != '/') {
@@ -150,6 +155,7 @@ bool ESP_FileSystem::mkdir(const char *path) {
 }
 
 bool ESP_FileSystem::rmdir(const char *path) {
+  ESP_FileSystemChange change;
   String spath = path;
   spath.trim();
   if (!spath.startsWith("/")) {
@@ -257,6 +263,7 @@ bool ESP_File::seek(uint32_t pos, uint8_t mode) {
 }
 
 void ESP_File::close() {
+  ESP_FileSystemChange change(_index != -1 && _iswritemode);
   if (_index != -1) {
     esp3d_log("Closing File at index %d", _index);
     tFile_handle[_index].close();
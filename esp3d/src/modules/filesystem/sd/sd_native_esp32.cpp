@@ -62,8 +62,10 @@ uint8_t ESP_SD::getState(bool refresh) {
             ESP_SD_MISO_PIN != -1 ? ESP_SD_MISO_PIN : MISO,
             ESP_SD_MOSI_PIN != -1 ? ESP_SD_MOSI_PIN : MOSI,
             ESP_SD_SCK_PIN != -1 ? ESP_SD_SCK_PIN : SCK);
+  // VFS allows 5 open files by default
   if (SD.begin((ESP_SD_CS_PIN == -1) ? SS : ESP_SD_CS_PIN, SPI,
-               ESP_SPI_FREQ / _spi_speed_divider)) {
+               ESP_SPI_FREQ / _spi_speed_divider, "/sd",
+               ESP_MAX_SD_OPENHANDLE)) {
     if (SD.cardSize() > 0) {
       _state = ESP_SDCARD_IDLE;
     }
@@ -150,17 +152,20 @@ uint64_t ESP_SD::freeBytes(bool refresh) {
 uint ESP_SD::maxPathLength() { return 255; }
 
 bool ESP_SD::rename(const char *oldpath, const char *newpath) {
+  ESP_SDChange change;
   esp3d_log("rename %s to %s", oldpath, newpath);
   return SD.rename(oldpath, newpath);
 }
 
 bool ESP_SD::format() {
+  ESP_SDChange change;
   // not available yet
   esp3d_log_e("Not implemented!");
   return false;
 }
 
 ESP_SDFile ESP_SD::open(const char *path, uint8_t mode) {
+  ESP_SDChange change(mode != ESP_FILE_READ);
   // do some check
   if (((strcmp(path, "/") == 0) &&
        ((mode == ESP_FILE_WRITE) || (mode == ESP_FILE_APPEND))) ||
@@ -207,9 +212,13 @@ bool ESP_SD::exists(const char *path) {
   return res;
 }
 
-bool ESP_SD::remove(const char *path) { return SD.remove(path); }
+bool ESP_SD::remove(const char *path) {
+  ESP_SDChange change;
+  return SD.remove(path);
+}
 
 bool ESP_SD::mkdir(const char *path) {
+  ESP_SDChange change;
   String p = path;
   if (p.endsWith("/")) {
     p.remove(p.length() - 1, 1);
@@ -218,6 +227,7 @@ bool ESP_SD::mkdir(const char *path) {
 }
 
 bool ESP_SD::rmdir(const char *path) {
+  ESP_SDChange change;
   String p = path;
   if (!p.startsWith("/")) {
     p = '/' + p;
@@ -325,6 +335,7 @@ bool ESP_SDFile::seek(uint32_t pos, uint8_t mode) {
 }
 
 void ESP_SDFile::close() {
+  ESP_SDChange change(_index != -1 && _iswritemode);
   if (_index != -1) {
     // esp3d_log("Closing File at index %d", _index);
     tSDFile_handle[_index].close();
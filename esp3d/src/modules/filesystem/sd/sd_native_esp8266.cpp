@@ -177,16 +177,19 @@ uint64_t ESP_SD::freeBytes(bool refresh) {
 uint ESP_SD::maxPathLength() { return 255; }
 
 bool ESP_SD::rename(const char* oldpath, const char* newpath) {
+  ESP_SDChange change;
   return (bool)SDFS.rename(oldpath, newpath);
 }
 
 bool ESP_SD::format() {
+  ESP_SDChange change;
   esp3d_log_e("Not implemented!");
 
   return false;
 }
 
 ESP_SDFile ESP_SD::open(const char* path, uint8_t mode) {
+  ESP_SDChange change(mode != ESP_FILE_READ);
   // do some check
   if (((strcmp(path, "/") == 0) &&
        ((mode == ESP_FILE_WRITE) || (mode == ESP_FILE_APPEND))) ||
@@ -235,13 +238,18 @@ bool ESP_SD::exists(const char* path) {
 }
 
 bool ESP_SD::remove(const char* path) {
+  ESP_SDChange change;
   _sizechanged = true;
   return SD.remove(path);
 }
 
-bool ESP_SD::mkdir(const char* path) { return SD.mkdir(path); }
+bool ESP_SD::mkdir(const char* path) {
+  ESP_SDChange change;
+  return SD.mkdir(path);
+}
 
 bool ESP_SD::rmdir(const char* path) {
+  ESP_SDChange change;
   String p = path;
   if (!p.endsWith("/")) {
     p += '/';
@@ -360,6 +368,7 @@ const char* ESP_SDFile::shortname() const {
 }
 
 void ESP_SDFile::close() {
+  ESP_SDChange change(_index != -1 && _iswritemode);
   if (_index != -1) {
     // esp3d_log("Closing File at index %d", _index);
     tSDFile_handle[_index].close();
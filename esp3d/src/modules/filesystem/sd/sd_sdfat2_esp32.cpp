@@ -211,10 +211,12 @@ uint64_t ESP_SD::freeBytes(bool refresh) {
 uint ESP_SD::maxPathLength() { return 255; }
 
 bool ESP_SD::rename(const char* oldpath, const char* newpath) {
+  ESP_SDChange change;
   return SD.rename(oldpath, newpath);
 }
 
 bool ESP_SD::format() {
+  ESP_SDChange change;
   uint32_t const ERASE_SIZE = 262144L;
   uint32_t cardSectorCount = 0;
   uint8_t sectorBuffer[512];
@@ -282,6 +284,7 @@ bool ESP_SD::format() {
 }
 
 ESP_SDFile ESP_SD::open(const char* path, uint8_t mode) {
+  ESP_SDChange change(mode != ESP_FILE_READ);
   esp3d_log("open %s, %d", path, mode);
   // do some check
   if (((strcmp(path, "/") == 0) &&
@@ -336,13 +339,18 @@ bool ESP_SD::exists(const char* path) {
 }
 
 bool ESP_SD::remove(const char* path) {
+  ESP_SDChange change;
   _sizechanged = true;
   return SD.remove(path);
 }
 
-bool ESP_SD::mkdir(const char* path) { return SD.mkdir(path); }
+bool ESP_SD::mkdir(const char* path) {
+  ESP_SDChange change;
+  return SD.mkdir(path);
+}
 
 bool ESP_SD::rmdir(const char* path) {
+  ESP_SDChange change;
   String p = path;
   if (!p.endsWith("/")) {
     p += '/';
@@ -485,6 +493,7 @@ const char* ESP_SDFile::shortname() const {
 }
 
 void ESP_SDFile::close() {
+  ESP_SDChange change(_index != -1 && _iswritemode);
   if (_index != -1) {
     // esp3d_log("Closing File at index %d", _index);
     tSDFile_handle[_index].close();
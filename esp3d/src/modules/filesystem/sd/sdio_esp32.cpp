@@ -61,7 +61,8 @@ uint8_t ESP_SD::getState(bool refresh) {
   if (!lastinitok) {
     esp3d_log("last init was failed try sd_mmc begin");
     SD_MMC.end();
-    if (SD_MMC.begin("/sdcard", SDIO_BIT_MODE)) {
+    if (SD_MMC.begin("/sdcard", SDIO_BIT_MODE, false,
+                     BOARD_MAX_SDMMC_FREQ, ESP_MAX_SD_OPENHANDLE)) {
       esp3d_log("sd_mmc begin succeed");
       if (SD_MMC.cardType() != CARD_NONE) {
         _state = ESP_SDCARD_IDLE;
@@ -82,7 +83,8 @@ uint8_t ESP_SD::getState(bool refresh) {
       lastinitok = false;
       esp3d_log_e("Soft sd check failed");
       SD_MMC.end();
-      if (SD_MMC.begin("/sdcard", SDIO_BIT_MODE)) {
+      if (SD_MMC.begin("/sdcard", SDIO_BIT_MODE, false,
+                       BOARD_MAX_SDMMC_FREQ, ESP_MAX_SD_OPENHANDLE)) {
         esp3d_log("new sd_mmc begin succeed");
         if (SD_MMC.cardType() != CARD_NONE) {
           _state = ESP_SDCARD_IDLE;
@@ -161,10 +163,12 @@ uint64_t ESP_SD::freeBytes(bool refresh) {
 uint ESP_SD::maxPathLength() { return 255; }
 
 bool ESP_SD::rename(const char *oldpath, const char *newpath) {
+  ESP_SDChange change;
   return SD_MMC.rename(oldpath, newpath);
 }
 
 bool ESP_SD::format() {
+  ESP_SDChange change;
   // not available yet
   esp3d_log_e("Not implemented!");
 
@@ -172,6 +176,7 @@ bool ESP_SD::format() {
 }
 
 ESP_SDFile ESP_SD::open(const char *path, uint8_t mode) {
+  ESP_SDChange change(mode != ESP_FILE_READ);
   // do some check
   if (((strcmp(path, "/") == 0) &&
        ((mode == ESP_FILE_WRITE) || (mode == ESP_FILE_APPEND))) ||
@@ -222,9 +227,13 @@ bool ESP_SD::exists(const char *path) {
   return res;
 }
 
-bool ESP_SD::remove(const char *path) { return SD_MMC.remove(path); }
+bool ESP_SD::remove(const char *path) {
+  ESP_SDChange change;
+  return SD_MMC.remove(path);
+}
 
 bool ESP_SD::mkdir(const char *path) {
+  ESP_SDChange change;
   String p = path;
   if (p.endsWith("/")) {
     p.remove(p.length() - 1, 1);
@@ -233,6 +242,7 @@ bool ESP_SD::mkdir(const char *path) {
 }
 
 bool ESP_SD::rmdir(const char *path) {
+  ESP_SDChange change;
   if (!exists(path)) {
     return false;
   }
@@ -335,6 +345,7 @@ bool ESP_SDFile::seek(uint32_t pos, uint8_t mode) {
 }
 
 void ESP_SDFile::close() {
+  ESP_SDChange change(_index != -1 && _iswritemode);
   if (_index != -1) {
     // esp3d_log("Closing File at index %d", _index);
     tSDFile_handle[_index].close();
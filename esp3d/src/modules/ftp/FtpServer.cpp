@@ -12,6 +12,9 @@
 #include "FtpServer.h"
 #include "../../core/esp3d_log.h"
 #include "../filesystem/esp_filesystem.h"
+#if defined(GCODE_INDEX_FEATURE)
+#include "../gcode_host/gcode_index.h"
+#endif  // GCODE_INDEX_FEATURE
 #if defined(SD_DEVICE)
 #include "../filesystem/esp_sd.h"
 #endif
@@ -195,6 +198,7 @@ void FtpServer::iniVariables() {
   millisEndConnection = 0;
   millisBeginTrans = 0;
   bytesTransfered = 0;
+  allocSize = 0;
   rnfrCmd = false;
   strcpy(cwdName, "/");
   _currentUser = "";
@@ -303,6 +307,9 @@ bool FtpServer::processCommand() {
             char path[FTP_CWD_SIZE];
             if (makePath(path)) {
               if (ESP_FileSystem::rename(rnfrName, path)) {
+#if defined(GCODE_INDEX_FEATURE)
+                ESP3DGcodeIndex::renameFor<ESP_FileSystem>(rnfrName, path);
+#endif  // GCODE_INDEX_FEATURE
                 client.println("250 Rename successful");
               } else {
                 client.println("550 Rename failed");
@@ -319,6 +326,9 @@ bool FtpServer::processCommand() {
             char path[FTP_CWD_SIZE];
             if (makeExistsPath(path)) {
               if (ESP_FileSystem::remove(path)) {
+#if defined(GCODE_INDEX_FEATURE)
+                ESP3DGcodeIndex::removeFor<ESP_FileSystem>(path);
+#endif  // GCODE_INDEX_FEATURE
                 client.println("250 File deleted");
               } else {
                 client.println("550 Delete failed");
@@ -329,6 +339,15 @@ bool FtpServer::processCommand() {
           } else {
             client.println("501 No file specified");
           }
+        } else if (CommandIs("ALLO")) {
+          // announced size of next STOR
+          allocSize = haveParameter() ? strtoul(parameter, nullptr, 10) : 0;
+          if (allocSize > ESP_FileSystem::freeBytes()) {
+            allocSize = 0;
+            client.println("552 Insufficient storage space");
+          } else {
+            client.println("200 ALLO command successful");
+          }
         } else if (CommandIs("MKD")) {
           if (haveParameter()) {
             char path[FTP_CWD_SIZE];
@@ -504,6 +523,17 @@ bool FtpServer::doStore() {
   if (!dataConnect()) {
     return false;
   }
+  // size announced by ALLO is only valid for this transfer
+  uint32_t announcedSize = allocSize;
+  allocSize = 0;
+  if (announcedSize > ESP_FileSystem::freeBytes()) {
+    client.println("552 Insufficient storage space");
+    closeTransfer();
+    return false;
+  }
+  // file is written without ESP_FileSystem, so cached content of
+  // filesystem is dropped once file is closed
+  ESP_FileSystemChange change;
   File file = FILESYSTEM.open(path, "w");
   if (!file) {
     client.println("550 Failed to create file");
@@ -513,11 +543,26 @@ bool FtpServer::doStore() {
   millisBeginTrans = millis();
   bytesTransfered = 0;
   transferStage = FTP_Store;
-  while (data.available()) {
-    int readBytes = data.read(buf, FTP_BUF_SIZE);
+  // buffer is only written when full, so flash gets whole blocks
+  size_t buffered = 0;
+  bool writeError = false;
+#if defined(GCODE_INDEX_FEATURE)
+  // layers are indexed while data are received
+  ESP3DGcodeIndex index;
+  bool indexed = ESP3DGcodeIndex::isGcodeFile(path) && index.begin();
+#endif  // GCODE_INDEX_FEATURE
+  while (data.available() && !writeError) {
+    int readBytes = data.read(buf + buffered, FTP_BUF_SIZE - buffered);
     if (readBytes <= 0) break;
-    file.write(buf, readBytes);
+    buffered += readBytes;
     bytesTransfered += readBytes;
+    if (buffered == FTP_BUF_SIZE) {
+      writeError = (file.write(buf, buffered) != buffered);
+#if defined(GCODE_INDEX_FEATURE)
+      index.feed(buf, buffered);
+#endif  // GCODE_INDEX_FEATURE
+      buffered = 0;
+    }
     if (millis() - millisBeginTrans > FTP_TIME_OUT * 1000) {
       client.println("552 Transfer timeout");
       file.close();
@@ -525,8 +570,24 @@ bool FtpServer::doStore() {
       return false;
     }
   }
+  if (buffered > 0 && !writeError) {
+    writeError = (file.write(buf, buffered) != buffered);
+#if defined(GCODE_INDEX_FEATURE)
+    index.feed(buf, buffered);
+#endif  // GCODE_INDEX_FEATURE
+  }
   file.close();
   closeTransfer();
+  if (writeError) {
+    client.println("452 Write error");
+    return false;
+  }
+#if defined(GCODE_INDEX_FEATURE)
+  if (indexed) {
+    index.end();
+    index.saveFor<ESP_FileSystem>(path);
+  }
+#endif  // GCODE_INDEX_FEATURE
   client.println("226 Transfer complete");
   return true;
 }
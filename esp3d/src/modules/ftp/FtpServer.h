@@ -196,6 +196,7 @@ class FtpServer {
   char rnfrName[FTP_CWD_SIZE];  // name of file for RNFR command
   char command[5];              // command sent by client
   bool rnfrCmd;                 // previous command was RNFR
+  uint32_t allocSize;           // size announced by ALLO for next STOR
   char* parameter;              // point to begin of parameters sent by client
   uint16_t dataPort;
   uint16_t iCL;  // pointer to cmdLine next incoming char
@@ -23,19 +23,61 @@
 #include "../../core/esp3d_commands.h"
 #include "../../core/esp3d_settings.h"
 #include "gcode_host.h"
+#if defined(MEATPACK_FEATURE)
+#include "../meatpack/meatpack.h"
+#endif  // MEATPACK_FEATURE
 
+// Stream uses one slot, next queued job is opened in the other one
 #if defined(FILESYSTEM_FEATURE)
 #include "../filesystem/esp_filesystem.h"
-ESP_File FSfileHandle;
+ESP_File FSfileHandle[2];
 #endif  // FILESYSTEM_FEATURE
 #if defined(SD_DEVICE)
 #include "../filesystem/esp_sd.h"
-ESP_SDFile SDfileHandle;
+ESP_SDFile SDfileHandle[2];
 #endif  // FILESYSTEM_FEATURE
 
 #define ESP_HOST_TIMEOUT 16000
 #define MAX_TRY_2_SEND 5
 
+// Go to first line start at or after offset, offset is updated
+template <typename T>
+static bool seekLine(T &file, uint32_t &offset) {
+  offset--;
+  if (!file.seek(offset)) {
+    return false;
+  }
+  int c;
+  while ((c = file.read()) != -1) {
+    offset++;
+    if (c == '\n') {
+      break;
+    }
+  }
+  return true;
+}
+
+// Remove file system header of filename and return stream type
+static uint8_t streamType(String &filename) {
+  // TODO UD = USB DISK
+#if defined(SD_DEVICE)
+  if (filename.startsWith(ESP_SD_FS_HEADER)) {
+    filename = filename.substring(strlen(ESP_SD_FS_HEADER), filename.length());
+    return TYPE_SD_STREAM;
+  }
+#endif  // SD_DEVICE
+#if defined(FILESYSTEM_FEATURE)
+  if (filename.startsWith(ESP_FLASH_FS_HEADER)) {
+    filename =
+        filename.substring(strlen(ESP_FLASH_FS_HEADER), filename.length());
+  }
+  // if no header it is also an FS file
+  return TYPE_FS_STREAM;
+#endif  // FILESYSTEM_FEATURE
+  // it is not a file so it is a script
+  return TYPE_SCRIPT_STREAM;
+}
+
 GcodeHost esp3d_gcode_host;
 
 GcodeHost::GcodeHost() { end(); }
@@ -47,7 +89,7 @@ bool GcodeHost::begin() {
   return true;
 }
 
-bool GcodeHost::dispatch(ESP3DMessage* message) { 
+bool GcodeHost::dispatch(ESP3DMessage* message) {
   if (!message || _step == HOST_NO_STREAM) {
     return false;
   }
@@ -57,7 +99,7 @@ bool GcodeHost::dispatch(ESP3DMessage* message) {
     return true;
   }
   return false;
- }
+}
 
 void GcodeHost::end() {
   _commandNumber = 0;
@@ -67,6 +109,32 @@ void GcodeHost::end() {
   _bufferSize = 0;
   _totalSize = 0;
   _processedSize = 0;
+  _startOffset = 0;
+  _fileSlot = 0;
+  _needRelease = false;
+#if defined(PRINT_QUEUE_FEATURE)
+  _jobId = 0;
+  _prefetchId = 0;
+  _prefetchType = TYPE_SCRIPT_STREAM;
+  _prefetched = false;
+  _prefetchSize = 0;
+  _prefetchLease = false;
+  _readAheadSize = 0;
+  _readAheadPos = 0;
+#endif  // PRINT_QUEUE_FEATURE
+#if defined(GCODE_INDEX_FEATURE)
+  _startLayer = -1;
+  _index.clear();
+#endif  // GCODE_INDEX_FEATURE
+#if defined(PRINT_JOURNAL_FEATURE)
+  _recoverSize = 0;
+  _prologue = "";
+  _lineNumber = 0;
+#endif  // PRINT_JOURNAL_FEATURE
+  _scriptId = 0;
+  _currentScriptId = 0;
+  _scriptsDone = 0;
+  _scriptError = ERROR_NO_ERROR;
 #if defined(AUTHENTICATION_FEATURE)
   _auth = ESP3DAuthenticationLevel::guest;
 #else
@@ -129,6 +197,9 @@ void GcodeHost::flush() {
     // like if numbering is enabled
     if (_step == HOST_WAIT4_ACK) {
       _step = HOST_READ_LINE;
+#if defined(PRINT_JOURNAL_FEATURE)
+      _journal.acked(_processedSize, _lineNumber, _commandNumber);
+#endif  // PRINT_JOURNAL_FEATURE
     } else {
       esp3d_log("Got ok but out of the query");
     }
@@ -144,17 +215,39 @@ void GcodeHost::flush() {
 }
 
 void GcodeHost::startStream() {
+  bool prefetched = false;
+#if defined(PRINT_QUEUE_FEATURE)
+  if (_prefetchId != 0 && _fsType != TYPE_SCRIPT_STREAM) {
+    if (_prefetched && _prefetchId == _jobId) {
+      // job was opened while previous one was ending
+      _fileSlot ^= 1;
+      _readAheadSize = _prefetchSize;
+      _readAheadPos = 0;
+      _prefetchId = 0;
+      _prefetched = false;
+      _prefetchLease = false;
+      prefetched = true;
+      esp3d_log("Job %d was opened ahead", _jobId);
+    } else {
+      dropPrefetch();
+    }
+  }
+  if (!prefetched) {
+    _readAheadSize = 0;
+    _readAheadPos = 0;
+  }
+#endif  // PRINT_QUEUE_FEATURE
   if (_fsType == TYPE_SCRIPT_STREAM) {
     _totalSize = _script.length();
     esp3d_log("Script line %s opened, size is %d", _script.c_str(), _totalSize);
   }
 #if defined(FILESYSTEM_FEATURE)
   if (_fsType == TYPE_FS_STREAM) {
-    if (ESP_FileSystem::exists(_fileName.c_str())) {
-      FSfileHandle = ESP_FileSystem::open(_fileName.c_str());
+    if (!prefetched && ESP_FileSystem::exists(_fileName.c_str())) {
+      FSfileHandle[_fileSlot] = ESP_FileSystem::open(_fileName.c_str());
     }
-    if (FSfileHandle.isOpen()) {
-      _totalSize = FSfileHandle.size();
+    if (FSfileHandle[_fileSlot].isOpen()) {
+      _totalSize = FSfileHandle[_fileSlot].size();
       esp3d_log("File %s opened, size is %d", _fileName.c_str(), _totalSize);
     } else {
       _error = ERROR_FILE_NOT_FOUND;
@@ -166,27 +259,32 @@ void GcodeHost::startStream() {
 #endif  // FILESYSTEM_FEATURE
 #if defined(SD_DEVICE)
   if (_fsType == TYPE_SD_STREAM) {
-    if (!ESP_SD::accessFS()) {
-      _error = ERROR_FILE_NOT_FOUND;
-      _step = HOST_ERROR_STREAM;
-      _needRelease = false;
-      esp3d_log_e("File not found: %s", _fileName.c_str());
-      return;
-    }
-    _needRelease = true;
-    if (ESP_SD::getState(true) == ESP_SDCARD_NOT_PRESENT) {
-      _error = ERROR_FILE_NOT_FOUND;
-      _step = HOST_ERROR_STREAM;
-      esp3d_log_e("File not found: %s", _fileName.c_str());
-      return;
-    }
-    ESP_SD::setState(ESP_SDCARD_BUSY);
+    if (prefetched) {
+      // SD was accessed when job was opened ahead
+      _needRelease = true;
+    } else {
+      if (!ESP_SD::accessFS()) {
+        _error = ERROR_FILE_NOT_FOUND;
+        _step = HOST_ERROR_STREAM;
+        _needRelease = false;
+        esp3d_log_e("File not found: %s", _fileName.c_str());
+        return;
+      }
+      _needRelease = true;
+      if (ESP_SD::getState(true) == ESP_SDCARD_NOT_PRESENT) {
+        _error = ERROR_FILE_NOT_FOUND;
+        _step = HOST_ERROR_STREAM;
+        esp3d_log_e("File not found: %s", _fileName.c_str());
+        return;
+      }
+      ESP_SD::setState(ESP_SDCARD_BUSY);
 
-    if (ESP_SD::exists(_fileName.c_str())) {
-      SDfileHandle = ESP_SD::open(_fileName.c_str());
+      if (ESP_SD::exists(_fileName.c_str())) {
+        SDfileHandle[_fileSlot] = ESP_SD::open(_fileName.c_str());
+      }
     }
-    if (SDfileHandle.isOpen()) {
-      _totalSize = SDfileHandle.size();
+    if (SDfileHandle[_fileSlot].isOpen()) {
+      _totalSize = SDfileHandle[_fileSlot].size();
       esp3d_log("File %s opened, size is %d", _fileName.c_str(), _totalSize);
     } else {
       _error = ERROR_FILE_NOT_FOUND;
@@ -203,38 +301,439 @@ void GcodeHost::startStream() {
   _step = HOST_READ_LINE;
   _nextStep = HOST_READ_LINE;
   _processedSize = 0;
+#if defined(PRINT_JOURNAL_FEATURE)
+  _lineNumber = 0;
+#endif  // PRINT_JOURNAL_FEATURE
+#if defined(GCODE_INDEX_FEATURE)
+  loadIndex();
+#endif  // GCODE_INDEX_FEATURE
+  if (!seekStart()) {
+    return;
+  }
+#if defined(PRINT_JOURNAL_FEATURE)
+  if (!startJournal()) {
+    return;
+  }
+#endif  // PRINT_JOURNAL_FEATURE
+#if defined(GCODE_MINIFIER_FEATURE)
+  uint8_t minifierOptions = 0;
+  uint8_t firmware = ESP3DSettings::GetFirmwareTarget();
+  if (firmware == GRBL || firmware == GRBLHAL || firmware == REPRAP) {
+    minifierOptions |= ESP3D_MINIFY_PAREN_COMMENTS;
+  }
+#if defined(GCODE_MINIFIER_MODAL_MOTION)
+  if (firmware == GRBL || firmware == GRBLHAL) {
+    minifierOptions |= ESP3D_MINIFY_MODAL_MOTION;
+  }
+#endif  // GCODE_MINIFIER_MODAL_MOTION
+  _minifier.setOptions(minifierOptions);
+  _minifier.reset();
+#endif  // GCODE_MINIFIER_FEATURE
+#if defined(MEATPACK_FEATURE)
+  // files are worth packing, scripts are too short
+  if (_fsType != TYPE_SCRIPT_STREAM) {
+    esp3d_meatpack.begin();
+  }
+#endif  // MEATPACK_FEATURE
+}
+
+bool GcodeHost::seekStart() {
+  uint32_t offset = _startOffset;
+#if defined(GCODE_INDEX_FEATURE)
+  if (_startLayer >= 0) {
+    int32_t index = _index.findLayer(_startLayer);
+    if (index < 0) {
+      esp3d_log_e("No index to start at layer %d", _startLayer);
+      _error = ERROR_NO_INDEX;
+      _step = HOST_ERROR_STREAM;
+      return false;
+    }
+    offset = _index.entry(index)->offset;
+#if defined(PRINT_JOURNAL_FEATURE)
+    _lineNumber = _index.entry(index)->line;
+#endif  // PRINT_JOURNAL_FEATURE
+    esp3d_log("Layer %d starts at %d", _index.entry(index)->layer, offset);
+  }
+#endif  // GCODE_INDEX_FEATURE
+  if (offset == 0 || _fsType == TYPE_SCRIPT_STREAM) {
+    return true;
+  }
+#if defined(PRINT_QUEUE_FEATURE)
+  // bytes read ahead are not the ones at offset
+  _readAheadSize = 0;
+  _readAheadPos = 0;
+#endif  // PRINT_QUEUE_FEATURE
+  bool res = false;
+  if (offset < _totalSize) {
+#if defined(FILESYSTEM_FEATURE)
+    if (_fsType == TYPE_FS_STREAM) {
+      res = seekLine(FSfileHandle[_fileSlot], offset);
+    }
+#endif  // FILESYSTEM_FEATURE
+#if defined(SD_DEVICE)
+    if (_fsType == TYPE_SD_STREAM) {
+      res = seekLine(SDfileHandle[_fileSlot], offset);
+    }
+#endif  // SD_DEVICE
+  }
+  if (!res) {
+    esp3d_log_e("Cannot start at %d", offset);
+    _error = ERROR_FILE_SYSTEM;
+    _step = HOST_ERROR_STREAM;
+    return false;
+  }
+  esp3d_log("Stream starts at %d", offset);
+  _processedSize = offset;
+  _currentPosition = offset;
+  return true;
+}
+
+#if defined(PRINT_JOURNAL_FEATURE)
+bool GcodeHost::startJournal() {
+  if (_fsType == TYPE_SCRIPT_STREAM) {
+    return true;
+  }
+  ESP3DPrintJournalRecord state;
+  memset(&state, 0, sizeof(state));
+  if (_recoverSize != 0) {
+    if (_recoverSize != _totalSize) {
+      esp3d_log_e("%s changed since journal was written", _fileName.c_str());
+      _error = ERROR_JOURNAL_MISMATCH;
+      _step = HOST_ERROR_STREAM;
+      return false;
+    }
+    state = _recoverState;
+    _lineNumber = _recoverState.line;
+  }
+  state.offset = _processedSize;
+  state.line = _lineNumber;
+  state.commandNumber = _commandNumber;
+  if (!_journal.begin(_fsType, _fileName.c_str(), _totalSize, state)) {
+    esp3d_log_e("No journal for %s", _fileName.c_str());
+  }
+  return true;
 }
 
+bool GcodeHost::recover(ESP3DAuthenticationLevel auth_type) {
+  ESP3DPrintJournalHeader header;
+  if (_step != HOST_NO_STREAM ||
+      !ESP3DPrintJournal::read(header, _recoverState)) {
+    return false;
+  }
+  uint8_t firmware = ESP3DSettings::GetFirmwareTarget();
+  bool isCNC = (firmware == GRBL || firmware == GRBLHAL);
+  // printer position is restored, file must have set it before last record
+  uint8_t modes = _recoverState.modes;
+  uint8_t needed = 0;
+  if (!isCNC) {
+    needed = ESP3D_JOURNAL_Z_KNOWN;
+    // relative extrusion does not need E position
+    if (!(modes & ESP3D_JOURNAL_RELATIVE_E)) {
+      needed |= ESP3D_JOURNAL_E_KNOWN;
+    }
+  }
+  if ((modes & needed) != needed) {
+    esp3d_log_e("Printer position of journal is unknown: %d", modes);
+    return false;
+  }
+  String filename;
+#if defined(SD_DEVICE)
+  if (header.fsType == TYPE_SD_STREAM) {
+    filename = ESP_SD_FS_HEADER;
+  }
+#endif  // SD_DEVICE
+  if (header.fsType == TYPE_FS_STREAM) {
+    filename = ESP_FLASH_FS_HEADER;
+  }
+  if (filename.length() == 0) {
+    esp3d_log_e("Journal file system %d not available", header.fsType);
+    return false;
+  }
+  filename += header.fileName;
+  if (!processFileFrom(filename.c_str(), _recoverState.offset, -1,
+                       auth_type)) {
+    return false;
+  }
+  esp3d_log("Recovering %s at %d", filename.c_str(), _recoverState.offset);
+  _recoverSize = header.fileSize;
+  _commandNumber = _recoverState.commandNumber;
+  // printer may have cooled down meanwhile
+  _prologue = "";
+  if (!isCNC) {
+    if (_recoverState.bedTemperature > 0) {
+      _prologue += "M140 S" + String(_recoverState.bedTemperature, 1) + "\n";
+    }
+    if (_recoverState.hotendTemperature > 0) {
+      _prologue +=
+          "M104 S" + String(_recoverState.hotendTemperature, 1) + "\n";
+    }
+    if (_recoverState.bedTemperature > 0) {
+      _prologue += "M190 S" + String(_recoverState.bedTemperature, 1) + "\n";
+    }
+    if (_recoverState.hotendTemperature > 0) {
+      _prologue +=
+          "M109 S" + String(_recoverState.hotendTemperature, 1) + "\n";
+    }
+    // Z cannot be homed with the print on the bed: printer is told where Z
+    // is, X and Y are homed, then nozzle goes back to Z if homing raised it
+    String z = String(_recoverState.z, 3);
+    _prologue += "G92 Z" + z + "\n";
+    _prologue += "G28 X Y\n";
+    _prologue += "G90\n";
+    _prologue += "G1 Z" + z + "\n";
+    if (modes & ESP3D_JOURNAL_E_KNOWN) {
+      _prologue += "G92 E" + String(_recoverState.e, 5) + "\n";
+    }
+  }
+  // G90/G91 also set E mode, so M82/M83 comes after
+  _prologue += (modes & ESP3D_JOURNAL_RELATIVE_XYZ) ? "G91\n" : "G90\n";
+  if (!isCNC) {
+    _prologue += (modes & ESP3D_JOURNAL_RELATIVE_E) ? "M83\n" : "M82\n";
+  }
+  if (_recoverState.feedrate > 0) {
+    _prologue += isCNC ? "F" : "G1 F";
+    _prologue += String(_recoverState.feedrate, 0) + "\n";
+  }
+  return true;
+}
+#endif  // PRINT_JOURNAL_FEATURE
+
+#if defined(PRINT_QUEUE_FEATURE)
+uint32_t GcodeHost::queueFile(const char *filename,
+                              ESP3DAuthenticationLevel auth_type,
+                              uint8_t priority) {
+  String name = filename[0] != '/' ? "/" : "";
+  name += filename;
+  name.trim();
+  String path = name;
+  if (name.length() < 2 || streamType(path) == TYPE_SCRIPT_STREAM) {
+    esp3d_log_e("Cannot queue %s", name.c_str());
+    return 0;
+  }
+  return _queue.add(name.c_str(), auth_type, priority);
+}
+
+void GcodeHost::pauseQueue() {
+  _queue.setPaused(true);
+  dropPrefetch();
+}
+
+bool GcodeHost::startJob() {
+  if (_step != HOST_NO_STREAM || _queue.isPaused()) {
+    return false;
+  }
+  ESP3DPrintJob job;
+  if (!_queue.pop(job)) {
+    return false;
+  }
+  esp3d_log("Starting job %d: %s", job.id, job.fileName);
+  if (!processFile(job.fileName,
+                   static_cast<ESP3DAuthenticationLevel>(job.auth))) {
+    esp3d_log_e("Cannot start job %d", job.id);
+    return false;
+  }
+  _jobId = job.id;
+  return true;
+}
+
+void GcodeHost::prefetchJob() {
+  ESP3DPrintJob next;
+  bool hasNext = _queue.first(next);
+  if (_prefetchId != 0 &&
+      (!hasNext || next.id != _prefetchId || _queue.isPaused())) {
+    esp3d_log("Job %d is no more next one", _prefetchId);
+    dropPrefetch();
+  }
+  // waiting for ack is the idle time of stream, and current file must have
+  // used its own bytes read ahead as buffer is shared
+  if (!hasNext || _prefetchId != 0 || _queue.isPaused() ||
+      _step != HOST_WAIT4_ACK || _fsType == TYPE_SCRIPT_STREAM ||
+      _processedSize + ESP3D_PRINT_QUEUE_PREFETCH_DISTANCE < _totalSize ||
+      _readAheadPos < _readAheadSize) {
+    return;
+  }
+  // job is not tried again if it cannot be opened, start will report error
+  _prefetchId = next.id;
+  String filename = next.fileName;
+  _prefetchType = streamType(filename);
+  uint8_t slot = _fileSlot ^ 1;
+#if defined(FILESYSTEM_FEATURE)
+  if (_prefetchType == TYPE_FS_STREAM) {
+    if (ESP_FileSystem::exists(filename.c_str())) {
+      FSfileHandle[slot] = ESP_FileSystem::open(filename.c_str());
+    }
+    if (FSfileHandle[slot].isOpen()) {
+      _prefetchSize = FSfileHandle[slot].read(_readAhead, sizeof(_readAhead));
+      _prefetched = true;
+    }
+  }
+#endif  // FILESYSTEM_FEATURE
+#if defined(SD_DEVICE)
+  if (_prefetchType == TYPE_SD_STREAM) {
+    // SD stream already has the access
+    if (_fsType != TYPE_SD_STREAM) {
+      if (!ESP_SD::accessFS()) {
+        esp3d_log_e("No SD access for job %d", _prefetchId);
+        return;
+      }
+      _prefetchLease = true;
+    }
+    if (ESP_SD::exists(filename.c_str())) {
+      SDfileHandle[slot] = ESP_SD::open(filename.c_str());
+    }
+    if (SDfileHandle[slot].isOpen()) {
+      _prefetchSize = SDfileHandle[slot].read(_readAhead, sizeof(_readAhead));
+      _prefetched = true;
+    } else if (_prefetchLease) {
+      ESP_SD::releaseFS();
+      _prefetchLease = false;
+    }
+  }
+#endif  // SD_DEVICE
+  esp3d_log("Job %d opened ahead: %s", _prefetchId,
+            _prefetched ? "ok" : "failed");
+}
+
+void GcodeHost::dropPrefetch() {
+  uint8_t slot = _fileSlot ^ 1;
+#if defined(FILESYSTEM_FEATURE)
+  if (FSfileHandle[slot].isOpen()) {
+    FSfileHandle[slot].close();
+  }
+#endif  // FILESYSTEM_FEATURE
+#if defined(SD_DEVICE)
+  if (SDfileHandle[slot].isOpen()) {
+    SDfileHandle[slot].close();
+  }
+  if (_prefetchLease) {
+    ESP_SD::releaseFS();
+  }
+#endif  // SD_DEVICE
+  _prefetchLease = false;
+  _prefetched = false;
+  _prefetchSize = 0;
+  _prefetchId = 0;
+}
+#endif  // PRINT_QUEUE_FEATURE
+
+#if defined(GCODE_INDEX_FEATURE)
+void GcodeHost::loadIndex() {
+  _index.clear();
+#if defined(FILESYSTEM_FEATURE)
+  if (_fsType == TYPE_FS_STREAM) {
+    _index.loadFor<ESP_FileSystem>(_fileName.c_str(), _totalSize,
+                                   FSfileHandle[_fileSlot].getLastWrite());
+  }
+#endif  // FILESYSTEM_FEATURE
+#if defined(SD_DEVICE)
+  if (_fsType == TYPE_SD_STREAM) {
+    _index.loadFor<ESP_SD>(_fileName.c_str(), _totalSize,
+                           SDfileHandle[_fileSlot].getLastWrite());
+  }
+#endif  // SD_DEVICE
+  esp3d_log("Index of %s: %d layers", _fileName.c_str(), _index.layers());
+}
+
+uint32_t GcodeHost::currentLayer() {
+  const ESP3DGcodeLayer *entry =
+      _index.entry(_index.findOffset(_processedSize));
+  return entry ? entry->layer : 0;
+}
+
+float GcodeHost::currentZ() {
+  const ESP3DGcodeLayer *entry =
+      _index.entry(_index.findOffset(_processedSize));
+  return entry ? entry->z : 0;
+}
+
+uint32_t GcodeHost::remainingTime() {
+  uint32_t elapsed = elapsedTime();
+  return totalTime() > elapsed ? totalTime() - elapsed : 0;
+}
+#endif  // GCODE_INDEX_FEATURE
+
 void GcodeHost::endStream() {
   esp3d_log("Ending Stream");
+#if defined(MEATPACK_FEATURE)
+  esp3d_meatpack.end();
+#endif  // MEATPACK_FEATURE
 #if defined(FILESYSTEM_FEATURE)
   if (_fsType == TYPE_FS_STREAM) {
-    if (FSfileHandle.isOpen()) {
-      FSfileHandle.close();
+    if (FSfileHandle[_fileSlot].isOpen()) {
+      FSfileHandle[_fileSlot].close();
     }
   }
 #endif  // FILESYSTEM_FEATURE
 #if defined(SD_DEVICE)
   if (_fsType == TYPE_SD_STREAM) {
-    if (SDfileHandle.isOpen()) {
-      SDfileHandle.close();
+    if (SDfileHandle[_fileSlot].isOpen()) {
+      SDfileHandle[_fileSlot].close();
+    }
+    bool release = _needRelease;
+#if defined(PRINT_QUEUE_FEATURE)
+    if (release && _prefetched && _prefetchType == TYPE_SD_STREAM) {
+      // next job is already opened on SD, it keeps the access
+      _prefetchLease = true;
+      release = false;
     }
-    if (_needRelease) {
+#endif  // PRINT_QUEUE_FEATURE
+    if (release) {
       ESP_SD::releaseFS();
     }
+    _needRelease = false;
   }
 #endif  // SD_DEVICE
+#if defined(GCODE_INDEX_FEATURE)
+  _index.clear();
+#endif  // GCODE_INDEX_FEATURE
+#if defined(PRINT_JOURNAL_FEATURE)
+  // failed job is kept to be recovered
+  _journal.end(_error != ERROR_NO_ERROR && _error != ERROR_STREAM_ABORTED);
+  _recoverSize = 0;
+  _prologue = "";
+#endif  // PRINT_JOURNAL_FEATURE
+  if (_fsType == TYPE_SCRIPT_STREAM) {
+    _scriptsDone = _currentScriptId;
+    _scriptError = _error;
+  }
+#if defined(PRINT_QUEUE_FEATURE)
+  if (_fsType != TYPE_SCRIPT_STREAM && _error != ERROR_NO_ERROR &&
+      _queue.count() > 0) {
+    // printer state is unknown after a failed or aborted file
+    esp3d_log("Print queue paused");
+    pauseQueue();
+  }
+  _jobId = 0;
+#endif  // PRINT_QUEUE_FEATURE
   _step = HOST_NO_STREAM;
-  if (!_scriptList.isEmpty()){
+  while (_step == HOST_NO_STREAM && !_scriptList.isEmpty()) {
     ScriptEntry scr = _scriptList.pop();
-    processScript(scr.script.c_str(),scr.auth_type);
+    if (!startScript(scr.script.c_str(), scr.auth_type, scr.id)) {
+      // nothing to wait for
+      _scriptsDone = scr.id;
+    }
+  }
+#if defined(PRINT_QUEUE_FEATURE)
+  // file opened ahead starts in same loop
+  if (startJob()) {
+    startStream();
   }
-  //TODO: do same for files
+#endif  // PRINT_QUEUE_FEATURE
 }
 
 void GcodeHost::readNextCommand() {
   _currentCommand = "";
   _step = HOST_PROCESS_LINE;
+#if defined(PRINT_JOURNAL_FEATURE)
+  if (_prologue.length() > 0) {
+    int pos = _prologue.indexOf('\n');
+    _currentCommand = _prologue.substring(0, pos);
+    _prologue.remove(0, pos + 1);
+    esp3d_log("Recovery command is %s", _currentCommand.c_str());
+    return;
+  }
+  size_t previousSize = _processedSize;
+#endif  // PRINT_JOURNAL_FEATURE
   if (_fsType == TYPE_SCRIPT_STREAM) {
     esp3d_log("Reading next command from script");
     if (_currentPosition < _script.length()) {
@@ -252,12 +751,11 @@ void GcodeHost::readNextCommand() {
       _step = HOST_STOP_STREAM;
     }
   }
-#if defined(FILESYSTEM_FEATURE)
-  if (_fsType == TYPE_FS_STREAM) {
+  if (_fsType != TYPE_SCRIPT_STREAM) {
     bool processing = true;
     while (processing) {
       // to handle file without endline
-      int c = FSfileHandle.read();
+      int c = readByte();
       if (c == -1) {
         processing = false;
       } else {
@@ -271,41 +769,56 @@ void GcodeHost::readNextCommand() {
       }
     }
     if (_currentCommand.length() == 0) {
-      if (FSfileHandle.available()) {
+      if (hasData()) {
         _step = HOST_READ_LINE;
       } else {
         _step = HOST_STOP_STREAM;
       }
     }
   }
+#if defined(PRINT_JOURNAL_FEATURE)
+  if (_fsType != TYPE_SCRIPT_STREAM && _processedSize != previousSize) {
+    _lineNumber++;
+  }
+#endif  // PRINT_JOURNAL_FEATURE
+}
+
+int GcodeHost::readByte() {
+#if defined(PRINT_QUEUE_FEATURE)
+  if (_readAheadPos < _readAheadSize) {
+    return _readAhead[_readAheadPos++];
+  }
+#endif  // PRINT_QUEUE_FEATURE
+#if defined(FILESYSTEM_FEATURE)
+  if (_fsType == TYPE_FS_STREAM) {
+    return FSfileHandle[_fileSlot].read();
+  }
 #endif  // FILESYSTEM_FEATURE
 #if defined(SD_DEVICE)
   if (_fsType == TYPE_SD_STREAM) {
-    bool processing = true;
-    while (processing) {
-      // to handle file without endline
-      int c = SDfileHandle.read();
-      if (c == -1) {
-        processing = false;
-      } else {
-        _processedSize++;
-        _currentPosition++;
-        if (!(char)c == '\n' ) {
-          _currentCommand += (char)c;
-        } else {
-          processing = false;
-        }
-      }
-    }
-    if (_currentCommand.length() == 0) {
-      if (SDfileHandle.available()) {
-        _step = HOST_READ_LINE;
-      } else {
-        _step = HOST_STOP_STREAM;
-      }
-    }
+    return SDfileHandle[_fileSlot].read();
+  }
+#endif  // SD_DEVICE
+  return -1;
+}
+
+bool GcodeHost::hasData() {
+#if defined(PRINT_QUEUE_FEATURE)
+  if (_readAheadPos < _readAheadSize) {
+    return true;
+  }
+#endif  // PRINT_QUEUE_FEATURE
+#if defined(FILESYSTEM_FEATURE)
+  if (_fsType == TYPE_FS_STREAM) {
+    return FSfileHandle[_fileSlot].available() > 0;
+  }
+#endif  // FILESYSTEM_FEATURE
+#if defined(SD_DEVICE)
+  if (_fsType == TYPE_SD_STREAM) {
+    return SDfileHandle[_fileSlot].available() > 0;
   }
 #endif  // SD_DEVICE
+  return false;
 }
 
 bool GcodeHost::isCommand() {
@@ -350,6 +863,21 @@ void GcodeHost::processCommand() {
       }
 
     } else {
+#if defined(PRINT_JOURNAL_FEATURE)
+      // before minifier, which may drop modal G0/G1
+      _journal.track(_currentCommand.c_str());
+#endif  // PRINT_JOURNAL_FEATURE
+#if defined(GCODE_MINIFIER_FEATURE)
+      size_t size = _minifier.minify(_currentCommand.begin(),
+                                     _currentCommand.length());
+      if (size == 0) {
+        // only comments
+        _step = HOST_READ_LINE;
+        return;
+      }
+      _currentCommand.remove(size);
+      _currentCommand += "\n";
+#endif  // GCODE_MINIFIER_FEATURE
       ESP3DMessage *msg = esp3d_message_manager.newMsg(
           ESP3DClientType::stream, esp3d_commands.getOutputClient(),
           (uint8_t *)_currentCommand.c_str(), _currentCommand.length(), _auth);
@@ -373,14 +901,27 @@ void GcodeHost::processCommand() {
 }
 
 void GcodeHost::handle() {
+#if defined(PRINT_QUEUE_FEATURE)
+  prefetchJob();
+  startJob();
+#endif  // PRINT_QUEUE_FEATURE
   if (_step == HOST_NO_STREAM) {
     return;
   }
+#if defined(MEATPACK_FEATURE)
+  esp3d_meatpack.handle();
+#endif  // MEATPACK_FEATURE
   switch (_step) {
     case HOST_START_STREAM:
       startStream();
       break;
     case HOST_READ_LINE:
+#if defined(MEATPACK_FEATURE)
+      // wait printer answer before sending anything
+      if (esp3d_meatpack.isNegotiating()) {
+        break;
+      }
+#endif  // MEATPACK_FEATURE
       if (_nextStep == HOST_PAUSE_STREAM) {
         _step = HOST_PAUSE_STREAM;
         _nextStep = HOST_READ_LINE;
@@ -512,12 +1053,22 @@ uint32_t GcodeHost::getCommandNumber(String &response) {
 
 bool GcodeHost::processScript(const char *line,
                               ESP3DAuthenticationLevel auth_type) {
+  _scriptId++;
   if (_step != HOST_NO_STREAM) {
       esp3d_log("Streaming already in progress, put to queue");
       String s = line;
-      _scriptList.push(line, auth_type);
+      _scriptList.push(line, auth_type, _scriptId);
       return true;
   }
+  if (!startScript(line, auth_type, _scriptId)) {
+    _scriptsDone = _scriptId;
+    return false;
+  }
+  return true;
+}
+
+bool GcodeHost::startScript(const char *line,
+                            ESP3DAuthenticationLevel auth_type, uint32_t id) {
   _script = line;
   _script.trim();
   esp3d_log("Processing script: %s", _script.c_str());
@@ -528,13 +1079,13 @@ bool GcodeHost::processScript(const char *line,
 
   _fsType = TYPE_SCRIPT_STREAM;
   _step = HOST_START_STREAM;
-  _auth_type = auth_type;
+  _auth = auth_type;
+  _currentScriptId = id;
   return true;
 }
 
 bool GcodeHost::processFile(const char *filename,
                             ESP3DAuthenticationLevel auth_type) {
-  bool target_found = false;
   // sanity check
   _fileName = filename[0] != '/' ? "/" : "";
   _fileName += filename;
@@ -548,42 +1099,42 @@ bool GcodeHost::processFile(const char *filename,
     esp3d_log_e("Streaming already in progress");
     return false;
   }
-  // TODO UD = USB DISK
-#if defined(SD_DEVICE)
-  if (_fileName.startsWith(ESP_SD_FS_HEADER)) {
-    esp3d_log("Processing SD file");
-    target_found = true;
-    _fileName =
-        _fileName.substring(strlen(ESP_SD_FS_HEADER), _fileName.length());
-    _fsType = TYPE_SD_STREAM;
-  }
-#endif  // SD_DEVICE
-#if defined(FILESYSTEM_FEATURE)
-  if (!target_found && _fileName.startsWith(ESP_FLASH_FS_HEADER)) {
-    target_found = true;
-    _fileName =
-        _fileName.substring(strlen(ESP_FLASH_FS_HEADER), _fileName.length());
-    esp3d_log("Processing /FS file %s", _fileName.c_str());
-    _fsType = TYPE_FS_STREAM;
-  }
-  // if no header it is also an FS file
-  if (!target_found) {
-    esp3d_log("Processing FS file %s", _fileName.c_str());
-    _fsType = TYPE_FS_STREAM;
-    target_found = true;
-  }
-#endif  // FILESYSTEM_FEATURE
-  // it is not a file so it is a script
-  if (!target_found) {
-    target_found = true;
-    _fsType = TYPE_SCRIPT_STREAM;
+  _startOffset = 0;
+#if defined(GCODE_INDEX_FEATURE)
+  _startLayer = -1;
+#endif  // GCODE_INDEX_FEATURE
+#if defined(PRINT_QUEUE_FEATURE)
+  _jobId = 0;
+#endif  // PRINT_QUEUE_FEATURE
+  _fsType = streamType(_fileName);
+  esp3d_log("Processing file %s of type %d", _fileName.c_str(), _fsType);
+  if (_fsType == TYPE_SCRIPT_STREAM) {
     // remove the /
     _script = &_fileName[1];
     esp3d_log("Processing Script file %s", _script.c_str());
     _fileName = "";
   }
   _step = HOST_START_STREAM;
-  _auth_type = auth_type;
+  _auth = auth_type;
+  return true;
+}
+
+bool GcodeHost::processFileFrom(const char *filename, uint32_t offset,
+                                int32_t layer,
+                                ESP3DAuthenticationLevel auth_type) {
+  if (!processFile(filename, auth_type)) {
+    return false;
+  }
+#if defined(GCODE_INDEX_FEATURE)
+  _startLayer = layer;
+#else
+  if (layer >= 0) {
+    esp3d_log_e("Starting at a layer needs GCODE_INDEX_FEATURE");
+    _step = HOST_NO_STREAM;
+    return false;
+  }
+#endif  // GCODE_INDEX_FEATURE
+  _startOffset = offset;
   return true;
 }
 
@@ -25,6 +25,18 @@
 #include "../../core/esp3d_message.h"
 #include "../authentication/authentication_service.h"
 #include "./gcode_script_fifo.h"
+#if defined(GCODE_MINIFIER_FEATURE)
+#include "./gcode_minifier.h"
+#endif  // GCODE_MINIFIER_FEATURE
+#if defined(GCODE_INDEX_FEATURE)
+#include "./gcode_index.h"
+#endif  // GCODE_INDEX_FEATURE
+#if defined(PRINT_JOURNAL_FEATURE)
+#include "./print_journal.h"
+#endif  // PRINT_JOURNAL_FEATURE
+#if defined(PRINT_QUEUE_FEATURE)
+#include "./print_queue.h"
+#endif  // PRINT_QUEUE_FEATURE
 
 #define ERROR_NO_ERROR 0
 #define ERROR_TIME_OUT 1
@@ -40,6 +52,8 @@
 #define ERROR_UNKNOW 11
 #define ERROR_FILE_NOT_FOUND 12
 #define ERROR_STREAM_ABORTED 13
+#define ERROR_NO_INDEX 14
+#define ERROR_JOURNAL_MISMATCH 15
 
 #define HOST_NO_STREAM 100
 #define HOST_START_STREAM 101
@@ -101,6 +115,49 @@ class GcodeHost {
                                            ESP3DAuthenticationLevel::admin);
   bool processFile(const char* filename, ESP3DAuthenticationLevel auth_type =
                                              ESP3DAuthenticationLevel::admin);
+  // Start file at offset, or at layer if layer >= 0 (needs file index)
+  // Offset which is not a line start goes to next line
+  bool processFileFrom(const char* filename, uint32_t offset, int32_t layer,
+                       ESP3DAuthenticationLevel auth_type =
+                           ESP3DAuthenticationLevel::admin);
+#if defined(GCODE_INDEX_FEATURE)
+  // Stream file has an up to date index
+  bool hasIndex() { return _index.isValid(_totalSize); }
+  uint32_t layersCount() { return _index.layers(); }
+  uint32_t currentLayer();
+  float currentZ();
+  // Slicer estimations (s)
+  uint32_t totalTime() { return _index.totalTime(); }
+  uint32_t elapsedTime() { return _index.elapsedTime(_processedSize); }
+  uint32_t remainingTime();
+#endif  // GCODE_INDEX_FEATURE
+#if defined(PRINT_JOURNAL_FEATURE)
+  // Resume job of journal from its last record, temperatures, position
+  // (X/Y homed, Z and E set), modes and feedrate are restored first, false
+  // if file did not set Z and E before last record
+  bool recover(ESP3DAuthenticationLevel auth_type =
+                   ESP3DAuthenticationLevel::admin);
+#endif  // PRINT_JOURNAL_FEATURE
+#if defined(PRINT_QUEUE_FEATURE)
+  // Files waiting to be printed, next one is started when stream is done
+  ESP3DPrintQueue& queue() { return _queue; }
+  // Id of queued job being printed, 0 if stream is not a queued job
+  uint32_t currentJobId() { return _jobId; }
+  // Queue file to print after current stream, return job id or 0
+  uint32_t queueFile(const char* filename, ESP3DAuthenticationLevel auth_type,
+                     uint8_t priority = 0);
+  // Stop queue and drop job opened ahead
+  void pauseQueue();
+#endif  // PRINT_QUEUE_FEATURE
+  // Scripts are numbered in processing order, a script is done when its
+  // number is at or below scriptsDone()
+  uint32_t lastScriptId() { return _scriptId; }
+  uint32_t scriptsDone() { return _scriptsDone; }
+  bool isScriptDone(uint32_t id) { return (int32_t)(_scriptsDone - id) >= 0; }
+  // Error of last script done
+  uint8_t scriptError() { return _scriptError; }
+  // Next script would push out oldest queued one
+  bool isScriptQueueFull() { return _scriptList.isFull(); }
   bool abort();
   bool pause();
   bool resume();
@@ -113,7 +170,60 @@ class GcodeHost {
   bool isAck(String& line);
 
  private:
+  bool seekStart();
+  // Read from file being streamed, -1 at end of file
+  int readByte();
+  bool hasData();
+#if defined(PRINT_QUEUE_FEATURE)
+  // Start next queued job if host is idle
+  bool startJob();
+  // Open next queued job in free slot and read its first bytes
+  void prefetchJob();
+  void dropPrefetch();
+  ESP3DPrintQueue _queue;
+  uint32_t _jobId;
+  // Job opened ahead in slot _fileSlot ^ 1 (its first bytes are in
+  // _readAhead once stream has used its own ones), 0 if none
+  uint32_t _prefetchId;
+  uint8_t _prefetchType;
+  bool _prefetched;
+  uint16_t _prefetchSize;
+  // SD was accessed for prefetched job and must be released with it
+  bool _prefetchLease;
+  // Bytes read ahead at start of file, served before file content
+  uint8_t _readAhead[ESP3D_PRINT_QUEUE_PREFETCH_SIZE];
+  uint16_t _readAheadSize;
+  uint16_t _readAheadPos;
+#endif  // PRINT_QUEUE_FEATURE
+  // File handles slot of stream, other one is used to open next job
+  uint8_t _fileSlot;
+  bool startScript(const char* line, ESP3DAuthenticationLevel auth_type,
+                   uint32_t id);
+#if defined(GCODE_INDEX_FEATURE)
+  void loadIndex();
+  ESP3DGcodeIndex _index;
+  int32_t _startLayer;
+#endif  // GCODE_INDEX_FEATURE
+  uint32_t _startOffset;
+#if defined(PRINT_JOURNAL_FEATURE)
+  bool startJournal();
+  ESP3DPrintJournal _journal;
+  ESP3DPrintJournalRecord _recoverState;
+  // size of recovered file, 0 if not a recovery
+  uint32_t _recoverSize;
+  // commands sent before file when recovering
+  String _prologue;
+  // line of file to read next, counted from start point if it is unknown
+  uint32_t _lineNumber;
+#endif  // PRINT_JOURNAL_FEATURE
   ESP3DScriptFIFO _scriptList;
+  uint32_t _scriptId;
+  uint32_t _currentScriptId;
+  uint32_t _scriptsDone;
+  uint8_t _scriptError;
+#if defined(GCODE_MINIFIER_FEATURE)
+  ESP3DGcodeMinifier _minifier;
+#endif  // GCODE_MINIFIER_FEATURE
   ESP3DAuthenticationLevel _auth;
   uint8_t _buffer[ESP_HOST_BUFFER_SIZE + 1];
   size_t _bufferSize;
@@ -130,7 +240,6 @@ class GcodeHost {
   uint8_t _fsType;
   String _currentCommand;
   String _response;
-  ESP3DAuthenticationLevel _auth_type;
   uint64_t _startTimeOut;
   bool _needRelease;
 };
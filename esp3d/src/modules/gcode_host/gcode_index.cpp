@@ -0,0 +1,399 @@
+/*
+  gcode_index.cpp -  G-code layers index class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+// #define ESP_LOG_FEATURE LOG_OUTPUT_SERIAL0
+#include "../../include/esp3d_config.h"
+#if defined(GCODE_INDEX_FEATURE)
+#include <stdlib.h>
+#include <string.h>
+
+#include "gcode_index.h"
+
+// Layer markers, first one found is the only one used for the file
+#define MARKER_NONE 0
+#define MARKER_CURA 1
+#define MARKER_PRUSA 2
+#define MARKER_S3D 3
+
+static const char* gcodeExtensions[] = {".gcode", ".gco", ".g", ".gc"};
+
+static bool startsWith(const char* s, const char* prefix) {
+  return strncmp(s, prefix, strlen(prefix)) == 0;
+}
+
+static const char* skipSpaces(const char* s) {
+  while (*s == ' ' || *s == '\t') {
+    s++;
+  }
+  return s;
+}
+
+// "1d 2h 3m 4s" => seconds
+static uint32_t parseDuration(const char* s) {
+  uint32_t total = 0;
+  while (*s) {
+    s = skipSpaces(s);
+    char* end;
+    uint32_t value = strtoul(s, &end, 10);
+    if (end == s) {
+      break;
+    }
+    switch (*end) {
+      case 'd':
+        total += value * 86400;
+        break;
+      case 'h':
+        total += value * 3600;
+        break;
+      case 'm':
+        total += value * 60;
+        break;
+      case 's':
+        total += value;
+        break;
+      default:
+        return total;
+    }
+    s = end + 1;
+  }
+  return total;
+}
+
+// Value of word letter in command part of line, false if absent
+static bool getWord(const char* line, char letter, float& value) {
+  for (const char* p = line; *p && *p != ';'; p++) {
+    if (*p == letter || *p == letter + ('a' - 'A')) {
+      char* end;
+      value = strtof(p + 1, &end);
+      if (end != p + 1) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+ESP3DGcodeIndex::ESP3DGcodeIndex() {
+  _entries = nullptr;
+  clear();
+}
+
+ESP3DGcodeIndex::~ESP3DGcodeIndex() { clear(); }
+
+bool ESP3DGcodeIndex::isGcodeFile(const char* filename) {
+  String name = filename;
+  name.toLowerCase();
+  for (size_t i = 0; i < sizeof(gcodeExtensions) / sizeof(gcodeExtensions[0]);
+       i++) {
+    if (name.endsWith(gcodeExtensions[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+String ESP3DGcodeIndex::indexName(const char* filename) {
+  String name = filename;
+  name += ESP3D_GCODE_INDEX_EXTENSION;
+  return name;
+}
+
+bool ESP3DGcodeIndex::allocate(uint32_t count) {
+  if (count == 0) {
+    count = 1;
+  }
+  _entries = (ESP3DGcodeLayer*)malloc(count * sizeof(ESP3DGcodeLayer));
+  if (!_entries) {
+    esp3d_log_e("Cannot allocate index of %d layers", count);
+    return false;
+  }
+  return true;
+}
+
+void ESP3DGcodeIndex::clear() {
+  if (_entries) {
+    free(_entries);
+    _entries = nullptr;
+  }
+  _count = 0;
+  _stride = 1;
+  _fileSize = 0;
+  _fileTime = 0;
+  _lines = 0;
+  _layers = 0;
+  _totalTime = 0;
+  _elapsedTime = 0;
+  _firstRemaining = -1;
+  _marker = MARKER_NONE;
+  _zPending = false;
+  _lineSize = 0;
+  _lineStart = 0;
+}
+
+bool ESP3DGcodeIndex::begin() {
+  clear();
+  return allocate(ESP3D_GCODE_INDEX_MAX_LAYERS);
+}
+
+void ESP3DGcodeIndex::feed(const uint8_t* data, size_t size) {
+  if (!_entries) {
+    return;
+  }
+  for (size_t i = 0; i < size; i++) {
+    char c = (char)data[i];
+    _fileSize++;
+    if (c == '\n') {
+      _line[_lineSize] = 0;
+      parseLine();
+      _lines++;
+      _lineSize = 0;
+      _lineStart = _fileSize;
+    } else if (c != '\r' && _lineSize < ESP3D_GCODE_INDEX_LINE_SIZE) {
+      _line[_lineSize++] = c;
+    }
+  }
+}
+
+void ESP3DGcodeIndex::end() {
+  if (!_entries) {
+    return;
+  }
+  // last line without end of line
+  if (_fileSize > _lineStart) {
+    _line[_lineSize] = 0;
+    parseLine();
+    _lines++;
+    _lineSize = 0;
+    _lineStart = _fileSize;
+  }
+  if (_totalTime == 0 && _firstRemaining > 0) {
+    _totalTime = _firstRemaining;
+  }
+}
+
+const ESP3DGcodeLayer* ESP3DGcodeIndex::entry(uint32_t index) {
+  if (!_entries || index >= _count) {
+    return nullptr;
+  }
+  return &_entries[index];
+}
+
+int32_t ESP3DGcodeIndex::findOffset(uint32_t offset) {
+  if (!_entries || _count == 0 || _entries[0].offset > offset) {
+    return -1;
+  }
+  uint32_t low = 0;
+  uint32_t high = _count - 1;
+  while (low < high) {
+    uint32_t mid = (low + high + 1) / 2;
+    if (_entries[mid].offset <= offset) {
+      low = mid;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return low;
+}
+
+int32_t ESP3DGcodeIndex::findLayer(uint32_t layer) {
+  if (!_entries || _count == 0) {
+    return -1;
+  }
+  // entry n is layer n * stride
+  uint32_t index = layer / _stride;
+  if (index >= _count) {
+    index = _count - 1;
+  }
+  return index;
+}
+
+uint32_t ESP3DGcodeIndex::elapsedTime(uint32_t offset) {
+  if (_totalTime == 0) {
+    return 0;
+  }
+  int32_t index = findOffset(offset);
+  if (index < 0) {
+    return 0;
+  }
+  // interpolate inside layer
+  uint32_t startTime = _entries[index].time;
+  uint32_t startOffset = _entries[index].offset;
+  uint32_t endTime = _totalTime;
+  uint32_t endOffset = _fileSize;
+  if ((uint32_t)index + 1 < _count) {
+    endTime = _entries[index + 1].time;
+    endOffset = _entries[index + 1].offset;
+  }
+  if (endTime < startTime || endOffset <= startOffset) {
+    return startTime;
+  }
+  if (offset > endOffset) {
+    offset = endOffset;
+  }
+  return startTime + (uint32_t)((uint64_t)(endTime - startTime) *
+                                (offset - startOffset) /
+                                (endOffset - startOffset));
+}
+
+void ESP3DGcodeIndex::fillHeader(ESP3DGcodeIndexHeader& header) {
+  memcpy(header.magic, ESP3D_GCODE_INDEX_MAGIC, sizeof(header.magic));
+  header.version = ESP3D_GCODE_INDEX_VERSION;
+  header.stride = _stride;
+  header.count = _count;
+  header.fileSize = _fileSize;
+  header.fileTime = _fileTime;
+  header.lines = _lines;
+  header.layers = _layers;
+  header.totalTime = _totalTime;
+}
+
+bool ESP3DGcodeIndex::checkHeader(const ESP3DGcodeIndexHeader& header) {
+  if (memcmp(header.magic, ESP3D_GCODE_INDEX_MAGIC, sizeof(header.magic)) !=
+          0 ||
+      header.version != ESP3D_GCODE_INDEX_VERSION) {
+    esp3d_log_e("Not a valid index file");
+    return false;
+  }
+  if (header.count > ESP3D_GCODE_INDEX_MAX_LAYERS || header.stride == 0) {
+    esp3d_log_e("Index of %d layers is too big", header.count);
+    return false;
+  }
+  return true;
+}
+
+void ESP3DGcodeIndex::parseLine() {
+  const char* line = skipSpaces(_line);
+  if (*line == ';') {
+    parseComment(skipSpaces(line + 1));
+    return;
+  }
+  // line number is not part of command
+  if (*line == 'N' || *line == 'n') {
+    line++;
+    while (*line >= '0' && *line <= '9') {
+      line++;
+    }
+    line = skipSpaces(line);
+  }
+  if (*line == 0) {
+    return;
+  }
+  char letter = *line & ~0x20;
+  char* end;
+  long code = strtol(line + 1, &end, 10);
+  if (end == line + 1) {
+    return;
+  }
+  float value;
+  if (letter == 'G' && (code == 0 || code == 1)) {
+    if (_zPending && getWord(end, 'Z', value)) {
+      setLayerZ(value);
+    }
+  } else if (letter == 'M' && code == 73) {
+    // Prusa progress: remaining time in minutes
+    if (getWord(end, 'R', value) && value >= 0) {
+      int32_t remaining = (int32_t)value * 60;
+      if (_firstRemaining < 0) {
+        _firstRemaining = remaining;
+      }
+      _elapsedTime =
+          _firstRemaining > remaining ? _firstRemaining - remaining : 0;
+    }
+  }
+}
+
+void ESP3DGcodeIndex::parseComment(const char* comment) {
+  if (startsWith(comment, "LAYER:")) {
+    if (_marker == MARKER_NONE) {
+      _marker = MARKER_CURA;
+    }
+    if (_marker == MARKER_CURA) {
+      addLayer();
+    }
+  } else if (startsWith(comment, "LAYER_CHANGE")) {
+    if (_marker == MARKER_NONE) {
+      _marker = MARKER_PRUSA;
+    }
+    if (_marker == MARKER_PRUSA) {
+      addLayer();
+    }
+  } else if (startsWith(comment, "layer ") && comment[6] >= '0' &&
+             comment[6] <= '9') {
+    // ; layer 1, Z = 0.200
+    if (_marker == MARKER_NONE) {
+      _marker = MARKER_S3D;
+    }
+    if (_marker == MARKER_S3D) {
+      addLayer();
+      const char* z = strstr(comment, "Z = ");
+      if (z && _zPending) {
+        setLayerZ(strtof(z + 4, nullptr));
+      }
+    }
+  } else if (startsWith(comment, "Z:")) {
+    if (_marker == MARKER_PRUSA && _zPending) {
+      setLayerZ(strtof(comment + 2, nullptr));
+    }
+  } else if (startsWith(comment, "TIME:")) {
+    _totalTime = strtoul(comment + 5, nullptr, 10);
+  } else if (startsWith(comment, "TIME_ELAPSED:")) {
+    _elapsedTime = (uint32_t)strtof(comment + 13, nullptr);
+  } else if (startsWith(comment,
+                        "estimated printing time (normal mode) = ")) {
+    if (_totalTime == 0) {
+      _totalTime = parseDuration(comment + 40);
+    }
+  }
+}
+
+void ESP3DGcodeIndex::addLayer() {
+  uint32_t layer = _layers++;
+  _zPending = false;
+  if (layer % _stride != 0) {
+    return;
+  }
+  if (_count == ESP3D_GCODE_INDEX_MAX_LAYERS) {
+    // keep 1 entry of 2 and double the stride
+    for (uint32_t i = 0; i < _count / 2; i++) {
+      _entries[i] = _entries[2 * i];
+    }
+    _count /= 2;
+    _stride *= 2;
+    esp3d_log("Index is full, keep 1 layer of %d", _stride);
+    if (layer % _stride != 0) {
+      return;
+    }
+  }
+  ESP3DGcodeLayer& entry = _entries[_count++];
+  entry.offset = _lineStart;
+  entry.line = _lines;
+  entry.layer = layer;
+  entry.time = _elapsedTime;
+  entry.z = 0;
+  _zPending = true;
+}
+
+void ESP3DGcodeIndex::setLayerZ(float z) {
+  if (_count > 0) {
+    _entries[_count - 1].z = z;
+  }
+  _zPending = false;
+}
+
+#endif  // GCODE_INDEX_FEATURE
@@ -0,0 +1,251 @@
+/*
+  gcode_index.h -  G-code layers index class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _GCODE_INDEX_H
+#define _GCODE_INDEX_H
+
+#include <Arduino.h>
+
+#include "../../include/esp3d_config.h"
+
+// Index file is stored next to G-code file: <filename>.gidx
+#define ESP3D_GCODE_INDEX_EXTENSION ".gidx"
+#define ESP3D_GCODE_INDEX_MAGIC "GIDX"
+#define ESP3D_GCODE_INDEX_VERSION 2
+
+// Layers kept in index, when a file has more layers only 1 of 2, 1 of 4...
+// is kept
+#ifndef ESP3D_GCODE_INDEX_MAX_LAYERS
+#if defined(ARDUINO_ARCH_ESP32)
+#define ESP3D_GCODE_INDEX_MAX_LAYERS 1024
+#else
+#define ESP3D_GCODE_INDEX_MAX_LAYERS 256
+#endif  // ARDUINO_ARCH_ESP32
+#endif  // ESP3D_GCODE_INDEX_MAX_LAYERS
+
+// Part of each line which is parsed, slicer comments are short
+#define ESP3D_GCODE_INDEX_LINE_SIZE 96
+
+// Index file content is header followed by count entries (little endian)
+struct ESP3DGcodeIndexHeader {
+  char magic[4];
+  uint16_t version;
+  // one entry every stride layers
+  uint16_t stride;
+  uint32_t count;
+  // size and last write time of indexed file, index is outdated if one
+  // of them is different
+  uint32_t fileSize;
+  uint32_t fileTime;
+  uint32_t lines;
+  uint32_t layers;
+  // slicer estimation (s), 0 if unknown
+  uint32_t totalTime;
+};
+
+struct ESP3DGcodeLayer {
+  // first byte and line (0 based) of layer in file
+  uint32_t offset;
+  uint32_t line;
+  uint32_t layer;
+  // slicer estimation of time elapsed when layer starts (s)
+  uint32_t time;
+  float z;
+};
+
+// Find layers in G-code using slicers comments:
+// ;LAYER:<n> (Cura, ideaMaker), ;LAYER_CHANGE (PrusaSlicer, SuperSlicer,
+// OrcaSlicer), ; layer <n> (Simplify3D)
+// Estimated time comes from ;TIME: / ;TIME_ELAPSED: (Cura), M73 R (Prusa)
+// or ; estimated printing time (normal mode) = (Prusa)
+class ESP3DGcodeIndex {
+ public:
+  ESP3DGcodeIndex();
+  ~ESP3DGcodeIndex();
+  static bool isGcodeFile(const char* filename);
+  static String indexName(const char* filename);
+  // Index follows its G-code file, to call after file was removed or
+  // renamed, nothing is done if it was not
+  template <typename FS>
+  static void removeFor(const char* filename) {
+    if (!isGcodeFile(filename) || FS::exists(filename)) {
+      return;
+    }
+    String name = indexName(filename);
+    if (FS::exists(name.c_str())) {
+      FS::remove(name.c_str());
+    }
+  }
+  template <typename FS>
+  static void renameFor(const char* oldname, const char* newname) {
+    if (!FS::exists(newname) || FS::exists(oldname)) {
+      return;
+    }
+    // index of an overwritten file is outdated
+    String name = indexName(newname);
+    if (FS::exists(name.c_str())) {
+      FS::remove(name.c_str());
+    }
+    if (!isGcodeFile(oldname)) {
+      return;
+    }
+    name = indexName(oldname);
+    if (!FS::exists(name.c_str())) {
+      return;
+    }
+    if (!isGcodeFile(newname) ||
+        !FS::rename(name.c_str(), indexName(newname).c_str())) {
+      FS::remove(name.c_str());
+    }
+  }
+  // Start a new index, data must be fed in file order
+  bool begin();
+  void feed(const uint8_t* data, size_t size);
+  void end();
+  void clear();
+  bool isEmpty() { return _count == 0 && _totalTime == 0; }
+  bool isValid(uint32_t fileSize) {
+    return _entries && _fileSize == fileSize && !isEmpty();
+  }
+  uint32_t count() { return _count; }
+  uint32_t layers() { return _layers; }
+  uint32_t lines() { return _lines; }
+  uint32_t totalTime() { return _totalTime; }
+  uint32_t fileSize() { return _fileSize; }
+  const ESP3DGcodeLayer* entry(uint32_t index);
+  // Last entry starting at or before offset, -1 if none
+  int32_t findOffset(uint32_t offset);
+  // Entry of layer or closest one before, -1 if none
+  int32_t findLayer(uint32_t layer);
+  // Estimated time (s) already printed when reaching offset
+  uint32_t elapsedTime(uint32_t offset);
+  // File must be opened in write mode
+  template <typename T>
+  bool save(T& file) {
+    if (!_entries) {
+      return false;
+    }
+    ESP3DGcodeIndexHeader header;
+    fillHeader(header);
+    size_t size = _count * sizeof(ESP3DGcodeLayer);
+    return file.write((const uint8_t*)&header, sizeof(header)) ==
+               sizeof(header) &&
+           file.write((const uint8_t*)_entries, size) == size;
+  }
+  template <typename T>
+  bool load(T& file) {
+    ESP3DGcodeIndexHeader header;
+    clear();
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        !checkHeader(header) || !allocate(header.count)) {
+      return false;
+    }
+    size_t size = header.count * sizeof(ESP3DGcodeLayer);
+    if (file.read((uint8_t*)_entries, size) != size) {
+      clear();
+      return false;
+    }
+    _count = header.count;
+    _stride = header.stride;
+    _fileSize = header.fileSize;
+    _fileTime = header.fileTime;
+    _lines = header.lines;
+    _layers = header.layers;
+    _totalTime = header.totalTime;
+    return true;
+  }
+  // Write index next to filename using FS (ESP_FileSystem, ESP_SD...),
+  // outdated index is removed if nothing was found
+  template <typename FS>
+  bool saveFor(const char* filename) {
+    String name = indexName(filename);
+    if (FS::exists(name.c_str())) {
+      FS::remove(name.c_str());
+    }
+    if (isEmpty()) {
+      return false;
+    }
+    auto gcode = FS::open(filename);
+    if (!gcode) {
+      return false;
+    }
+    _fileTime = (uint32_t)gcode.getLastWrite();
+    gcode.close();
+    auto file = FS::open(name.c_str(), ESP_FILE_WRITE);
+    if (!file) {
+      return false;
+    }
+    bool res = save(file);
+    file.close();
+    if (!res) {
+      FS::remove(name.c_str());
+    }
+    return res;
+  }
+  // Load index of filename if it is up to date
+  template <typename FS>
+  bool loadFor(const char* filename, uint32_t fileSize, time_t fileTime) {
+    String name = indexName(filename);
+    clear();
+    if (!FS::exists(name.c_str())) {
+      return false;
+    }
+    auto file = FS::open(name.c_str());
+    if (!file) {
+      return false;
+    }
+    bool res = load(file);
+    file.close();
+    if (res && (_fileSize != fileSize || _fileTime != (uint32_t)fileTime)) {
+      clear();
+      res = false;
+    }
+    return res;
+  }
+
+ private:
+  bool allocate(uint32_t count);
+  void fillHeader(ESP3DGcodeIndexHeader& header);
+  bool checkHeader(const ESP3DGcodeIndexHeader& header);
+  void parseLine();
+  void parseComment(const char* comment);
+  void addLayer();
+  void setLayerZ(float z);
+  ESP3DGcodeLayer* _entries;
+  uint32_t _count;
+  uint16_t _stride;
+  uint32_t _fileSize;
+  uint32_t _fileTime;
+  uint32_t _lines;
+  uint32_t _layers;
+  uint32_t _totalTime;
+  uint32_t _elapsedTime;
+  // first M73 remaining time, it is the total time
+  int32_t _firstRemaining;
+  // marker used by file, other ones are ignored
+  uint8_t _marker;
+  // Z of last layer is not known yet
+  bool _zPending;
+  char _line[ESP3D_GCODE_INDEX_LINE_SIZE + 1];
+  size_t _lineSize;
+  uint32_t _lineStart;
+};
+
+#endif  //_GCODE_INDEX_H
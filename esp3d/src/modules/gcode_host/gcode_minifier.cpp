@@ -0,0 +1,244 @@
+/*
+  gcode_minifier.cpp -  G-code minifier class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "../../include/esp3d_config.h"
+#if defined(GCODE_MINIFIER_FEATURE)
+#include <stdlib.h>
+#include <string.h>
+
+#include "gcode_minifier.h"
+
+// Commands with a string parameter, spaces must be kept
+static const uint16_t stringCommands[] = {0,  1,  16,  23,  28, 30,
+                                          32, 33, 117, 118, 928};
+
+static bool isLetter(char c) {
+  return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+static bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Skip [+-]digits[.digits] from pos, return true if there was a number
+static bool skipNumber(const char* line, size_t size, size_t& pos) {
+  size_t start = pos;
+  if (pos < size && (line[pos] == '-' || line[pos] == '+')) {
+    pos++;
+  }
+  bool hasDigits = false;
+  while (pos < size && isDigit(line[pos])) {
+    pos++;
+    hasDigits = true;
+  }
+  if (pos < size && line[pos] == '.') {
+    pos++;
+    while (pos < size && isDigit(line[pos])) {
+      pos++;
+      hasDigits = true;
+    }
+  }
+  if (!hasDigits) {
+    pos = start;
+  }
+  return hasDigits;
+}
+
+ESP3DGcodeMinifier::ESP3DGcodeMinifier() {
+  _options = 0;
+  reset();
+}
+
+void ESP3DGcodeMinifier::reset() { _motion = -1; }
+
+// Line that must be sent as it is: not only letters and numbers
+bool ESP3DGcodeMinifier::isRawLine(const char* line, size_t size) {
+  size_t pos = 0;
+  bool first = true;
+  while (pos < size) {
+    char c = line[pos];
+    if (isSpace(c)) {
+      pos++;
+    } else if (c == '(' && (_options & ESP3D_MINIFY_PAREN_COMMENTS)) {
+      while (pos < size && line[pos] != ')') {
+        pos++;
+      }
+      if (pos == size) {
+        return true;
+      }
+      pos++;
+    } else if (isLetter(c)) {
+      pos++;
+      size_t start = pos;
+      bool hasNumber = skipNumber(line, size, pos);
+      if (first && hasNumber && (c == 'M' || c == 'm')) {
+        uint16_t code = (uint16_t)atoi(&line[start]);
+        for (size_t i = 0;
+             i < sizeof(stringCommands) / sizeof(stringCommands[0]); i++) {
+          if (stringCommands[i] == code) {
+            return true;
+          }
+        }
+      }
+      // value must end the word
+      if (pos < size && !isSpace(line[pos]) && !isLetter(line[pos]) &&
+          line[pos] != '(') {
+        return true;
+      }
+      first = false;
+    } else {
+      // checksum, quotes, $ commands...
+      return true;
+    }
+  }
+  return false;
+}
+
+// Write number at pos to out without sign of zero, leading and trailing
+// zeros: -00.500 => -.5, 10.000 => 10, -0.0 => 0
+size_t ESP3DGcodeMinifier::copyNumber(const char* line, size_t size,
+                                      size_t& pos, char* out) {
+  size_t start = pos;
+  if (!skipNumber(line, size, pos)) {
+    return 0;
+  }
+  size_t p = start;
+  bool negative = false;
+  if (line[p] == '-' || line[p] == '+') {
+    negative = (line[p] == '-');
+    p++;
+  }
+  size_t intStart = p;
+  while (p < pos && isDigit(line[p])) {
+    p++;
+  }
+  size_t intEnd = p;
+  while (intStart < intEnd && line[intStart] == '0') {
+    intStart++;
+  }
+  size_t fracStart = intEnd;
+  size_t fracEnd = intEnd;
+  if (p < pos && line[p] == '.') {
+    fracStart = p + 1;
+    fracEnd = pos;
+    while (fracEnd > fracStart && line[fracEnd - 1] == '0') {
+      fracEnd--;
+    }
+  }
+  size_t n = 0;
+  if (intStart == intEnd && fracStart == fracEnd) {
+    out[n++] = '0';
+    return n;
+  }
+  // output is never ahead of input, so copying forward is safe
+  if (negative) {
+    out[n++] = '-';
+  }
+  for (size_t i = intStart; i < intEnd; i++) {
+    out[n++] = line[i];
+  }
+  if (fracStart < fracEnd) {
+    out[n++] = '.';
+    for (size_t i = fracStart; i < fracEnd; i++) {
+      out[n++] = line[i];
+    }
+  }
+  return n;
+}
+
+// Line is already minified, remove leading G0/G1 if same as previous one
+size_t ESP3DGcodeMinifier::dropModalMotion(char* line, size_t size) {
+  int8_t motion = -1;
+  for (size_t i = 0; i < size; i++) {
+    if (line[i] != 'G' && line[i] != 'g') {
+      continue;
+    }
+    bool isMotion = (i == 0 && i + 1 < size &&
+                     (line[i + 1] == '0' || line[i + 1] == '1') &&
+                     (i + 2 == size || isLetter(line[i + 2])));
+    if (!isMotion) {
+      // other G command, it may change motion mode
+      _motion = -1;
+      return size;
+    }
+    motion = line[i + 1] - '0';
+  }
+  if (motion == -1) {
+    return size;
+  }
+  if (motion == _motion && size > 2) {
+    memmove(line, &line[2], size - 2);
+    size -= 2;
+    line[size] = '\0';
+  }
+  _motion = motion;
+  return size;
+}
+
+size_t ESP3DGcodeMinifier::minify(char* line, size_t size) {
+  if (!line) {
+    return 0;
+  }
+  const char* comment = (const char*)memchr(line, ';', size);
+  if (comment) {
+    size = comment - line;
+  }
+  size_t n = 0;
+  if (isRawLine(line, size)) {
+    // only trim it
+    size_t start = 0;
+    while (start < size && isSpace(line[start])) {
+      start++;
+    }
+    while (size > start && isSpace(line[size - 1])) {
+      size--;
+    }
+    n = size - start;
+    memmove(line, &line[start], n);
+    _motion = -1;
+  } else {
+    size_t pos = 0;
+    while (pos < size) {
+      char c = line[pos];
+      if (c == '(') {
+        while (line[pos] != ')') {
+          pos++;
+        }
+        pos++;
+      } else if (isLetter(c)) {
+        line[n++] = c;
+        pos++;
+        n += copyNumber(line, size, pos, &line[n]);
+      } else {
+        pos++;
+      }
+    }
+    if (_options & ESP3D_MINIFY_MODAL_MOTION) {
+      n = dropModalMotion(line, n);
+    }
+  }
+  if (n < size) {
+    line[n] = '\0';
+  }
+  return n;
+}
+
+#endif  // GCODE_MINIFIER_FEATURE
@@ -0,0 +1,57 @@
+/*
+  gcode_minifier.h -  G-code minifier class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _GCODE_MINIFIER_H
+#define _GCODE_MINIFIER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Options
+// Drop G0/G1 when motion mode is unchanged (Grbl modal motion)
+#define ESP3D_MINIFY_MODAL_MOTION 0x01
+// Remove (comments) (Grbl, RepRap)
+#define ESP3D_MINIFY_PAREN_COMMENTS 0x02
+
+// Sends same motion with less bytes:
+// G01 X10.500 Y-0.0  ; comment => G1X10.5Y0
+// Lines with string parameters (M117, M23...), quotes or checksum are only
+// cleaned from ; comments
+class ESP3DGcodeMinifier {
+ public:
+  ESP3DGcodeMinifier();
+  void setOptions(uint8_t options) { _options = options; }
+  uint8_t options() { return _options; }
+  // Forget modal state, must be done when a new stream starts
+  void reset();
+  // Minify line in place, result is never longer, return its size
+  // line is 0 terminated if there is space for it
+  size_t minify(char* line, size_t size);
+
+ private:
+  bool isRawLine(const char* line, size_t size);
+  size_t copyNumber(const char* line, size_t size, size_t& pos, char* out);
+  size_t dropModalMotion(char* line, size_t size);
+  uint8_t _options;
+  // last motion mode sent (0 or 1), -1 if unknown
+  int8_t _motion;
+};
+
+#endif  //_GCODE_MINIFIER_H
@@ -43,8 +43,9 @@
 struct ScriptEntry {
     String script;
     ESP3DAuthenticationLevel auth_type;
+    uint32_t id;
 
-    ScriptEntry(String s, ESP3DAuthenticationLevel a) : script(std::move(s)), auth_type(a) {}
+    ScriptEntry(String s, ESP3DAuthenticationLevel a, uint32_t i = 0) : script(std::move(s)), auth_type(a), id(i) {}
 };
 
 class ESP3DScriptFIFO {
@@ -61,7 +62,7 @@ class ESP3DScriptFIFO {
   void setMaxSize(size_t maxSize) { _maxSize = maxSize; }
   size_t getMaxSize() const { return _maxSize; }
 
-  void push(String script, ESP3DAuthenticationLevel auth_type) {
+  void push(String script, ESP3DAuthenticationLevel auth_type, uint32_t id = 0) {
     if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
       esp3d_log("push to list [%s] auth: %d, size: %d", script.c_str(), auth_type, fifo.size());
       if (fifo.size() >= _maxSize && _maxSize != 0) {
@@ -69,7 +70,7 @@ class ESP3DScriptFIFO {
         fifo.pop();
         esp3d_log("oldest message removed, list size: %d", fifo.size());
       }
-      fifo.emplace(std::move(script), auth_type);
+      fifo.emplace(std::move(script), auth_type, id);
       esp3d_log("push to list size: %d", fifo.size());
       xSemaphoreGive(_mutex);
     } else {
@@ -94,6 +95,8 @@ class ESP3DScriptFIFO {
     return entry;
   }
 
+  bool isFull() const { return _maxSize != 0 && size() >= _maxSize; }
+
   bool isEmpty() const {
     bool empty = true;
     if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
@@ -0,0 +1,327 @@
+/*
+  print_journal.cpp -  print checkpoint journal class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+// #define ESP_LOG_FEATURE LOG_OUTPUT_SERIAL0
+#include "../../include/esp3d_config.h"
+#if defined(PRINT_JOURNAL_FEATURE)
+#include <stdlib.h>
+#include <string.h>
+
+#include "print_journal.h"
+
+static uint32_t crc32(const uint8_t* data, size_t size) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < size; i++) {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+// crc is the last field of the structure
+template <typename T>
+static uint32_t crcOf(const T& data) {
+  return crc32((const uint8_t*)&data, sizeof(T) - sizeof(uint32_t));
+}
+
+static String segmentName(uint8_t segment) {
+  return String(ESP3D_PRINT_JOURNAL_SEGMENT) + String(segment) + ".bin";
+}
+
+static bool hasLetter(const char* command, char letter) {
+  for (const char* p = command; *p && *p != ';'; p++) {
+    if (*p == letter || *p == letter + ('a' - 'A')) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Value of word letter in command, false if absent
+static bool getWord(const char* command, char letter, float& value) {
+  for (const char* p = command; *p && *p != ';'; p++) {
+    if (*p == letter || *p == letter + ('a' - 'A')) {
+      char* end;
+      value = strtof(p + 1, &end);
+      if (end != p + 1) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+ESP3DPrintJournal::ESP3DPrintJournal() {
+  memset(&_header, 0, sizeof(_header));
+  memset(&_record, 0, sizeof(_record));
+  _segment = 0;
+  _recordsCount = 0;
+  _pendingLines = 0;
+  _lastSync = 0;
+}
+
+ESP3DPrintJournal::~ESP3DPrintJournal() { end(true); }
+
+bool ESP3DPrintJournal::begin(uint8_t fsType, const char* fileName,
+                              uint32_t fileSize,
+                              const ESP3DPrintJournalRecord& state) {
+  end(false);
+  clear();
+  memset(&_header, 0, sizeof(_header));
+  memcpy(_header.magic, ESP3D_PRINT_JOURNAL_MAGIC, sizeof(_header.magic));
+  _header.version = ESP3D_PRINT_JOURNAL_VERSION;
+  _header.fsType = fsType;
+  _header.fileSize = fileSize;
+  if (strlen(fileName) >= sizeof(_header.fileName)) {
+    esp3d_log_e("File name too long for journal: %s", fileName);
+    return false;
+  }
+  strcpy(_header.fileName, fileName);
+  _header.crc = crcOf(_header);
+  _record = state;
+  if (!openSegment(0)) {
+    return false;
+  }
+  _pendingLines = 1;
+  sync();
+  return true;
+}
+
+bool ESP3DPrintJournal::openSegment(uint8_t segment) {
+  if (_file.isOpen()) {
+    _file.close();
+  }
+  _segment = segment;
+  _recordsCount = 0;
+  String name = segmentName(segment);
+  _file = ESP_FileSystem::open(name.c_str(), ESP_FILE_WRITE);
+  if (!_file.isOpen()) {
+    esp3d_log_e("Cannot create journal %s", name.c_str());
+    return false;
+  }
+  if (_file.write((const uint8_t*)&_header, sizeof(_header)) !=
+      sizeof(_header)) {
+    esp3d_log_e("Cannot write journal %s", name.c_str());
+    _file.close();
+    return false;
+  }
+  _file.flush();
+  return true;
+}
+
+void ESP3DPrintJournal::track(const char* command) {
+  if (!_file.isOpen()) {
+    return;
+  }
+  // line number and checksum are not part of the command
+  if (*command == 'N' || *command == 'n') {
+    command++;
+    while (*command >= '0' && *command <= '9') {
+      command++;
+    }
+    while (*command == ' ') {
+      command++;
+    }
+  }
+  char letter = *command & ~0x20;
+  char* end;
+  long code = strtol(command + 1, &end, 10);
+  if (end == command + 1) {
+    return;
+  }
+  float value;
+  uint8_t& modes = _record.modes;
+  if (letter == 'G') {
+    switch (code) {
+      case 0:
+      case 1:
+      case 2:
+      case 3:
+        if (getWord(end, 'Z', value)) {
+          if (!(modes & ESP3D_JOURNAL_RELATIVE_XYZ)) {
+            _record.z = value;
+            modes |= ESP3D_JOURNAL_Z_KNOWN;
+          } else if (modes & ESP3D_JOURNAL_Z_KNOWN) {
+            _record.z += value;
+          }
+        }
+        if (getWord(end, 'E', value)) {
+          if (!(modes & ESP3D_JOURNAL_RELATIVE_E)) {
+            _record.e = value;
+            modes |= ESP3D_JOURNAL_E_KNOWN;
+          } else if (modes & ESP3D_JOURNAL_E_KNOWN) {
+            _record.e += value;
+          }
+        }
+        if (getWord(end, 'F', value)) {
+          _record.feedrate = value;
+        }
+        break;
+      case 28:
+        // Z is unknown until next absolute move once it is homed
+        if (hasLetter(end, 'Z') ||
+            (!hasLetter(end, 'X') && !hasLetter(end, 'Y'))) {
+          modes &= ~ESP3D_JOURNAL_Z_KNOWN;
+        }
+        break;
+      case 90:
+        // E follows positioning mode until M82/M83
+        modes &= ~(ESP3D_JOURNAL_RELATIVE_XYZ | ESP3D_JOURNAL_RELATIVE_E);
+        break;
+      case 91:
+        modes |= ESP3D_JOURNAL_RELATIVE_XYZ | ESP3D_JOURNAL_RELATIVE_E;
+        break;
+      case 92:
+        if (getWord(end, 'Z', value)) {
+          _record.z = value;
+          modes |= ESP3D_JOURNAL_Z_KNOWN;
+        }
+        if (getWord(end, 'E', value)) {
+          _record.e = value;
+          modes |= ESP3D_JOURNAL_E_KNOWN;
+        }
+        break;
+    }
+  } else if (letter == 'M') {
+    switch (code) {
+      case 82:
+        modes &= ~ESP3D_JOURNAL_RELATIVE_E;
+        break;
+      case 83:
+        modes |= ESP3D_JOURNAL_RELATIVE_E;
+        break;
+      case 104:
+      case 109:
+        // other extruders are not tracked
+        if ((!getWord(end, 'T', value) || value == 0) &&
+            getWord(end, 'S', value)) {
+          _record.hotendTemperature = value;
+        }
+        break;
+      case 140:
+      case 190:
+        if (getWord(end, 'S', value)) {
+          _record.bedTemperature = value;
+        }
+        break;
+    }
+  }
+}
+
+void ESP3DPrintJournal::acked(uint32_t offset, uint32_t line,
+                              uint32_t commandNumber) {
+  if (!_file.isOpen()) {
+    return;
+  }
+  _record.offset = offset;
+  _record.line = line;
+  _record.commandNumber = commandNumber;
+  _pendingLines++;
+  if (_pendingLines >= ESP3D_PRINT_JOURNAL_LINES ||
+      millis() - _lastSync >= ESP3D_PRINT_JOURNAL_INTERVAL) {
+    sync();
+  }
+}
+
+void ESP3DPrintJournal::sync() {
+  if (!_file.isOpen() || _pendingLines == 0) {
+    return;
+  }
+  if (_recordsCount >= ESP3D_PRINT_JOURNAL_RECORDS &&
+      !openSegment(_segment ^ 1)) {
+    return;
+  }
+  _record.sequence++;
+  _record.crc = crcOf(_record);
+  if (_file.write((const uint8_t*)&_record, sizeof(_record)) !=
+      sizeof(_record)) {
+    esp3d_log_e("Cannot write journal record");
+  }
+  _file.flush();
+  _recordsCount++;
+  _pendingLines = 0;
+  _lastSync = millis();
+  esp3d_log("Journal record %d: offset %d line %d", _record.sequence,
+            _record.offset, _record.line);
+}
+
+void ESP3DPrintJournal::end(bool keep) {
+  if (!_file.isOpen()) {
+    return;
+  }
+  if (keep) {
+    sync();
+    _file.close();
+  } else {
+    _file.close();
+    clear();
+  }
+}
+
+bool ESP3DPrintJournal::read(ESP3DPrintJournalHeader& header,
+                             ESP3DPrintJournalRecord& record) {
+  bool found = false;
+  for (uint8_t segment = 0; segment < 2; segment++) {
+    String name = segmentName(segment);
+    if (!ESP_FileSystem::exists(name.c_str())) {
+      continue;
+    }
+    ESP_File file = ESP_FileSystem::open(name.c_str());
+    ESP3DPrintJournalHeader segmentHeader;
+    if (!file.isOpen()) {
+      continue;
+    }
+    if (file.read((uint8_t*)&segmentHeader, sizeof(segmentHeader)) !=
+            sizeof(segmentHeader) ||
+        memcmp(segmentHeader.magic, ESP3D_PRINT_JOURNAL_MAGIC,
+               sizeof(segmentHeader.magic)) != 0 ||
+        segmentHeader.version != ESP3D_PRINT_JOURNAL_VERSION ||
+        segmentHeader.crc != crcOf(segmentHeader)) {
+      esp3d_log_e("Invalid journal %s", name.c_str());
+      file.close();
+      continue;
+    }
+    ESP3DPrintJournalRecord current;
+    // a record interrupted by reset fails crc and ends the segment
+    while (file.read((uint8_t*)&current, sizeof(current)) ==
+               sizeof(current) &&
+           current.crc == crcOf(current)) {
+      if (!found || current.sequence > record.sequence) {
+        record = current;
+        header = segmentHeader;
+        found = true;
+      }
+    }
+    file.close();
+  }
+  return found;
+}
+
+void ESP3DPrintJournal::clear() {
+  for (uint8_t segment = 0; segment < 2; segment++) {
+    String name = segmentName(segment);
+    if (ESP_FileSystem::exists(name.c_str())) {
+      ESP_FileSystem::remove(name.c_str());
+    }
+  }
+}
+
+#endif  // PRINT_JOURNAL_FEATURE
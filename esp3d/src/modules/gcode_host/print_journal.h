@@ -0,0 +1,121 @@
+/*
+  print_journal.h -  print checkpoint journal class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _PRINT_JOURNAL_H
+#define _PRINT_JOURNAL_H
+
+#include <Arduino.h>
+
+#include "../../include/esp3d_config.h"
+#include "../filesystem/esp_filesystem.h"
+
+// Journal is 2 segments on local filesystem, when one is full the other one
+// is restarted, so previous records stay readable until new ones are written
+#define ESP3D_PRINT_JOURNAL_SEGMENT "/print_journal_"
+#define ESP3D_PRINT_JOURNAL_MAGIC "PJNL"
+#define ESP3D_PRINT_JOURNAL_VERSION 2
+#define ESP3D_PRINT_JOURNAL_NAME_SIZE 128
+
+// Records in one segment
+#ifndef ESP3D_PRINT_JOURNAL_RECORDS
+#define ESP3D_PRINT_JOURNAL_RECORDS 128
+#endif  // ESP3D_PRINT_JOURNAL_RECORDS
+
+// A record is written every N acknowledged lines...
+#ifndef ESP3D_PRINT_JOURNAL_LINES
+#define ESP3D_PRINT_JOURNAL_LINES 100
+#endif  // ESP3D_PRINT_JOURNAL_LINES
+
+// ...or every N ms if some lines were acknowledged meanwhile
+#ifndef ESP3D_PRINT_JOURNAL_INTERVAL
+#define ESP3D_PRINT_JOURNAL_INTERVAL 10000
+#endif  // ESP3D_PRINT_JOURNAL_INTERVAL
+
+// Printer modes of record, modes not set by file are firmware default ones
+// (absolute), a position is known only once the file has set it
+#define ESP3D_JOURNAL_RELATIVE_XYZ 0x01
+#define ESP3D_JOURNAL_RELATIVE_E 0x02
+#define ESP3D_JOURNAL_Z_KNOWN 0x04
+#define ESP3D_JOURNAL_E_KNOWN 0x08
+
+struct ESP3DPrintJournalHeader {
+  char magic[4];
+  uint16_t version;
+  uint8_t fsType;
+  uint8_t reserved;
+  // size of printed file, it must not have changed to resume
+  uint32_t fileSize;
+  char fileName[ESP3D_PRINT_JOURNAL_NAME_SIZE];
+  uint32_t crc;
+};
+
+struct ESP3DPrintJournalRecord {
+  uint32_t sequence;
+  // next line to send, all lines before were acknowledged
+  uint32_t offset;
+  uint32_t line;
+  uint32_t commandNumber;
+  // last values sent to printer, 0 if unknown
+  float z;
+  float e;
+  float feedrate;
+  float hotendTemperature;
+  float bedTemperature;
+  // ESP3D_JOURNAL_* flags
+  uint8_t modes;
+  uint8_t reserved[3];
+  uint32_t crc;
+};
+
+class ESP3DPrintJournal {
+ public:
+  ESP3DPrintJournal();
+  ~ESP3DPrintJournal();
+  // Start journal of a new job, previous journal is removed
+  // state is the start position (and values of a recovered job), it is
+  // written at once so job can be recovered even before first sync
+  bool begin(uint8_t fsType, const char* fileName, uint32_t fileSize,
+             const ESP3DPrintJournalRecord& state);
+  // Command sent to printer, Z, E, modes, feedrate and temperatures are kept
+  void track(const char* command);
+  // All lines before offset were acknowledged
+  void acked(uint32_t offset, uint32_t line, uint32_t commandNumber);
+  // Write a record now if something changed
+  void sync();
+  // Job is done, journal is removed unless it is kept for recovery
+  void end(bool keep);
+  bool started() { return _file.isOpen(); }
+  // Last consistent record written by a job
+  static bool read(ESP3DPrintJournalHeader& header,
+                   ESP3DPrintJournalRecord& record);
+  static void clear();
+
+ private:
+  bool openSegment(uint8_t segment);
+  ESP_File _file;
+  ESP3DPrintJournalHeader _header;
+  ESP3DPrintJournalRecord _record;
+  uint8_t _segment;
+  uint16_t _recordsCount;
+  uint32_t _pendingLines;
+  uint32_t _lastSync;
+};
+
+#endif  //_PRINT_JOURNAL_H
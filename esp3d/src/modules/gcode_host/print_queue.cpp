@@ -0,0 +1,299 @@
+/*
+  print_queue.cpp -  print job queue class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+// #define ESP_LOG_FEATURE LOG_OUTPUT_SERIAL0
+#include "../../include/esp3d_config.h"
+#if defined(PRINT_QUEUE_FEATURE)
+#include <string.h>
+
+#include "../filesystem/esp_filesystem.h"
+#include "print_queue.h"
+
+ESP3DPrintQueue::ESP3DPrintQueue() {
+  _count = 0;
+  _nextId = 1;
+  _loaded = false;
+  _paused = false;
+  _mutex = xSemaphoreCreateMutex();
+}
+
+ESP3DPrintQueue::~ESP3DPrintQueue() { vSemaphoreDelete(_mutex); }
+
+// Filesystem is started after gcode host, so queue is read on first use
+bool ESP3DPrintQueue::load() {
+  if (_loaded) {
+    return true;
+  }
+  if (!ESP_FileSystem::started()) {
+    return false;
+  }
+  _loaded = true;
+  // aside file is complete only if reset happened before its rename, so it
+  // is newer than queue file
+  if (loadFrom(ESP3D_PRINT_QUEUE_TMP_FILE)) {
+    esp3d_log("Print queue restored from %s", ESP3D_PRINT_QUEUE_TMP_FILE);
+    save();
+  } else if (!loadFrom(ESP3D_PRINT_QUEUE_FILE)) {
+    return true;
+  }
+  // bed may not be clear after a reset, so restored jobs wait for operator
+  _paused = _count > 0;
+  esp3d_log("Print queue has %d jobs", _count);
+  return true;
+}
+
+bool ESP3DPrintQueue::loadFrom(const char* path) {
+  if (!ESP_FileSystem::exists(path)) {
+    return false;
+  }
+  ESP_File file = ESP_FileSystem::open(path);
+  if (!file.isOpen()) {
+    esp3d_log_e("Cannot open %s", path);
+    return false;
+  }
+  ESP3DPrintQueueHeader header;
+  if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+      memcmp(header.magic, ESP3D_PRINT_QUEUE_MAGIC, sizeof(header.magic)) !=
+          0 ||
+      header.version != ESP3D_PRINT_QUEUE_VERSION ||
+      header.count > ESP3D_PRINT_QUEUE_SIZE ||
+      file.size() != sizeof(header) + header.count * sizeof(ESP3DPrintJob)) {
+    esp3d_log_e("Invalid print queue %s", path);
+    file.close();
+    return false;
+  }
+  size_t size = header.count * sizeof(ESP3DPrintJob);
+  bool res = file.read((uint8_t*)_jobs, size) == size;
+  file.close();
+  if (!res) {
+    return false;
+  }
+  _count = header.count;
+  _nextId = header.nextId;
+  for (uint16_t i = 0; i < _count; i++) {
+    _jobs[i].fileName[ESP3D_PRINT_QUEUE_NAME_SIZE - 1] = 0;
+  }
+  return true;
+}
+
+bool ESP3DPrintQueue::save() {
+  ESP3DPrintQueueHeader header;
+  memcpy(header.magic, ESP3D_PRINT_QUEUE_MAGIC, sizeof(header.magic));
+  header.version = ESP3D_PRINT_QUEUE_VERSION;
+  header.count = _count;
+  header.nextId = _nextId;
+  ESP_File file =
+      ESP_FileSystem::open(ESP3D_PRINT_QUEUE_TMP_FILE, ESP_FILE_WRITE);
+  if (!file.isOpen()) {
+    esp3d_log_e("Cannot create print queue");
+    return false;
+  }
+  size_t size = _count * sizeof(ESP3DPrintJob);
+  bool res = file.write((const uint8_t*)&header, sizeof(header)) ==
+                 sizeof(header) &&
+             file.write((const uint8_t*)_jobs, size) == size;
+  file.close();
+  if (!res) {
+    esp3d_log_e("Cannot write print queue");
+    ESP_FileSystem::remove(ESP3D_PRINT_QUEUE_TMP_FILE);
+    return false;
+  }
+  // rename does not replace existing file on all filesystems, load() reads
+  // aside file if reset happens in between
+  if (ESP_FileSystem::exists(ESP3D_PRINT_QUEUE_FILE)) {
+    ESP_FileSystem::remove(ESP3D_PRINT_QUEUE_FILE);
+  }
+  return ESP_FileSystem::rename(ESP3D_PRINT_QUEUE_TMP_FILE,
+                                ESP3D_PRINT_QUEUE_FILE);
+}
+
+uint32_t ESP3DPrintQueue::add(const char* fileName,
+                              ESP3DAuthenticationLevel auth,
+                              uint8_t priority) {
+  uint32_t id = 0;
+  if (strlen(fileName) >= ESP3D_PRINT_QUEUE_NAME_SIZE) {
+    esp3d_log_e("File name too long for print queue: %s", fileName);
+    return 0;
+  }
+  if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+    if (!load()) {
+      esp3d_log_e("Print queue is not available");
+    } else if (_count >= ESP3D_PRINT_QUEUE_SIZE) {
+      esp3d_log_e("Print queue is full");
+    } else {
+      // keep jobs sorted: after all jobs of same or higher priority
+      uint16_t pos = _count;
+      while (pos > 0 && _jobs[pos - 1].priority < priority) {
+        _jobs[pos] = _jobs[pos - 1];
+        pos--;
+      }
+      ESP3DPrintJob& job = _jobs[pos];
+      memset(&job, 0, sizeof(job));
+      job.id = _nextId++;
+      if (_nextId == 0) {
+        _nextId = 1;
+      }
+      job.priority = priority;
+      job.auth = static_cast<uint8_t>(auth);
+      strcpy(job.fileName, fileName);
+      _count++;
+      save();
+      id = job.id;
+      esp3d_log("Job %d queued: %s", job.id, job.fileName);
+    }
+    xSemaphoreGive(_mutex);
+  } else {
+    esp3d_log_e("Mutex not taken");
+  }
+  return id;
+}
+
+bool ESP3DPrintQueue::removeJob(uint32_t id) {
+  for (uint16_t i = 0; i < _count; i++) {
+    if (_jobs[i].id == id) {
+      _count--;
+      memmove(&_jobs[i], &_jobs[i + 1], (_count - i) * sizeof(ESP3DPrintJob));
+      save();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ESP3DPrintQueue::remove(uint32_t id) {
+  bool res = false;
+  if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+    res = load() && removeJob(id);
+    xSemaphoreGive(_mutex);
+  } else {
+    esp3d_log_e("Mutex not taken");
+  }
+  return res;
+}
+
+void ESP3DPrintQueue::clear() {
+  if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+    if (load()) {
+      _count = 0;
+      _paused = false;
+      if (ESP_FileSystem::exists(ESP3D_PRINT_QUEUE_FILE)) {
+        ESP_FileSystem::remove(ESP3D_PRINT_QUEUE_FILE);
+      }
+      if (ESP_FileSystem::exists(ESP3D_PRINT_QUEUE_TMP_FILE)) {
+        ESP_FileSystem::remove(ESP3D_PRINT_QUEUE_TMP_FILE);
+      }
+    }
+    xSemaphoreGive(_mutex);
+  } else {
+    esp3d_log_e("Mutex not taken");
+  }
+}
+
+bool ESP3DPrintQueue::first(ESP3DPrintJob& job) {
+  bool res = false;
+  if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+    if (load() && _count > 0) {
+      job = _jobs[0];
+      res = true;
+    }
+    xSemaphoreGive(_mutex);
+  } else {
+    esp3d_log_e("Mutex not taken");
+  }
+  return res;
+}
+
+bool ESP3DPrintQueue::pop(ESP3DPrintJob& job) {
+  bool res = false;
+  if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+    if (load() && _count > 0) {
+      job = _jobs[0];
+      res = removeJob(job.id);
+    }
+    xSemaphoreGive(_mutex);
+  } else {
+    esp3d_log_e("Mutex not taken");
+  }
+  return res;
+}
+
+bool ESP3DPrintQueue::find(uint32_t id, ESP3DPrintJob& job) {
+  bool res = false;
+  if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+    if (load()) {
+      for (uint16_t i = 0; i < _count && !res; i++) {
+        if (_jobs[i].id == id) {
+          job = _jobs[i];
+          res = true;
+        }
+      }
+    }
+    xSemaphoreGive(_mutex);
+  } else {
+    esp3d_log_e("Mutex not taken");
+  }
+  return res;
+}
+
+uint16_t ESP3DPrintQueue::count() {
+  uint16_t nb = 0;
+  if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+    nb = load() ? _count : 0;
+    xSemaphoreGive(_mutex);
+  } else {
+    esp3d_log_e("Mutex not taken");
+  }
+  return nb;
+}
+
+String ESP3DPrintQueue::toString(bool json, uint32_t currentJob) {
+  String s;
+  if (xSemaphoreTake(_mutex, portMAX_DELAY) != pdTRUE) {
+    esp3d_log_e("Mutex not taken");
+    return s;
+  }
+  uint16_t nb = load() ? _count : 0;
+  s.reserve(64 + nb * (ESP3D_PRINT_QUEUE_NAME_SIZE / 2));
+  s = json ? "{\"paused\":\"" : "paused: ";
+  s += _paused ? "yes" : "no";
+  s += json ? "\",\"current\":\"" : "\ncurrent: ";
+  s += String(currentJob);
+  s += json ? "\",\"jobs\":[" : "";
+  for (uint16_t i = 0; i < nb; i++) {
+    const ESP3DPrintJob& entry = _jobs[i];
+    if (json) {
+      if (i > 0) {
+        s += ",";
+      }
+      s += "{\"id\":\"" + String(entry.id) + "\",\"priority\":\"" +
+           String(entry.priority) + "\",\"file\":\"" + entry.fileName +
+           "\"}";
+    } else {
+      s += "\n" + String(entry.id) + " P" + String(entry.priority) + " " +
+           entry.fileName;
+    }
+  }
+  if (json) {
+    s += "]}";
+  }
+  xSemaphoreGive(_mutex);
+  return s;
+}
+
+#endif  // PRINT_QUEUE_FEATURE
@@ -0,0 +1,123 @@
+/*
+  print_queue.h -  print job queue class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _PRINT_QUEUE_H
+#define _PRINT_QUEUE_H
+
+#include <Arduino.h>
+
+#include "../../include/esp3d_config.h"
+#include "../authentication/authentication_level_types.h"
+#if defined(ARDUINO_ARCH_ESP32)
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#endif  // ARDUINO_ARCH_ESP32
+
+#if defined(ARDUINO_ARCH_ESP8266)
+#ifndef pdTRUE
+#define pdTRUE true
+#define xSemaphoreTake(A, B) true
+#define xSemaphoreGive(A)
+#define xSemaphoreCreateMutex(A) 0
+#define vSemaphoreDelete(A)
+#define SemaphoreHandle_t void*
+#endif  // pdTRUE
+#endif  // ESP8266
+
+// Queue is saved on local filesystem after each change, new content is
+// written aside then renamed, if a reset happens before rename the complete
+// new content is read from aside file
+#define ESP3D_PRINT_QUEUE_FILE "/print_queue.bin"
+#define ESP3D_PRINT_QUEUE_TMP_FILE "/print_queue.tmp"
+#define ESP3D_PRINT_QUEUE_MAGIC "PQUE"
+#define ESP3D_PRINT_QUEUE_VERSION 1
+#define ESP3D_PRINT_QUEUE_NAME_SIZE 128
+
+// Jobs in queue
+#ifndef ESP3D_PRINT_QUEUE_SIZE
+#define ESP3D_PRINT_QUEUE_SIZE 16
+#endif  // ESP3D_PRINT_QUEUE_SIZE
+
+// Next job is opened when current file has less than N bytes left to send
+#ifndef ESP3D_PRINT_QUEUE_PREFETCH_DISTANCE
+#define ESP3D_PRINT_QUEUE_PREFETCH_DISTANCE 4096
+#endif  // ESP3D_PRINT_QUEUE_PREFETCH_DISTANCE
+
+// Bytes of next job read ahead when it is opened
+#ifndef ESP3D_PRINT_QUEUE_PREFETCH_SIZE
+#define ESP3D_PRINT_QUEUE_PREFETCH_SIZE 256
+#endif  // ESP3D_PRINT_QUEUE_PREFETCH_SIZE
+
+struct ESP3DPrintJob {
+  uint32_t id;
+  // higher priority jobs are printed first, same priority is FIFO
+  uint8_t priority;
+  // ESP3DAuthenticationLevel of client which queued the job
+  uint8_t auth;
+  uint16_t reserved;
+  // with /FS or /SD header
+  char fileName[ESP3D_PRINT_QUEUE_NAME_SIZE];
+};
+
+struct ESP3DPrintQueueHeader {
+  char magic[4];
+  uint16_t version;
+  uint16_t count;
+  uint32_t nextId;
+};
+
+// Jobs are copied out, as queue is used by commands and by gcode host
+class ESP3DPrintQueue {
+ public:
+  ESP3DPrintQueue();
+  ~ESP3DPrintQueue();
+  // Add job, return its id or 0 if queue is full
+  uint32_t add(const char* fileName, ESP3DAuthenticationLevel auth,
+               uint8_t priority = 0);
+  bool remove(uint32_t id);
+  // Remove all jobs, empty queue is not paused anymore
+  void clear();
+  // Job to print next, false if queue is empty
+  bool first(ESP3DPrintJob& job);
+  // Remove next job from queue
+  bool pop(ESP3DPrintJob& job);
+  // Job of id, false if it is not in queue
+  bool find(uint32_t id, ESP3DPrintJob& job);
+  uint16_t count();
+  // Paused queue keeps its jobs but none is started
+  void setPaused(bool paused) { _paused = paused; }
+  bool isPaused() { return _paused; }
+  String toString(bool json, uint32_t currentJob = 0);
+
+ private:
+  // Called with mutex taken
+  bool load();
+  bool loadFrom(const char* path);
+  bool save();
+  bool removeJob(uint32_t id);
+  SemaphoreHandle_t _mutex;
+  ESP3DPrintJob _jobs[ESP3D_PRINT_QUEUE_SIZE];
+  uint16_t _count;
+  uint32_t _nextId;
+  bool _loaded;
+  bool _paused;
+};
+
+#endif  //_PRINT_QUEUE_H
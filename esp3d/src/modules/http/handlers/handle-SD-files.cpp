@@ -30,6 +30,12 @@
 #include "../../../core/esp3d_string.h"
 #include "../../authentication/authentication_service.h"
 #include "../../filesystem/esp_sd.h"
+#if defined(GCODE_INDEX_FEATURE)
+#include "../../gcode_host/gcode_index.h"
+#endif  // GCODE_INDEX_FEATURE
+#if defined(GLOBAL_FILESYSTEM_FEATURE)
+#include "../../filesystem/esp_globalFS.h"
+#endif  // GLOBAL_FILESYSTEM_FEATURE
 
 // SD
 // SD files list and file commands
@@ -98,6 +104,9 @@ void HTTP_Server::handleSDFileList() {
       } else {
         if (ESP_SD::remove(filename.c_str())) {
           status = shortname + " deleted";
+#if defined(GCODE_INDEX_FEATURE)
+          ESP3DGcodeIndex::removeFor<ESP_SD>(filename.c_str());
+#endif  // GCODE_INDEX_FEATURE
           // what happen if no "/." and no other subfiles for SPIFFS like?
           String ptmp = path;
           if ((path != "/") && (path[path.length() - 1] = '/')) {
@@ -122,6 +131,22 @@ void HTTP_Server::handleSDFileList() {
       filename += "/";
       filename.replace("//", "/");
       if (filename != "/") {
+#if defined(GLOBAL_FILESYSTEM_FEATURE)
+        // whole tree is removed in background, progress is given by ESP791
+        String globalPath = ESP_SD_FS_HEADER + filename;
+        uint16_t jobId =
+            ESP_GBFS::addJob(ESP_GBFSJobType::remove, globalPath.c_str());
+        if (jobId != 0) {
+          esp3d_log("Deleting %s, job %d", filename.c_str(), jobId);
+          status = shortname;
+          status += " deletion started (job ";
+          status += String(jobId);
+          status += ")";
+        } else {
+          status = "Cannot deleted ";
+          status += shortname;
+        }
+#else
         if (ESP_SD::rmdir(filename.c_str())) {
           esp3d_log("Deleting %s", filename.c_str());
           status = shortname;
@@ -130,6 +155,7 @@ void HTTP_Server::handleSDFileList() {
           status = "Cannot deleted ";
           status += shortname;
         }
+#endif  // GLOBAL_FILESYSTEM_FEATURE
       }
     }
     // create a directory
@@ -0,0 +1,149 @@
+/*
+ handle-batch.cpp - ESP3D http handle
+
+ Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with This code; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "../../../include/esp3d_config.h"
+#if defined(HTTP_FEATURE) && defined(GCODE_HOST_FEATURE)
+#include "../http_server.h"
+#include <ESPAsyncWebServer.h>
+#include "../../../core/esp3d_commands.h"
+#include "../../authentication/authentication_service.h"
+#include "../../gcode_host/gcode_host.h"
+
+static String batchResult(uint32_t id, uint32_t lines, bool done) {
+  String json = "{\"id\":\"" + String(id) + "\",\"lines\":\"" + String(lines) + "\",\"done\":\"" + (done ? "yes" : "no") + "\"";
+  // error is only known for last script done
+  if (done && esp3d_gcode_host.scriptsDone() == id) {
+    json += ",\"error\":\"" + String(esp3d_gcode_host.scriptError()) + "\"";
+  }
+  json += "}";
+  return json;
+}
+
+// Body of /batch is kept in request until it is complete
+void HTTP_Server::BatchBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+  if (index == 0) {
+    if (total > ESP3D_BATCH_MAX_SIZE || request->_tempObject) {
+      esp3d_log_e("Batch of %d bytes refused", total);
+      return;
+    }
+    request->_tempObject = malloc(total + 1);
+    if (!request->_tempObject) {
+      esp3d_log_e("Not enough memory for batch of %d bytes", total);
+      return;
+    }
+  }
+  if (request->_tempObject && index + len <= total) {
+    memcpy((uint8_t *)request->_tempObject + index, data, len);
+    ((char *)request->_tempObject)[index + len] = 0;
+  }
+}
+
+// Handle batch of commands /batch (POST), body has one command per line,
+// lines are sent by G-code host as one script so each one waits for printer
+// ack, wait=1 answers only when batch is done or after ESP3D_BATCH_TIMEOUT
+void HTTP_Server::handle_batch(AsyncWebServerRequest *request) {
+  ESP3DAuthenticationLevel auth_level = AuthenticationService::getAuthenticatedLevel();
+  if (auth_level == ESP3DAuthenticationLevel::guest) {
+    request->send(401, "text/plain", "Wrong authentication!");
+    return;
+  }
+  if (!request->_tempObject) {
+    if (request->contentLength() > ESP3D_BATCH_MAX_SIZE) {
+      request->send(413, "text/plain", "Batch too big");
+    } else {
+      request->send(400, "text/plain", "Invalid batch");
+    }
+    return;
+  }
+  // script uses ';' as separator, so comments are removed
+  String script;
+  uint32_t lines = 0;
+  char *line = (char *)request->_tempObject;
+  while (*line) {
+    char *end = line + strcspn(line, "\r\n");
+    char next = *end;
+    *end = 0;
+    while (*line == ' ' || *line == '\t') {
+      line++;
+    }
+    size_t size = strlen(line);
+    if (!esp3d_commands.is_esp_command((uint8_t *)line, size)) {
+      char *comment = strchr(line, ';');
+      if (comment) {
+        size = comment - line;
+      }
+    } else if (strchr(line, ';')) {
+      esp3d_log_e("Invalid batch line %s", line);
+      request->send(400, "text/plain", "Invalid batch line " + String(lines + 1));
+      return;
+    }
+    while (size > 0 && (line[size - 1] == ' ' || line[size - 1] == '\t')) {
+      size--;
+    }
+    if (size > 0) {
+      line[size] = 0;
+      if (script.length() > 0) {
+        script += ";";
+      }
+      script += line;
+      lines++;
+    }
+    line = next ? end + 1 : end;
+  }
+  if (lines == 0) {
+    request->send(400, "text/plain", "No command in batch");
+    return;
+  }
+  // a full queue would drop oldest batch
+  if (esp3d_gcode_host.isScriptQueueFull()) {
+    request->send(503, "text/plain", "Too many batches queued");
+    return;
+  }
+  if (!esp3d_gcode_host.processScript(script.c_str(), auth_level)) {
+    request->send(500, "text/plain", "Cannot process batch");
+    return;
+  }
+  uint32_t id = esp3d_gcode_host.lastScriptId();
+  esp3d_log("Batch %d: %d lines", id, lines);
+  bool wait = request->hasParam("wait") && request->getParam("wait")->value() != "0";
+  if (!wait) {
+    request->send(200, "application/json", batchResult(id, lines, esp3d_gcode_host.isScriptDone(id)));
+    return;
+  }
+  uint32_t start = millis();
+  bool sent = false;
+  AsyncWebServerResponse *response = request->beginChunkedResponse(
+      "application/json", [id, lines, start, sent](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+        if (sent) {
+          return 0;
+        }
+        bool done = esp3d_gcode_host.isScriptDone(id);
+        if (!done && millis() - start < ESP3D_BATCH_TIMEOUT) {
+          return RESPONSE_TRY_AGAIN;
+        }
+        String json = batchResult(id, lines, done);
+        size_t size = json.length() < maxLen ? json.length() : maxLen;
+        memcpy(buffer, json.c_str(), size);
+        sent = true;
+        return size;
+      });
+  response->addHeader("Cache-Control", "no-cache");
+  request->send(response);
+}
+#endif  // HTTP_FEATURE && GCODE_HOST_FEATURE
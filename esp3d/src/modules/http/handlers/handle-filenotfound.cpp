@@ -29,6 +29,7 @@
 #include "../../filesystem/esp_sd.h"
 #endif  // SD_DEVICE
 #include "../favicon.h"
+#include "../path_cache.h"
 
 #if defined(ESP3DLIB_ENV) && COMMUNICATION_PROTOCOL == SOCKET_SERIAL
 #include "../../serial2socket/serial2socket.h"
@@ -43,18 +44,19 @@ void HTTP_Server::handle_not_found(AsyncWebServerRequest *request) {
     return;
   }
   String path = esp3d_string::urlDecode(request->url()); // urlDecode is correct as per esp3d_string.h
-  String contentType = esp3d_string::getContentType(path.c_str());
   String pathWithGz = path + ".gz";
   esp3d_log("URI: %s", path.c_str());
 #if defined(FILESYSTEM_FEATURE)
-  if (ESP_FileSystem::exists(pathWithGz.c_str()) || ESP_FileSystem::exists(path.c_str())) {
+  const ESP3DPathEntry &entry =
+      esp3d_path_cache.resolve(FS_FLASH, path.c_str());
+  if (entry.variant != ESP3DPathVariant::none) {
     esp3d_log("Path found `%s`", path.c_str());
-    if (ESP_FileSystem::exists(pathWithGz.c_str())) {
-      request->send(ESP_FileSystem::open(pathWithGz.c_str(), "r"), contentType, true); // Use send with File and gzip encoding
+    if (entry.variant == ESP3DPathVariant::gzip) {
+      request->send(ESP_FileSystem::open(pathWithGz.c_str(), "r"), entry.contentType, true); // Use send with File and gzip encoding
       esp3d_log("Path is gz `%s`", pathWithGz.c_str());
       return;
     }
-    if (!StreamFSFile(path.c_str(), contentType.c_str(), request)) {
+    if (!StreamFSFile(path.c_str(), entry.contentType, request)) {
       esp3d_log_e("Stream `%s` failed", path.c_str());
       request->send(500, "text/plain", "Stream failed");
     }
@@ -73,8 +75,11 @@ void HTTP_Server::handle_not_found(AsyncWebServerRequest *request) {
     if (ESP_SD::accessFS()) {
       if (ESP_SD::getState(true) != ESP_SDCARD_NOT_PRESENT) {
         ESP_SD::setState(ESP_SDCARD_BUSY);
-        if (ESP_SD::exists(pathWithGz.c_str()) || ESP_SD::exists(path.c_str())) {
-          if (ESP_SD::exists(pathWithGz.c_str())) {
+        const ESP3DPathEntry &sdEntry =
+            esp3d_path_cache.resolve(FS_SD, path.c_str());
+        const char *contentType = sdEntry.contentType;
+        if (sdEntry.variant != ESP3DPathVariant::none) {
+          if (sdEntry.variant == ESP3DPathVariant::gzip) {
             request->send(ESP_SD::open(pathWithGz.c_str(), "r"), contentType, true); // Use send with File and gzip encoding
             path = pathWithGz;
           } else {
@@ -83,7 +88,7 @@ void HTTP_Server::handle_not_found(AsyncWebServerRequest *request) {
 #if defined(ESP3DLIB_ENV) && COMMUNICATION_PROTOCOL == SOCKET_SERIAL
           Serial2Socket.pause();
 #endif  // ESP3DLIB_ENV && COMMUNICATION_PROTOCOL == SOCKET_SERIAL
-          if (!StreamSDFile(path.c_str(), contentType.c_str(), request)) {
+          if (!StreamSDFile(path.c_str(), contentType, request)) {
             esp3d_log_e("Stream `%s` failed", path.c_str());
             request->send(500, "text/plain", "Stream failed");
           }
@@ -102,14 +107,15 @@ void HTTP_Server::handle_not_found(AsyncWebServerRequest *request) {
 #ifdef FILESYSTEM_FEATURE
   // Check local 404 page
   path = "/404.htm";
-  contentType = esp3d_string::getContentType(path.c_str());
   pathWithGz = path + ".gz";
-  if (ESP_FileSystem::exists(pathWithGz.c_str()) || ESP_FileSystem::exists(path.c_str())) {
-    if (ESP_FileSystem::exists(pathWithGz.c_str())) {
-      request->send(ESP_FileSystem::open(pathWithGz.c_str(), "r"), contentType, true); // Use send with File and gzip encoding
+  const ESP3DPathEntry &notFound =
+      esp3d_path_cache.resolve(FS_FLASH, path.c_str());
+  if (notFound.variant != ESP3DPathVariant::none) {
+    if (notFound.variant == ESP3DPathVariant::gzip) {
+      request->send(ESP_FileSystem::open(pathWithGz.c_str(), "r"), notFound.contentType, true); // Use send with File and gzip encoding
       path = pathWithGz;
     } else {
-      if (!StreamFSFile(path.c_str(), contentType.c_str(), request)) {
+      if (!StreamFSFile(path.c_str(), notFound.contentType, request)) {
         esp3d_log_e("Stream `%s` failed", path.c_str());
         request->send(500, "text/plain", "Stream failed");
       }
@@ -23,6 +23,9 @@
 #include <ESPAsyncWebServer.h>
 #include "../../authentication/authentication_service.h"
 #include "../../filesystem/esp_filesystem.h"
+#if defined(GCODE_INDEX_FEATURE)
+#include "../../gcode_host/gcode_index.h"
+#endif  // GCODE_INDEX_FEATURE
 
 #ifdef FILESYSTEM_TIMESTAMP_FEATURE
 #include "../../time/time_service.h"
@@ -80,6 +83,9 @@ void HTTP_Server::handleFSFileList(AsyncWebServerRequest *request) {
       } else {
         if (ESP_FileSystem::remove(filename.c_str())) {
           status = shortname + " deleted";
+#if defined(GCODE_INDEX_FEATURE)
+          ESP3DGcodeIndex::removeFor<ESP_FileSystem>(filename.c_str());
+#endif  // GCODE_INDEX_FEATURE
           String ptmp = path;
           if (path != "/" && path[path.length() - 1] == '/') {
             ptmp = path.substring(0, path.length() - 1);
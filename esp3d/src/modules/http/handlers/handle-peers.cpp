@@ -0,0 +1,79 @@
+/*
+ handle-peers.cpp - ESP3D http handle
+
+ Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with This code; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "../../../include/esp3d_config.h"
+#if defined(HTTP_FEATURE) && defined(MDNS_FEATURE)
+#include "../http_server.h"
+#include <ESPAsyncWebServer.h>
+#include "../../authentication/authentication_service.h"
+#include "../../mDNS/mDNS.h"
+
+static void printJsonString(Print &out, const char *s) {
+  out.print('"');
+  for (; *s; s++) {
+    if (*s == '"' || *s == '\\') {
+      out.print('\\');
+      out.print(*s);
+    } else if ((uint8_t)*s < 0x20) {
+      out.printf("\\u%04x", (uint8_t)*s);
+    } else {
+      out.print(*s);
+    }
+  }
+  out.print('"');
+}
+
+// Handle ESP3D peers query /peers, list comes from mDNS discovery cache
+// so a dashboard get the whole printers farm without querying each one
+void HTTP_Server::handle_peers(AsyncWebServerRequest *request) {
+  if (AuthenticationService::getAuthenticatedLevel() == ESP3DAuthenticationLevel::guest) {
+    request->send(401, "text/plain", "Wrong authentication!");
+    return;
+  }
+  if (request->hasParam("refresh")) {
+    // Answer comes with next discovery, current list is sent meanwhile
+    esp3d_mDNS.requestRefresh();
+  }
+  AsyncResponseStream *response = request->beginResponseStream("application/json");
+  response->addHeader("Cache-Control", "no-cache");
+  response->print("{\"hostname\":");
+  printJsonString(*response, esp3d_mDNS.hostname());
+  response->printf(",\"refreshing\":%s,\"age\":%u,\"peers\":[",
+                   esp3d_mDNS.isRefreshing() ? "true" : "false",
+                   esp3d_mDNS.hasPeers() ? (unsigned int)esp3d_mDNS.lastRefreshAge() : 0);
+  for (uint8_t i = 0; i < esp3d_mDNS.peersCount(); i++) {
+    const ESP3DmDNSPeer *peer = esp3d_mDNS.peer(i);
+    response->print(i > 0 ? ",{\"hostname\":" : "{\"hostname\":");
+    printJsonString(*response, peer->hostname);
+    response->printf(",\"ip\":\"%s\",\"port\":%u,\"seen\":%u,\"txt\":{", peer->ip,
+                     peer->port, (unsigned int)(millis() - peer->lastSeen));
+    for (uint8_t t = 0; t < peer->txtCount; t++) {
+      if (t > 0) {
+        response->print(',');
+      }
+      printJsonString(*response, peer->txtKey[t]);
+      response->print(':');
+      printJsonString(*response, peer->txtValue[t]);
+    }
+    response->print("}}");
+  }
+  response->print("]}");
+  request->send(response);
+}
+#endif  // HTTP_FEATURE && MDNS_FEATURE
@@ -0,0 +1,39 @@
+/*
+ handle-queue.cpp - ESP3D http handle
+
+ Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with This code; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "../../../include/esp3d_config.h"
+#if defined(HTTP_FEATURE) && defined(PRINT_QUEUE_FEATURE)
+#include "../http_server.h"
+#include <ESPAsyncWebServer.h>
+#include "../../authentication/authentication_service.h"
+#include "../../gcode_host/gcode_host.h"
+
+// Handle print queue query /queue, jobs are listed in printing order
+void HTTP_Server::handle_queue(AsyncWebServerRequest *request) {
+  if (AuthenticationService::getAuthenticatedLevel() == ESP3DAuthenticationLevel::guest) {
+    request->send(401, "text/plain", "Wrong authentication!");
+    return;
+  }
+  AsyncWebServerResponse *response = request->beginResponse(
+      200, "application/json",
+      esp3d_gcode_host.queue().toString(true, esp3d_gcode_host.currentJobId()));
+  response->addHeader("Cache-Control", "no-cache");
+  request->send(response);
+}
+#endif  // HTTP_FEATURE && PRINT_QUEUE_FEATURE
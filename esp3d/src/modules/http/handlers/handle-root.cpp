@@ -24,6 +24,7 @@
 #include "../embedded.h"
 #include "../../../core/esp3d_string.h"
 #include "../../filesystem/esp_filesystem.h"
+#include "../path_cache.h"
 
 // Root of Webserver
 void HTTP_Server::handle_root(AsyncWebServerRequest *request) {
@@ -37,17 +38,17 @@ void HTTP_Server::handle_root(AsyncWebServerRequest *request) {
     path += "/";
   }
   path += "index.html";
-  String contentType = esp3d_string::getContentType(path.c_str());
-  String pathWithGz = path + ".gz";
-  if ((ESP_FileSystem::exists(pathWithGz.c_str()) || ESP_FileSystem::exists(path.c_str())) &&
+  const ESP3DPathEntry &entry =
+      esp3d_path_cache.resolve(FS_FLASH, path.c_str());
+  if (entry.variant != ESP3DPathVariant::none &&
       (!request->hasParam("forcefallback") || request->getParam("forcefallback")->value() != "yes")) {
     esp3d_log("Path found `%s`", path.c_str());
-    if (ESP_FileSystem::exists(pathWithGz.c_str())) {
+    if (entry.variant == ESP3DPathVariant::gzip) {
       request->addResponseHeader("Content-Encoding", "gzip");
-      path = pathWithGz;
+      path += ".gz";
       esp3d_log("Path is gz `%s`", path.c_str());
     }
-    if (!StreamFSFile(path.c_str(), contentType.c_str(), request)) {
+    if (!StreamFSFile(path.c_str(), entry.contentType, request)) {
       esp3d_log_e("Stream `%s` failed", path.c_str());
       request->send(500, "text/plain", "Stream failed");
     }
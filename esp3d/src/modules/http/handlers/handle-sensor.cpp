@@ -0,0 +1,53 @@
+/*
+ handle-sensor.cpp - ESP3D http handle
+
+ Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with This code; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "../../../include/esp3d_config.h"
+#if defined(HTTP_FEATURE) && defined(SENSOR_DEVICE)
+#include "../http_server.h"
+#include <ESPAsyncWebServer.h>
+#include "../../authentication/authentication_service.h"
+#include "../../sensor/sensor.h"
+
+// Handle sensor history query /sensor?since=xxx&resolution=raw/1m/15m
+// answer is generated chunk by chunk from history, no copy is made
+void HTTP_Server::handle_sensor(AsyncWebServerRequest *request) {
+  if (AuthenticationService::getAuthenticatedLevel() == ESP3DAuthenticationLevel::guest) {
+    request->send(401, "text/plain", "Wrong authentication!");
+    return;
+  }
+  uint32_t since = 0;
+  ESP3DSensorResolution resolution = ESP3DSensorResolution::raw;
+  if (request->hasParam("since")) {
+    since = strtoul(request->getParam("since")->value().c_str(), nullptr, 10);
+  }
+  if (request->hasParam("resolution") &&
+      !ESP3DSensorHistory::getResolution(request->getParam("resolution")->value().c_str(), resolution)) {
+    request->send(400, "text/plain", "Invalid resolution");
+    return;
+  }
+  ESP3DSensorCursor cursor;
+  esp3d_sensor.history().initCursor(cursor, resolution, since, true);
+  AsyncWebServerResponse *response = request->beginChunkedResponse(
+      "application/json", [cursor](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+        return esp3d_sensor.history().read(cursor, (char *)buffer, maxLen);
+      });
+  response->addHeader("Cache-Control", "no-cache");
+  request->send(response);
+}
+#endif  // HTTP_FEATURE && SENSOR_DEVICE
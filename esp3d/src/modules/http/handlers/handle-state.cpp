@@ -0,0 +1,39 @@
+/*
+ handle-state.cpp - ESP3D http handle
+
+ Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with This code; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include "../../../include/esp3d_config.h"
+#if defined(HTTP_FEATURE) && defined(PRINTER_STATE_FEATURE)
+#include "../http_server.h"
+#include <ESPAsyncWebServer.h>
+#include "../../authentication/authentication_service.h"
+#include "../../printer_state/printer_state.h"
+
+// Handle printer state query /state, answer comes from cache
+// so any number of clients does not add queries to printer
+void HTTP_Server::handle_state(AsyncWebServerRequest *request) {
+  if (AuthenticationService::getAuthenticatedLevel() == ESP3DAuthenticationLevel::guest) {
+    request->send(401, "text/plain", "Wrong authentication!");
+    return;
+  }
+  AsyncWebServerResponse *response =
+      request->beginResponse(200, "application/json", esp3d_printer_state.toString(true));
+  response->addHeader("Cache-Control", "no-cache");
+  request->send(response);
+}
+#endif  // HTTP_FEATURE && PRINTER_STATE_FEATURE
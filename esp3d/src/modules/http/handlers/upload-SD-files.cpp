@@ -29,6 +29,9 @@
 #endif  // ARDUINO_ARCH_ESP8266
 #include "../../authentication/authentication_service.h"
 #include "../../filesystem/esp_sd.h"
+#if defined(GCODE_INDEX_FEATURE)
+#include "../../gcode_host/gcode_index.h"
+#endif  // GCODE_INDEX_FEATURE
 
 #ifdef ESP_BENCHMARK_FEATURE
 #include "../../../core/esp3d_benchmark.h"
@@ -38,6 +41,66 @@
 #endif  // ESP3DLIB_ENV && COMMUNICATION_PROTOCOL == SOCKET_SERIAL
 #include "../../websocket/websocket_server.h"
 
+// Upload chunks are accumulated so the card only gets writes of
+// ESP_SD_WRITE_BUFFER_SIZE (sector multiple) until the final flush
+static uint8_t* sd_write_buffer = nullptr;
+static size_t sd_write_buffer_pos = 0;
+
+static void freeWriteBuffer() {
+  if (sd_write_buffer) {
+    free(sd_write_buffer);
+    sd_write_buffer = nullptr;
+  }
+  sd_write_buffer_pos = 0;
+}
+
+static bool flushWriteBuffer(ESP_SDFile& file) {
+  if (!sd_write_buffer || sd_write_buffer_pos == 0) {
+    return true;
+  }
+  size_t written = file.write(sd_write_buffer, sd_write_buffer_pos);
+  if (written != sd_write_buffer_pos) {
+    esp3d_log_e("File write failed du to mismatch size %d vs %d", written,
+                sd_write_buffer_pos);
+    return false;
+  }
+  sd_write_buffer_pos = 0;
+  return true;
+}
+
+static bool bufferedWrite(ESP_SDFile& file, const uint8_t* data, size_t size) {
+  if (!sd_write_buffer) {
+    // no buffer available, write as it comes
+    return file.write(data, size) == size;
+  }
+  while (size > 0) {
+    if (sd_write_buffer_pos == 0 && size >= ESP_SD_WRITE_BUFFER_SIZE) {
+      // already aligned, no need to copy full blocks
+      size_t blocks = size - (size % ESP_SD_WRITE_BUFFER_SIZE);
+      if (file.write(data, blocks) != blocks) {
+        esp3d_log_e("File write failed for %d bytes", blocks);
+        return false;
+      }
+      data += blocks;
+      size -= blocks;
+      continue;
+    }
+    size_t len = ESP_SD_WRITE_BUFFER_SIZE - sd_write_buffer_pos;
+    if (len > size) {
+      len = size;
+    }
+    memcpy(sd_write_buffer + sd_write_buffer_pos, data, len);
+    sd_write_buffer_pos += len;
+    data += len;
+    size -= len;
+    if (sd_write_buffer_pos == ESP_SD_WRITE_BUFFER_SIZE &&
+        !flushWriteBuffer(file)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // SD files uploader handle
 void HTTP_Server::SDFileupload() {
 #ifdef ESP_BENCHMARK_FEATURE
@@ -50,6 +113,9 @@ void HTTP_Server::SDFileupload() {
       AuthenticationService::getAuthenticatedLevel();
   static String filename;
   static ESP_SDFile fsUploadFile;
+#if defined(GCODE_INDEX_FEATURE)
+  static ESP3DGcodeIndex uploadIndex;
+#endif  // GCODE_INDEX_FEATURE
   // Guest cannot upload - only admin
   if (auth_level == ESP3DAuthenticationLevel::guest) {
     pushError(ESP_ERROR_AUTHENTICATION, "Upload rejected", 401);
@@ -157,6 +223,26 @@ void HTTP_Server::SDFileupload() {
             // if yes upload is started
             _upload_status = UPLOAD_STATUS_ONGOING;
             esp3d_log("Try file creation");
+            // reserve contiguous clusters if size is known
+            if (_webserver->hasArg(sizeargname.c_str())) {
+              uint64_t filesize =
+                  strtoull(_webserver->arg(sizeargname.c_str()).c_str(),
+                           nullptr, 10);
+              if (fsUploadFile.preAllocate(filesize)) {
+                esp3d_log("Preallocated %u bytes", (uint32_t)filesize);
+              }
+            }
+            freeWriteBuffer();
+            sd_write_buffer = (uint8_t*)malloc(ESP_SD_WRITE_BUFFER_SIZE);
+            if (!sd_write_buffer) {
+              esp3d_log_e("No write buffer, use direct write");
+            }
+#if defined(GCODE_INDEX_FEATURE)
+            // layers are indexed while data are received
+            if (ESP3DGcodeIndex::isGcodeFile(filename.c_str())) {
+              uploadIndex.begin();
+            }
+#endif  // GCODE_INDEX_FEATURE
           } else {
             // if no set cancel flag
             _upload_status = UPLOAD_STATUS_FAILED;
@@ -177,14 +263,14 @@ void HTTP_Server::SDFileupload() {
             last_WS_update = millis();
           }
           // no error so write post date
-          int writeddatanb = fsUploadFile.write(upload.buf, upload.currentSize);
-          if (upload.currentSize != (size_t)writeddatanb) {
+          if (!bufferedWrite(fsUploadFile, upload.buf, upload.currentSize)) {
             // we have a problem set flag UPLOAD_STATUS_FAILED
-            esp3d_log_e("File write failed du to mismatch size %d vs %d",
-                        writeddatanb, upload.currentSize);
             _upload_status = UPLOAD_STATUS_FAILED;
             pushError(ESP_ERROR_FILE_WRITE, "File write failed");
           }
+#if defined(GCODE_INDEX_FEATURE)
+          uploadIndex.feed(upload.buf, upload.currentSize);
+#endif  // GCODE_INDEX_FEATURE
         } else {
           // we have a problem set flag UPLOAD_STATUS_FAILED
           _upload_status = UPLOAD_STATUS_FAILED;
@@ -196,7 +282,12 @@ void HTTP_Server::SDFileupload() {
         uint32_t filesize = 0;
         // check if file is still open
         if (fsUploadFile) {
-          // close it
+          // write what remains in buffer then close it
+          if (!flushWriteBuffer(fsUploadFile)) {
+            _upload_status = UPLOAD_STATUS_FAILED;
+            pushError(ESP_ERROR_FILE_WRITE, "File write failed");
+          }
+          freeWriteBuffer();
           fsUploadFile.close();
 #ifdef ESP_BENCHMARK_FEATURE
           benchMark("SD upload", bench_start, millis(), bench_transfered);
@@ -205,7 +296,9 @@ void HTTP_Server::SDFileupload() {
           String sizeargname = upload.filename + "S";
           // fsUploadFile = ESP_SD::open (filename, ESP_FILE_READ);
           filesize = fsUploadFile.size();
-          _upload_status = UPLOAD_STATUS_SUCCESSFUL;
+          if (_upload_status == UPLOAD_STATUS_ONGOING) {
+            _upload_status = UPLOAD_STATUS_SUCCESSFUL;
+          }
           if (_webserver->hasArg(sizeargname.c_str())) {
             if (_webserver->arg(sizeargname.c_str()) != String(filesize)) {
               _upload_status = UPLOAD_STATUS_FAILED;
@@ -215,6 +308,14 @@ void HTTP_Server::SDFileupload() {
           if (_upload_status == UPLOAD_STATUS_ONGOING) {
             _upload_status = UPLOAD_STATUS_SUCCESSFUL;
           }
+#if defined(GCODE_INDEX_FEATURE)
+          if (_upload_status == UPLOAD_STATUS_SUCCESSFUL &&
+              ESP3DGcodeIndex::isGcodeFile(filename.c_str())) {
+            uploadIndex.end();
+            uploadIndex.saveFor<ESP_SD>(filename.c_str());
+          }
+          uploadIndex.clear();
+#endif  // GCODE_INDEX_FEATURE
         } else {
           // we have a problem set flag UPLOAD_STATUS_FAILED
           _upload_status = UPLOAD_STATUS_FAILED;
@@ -241,6 +342,10 @@ void HTTP_Server::SDFileupload() {
 
   if (_upload_status == UPLOAD_STATUS_FAILED) {
     cancelUpload();
+    freeWriteBuffer();
+#if defined(GCODE_INDEX_FEATURE)
+    uploadIndex.clear();
+#endif  // GCODE_INDEX_FEATURE
     if (fsUploadFile) {
       fsUploadFile.close();
     }
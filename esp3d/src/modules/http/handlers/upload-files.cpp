@@ -23,6 +23,9 @@
 #include <ESPAsyncWebServer.h>
 #include "../../authentication/authentication_service.h"
 #include "../../filesystem/esp_filesystem.h"
+#if defined(GCODE_INDEX_FEATURE)
+#include "../../gcode_host/gcode_index.h"
+#endif  // GCODE_INDEX_FEATURE
 
 #if defined(ESP3DLIB_ENV) && COMMUNICATION_PROTOCOL == SOCKET_SERIAL
 #include "../../serial2socket/serial2socket.h"
@@ -40,6 +43,9 @@ void HTTP_Server::FSFileupload(AsyncWebServerRequest *request, const String& fil
 #endif  // ESP_BENCHMARK_FEATURE
   static String upload_filename;
   static ESP_File fsUploadFile;
+#if defined(GCODE_INDEX_FEATURE)
+  static ESP3DGcodeIndex uploadIndex;
+#endif  // GCODE_INDEX_FEATURE
   ESP3DAuthenticationLevel auth_level = AuthenticationService::getAuthenticatedLevel();
   
   if (auth_level == ESP3DAuthenticationLevel::guest) {
@@ -115,6 +121,13 @@ void HTTP_Server::FSFileupload(AsyncWebServerRequest *request, const String& fil
           _upload_status = UPLOAD_STATUS_FAILED;
           pushError(ESP_ERROR_FILE_CREATION, "File creation failed");
         }
+#if defined(GCODE_INDEX_FEATURE)
+        // layers are indexed while data are received
+        if (fsUploadFile &&
+            ESP3DGcodeIndex::isGcodeFile(upload_filename.c_str())) {
+          uploadIndex.begin();
+        }
+#endif  // GCODE_INDEX_FEATURE
       }
     }
   }
@@ -127,6 +140,9 @@ void HTTP_Server::FSFileupload(AsyncWebServerRequest *request, const String& fil
       _upload_status = UPLOAD_STATUS_FAILED;
       pushError(ESP_ERROR_FILE_WRITE, "File write failed");
     }
+#if defined(GCODE_INDEX_FEATURE)
+    uploadIndex.feed(data, len);
+#endif  // GCODE_INDEX_FEATURE
   }
 
   if (final) {
@@ -157,6 +173,14 @@ void HTTP_Server::FSFileupload(AsyncWebServerRequest *request, const String& fil
       _upload_status = UPLOAD_STATUS_FAILED;
       pushError(ESP_ERROR_FILE_CLOSE, "File close failed");
     }
+#if defined(GCODE_INDEX_FEATURE)
+    if (_upload_status == UPLOAD_STATUS_SUCCESSFUL &&
+        ESP3DGcodeIndex::isGcodeFile(upload_filename.c_str())) {
+      uploadIndex.end();
+      uploadIndex.saveFor<ESP_FileSystem>(upload_filename.c_str());
+    }
+    uploadIndex.clear();
+#endif  // GCODE_INDEX_FEATURE
 #if defined(ESP3DLIB_ENV) && COMMUNICATION_PROTOCOL == SOCKET_SERIAL
     Serial2Socket.pause(false);
 #endif  // ESP3DLIB_ENV && COMMUNICATION_PROTOCOL == SOCKET_SERIAL
@@ -168,6 +192,9 @@ void HTTP_Server::FSFileupload(AsyncWebServerRequest *request, const String& fil
 
   if (_upload_status == UPLOAD_STATUS_FAILED) {
     cancelUpload();
+#if defined(GCODE_INDEX_FEATURE)
+    uploadIndex.clear();
+#endif  // GCODE_INDEX_FEATURE
     if (fsUploadFile) {
       fsUploadFile.close();
     }
@@ -31,9 +31,6 @@
 
 // MKS files uploader handle
 void HTTP_Server::MKSFileupload() {
-  static uint32_t fragmentID = 0;
-  static uint8_t buf2send[MKS_FRAME_DATA_MAX_SIZE];
-  static size_t buf2sendlen = 0;
   // get authentication status
   ESP3DAuthenticationLevel auth_level =
       AuthenticationService::getAuthenticatedLevel();
@@ -44,7 +41,6 @@ void HTTP_Server::MKSFileupload() {
   } else {
     HTTPUpload& upload = _webserver->upload();
     if (upload.status == UPLOAD_FILE_START) {
-      buf2sendlen = 0;
       esp3d_log("Starting upload");
       _upload_status = UPLOAD_STATUS_ONGOING;
       size_t fileSize = 0;
@@ -85,48 +81,29 @@ void HTTP_Server::MKSFileupload() {
       } else if (_webserver->hasHeader("Content-Length")) {
         fileSize = _webserver->header("Content-Length").toInt();
       }
-      fragmentID = 0;
       esp3d_log("Filename: %s Size:%d", filename.c_str(), fileSize);
-      if (MKSService::sendFirstFragment(filename.c_str(), fileSize)) {
-        MKSService::uploadMode();
+      if (!MKSService::startUpload(filename.c_str(), fileSize)) {
+        _upload_status = UPLOAD_STATUS_FAILED;
+        pushError(ESP_ERROR_FILE_CREATION, "File creation failed");
       }
     } else if (upload.status == UPLOAD_FILE_WRITE) {
       if (_upload_status == UPLOAD_STATUS_ONGOING) {
-        uint currentsize = upload.currentSize;
-        uint8_t* currentBuffer = upload.buf;
-        while ((currentsize > 0) && (_upload_status == UPLOAD_STATUS_ONGOING)) {
-          while ((buf2sendlen < MKS_FRAME_DATA_MAX_SIZE) && currentsize > 0) {
-            buf2send[buf2sendlen] = currentBuffer[0];
-            buf2sendlen++;
-            currentsize--;
-            currentBuffer++;
-          }
-          if (buf2sendlen == MKS_FRAME_DATA_MAX_SIZE) {
-            esp3d_log("Send %d chars in Fragment %d", buf2sendlen, fragmentID);
-            if (MKSService::sendFragment(buf2send, buf2sendlen, fragmentID)) {
-              buf2sendlen = 0;
-              fragmentID++;
-            } else {
-              _upload_status = UPLOAD_STATUS_FAILED;
-              pushError(ESP_ERROR_FILE_WRITE, "File write failed");
-            }
-          }
-          ESP3DHal::wait(0);
+        if (!MKSService::uploadData(upload.buf, upload.currentSize)) {
+          _upload_status = UPLOAD_STATUS_FAILED;
+          pushError(ESP_ERROR_FILE_WRITE, "File write failed");
         }
       }
 
     } else if (upload.status == UPLOAD_FILE_END) {
       if (_upload_status == UPLOAD_STATUS_ONGOING) {
         esp3d_log("Upload end");
-        fragmentID = MKSService::getFragmentID(fragmentID, true);
-        esp3d_log("Send %d chars in Fragment %d", buf2sendlen, fragmentID);
-        if (MKSService::sendFragment(buf2send, buf2sendlen, fragmentID)) {
+        if (MKSService::endUpload(true)) {
           _upload_status = UPLOAD_STATUS_SUCCESSFUL;
+          esp3d_log("Upload speed: %d B/s", MKSService::uploadRate());
         } else {
           _upload_status = UPLOAD_STATUS_FAILED;
           pushError(ESP_ERROR_FILE_CLOSE, "File close failed");
         }
-        MKSService::commandMode();
       }
     } else {
       // error
@@ -136,10 +113,7 @@ void HTTP_Server::MKSFileupload() {
   }
   if (_upload_status == UPLOAD_STATUS_FAILED) {
     cancelUpload();
-    // TBC need to do that
-    // MKSService::sendFragment(nullptr,0,MKSService::getFragmentID(fragmentID,
-    // true));
-    MKSService::commandMode();
+    MKSService::endUpload(false);
   }
 }
 #endif  // HTTP_FEATURE && (COMMUNICATION_PROTOCOL == MKS_SERIAL)
@@ -79,6 +79,25 @@ void HTTP_Server::init_handlers() {
       });
 #endif
   _webserver->on("/logs", HTTP_ANY, [](AsyncWebServerRequest *request) { handle_logs(request); });
+#ifdef PRINTER_STATE_FEATURE
+  _webserver->on("/state", HTTP_GET, [](AsyncWebServerRequest *request) { handle_state(request); });
+#endif
+#ifdef GCODE_HOST_FEATURE
+  _webserver->on(
+      "/batch", HTTP_POST, [](AsyncWebServerRequest *request) { handle_batch(request); }, nullptr,
+      [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+        BatchBody(request, data, len, index, total);
+      });
+#endif
+#ifdef PRINT_QUEUE_FEATURE
+  _webserver->on("/queue", HTTP_GET, [](AsyncWebServerRequest *request) { handle_queue(request); });
+#endif
+#ifdef MDNS_FEATURE
+  _webserver->on("/peers", HTTP_GET, [](AsyncWebServerRequest *request) { handle_peers(request); });
+#endif
+#ifdef SENSOR_DEVICE
+  _webserver->on("/sensor", HTTP_GET, [](AsyncWebServerRequest *request) { handle_sensor(request); });
+#endif
 #ifdef SD_DEVICE
   _webserver->on(
       "/sdfiles", HTTP_ANY,
@@ -100,11 +119,7 @@ void HTTP_Server::init_handlers() {
 
 bool HTTP_Server::StreamFSFile(const char* filename, const char* contentType, AsyncWebServerRequest *request) {
 #ifdef FILESYSTEM_FEATURE
-  if (!ESP_FileSystem::exists(filename)) {
-    esp3d_log_e("File %s does not exist", filename);
-    request->send(404, "text/plain", "File not found");
-    return false;
-  }
+  // filename was resolved by esp3d_path_cache, so it is not checked again
   AsyncWebServerResponse *response = request->beginResponse(ESP_FileSystem::open(filename, ESP_FILE_READ), filename, contentType);
   request->send(response);
   esp3d_log("Streaming file %s with content type %s", filename, contentType);
@@ -30,6 +30,16 @@
 #define WEBSERVER AsyncWebServer
 #endif
 
+// Biggest body accepted by /batch
+#ifndef ESP3D_BATCH_MAX_SIZE
+#define ESP3D_BATCH_MAX_SIZE 8192
+#endif  // ESP3D_BATCH_MAX_SIZE
+
+// Longest time /batch?wait=1 waits for batch to be done (ms)
+#ifndef ESP3D_BATCH_TIMEOUT
+#define ESP3D_BATCH_TIMEOUT 60000
+#endif  // ESP3D_BATCH_TIMEOUT
+
 // Upload status
 typedef enum {
   UPLOAD_STATUS_NONE = 0,
@@ -65,6 +75,22 @@ class HTTP_Server {
 #ifdef CAMERA_DEVICE
   static void handle_snap(AsyncWebServerRequest *request);
 #endif  // CAMERA_DEVICE
+#ifdef SENSOR_DEVICE
+  static void handle_sensor(AsyncWebServerRequest *request);
+#endif  // SENSOR_DEVICE
+#ifdef MDNS_FEATURE
+  static void handle_peers(AsyncWebServerRequest *request);
+#endif  // MDNS_FEATURE
+#ifdef PRINTER_STATE_FEATURE
+  static void handle_state(AsyncWebServerRequest *request);
+#endif  // PRINTER_STATE_FEATURE
+#ifdef GCODE_HOST_FEATURE
+  static void handle_batch(AsyncWebServerRequest *request);
+  static void BatchBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+#endif  // GCODE_HOST_FEATURE
+#ifdef PRINT_QUEUE_FEATURE
+  static void handle_queue(AsyncWebServerRequest *request);
+#endif  // PRINT_QUEUE_FEATURE
   static void init_handlers();
   static bool StreamFSFile(const char* filename, const char* contentType, AsyncWebServerRequest *request);
   static void handle_root(AsyncWebServerRequest *request);
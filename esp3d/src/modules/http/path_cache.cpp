@@ -0,0 +1,161 @@
+/*
+  path_cache.cpp -  static files path resolution cache class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+// #define ESP_LOG_FEATURE LOG_OUTPUT_SERIAL0
+#include "../../include/esp3d_config.h"
+#if defined(HTTP_FEATURE)
+#include <string.h>
+
+#include "../../core/esp3d_string.h"
+#include "path_cache.h"
+#if defined(FILESYSTEM_FEATURE)
+#include "../filesystem/esp_filesystem.h"
+#endif  // FILESYSTEM_FEATURE
+#if defined(SD_DEVICE)
+#include "../filesystem/esp_sd.h"
+#endif  // SD_DEVICE
+
+ESP3DPathCache esp3d_path_cache;
+
+ESP3DPathCache::ESP3DPathCache() {
+  memset(&_uncached, 0, sizeof(_uncached));
+  _fsGeneration = 0;
+  _sdGeneration = 0;
+  clear();
+}
+
+void ESP3DPathCache::clear() {
+  memset(_entries, 0, sizeof(_entries));
+  _useCounter = 0;
+  _hits = 0;
+  _misses = 0;
+}
+
+// Drop entries of a filesystem changed since they were resolved
+void ESP3DPathCache::checkGeneration() {
+  uint8_t changed[2] = {0, 0};
+#if defined(FILESYSTEM_FEATURE)
+  if (ESP_FileSystem::generation() != _fsGeneration) {
+    _fsGeneration = ESP_FileSystem::generation();
+    changed[0] = FS_FLASH;
+  }
+#endif  // FILESYSTEM_FEATURE
+#if defined(SD_DEVICE)
+  if (ESP_SD::generation() != _sdGeneration) {
+    _sdGeneration = ESP_SD::generation();
+    changed[1] = FS_SD;
+  }
+#endif  // SD_DEVICE
+  if (changed[0] == 0 && changed[1] == 0) {
+    return;
+  }
+  for (uint8_t i = 0; i < ESP3D_PATH_CACHE_SIZE; i++) {
+    if (_entries[i].fs == changed[0] || _entries[i].fs == changed[1]) {
+      esp3d_log("Drop cached path %s", _entries[i].path);
+      _entries[i].path[0] = '\0';
+      _entries[i].fs = 0;
+    }
+  }
+}
+
+ESP3DPathEntry* ESP3DPathCache::find(uint8_t fs, const char* path) {
+  for (uint8_t i = 0; i < ESP3D_PATH_CACHE_SIZE; i++) {
+    if (_entries[i].fs == fs && strcmp(_entries[i].path, path) == 0) {
+      return &_entries[i];
+    }
+  }
+  return nullptr;
+}
+
+// Empty entry or least recently used one
+ESP3DPathEntry* ESP3DPathCache::slot() {
+  ESP3DPathEntry* oldest = &_entries[0];
+  for (uint8_t i = 0; i < ESP3D_PATH_CACHE_SIZE; i++) {
+    if (_entries[i].path[0] == '\0') {
+      return &_entries[i];
+    }
+    if (_entries[i].lastUse < oldest->lastUse) {
+      oldest = &_entries[i];
+    }
+  }
+  return oldest;
+}
+
+template <typename FS>
+void ESP3DPathCache::lookup(ESP3DPathEntry& entry, const char* path) {
+  String name = String(path) + ".gz";
+  for (uint8_t i = 0; i < 2; i++) {
+    if (FS::exists(name.c_str())) {
+      auto file = FS::open(name.c_str());
+      if (file && !file.isDirectory()) {
+        entry.variant =
+            (i == 0) ? ESP3DPathVariant::gzip : ESP3DPathVariant::plain;
+        entry.size = file.size();
+        entry.lastWrite = file.getLastWrite();
+        file.close();
+        return;
+      }
+      file.close();
+    }
+    name = path;
+  }
+}
+
+const ESP3DPathEntry& ESP3DPathCache::resolve(uint8_t fs, const char* path) {
+  checkGeneration();
+  ESP3DPathEntry* entry = nullptr;
+  if (strlen(path) < ESP3D_PATH_CACHE_PATH_SIZE) {
+    entry = find(fs, path);
+    if (entry && (fs != FS_SD ||
+                  millis() - entry->created < ESP3D_PATH_CACHE_SD_TTL)) {
+      _hits++;
+      entry->lastUse = ++_useCounter;
+      return *entry;
+    }
+    // expired entry is resolved again in place
+    if (!entry) {
+      entry = slot();
+      strcpy(entry->path, path);
+    }
+  } else {
+    entry = &_uncached;
+  }
+  _misses++;
+  entry->fs = fs;
+  entry->variant = ESP3DPathVariant::none;
+  entry->size = 0;
+  entry->lastWrite = 0;
+  entry->contentType = esp3d_string::getContentType(path);
+#if defined(FILESYSTEM_FEATURE)
+  if (fs == FS_FLASH) {
+    lookup<ESP_FileSystem>(*entry, path);
+  }
+#endif  // FILESYSTEM_FEATURE
+#if defined(SD_DEVICE)
+  if (fs == FS_SD) {
+    lookup<ESP_SD>(*entry, path);
+  }
+#endif  // SD_DEVICE
+  entry->lastUse = ++_useCounter;
+  entry->created = millis();
+  esp3d_log("Resolved %s: %d", path, (uint8_t)entry->variant);
+  return *entry;
+}
+
+#endif  // HTTP_FEATURE
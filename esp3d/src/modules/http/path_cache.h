@@ -0,0 +1,96 @@
+/*
+  path_cache.h -  static files path resolution cache class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _PATH_CACHE_H
+#define _PATH_CACHE_H
+
+#include <Arduino.h>
+#include <time.h>
+
+#include "../../include/esp3d_config.h"
+
+// Resolved paths kept, least recently used one is replaced
+#ifndef ESP3D_PATH_CACHE_SIZE
+#define ESP3D_PATH_CACHE_SIZE 16
+#endif  // ESP3D_PATH_CACHE_SIZE
+
+// SD can be changed by printer or card swap without ESP3D knowing it, so
+// SD entries are checked again after this delay (ms)
+#ifndef ESP3D_PATH_CACHE_SD_TTL
+#define ESP3D_PATH_CACHE_SD_TTL 10000
+#endif  // ESP3D_PATH_CACHE_SD_TTL
+
+// Longer paths are not cached
+#define ESP3D_PATH_CACHE_PATH_SIZE 64
+
+enum class ESP3DPathVariant : uint8_t {
+  // neither path nor path.gz is a file
+  none = 0,
+  plain = 1,
+  gzip = 2,
+};
+
+struct ESP3DPathEntry {
+  char path[ESP3D_PATH_CACHE_PATH_SIZE];
+  // FS_FLASH or FS_SD
+  uint8_t fs;
+  ESP3DPathVariant variant;
+  uint32_t size;
+  time_t lastWrite;
+  // content type of path, not of .gz
+  const char* contentType;
+  uint32_t lastUse;
+  uint32_t created;
+};
+
+// Which file serves a static path: path.gz, path or none, without the
+// exists() calls on each request
+// Entries of a filesystem are dropped when ESP_FileSystem / ESP_SD
+// generation changes
+// Only used by web server task, so there is no lock
+class ESP3DPathCache {
+ public:
+  ESP3DPathCache();
+  // Filesystem must be accessible, for SD accessFS() must be done
+  // Returned entry is valid until next call
+  const ESP3DPathEntry& resolve(uint8_t fs, const char* path);
+  void clear();
+  uint32_t hits() { return _hits; }
+  uint32_t misses() { return _misses; }
+
+ private:
+  ESP3DPathEntry* find(uint8_t fs, const char* path);
+  ESP3DPathEntry* slot();
+  void checkGeneration();
+  template <typename FS>
+  static void lookup(ESP3DPathEntry& entry, const char* path);
+  ESP3DPathEntry _entries[ESP3D_PATH_CACHE_SIZE];
+  // result of paths which cannot be cached
+  ESP3DPathEntry _uncached;
+  uint32_t _useCounter;
+  uint32_t _fsGeneration;
+  uint32_t _sdGeneration;
+  uint32_t _hits;
+  uint32_t _misses;
+};
+
+extern ESP3DPathCache esp3d_path_cache;
+
+#endif  //_PATH_CACHE_H
@@ -25,6 +25,7 @@
 #include "../../core/esp3d_commands.h"
 #include "../../core/esp3d_hal.h"
 #include "../../core/esp3d_settings.h"
+#include "../gcode_host/gcode_host.h"
 #include "lua_interpreter_service.h"
 #if defined(NOTIFICATION_FEATURE)
 #include "../notifications/notifications_service.h"
@@ -47,6 +48,9 @@ LuaInterpreter::LuaInterpreter() {
   setupFunctions();
   registerConstants();
   _scriptBuffer = nullptr;
+  _outputBatch.reserve(ESP_LUA_OUTPUT_BATCH_SIZE);
+  _outputScriptId = 0;
+  _outputHeld = nullptr;
   _stateMutex = xSemaphoreCreateMutex();
   _messageInFIFO.setMaxSize(10);  // no limit
   _messageInFIFO.setId("in");
@@ -56,6 +60,9 @@ LuaInterpreter::LuaInterpreter() {
 
 LuaInterpreter::~LuaInterpreter() {
   deleteScriptTask();
+  if (_outputHeld) {
+    esp3d_message_manager.deleteMsg(_outputHeld);
+  }
   vSemaphoreDelete(_stateMutex);
 }
 
@@ -112,6 +119,7 @@ bool LuaInterpreter::executeScriptAsync(const char *script) {
   }
   _currentScriptName = script;
   _lastError  = "";
+  setupArena();
   if (!createScriptTask()) {
     if (_lastError.length() == 0) _lastError = "Failed to create script task";
     result = false;
@@ -145,6 +153,27 @@ bool LuaInterpreter::resumeScript() {
   return false;
 }
 
+// Pool is reserved when first script starts, so no memory is used
+// if no script is ever run
+void LuaInterpreter::setupArena() {
+  if (ESP_LUA_ARENA_SIZE == 0 || _arena.started()) {
+    return;
+  }
+  if (!_arena.begin(ESP_LUA_ARENA_SIZE)) {
+    esp3d_log_e("No memory for Lua arena, using heap");
+    return;
+  }
+  esp3d_log("Lua arena of %d bytes in %s", ESP_LUA_ARENA_SIZE,
+            _arena.inPsram() ? "PSRAM" : "RAM");
+  if (!_luaEngine.setArena(&_arena)) {
+    _arena.end();
+    return;
+  }
+  // state was recreated in arena
+  setupFunctions();
+  registerConstants();
+}
+
 void LuaInterpreter::resetLuaEnvironment() {
   _luaEngine.resetState();
   setupFunctions();
@@ -338,7 +367,8 @@ void LuaInterpreter::handle() {
   if (_luaEngine.isRunning() && notificationSent) {
     notificationSent = false;
   }
-  if (_messageOutFIFO.size() > 0 || _luaEngine.hasError()) {
+  if (_messageOutFIFO.size() > 0 || _outputHeld ||
+      _outputBatch.length() > 0 || _luaEngine.hasError()) {
     if (xSemaphoreTake(_stateMutex, portMAX_DELAY) == pdTRUE) {
       // Check if the script is in error state and if still running
       if (_luaEngine.hasError()) {
@@ -351,19 +381,110 @@ void LuaInterpreter::handle() {
         }
 #endif  // NOTIFICATION_FEATURE
       }
-      if (_messageOutFIFO.size() > 0) {
-        esp3d_log("lua_interpreter message size %d", _messageOutFIFO.size());
-      }
-      ESP3DMessage *msg = _messageOutFIFO.pop();
-      if (msg) {
-        esp3d_log("Processing message: %s", msg->data);
-        esp3d_commands.process(msg);
-      }
+      processOutput();
       xSemaphoreGive(_stateMutex);
     } else {
-    esp3d_log_e("Mutex not taken");
+      esp3d_log_e("Mutex not taken");
+    }
+  }
+}
+
+// Send queued output until queue is empty or budget is spent, ESP commands
+// are processed in order, G-code lines in between go to printer as one
+// G-code host script, so nothing more is sent until printer acknowledged them
+void LuaInterpreter::processOutput() {
+  uint32_t start = millis();
+  size_t count = 0;
+  while (count < ESP_LUA_OUTPUT_BUDGET &&
+         millis() - start < ESP_LUA_OUTPUT_TIME_BUDGET && isOutputAcked()) {
+    ESP3DMessage *msg = _outputHeld ? _outputHeld : _messageOutFIFO.pop();
+    _outputHeld = nullptr;
+    if (!msg) {
+      break;
+    }
+    count++;
+    esp3d_log("Processing message: %s", msg->data);
+    if (esp3d_commands.is_esp_command(msg->data, msg->size)) {
+      if (_outputBatch.length() > 0) {
+        _outputHeld = msg;
+        flushOutputBatch();
+        continue;
+      }
+      esp3d_commands.process(msg);
+      continue;
+    }
+    if (!addOutputLines(msg)) {
+      _outputHeld = msg;
+      flushOutputBatch();
+      continue;
+    }
+    esp3d_message_manager.deleteMsg(msg);
+  }
+  if (isOutputAcked()) {
+    flushOutputBatch();
+  }
+  if (count > 0) {
+    esp3d_log("lua_interpreter sent %d messages, %d left", count,
+              _messageOutFIFO.size());
+  }
+}
+
+// Last lines sent are acknowledged and another script can be queued
+bool LuaInterpreter::isOutputAcked() {
+  return esp3d_gcode_host.isScriptDone(_outputScriptId) &&
+         !esp3d_gcode_host.isScriptQueueFull();
+}
+
+// Add lines of message to batch, false if batch must be sent first
+// ';' separates commands of script, so comments are removed
+bool LuaInterpreter::addOutputLines(ESP3DMessage *msg) {
+  String lines;
+  size_t pos = 0;
+  while (pos < msg->size) {
+    size_t end = pos;
+    while (end < msg->size && msg->data[end] != '\n' &&
+           msg->data[end] != ';') {
+      end++;
+    }
+    String line;
+    line.concat((const char *)&msg->data[pos], end - pos);
+    line.trim();
+    if (line.length() > 0) {
+      if (lines.length() > 0) {
+        lines += ";";
+      }
+      lines += line;
+    }
+    while (end < msg->size && msg->data[end] != '\n') {
+      end++;
+    }
+    pos = end + 1;
+  }
+  if (lines.length() == 0) {
+    return true;
+  }
+  // a message longer than batch is sent alone
+  if (_outputBatch.length() > 0 &&
+      _outputBatch.length() + lines.length() + 1 > ESP_LUA_OUTPUT_BATCH_SIZE) {
+    return false;
+  }
+  if (_outputBatch.length() > 0) {
+    _outputBatch += ";";
+  }
+  _outputBatch += lines;
+  return true;
+}
+
+void LuaInterpreter::flushOutputBatch() {
+  if (_outputBatch.length() == 0) {
+    return;
   }
+  if (esp3d_gcode_host.processScript(_outputBatch.c_str())) {
+    _outputScriptId = esp3d_gcode_host.lastScriptId();
+  } else {
+    esp3d_log_e("Cannot send output to printer");
   }
+  _outputBatch = "";
 }
 
 uint64_t LuaInterpreter::getExecutionTime() {
@@ -439,6 +560,19 @@ int LuaInterpreter::l_print(lua_State *L) {
   esp3d_log("lua_interpreter output");
   LuaInterpreter *self =
       (LuaInterpreter *)lua_touserdata(L, lua_upvalueindex(1));
+  // wait until output is sent, so script goes at the pace of printer
+  // serial instead of filling memory
+  while (self->_messageOutFIFO.size() >= ESP_LUA_OUTPUT_QUEUE_SIZE) {
+    vTaskDelay(1);
+    while (self->_luaEngine.isPaused()) {
+      vTaskDelay(ESP_LUA_CHECK_INTERVAL);
+    }
+    if (!(self->_luaEngine.isRunning())) {
+      if (self->_lastError.length() == 0)
+        self->_lastError = "Execution stopped";
+      luaL_error(L, "Execution stopped");
+    }
+  }
   String dataString;
   dataString = "";
   int nargs = lua_gettop(L);
@@ -27,6 +27,32 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+// Memory pool of Lua scripts, 0 to use system heap
+#ifndef ESP_LUA_ARENA_SIZE
+#if defined(BOARD_HAS_PSRAM)
+#define ESP_LUA_ARENA_SIZE 524288
+#else
+#define ESP_LUA_ARENA_SIZE 65536
+#endif  // BOARD_HAS_PSRAM
+#endif  // ESP_LUA_ARENA_SIZE
+
+// print() waits when this many messages are not sent yet
+#ifndef ESP_LUA_OUTPUT_QUEUE_SIZE
+#define ESP_LUA_OUTPUT_QUEUE_SIZE 32
+#endif  // ESP_LUA_OUTPUT_QUEUE_SIZE
+
+// Messages and time (ms) spent sending output in one handle() call
+#ifndef ESP_LUA_OUTPUT_BUDGET
+#define ESP_LUA_OUTPUT_BUDGET 32
+#endif  // ESP_LUA_OUTPUT_BUDGET
+#ifndef ESP_LUA_OUTPUT_TIME_BUDGET
+#define ESP_LUA_OUTPUT_TIME_BUDGET 10
+#endif  // ESP_LUA_OUTPUT_TIME_BUDGET
+
+// Consecutive G-code lines are sent to printer as one G-code host script of
+// about this size, next lines are sent once all of them are acknowledged
+#define ESP_LUA_OUTPUT_BATCH_SIZE 512
+
 enum class Lua_Filesystem_Type : uint8_t {
   none = 0,
   fLash = 1,
@@ -47,12 +73,20 @@ class LuaInterpreter {
   bool isScriptRunning();
   bool isScriptPaused();
   const char* getLastError(); 
+  // nullptr if scripts use system heap
+  EspLuaArena* getArena() { return _luaEngine.getArena(); }
+  void setGC(EspLuaEngine::GCMode mode, int param1, int param2) {
+    _luaEngine.setGC(mode, param1, param2);
+  }
+  EspLuaEngine::GCMode getGCMode() { return _luaEngine.getGCMode(); }
   bool dispatch(ESP3DMessage* message);
   bool begin();
   void end();
   void handle();
 
  private:
+  // declared first so it is freed after Lua state
+  EspLuaArena _arena;
   EspLuaEngine _luaEngine;
   TaskHandle_t _scriptTask;
   char* _scriptBuffer;
@@ -64,6 +98,12 @@ class LuaInterpreter {
   unsigned long _startTime;
   unsigned long _pauseTime;
   String _lastError;
+  // G-code lines not sent yet, separated by ';'
+  String _outputBatch;
+  // G-code host script of last lines sent
+  uint32_t _outputScriptId;
+  // Output which waits for last lines to be acknowledged
+  ESP3DMessage* _outputHeld;
 
   static void scriptExecutionTask(void* parameter);
   void setupFunctions();
@@ -71,6 +111,11 @@ class LuaInterpreter {
   bool createScriptTask();
   void deleteScriptTask();
   void resetLuaEnvironment();
+  void setupArena();
+  void processOutput();
+  bool isOutputAcked();
+  bool addOutputLines(ESP3DMessage* msg);
+  void flushOutputBatch();
 
   // Wrappers
   static int l_print(lua_State* L);
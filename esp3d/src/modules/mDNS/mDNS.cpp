@@ -22,6 +22,7 @@
 #ifdef MDNS_FEATURE
 
 #include "../../core/esp3d_commands.h"
+#include "../../core/esp3d_hal.h"
 #include "../../core/esp3d_settings.h"
 #include "mDNS.h"
 
@@ -57,9 +58,17 @@ mDNS_Service::mDNS_Service() {
   _port = 0;
   _currentQueryCount = 0;
   _currentQueryTxtCount = 0;
+  _refreshing = false;
+  _refreshRequested = false;
+  _refreshStart = 0;
+  _lastRefresh = 0;
+  _peersCount = 0;
 #if defined(ARDUINO_ARCH_ESP8266)
   _hMDNSServiceQuery = 0;
 #endif  // ARDUINO_ARCH_ESP8266
+#if defined(ARDUINO_ARCH_ESP32)
+  _hSearch = nullptr;
+#endif  // ARDUINO_ARCH_ESP32
 }
 
 bool mDNS_Service::begin(const char* hostname) {
@@ -84,6 +93,8 @@ bool mDNS_Service::begin(const char* hostname) {
                                 ESP3DAuthenticationLevel::admin);
       }
       _started = true;
+      // First discovery is done shortly after start
+      _refreshStart = millis();
     }
   }
   return _started;
@@ -91,6 +102,10 @@ bool mDNS_Service::begin(const char* hostname) {
 void mDNS_Service::end() {
   _currentQueryCount = 0;
   _currentQueryTxtCount = 0;
+  endRefresh();
+  _refreshRequested = false;
+  _peersCount = 0;
+  _lastRefresh = 0;
   if (!_started || WiFi.getMode() == WIFI_AP) {
     return;
   }
@@ -201,12 +216,214 @@ void mDNS_Service::addESP3DServices(uint16_t port) {
 }
 
 void mDNS_Service::handle() {
-#if defined(ARDUINO_ARCH_ESP8266)
   if (WiFi.getMode() == WIFI_AP) {
     return;
   }
+#if defined(ARDUINO_ARCH_ESP8266)
   MDNS.update();
 #endif  // ARDUINO_ARCH_ESP8266
+  if (!_started) {
+    return;
+  }
+  if (_refreshing) {
+    pollRefresh();
+  } else if (_refreshRequested ||
+             (millis() - _refreshStart) >= (_lastRefresh == 0
+                                                ? ESP3D_MDNS_QUERY_TIMEOUT
+                                                : ESP3D_MDNS_REFRESH_INTERVAL)) {
+    _refreshRequested = false;
+    refresh();
+  }
+}
+
+bool mDNS_Service::refresh() {
+  if (_refreshing) {
+    return true;
+  }
+  if (!_started || WiFi.getMode() == WIFI_AP) {
+    return false;
+  }
+  _refreshStart = millis();
+#if defined(ARDUINO_ARCH_ESP32)
+  // Query is sent and answers are collected by mDNS task, no wait here
+  _hSearch = mdns_query_async_new(NULL, "_" MDNS_SERVICE_NAME,
+                                  "_" MDNS_SERVICE_TYPE, MDNS_TYPE_PTR,
+                                  ESP3D_MDNS_QUERY_TIMEOUT,
+                                  ESP3D_MDNS_MAX_PEERS, NULL);
+  if (!_hSearch) {
+    esp3d_log_e("Cannot start mDNS discovery");
+    return false;
+  }
+#endif  // ARDUINO_ARCH_ESP32
+#if defined(ARDUINO_ARCH_ESP8266)
+  // Service query is permanent, answers are already there
+  if (!_hMDNSServiceQuery) {
+    return false;
+  }
+#endif  // ARDUINO_ARCH_ESP8266
+  esp3d_log("mDNS discovery started");
+  _refreshing = true;
+  return true;
+}
+
+bool mDNS_Service::pollRefresh() {
+  if (!_refreshing) {
+    return true;
+  }
+  ESP3DmDNSPeer tmp;
+#if defined(ARDUINO_ARCH_ESP32)
+  mdns_result_t* results = nullptr;
+#if ESP_ARDUINO_VERSION_MAJOR == 3
+  uint8_t nbResults = 0;
+  bool done = mdns_query_async_get_results((mdns_search_once_t*)_hSearch, 0,
+                                           &results, &nbResults);
+#else
+  bool done = mdns_query_async_get_results((mdns_search_once_t*)_hSearch, 0,
+                                           &results);
+#endif  // ESP_ARDUINO_VERSION_MAJOR == 3
+  if (!done) {
+    if ((millis() - _refreshStart) > 2 * ESP3D_MDNS_QUERY_TIMEOUT) {
+      esp3d_log_e("mDNS discovery timeout");
+      endRefresh();
+      return true;
+    }
+    return false;
+  }
+  for (mdns_result_t* r = results; r; r = r->next) {
+    if (!r->hostname) {
+      continue;
+    }
+    strncpy(tmp.hostname, r->hostname, sizeof(tmp.hostname) - 1);
+    tmp.hostname[sizeof(tmp.hostname) - 1] = '\0';
+    tmp.ip[0] = '\0';
+    for (mdns_ip_addr_t* a = r->addr; a; a = a->next) {
+      // Currently esp3d support only IPV4
+      if (a->addr.type == ESP_IPADDR_TYPE_V4) {
+        strncpy(tmp.ip, IPAddress(a->addr.u_addr.ip4.addr).toString().c_str(),
+                sizeof(tmp.ip) - 1);
+        tmp.ip[sizeof(tmp.ip) - 1] = '\0';
+        break;
+      }
+    }
+    tmp.port = r->port;
+    tmp.txtCount = 0;
+    for (size_t t = 0; t < r->txt_count && tmp.txtCount < ESP3D_MDNS_MAX_TXT;
+         t++) {
+      strncpy(tmp.txtKey[tmp.txtCount], r->txt[t].key ? r->txt[t].key : "",
+              ESP3D_MDNS_TXT_KEY_SIZE - 1);
+      tmp.txtKey[tmp.txtCount][ESP3D_MDNS_TXT_KEY_SIZE - 1] = '\0';
+      strncpy(tmp.txtValue[tmp.txtCount],
+              r->txt[t].value ? r->txt[t].value : "",
+              ESP3D_MDNS_TXT_VALUE_SIZE - 1);
+      tmp.txtValue[tmp.txtCount][ESP3D_MDNS_TXT_VALUE_SIZE - 1] = '\0';
+      tmp.txtCount++;
+    }
+    updatePeer(tmp);
+  }
+  if (results) {
+    mdns_query_results_free(results);
+  }
+#endif  // ARDUINO_ARCH_ESP32
+#if defined(ARDUINO_ARCH_ESP8266)
+  uint16_t count = servicesCount();
+  for (uint16_t i = 0; i < count; i++) {
+    strncpy(tmp.hostname, answerHostname(i), sizeof(tmp.hostname) - 1);
+    tmp.hostname[sizeof(tmp.hostname) - 1] = '\0';
+    strncpy(tmp.ip, answerIP(i), sizeof(tmp.ip) - 1);
+    tmp.ip[sizeof(tmp.ip) - 1] = '\0';
+    tmp.port = answerPort(i);
+    tmp.txtCount = 0;
+    uint16_t nbTxt = answerTxtCount(i);
+    for (uint16_t t = 0; t < nbTxt && tmp.txtCount < ESP3D_MDNS_MAX_TXT; t++) {
+      strncpy(tmp.txtKey[tmp.txtCount], answerTxtKey(i, t),
+              ESP3D_MDNS_TXT_KEY_SIZE - 1);
+      tmp.txtKey[tmp.txtCount][ESP3D_MDNS_TXT_KEY_SIZE - 1] = '\0';
+      strncpy(tmp.txtValue[tmp.txtCount], answerTxt(i, t),
+              ESP3D_MDNS_TXT_VALUE_SIZE - 1);
+      tmp.txtValue[tmp.txtCount][ESP3D_MDNS_TXT_VALUE_SIZE - 1] = '\0';
+      tmp.txtCount++;
+    }
+    updatePeer(tmp);
+  }
+#endif  // ARDUINO_ARCH_ESP8266
+  endRefresh();
+  expirePeers();
+  _lastRefresh = millis();
+  // 0 means never refreshed
+  if (_lastRefresh == 0) {
+    _lastRefresh = 1;
+  }
+  esp3d_log("mDNS discovery done, %d peers", _peersCount);
+  return true;
+}
+
+bool mDNS_Service::waitRefresh() {
+  while (_refreshing && !pollRefresh()) {
+    ESP3DHal::wait(10);
+  }
+  return _lastRefresh != 0;
+}
+
+void mDNS_Service::endRefresh() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (_hSearch) {
+    mdns_query_async_delete((mdns_search_once_t*)_hSearch);
+    _hSearch = nullptr;
+  }
+#endif  // ARDUINO_ARCH_ESP32
+  _refreshing = false;
+}
+
+void mDNS_Service::updatePeer(ESP3DmDNSPeer& peer) {
+  // Same host may answer on several interfaces, ".local" is not kept
+  char* domain = strstr(peer.hostname, ".local");
+  if (domain) {
+    *domain = '\0';
+  }
+  if (strlen(peer.hostname) == 0 ||
+      strcasecmp(peer.hostname, _hostname.c_str()) == 0) {
+    return;
+  }
+  uint8_t index = _peersCount;
+  for (uint8_t i = 0; i < _peersCount; i++) {
+    if (strcasecmp(_peers[i].hostname, peer.hostname) == 0) {
+      index = i;
+      break;
+    }
+  }
+  if (index == ESP3D_MDNS_MAX_PEERS) {
+    // Cache is full, the peer not seen for the longest time is replaced
+    index = 0;
+    for (uint8_t i = 1; i < _peersCount; i++) {
+      if ((int32_t)(_peers[i].lastSeen - _peers[index].lastSeen) < 0) {
+        index = i;
+      }
+    }
+  } else if (index == _peersCount) {
+    _peersCount++;
+  }
+  _peers[index] = peer;
+  _peers[index].lastSeen = millis();
+}
+
+void mDNS_Service::expirePeers() {
+  uint8_t i = 0;
+  while (i < _peersCount) {
+    if ((millis() - _peers[i].lastSeen) > ESP3D_MDNS_PEER_TTL) {
+      esp3d_log("Peer %s removed", _peers[i].hostname);
+      _peersCount--;
+      _peers[i] = _peers[_peersCount];
+    } else {
+      i++;
+    }
+  }
+}
+
+const ESP3DmDNSPeer* mDNS_Service::peer(uint8_t index) {
+  if (index >= _peersCount) {
+    return nullptr;
+  }
+  return &_peers[index];
 }
 
 uint16_t mDNS_Service::servicesCount() {
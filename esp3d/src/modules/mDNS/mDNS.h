@@ -20,6 +20,46 @@
 #ifndef _MDNS_H
 #define _MDNS_H
 #include <Arduino.h>
+
+// Other ESP3D kept in discovery cache
+#ifndef ESP3D_MDNS_MAX_PEERS
+#if defined(ARDUINO_ARCH_ESP32)
+#define ESP3D_MDNS_MAX_PEERS 16
+#else
+#define ESP3D_MDNS_MAX_PEERS 8
+#endif  // ARDUINO_ARCH_ESP32
+#endif  // ESP3D_MDNS_MAX_PEERS
+
+// TXT records kept per peer
+#define ESP3D_MDNS_MAX_TXT 4
+#define ESP3D_MDNS_TXT_KEY_SIZE 16
+#define ESP3D_MDNS_TXT_VALUE_SIZE 32
+
+// Time between 2 discoveries (ms)
+#ifndef ESP3D_MDNS_REFRESH_INTERVAL
+#define ESP3D_MDNS_REFRESH_INTERVAL 60000
+#endif  // ESP3D_MDNS_REFRESH_INTERVAL
+
+// Time a discovery listens for answers (ms)
+#ifndef ESP3D_MDNS_QUERY_TIMEOUT
+#define ESP3D_MDNS_QUERY_TIMEOUT 3000
+#endif  // ESP3D_MDNS_QUERY_TIMEOUT
+
+// Peer not seen since this time is removed (ms)
+#ifndef ESP3D_MDNS_PEER_TTL
+#define ESP3D_MDNS_PEER_TTL (3 * ESP3D_MDNS_REFRESH_INTERVAL)
+#endif  // ESP3D_MDNS_PEER_TTL
+
+struct ESP3DmDNSPeer {
+  char hostname[64];
+  char ip[16];
+  uint16_t port;
+  uint8_t txtCount;
+  uint32_t lastSeen;
+  char txtKey[ESP3D_MDNS_MAX_TXT][ESP3D_MDNS_TXT_KEY_SIZE];
+  char txtValue[ESP3D_MDNS_MAX_TXT][ESP3D_MDNS_TXT_VALUE_SIZE];
+};
+
 class mDNS_Service {
  public:
   mDNS_Service();
@@ -36,8 +76,33 @@ class mDNS_Service {
   uint16_t answerTxtCount(uint16_t index);
   const char* answerTxtKey(uint16_t index, uint16_t txtIndex);
   const char* answerTxt(uint16_t index, uint16_t txtIndex);
+  // Discovery cache, refreshed in background by handle()
+  bool refresh();
+  // Safe from other tasks (web server): discovery is started by handle()
+  void requestRefresh() { _refreshRequested = true; }
+  bool isRefreshing() { return _refreshing || _refreshRequested; }
+  // Wait current discovery is done, return false if none was done
+  bool waitRefresh();
+  bool hasPeers() { return _lastRefresh != 0; }
+  uint32_t lastRefreshAge() { return millis() - _lastRefresh; }
+  uint8_t peersCount() { return _peersCount; }
+  const ESP3DmDNSPeer* peer(uint8_t index);
+  const char* hostname() { return _hostname.c_str(); }
 
  private:
+  bool pollRefresh();
+  void endRefresh();
+  void updatePeer(ESP3DmDNSPeer& peer);
+  void expirePeers();
+  bool _refreshing;
+  volatile bool _refreshRequested;
+  uint32_t _refreshStart;
+  uint32_t _lastRefresh;
+  uint8_t _peersCount;
+  ESP3DmDNSPeer _peers[ESP3D_MDNS_MAX_PEERS];
+#if defined(ARDUINO_ARCH_ESP32)
+  void* _hSearch;
+#endif  // ARDUINO_ARCH_ESP32
   bool _started;
   uint16_t _port;
   uint16_t _currentQueryCount;
@@ -0,0 +1,228 @@
+/*
+  meatpack.cpp - MeatPack G-code packing class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "../../include/esp3d_config.h"
+#if defined(MEATPACK_FEATURE)
+#include "../../core/esp3d_settings.h"
+#include "../serial/serial_service.h"
+#include "meatpack.h"
+
+ESP3DMeatPack esp3d_meatpack;
+
+// Two signal bytes followed by a command byte
+#define MP_SIGNAL_BYTE 0xFF
+#define MP_ENABLE_PACKING 0xFB
+#define MP_DISABLE_PACKING 0xFA
+#define MP_RESET_ALL 0xF9
+#define MP_QUERY_CONFIG 0xF8
+// Nibble value of a character sent as a full byte after the packed byte
+#define MP_NOT_PACKED 0x0F
+
+// 4 bits code of the 15 most used G-code characters
+static uint8_t packedCode(uint8_t c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  switch (c) {
+    case '.':
+      return 10;
+    case ' ':
+      return 11;
+    case '\n':
+      return 12;
+    case 'G':
+      return 13;
+    case 'X':
+      return 14;
+    default:
+      return MP_NOT_PACKED;
+  }
+}
+
+// Look for "[MP] ... ON|OFF" in printer answer, -1 if not a MeatPack report
+static int8_t reportedState(const uint8_t* data, size_t size) {
+  for (size_t i = 0; i + 4 <= size; i++) {
+    if (memcmp(&data[i], "[MP]", 4) != 0) {
+      continue;
+    }
+    for (size_t j = i + 4; j + 3 <= size && data[j] != '\n'; j++) {
+      if (data[j] == ' ' && data[j + 1] == 'O') {
+        return data[j + 2] == 'N' ? 1 : 0;
+      }
+    }
+    return -1;
+  }
+  return -1;
+}
+
+ESP3DMeatPack::ESP3DMeatPack() {
+  _state = ESP3DMeatPackState::off;
+  _startTime = 0;
+  _pending = -1;
+  _plainSize = 0;
+  _packedSize = 0;
+}
+
+bool ESP3DMeatPack::begin() {
+  if (_state == ESP3DMeatPackState::unsupported) {
+    return false;
+  }
+  if (_state != ESP3DMeatPackState::off) {
+    return true;
+  }
+  if (ESP3DSettings::GetFirmwareTarget() != MARLIN) {
+    return false;
+  }
+  // Reset printer side then query its state, the end of lines keep the
+  // signal bytes apart from G-code if printer does not know MeatPack
+  static const uint8_t probe[] = {
+      '\n',           MP_SIGNAL_BYTE, MP_SIGNAL_BYTE, MP_RESET_ALL,
+      MP_SIGNAL_BYTE, MP_SIGNAL_BYTE, MP_QUERY_CONFIG, '\n'};
+  if (!sendSignal(probe, sizeof(probe))) {
+    return false;
+  }
+  esp3d_log("MeatPack: probing printer");
+  _state = ESP3DMeatPackState::probing;
+  _startTime = millis();
+  return true;
+}
+
+void ESP3DMeatPack::end() {
+  if (_state == ESP3DMeatPackState::active) {
+    // complete last pair, a lonely end of line is harmless
+    if (_pending != -1) {
+      uint8_t out[3];
+      size_t n = packPair(_pending, '\n', out);
+      esp3d_serial_service.writeBytes(out, n);
+      _pending = -1;
+    }
+    static const uint8_t disable[] = {MP_SIGNAL_BYTE, MP_SIGNAL_BYTE,
+                                      MP_DISABLE_PACKING};
+    sendSignal(disable, sizeof(disable));
+    esp3d_log("MeatPack: %d bytes sent as %d bytes", _plainSize, _packedSize);
+    _state = ESP3DMeatPackState::off;
+  } else if (isNegotiating()) {
+    static const uint8_t reset[] = {MP_SIGNAL_BYTE, MP_SIGNAL_BYTE,
+                                    MP_RESET_ALL};
+    sendSignal(reset, sizeof(reset));
+    _state = ESP3DMeatPackState::off;
+  }
+}
+
+void ESP3DMeatPack::handle() {
+  if (!isNegotiating() || (millis() - _startTime) < ESP3D_MEATPACK_TIMEOUT) {
+    return;
+  }
+  if (_state == ESP3DMeatPackState::enabling) {
+    // printer state is unknown, be sure it is back to plain G-code
+    static const uint8_t reset[] = {MP_SIGNAL_BYTE, MP_SIGNAL_BYTE,
+                                    MP_RESET_ALL};
+    sendSignal(reset, sizeof(reset));
+  }
+  esp3d_log_e("MeatPack: no answer from printer, sending plain G-code");
+  _state = ESP3DMeatPackState::unsupported;
+}
+
+void ESP3DMeatPack::parse(const uint8_t* data, size_t size) {
+  if (!data || _state == ESP3DMeatPackState::off ||
+      _state == ESP3DMeatPackState::unsupported) {
+    return;
+  }
+  int8_t on = reportedState(data, size);
+  if (on == 1) {
+    // the query answer of probe may come before the enable answer
+    if (isNegotiating()) {
+      esp3d_log("MeatPack: packing is on");
+      _state = ESP3DMeatPackState::active;
+      _pending = -1;
+      _plainSize = 0;
+      _packedSize = 0;
+    }
+  } else if (on == 0) {
+    if (_state == ESP3DMeatPackState::probing) {
+      static const uint8_t enable[] = {MP_SIGNAL_BYTE, MP_SIGNAL_BYTE,
+                                       MP_ENABLE_PACKING};
+      if (sendSignal(enable, sizeof(enable))) {
+        _state = ESP3DMeatPackState::enabling;
+        _startTime = millis();
+      } else {
+        _state = ESP3DMeatPackState::off;
+      }
+    } else if (_state == ESP3DMeatPackState::active) {
+      esp3d_log_e("MeatPack: printer switched packing off");
+      _state = ESP3DMeatPackState::off;
+    }
+  }
+}
+
+size_t ESP3DMeatPack::packPair(uint8_t first, uint8_t second, uint8_t* out) {
+  uint8_t firstCode = packedCode(first);
+  uint8_t secondCode = packedCode(second);
+  size_t n = 0;
+  out[n++] = firstCode | (secondCode << 4);
+  if (firstCode == MP_NOT_PACKED) {
+    out[n++] = first;
+  }
+  if (secondCode == MP_NOT_PACKED) {
+    out[n++] = second;
+  }
+  return n;
+}
+
+size_t ESP3DMeatPack::pack(const uint8_t* data, size_t size, uint8_t* out) {
+  size_t n = 0;
+  for (size_t i = 0; i < size; i++) {
+    if (_pending != -1) {
+      n += packPair(_pending, data[i], &out[n]);
+      _pending = -1;
+    } else if (data[i] == '\n') {
+      // printer ignores the character after an end of line in a pair
+      n += packPair('\n', '\n', &out[n]);
+    } else {
+      _pending = data[i];
+    }
+  }
+  return n;
+}
+
+size_t ESP3DMeatPack::write(const uint8_t* data, size_t size) {
+  uint8_t out[ESP3D_MEATPACK_BUFFER_SIZE];
+  // worst case is 3 bytes for 2 characters
+  const size_t chunkSize = ((ESP3D_MEATPACK_BUFFER_SIZE - 2) * 2) / 3;
+  size_t done = 0;
+  while (done < size) {
+    size_t len = (size - done) > chunkSize ? chunkSize : (size - done);
+    size_t n = pack(&data[done], len, out);
+    if (n > 0 && esp3d_serial_service.writeBytes(out, n) != n) {
+      esp3d_log_e("MeatPack: cannot write packed data");
+      return done;
+    }
+    _plainSize += len;
+    _packedSize += n;
+    done += len;
+  }
+  return done;
+}
+
+bool ESP3DMeatPack::sendSignal(const uint8_t* commands, size_t count) {
+  return esp3d_serial_service.writeBytes(commands, count) == count;
+}
+
+#endif  // MEATPACK_FEATURE
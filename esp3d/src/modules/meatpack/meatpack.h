@@ -0,0 +1,78 @@
+/*
+  meatpack.h - MeatPack G-code packing class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _MEATPACK_H
+#define _MEATPACK_H
+
+#include <Arduino.h>
+
+// Time to wait for printer answer to a MeatPack command (ms)
+#ifndef ESP3D_MEATPACK_TIMEOUT
+#define ESP3D_MEATPACK_TIMEOUT 2000
+#endif  // ESP3D_MEATPACK_TIMEOUT
+
+// Size of packed data written to serial at once
+#define ESP3D_MEATPACK_BUFFER_SIZE 96
+
+enum class ESP3DMeatPackState : uint8_t {
+  off,          // plain G-code
+  probing,      // waiting for printer to report MeatPack state
+  enabling,     // waiting for printer to confirm packing is on
+  active,       // all data sent to printer is packed
+  unsupported,  // printer did not answer, never probed again
+};
+
+// Data sent to printer is packed 2 characters per byte when possible,
+// see Marlin feature/meatpack.cpp for the decoder side
+class ESP3DMeatPack {
+ public:
+  ESP3DMeatPack();
+  // Ask printer to switch to packed mode, false if it cannot be done
+  bool begin();
+  // Back to plain G-code
+  void end();
+  void handle();
+  // Printer answer, looking for "[MP] ..." state report
+  void parse(const uint8_t* data, size_t size);
+  ESP3DMeatPackState state() { return _state; }
+  bool isActive() { return _state == ESP3DMeatPackState::active; }
+  bool isNegotiating() {
+    return _state == ESP3DMeatPackState::probing ||
+           _state == ESP3DMeatPackState::enabling;
+  }
+  // Pack data and write it to printer serial, return size of data consumed
+  size_t write(const uint8_t* data, size_t size);
+  // Pack data into out, which must be able to hold size * 3 / 2 + 2 bytes
+  size_t pack(const uint8_t* data, size_t size, uint8_t* out);
+
+ private:
+  size_t packPair(uint8_t first, uint8_t second, uint8_t* out);
+  bool sendSignal(const uint8_t* commands, size_t count);
+  ESP3DMeatPackState _state;
+  uint32_t _startTime;
+  // first character of an incomplete pair, -1 if none
+  int16_t _pending;
+  uint32_t _plainSize;
+  uint32_t _packedSize;
+};
+
+extern ESP3DMeatPack esp3d_meatpack;
+
+#endif  //_MEATPACK_H
@@ -28,6 +28,7 @@
 #include "../serial/serial_service.h"
 #include "../telnet/telnet_server.h"
 #include "../wifi/wificonfig.h"
+#include "../wifi/wifiscan.h"
 #include "mks_service.h"
 
 // Flag Pins
@@ -104,6 +105,21 @@ char MKSService::_moduleId[22] = {0};
 uint8_t MKSService::_uploadStatus = UNKNOW_STATE;
 long MKSService::_commandBaudRate = 115200;
 bool MKSService::_uploadMode = false;
+volatile bool MKSService::_boardReady = false;
+uint8_t MKSService::_uploadFrames[2][MKS_FRAME_SIZE] = {{0}};
+uint8_t MKSService::_fillIndex = 0;
+size_t MKSService::_fillSize = 0;
+int8_t MKSService::_txIndex = -1;
+size_t MKSService::_txOffset = 0;
+size_t MKSService::_txSize = 0;
+uint32_t MKSService::_fragmentNumber = 0;
+uint32_t MKSService::_uploadStartTime = 0;
+uint32_t MKSService::_uploadedBytes = 0;
+uint32_t MKSService::_uploadRate = 0;
+bool MKSService::_hotspotsPending = false;
+
+// Board pulls its flag pin to ready level when it can accept a frame
+void IRAM_ATTR MKSService::boardReadyISR() { _boardReady = true; }
 
 bool MKSService::isHead(const char c) { return (c == MKS_FRAME_HEAD_FLAG); }
 bool MKSService::isTail(const char c) { return (c == MKS_FRAME_TAIL_FLAG); }
@@ -134,6 +150,8 @@ bool MKSService::begin() {
   esp3d_log("Starting MKS service");
   pinMode(BOARD_FLAG_PIN, INPUT);
   pinMode(ESP_FLAG_PIN, OUTPUT);
+  attachInterrupt(digitalPinToInterrupt(BOARD_FLAG_PIN), boardReadyISR,
+                  FALLING);
   _started = true;
   sprintf(_moduleId, "HJNLM000%02X%02X%02X%02X%02X%02X", WiFi.macAddress()[0],
           WiFi.macAddress()[1], WiFi.macAddress()[2], WiFi.macAddress()[3],
@@ -201,26 +219,35 @@ bool MKSService::sendFirstFragment(const char *filename, size_t filesize) {
   return false;
 }
 
+void MKSService::buildFragmentFrame(uint8_t *frame, const size_t dataSize,
+                                    uint fragmentID) {
+  uint dataLen = dataSize + 4;
+  frame[MKS_FRAME_HEAD_OFFSET] = MKS_FRAME_HEAD_FLAG;
+  frame[MKS_FRAME_TYPE_OFFSET] = MKS_FRAME_DATA_FRAGMENT_TYPE;
+  frame[MKS_FRAME_DATALEN_OFFSET] = dataLen & 0xff;
+  frame[MKS_FRAME_DATALEN_OFFSET + 1] = dataLen >> 8;
+  frame[MKS_FRAME_DATA_OFFSET] = fragmentID & 0xff;
+  frame[MKS_FRAME_DATA_OFFSET + 1] = (fragmentID >> 8) & 0xff;
+  frame[MKS_FRAME_DATA_OFFSET + 2] = (fragmentID >> 16) & 0xff;
+  frame[MKS_FRAME_DATA_OFFSET + 3] = (fragmentID >> 24) & 0xff;
+  frame[dataLen + 4] = MKS_FRAME_TAIL_FLAG;
+}
+
 bool MKSService::sendFragment(const uint8_t *dataFrame, const size_t dataSize,
                               uint fragmentID) {
-  uint dataLen = dataSize + 4;
   esp3d_log("Sending fragment: datalen=%d, fragmentID=%d", dataSize, fragmentID);
-  clearFrame();
-  _frame[MKS_FRAME_HEAD_OFFSET] = MKS_FRAME_HEAD_FLAG;
-  _frame[MKS_FRAME_TYPE_OFFSET] = MKS_FRAME_DATA_FRAGMENT_TYPE;
-  _frame[MKS_FRAME_DATALEN_OFFSET] = dataLen & 0xff;
-  _frame[MKS_FRAME_DATALEN_OFFSET + 1] = dataLen >> 8;
-  _frame[MKS_FRAME_DATA_OFFSET] = fragmentID & 0xff;
-  _frame[MKS_FRAME_DATA_OFFSET + 1] = (fragmentID >> 8) & 0xff;
-  _frame[MKS_FRAME_DATA_OFFSET + 2] = (fragmentID >> 16) & 0xff;
-  _frame[MKS_FRAME_DATA_OFFSET + 3] = (fragmentID >> 24) & 0xff;
+  if (dataSize > MKS_FRAME_DATA_MAX_SIZE) {
+    esp3d_log_e("Fragment too large: %d", dataSize);
+    return false;
+  }
   if ((dataSize > 0) && (dataFrame != nullptr)) {
     memcpy(&_frame[MKS_FRAME_DATA_OFFSET + 4], dataFrame, dataSize);
   }
-  _frame[dataLen + 4] = MKS_FRAME_TAIL_FLAG;
+  buildFragmentFrame(_frame, dataSize, fragmentID);
   if (canSendFrame()) {
     _uploadStatus = UNKNOW_STATE;
-    if (esp3d_serial_service.writeBytes(_frame, dataLen + 5) == (dataLen + 5)) {
+    if (esp3d_serial_service.writeBytes(_frame, dataSize + 9) ==
+        (dataSize + 9)) {
       esp3d_log("Fragment sent successfully");
       sendFrameDone();
       return true;
@@ -233,72 +260,179 @@ bool MKSService::sendFragment(const uint8_t *dataFrame, const size_t dataSize,
   return false;
 }
 
-void MKSService::sendWifiHotspots() {
-  uint8_t ssid_name_length;
-  uint dataOffset = 1;
-  uint8_t total_hotspots = 0;
-  uint8_t currentmode = WiFi.getMode();
-  esp3d_log("Starting WiFi scan for hotspots");
-  if (currentmode == WIFI_AP) {
-    esp3d_log("Switching to WIFI_AP_STA for scanning");
-    if (!WiFi.mode(WIFI_AP_STA)) {
-      esp3d_log_e("Failed to switch to WIFI_AP_STA");
-      return;
-    }
+bool MKSService::startUpload(const char *filename, size_t filesize) {
+  // make sure nothing is left from a previous upload
+  _txIndex = -1;
+  _fillIndex = 0;
+  _fillSize = 0;
+  _fragmentNumber = 0;
+  _uploadedBytes = 0;
+  _uploadRate = 0;
+  if (!sendFirstFragment(filename, filesize)) {
+    return false;
   }
-  clearFrame();
-  WiFi.scanDelete();
-  int n = WiFi.scanNetworks();
-  esp3d_log("Scan completed, found %d networks", n);
-  if (n <= 0) {
-    esp3d_log_e("No networks found or scan failed");
-    _frame[MKS_FRAME_HEAD_OFFSET] = MKS_FRAME_HEAD_FLAG;
-    _frame[MKS_FRAME_TYPE_OFFSET] = MKS_FRAME_DATA_HOTSPOTS_LIST_TYPE;
-    _frame[MKS_FRAME_DATA_OFFSET] = 0; // No hotspots
-    _frame[MKS_FRAME_DATALEN_OFFSET] = 1 & 0xff;
-    _frame[MKS_FRAME_DATALEN_OFFSET + 1] = 1 >> 8;
-    _frame[MKS_FRAME_DATA_OFFSET + 1] = MKS_FRAME_TAIL_FLAG;
-    if (canSendFrame()) {
-      if (esp3d_serial_service.writeBytes(_frame, 6) == 6) {
-        esp3d_log("Sent empty hotspot list");
-      } else {
-        esp3d_log_e("Failed to send empty hotspot list");
+  uploadMode();
+  _uploadStartTime = millis();
+  return true;
+}
+
+bool MKSService::uploadData(const uint8_t *data, size_t len) {
+  if (!_uploadMode) {
+    esp3d_log_e("Upload not started");
+    return false;
+  }
+  while (len > 0) {
+    // data are copied in place, header is added when the frame is full
+    size_t chunk = MKS_FRAME_DATA_MAX_SIZE - _fillSize;
+    if (chunk > len) {
+      chunk = len;
+    }
+    memcpy(&_uploadFrames[_fillIndex][MKS_FRAME_DATA_OFFSET + 4 + _fillSize],
+           data, chunk);
+    _fillSize += chunk;
+    data += chunk;
+    len -= chunk;
+    if (_fillSize == MKS_FRAME_DATA_MAX_SIZE) {
+      if (!queueFragment(false)) {
+        return false;
       }
     } else {
-      esp3d_log_e("Board not ready for hotspot list");
+      // let the frame in flight progress while we wait for more data
+      pumpUpload();
     }
+  }
+  return true;
+}
+
+bool MKSService::endUpload(bool success) {
+  bool res = false;
+  if (_uploadMode) {
+    if (success) {
+      res = queueFragment(true) && drainUpload();
+    } else {
+      // TBC: board has no explicit abort frame, just stop sending
+      drainUpload();
+    }
+    updateUploadRate();
+    esp3d_log("Upload %s: %d bytes in %d ms, %d.%02d KB/s",
+              res ? "done" : "failed", _uploadedBytes,
+              millis() - _uploadStartTime, _uploadRate / 1024,
+              ((_uploadRate % 1024) * 100) / 1024);
+  }
+  _txIndex = -1;
+  _fillSize = 0;
+  commandMode();
+  return res;
+}
+
+// Close current filling frame and hand it to UART, previous frame must be
+// fully sent before board can accept a new one
+bool MKSService::queueFragment(bool isLast) {
+  if (!drainUpload()) {
+    return false;
+  }
+  uint fragmentID = getFragmentID(_fragmentNumber, isLast);
+  buildFragmentFrame(_uploadFrames[_fillIndex], _fillSize, fragmentID);
+  if (!canSendFrame()) {
+    esp3d_log_e("Board not ready for fragment %d", _fragmentNumber);
     sendFrameDone();
-    WiFi.mode((WiFiMode_t)currentmode);
+    return false;
+  }
+  _uploadStatus = UNKNOW_STATE;
+  _txIndex = _fillIndex;
+  _txOffset = 0;
+  _txSize = _fillSize + 9;
+  _fillIndex ^= 1;
+  _fillSize = 0;
+  _fragmentNumber++;
+  pumpUpload();
+  return true;
+}
+
+// Push as much of the frame in flight as UART can take without blocking
+void MKSService::pumpUpload() {
+  if (_txIndex < 0) {
     return;
   }
+  size_t available = esp3d_serial_service.availableForWrite();
+  if (available > 0) {
+    size_t toSend = _txSize - _txOffset;
+    if (toSend > available) {
+      toSend = available;
+    }
+    size_t sent = esp3d_serial_service.writeBytes(
+        &_uploadFrames[_txIndex][_txOffset], toSend);
+    _txOffset += sent;
+    _uploadedBytes += sent;
+  }
+  if (_txOffset >= _txSize) {
+    esp3d_log("Fragment sent successfully");
+    sendFrameDone();
+    _txIndex = -1;
+  }
+}
+
+bool MKSService::drainUpload() {
+  uint32_t startTime = millis();
+  while (_txIndex >= 0) {
+    size_t offset = _txOffset;
+    pumpUpload();
+    if (_txOffset != offset) {
+      startTime = millis();
+    } else if ((millis() - startTime) > FRAME_WAIT_TO_SEND_TIMEOUT) {
+      esp3d_log_e("Failed to send fragment: UART stalled");
+      sendFrameDone();
+      _txIndex = -1;
+      return false;
+    }
+    ESP3DHal::wait(0);
+  }
+  return true;
+}
+
+void MKSService::updateUploadRate() {
+  uint32_t duration = millis() - _uploadStartTime;
+  if (duration == 0) {
+    duration = 1;
+  }
+  _uploadRate = (uint32_t)(((uint64_t)_uploadedBytes * 1000) / duration);
+}
+
+void MKSService::sendWifiHotspots() {
+  // Recent results are sent at once, else when background scan is done
+  if (!WiFiScan::isValid()) {
+    esp3d_log("Starting WiFi scan for hotspots");
+    if (WiFiScan::start()) {
+      _hotspotsPending = true;
+      return;
+    }
+    esp3d_log_e("WiFi scan failed to start");
+  }
+  sendHotspotsList();
+}
+
+void MKSService::sendHotspotsList() {
+  _hotspotsPending = false;
+  uint8_t ssid_name_length;
+  uint dataOffset = 1;
+  uint8_t total_hotspots = 0;
+  clearFrame();
   _frame[MKS_FRAME_HEAD_OFFSET] = MKS_FRAME_HEAD_FLAG;
   _frame[MKS_FRAME_TYPE_OFFSET] = MKS_FRAME_DATA_HOTSPOTS_LIST_TYPE;
-  String configuredSSID = ESP3DSettings::readString(ESP_STA_SSID);
-  bool ssidFound = false;
-  for (uint8_t i = 0; i < n && total_hotspots < NB_HOTSPOT_MAX; ++i) {
-    int8_t signal_rssi = WiFi.RSSI(i);
-    if (signal_rssi < MIN_RSSI) {
-      esp3d_log("Ignoring %s: RSSI %d < MIN_RSSI %d", WiFi.SSID(i).c_str(), signal_rssi, MIN_RSSI);
-      continue;
-    }
-    ssid_name_length = WiFi.SSID(i).length();
-    if (ssid_name_length > MAX_SSID_LENGTH) {
-      esp3d_log_e("Ignoring %s: SSID length %d > MAX_SSID_LENGTH %d", 
-                  WiFi.SSID(i).c_str(), ssid_name_length, MAX_SSID_LENGTH);
-      continue;
-    }
-    esp3d_log("Network %d: %s, RSSI: %d, %s", i + 1, WiFi.SSID(i).c_str(), signal_rssi,
-              (WiFi.encryptionType(i) == ENC_TYPE_NONE) ? "Open" : "Secure");
+  // Failed scan has no network so an empty list is sent
+  for (uint8_t i = 0; i < WiFiScan::count() && total_hotspots < NB_HOTSPOT_MAX;
+       ++i) {
+    const ESP3DWiFiNetwork *network = WiFiScan::network(i);
+    ssid_name_length = strlen(network->ssid);
+    esp3d_log("Network %d: %s, RSSI: %d, %s", i + 1, network->ssid,
+              network->rssi, network->isProtected ? "Secure" : "Open");
     _frame[MKS_FRAME_DATA_OFFSET + dataOffset] = ssid_name_length;
-    for (uint8_t p = 0; p < ssid_name_length; p++) {
-      _frame[MKS_FRAME_DATA_OFFSET + dataOffset + 1 + p] = WiFi.SSID(i)[p];
-    }
-    _frame[MKS_FRAME_DATA_OFFSET + dataOffset + ssid_name_length + 1] = WiFi.RSSI(i);
+    memcpy(&_frame[MKS_FRAME_DATA_OFFSET + dataOffset + 1], network->ssid,
+           ssid_name_length);
+    _frame[MKS_FRAME_DATA_OFFSET + dataOffset + ssid_name_length + 1] =
+        network->rssi;
     dataOffset += ssid_name_length + 2;
     total_hotspots++;
-    if (WiFi.SSID(i) == configuredSSID) {
-      ssidFound = true;
-    }
   }
   _frame[MKS_FRAME_DATA_OFFSET] = total_hotspots;
   _frame[MKS_FRAME_DATA_OFFSET + dataOffset] = MKS_FRAME_TAIL_FLAG;
@@ -315,9 +449,6 @@ void MKSService::sendWifiHotspots() {
     esp3d_log_e("Board not ready for hotspot list");
   }
   sendFrameDone();
-  WiFi.scanDelete();
-  WiFi.mode((WiFiMode_t)currentmode);
-  esp3d_log("Restored WiFi mode to %d", currentmode);
 }
 
 void MKSService::handleFrame(const uint8_t type, const uint8_t *dataFrame,
@@ -633,17 +764,22 @@ void MKSService::messageWiFiConfig(const uint8_t *dataFrame, const size_t dataSi
 
 bool MKSService::canSendFrame() {
   esp3d_log("Checking if board is ready for frame");
+  _boardReady = false;
   digitalWrite(ESP_FLAG_PIN, BOARD_READY_FLAG_VALUE);
+  // board may already be ready, no edge will come in that case
+  if (digitalRead(BOARD_FLAG_PIN) == BOARD_READY_FLAG_VALUE) {
+    _boardReady = true;
+  }
   uint32_t startTime = millis();
-  while ((millis() - startTime) < FRAME_WAIT_TO_SEND_TIMEOUT) {
-    if (digitalRead(BOARD_FLAG_PIN) == BOARD_READY_FLAG_VALUE) {
-      esp3d_log("Board ready");
-      return true;
+  while (!_boardReady) {
+    if ((millis() - startTime) >= FRAME_WAIT_TO_SEND_TIMEOUT) {
+      esp3d_log_e("Board not ready after %d ms", FRAME_WAIT_TO_SEND_TIMEOUT);
+      return false;
     }
     ESP3DHal::wait(0);
   }
-  esp3d_log_e("Board not ready after %d ms", FRAME_WAIT_TO_SEND_TIMEOUT);
-  return false;
+  esp3d_log("Board ready");
+  return true;
 }
 
 void MKSService::sendFrameDone() {
@@ -656,24 +792,25 @@ bool MKSService::sendGcodeFrame(const char *cmd) {
     esp3d_log_e("Cannot send G-code in upload mode");
     return false;
   }
-  String tmp = cmd;
-  if (tmp.endsWith("\n")) {
-    tmp[tmp.length() - 1] = '\0';
+  size_t len = strlen(cmd);
+  if (len > 0 && cmd[len - 1] == '\n') {
+    len--;
   }
-  esp3d_log("Sending G-code: %s, size=%d", tmp.c_str(), strlen(tmp.c_str()));
-  clearFrame();
+  if (len + 7 > MKS_FRAME_SIZE) {
+    esp3d_log_e("G-code too long for frame: %d", len);
+    return false;
+  }
+  esp3d_log("Sending G-code: %.*s, size=%d", (int)len, cmd, len);
   _frame[MKS_FRAME_HEAD_OFFSET] = MKS_FRAME_HEAD_FLAG;
   _frame[MKS_FRAME_TYPE_OFFSET] = MKS_FRAME_DATA_COMMAND_TYPE;
-  for (uint i = 0; i < strlen(tmp.c_str()); i++) {
-    _frame[MKS_FRAME_DATA_OFFSET + i] = tmp[i];
-  }
-  _frame[MKS_FRAME_DATA_OFFSET + strlen(tmp.c_str())] = '\r';
-  _frame[MKS_FRAME_DATA_OFFSET + strlen(tmp.c_str()) + 1] = '\n';
-  _frame[MKS_FRAME_DATA_OFFSET + strlen(tmp.c_str()) + 2] = MKS_FRAME_TAIL_FLAG;
-  _frame[MKS_FRAME_DATALEN_OFFSET] = (strlen(tmp.c_str()) + 2) & 0xff;
-  _frame[MKS_FRAME_DATALEN_OFFSET + 1] = ((strlen(tmp.c_str()) + 2) >> 8) & 0xff;
+  _frame[MKS_FRAME_DATALEN_OFFSET] = (len + 2) & 0xff;
+  _frame[MKS_FRAME_DATALEN_OFFSET + 1] = ((len + 2) >> 8) & 0xff;
+  memcpy(&_frame[MKS_FRAME_DATA_OFFSET], cmd, len);
+  _frame[MKS_FRAME_DATA_OFFSET + len] = '\r';
+  _frame[MKS_FRAME_DATA_OFFSET + len + 1] = '\n';
+  _frame[MKS_FRAME_DATA_OFFSET + len + 2] = MKS_FRAME_TAIL_FLAG;
   if (canSendFrame()) {
-    if (esp3d_serial_service.writeBytes(_frame, strlen(tmp.c_str()) + 7) == (strlen(tmp.c_str()) + 7)) {
+    if (esp3d_serial_service.writeBytes(_frame, len + 7) == (len + 7)) {
       esp3d_log("G-code frame sent successfully");
       sendFrameDone();
       return true;
@@ -827,12 +964,22 @@ void MKSService::clearFrame(uint start) {
 
 void MKSService::handle() {
   if (_started) {
-    sendNetworkFrame();
+    if (_hotspotsPending && !WiFiScan::isRunning()) {
+      sendHotspotsList();
+    }
+    if (_uploadMode) {
+      pumpUpload();
+    } else {
+      sendNetworkFrame();
+    }
   }
 }
 
 void MKSService::end() {
   esp3d_log("Stopping MKS service");
+  if (_started) {
+    detachInterrupt(digitalPinToInterrupt(BOARD_FLAG_PIN));
+  }
   _started = false;
 }
 
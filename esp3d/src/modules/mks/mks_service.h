@@ -45,11 +45,19 @@ class MKSService {
   static uint getFragmentID(uint32_t fragmentNumber, bool isLast = false);
   static void commandMode(bool fromSettings = false);
   static void uploadMode();
+  // Pipelined upload: one frame is filled while the other drains to UART
+  static bool startUpload(const char* filename, size_t filesize);
+  static bool uploadData(const uint8_t* data, size_t len);
+  static bool endUpload(bool success = true);
+  // effective speed of current/last upload in bytes per second
+  static uint32_t uploadRate() { return _uploadRate; }
 
  private:
   static uint8_t _uploadStatus;
   static long _commandBaudRate;
   static void sendWifiHotspots();
+  static void sendHotspotsList();
+  static bool _hotspotsPending;
   static void messageWiFiControl(const uint8_t* dataFrame,
                                  const size_t dataSize);
   static void messageException(const uint8_t* dataFrame, const size_t dataSize);
@@ -58,10 +66,28 @@ class MKSService {
   static void clearFrame(uint start = 0);
   static bool canSendFrame();
   static void sendFrameDone();
+  static void IRAM_ATTR boardReadyISR();
+  static void buildFragmentFrame(uint8_t* frame, const size_t dataSize,
+                                 uint fragmentID);
+  static bool queueFragment(bool isLast);
+  static void pumpUpload();
+  static bool drainUpload();
+  static void updateUploadRate();
   static bool _started;
   static uint8_t _frame[MKS_FRAME_SIZE];
   static char _moduleId[22];
   static bool _uploadMode;
+  static volatile bool _boardReady;
+  static uint8_t _uploadFrames[2][MKS_FRAME_SIZE];
+  static uint8_t _fillIndex;
+  static size_t _fillSize;
+  static int8_t _txIndex;
+  static size_t _txOffset;
+  static size_t _txSize;
+  static uint32_t _fragmentNumber;
+  static uint32_t _uploadStartTime;
+  static uint32_t _uploadedBytes;
+  static uint32_t _uploadRate;
 };
 
 #endif  //_SERIAL_SERVICES_H
@@ -0,0 +1,388 @@
+/*
+  printer_state.cpp - printer state tracking class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "../../include/esp3d_config.h"
+#if defined(PRINTER_STATE_FEATURE)
+#include "../../core/esp3d_commands.h"
+#include "../../core/esp3d_settings.h"
+#include "printer_state.h"
+#if defined(GCODE_HOST_FEATURE)
+#include "../gcode_host/gcode_host.h"
+#endif  // GCODE_HOST_FEATURE
+
+ESP3DPrinterState esp3d_printer_state;
+
+// Queries sent one after the other, each one every interval
+static const char* const printerQueries[] = {"M105\n", "M114\n", "M27\n"};
+#define NB_PRINTER_QUERIES (sizeof(printerQueries) / sizeof(printerQueries[0]))
+
+// Value after "key:" if key starts a token of line, else nullptr
+static const char* findToken(const char* line, const char* key) {
+  size_t keyLen = strlen(key);
+  for (const char* p = line; (p = strstr(p, key)) != nullptr; p++) {
+    if ((p == line || p[-1] == ' ') && p[keyLen] == ':') {
+      return p + keyLen + 1;
+    }
+  }
+  return nullptr;
+}
+
+// "current /target", target is optional
+static bool readTemperature(const char* p, ESP3DTemperature& temperature) {
+  char* end;
+  float current = strtof(p, &end);
+  if (end == p) {
+    return false;
+  }
+  temperature.current = current;
+  while (*end == ' ') {
+    end++;
+  }
+  if (*end == '/') {
+    temperature.target = strtof(end + 1, nullptr);
+  }
+  return true;
+}
+
+static uint32_t updateTime() {
+  uint32_t now = millis();
+  // 0 means never updated
+  return now ? now : 1;
+}
+
+ESP3DPrinterState::ESP3DPrinterState() {
+  _interval = ESP3D_PRINTER_STATE_INTERVAL;
+  end();
+}
+
+void ESP3DPrinterState::begin() {
+  end();
+  _lastPoll = millis();
+}
+
+void ESP3DPrinterState::end() {
+  memset(&_data, 0, sizeof(_data));
+  _lineSize = 0;
+  _lineOverflow = false;
+  _nextQuery = 0;
+  _lastPoll = 0;
+}
+
+bool ESP3DPrinterState::isGrbl() {
+  uint8_t fw = ESP3DSettings::GetFirmwareTarget();
+  return fw == GRBL || fw == GRBLHAL;
+}
+
+void ESP3DPrinterState::handle() {
+#if defined(GCODE_HOST_FEATURE)
+  // Stream progress is known here, no need to ask printer
+  if (esp3d_gcode_host.getStatus() != HOST_NO_STREAM &&
+      esp3d_gcode_host.totalSize() > 0) {
+    _data.hasProgress = true;
+    _data.printing = true;
+    _data.printed = esp3d_gcode_host.processedSize();
+    _data.size = esp3d_gcode_host.totalSize();
+    _data.progressTime = updateTime();
+  }
+#endif  // GCODE_HOST_FEATURE
+  if (_interval == 0 || (millis() - _lastPoll) < _interval) {
+    return;
+  }
+  _lastPoll = millis();
+  poll();
+}
+
+void ESP3DPrinterState::poll() {
+  if (isGrbl()) {
+    // Status report is a realtime command, it does not need an ok
+    esp3d_commands.dispatch("?", esp3d_commands.getOutputClient(), no_id,
+                            ESP3DMessageType::realtimecmd,
+                            ESP3DClientType::system,
+                            ESP3DAuthenticationLevel::admin);
+    return;
+  }
+  uint8_t fw = ESP3DSettings::GetFirmwareTarget();
+  if (fw == UNKNOWN_FW || fw == HP_GL) {
+    return;
+  }
+#if defined(GCODE_HOST_FEATURE)
+  // The ok of a query would be taken as ack of streamed line
+  if (esp3d_gcode_host.getStatus() != HOST_NO_STREAM) {
+    return;
+  }
+#endif  // GCODE_HOST_FEATURE
+  esp3d_commands.dispatch(printerQueries[_nextQuery],
+                          esp3d_commands.getOutputClient(), no_id,
+                          ESP3DMessageType::unique, ESP3DClientType::system,
+                          ESP3DAuthenticationLevel::admin);
+  _nextQuery = (_nextQuery + 1) % NB_PRINTER_QUERIES;
+}
+
+void ESP3DPrinterState::parse(const uint8_t* data, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    char c = (char)data[i];
+    if (c == '\n' || c == '\r') {
+      if (!_lineOverflow && _lineSize > 0) {
+        _line[_lineSize] = '\0';
+        parseLine(_line);
+      }
+      _lineSize = 0;
+      _lineOverflow = false;
+    } else if (_lineSize < ESP3D_PRINTER_STATE_LINE_SIZE) {
+      _line[_lineSize++] = c;
+    } else {
+      // Too long for a state answer, ignore the whole line
+      _lineOverflow = true;
+    }
+  }
+}
+
+void ESP3DPrinterState::parseLine(const char* line) {
+  if (isGrbl()) {
+    if (line[0] == '<') {
+      parseGrblStatus(line);
+    }
+    return;
+  }
+  if (strstr(line, "SD printing") || strstr(line, "Not SD printing")) {
+    parseProgress(line);
+  } else if (findToken(line, "X") && findToken(line, "Y")) {
+    parsePosition(line);
+  } else if (findToken(line, "T") || findToken(line, "T0") ||
+             findToken(line, "B")) {
+    parseTemperatures(line);
+  }
+}
+
+// ok T:210.0 /210.0 B:60.0 /60.0 T0:210.0 /210.0 T1:25.0 /0.0 @:0 B@:0
+void ESP3DPrinterState::parseTemperatures(const char* line) {
+  bool updated = false;
+  char key[4] = "T0";
+  for (uint8_t i = 0; i < ESP3D_PRINTER_STATE_MAX_EXTRUDERS; i++) {
+    key[1] = '0' + i;
+    const char* p = findToken(line, key);
+    if (p && readTemperature(p, _data.extruders[i])) {
+      if (_data.nbExtruders < i + 1) {
+        _data.nbExtruders = i + 1;
+      }
+      updated = true;
+    }
+  }
+  // T alone is current extruder, only used when there is a single one
+  if (!updated) {
+    const char* p = findToken(line, "T");
+    if (p && readTemperature(p, _data.extruders[0])) {
+      if (_data.nbExtruders == 0) {
+        _data.nbExtruders = 1;
+      }
+      updated = true;
+    }
+  }
+  const char* p = findToken(line, "B");
+  if (p && readTemperature(p, _data.bed)) {
+    _data.hasBed = true;
+    updated = true;
+  }
+  p = findToken(line, "C");
+  if (p && readTemperature(p, _data.chamber)) {
+    _data.hasChamber = true;
+    updated = true;
+  }
+  if (updated) {
+    _data.temperaturesTime = updateTime();
+  }
+}
+
+// X:10.00 Y:20.00 Z:0.30 E:0.00 Count X:800 Y:1600 Z:120
+void ESP3DPrinterState::parsePosition(const char* line) {
+  static const char* const axes[] = {"X", "Y", "Z", "E"};
+  // Steps count follows, same letters must not be read again
+  const char* count = strstr(line, "Count");
+  for (uint8_t i = 0; i < 4; i++) {
+    const char* p = findToken(line, axes[i]);
+    if (p && (!count || p < count)) {
+      _data.position[i] = strtof(p, nullptr);
+    }
+  }
+  _data.hasPosition = true;
+  _data.positionTime = updateTime();
+}
+
+// SD printing byte 1234/56789 or Not SD printing
+void ESP3DPrinterState::parseProgress(const char* line) {
+  const char* p = strstr(line, "byte");
+  _data.hasProgress = true;
+  _data.printing = false;
+  if (!strstr(line, "Not SD printing") && p) {
+    char* end;
+    uint32_t printed = strtoul(p + 4, &end, 10);
+    if (*end == '/') {
+      _data.printed = printed;
+      _data.size = strtoul(end + 1, nullptr, 10);
+      _data.printing = true;
+    }
+  }
+  _data.progressTime = updateTime();
+}
+
+// <Idle|MPos:0.000,0.000,0.000|FS:0,0> or <Idle,MPos:0.000,0.000,0.000,...>
+void ESP3DPrinterState::parseGrblStatus(const char* line) {
+  size_t i = 0;
+  line++;
+  while (line[i] && line[i] != '|' && line[i] != ',' && line[i] != '>' &&
+         i < sizeof(_data.machineState) - 1) {
+    _data.machineState[i] = line[i];
+    i++;
+  }
+  _data.machineState[i] = '\0';
+  const char* p = strstr(line, "WPos:");
+  if (!p) {
+    p = strstr(line, "MPos:");
+  }
+  if (p) {
+    p += 5;
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      char* end;
+      _data.position[axis] = strtof(p, &end);
+      if (end == p || *end != ',') {
+        break;
+      }
+      p = end + 1;
+    }
+    _data.hasPosition = true;
+    _data.positionTime = updateTime();
+  }
+}
+
+static void addTemperature(String& s, bool json, const char* name,
+                           const ESP3DTemperature& temperature) {
+  if (json) {
+    s += "\"";
+    s += name;
+    s += "\":[";
+    s += String(temperature.current, 1);
+    s += ",";
+    s += String(temperature.target, 1);
+    s += "]";
+  } else {
+    s += name;
+    s += ":";
+    s += String(temperature.current, 1);
+    s += "/";
+    s += String(temperature.target, 1);
+  }
+}
+
+static void addAge(String& s, bool json, const char* name, uint32_t time) {
+  if (time == 0) {
+    return;
+  }
+  if (json) {
+    s += ",\"";
+    s += name;
+    s += "Age\":";
+  } else {
+    s += " (";
+  }
+  s += String(millis() - time);
+  if (!json) {
+    s += "ms ago)";
+  }
+}
+
+String ESP3DPrinterState::toString(bool json) {
+  static const char* const axes[] = {"X", "Y", "Z", "E"};
+  String s;
+  s.reserve(256);
+  s = json ? "{\"interval\":" : "interval: ";
+  s += String(_interval);
+  if (_data.nbExtruders || _data.hasBed || _data.hasChamber) {
+    s += json ? ",\"temperatures\":{" : "\ntemperatures: ";
+    bool first = true;
+    char name[4] = "T0";
+    for (uint8_t i = 0; i < _data.nbExtruders; i++) {
+      name[1] = '0' + i;
+      if (!first) {
+        s += json ? "," : " ";
+      }
+      addTemperature(s, json, name, _data.extruders[i]);
+      first = false;
+    }
+    if (_data.hasBed) {
+      if (!first) {
+        s += json ? "," : " ";
+      }
+      addTemperature(s, json, "B", _data.bed);
+      first = false;
+    }
+    if (_data.hasChamber) {
+      if (!first) {
+        s += json ? "," : " ";
+      }
+      addTemperature(s, json, "C", _data.chamber);
+    }
+    if (json) {
+      s += "}";
+    }
+    addAge(s, json, "temperatures", _data.temperaturesTime);
+  }
+  if (_data.hasPosition) {
+    s += json ? ",\"position\":{" : "\nposition: ";
+    uint8_t nbAxes = isGrbl() ? 3 : 4;
+    for (uint8_t i = 0; i < nbAxes; i++) {
+      if (i > 0) {
+        s += json ? "," : " ";
+      }
+      s += json ? "\"" : "";
+      s += axes[i];
+      s += json ? "\":" : ":";
+      s += String(_data.position[i], 3);
+    }
+    if (json) {
+      s += "}";
+    }
+    addAge(s, json, "position", _data.positionTime);
+  }
+  if (_data.machineState[0] != '\0') {
+    s += json ? ",\"state\":\"" : "\nstate: ";
+    s += _data.machineState;
+    s += json ? "\"" : "";
+  }
+  if (_data.hasProgress) {
+    s += json ? ",\"printing\":" : "\nprinting: ";
+    s += _data.printing ? (json ? "true" : "yes") : (json ? "false" : "no");
+    if (_data.printing && _data.size > 0) {
+      s += json ? ",\"progress\":" : ", progress: ";
+      s += String(100.0 * _data.printed / _data.size, 1);
+      s += json ? ",\"printed\":" : "% (";
+      s += String(_data.printed);
+      s += json ? ",\"size\":" : "/";
+      s += String(_data.size);
+      s += json ? "" : ")";
+    }
+    addAge(s, json, "progress", _data.progressTime);
+  }
+  if (json) {
+    s += "}";
+  }
+  return s;
+}
+
+#endif  // PRINTER_STATE_FEATURE
@@ -0,0 +1,93 @@
+/*
+  printer_state.h - printer state tracking class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _PRINTER_STATE_H
+#define _PRINTER_STATE_H
+
+#include <Arduino.h>
+
+// Time between 2 queries sent to printer (ms), 0 disables queries
+#ifndef ESP3D_PRINTER_STATE_INTERVAL
+#define ESP3D_PRINTER_STATE_INTERVAL 3000
+#endif  // ESP3D_PRINTER_STATE_INTERVAL
+
+#define ESP3D_PRINTER_STATE_MAX_EXTRUDERS 4
+// Longest printer answer line that is parsed
+#define ESP3D_PRINTER_STATE_LINE_SIZE 160
+
+struct ESP3DTemperature {
+  float current;
+  float target;
+};
+
+struct ESP3DPrinterStateData {
+  uint8_t nbExtruders;
+  bool hasBed;
+  bool hasChamber;
+  bool hasPosition;
+  bool hasProgress;
+  bool printing;
+  ESP3DTemperature extruders[ESP3D_PRINTER_STATE_MAX_EXTRUDERS];
+  ESP3DTemperature bed;
+  ESP3DTemperature chamber;
+  float position[4];  // X Y Z E
+  uint32_t printed;   // bytes
+  uint32_t size;      // bytes
+  char machineState[16];  // Grbl state (Idle, Run, Hold...)
+  // millis() of last update, 0 if never updated
+  uint32_t temperaturesTime;
+  uint32_t positionTime;
+  uint32_t progressTime;
+};
+
+class ESP3DPrinterState {
+ public:
+  ESP3DPrinterState();
+  void begin();
+  void end();
+  void handle();
+  // Data coming from printer, may be partial lines
+  void parse(const uint8_t* data, size_t size);
+  void setInterval(uint32_t interval) { _interval = interval; }
+  uint32_t interval() { return _interval; }
+  const ESP3DPrinterStateData& data() { return _data; }
+  // state as JSON object or as plain text
+  String toString(bool json);
+
+ private:
+  void parseLine(const char* line);
+  void parseTemperatures(const char* line);
+  void parsePosition(const char* line);
+  void parseProgress(const char* line);
+  void parseGrblStatus(const char* line);
+  bool isGrbl();
+  void poll();
+  uint32_t _interval;
+  uint32_t _lastPoll;
+  uint8_t _nextQuery;
+  ESP3DPrinterStateData _data;
+  char _line[ESP3D_PRINTER_STATE_LINE_SIZE + 1];
+  size_t _lineSize;
+  bool _lineOverflow;
+};
+
+extern ESP3DPrinterState esp3d_printer_state;
+
+#endif  //_PRINTER_STATE_H
@@ -62,9 +62,15 @@ const char *AnalogSensorDevice::GetCurrentModelString() {
 
 const char *AnalogSensorDevice::GetModelString(uint8_t i) { return "ANALOG"; }
 
+uint8_t AnalogSensorDevice::nbValues() { return 1; }
+
+const char *AnalogSensorDevice::GetValueUnit(uint8_t i) { return SENSOR__UNIT; }
+
 const char *AnalogSensorDevice::GetData() {
   static String s;
-  s = String(SENSOR_CONVERTER(analogRead(ESP3D_SENSOR_PIN))) + "[";
+  _values[0] = SENSOR_CONVERTER(analogRead(ESP3D_SENSOR_PIN));
+  _nbValues = 1;
+  s = String(_values[0]) + "[";
   s += SENSOR__UNIT;
   s += "]";
   return s.c_str();
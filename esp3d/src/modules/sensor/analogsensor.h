@@ -36,6 +36,8 @@ class AnalogSensorDevice : ESP3DSensorDevice {
   const char *GetModelString(uint8_t i = 0);
   const char *GetCurrentModelString();
   const char *GetData();
+  uint8_t nbValues();
+  const char *GetValueUnit(uint8_t i);
 };
 
 #endif  //_ANALOG_SENSOR_H
@@ -134,8 +134,20 @@ const char *BMX280SensorDevice::GetModelString(uint8_t i) {
 // helper function
 float toFahrenheit(float fromCelcius) { return 1.8 * fromCelcius + 32.0; };
 
+uint8_t BMX280SensorDevice::nbValues() {
+  if (bmx280_device) {
+    return bmx280_device->isBME280() ? 3 : 2;
+  }
+  return 0;
+}
+
+const char *BMX280SensorDevice::GetValueUnit(uint8_t i) {
+  return i == 0 ? SENSOR__UNIT : i == 1 ? "Pa" : "%";
+}
+
 const char *BMX280SensorDevice::GetData() {
   static String s;
+  _nbValues = 0;
   if (bmx280_device) {
     if (!bmx280_device->measure()) {
       s = "BUSY";
@@ -164,8 +176,13 @@ const char *BMX280SensorDevice::GetData() {
           s += SENSOR__UNIT;
           s += "] " + String(pressure, 1);
           s += "[Pa]";
+          _values[0] = temperature;
+          _values[1] = pressure;
+          _nbValues = 2;
           if (bmx280_device->isBME280()) {
             s += " " + String(humidity, 1) + "[%]";
+            _values[2] = humidity;
+            _nbValues = 3;
           }
         } else {
           s = "DISCONNECTED";
@@ -35,6 +35,8 @@ class BMX280SensorDevice : ESP3DSensorDevice {
   const char *GetModelString(uint8_t i = 0);
   const char *GetCurrentModelString();
   const char *GetData();
+  uint8_t nbValues();
+  const char *GetValueUnit(uint8_t i);
 };
 
 #endif  //_BMX280_SENSOR_H
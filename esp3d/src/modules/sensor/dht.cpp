@@ -124,8 +124,15 @@ const char *DHTSensorDevice::GetModelString(uint8_t i) {
   return "NONE";
 }
 
+uint8_t DHTSensorDevice::nbValues() { return 2; }
+
+const char *DHTSensorDevice::GetValueUnit(uint8_t i) {
+  return i == 0 ? SENSOR__UNIT : "%";
+}
+
 const char *DHTSensorDevice::GetData() {
   static String s;
+  _nbValues = 0;
   if (dht_device) {
     float temperature = dht_device->getTemperature();
     float humidity = dht_device->getHumidity();
@@ -138,6 +145,9 @@ const char *DHTSensorDevice::GetData() {
       s += "[";
       s += SENSOR__UNIT;
       s += "] " + String(humidity, 1) + "[%]";
+      _values[0] = temperature;
+      _values[1] = humidity;
+      _nbValues = 2;
     } else {
       s = "DISCONNECTED";
       esp3d_log_e("No valid data");
@@ -36,6 +36,8 @@ class DHTSensorDevice : ESP3DSensorDevice {
   const char *GetModelString(uint8_t i = 0);
   const char *GetCurrentModelString();
   const char *GetData();
+  uint8_t nbValues();
+  const char *GetValueUnit(uint8_t i);
 };
 
 #endif  //_DHT_SENSOR_H
@@ -75,6 +75,13 @@ bool ESP3DSensor::begin() {
   if (!_device->begin()) {
     res = false;
   }
+  const char* units[ESP3D_SENSOR_MAX_VALUES];
+  uint8_t nbValues = _device->nbValues();
+  for (uint8_t i = 0; i < nbValues; i++) {
+    units[i] = _device->GetValueUnit(i);
+  }
+  _history.clear();
+  _history.setUnits(nbValues, units);
   _lastReadTime = millis();
   _started = res;
   return _started;
@@ -152,6 +159,8 @@ void ESP3DSensor::handle() {
     if ((millis() - _lastReadTime) > _interval) {
       String data = _device->GetData();
       _lastReadTime = millis();
+      float values[ESP3D_SENSOR_MAX_VALUES];
+      _history.add(values, _device->GetValues(values));
 #if defined(WIFI_FEATURE) || defined(ETH_FEATURE)
       String s = "SENSOR:" + data;
       esp3d_commands.dispatch(s.c_str(), ESP3DClientType::webui_websocket,
@@ -21,9 +21,11 @@
 #ifndef _ESP3D_SENSOR_H
 #define _ESP3D_SENSOR_H
 
+#include "sensor_history.h"
+
 class ESP3DSensorDevice {
  public:
-  ESP3DSensorDevice() {}
+  ESP3DSensorDevice() { _nbValues = 0; }
   virtual ~ESP3DSensorDevice() {}
   virtual bool begin() { return false; }
   virtual void end() {}
@@ -34,6 +36,17 @@ class ESP3DSensorDevice {
   virtual const char *GetCurrentModelString() { return "None"; }
   virtual const char *GetModelString(uint8_t i = 0) { return "None"; }
   virtual const char *GetData() { return ""; }
+  virtual uint8_t nbValues() { return 0; }
+  virtual const char *GetValueUnit(uint8_t i) { return ""; }
+  // Values of last GetData(), 0 if reading failed
+  uint8_t GetValues(float *values) {
+    memcpy(values, _values, _nbValues * sizeof(float));
+    return _nbValues;
+  }
+
+ protected:
+  float _values[ESP3D_SENSOR_MAX_VALUES];
+  uint8_t _nbValues;
 };
 
 class ESP3DSensor {
@@ -53,12 +66,14 @@ class ESP3DSensor {
   const char *GetModelString(uint8_t i = 0);
   const char *GetData();
   bool started() { return _started; }
+  ESP3DSensorHistory &history() { return _history; }
 
  protected:
   bool _started;
   uint32_t _interval;
   uint32_t _lastReadTime;
   ESP3DSensorDevice *_device;
+  ESP3DSensorHistory _history;
 };
 
 extern ESP3DSensor esp3d_sensor;
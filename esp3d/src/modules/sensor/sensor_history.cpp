@@ -0,0 +1,432 @@
+/*
+  sensor_history.cpp -  sensor samples history class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "../../include/esp3d_config.h"
+#ifdef SENSOR_DEVICE
+#include "sensor_history.h"
+
+#define MINUTE_PERIOD 60000
+#define QUARTER_PERIOD 900000
+
+enum { STEP_HEAD = 0, STEP_ITEMS, STEP_CURRENT, STEP_TAIL, STEP_DONE };
+
+ESP3DSensorHistory::ESP3DSensorHistory() {
+  _mutex = xSemaphoreCreateMutex();
+  _nbValues = 0;
+  for (uint8_t i = 0; i < ESP3D_SENSOR_MAX_VALUES; i++) {
+    _units[i] = "";
+  }
+  clear();
+}
+
+ESP3DSensorHistory::~ESP3DSensorHistory() { vSemaphoreDelete(_mutex); }
+
+void ESP3DSensorHistory::clear() {
+  _rawTotal = 0;
+  _minuteTotal = 0;
+  _quarterTotal = 0;
+  _currentMinute.count = 0;
+  _currentQuarter.count = 0;
+}
+
+void ESP3DSensorHistory::setUnits(uint8_t nbValues, const char** units) {
+  if (nbValues > ESP3D_SENSOR_MAX_VALUES) {
+    nbValues = ESP3D_SENSOR_MAX_VALUES;
+  }
+  if (xSemaphoreTake(_mutex, portMAX_DELAY) != pdTRUE) {
+    esp3d_log_e("Mutex not taken");
+    return;
+  }
+  if (nbValues != _nbValues) {
+    // Stored samples do not match anymore
+    clear();
+  }
+  _nbValues = nbValues;
+  for (uint8_t i = 0; i < _nbValues; i++) {
+    _units[i] = (units && units[i]) ? units[i] : "";
+  }
+  xSemaphoreGive(_mutex);
+}
+
+void ESP3DSensorHistory::add(const float* values, uint8_t nbValues) {
+  // Failed reading or unexpected sample
+  if (nbValues == 0 || nbValues != _nbValues) {
+    return;
+  }
+  if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+    addSample(values);
+    xSemaphoreGive(_mutex);
+  } else {
+    esp3d_log_e("Mutex not taken");
+  }
+}
+
+void ESP3DSensorHistory::addSample(const float* values) {
+  uint32_t now = millis();
+  ESP3DSensorSample& sample = _raw[_rawTotal % ESP3D_SENSOR_HISTORY_RAW_SIZE];
+  sample.time = now;
+  memcpy(sample.values, values, _nbValues * sizeof(float));
+  _rawTotal++;
+  // Rollups are updated now so queries have nothing to compute
+  if (_currentMinute.count > 0 &&
+      (now - _currentMinute.time) >= MINUTE_PERIOD) {
+    closeMinute();
+  }
+  if (_currentMinute.count == 0) {
+    _currentMinute.time = now;
+    _currentMinute.count = 1;
+    for (uint8_t i = 0; i < _nbValues; i++) {
+      _currentMinute.min[i] = values[i];
+      _currentMinute.avg[i] = values[i];
+      _currentMinute.max[i] = values[i];
+    }
+    return;
+  }
+  _currentMinute.count++;
+  for (uint8_t i = 0; i < _nbValues; i++) {
+    if (values[i] < _currentMinute.min[i]) {
+      _currentMinute.min[i] = values[i];
+    }
+    if (values[i] > _currentMinute.max[i]) {
+      _currentMinute.max[i] = values[i];
+    }
+    _currentMinute.avg[i] +=
+        (values[i] - _currentMinute.avg[i]) / _currentMinute.count;
+  }
+}
+
+void ESP3DSensorHistory::closeMinute() {
+  _minute[_minuteTotal % ESP3D_SENSOR_HISTORY_MINUTE_SIZE] = _currentMinute;
+  _minuteTotal++;
+  if (_currentQuarter.count > 0 &&
+      (_currentMinute.time - _currentQuarter.time) >= QUARTER_PERIOD) {
+    _quarter[_quarterTotal % ESP3D_SENSOR_HISTORY_QUARTER_SIZE] =
+        _currentQuarter;
+    _quarterTotal++;
+    _currentQuarter.count = 0;
+  }
+  mergeRollup(_currentQuarter, _currentMinute);
+  _currentMinute.count = 0;
+}
+
+void ESP3DSensorHistory::mergeRollup(ESP3DSensorRollup& into,
+                                     const ESP3DSensorRollup& from) {
+  if (from.count == 0) {
+    return;
+  }
+  if (into.count == 0) {
+    into = from;
+    return;
+  }
+  uint32_t count = into.count + from.count;
+  for (uint8_t i = 0; i < _nbValues; i++) {
+    if (from.min[i] < into.min[i]) {
+      into.min[i] = from.min[i];
+    }
+    if (from.max[i] > into.max[i]) {
+      into.max[i] = from.max[i];
+    }
+    into.avg[i] = (into.avg[i] * into.count + from.avg[i] * from.count) / count;
+  }
+  into.count = count;
+}
+
+uint32_t ESP3DSensorHistory::size(ESP3DSensorResolution resolution) {
+  switch (resolution) {
+    case ESP3DSensorResolution::minute:
+      return _minuteTotal < ESP3D_SENSOR_HISTORY_MINUTE_SIZE
+                 ? _minuteTotal
+                 : ESP3D_SENSOR_HISTORY_MINUTE_SIZE;
+    case ESP3DSensorResolution::quarter:
+      return _quarterTotal < ESP3D_SENSOR_HISTORY_QUARTER_SIZE
+                 ? _quarterTotal
+                 : ESP3D_SENSOR_HISTORY_QUARTER_SIZE;
+    default:
+      return _rawTotal < ESP3D_SENSOR_HISTORY_RAW_SIZE
+                 ? _rawTotal
+                 : ESP3D_SENSOR_HISTORY_RAW_SIZE;
+  }
+}
+
+void ESP3DSensorHistory::initCursor(ESP3DSensorCursor& cursor,
+                                    ESP3DSensorResolution resolution,
+                                    uint32_t since, bool json) {
+  cursor.resolution = resolution;
+  cursor.json = json;
+  cursor.first = true;
+  cursor.step = STEP_HEAD;
+  cursor.itemLen = 0;
+  cursor.offset = 0;
+  cursor.since = since;
+  cursor.now = millis();
+  cursor.end = 0;
+  cursor.index = 0;
+  if (xSemaphoreTake(_mutex, portMAX_DELAY) != pdTRUE) {
+    esp3d_log_e("Mutex not taken");
+    return;
+  }
+  switch (resolution) {
+    case ESP3DSensorResolution::minute:
+      cursor.end = _minuteTotal;
+      break;
+    case ESP3DSensorResolution::quarter:
+      cursor.end = _quarterTotal;
+      break;
+    default:
+      cursor.end = _rawTotal;
+      break;
+  }
+  cursor.index = cursor.end - size(resolution);
+  xSemaphoreGive(_mutex);
+}
+
+bool ESP3DSensorHistory::isNewer(const ESP3DSensorCursor& cursor,
+                                 uint32_t time) {
+  // since 0 means everything, else compare with millis() rollover in mind
+  return cursor.since == 0 || (int32_t)(time - cursor.since) > 0;
+}
+
+size_t ESP3DSensorHistory::formatSample(const ESP3DSensorCursor& cursor,
+                                        const ESP3DSensorSample& sample,
+                                        char* buffer, size_t maxSize) {
+  size_t pos = 0;
+  pos += snprintf(buffer + pos, maxSize - pos, cursor.json ? "%s[%u" : "%s%u",
+                  cursor.json && !cursor.first ? "," : "",
+                  (unsigned int)sample.time);
+  for (uint8_t i = 0; i < _nbValues && pos < maxSize; i++) {
+    pos += snprintf(buffer + pos, maxSize - pos, cursor.json ? ",%.2f" : " %.2f",
+                    sample.values[i]);
+  }
+  if (pos < maxSize) {
+    pos += snprintf(buffer + pos, maxSize - pos, cursor.json ? "]" : "\n");
+  }
+  return pos < maxSize ? pos : maxSize - 1;
+}
+
+size_t ESP3DSensorHistory::formatRollup(const ESP3DSensorCursor& cursor,
+                                        const ESP3DSensorRollup& rollup,
+                                        char* buffer, size_t maxSize) {
+  size_t pos = 0;
+  pos += snprintf(buffer + pos, maxSize - pos,
+                  cursor.json ? "%s[%u,%u" : "%s%u %u",
+                  cursor.json && !cursor.first ? "," : "",
+                  (unsigned int)rollup.time, (unsigned int)rollup.count);
+  for (uint8_t i = 0; i < _nbValues && pos < maxSize; i++) {
+    pos += snprintf(buffer + pos, maxSize - pos,
+                    cursor.json ? ",[%.2f,%.2f,%.2f]" : " %.2f/%.2f/%.2f",
+                    rollup.min[i], rollup.avg[i], rollup.max[i]);
+  }
+  if (pos < maxSize) {
+    pos += snprintf(buffer + pos, maxSize - pos, cursor.json ? "]" : "\n");
+  }
+  return pos < maxSize ? pos : maxSize - 1;
+}
+
+// Copy what fits of current item, the rest is sent on next read
+void ESP3DSensorHistory::emit(ESP3DSensorCursor& cursor, char* buffer,
+                              size_t maxSize, size_t& written) {
+  size_t len = cursor.itemLen - cursor.offset;
+  if (len > maxSize - written) {
+    len = maxSize - written;
+  }
+  memcpy(buffer + written, cursor.item + cursor.offset, len);
+  written += len;
+  cursor.offset += len;
+}
+
+// Format next item of the answer in cursor, or only move to next step.
+// Entries are copied under mutex, formatting is done on the copy.
+void ESP3DSensorHistory::nextItem(ESP3DSensorCursor& cursor) {
+  char* item = cursor.item;
+  size_t len = 0;
+  switch (cursor.step) {
+    case STEP_HEAD:
+      if (cursor.json) {
+        len = snprintf(item, sizeof(cursor.item),
+                       "{\"cmd\":\"210\",\"status\":\"ok\",\"data\":{"
+                       "\"now\":%u,\"resolution\":\"%s\",\"units\":[",
+                       (unsigned int)cursor.now,
+                       resolutionString(cursor.resolution));
+        for (uint8_t i = 0; i < _nbValues && len < sizeof(cursor.item); i++) {
+          len += snprintf(item + len, sizeof(cursor.item) - len, "%s\"%s\"",
+                          i > 0 ? "," : "", _units[i]);
+        }
+        if (len < sizeof(cursor.item)) {
+          len += snprintf(item + len, sizeof(cursor.item) - len,
+                          "],\"values\":[");
+        }
+      } else {
+        len = snprintf(item, sizeof(cursor.item), "now: %u, resolution: %s\n",
+                       (unsigned int)cursor.now,
+                       resolutionString(cursor.resolution));
+      }
+      if (len >= sizeof(cursor.item)) {
+        len = sizeof(cursor.item) - 1;
+      }
+      cursor.step = STEP_ITEMS;
+      break;
+    case STEP_ITEMS: {
+      if (cursor.index >= cursor.end) {
+        cursor.step = cursor.resolution == ESP3DSensorResolution::raw
+                          ? STEP_TAIL
+                          : STEP_CURRENT;
+        break;
+      }
+      uint32_t ringSize;
+      switch (cursor.resolution) {
+        case ESP3DSensorResolution::minute:
+          ringSize = ESP3D_SENSOR_HISTORY_MINUTE_SIZE;
+          break;
+        case ESP3DSensorResolution::quarter:
+          ringSize = ESP3D_SENSOR_HISTORY_QUARTER_SIZE;
+          break;
+        default:
+          ringSize = ESP3D_SENSOR_HISTORY_RAW_SIZE;
+          break;
+      }
+      ESP3DSensorSample sample;
+      ESP3DSensorRollup rollup;
+      bool found = false;
+      if (xSemaphoreTake(_mutex, portMAX_DELAY) != pdTRUE) {
+        esp3d_log_e("Mutex not taken");
+        cursor.step = STEP_TAIL;
+        break;
+      }
+      uint32_t total = _rawTotal;
+      if (cursor.resolution == ESP3DSensorResolution::minute) {
+        total = _minuteTotal;
+      } else if (cursor.resolution == ESP3DSensorResolution::quarter) {
+        total = _quarterTotal;
+      }
+      // Entries overwritten since previous read are lost
+      if (total - cursor.index > ringSize) {
+        cursor.index = total - ringSize;
+      }
+      if (cursor.index < cursor.end) {
+        found = true;
+        if (cursor.resolution == ESP3DSensorResolution::raw) {
+          sample = _raw[cursor.index % ringSize];
+        } else if (cursor.resolution == ESP3DSensorResolution::minute) {
+          rollup = _minute[cursor.index % ringSize];
+        } else {
+          rollup = _quarter[cursor.index % ringSize];
+        }
+      }
+      xSemaphoreGive(_mutex);
+      if (!found) {
+        break;
+      }
+      if (cursor.resolution == ESP3DSensorResolution::raw) {
+        if (isNewer(cursor, sample.time)) {
+          len = formatSample(cursor, sample, item, sizeof(cursor.item));
+        }
+      } else if (isNewer(cursor, rollup.time)) {
+        len = formatRollup(cursor, rollup, item, sizeof(cursor.item));
+      }
+      if (len > 0) {
+        cursor.first = false;
+      }
+      cursor.index++;
+    } break;
+    case STEP_CURRENT: {
+      // Period in progress is sent last so client has latest values
+      ESP3DSensorRollup current;
+      ESP3DSensorRollup minute;
+      current.count = 0;
+      if (xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+        minute = _currentMinute;
+        current = cursor.resolution == ESP3DSensorResolution::quarter
+                      ? _currentQuarter
+                      : _currentMinute;
+        xSemaphoreGive(_mutex);
+      } else {
+        esp3d_log_e("Mutex not taken");
+      }
+      if (cursor.resolution == ESP3DSensorResolution::quarter) {
+        if (current.count > 0 && minute.count > 0 &&
+            (minute.time - current.time) >= QUARTER_PERIOD) {
+          current = minute;
+        } else {
+          mergeRollup(current, minute);
+        }
+      }
+      if (current.count > 0 && isNewer(cursor, current.time)) {
+        len = formatRollup(cursor, current, item, sizeof(cursor.item));
+        cursor.first = false;
+      }
+      cursor.step = STEP_TAIL;
+    } break;
+    case STEP_TAIL:
+      if (cursor.json) {
+        memcpy(item, "]}}", 3);
+        len = 3;
+      }
+      cursor.step = STEP_DONE;
+      break;
+    default:
+      cursor.step = STEP_DONE;
+      break;
+  }
+  cursor.itemLen = len;
+  cursor.offset = 0;
+}
+
+size_t ESP3DSensorHistory::read(ESP3DSensorCursor& cursor, char* buffer,
+                                size_t maxSize) {
+  size_t written = 0;
+  while (written < maxSize) {
+    if (cursor.offset < cursor.itemLen) {
+      emit(cursor, buffer, maxSize, written);
+    } else if (cursor.step != STEP_DONE) {
+      nextItem(cursor);
+    } else {
+      break;
+    }
+  }
+  return written;
+}
+
+bool ESP3DSensorHistory::getResolution(const char* s,
+                                       ESP3DSensorResolution& resolution) {
+  if (!s || strlen(s) == 0 || strcmp(s, "raw") == 0) {
+    resolution = ESP3DSensorResolution::raw;
+  } else if (strcmp(s, "1m") == 0) {
+    resolution = ESP3DSensorResolution::minute;
+  } else if (strcmp(s, "15m") == 0) {
+    resolution = ESP3DSensorResolution::quarter;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+const char* ESP3DSensorHistory::resolutionString(
+    ESP3DSensorResolution resolution) {
+  switch (resolution) {
+    case ESP3DSensorResolution::minute:
+      return "1m";
+    case ESP3DSensorResolution::quarter:
+      return "15m";
+    default:
+      return "raw";
+  }
+}
+
+#endif  // SENSOR_DEVICE
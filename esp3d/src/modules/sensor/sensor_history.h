@@ -0,0 +1,151 @@
+/*
+  sensor_history.h -  sensor samples history class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _ESP3D_SENSOR_HISTORY_H
+#define _ESP3D_SENSOR_HISTORY_H
+
+#include <Arduino.h>
+#if defined(ARDUINO_ARCH_ESP32)
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#endif  // ARDUINO_ARCH_ESP32
+
+#if defined(ARDUINO_ARCH_ESP8266)
+#ifndef pdTRUE
+#define pdTRUE true
+#define xSemaphoreTake(A, B) true
+#define xSemaphoreGive(A)
+#define xSemaphoreCreateMutex(A) 0
+#define vSemaphoreDelete(A)
+#define SemaphoreHandle_t void*
+#endif  // pdTRUE
+#endif  // ESP8266
+
+// Values of one sample (temperature, humidity, pressure...)
+#define ESP3D_SENSOR_MAX_VALUES 3
+
+// Number of entries kept for each resolution
+#ifndef ESP3D_SENSOR_HISTORY_RAW_SIZE
+#if defined(ARDUINO_ARCH_ESP32)
+#define ESP3D_SENSOR_HISTORY_RAW_SIZE 180
+#else
+#define ESP3D_SENSOR_HISTORY_RAW_SIZE 40
+#endif  // ARDUINO_ARCH_ESP32
+#endif  // ESP3D_SENSOR_HISTORY_RAW_SIZE
+#ifndef ESP3D_SENSOR_HISTORY_MINUTE_SIZE
+#if defined(ARDUINO_ARCH_ESP32)
+#define ESP3D_SENSOR_HISTORY_MINUTE_SIZE 60
+#else
+#define ESP3D_SENSOR_HISTORY_MINUTE_SIZE 30
+#endif  // ARDUINO_ARCH_ESP32
+#endif  // ESP3D_SENSOR_HISTORY_MINUTE_SIZE
+#ifndef ESP3D_SENSOR_HISTORY_QUARTER_SIZE
+#if defined(ARDUINO_ARCH_ESP32)
+#define ESP3D_SENSOR_HISTORY_QUARTER_SIZE 96
+#else
+#define ESP3D_SENSOR_HISTORY_QUARTER_SIZE 16
+#endif  // ARDUINO_ARCH_ESP32
+#endif  // ESP3D_SENSOR_HISTORY_QUARTER_SIZE
+
+// Longest item of an answer: rollup with all values
+#define ESP3D_SENSOR_HISTORY_ITEM_SIZE 192
+
+enum class ESP3DSensorResolution : uint8_t { raw, minute, quarter };
+
+struct ESP3DSensorSample {
+  uint32_t time;  // millis() of sample
+  float values[ESP3D_SENSOR_MAX_VALUES];
+};
+
+struct ESP3DSensorRollup {
+  uint32_t time;  // millis() of first sample of the period
+  uint32_t count;
+  float min[ESP3D_SENSOR_MAX_VALUES];
+  float avg[ESP3D_SENSOR_MAX_VALUES];
+  float max[ESP3D_SENSOR_MAX_VALUES];
+};
+
+// Position of a query in the history, so the answer can be sent in
+// several parts even if samples are added meanwhile
+struct ESP3DSensorCursor {
+  ESP3DSensorResolution resolution;
+  bool json;
+  bool first;
+  uint8_t step;
+  uint32_t since;
+  uint32_t now;
+  uint32_t index;
+  uint32_t end;
+  // item being sent, kept as formatted so next part matches first one
+  char item[ESP3D_SENSOR_HISTORY_ITEM_SIZE];
+  uint16_t itemLen;
+  // part of item already sent
+  uint16_t offset;
+};
+
+class ESP3DSensorHistory {
+ public:
+  ESP3DSensorHistory();
+  ~ESP3DSensorHistory();
+  void clear();
+  // units are the units of each value, they must stay valid
+  void setUnits(uint8_t nbValues, const char** units);
+  void add(const float* values, uint8_t nbValues);
+  uint32_t size(ESP3DSensorResolution resolution);
+  // Entries newer than since (millis) in the given resolution
+  void initCursor(ESP3DSensorCursor& cursor, ESP3DSensorResolution resolution,
+                  uint32_t since, bool json);
+  // Fill buffer with next part of the answer, return 0 when done, can be
+  // called from another task than add() (e.g. http chunks)
+  size_t read(ESP3DSensorCursor& cursor, char* buffer, size_t maxSize);
+  static bool getResolution(const char* s, ESP3DSensorResolution& resolution);
+  static const char* resolutionString(ESP3DSensorResolution resolution);
+
+ private:
+  void addSample(const float* values);
+  void nextItem(ESP3DSensorCursor& cursor);
+  void closeMinute();
+  void mergeRollup(ESP3DSensorRollup& into, const ESP3DSensorRollup& from);
+  bool isNewer(const ESP3DSensorCursor& cursor, uint32_t time);
+  size_t formatSample(const ESP3DSensorCursor& cursor,
+                      const ESP3DSensorSample& sample, char* buffer,
+                      size_t maxSize);
+  size_t formatRollup(const ESP3DSensorCursor& cursor,
+                      const ESP3DSensorRollup& rollup, char* buffer,
+                      size_t maxSize);
+  void emit(ESP3DSensorCursor& cursor, char* buffer, size_t maxSize,
+            size_t& written);
+  // samples are added and copied for answers under this mutex
+  SemaphoreHandle_t _mutex;
+  uint8_t _nbValues;
+  const char* _units[ESP3D_SENSOR_MAX_VALUES];
+  // total of entries ever added, entry n is at n % ring size
+  uint32_t _rawTotal;
+  uint32_t _minuteTotal;
+  uint32_t _quarterTotal;
+  ESP3DSensorSample _raw[ESP3D_SENSOR_HISTORY_RAW_SIZE];
+  ESP3DSensorRollup _minute[ESP3D_SENSOR_HISTORY_MINUTE_SIZE];
+  ESP3DSensorRollup _quarter[ESP3D_SENSOR_HISTORY_QUARTER_SIZE];
+  // periods in progress
+  ESP3DSensorRollup _currentMinute;
+  ESP3DSensorRollup _currentQuarter;
+};
+
+#endif  //_ESP3D_SENSOR_HISTORY_H
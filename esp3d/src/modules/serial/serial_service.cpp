@@ -24,6 +24,9 @@
 #include "../../core/esp3d_settings.h"
 #include "../../core/esp3d_string.h"
 #include "../authentication/authentication_service.h"
+#if defined(MEATPACK_FEATURE)
+#include "../meatpack/meatpack.h"
+#endif  // MEATPACK_FEATURE
 #include "serial_service.h"
 
 extern HardwareSerial *Serials[];
@@ -119,6 +122,13 @@ size_t ESP3DSerialService::writeBytes(const uint8_t *buffer, size_t size) {
   }
 }
 
+size_t ESP3DSerialService::availableForWrite() {
+  if (!_started) {
+    return 0;
+  }
+  return Serials[_serialIndex]->availableForWrite();
+}
+
 size_t ESP3DSerialService::readBytes(uint8_t *sbuf, size_t len) {
   if (!_started) {
     return -1;
@@ -141,7 +151,15 @@ bool ESP3DSerialService::dispatch(ESP3DMessage *message) {
     if (message) {
       // if message is not null
       if (message->data && message->size != 0) {
-        if (writeBytes(message->data, message->size) == message->size) {
+#if defined(MEATPACK_FEATURE)
+        // once printer accepted packing, everything sent to it is packed
+        size_t sent = (_id == MAIN_SERIAL && esp3d_meatpack.isActive())
+                          ? esp3d_meatpack.write(message->data, message->size)
+                          : writeBytes(message->data, message->size);
+#else
+        size_t sent = writeBytes(message->data, message->size);
+#endif  // MEATPACK_FEATURE
+        if (sent == message->size) {
           flush();
           // Delete message now
           esp3d_message_manager.deleteMsg(message);
@@ -52,6 +52,7 @@ class ESP3DSerialService final {
   void swap();
   #endif // ARDUINO_ARCH_ESP8266
   size_t writeBytes(const uint8_t *buffer, size_t size);
+  size_t availableForWrite();
   size_t readBytes(uint8_t *sbuf, size_t len);
   inline bool started() { return _started; }
   bool dispatch(ESP3DMessage *message);
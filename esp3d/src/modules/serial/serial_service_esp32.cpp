@@ -25,6 +25,12 @@
 #include "../../core/esp3d_settings.h"
 #include "../../core/esp3d_string.h"
 #include "../authentication/authentication_service.h"
+#if defined(PRINTER_STATE_FEATURE)
+#include "../printer_state/printer_state.h"
+#endif  // PRINTER_STATE_FEATURE
+#if defined(MEATPACK_FEATURE)
+#include "../meatpack/meatpack.h"
+#endif  // MEATPACK_FEATURE
 #include "serial_service.h"
 
 #define SERIAL_COMMUNICATION_TIMEOUT 500
@@ -121,7 +127,7 @@ bool ESP3DSerialService::begin(uint8_t serialIndex) {
   _serialIndex = serialIndex - 1;
   esp3d_log("Serial %d begin for %d", _serialIndex, _id);
   if (_id == BRIDGE_SERIAL &&
-      ESP3DSettings::readByte(ESP_SERIAL_BRIDGE_ON) == 0) {
+      ESP3DSettings::readByte(static_cast<int>(ESP3DSettingIndex::esp3d_serial_bridge_on)) == 0) {
     esp3d_log("Serial %d for %d is disabled", _serialIndex, _id);
     return true;
   }
@@ -136,14 +142,14 @@ bool ESP3DSerialService::begin(uint8_t serialIndex) {
   uint32_t defaultBr = 0;
   switch (_id) {
     case MAIN_SERIAL:
-      br = ESP3DSettings::readUint32(ESP_BAUD_RATE);
-      defaultBr = ESP3DSettings::getDefaultIntegerSetting(ESP_BAUD_RATE);
+      br = ESP3DSettings::readUint32(static_cast<int>(ESP3DSettingIndex::esp3d_baud_rate));
+      defaultBr = ESP3DSettings::getDefaultIntegerSetting(ESP3DSettingIndex::esp3d_baud_rate);
       break;
 #if defined(ESP_SERIAL_BRIDGE_OUTPUT)
     case BRIDGE_SERIAL:
-      br = ESP3DSettings::readUint32(ESP_SERIAL_BRIDGE_BAUD);
+      br = ESP3DSettings::readUint32(static_cast<int>(ESP3DSettingIndex::esp3d_serial_bridge_baud));
       defaultBr =
-          ESP3DSettings::getDefaultIntegerSetting(ESP_SERIAL_BRIDGE_BAUD);
+          ESP3DSettings::getDefaultIntegerSetting(ESP3DSettingIndex::esp3d_serial_bridge_baud);
       break;
 #endif  // ESP_SERIAL_BRIDGE_OUTPUT
     default:
@@ -156,7 +162,7 @@ bool ESP3DSerialService::begin(uint8_t serialIndex) {
   _buffer_size = 0;
   // change only if different from current
   if (br != baudRate() || (_rxPin != -1) || (_txPin != -1)) {
-    if (!ESP3DSettings::isValidIntegerSetting(br, ESP_BAUD_RATE)) {
+    if (!ESP3DSettings::isValidIntegerSetting(br, ESP3DSettingIndex::esp3d_baud_rate)) {
       br = defaultBr;
     }
     Serials[_serialIndex]->setRxBufferSize(SERIAL_RX_BUFFER_SIZE);
@@ -220,6 +226,18 @@ void ESP3DSerialService::handle() {
       esp3d_log("Serial in fifo size %d", _messagesInFIFO.size());
       ESP3DMessage *message = _messagesInFIFO.pop();
       if (message) {
+#if defined(PRINTER_STATE_FEATURE)
+        if (_id == MAIN_SERIAL &&
+            message->type != ESP3DMessageType::realtimecmd) {
+          esp3d_printer_state.parse(message->data, message->size);
+        }
+#endif  // PRINTER_STATE_FEATURE
+#if defined(MEATPACK_FEATURE)
+        if (_id == MAIN_SERIAL &&
+            message->type != ESP3DMessageType::realtimecmd) {
+          esp3d_meatpack.parse(message->data, message->size);
+        }
+#endif  // MEATPACK_FEATURE
         esp3d_commands.process(message);
       } else {
         esp3d_log_e("Cannot create message");
@@ -236,17 +254,16 @@ bool ESP3DSerialService::reset() {
   switch (_id) {
     case MAIN_SERIAL:
       return ESP3DSettings::writeUint32(
-          ESP_BAUD_RATE,
-          ESP3DSettings::getDefaultIntegerSetting(ESP_BAUD_RATE));
+          static_cast<int>(ESP3DSettingIndex::esp3d_baud_rate),
+          ESP3DSettings::getDefaultIntegerSetting(ESP3DSettingIndex::esp3d_baud_rate));
 #if defined(ESP_SERIAL_BRIDGE_OUTPUT)
     case BRIDGE_SERIAL:
       res = ESP3DSettings::writeByte(
-          ESP_SERIAL_BRIDGE_ON,
-          ESP3DSettings::getDefaultByteSetting(ESP_SERIAL_BRIDGE_ON));
+          static_cast<int>(ESP3DSettingIndex::esp3d_serial_bridge_on),
+          ESP3DSettings::getDefaultByteSetting(ESP3DSettingIndex::esp3d_serial_bridge_on));
       return res &&
-             ESP3DSettings::writeUint32(ESP_SERIAL_BRIDGE_BAUD,
-                                        ESP3DSettings::getDefaultIntegerSetting(
-                                            ESP_SERIAL_BRIDGE_BAUD));
+             ESP3DSettings::writeUint32(static_cast<int>(ESP3DSettingIndex::esp3d_serial_bridge_baud),
+                                        ESP3DSettings::getDefaultIntegerSetting(ESP3DSettingIndex::esp3d_serial_bridge_baud));
 #endif  // ESP_SERIAL_BRIDGE_OUTPUT
     default:
       return res;
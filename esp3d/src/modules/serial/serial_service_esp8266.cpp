@@ -29,6 +29,12 @@
 #include "../mks/mks_service.h"
 #endif  // COMMUNICATION_PROTOCOL == MKS_SERIAL
 #include "../authentication/authentication_service.h"
+#if defined(PRINTER_STATE_FEATURE)
+#include "../printer_state/printer_state.h"
+#endif  // PRINTER_STATE_FEATURE
+#if defined(MEATPACK_FEATURE)
+#include "../meatpack/meatpack.h"
+#endif  // MEATPACK_FEATURE
 #define MAX_SERIAL 2
 HardwareSerial *Serials[MAX_SERIAL] = {&Serial, &Serial1};
 
@@ -66,14 +72,14 @@ bool ESP3DSerialService::begin(uint8_t serialIndex) {
   uint32_t br = 0;
   uint32_t defaultBr = 0;
 
-  br = ESP3DSettings::readUint32(ESP_BAUD_RATE);
-  defaultBr = ESP3DSettings::getDefaultIntegerSetting(ESP_BAUD_RATE);
+  br = ESP3DSettings::readUint32(static_cast<int>(ESP3DSettingIndex::esp3d_baud_rate));
+  defaultBr = ESP3DSettings::getDefaultIntegerSetting(ESP3DSettingIndex::esp3d_baud_rate);
   setParameters();
   esp3d_log("Baud rate is %d , default is %d", br, defaultBr);
   _buffer_size = 0;
   // change only if different from current
   if (br != baudRate() || (_rxPin != -1) || (_txPin != -1)) {
-    if (!ESP3DSettings::isValidIntegerSetting(br, ESP_BAUD_RATE)) {
+    if (!ESP3DSettings::isValidIntegerSetting(br, ESP3DSettingIndex::esp3d_baud_rate)) {
       br = defaultBr;
     }
     Serials[_serialIndex]->setRxBufferSize(SERIAL_RX_BUFFER_SIZE);
@@ -108,6 +114,16 @@ void ESP3DSerialService::flushData(const uint8_t *data, size_t size, ESP3DMessag
 
   if (message) {
     message->type = type;
+#if defined(PRINTER_STATE_FEATURE)
+    if (_id == MAIN_SERIAL && type != ESP3DMessageType::realtimecmd) {
+      esp3d_printer_state.parse(data, size);
+    }
+#endif  // PRINTER_STATE_FEATURE
+#if defined(MEATPACK_FEATURE)
+    if (_id == MAIN_SERIAL && type != ESP3DMessageType::realtimecmd) {
+      esp3d_meatpack.parse(data, size);
+    }
+#endif  // MEATPACK_FEATURE
     esp3d_log("Process Message");
     esp3d_commands.process(message);
   } else {
@@ -264,7 +280,7 @@ void ESP3DSerialService::push2buffer(uint8_t *sbuf, size_t len) {
 bool ESP3DSerialService::reset() {
   esp3d_log("Reset serial");
   return ESP3DSettings::writeUint32(
-      ESP_BAUD_RATE, ESP3DSettings::getDefaultIntegerSetting(ESP_BAUD_RATE));
+      static_cast<int>(ESP3DSettingIndex::esp3d_baud_rate), ESP3DSettings::getDefaultIntegerSetting(ESP3DSettingIndex::esp3d_baud_rate));
 }
 
 void ESP3DSerialService::swap() {
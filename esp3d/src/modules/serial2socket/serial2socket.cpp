@@ -30,19 +30,20 @@
 
 Serial_2_Socket Serial2Socket;
 
+// Make ring content visible to other core before moving index
+#define S2S_BARRIER() __sync_synchronize()
+
 Serial_2_Socket::Serial_2_Socket() { end(); }
 Serial_2_Socket::~Serial_2_Socket() { end(); }
 void Serial_2_Socket::begin(long speed) { end(); }
 
 void Serial_2_Socket::enable(bool enable) { _started = enable; }
 
+// Rings are not reset here because pause can be called from any task,
+// each consumer discards its pending data while paused
 void Serial_2_Socket::pause(bool state) {
   _paused = state;
-  if (_paused) {
-    _TXbufferSize = 0;
-    _RXbufferSize = 0;
-    _RXbufferpos = 0;
-  } else {
+  if (!_paused) {
     _lastflush = millis();
   }
 }
@@ -50,9 +51,13 @@ void Serial_2_Socket::pause(bool state) {
 bool Serial_2_Socket::isPaused() { return _paused; }
 
 void Serial_2_Socket::end() {
-  _TXbufferSize = 0;
-  _RXbufferSize = 0;
-  _RXbufferpos = 0;
+  _TXhead = 0;
+  _TXtail = 0;
+  _TXlineEnd = 0;
+  _TXlineReady = false;
+  _TXflushRequested = false;
+  _RXhead = 0;
+  _RXtail = 0;
   _started = false;
   _paused = false;
   _lastflush = millis();
@@ -67,121 +72,188 @@ long Serial_2_Socket::baudRate() { return 0; }
 
 bool Serial_2_Socket::started() { return _started; }
 
+bool Serial_2_Socket::isConnected() { return _started; }
+
 Serial_2_Socket::operator bool() const { return true; }
 
 int Serial_2_Socket::available() {
   if (_paused) {
+    // drop what was received before pause
+    _RXtail = _RXhead;
     return 0;
   }
-  return _RXbufferSize;
+  return _RXhead - _RXtail;
 }
 
-size_t Serial_2_Socket::write(uint8_t c) {
-  if (!_started || _paused) {
-    return 1;
-  }
-  return write(&c, 1);
-}
+size_t Serial_2_Socket::write(uint8_t c) { return write(&c, 1); }
 
 size_t Serial_2_Socket::write(const uint8_t *buffer, size_t size) {
   if (buffer == NULL || size == 0 || !_started || _paused) {
-    esp3d_log("Serial2Socket: no data, not started or paused");
     return size;
   }
-  if (_TXbufferSize == 0) {
-    _lastflush = millis();
+  uint32_t head = _TXhead;
+  size_t freeSize = S2S_TX_RING_SIZE - (head - _TXtail);
+  size_t count = size;
+  if (count > freeSize) {
+    // never block Marlin, extra data is lost
+    esp3d_log_e("S2S: TX ring full, %d bytes lost", size - freeSize);
+    count = freeSize;
   }
-  // send full line
-  if (_TXbufferSize + size > S2S_TXBUFFERSIZE) {
-    flush();
-  }
-  // need periodic check to force to flush in case of no end
-  for (int i = 0; i < size; i++) {
-    _TXbuffer[_TXbufferSize] = buffer[i];
-    _TXbufferSize++;
-    if (buffer[i] == (const uint8_t)'\n') {
-      esp3d_log("S2S: %s TXSize: %d", (const char *)_TXbuffer, _TXbufferSize);
-      flush();
-    }
+  if (count == 0) {
+    return size;
+  }
+  size_t pos = head & (S2S_TX_RING_SIZE - 1);
+  size_t first = S2S_TX_RING_SIZE - pos;
+  if (first > count) {
+    first = count;
+  }
+  memcpy(&_TXring[pos], buffer, first);
+  if (count > first) {
+    memcpy(_TXring, &buffer[first], count - first);
+  }
+  S2S_BARRIER();
+  _TXhead = head + count;
+  if (memchr(buffer, '\n', count) != NULL) {
+    _TXlineReady = true;
   }
-  handle_flush();
   return size;
 }
 
 int Serial_2_Socket::peek(void) {
-  if (_RXbufferSize > 0 && _started) {
-    return _RXbuffer[_RXbufferpos];
-  } else {
+  if (!_started || _paused || _RXhead == _RXtail) {
     return -1;
   }
+  return _RXring[_RXtail & (S2S_RX_RING_SIZE - 1)];
 }
 
 bool Serial_2_Socket::push(const uint8_t *buffer, size_t size) {
   if (buffer == NULL || size == 0 || !_started || _paused) {
     return false;
   }
-  int data_size = size;
-  if ((data_size + _RXbufferSize) <= S2S_RXBUFFERSIZE) {
-    int current = _RXbufferpos + _RXbufferSize;
-    if (current > S2S_RXBUFFERSIZE) {
-      current = current - S2S_RXBUFFERSIZE;
-    }
-    for (int i = 0; i < data_size; i++) {
-      if (current > (S2S_RXBUFFERSIZE - 1)) {
-        current = 0;
-      }
-      _RXbuffer[current] = buffer[i];
-      current++;
-    }
-    _RXbufferSize += size;
-    _RXbuffer[current] = 0;
-    return true;
+  uint32_t head = _RXhead;
+  if (size > S2S_RX_RING_SIZE - (head - _RXtail)) {
+    return false;
   }
-  return false;
+  size_t pos = head & (S2S_RX_RING_SIZE - 1);
+  size_t first = S2S_RX_RING_SIZE - pos;
+  if (first > size) {
+    first = size;
+  }
+  memcpy(&_RXring[pos], buffer, first);
+  if (size > first) {
+    memcpy(_RXring, &buffer[first], size - first);
+  }
+  S2S_BARRIER();
+  _RXhead = head + size;
+  return true;
 }
 
 int Serial_2_Socket::read(void) {
-  if (_RXbufferSize > 0 && _started && !_paused) {
-    int v = _RXbuffer[_RXbufferpos];
-    _RXbufferpos++;
-    if (_RXbufferpos > (S2S_RXBUFFERSIZE - 1)) {
-      _RXbufferpos = 0;
-    }
-    _RXbufferSize--;
-    return v;
-  } else {
+  if (!_started || _paused) {
+    return -1;
+  }
+  uint32_t tail = _RXtail;
+  if (_RXhead == tail) {
     return -1;
   }
+  S2S_BARRIER();
+  int v = _RXring[tail & (S2S_RX_RING_SIZE - 1)];
+  S2S_BARRIER();
+  _RXtail = tail + 1;
+  return v;
 }
 
 void Serial_2_Socket::handle() { handle_flush(); }
 
+// Called from ESP3D task: complete lines are sent as soon as they are
+// written, without waiting for any timeout
 void Serial_2_Socket::handle_flush() {
-  if (_TXbufferSize > 0 && _started && !_paused) {
-    if ((_TXbufferSize >= S2S_TXBUFFERSIZE) ||
-        ((millis() - _lastflush) > S2S_FLUSHTIMEOUT)) {
-      esp3d_log("force socket flush");
-      flush();
+  if (!_started) {
+    return;
+  }
+  if (_paused) {
+    // drop what Marlin wrote before pause
+    _TXtail = _TXhead;
+    _TXlineEnd = _TXtail;
+    return;
+  }
+  uint32_t tail = _TXtail;
+  if (_TXlineReady) {
+    _TXlineReady = false;
+    S2S_BARRIER();
+    // look for the last end of line not yet seen
+    uint32_t from = (int32_t)(_TXlineEnd - tail) > 0 ? _TXlineEnd : tail;
+    for (uint32_t i = _TXhead; i != from; i--) {
+      if (_TXring[(i - 1) & (S2S_TX_RING_SIZE - 1)] == '\n') {
+        _TXlineEnd = i;
+        break;
+      }
     }
   }
+  // send complete lines
+  while ((int32_t)(_TXlineEnd - _TXtail) > 0) {
+    sendTX(_TXlineEnd - _TXtail);
+  }
+  uint32_t pending = _TXhead - _TXtail;
+  if (pending == 0) {
+    _lastflush = millis();
+    _TXflushRequested = false;
+    return;
+  }
+  // data without end of line
+  if (_TXflushRequested || pending >= S2S_TXBUFFERSIZE ||
+      (millis() - _lastflush) > S2S_FLUSHTIMEOUT) {
+    esp3d_log("force socket flush");
+    _TXflushRequested = false;
+    sendTX(pending);
+    _lastflush = millis();
+  }
 }
+
+// Can be called from Marlin task, so only ask ESP3D task to send all data
 void Serial_2_Socket::flush(void) {
-  if (_TXbufferSize > 0 && _started && !_paused) {
-    ESP3DMessage *msg = esp3d_message_manager.newMsg(
-        ESP3DClientType::socket_serial, ESP3DClientType::all_clients, _TXbuffer,
-        _TXbufferSize, _auth);
-    // dispatch command
-    if (msg) {
-      // process command
-      msg->type = ESP3DMessageType::unique;
-      esp3d_commands.process(msg);
-    } else {
-      esp3d_log_e("Cannot create message");
+  if (_started && !_paused) {
+    _TXflushRequested = true;
+  }
+}
+
+// Send up to size bytes from TX ring in one message, cut at last end of
+// line if more data remains
+void Serial_2_Socket::sendTX(uint32_t size) {
+  uint32_t tail = _TXtail;
+  if (size > S2S_TXBUFFERSIZE) {
+    size = S2S_TXBUFFERSIZE;
+  }
+  S2S_BARRIER();
+  size_t pos = tail & (S2S_TX_RING_SIZE - 1);
+  size_t first = S2S_TX_RING_SIZE - pos;
+  if (first > size) {
+    first = size;
+  }
+  memcpy(_TXbuffer, &_TXring[pos], first);
+  if (size > first) {
+    memcpy(&_TXbuffer[first], _TXring, size - first);
+  }
+  if (size == S2S_TXBUFFERSIZE && (_TXhead - tail) > size) {
+    for (uint32_t i = size; i > 0; i--) {
+      if (_TXbuffer[i - 1] == '\n') {
+        size = i;
+        break;
+      }
     }
-    // refresh timout
-    _lastflush = millis();
-    // reset buffer
-    _TXbufferSize = 0;
+  }
+  S2S_BARRIER();
+  _TXtail = tail + size;
+  ESP3DMessage *msg = esp3d_message_manager.newMsg(
+      ESP3DClientType::socket_serial, ESP3DClientType::all_clients, _TXbuffer,
+      size, _auth);
+  // dispatch command
+  if (msg) {
+    // process command
+    msg->type = ESP3DMessageType::unique;
+    esp3d_commands.process(msg);
+  } else {
+    esp3d_log_e("Cannot create message");
   }
 }
 
@@ -24,9 +24,30 @@
 #include <Print.h>
 
 #include "../authentication/authentication_level_types.h"
+
+// Rings between Marlin task and ESP3D task, size must be a power of 2
+// TX ring (Marlin -> clients) must hold a full report (M503, M115...)
+#ifndef S2S_TX_RING_SIZE
+#define S2S_TX_RING_SIZE 4096
+#endif  // S2S_TX_RING_SIZE
+// RX ring (clients -> Marlin)
+#ifndef S2S_RX_RING_SIZE
+#define S2S_RX_RING_SIZE 1024
+#endif  // S2S_RX_RING_SIZE
+// Max size of one message sent to clients
+#ifndef S2S_TXBUFFERSIZE
 #define S2S_TXBUFFERSIZE 1200
-#define S2S_RXBUFFERSIZE 128
-#define S2S_FLUSHTIMEOUT 500
+#endif  // S2S_TXBUFFERSIZE
+// Complete lines are sent at once, data without end of line is sent after
+// this delay (ms)
+#ifndef S2S_FLUSHTIMEOUT
+#define S2S_FLUSHTIMEOUT 20
+#endif  // S2S_FLUSHTIMEOUT
+
+static_assert((S2S_TX_RING_SIZE & (S2S_TX_RING_SIZE - 1)) == 0,
+              "S2S_TX_RING_SIZE must be a power of 2");
+static_assert((S2S_RX_RING_SIZE & (S2S_RX_RING_SIZE - 1)) == 0,
+              "S2S_RX_RING_SIZE must be a power of 2");
 
 class ESP3DMessage;  // forward declaration
 
@@ -48,6 +69,7 @@ class Serial_2_Socket : public Stream {
   void end();
   void enable(bool enable = true);
   bool started();
+  bool isConnected();
   int available();
   int peek(void);
   int read(void);
@@ -64,11 +86,26 @@ class Serial_2_Socket : public Stream {
   bool _paused;
   ESP3DAuthenticationLevel _auth;
   uint32_t _lastflush;
+  // Each ring has a single producer and a single consumer:
+  // TX: write() from Marlin task, flush() from ESP3D task
+  // RX: push() from ESP3D task, read() from Marlin task
+  // head is only changed by producer, tail only by consumer, both are
+  // free running counters, position in ring is counter & (size - 1)
+  uint8_t _TXring[S2S_TX_RING_SIZE];
+  volatile uint32_t _TXhead;
+  volatile uint32_t _TXtail;
+  // set by producer when an end of line is written
+  volatile bool _TXlineReady;
+  // set by producer to send data even without end of line
+  volatile bool _TXflushRequested;
+  // last end of line seen by consumer, data up to it can be sent
+  uint32_t _TXlineEnd;
+  uint8_t _RXring[S2S_RX_RING_SIZE];
+  volatile uint32_t _RXhead;
+  volatile uint32_t _RXtail;
+  // message content, only used by consumer of TX ring
   uint8_t _TXbuffer[S2S_TXBUFFERSIZE];
-  uint16_t _TXbufferSize;
-  uint8_t _RXbuffer[S2S_RXBUFFERSIZE];
-  uint16_t _RXbufferSize;
-  uint16_t _RXbufferpos;
+  void sendTX(uint32_t size);
 };
 
 extern Serial_2_Socket Serial2Socket;
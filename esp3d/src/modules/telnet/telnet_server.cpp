@@ -25,6 +25,7 @@
 
 #include "telnet_server.h" // Added missing include
 #include "../../core/esp3d_commands.h"
+#include "../../core/esp3d_hal.h"
 #include "../../core/esp3d_message.h"
 #include "../../core/esp3d_settings.h"
 #include "../../core/esp3d_string.h"
@@ -39,6 +40,12 @@ Telnet_Server telnet_server;
 
 #define TIMEOUT_TELNET_FLUSH 1500
 
+// Output records are stored in the ring as: sessions mask, size low byte,
+// size high byte, then the payload
+#define TELNET_RECORD_HEADER_SIZE 3
+#define TELNET_RECORD_MAX_PAYLOAD (ESP3D_TELNET_TX_RING_SIZE / 4)
+#define TELNET_ALL_SESSIONS 0xFF
+
 #if defined(AUTHENTICATION_FEATURE)
 #define TELNET_WELCOME_MESSAGE         \
   ";Welcome to ESP3D V" FW_VERSION \
@@ -48,55 +55,140 @@ Telnet_Server telnet_server;
 #endif  // AUTHENTICATION_FEATURE
 
 void Telnet_Server::closeClient() {
-  if (_telnetClients) {
-    _telnetClients.stop();
+  for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+    closeSession(i);
   }
 }
 
+void Telnet_Server::closeSession(uint8_t index) {
+  ESP3DTelnetSession &session = _sessions[index];
+  session.client.stop();
+  session.buffer_size = 0;
+  session.txpos = _txhead;
+  session.txoffset = 0;
+#if defined(AUTHENTICATION_FEATURE)
+  session.auth = ESP3DAuthenticationLevel::guest;
+#else
+  session.auth = ESP3DAuthenticationLevel::admin;
+#endif  // AUTHENTICATION_FEATURE
+}
+
+bool Telnet_Server::isSessionConnected(uint8_t index) {
+  return _sessions[index].client.connected();
+}
+
 bool Telnet_Server::isConnected() {
   if (!_started || _telnetserver == NULL) {
     return false;
   }
-  // Check if there are any new clients
-  if (_telnetserver->hasClient()) {
-    // Find free/disconnected spot
-    if (!_telnetClients || !_telnetClients.connected()) {
-      if (_telnetClients) {
-        _telnetClients.stop();
-      }
-      _telnetClients = _telnetserver->accept();
-      esp3d_log("New Telnet client connected from %s", _telnetClients.remoteIP().toString().c_str());
-#ifndef DISABLE_TELNET_WELCOME_MESSAGE
-      // New client
-      writeBytes((uint8_t *)TELNET_WELCOME_MESSAGE, strlen(TELNET_WELCOME_MESSAGE));
-#endif  // DISABLE_TELNET_WELCOME_MESSAGE
-      initAuthentication();
+  for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+    if (isSessionConnected(i)) {
+      return true;
     }
   }
-  if (_telnetserver->hasClient()) {
-    // No free/disconnected spot, so reject
-    _telnetserver->accept().stop();
-    esp3d_log("Rejected additional Telnet client");
+  return false;
+}
+
+uint8_t Telnet_Server::clientsCount() {
+  uint8_t count = 0;
+  if (!_started) {
+    return 0;
   }
-  return _telnetClients.connected();
+  for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+    if (isSessionConnected(i)) {
+      count++;
+    }
+  }
+  return count;
 }
 
 const char *Telnet_Server::clientIPAddress() {
   static String res;
-  res = "0.0.0.0";
-  if (_telnetClients && _telnetClients.connected()) {
-    res = _telnetClients.remoteIP().toString();
+  res = "";
+  for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+    if (isSessionConnected(i)) {
+      if (res.length() > 0) {
+        res += ", ";
+      }
+      res += _sessions[i].client.remoteIP().toString();
+    }
+  }
+  if (res.length() == 0) {
+    res = "0.0.0.0";
   }
   return res.c_str();
 }
 
+void Telnet_Server::acceptClients() {
+  // Bounded so a flood of connections cannot hold the loop
+  for (uint8_t n = 0;
+       n <= ESP3D_TELNET_MAX_CLIENTS && _telnetserver->hasClient(); n++) {
+    int8_t slot = -1;
+    // Find free/disconnected spot
+    for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+      if (!isSessionConnected(i)) {
+        slot = i;
+        break;
+      }
+    }
+    if (slot == -1) {
+      // No free/disconnected spot, so reject
+      _telnetserver->accept().stop();
+      esp3d_log("Rejected additional Telnet client");
+      continue;
+    }
+    closeSession(slot);
+    _sessions[slot].client = _telnetserver->accept();
+    initSession(slot);
+  }
+}
+
+void Telnet_Server::initSession(uint8_t index) {
+  ESP3DTelnetSession &session = _sessions[index];
+  // Input buffer is kept with the slot until the server ends
+  if (!_isdebug && !session.buffer) {
+    session.buffer = (uint8_t *)malloc(ESP3D_TELNET_BUFFER_SIZE + 1);
+    if (!session.buffer) {
+      esp3d_log_e("Failed to allocate Telnet buffer");
+      session.client.stop();
+      return;
+    }
+  }
+  session.client.setNoDelay(true);
+  session.buffer_size = 0;
+  session.lastflush = millis();
+  // New session only gets output produced from now
+  session.txpos = _txhead;
+  session.txoffset = 0;
+#if defined(AUTHENTICATION_FEATURE)
+  session.auth = ESP3DAuthenticationLevel::guest;
+#else
+  session.auth = ESP3DAuthenticationLevel::admin;
+#endif  // AUTHENTICATION_FEATURE
+  esp3d_log("New Telnet client %d connected from %s", index,
+            session.client.remoteIP().toString().c_str());
+#ifndef DISABLE_TELNET_WELCOME_MESSAGE
+  pushOutput((uint8_t *)TELNET_WELCOME_MESSAGE, strlen(TELNET_WELCOME_MESSAGE),
+             1 << index);
+#endif  // DISABLE_TELNET_WELCOME_MESSAGE
+}
+
 Telnet_Server::Telnet_Server() {
-  _buffer_size = 0;
   _started = false;
   _isdebug = false;
   _port = 0;
-  _buffer = nullptr;
+  _current = -1;
+  _txring = nullptr;
+  _txhead = 0;
+  _dropped = 0;
   _telnetserver = nullptr;
+  for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+    _sessions[i].buffer = nullptr;
+    _sessions[i].buffer_size = 0;
+    _sessions[i].lastflush = 0;
+    _sessions[i].txpos = 0;
+    _sessions[i].txoffset = 0;
+  }
   initAuthentication();
 }
 
@@ -119,21 +211,18 @@ bool Telnet_Server::begin(uint16_t port, bool debug) {
   }
   esp3d_log("Starting Telnet server on port %d", _port);
   _isdebug = debug;
-  if (!_isdebug) {
-    _buffer = (uint8_t *)malloc(ESP3D_TELNET_BUFFER_SIZE + 1);
-    if (!_buffer) {
-      esp3d_log_e("Failed to allocate Telnet buffer");
-      return false;
-    }
+  // Output shared by all sessions
+  _txring = (uint8_t *)malloc(ESP3D_TELNET_TX_RING_SIZE);
+  if (!_txring) {
+    esp3d_log_e("Failed to allocate Telnet output ring");
+    return false;
   }
   // Create instance
   _telnetserver = new WiFiServer(_port);
   if (!_telnetserver) {
     esp3d_log_e("Failed to create Telnet server");
-    if (_buffer) {
-      free(_buffer);
-      _buffer = nullptr;
-    }
+    free(_txring);
+    _txring = nullptr;
     return false;
   }
   _telnetserver->setNoDelay(true);
@@ -145,7 +234,6 @@ bool Telnet_Server::begin(uint16_t port, bool debug) {
     esp3d_log("Telnet server configured for APSTA mode");
   }
   _started = true;
-  _lastflush = millis();
   esp3d_log("Telnet server started on port %d", _port);
   return _started;
 }
@@ -155,23 +243,25 @@ bool Telnet_Server::begin(uint16_t port, bool debug) {
  */
 void Telnet_Server::end() {
   _started = false;
-  _buffer_size = 0;
   _port = 0;
   _isdebug = false;
+  _current = -1;
   closeClient();
   if (_telnetserver) {
     delete _telnetserver;
     _telnetserver = nullptr;
   }
-  if (_buffer) {
-    free(_buffer);
-    _buffer = nullptr;
+  for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+    if (_sessions[i].buffer) {
+      free(_sessions[i].buffer);
+      _sessions[i].buffer = nullptr;
+    }
+  }
+  if (_txring) {
+    free(_txring);
+    _txring = nullptr;
   }
-#if defined(AUTHENTICATION_FEATURE)
-  _auth = ESP3DAuthenticationLevel::guest;
-#else
-  _auth = ESP3DAuthenticationLevel::admin;
-#endif  // AUTHENTICATION_FEATURE
+  _txhead = 0;
 }
 
 /**
@@ -186,31 +276,40 @@ bool Telnet_Server::started() { return _started; }
 
 void Telnet_Server::handle() {
   ESP3DHal::wait(0);
-  if (isConnected()) {
-    // Check clients for data
-    size_t len = _telnetClients.available();
-    if (len > 0) {
-      // If yes, read them
-      uint8_t *sbuf = (uint8_t *)malloc(len);
-      if (sbuf) {
-        size_t count = _telnetClients.read(sbuf, len);
-        // Push to buffer
-        if (count > 0) {
-          esp3d_log("Received %d bytes from Telnet client", count);
-          push2buffer(sbuf, count);
-        }
-        // Free buffer
-        free(sbuf);
-      } else {
-        esp3d_log_e("Failed to allocate buffer for Telnet data");
+  if (!_started || !_telnetserver) {
+    return;
+  }
+  acceptClients();
+  for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+    if (!isSessionConnected(i)) {
+      continue;
+    }
+    ESP3DTelnetSession &session = _sessions[i];
+    // Check client for data, one input buffer at most per loop
+    size_t total = 0;
+    size_t len = session.client.available();
+    while (len > 0 && total < ESP3D_TELNET_BUFFER_SIZE) {
+      uint8_t sbuf[128];
+      size_t count =
+          session.client.read(sbuf, len > sizeof(sbuf) ? sizeof(sbuf) : len);
+      if (count == 0 || count > sizeof(sbuf)) {
+        break;
       }
+      total += count;
+      push2buffer(i, sbuf, count);
+      if (!isSessionConnected(i)) {
+        break;
+      }
+      len = session.client.available();
+    }
+    // We cannot leave data in buffer too long
+    // in case some commands "forget" to add \n
+    if (((millis() - session.lastflush) > TIMEOUT_TELNET_FLUSH) &&
+        (session.buffer_size > 0)) {
+      flushBuffer(i);
     }
   }
-  // We cannot leave data in buffer too long
-  // in case some commands "forget" to add \n
-  if (((millis() - _lastflush) > TIMEOUT_TELNET_FLUSH) && (_buffer_size > 0)) {
-    flushBuffer();
-  }
+  flushSessions();
 }
 
 bool Telnet_Server::dispatch(ESP3DMessage *message) {
@@ -219,7 +318,14 @@ bool Telnet_Server::dispatch(ESP3DMessage *message) {
     return false;
   }
   if (message->size > 0 && message->data) {
-    size_t sentcnt = writeBytes(message->data, message->size);
+    // Answers to a session command only go back to that session, anything
+    // else (printer output, notifications) goes to every session
+    uint8_t mask = TELNET_ALL_SESSIONS;
+    if (_current >= 0 && (message->origin == ESP3DClientType::telnet ||
+                          message->origin == ESP3DClientType::command)) {
+      mask = 1 << _current;
+    }
+    size_t sentcnt = pushOutput(message->data, message->size, mask);
     if (sentcnt != message->size) {
       esp3d_log_e("Failed to send %d bytes, sent %d", message->size, sentcnt);
       return false;
@@ -231,120 +337,292 @@ bool Telnet_Server::dispatch(ESP3DMessage *message) {
 }
 
 void Telnet_Server::initAuthentication() {
+  for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
 #if defined(AUTHENTICATION_FEATURE)
-  _auth = ESP3DAuthenticationLevel::guest;
+    _sessions[i].auth = ESP3DAuthenticationLevel::guest;
 #else
-  _auth = ESP3DAuthenticationLevel::admin;
+    _sessions[i].auth = ESP3DAuthenticationLevel::admin;
 #endif  // AUTHENTICATION_FEATURE
+  }
 }
 
-ESP3DAuthenticationLevel Telnet_Server::getAuthentication() { return _auth; }
+// Authentication is per session, it applies to the session whose
+// command is being processed
+void Telnet_Server::setAuthentication(ESP3DAuthenticationLevel auth) {
+  if (_current >= 0) {
+    _sessions[_current].auth = auth;
+  }
+}
 
-void Telnet_Server::flushData(const uint8_t *data, size_t size, ESP3DMessageType type) {
+ESP3DAuthenticationLevel Telnet_Server::getAuthentication() {
+  if (_current >= 0) {
+    return _sessions[_current].auth;
+  }
+#if defined(AUTHENTICATION_FEATURE)
+  return ESP3DAuthenticationLevel::guest;
+#else
+  return ESP3DAuthenticationLevel::admin;
+#endif  // AUTHENTICATION_FEATURE
+}
+
+void Telnet_Server::flushData(uint8_t index, const uint8_t *data, size_t size,
+                              ESP3DMessageType type) {
+  ESP3DTelnetSession &session = _sessions[index];
   ESP3DMessage *message = esp3d_message_manager.newMsg(
-      ESP3DClientType::telnet, esp3d_commands.getOutputClient(), data, size, _auth);
+      ESP3DClientType::telnet, esp3d_commands.getOutputClient(), data, size,
+      session.auth);
   if (message) {
     message->type = type;
     esp3d_log("Processing Telnet message of size %d", size);
+    int8_t previous = _current;
+    _current = index;
     esp3d_commands.process(message);
+    _current = previous;
   } else {
     esp3d_log_e("Cannot create Telnet message");
   }
-  _lastflush = millis();
+  session.lastflush = millis();
 }
 
-void Telnet_Server::flushChar(char c) {
-  flushData((uint8_t *)&c, 1, ESP3DMessageType::realtimecmd);
+void Telnet_Server::flushChar(uint8_t index, char c) {
+  flushData(index, (uint8_t *)&c, 1, ESP3DMessageType::realtimecmd);
 }
 
-void Telnet_Server::flushBuffer() {
-  _buffer[_buffer_size] = 0x0;
-  flushData((uint8_t *)_buffer, _buffer_size, ESP3DMessageType::unique);
-  _buffer_size = 0;
+void Telnet_Server::flushBuffer(uint8_t index) {
+  ESP3DTelnetSession &session = _sessions[index];
+  session.buffer[session.buffer_size] = 0x0;
+  // Reset before processing as the session may be reused meanwhile
+  size_t size = session.buffer_size;
+  session.buffer_size = 0;
+  flushData(index, session.buffer, size, ESP3DMessageType::unique);
 }
 
-void Telnet_Server::push2buffer(uint8_t *sbuf, size_t len) {
-  if (!_buffer || !_started) {
-    esp3d_log_e("Cannot push to buffer: server not started or buffer null");
+void Telnet_Server::push2buffer(uint8_t index, uint8_t *sbuf, size_t len) {
+  ESP3DTelnetSession &session = _sessions[index];
+  // No input buffer in debug mode, data are just dropped
+  if (!session.buffer || !_started) {
     return;
   }
   for (size_t i = 0; i < len; i++) {
-    _lastflush = millis();
+    session.lastflush = millis();
     if (esp3d_string::isRealTimeCommand(sbuf[i])) {
-      flushChar(sbuf[i]);
+      flushChar(index, sbuf[i]);
     } else {
-      _buffer[_buffer_size] = sbuf[i];
-      _buffer_size++;
-      if (_buffer_size > ESP3D_TELNET_BUFFER_SIZE || _buffer[_buffer_size - 1] == '\n') {
-        flushBuffer();
+      session.buffer[session.buffer_size] = sbuf[i];
+      session.buffer_size++;
+      if (session.buffer_size > ESP3D_TELNET_BUFFER_SIZE ||
+          session.buffer[session.buffer_size - 1] == '\n') {
+        flushBuffer(index);
       }
     }
+    // Server may have been restarted by the command
+    if (!session.buffer || !_started) {
+      return;
+    }
   }
 }
 
-size_t Telnet_Server::writeBytes(const uint8_t *buffer, size_t size) {
-  if (isConnected() && (size > 0) && _started) {
-    if ((size_t)availableForWrite() >= size) {
-      // Push data to connected Telnet client
-      size_t sent = _telnetClients.write(buffer, size);
-      esp3d_log("Sent %d bytes to Telnet client", sent);
-      return sent;
-    } else {
-      size_t sizetosend = size;
-      size_t sizesent = 0;
-      uint8_t *buffertmp = (uint8_t *)buffer;
-      uint32_t starttime = millis();
-      // Loop until all is sent or timeout
-      while (sizetosend > 0 && ((millis() - starttime) < 100)) {
-        size_t available = availableForWrite();
-        if (available > 0) {
-          // In case less is sent
-          available = _telnetClients.write(
-              &buffertmp[sizesent],
-              (available >= sizetosend) ? sizetosend : available);
-          sizetosend -= available;
-          sizesent += available;
-          starttime = millis();
-          esp3d_log("Sent %d bytes, %d remaining", available, sizetosend);
-        } else {
-          ESP3DHal::wait(5);
-        }
-      }
-      return sizesent;
-    }
+// Skip the records not addressed to the session, so its position only
+// lags on data it still has to send
+void Telnet_Server::skipRecords(uint8_t index) {
+  ESP3DTelnetSession &session = _sessions[index];
+  uint8_t bit = 1 << index;
+  while (session.txoffset == 0 && session.txpos != _txhead &&
+         !(ringByte(session.txpos) & bit)) {
+    size_t len = ringByte(session.txpos + 1) |
+                 (ringByte(session.txpos + 2) << 8);
+    session.txpos += TELNET_RECORD_HEADER_SIZE + len;
   }
-  esp3d_log_e("Cannot write: not connected or zero size");
-  return 0;
 }
 
-int Telnet_Server::availableForWrite() {
-  if (!isConnected()) {
-    return 0;
-  }
+size_t Telnet_Server::sessionWritable(uint8_t index) {
 #ifdef ARDUINO_ARCH_ESP32
+  (void)index;
   return 128;  // Hard code for ESP32
 #endif         // ARDUINO_ARCH_ESP32
 #ifdef ARDUINO_ARCH_ESP8266
-  return _telnetClients.availableForWrite();
+  return _sessions[index].client.availableForWrite();
 #endif  // ARDUINO_ARCH_ESP8266
 }
 
+// Send what the socket accepts of the session pending output,
+// return the number of bytes sent
+size_t Telnet_Server::flushSession(uint8_t index) {
+  ESP3DTelnetSession &session = _sessions[index];
+  uint8_t bit = 1 << index;
+  size_t sent = 0;
+  if (!_txring || !isSessionConnected(index)) {
+    return 0;
+  }
+  while (session.txpos != _txhead) {
+    uint8_t mask = ringByte(session.txpos);
+    size_t len = ringByte(session.txpos + 1) |
+                 (ringByte(session.txpos + 2) << 8);
+    if (mask & bit) {
+      size_t available = sessionWritable(index);
+      if (available == 0) {
+        break;
+      }
+      uint32_t start = (session.txpos + TELNET_RECORD_HEADER_SIZE +
+                        session.txoffset) % ESP3D_TELNET_TX_RING_SIZE;
+      size_t chunk = len - session.txoffset;
+      if (chunk > available) {
+        chunk = available;
+      }
+      // Payload may wrap around the end of the ring
+      if (start + chunk > ESP3D_TELNET_TX_RING_SIZE) {
+        chunk = ESP3D_TELNET_TX_RING_SIZE - start;
+      }
+      size_t written = session.client.write(&_txring[start], chunk);
+      if (written == 0 || written > chunk) {
+        break;
+      }
+      sent += written;
+      session.txoffset += written;
+      if (session.txoffset < len) {
+        continue;
+      }
+    }
+    session.txpos += TELNET_RECORD_HEADER_SIZE + len;
+    session.txoffset = 0;
+  }
+  return sent;
+}
+
+void Telnet_Server::flushSessions() {
+  for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+    flushSession(i);
+  }
+}
+
+// Send what the socket takes of the session pending output, false if the
+// ring is still too full for a new record: output only waits for the
+// session whose command is answered, up to ESP3D_TELNET_TX_TIMEOUT
+bool Telnet_Server::makeRoom(uint8_t index, size_t needed, bool wait) {
+  ESP3DTelnetSession &session = _sessions[index];
+  skipRecords(index);
+  if ((_txhead - session.txpos) + needed <= ESP3D_TELNET_TX_RING_SIZE) {
+    return true;
+  }
+  uint32_t start = millis();
+  do {
+    if (flushSession(index) == 0 && wait) {
+      ESP3DHal::wait(1);
+    }
+    skipRecords(index);
+    if ((_txhead - session.txpos) + needed <= ESP3D_TELNET_TX_RING_SIZE) {
+      return true;
+    }
+  } while (wait && isSessionConnected(index) &&
+           (millis() - start) < ESP3D_TELNET_TX_TIMEOUT);
+  return false;
+}
+
+// Output is written once in the shared ring, each session sends it from
+// its own position, another session that cannot keep up is dropped instead
+// of stalling the one being answered
+size_t Telnet_Server::pushOutput(const uint8_t *data, size_t size,
+                                 uint8_t mask) {
+  if (!_started || !_txring || !data || size == 0) {
+    return 0;
+  }
+  uint8_t targets = 0;
+  for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+    if ((mask & (1 << i)) && isSessionConnected(i)) {
+      targets |= 1 << i;
+    }
+  }
+  size_t pushed = 0;
+  while (pushed < size && targets != 0) {
+    size_t len = size - pushed;
+    if (len > TELNET_RECORD_MAX_PAYLOAD) {
+      len = TELNET_RECORD_MAX_PAYLOAD;
+    }
+    size_t needed = len + TELNET_RECORD_HEADER_SIZE;
+    // session being answered is never dropped, its output is cut instead
+    if (_current >= 0 && isSessionConnected(_current) &&
+        !makeRoom(_current, needed, true)) {
+      esp3d_log_e("Telnet client %d does not read, output dropped",
+                  _current);
+      break;
+    }
+    for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+      if (i != _current && isSessionConnected(i) &&
+          !makeRoom(i, needed, false)) {
+        closeSession(i);
+        targets &= ~(1 << i);
+        _dropped++;
+        esp3d_log_e("Telnet client %d too slow, disconnected", i);
+      }
+    }
+    if (targets == 0) {
+      break;
+    }
+    _txring[_txhead % ESP3D_TELNET_TX_RING_SIZE] = targets;
+    _txring[(_txhead + 1) % ESP3D_TELNET_TX_RING_SIZE] = len & 0xFF;
+    _txring[(_txhead + 2) % ESP3D_TELNET_TX_RING_SIZE] = (len >> 8) & 0xFF;
+    uint32_t start =
+        (_txhead + TELNET_RECORD_HEADER_SIZE) % ESP3D_TELNET_TX_RING_SIZE;
+    size_t first = ESP3D_TELNET_TX_RING_SIZE - start;
+    if (first > len) {
+      first = len;
+    }
+    memcpy(&_txring[start], &data[pushed], first);
+    if (first < len) {
+      memcpy(_txring, &data[pushed + first], len - first);
+    }
+    _txhead += needed;
+    pushed += len;
+  }
+  flushSessions();
+  return pushed;
+}
+
+size_t Telnet_Server::writeBytes(const uint8_t *buffer, size_t size) {
+  return pushOutput(buffer, size, TELNET_ALL_SESSIONS);
+}
+
+// Room left in the output ring for the most lagging session
+int Telnet_Server::availableForWrite() {
+  uint32_t lag = 0;
+  if (!isConnected() || !_txring) {
+    return 0;
+  }
+  for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+    if (isSessionConnected(i)) {
+      skipRecords(i);
+      if (_txhead - _sessions[i].txpos > lag) {
+        lag = _txhead - _sessions[i].txpos;
+      }
+    }
+  }
+  return ESP3D_TELNET_TX_RING_SIZE - lag;
+}
+
 int Telnet_Server::available() {
-  if (isConnected()) {
-    return _telnetClients.available();
+  int count = 0;
+  if (!isConnected()) {
+    return 0;
   }
-  return 0;
+  for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+    if (isSessionConnected(i)) {
+      count += _sessions[i].client.available();
+    }
+  }
+  return count;
 }
 
 size_t Telnet_Server::readBytes(uint8_t *sbuf, size_t len) {
   if (isConnected()) {
-    if (_telnetClients.available() > 0) {
-      return _telnetClients.read(sbuf, len);
+    for (uint8_t i = 0; i < ESP3D_TELNET_MAX_CLIENTS; i++) {
+      if (isSessionConnected(i) && _sessions[i].client.available() > 0) {
+        return _sessions[i].client.read(sbuf, len);
+      }
     }
   }
   return 0;
 }
 
-void Telnet_Server::flush() { _telnetClients.flush(); }
+void Telnet_Server::flush() { flushSessions(); }
 
-#endif  // TELNET_FEATURE
\ No newline at end of file
+#endif  // TELNET_FEATURE
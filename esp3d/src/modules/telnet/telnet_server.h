@@ -28,6 +28,53 @@
 
 #define ESP3D_TELNET_BUFFER_SIZE 1200
 
+// Number of simultaneous telnet sessions, extra clients are rejected
+#ifndef ESP3D_TELNET_MAX_CLIENTS
+#if defined(ARDUINO_ARCH_ESP32)
+#define ESP3D_TELNET_MAX_CLIENTS 3
+#else
+#define ESP3D_TELNET_MAX_CLIENTS 2
+#endif  // ARDUINO_ARCH_ESP32
+#endif  // ESP3D_TELNET_MAX_CLIENTS
+
+// Size of the output ring shared by all sessions, a session lagging
+// more than this behind the output is disconnected, except the one whose
+// command is answered
+#ifndef ESP3D_TELNET_TX_RING_SIZE
+#if defined(ARDUINO_ARCH_ESP32)
+#define ESP3D_TELNET_TX_RING_SIZE 4096
+#else
+#define ESP3D_TELNET_TX_RING_SIZE 1024
+#endif  // ARDUINO_ARCH_ESP32
+#endif  // ESP3D_TELNET_TX_RING_SIZE
+
+// Time an answer larger than the ring waits for its session to send it
+// (ms), rest of answer is dropped after it
+#ifndef ESP3D_TELNET_TX_TIMEOUT
+#define ESP3D_TELNET_TX_TIMEOUT 2000
+#endif  // ESP3D_TELNET_TX_TIMEOUT
+
+#if ESP3D_TELNET_MAX_CLIENTS > 8
+#error "ESP3D_TELNET_MAX_CLIENTS cannot exceed 8"
+#endif
+#if ESP3D_TELNET_TX_RING_SIZE < 256
+#error "ESP3D_TELNET_TX_RING_SIZE must be at least 256"
+#endif
+#if (ESP3D_TELNET_TX_RING_SIZE & (ESP3D_TELNET_TX_RING_SIZE - 1)) != 0
+#error "ESP3D_TELNET_TX_RING_SIZE must be a power of 2"
+#endif
+
+struct ESP3DTelnetSession {
+  WiFiClient client;
+  ESP3DAuthenticationLevel auth;
+  uint8_t* buffer;
+  size_t buffer_size;
+  uint32_t lastflush;
+  // position of the output record being sent and bytes already sent of it
+  uint32_t txpos;
+  uint16_t txoffset;
+};
+
 class Telnet_Server {
  public:
   Telnet_Server();
@@ -38,6 +85,8 @@ class Telnet_Server {
   bool reset();
   bool started();
   bool isConnected();
+  uint8_t clientsCount();
+  uint32_t droppedClients() { return _dropped; }
   const char* clientIPAddress();
   size_t writeBytes(const uint8_t* buffer, size_t size);
   bool dispatch(ESP3DMessage* message);
@@ -48,23 +97,38 @@ class Telnet_Server {
   uint16_t port() { return _port; }
   void closeClient();
   void initAuthentication();
-  void setAuthentication(ESP3DAuthenticationLevel auth) { _auth = auth; }
+  void setAuthentication(ESP3DAuthenticationLevel auth);
   ESP3DAuthenticationLevel getAuthentication();
 
  private:
   bool _started;
   WiFiServer* _telnetserver;
-  WiFiClient _telnetClients;
-  ESP3DAuthenticationLevel _auth;
+  ESP3DTelnetSession _sessions[ESP3D_TELNET_MAX_CLIENTS];
+  // session whose input is being processed, -1 if none
+  int8_t _current;
   uint16_t _port;
   bool _isdebug;
-  uint32_t _lastflush;
-  uint8_t* _buffer;
-  size_t _buffer_size;
-  void push2buffer(uint8_t* sbuf, size_t len);
-  void flushBuffer();
-  void flushChar(char c);
-  void flushData(const uint8_t* data, size_t size, ESP3DMessageType type);
+  uint8_t* _txring;
+  uint32_t _txhead;
+  uint32_t _dropped;
+  void acceptClients();
+  void initSession(uint8_t index);
+  void closeSession(uint8_t index);
+  bool isSessionConnected(uint8_t index);
+  size_t pushOutput(const uint8_t* data, size_t size, uint8_t mask);
+  bool makeRoom(uint8_t index, size_t needed, bool wait);
+  void skipRecords(uint8_t index);
+  size_t flushSession(uint8_t index);
+  void flushSessions();
+  size_t sessionWritable(uint8_t index);
+  uint8_t ringByte(uint32_t pos) {
+    return _txring[pos % ESP3D_TELNET_TX_RING_SIZE];
+  }
+  void push2buffer(uint8_t index, uint8_t* sbuf, size_t len);
+  void flushBuffer(uint8_t index);
+  void flushChar(uint8_t index, char c);
+  void flushData(uint8_t index, const uint8_t* data, size_t size,
+                 ESP3DMessageType type);
 };
 
 extern Telnet_Server telnet_server;
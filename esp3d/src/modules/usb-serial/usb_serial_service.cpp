@@ -24,6 +24,9 @@
 #include "../../core/esp3d_settings.h"
 #include "../../core/esp3d_string.h"
 #include "../authentication/authentication_service.h"
+#if defined(PRINTER_STATE_FEATURE)
+#include "../printer_state/printer_state.h"
+#endif  // PRINTER_STATE_FEATURE
 #include "usb_serial_service.h"
 
 #if defined(NOTIFICATION_FEATURE)
@@ -388,6 +391,11 @@ void ESP3DUsbSerialService::handle() {
       esp3d_log("Serial in fifo size %d", _messagesInFIFO.size());
       ESP3DMessage *message = _messagesInFIFO.pop();
       if (message) {
+#if defined(PRINTER_STATE_FEATURE)
+        if (message->type != ESP3DMessageType::realtimecmd) {
+          esp3d_printer_state.parse(message->data, message->size);
+        }
+#endif  // PRINTER_STATE_FEATURE
         esp3d_commands.process(message);
       } else {
         esp3d_log_e("Cannot create message");
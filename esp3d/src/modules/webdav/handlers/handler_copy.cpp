@@ -68,8 +68,21 @@ void WebdavServer::handler_copy(const char* url) {
             WebDavFile fileOrigin = WebDavFS::open(url);
             if (fileOrigin) {
               if (fileOrigin.isDirectory()) {
-                code = 413;
-                esp3d_log_e("File %s is a directory", url);
+                // whole tree is copied in background
+                if (WebDavFS::exists(destination.c_str())) {
+                  code = 412;
+                  esp3d_log_e("Destination %s already exists",
+                              destination.c_str());
+                } else {
+                  String source = globalPath(url);
+                  if (ESP_GBFS::addJob(ESP_GBFSJobType::copy, source.c_str(),
+                                       globalPath(destination.c_str()))) {
+                    code = 202;
+                  } else {
+                    code = 500;
+                    esp3d_log_e("Failed to queue copy of %s", url);
+                  }
+                }
               } else {
                 // check if destination exists
                 WebDavFile fileDestination =
@@ -22,6 +22,9 @@
 
 #if defined(WEBDAV_FEATURE)
 #include "../webdav_server.h"
+#if defined(GCODE_INDEX_FEATURE)
+#include "../../gcode_host/gcode_index.h"
+#endif  // GCODE_INDEX_FEATURE
 
 void WebdavServer::handler_delete(const char* url) {
   esp3d_log("Processing DELETE");
@@ -36,8 +39,21 @@ void WebdavServer::handler_delete(const char* url) {
     if (WebDavFS::accessFS(fsType)) {
       // check if file exists
       if (WebDavFS::exists(url)) {
-        // try remove as file
-        if (!WebDavFS::remove(url)) {
+        bool isDir = false;
+        WebDavFile file = WebDavFS::open(url);
+        if (file) {
+          isDir = file.isDirectory();
+          file.close();
+        }
+        if (isDir) {
+          // whole tree is removed in background
+          if (ESP_GBFS::addJob(ESP_GBFSJobType::remove, globalPath(url))) {
+            code = 202;
+          } else {
+            code = 500;
+            esp3d_log_e("Failed to queue removal of %s", url);
+          }
+        } else if (!WebDavFS::remove(url)) {  // try remove as file
           esp3d_log("Failed to remove file %s", url);
           esp3d_log("Trying to remove as directory");
           // if failed try remove as directory
@@ -47,6 +63,9 @@ void WebdavServer::handler_delete(const char* url) {
             esp3d_log_e("Failed to remove %s", url);
           }
         }
+#if defined(GCODE_INDEX_FEATURE)
+        ESP3DGcodeIndex::removeFor<WebDavFS>(url);
+#endif  // GCODE_INDEX_FEATURE
       } else {
         code = 404;
         esp3d_log_e("File not found");
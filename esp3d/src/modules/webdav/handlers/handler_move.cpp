@@ -23,6 +23,9 @@
 #if defined(WEBDAV_FEATURE)
 #include "../../../core/esp3d_string.h"
 #include "../webdav_server.h"
+#if defined(GCODE_INDEX_FEATURE)
+#include "../../gcode_host/gcode_index.h"
+#endif  // GCODE_INDEX_FEATURE
 
 void WebdavServer::handler_move(const char* url) {
   esp3d_log("Processing MOVE");
@@ -92,6 +95,9 @@ void WebdavServer::handler_move(const char* url) {
                 esp3d_log_e("Failed to move %s to %s", url,
                             destination.c_str());
               }
+#if defined(GCODE_INDEX_FEATURE)
+              ESP3DGcodeIndex::renameFor<WebDavFS>(url, destination.c_str());
+#endif  // GCODE_INDEX_FEATURE
             }
           } else {
             code = 404;
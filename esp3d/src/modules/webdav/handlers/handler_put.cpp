@@ -23,6 +23,9 @@
 #if defined(WEBDAV_FEATURE)
 #include "../../../core/esp3d_string.h"
 #include "../webdav_server.h"
+#if defined(GCODE_INDEX_FEATURE)
+#include "../../gcode_host/gcode_index.h"
+#endif  // GCODE_INDEX_FEATURE
 #if defined(HTTP_FEATURE)
 #include "../../websocket/websocket_server.h"
 #endif  // HTTP_FEATURE
@@ -110,6 +113,14 @@ void WebdavServer::handler_put(const char* url) {
         WebDavFile file = WebDavFS::open(url, ESP_FILE_WRITE);
         if (file) {
           size_t received = 0;
+          size_t buffered = 0;
+          bool writeError = false;
+#if WEBDAV_FEATURE != FS_FLASH
+          // reserve contiguous clusters on SD when size is known
+          if (content_length > 0 && file.preAllocate(content_length)) {
+            esp3d_log("Preallocated %d bytes", content_length);
+          }
+#endif  // WEBDAV_FEATURE != FS_FLASH
 #if defined(ARDUINO_ARCH_ESP32)
           uint8_t chunk[2048];
 #endif  // ARDUINO_ARCH_ESP32
@@ -119,15 +130,27 @@ void WebdavServer::handler_put(const char* url) {
 #if defined(HTTP_FEATURE)
           Esp3dTimout updateWS(2000);
 #endif  // HTTP_FEATURE
-          while (_client.available() && received < content_length) {
+#if defined(GCODE_INDEX_FEATURE)
+          // layers are indexed while data are received
+          ESP3DGcodeIndex index;
+          bool indexed = ESP3DGcodeIndex::isGcodeFile(url) && index.begin();
+#endif  // GCODE_INDEX_FEATURE
+          // chunk is only written when full (sector multiple) or at the end
+          while (_client.available() && received < content_length &&
+                 !writeError) {
             ESP3DHal::wait(0);
-            size_t received_bytes = _client.read(chunk, sizeof(chunk));
-            if (received_bytes != file.write(chunk, received_bytes)) {
-              code = 500;
-              esp3d_log_e("Failed to write %s", url);
-              break;
-            } else {
-              received += received_bytes;
+            size_t received_bytes =
+                _client.read(chunk + buffered, sizeof(chunk) - buffered);
+            buffered += received_bytes;
+            received += received_bytes;
+            if (buffered == sizeof(chunk) || received >= content_length) {
+              if (buffered != file.write(chunk, buffered)) {
+                writeError = true;
+              }
+#if defined(GCODE_INDEX_FEATURE)
+              index.feed(chunk, buffered);
+#endif  // GCODE_INDEX_FEATURE
+              buffered = 0;
             }
 
 #if defined(HTTP_FEATURE)
@@ -138,7 +161,13 @@ void WebdavServer::handler_put(const char* url) {
             }
 #endif  // HTTP_FEATURE
           }
-          if (received != content_length) {
+          if (buffered > 0 && buffered != file.write(chunk, buffered)) {
+            writeError = true;
+          }
+#if defined(GCODE_INDEX_FEATURE)
+          index.feed(chunk, buffered);
+#endif  // GCODE_INDEX_FEATURE
+          if (writeError || received != content_length) {
             code = 500;
             esp3d_log_e("Failed to write %s", url);
           } else {
@@ -151,6 +180,12 @@ void WebdavServer::handler_put(const char* url) {
           }
 
           file.close();
+#if defined(GCODE_INDEX_FEATURE)
+          if (indexed && (code == 201 || code == 204)) {
+            index.end();
+            index.saveFor<WebDavFS>(url);
+          }
+#endif  // GCODE_INDEX_FEATURE
         } else {
           code = 500;
           esp3d_log_e("Failed to open %s for writing", url);
@@ -280,6 +280,9 @@ bool WebdavServer::send_response_code(int code) {
     case 201:
       _client.print("Created");
       break;
+    case 202:
+      _client.print("Accepted");
+      break;
     case 204:
       _client.print("No Content");
       break;
@@ -568,4 +571,21 @@ bool WebdavServer::isRoot(const char* url) {
 #endif  // WEBDAV_FEATURE == FS_ROOT
   return false;
 }
+
+// Path of url on Global Filesystem
+const char* WebdavServer::globalPath(const char* url) {
+  static String path;
+#if WEBDAV_FEATURE == FS_ROOT
+  path = url;
+#endif  // WEBDAV_FEATURE == FS_ROOT
+#if WEBDAV_FEATURE == FS_FLASH
+  path = ESP_FLASH_FS_HEADER;
+  path += url;
+#endif  // WEBDAV_FEATURE == FS_FLASH
+#if WEBDAV_FEATURE == FS_SD
+  path = ESP_SD_FS_HEADER;
+  path += url;
+#endif  // WEBDAV_FEATURE == FS_SD
+  return path.c_str();
+}
 #endif  // WEBDAV_FEATURE
\ No newline at end of file
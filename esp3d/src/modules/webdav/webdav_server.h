@@ -45,6 +45,8 @@ typedef ESP_SDFile WebDavFile;
 typedef ESP_SD WebDavFS;
 #endif  // WEBDAV_FEATURE == FS_SD
 
+// directories are copied / removed by Global Filesystem background jobs
+#include "../filesystem/esp_globalFS.h"
 #include <WiFiClient.h>
 #include <WiFiServer.h>
 
@@ -84,6 +86,7 @@ class WebdavServer {
   bool send_chunk_content(const char* content);
   const char* urlDecode(const char* url);
   bool isRoot(const char* url);
+  const char* globalPath(const char* url);
 
  private:
   bool _started;
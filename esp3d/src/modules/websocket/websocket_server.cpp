@@ -38,6 +38,10 @@
 #include "../authentication/authentication_service.h"
 #include "websocket_server.h"
 
+#if TXHEADERSIZE != WEBSOCKETS_MAX_HEADER_SIZE
+#error TXHEADERSIZE must be WEBSOCKETS_MAX_HEADER_SIZE
+#endif  // TXHEADERSIZE != WEBSOCKETS_MAX_HEADER_SIZE
+
 WebSocket_Server websocket_terminal_server("webui-v3",
                                            ESP3DClientType::webui_websocket);
 #if defined(WS_DATA_FEATURE)
@@ -315,7 +319,7 @@ size_t WebSocket_Server::writeBytes(const uint8_t *buffer, size_t size) {
       if (_TXbufferSize >= TXBUFFERSIZE) {
         flushTXbuffer();
       }
-      _TXbuffer[_TXbufferSize] = buffer[i];
+      _TXbuffer[TXHEADERSIZE + _TXbufferSize] = buffer[i];
       _TXbufferSize++;
     }
     esp3d_log("Buffered %d bytes for WebSocket on port %d", size, _port);
@@ -413,7 +417,8 @@ void WebSocket_Server::flushTXbuffer(void) {
   if (_started) {
     if ((_TXbufferSize > 0) && (_websocket_server->connectedClients() > 0)) {
       if (_websocket_server) {
-        _websocket_server->broadcastBIN(_TXbuffer, _TXbufferSize);
+        // header is written in reserved room, data is not copied
+        _websocket_server->broadcastBIN(_TXbuffer, _TXbufferSize, true);
         esp3d_log("Broadcasted %d bytes on WebSocket port %d", _TXbufferSize, _port);
       }
       // Refresh timeout
@@ -23,6 +23,8 @@
 
 #include "../../core/esp3d_message.h"
 #define TXBUFFERSIZE 1200
+// room left before TX data for frame header (WEBSOCKETS_MAX_HEADER_SIZE)
+#define TXHEADERSIZE 14
 #define RXBUFFERSIZE 256
 #define FLUSHTIMEOUT 500
 class WebSocketsServer;
@@ -65,7 +67,7 @@ class WebSocket_Server {
   uint32_t _lastRXflush;
   WebSocketsServer *_websocket_server;
   String _protocol;
-  uint8_t _TXbuffer[TXBUFFERSIZE];
+  uint8_t _TXbuffer[TXHEADERSIZE + TXBUFFERSIZE];
   uint16_t _TXbufferSize;
   uint8_t _current_id;
   void flushTXbuffer();
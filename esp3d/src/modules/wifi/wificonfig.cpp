@@ -33,6 +33,7 @@
 #include "../../core/esp3d_settings.h"
 #include "../network/netconfig.h"
 #include "../wifi/wificonfig.h"
+#include "../wifi/wifiscan.h"
 
 #if defined(ARDUINO_ARCH_ESP32)
 esp_netif_t *get_esp_interface_netif(esp_interface_t interface);
@@ -553,6 +554,7 @@ bool WiFiConfig::begin(int8_t& espMode) {
 
 void WiFiConfig::end() {
   esp3d_log("Shutting down WiFi");
+  WiFiScan::end();
 
   if ((WiFi.getMode() == WIFI_STA) || (WiFi.getMode() == WIFI_AP_STA)) {
     if (WiFi.isConnected()) {
@@ -585,6 +587,7 @@ void WiFiConfig::end() {
 }
 
 void WiFiConfig::handle() {
+  WiFiScan::handle();
   if (WiFi.getMode() == WIFI_AP_STA) {
     if (WiFi.scanComplete() != WIFI_SCAN_RUNNING) {
       esp3d_log("Disabling STA to avoid mixed mode conflict");
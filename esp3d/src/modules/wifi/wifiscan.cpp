@@ -0,0 +1,212 @@
+/*
+  wifiscan.cpp - WiFi background scan functions class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "../../include/esp3d_config.h"
+#if defined(WIFI_FEATURE)
+#include "../../core/esp3d_commands.h"
+#include "../../core/esp3d_hal.h"
+#include "wifiscan.h"
+
+bool WiFiScan::_running = false;
+bool WiFiScan::_failed = false;
+bool WiFiScan::_hasResults = false;
+bool WiFiScan::_switchedMode = false;
+volatile bool WiFiScan::_blocking = false;
+uint32_t WiFiScan::_startTime = 0;
+uint32_t WiFiScan::_scanTime = 0;
+uint8_t WiFiScan::_count = 0;
+uint8_t WiFiScan::_requestsCount = 0;
+ESP3DWiFiNetwork WiFiScan::_networks[ESP3D_WIFI_SCAN_MAX_NETWORKS];
+ESP3DWiFiScanRequest WiFiScan::_requests[ESP3D_WIFI_SCAN_MAX_REQUESTS];
+
+bool WiFiScan::switchMode() {
+  WiFiMode_t currentMode = WiFi.getMode();
+  if (currentMode == WIFI_OFF) {
+    esp3d_log_e("Cannot scan, WiFi is off");
+    return false;
+  }
+  // Scan needs STA interface, it is removed once scan is done
+  _switchedMode = false;
+  if (currentMode == WIFI_AP) {
+    esp3d_log("Switching to WIFI_AP_STA for scanning");
+    if (!WiFi.mode(WIFI_AP_STA)) {
+      esp3d_log_e("Failed to switch to AP_STA mode");
+      return false;
+    }
+    _switchedMode = true;
+  }
+  WiFi.scanDelete();
+  return true;
+}
+
+bool WiFiScan::start() {
+  if (_running) {
+    return true;
+  }
+  if (!switchMode()) {
+    return false;
+  }
+  int res = WiFi.scanNetworks(true);
+  if (res < 0 && res != WIFI_SCAN_RUNNING) {
+    esp3d_log_e("Failed to start WiFi scan");
+    if (_switchedMode) {
+      WiFi.mode(WIFI_AP);
+      _switchedMode = false;
+    }
+    return false;
+  }
+  esp3d_log("WiFi scan started");
+  _running = true;
+  _startTime = millis();
+  return true;
+}
+
+bool WiFiScan::scan() {
+  if (_running) {
+    // running scan is completed by handle() of main loop
+    while (_running) {
+#if defined(ARDUINO_ARCH_ESP8266)
+      // main loop does not run while a web request is served
+      handle();
+#endif  // ARDUINO_ARCH_ESP8266
+      ESP3DHal::wait(10);
+    }
+    return !_failed;
+  }
+  if (!switchMode()) {
+    return false;
+  }
+  // other clients asking meanwhile are answered when scan is done
+  _blocking = true;
+  _running = true;
+  _startTime = millis();
+  esp3d_log("WiFi scan started and waited for");
+  complete(WiFi.scanNetworks());
+  _blocking = false;
+  return !_failed;
+}
+
+void WiFiScan::handle() {
+  if (!_running || _blocking) {
+    return;
+  }
+  int n = WiFi.scanComplete();
+  if (n == WIFI_SCAN_RUNNING) {
+    if ((millis() - _startTime) < ESP3D_WIFI_SCAN_TIMEOUT) {
+      return;
+    }
+    esp3d_log_e("WiFi scan timeout");
+    n = WIFI_SCAN_FAILED;
+  }
+  complete(n);
+}
+
+void WiFiScan::complete(int n) {
+  _count = 0;
+  _failed = (n < 0);
+  if (!_failed) {
+    // Copy results so scan memory can be released now
+    for (int i = 0; i < n && _count < ESP3D_WIFI_SCAN_MAX_NETWORKS; i++) {
+      if (WiFi.RSSI(i) < MIN_RSSI) {
+        continue;
+      }
+      ESP3DWiFiNetwork& network = _networks[_count];
+      strncpy(network.ssid, WiFi.SSID(i).c_str(), MAX_SSID_LENGTH);
+      network.ssid[MAX_SSID_LENGTH] = '\0';
+      network.rssi = WiFi.RSSI(i);
+      network.isProtected = (WiFi.encryptionType(i) != ENC_TYPE_NONE);
+      _count++;
+    }
+    esp3d_log("WiFi scan done, %d networks found, %d kept", n, _count);
+  }
+  WiFi.scanDelete();
+  _hasResults = !_failed;
+  _scanTime = millis();
+  _running = false;
+  if (_switchedMode) {
+    esp3d_log("Restoring WiFi mode to AP");
+    if (!WiFi.mode(WIFI_AP)) {
+      esp3d_log_e("Failed to restore WiFi mode to AP");
+    }
+    _switchedMode = false;
+  }
+  // Answer the clients waiting for this scan
+  uint8_t requestsCount = _requestsCount;
+  _requestsCount = 0;
+  for (uint8_t i = 0; i < requestsCount; i++) {
+    esp3d_commands.dispatchWiFiScan(
+        _requests[i].target, _requests[i].requestId,
+        _requests[i].authentication_level, _requests[i].json);
+  }
+}
+
+void WiFiScan::end() {
+  if (_running) {
+    WiFi.scanDelete();
+  }
+  _running = false;
+  _switchedMode = false;
+  _hasResults = false;
+  _failed = false;
+  _count = 0;
+  _requestsCount = 0;
+}
+
+bool WiFiScan::isValid() {
+  return !_running && _hasResults && age() < ESP3D_WIFI_SCAN_TTL;
+}
+
+uint32_t WiFiScan::age() { return millis() - _scanTime; }
+
+const ESP3DWiFiNetwork* WiFiScan::network(uint8_t index) {
+  if (index >= _count) {
+    return nullptr;
+  }
+  return &_networks[index];
+}
+
+int8_t WiFiScan::findSSID(const char* ssid) {
+  if (!isValid()) {
+    return -1;
+  }
+  for (uint8_t i = 0; i < _count; i++) {
+    if (strcmp(_networks[i].ssid, ssid) == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+bool WiFiScan::addRequest(ESP3DClientType target, ESP3DRequest requestId,
+                          ESP3DAuthenticationLevel authentication_level,
+                          bool json) {
+  if (_requestsCount >= ESP3D_WIFI_SCAN_MAX_REQUESTS) {
+    esp3d_log_e("Too many clients waiting for WiFi scan");
+    return false;
+  }
+  _requests[_requestsCount].target = target;
+  _requests[_requestsCount].requestId = requestId;
+  _requests[_requestsCount].authentication_level = authentication_level;
+  _requests[_requestsCount].json = json;
+  _requestsCount++;
+  return true;
+}
+
+#endif  // WIFI_FEATURE
@@ -0,0 +1,105 @@
+/*
+  wifiscan.h - WiFi background scan functions class
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _WIFISCAN_ESP3D_H
+#define _WIFISCAN_ESP3D_H
+
+#include "../../include/esp3d_config.h"
+#if defined(WIFI_FEATURE)
+#include "../../core/esp3d_message.h"
+#include "wificonfig.h"
+
+// Time the scan results are served without scanning again (ms)
+#ifndef ESP3D_WIFI_SCAN_TTL
+#define ESP3D_WIFI_SCAN_TTL 30000
+#endif  // ESP3D_WIFI_SCAN_TTL
+
+// A scan running longer than this is considered failed (ms)
+#ifndef ESP3D_WIFI_SCAN_TIMEOUT
+#define ESP3D_WIFI_SCAN_TIMEOUT 15000
+#endif  // ESP3D_WIFI_SCAN_TIMEOUT
+
+// Networks kept from a scan
+#ifndef ESP3D_WIFI_SCAN_MAX_NETWORKS
+#if defined(ARDUINO_ARCH_ESP32)
+#define ESP3D_WIFI_SCAN_MAX_NETWORKS 32
+#else
+#define ESP3D_WIFI_SCAN_MAX_NETWORKS 16
+#endif  // ARDUINO_ARCH_ESP32
+#endif  // ESP3D_WIFI_SCAN_MAX_NETWORKS
+
+// Clients waiting for the running scan
+#define ESP3D_WIFI_SCAN_MAX_REQUESTS 4
+
+struct ESP3DWiFiNetwork {
+  char ssid[MAX_SSID_LENGTH + 1];
+  int8_t rssi;
+  bool isProtected;
+};
+
+struct ESP3DWiFiScanRequest {
+  ESP3DClientType target;
+  ESP3DRequest requestId;
+  ESP3DAuthenticationLevel authentication_level;
+  bool json;
+};
+
+class WiFiScan {
+ public:
+  // Start a scan in background, does nothing if one is running
+  static bool start();
+  // Scan and wait for results, for clients which cannot be answered later,
+  // false if scan failed
+  static bool scan();
+  static void handle();
+  static void end();
+  static bool isRunning() { return _running; }
+  // Results of last scan are there and not older than ESP3D_WIFI_SCAN_TTL
+  static bool isValid();
+  static bool hasFailed() { return _failed; }
+  static uint32_t age();
+  static uint8_t count() { return _count; }
+  static const ESP3DWiFiNetwork* network(uint8_t index);
+  // -1 if no valid results, else 1 if ssid is in results, 0 if not
+  static int8_t findSSID(const char* ssid);
+  // Client to answer when the running scan is done
+  static bool addRequest(ESP3DClientType target, ESP3DRequest requestId,
+                         ESP3DAuthenticationLevel authentication_level,
+                         bool json);
+
+ private:
+  static bool switchMode();
+  static void complete(int n);
+  static bool _running;
+  static bool _failed;
+  static bool _hasResults;
+  static bool _switchedMode;
+  // scan() is waiting in WiFi.scanNetworks(), handle() must not complete
+  static volatile bool _blocking;
+  static uint32_t _startTime;
+  static uint32_t _scanTime;
+  static uint8_t _count;
+  static uint8_t _requestsCount;
+  static ESP3DWiFiNetwork _networks[ESP3D_WIFI_SCAN_MAX_NETWORKS];
+  static ESP3DWiFiScanRequest _requests[ESP3D_WIFI_SCAN_MAX_REQUESTS];
+};
+
+#endif  // WIFI_FEATURE
+#endif  // _WIFISCAN_ESP3D_H
@@ -0,0 +1,334 @@
+/*
+  EspLuaEngine project
+
+  Copyright (c) 2024 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "EspLuaArena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#endif  // defined(ARDUINO_ARCH_ESP32)
+
+#define BLOCK_FREE ((size_t)1)
+#define BLOCK_PREV_FREE ((size_t)2)
+#define BLOCK_FLAGS (BLOCK_FREE | BLOCK_PREV_FREE)
+#define ALIGN_SIZE ((size_t)1 << ESP_LUA_ARENA_ALIGN_LOG2)
+// size and prevPhys, free list links are in payload
+#define HEADER_SIZE (sizeof(size_t) + sizeof(void*))
+#define MIN_BLOCK_SIZE (2 * sizeof(void*))
+#define SMALL_BLOCK_SIZE ((size_t)1 << ESP_LUA_ARENA_FL_SHIFT)
+#define MAX_BLOCK_SIZE ((size_t)1 << ESP_LUA_ARENA_FL_MAX)
+
+static int fls(size_t value) { return 31 - __builtin_clz((uint32_t)value); }
+
+static size_t alignUp(size_t value) {
+  return (value + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
+}
+
+// free list of size
+static void mapping(size_t size, int& fl, int& sl) {
+  if (size < SMALL_BLOCK_SIZE) {
+    fl = 0;
+    sl = size / (SMALL_BLOCK_SIZE / ESP_LUA_ARENA_SL_COUNT);
+  } else {
+    fl = fls(size);
+    sl = (size >> (fl - ESP_LUA_ARENA_SL_LOG2)) ^ ESP_LUA_ARENA_SL_COUNT;
+    fl -= ESP_LUA_ARENA_FL_SHIFT - 1;
+  }
+}
+
+// usable size of an allocation request
+static size_t adjustSize(size_t size) {
+  size = alignUp(size);
+  return size < MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : size;
+}
+
+EspLuaArena::EspLuaArena() : _pool(nullptr) { end(); }
+
+EspLuaArena::~EspLuaArena() { end(); }
+
+bool EspLuaArena::begin(size_t size) {
+  end();
+  if (size > MAX_BLOCK_SIZE) {
+    size = MAX_BLOCK_SIZE;
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  if (psramFound()) {
+    _pool = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    _inPsram = _pool != nullptr;
+  }
+#endif  // defined(ARDUINO_ARCH_ESP32)
+  if (!_pool) {
+    _pool = malloc(size);
+  }
+  if (!_pool) {
+    return false;
+  }
+  uintptr_t start = alignUp((uintptr_t)_pool);
+  uintptr_t stop = ((uintptr_t)_pool + size) & ~(ALIGN_SIZE - 1);
+  if (stop <= start + 2 * HEADER_SIZE + MIN_BLOCK_SIZE) {
+    end();
+    return false;
+  }
+  _size = size;
+  // one free block, then a used block of size 0 which ends the pool
+  Block* block = (Block*)start;
+  block->size = (stop - start - 2 * HEADER_SIZE) | BLOCK_FREE;
+  block->prevPhys = nullptr;
+  Block* last = nextPhys(block);
+  last->size = BLOCK_PREV_FREE;
+  last->prevPhys = block;
+  insertFree(block);
+  return true;
+}
+
+void EspLuaArena::end() {
+  if (_pool) {
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_inPsram) {
+      heap_caps_free(_pool);
+    } else {
+      free(_pool);
+    }
+#else
+    free(_pool);
+#endif  // defined(ARDUINO_ARCH_ESP32)
+  }
+  _pool = nullptr;
+  _size = 0;
+  _used = 0;
+  _peak = 0;
+  _free = 0;
+  _blocks = 0;
+  _failures = 0;
+  _inPsram = false;
+  _flBitmap = 0;
+  memset(_slBitmap, 0, sizeof(_slBitmap));
+  memset(_freeLists, 0, sizeof(_freeLists));
+}
+
+size_t EspLuaArena::blockSize(Block* block) {
+  return block->size & ~BLOCK_FLAGS;
+}
+
+EspLuaArena::Block* EspLuaArena::nextPhys(Block* block) {
+  return (Block*)((uint8_t*)payload(block) + blockSize(block));
+}
+
+void* EspLuaArena::payload(Block* block) {
+  return (uint8_t*)block + HEADER_SIZE;
+}
+
+EspLuaArena::Block* EspLuaArena::fromPayload(void* ptr) {
+  return (Block*)((uint8_t*)ptr - HEADER_SIZE);
+}
+
+void EspLuaArena::insertFree(Block* block) {
+  int fl, sl;
+  mapping(blockSize(block), fl, sl);
+  block->prevFree = nullptr;
+  block->nextFree = _freeLists[fl][sl];
+  if (block->nextFree) {
+    block->nextFree->prevFree = block;
+  }
+  _freeLists[fl][sl] = block;
+  _flBitmap |= 1U << fl;
+  _slBitmap[fl] |= 1U << sl;
+  _free += blockSize(block);
+}
+
+void EspLuaArena::removeFree(Block* block) {
+  int fl, sl;
+  mapping(blockSize(block), fl, sl);
+  if (block->prevFree) {
+    block->prevFree->nextFree = block->nextFree;
+  } else {
+    _freeLists[fl][sl] = block->nextFree;
+    if (!block->nextFree) {
+      _slBitmap[fl] &= ~(1U << sl);
+      if (!_slBitmap[fl]) {
+        _flBitmap &= ~(1U << fl);
+      }
+    }
+  }
+  if (block->nextFree) {
+    block->nextFree->prevFree = block->prevFree;
+  }
+  _free -= blockSize(block);
+}
+
+// first block of a free list where any block is big enough
+EspLuaArena::Block* EspLuaArena::findFree(size_t size) {
+  int fl, sl;
+  if (size >= SMALL_BLOCK_SIZE) {
+    size += ((size_t)1 << (fls(size) - ESP_LUA_ARENA_SL_LOG2)) - 1;
+  }
+  mapping(size, fl, sl);
+  if (fl >= ESP_LUA_ARENA_FL_COUNT) {
+    return nullptr;
+  }
+  uint32_t slMap = _slBitmap[fl] & (~0U << sl);
+  if (!slMap) {
+    uint32_t flMap =
+        fl + 1 < 32 ? (_flBitmap & (~0U << (fl + 1))) : 0;
+    if (!flMap) {
+      return nullptr;
+    }
+    fl = __builtin_ctz(flMap);
+    slMap = _slBitmap[fl];
+  }
+  sl = __builtin_ctz(slMap);
+  return _freeLists[fl][sl];
+}
+
+// used block keeps size bytes, the rest becomes a free block
+void EspLuaArena::trim(Block* block, size_t size) {
+  if (blockSize(block) < size + HEADER_SIZE + MIN_BLOCK_SIZE) {
+    return;
+  }
+  Block* rest = (Block*)((uint8_t*)payload(block) + size);
+  rest->size = (blockSize(block) - size - HEADER_SIZE) | BLOCK_FREE;
+  rest->prevPhys = block;
+  block->size = size | (block->size & BLOCK_FLAGS);
+  Block* next = nextPhys(rest);
+  if (next->size & BLOCK_FREE) {
+    removeFree(next);
+    rest->size += HEADER_SIZE + blockSize(next);
+    next = nextPhys(rest);
+  }
+  next->prevPhys = rest;
+  next->size |= BLOCK_PREV_FREE;
+  insertFree(rest);
+}
+
+void* EspLuaArena::allocate(size_t size) {
+  if (!_pool || size == 0) {
+    return nullptr;
+  }
+  size = adjustSize(size);
+  Block* block = size < MAX_BLOCK_SIZE ? findFree(size) : nullptr;
+  if (!block) {
+    _failures++;
+    return nullptr;
+  }
+  removeFree(block);
+  block->size &= ~BLOCK_FREE;
+  nextPhys(block)->size &= ~BLOCK_PREV_FREE;
+  trim(block, size);
+  _used += blockSize(block);
+  _blocks++;
+  if (_used > _peak) {
+    _peak = _used;
+  }
+  return payload(block);
+}
+
+void EspLuaArena::release(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  Block* block = fromPayload(ptr);
+  _used -= blockSize(block);
+  _blocks--;
+  if (block->size & BLOCK_PREV_FREE) {
+    Block* prev = block->prevPhys;
+    removeFree(prev);
+    prev->size += HEADER_SIZE + blockSize(block);
+    block = prev;
+  } else {
+    block->size |= BLOCK_FREE;
+  }
+  Block* next = nextPhys(block);
+  if (next->size & BLOCK_FREE) {
+    removeFree(next);
+    block->size += HEADER_SIZE + blockSize(next);
+    next = nextPhys(block);
+  }
+  next->prevPhys = block;
+  next->size |= BLOCK_PREV_FREE;
+  insertFree(block);
+}
+
+void* EspLuaArena::reallocate(void* ptr, size_t size) {
+  if (!ptr) {
+    return allocate(size);
+  }
+  if (size == 0) {
+    release(ptr);
+    return nullptr;
+  }
+  Block* block = fromPayload(ptr);
+  size_t current = blockSize(block);
+  size_t wanted = adjustSize(size);
+  if (wanted >= MAX_BLOCK_SIZE) {
+    _failures++;
+    return nullptr;
+  }
+  Block* next = nextPhys(block);
+  if (wanted > current && (next->size & BLOCK_FREE) &&
+      current + HEADER_SIZE + blockSize(next) >= wanted) {
+    // grow in place over next free block
+    removeFree(next);
+    block->size += HEADER_SIZE + blockSize(next);
+    nextPhys(block)->size &= ~BLOCK_PREV_FREE;
+    nextPhys(block)->prevPhys = block;
+  }
+  if (blockSize(block) >= wanted) {
+    trim(block, wanted);
+    _used += blockSize(block) - current;
+    if (_used > _peak) {
+      _peak = _used;
+    }
+    return ptr;
+  }
+  void* newPtr = allocate(size);
+  if (newPtr) {
+    memcpy(newPtr, ptr, current);
+    release(ptr);
+  }
+  return newPtr;
+}
+
+size_t EspLuaArena::largestFree() {
+  if (!_flBitmap) {
+    return 0;
+  }
+  int fl = 31 - __builtin_clz(_flBitmap);
+  int sl = 31 - __builtin_clz(_slBitmap[fl]);
+  size_t largest = 0;
+  for (Block* block = _freeLists[fl][sl]; block; block = block->nextFree) {
+    if (blockSize(block) > largest) {
+      largest = blockSize(block);
+    }
+  }
+  return largest;
+}
+
+void* EspLuaArena::luaAlloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+  (void)osize;
+  EspLuaArena* arena = static_cast<EspLuaArena*>(ud);
+  if (nsize == 0) {
+    arena->release(ptr);
+    return nullptr;
+  }
+  return arena->reallocate(ptr, nsize);
+}
@@ -0,0 +1,92 @@
+/*
+  EspLuaEngine project
+
+  Copyright (c) 2024 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Two levels segregated fit (TLSF) allocator on a fixed memory pool, so a
+// Lua state cannot use or fragment more memory than the pool size
+// allocation, free and resize in place are O(1)
+#define ESP_LUA_ARENA_ALIGN_LOG2 3
+#define ESP_LUA_ARENA_SL_LOG2 4
+// biggest block is 2^ESP_LUA_ARENA_FL_MAX bytes
+#define ESP_LUA_ARENA_FL_MAX 26
+#define ESP_LUA_ARENA_FL_SHIFT (ESP_LUA_ARENA_SL_LOG2 + ESP_LUA_ARENA_ALIGN_LOG2)
+#define ESP_LUA_ARENA_FL_COUNT \
+  (ESP_LUA_ARENA_FL_MAX - ESP_LUA_ARENA_FL_SHIFT + 1)
+#define ESP_LUA_ARENA_SL_COUNT (1 << ESP_LUA_ARENA_SL_LOG2)
+
+class EspLuaArena {
+ public:
+  EspLuaArena();
+  ~EspLuaArena();
+  // Reserve pool of size bytes, in PSRAM if any
+  bool begin(size_t size);
+  void end();
+  bool started() { return _pool != nullptr; }
+  void* allocate(size_t size);
+  // Same as realloc, ptr is kept if there is no room for size
+  void* reallocate(void* ptr, size_t size);
+  void release(void* ptr);
+  // lua_Alloc function, ud is the arena
+  static void* luaAlloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+  size_t size() { return _size; }
+  // bytes given to blocks in use, peak since begin or resetPeak
+  size_t used() { return _used; }
+  size_t peak() { return _peak; }
+  size_t freeSize() { return _free; }
+  // biggest allocation possible now, it walks one free list
+  size_t largestFree();
+  size_t blocks() { return _blocks; }
+  uint32_t failures() { return _failures; }
+  bool inPsram() { return _inPsram; }
+  void resetPeak() { _peak = _used; }
+
+ private:
+  struct Block {
+    // payload size, bit 0: block is free, bit 1: previous block is free
+    size_t size;
+    Block* prevPhys;
+    // only in free blocks
+    Block* nextFree;
+    Block* prevFree;
+  };
+  static size_t blockSize(Block* block);
+  static Block* nextPhys(Block* block);
+  static void* payload(Block* block);
+  static Block* fromPayload(void* ptr);
+  void insertFree(Block* block);
+  void removeFree(Block* block);
+  Block* findFree(size_t size);
+  void trim(Block* block, size_t size);
+  void* _pool;
+  size_t _size;
+  size_t _used;
+  size_t _peak;
+  size_t _free;
+  size_t _blocks;
+  uint32_t _failures;
+  bool _inPsram;
+  uint32_t _flBitmap;
+  uint32_t _slBitmap[ESP_LUA_ARENA_FL_COUNT];
+  Block* _freeLists[ESP_LUA_ARENA_FL_COUNT][ESP_LUA_ARENA_SL_COUNT];
+};
@@ -46,13 +46,13 @@ String EspLuaEngine::_lastError;
 std::atomic<bool> EspLuaEngine::_isPaused{false};
 std::atomic<bool> EspLuaEngine::_isRunning{false};
 
-EspLuaEngine::EspLuaEngine() : _lua_state(nullptr) {
-  _lua_state = luaL_newstate();
-  if (_lua_state) {
-    _loadLibraries();
-  } else {
-    log_e("Error : Impossible to create a new Lua state");
-  }
+EspLuaEngine::EspLuaEngine()
+    : _lua_state(nullptr),
+      _arena(nullptr),
+      _gcMode(GCMode::Incremental),
+      _gcParam1(0),
+      _gcParam2(0) {
+  _newState();
 }
 
 EspLuaEngine::~EspLuaEngine() {
@@ -93,20 +93,43 @@ void EspLuaEngine::hookFunction(lua_State* L, lua_Debug* ar) {
 void EspLuaEngine::resetState() {
   if (_lua_state) {
     lua_close(_lua_state);
-    _lua_state = luaL_newstate();
-    if (_lua_state) {
-      _loadLibraries();
-    } else {
-      log_e("Error: Impossible to create a new Lua state");
-    }
+    _lua_state = nullptr;
+    _newState();
   }
 }
 
+bool EspLuaEngine::setArena(EspLuaArena* arena) {
+  if (_isRunning.load()) {
+    log_e("Error: Cannot change arena while a script is running");
+    return false;
+  }
+  if (_lua_state) {
+    lua_close(_lua_state);
+    _lua_state = nullptr;
+  }
+  _arena = (arena && arena->started()) ? arena : nullptr;
+  _newState();
+  return _lua_state != nullptr;
+}
+
+void EspLuaEngine::setGC(GCMode mode, int param1, int param2) {
+  _gcMode = mode;
+  _gcParam1 = param1;
+  _gcParam2 = param2;
+}
+
 bool EspLuaEngine::executeScript(const char* script) {
   _lastError="";  // Clear the error message
   _isPaused.store(false);
   _isRunning.store(true);
 
+  // state is only used by script task, so GC is set here
+  if (_gcMode == GCMode::Generational) {
+    lua_gc(_lua_state, LUA_GCGEN, _gcParam1, _gcParam2);
+  } else {
+    lua_gc(_lua_state, LUA_GCINC, _gcParam1, _gcParam2, 0);
+  }
+
   // Configure the hook function
   lua_sethook(_lua_state, hookFunction, LUA_MASKCOUNT,
               ESP_LUA_NB_LINES_BEFORE_HOOK);
@@ -276,6 +299,29 @@ bool EspLuaEngine::_registerConstantImpl(const char* name, int value) {
 }
 
 /*Private methods*/
+void EspLuaEngine::_newState() {
+  if (_arena) {
+    _lua_state = lua_newstate(EspLuaArena::luaAlloc, _arena);
+    if (_lua_state) {
+      lua_atpanic(_lua_state, _panic);
+    }
+  } else {
+    _lua_state = luaL_newstate();
+  }
+  if (_lua_state) {
+    _loadLibraries();
+  } else {
+    log_e("Error: Impossible to create a new Lua state");
+  }
+}
+
+// same as luaL_newstate panic function
+int EspLuaEngine::_panic(lua_State* L) {
+  const char* msg = lua_tostring(L, -1);
+  log_e("Lua panic: %s", msg ? msg : "error object is not a string");
+  return 0;
+}
+
 void EspLuaEngine::_loadLibraries() {
   static const luaL_Reg loadedlibs[] = {{"_G", luaopen_base},
                                         {LUA_TABLIBNAME, luaopen_table},
@@ -25,6 +25,7 @@
 #include <atomic>
 #include <functional>
 
+#include "EspLuaArena.h"
 #include "lua-5.4.7/src/lua.hpp"
 #if defined(ARDUINO_ARCH_ESP32)
 #define ESP_LUA_CHECK_INTERVAL pdMS_TO_TICKS(10)
@@ -43,6 +44,10 @@ class EspLuaEngine {
     Running,
     Paused,
   };
+  enum class GCMode {
+    Incremental,
+    Generational,
+  };
   EspLuaEngine();
   ~EspLuaEngine();
 
@@ -56,6 +61,15 @@ class EspLuaEngine {
   lua_State* getLuaState() { return _lua_state; }
   const char* getLastError() { return _lastError.c_str(); }
   void resetState();
+  // Lua state is created again in arena (nullptr for system heap), so
+  // functions and constants must be registered again
+  bool setArena(EspLuaArena* arena);
+  EspLuaArena* getArena() { return _arena; }
+  // Used when next script starts, 0 keeps current value
+  // Incremental: pause, step multiplier (%)
+  // Generational: minor multiplier, major multiplier (%)
+  void setGC(GCMode mode, int param1 = 0, int param2 = 0);
+  GCMode getGCMode() { return _gcMode; }
 
   void setPauseFunction(PauseFunction func);
 
@@ -70,6 +84,10 @@ class EspLuaEngine {
 
  private:
   lua_State* _lua_state;
+  EspLuaArena* _arena;
+  GCMode _gcMode;
+  int _gcParam1;
+  int _gcParam2;
   static PauseFunction _pauseFunction;
   static String _lastError;
   static std::atomic<bool> _isPaused;
@@ -78,6 +96,8 @@ class EspLuaEngine {
   static void hookFunction(lua_State* L, lua_Debug* ar);
   static void _defaultPauseFunction();
   void _loadLibraries();
+  void _newState();
+  static int _panic(lua_State* L);
   bool _checkPreconditions(const char* name);
   bool _verifyGlobal(const char* name, int type);
   void _cleanupOnFailure(const char* name, int top);
@@ -23,6 +23,7 @@
  */
 
 #include "WebSockets.h"
+#include "WebSocketsMask.h"
 
 #ifdef ESP8266
 #include <core_esp8266_features.h>
@@ -279,9 +280,7 @@ bool WebSockets::sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * pay
             dataMaskPtr = payloadPtr;
         }
 
-        for(size_t x = 0; x < length; x++) {
-            dataMaskPtr[x] = (dataMaskPtr[x] ^ maskKey[x % 4]);
-        }
+        websocketsMask(dataMaskPtr, length, maskKey);
     }
 
 #ifndef NODEBUG_WEBSOCKETS
@@ -473,9 +472,7 @@ void WebSockets::handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t
 
             if(header->mask) {
                 // decode XOR
-                for(size_t i = 0; i < header->payloadLen; i++) {
-                    payload[i] = (payload[i] ^ header->maskKey[i % 4]);
-                }
+                websocketsMask(payload, header->payloadLen, header->maskKey);
             }
         }
 
@@ -0,0 +1,64 @@
+/**
+ * @file WebSocketsMask.h
+ * @date 18.10.2023
+ *
+ * This file is part of the WebSockets for Arduino.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef WEBSOCKETSMASK_H_
+#define WEBSOCKETSMASK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * XOR payload with the 4 bytes mask key (mask and unmask are the same)
+ * bytes are handled one by one until data is 32 bit aligned, then 4 by 4
+ * @param data uint8_t *        ptr to the payload
+ * @param length size_t         length of the payload
+ * @param maskKey uint8_t[4]    key of the frame
+ */
+static inline void websocketsMask(uint8_t * data, size_t length, const uint8_t * maskKey) {
+    size_t i = 0;
+
+    while(i < length && ((uintptr_t)(data + i) & 3)) {
+        data[i] ^= maskKey[i & 3];
+        i++;
+    }
+
+    if(length - i >= 4) {
+        // key rotated to start at byte i
+        uint8_t key[4] = { maskKey[i & 3], maskKey[(i + 1) & 3], maskKey[(i + 2) & 3], maskKey[(i + 3) & 3] };
+        uint32_t key32;
+        memcpy(&key32, key, sizeof(key32));
+        uint32_t * data32 = (uint32_t *)(data + i);
+        size_t words      = (length - i) / 4;
+        for(size_t w = 0; w < words; w++) {
+            data32[w] ^= key32;
+        }
+        i += words * 4;
+    }
+
+    while(i < length) {
+        data[i] ^= maskKey[i & 3];
+        i++;
+    }
+}
+
+#endif /* WEBSOCKETSMASK_H_ */
@@ -200,22 +200,11 @@ bool WebSocketsServerCore::sendTXT(uint8_t num, String & payload) {
  * @return true if ok
  */
 bool WebSocketsServerCore::broadcastTXT(uint8_t * payload, size_t length, bool headerToPayload) {
-    WSclient_t * client;
-    bool ret = true;
     if(length == 0) {
         length = strlen((const char *)payload);
     }
 
-    for(uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
-        client = &_clients[i];
-        if(clientIsConnected(client)) {
-            if(!sendFrame(client, WSop_text, payload, length, true, headerToPayload)) {
-                ret = false;
-            }
-        }
-        WEBSOCKETS_YIELD();
-    }
-    return ret;
+    return broadcastFrame(WSop_text, payload, length, headerToPayload);
 }
 
 bool WebSocketsServerCore::broadcastTXT(const uint8_t * payload, size_t length) {
@@ -265,22 +254,74 @@ bool WebSocketsServerCore::sendBIN(uint8_t num, const uint8_t * payload, size_t
  * @return true if ok
  */
 bool WebSocketsServerCore::broadcastBIN(uint8_t * payload, size_t length, bool headerToPayload) {
+    return broadcastFrame(WSop_binary, payload, length, headerToPayload);
+}
+
+bool WebSocketsServerCore::broadcastBIN(const uint8_t * payload, size_t length) {
+    return broadcastBIN((uint8_t *)payload, length);
+}
+
+/**
+ * send same frame to all clients
+ * server frames are not masked so the header is the same for every client,
+ * it is built once and the payload is not copied per client
+ * @param opcode WSopcode_t
+ * @param payload uint8_t *
+ * @param length size_t
+ * @param headerToPayload bool  (see sendFrame for more details)
+ * @return true if ok
+ */
+bool WebSocketsServerCore::broadcastFrame(WSopcode_t opcode, uint8_t * payload, size_t length, bool headerToPayload) {
     WSclient_t * client;
     bool ret = true;
+    uint8_t maskKey[4]                         = { 0x00, 0x00, 0x00, 0x00 };
+    uint8_t buffer[WEBSOCKETS_MAX_HEADER_SIZE] = { 0 };
+    uint8_t * headerPtr                        = &buffer[0];
+    uint8_t * dataPtr                          = NULL;
+    uint8_t headerSize;
+
+#ifdef WEBSOCKETS_USE_BIG_MEM
+    // same as sendFrame: one TCP package per client, but only one copy for all
+    if(!headerToPayload && ((length > 0) && (length < 1400)) && (GET_FREE_HEAP > 6000)) {
+        dataPtr = (uint8_t *)malloc(length + WEBSOCKETS_MAX_HEADER_SIZE);
+        if(dataPtr) {
+            memcpy((dataPtr + WEBSOCKETS_MAX_HEADER_SIZE), payload, length);
+            payload         = dataPtr;
+            headerToPayload = true;
+        }
+    }
+#endif
+
+    headerSize = createHeader(&buffer[0], opcode, length, false, maskKey, true);
+    if(headerToPayload) {
+        headerPtr = (payload + (WEBSOCKETS_MAX_HEADER_SIZE - headerSize));
+        memcpy(headerPtr, &buffer[0], headerSize);
+    }
+
     for(uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
         client = &_clients[i];
         if(clientIsConnected(client)) {
-            if(!sendFrame(client, WSop_binary, payload, length, true, headerToPayload)) {
+            if(client->status != WSC_CONNECTED) {
                 ret = false;
+            } else if(headerToPayload) {
+                if(write(client, headerPtr, (length + headerSize)) != (length + headerSize)) {
+                    ret = false;
+                }
+            } else {
+                if(write(client, headerPtr, headerSize) != headerSize) {
+                    ret = false;
+                } else if(payload && length > 0 && write(client, payload, length) != length) {
+                    ret = false;
+                }
             }
         }
         WEBSOCKETS_YIELD();
     }
-    return ret;
-}
 
-bool WebSocketsServerCore::broadcastBIN(const uint8_t * payload, size_t length) {
-    return broadcastBIN((uint8_t *)payload, length);
+    if(dataPtr) {
+        free(dataPtr);
+    }
+    return ret;
 }
 
 /**
@@ -0,0 +1,142 @@
+// Host driver for esp3d/src/core/esp3d_args.cpp
+// Usage: args_host check < hex lines > result lines
+//   each input line is parameters in hex, each output line is
+//   T|F (truncated), index of clean token (-1 if none), tokens in hex
+//   ("-" for empty token), then a line reused at same address with one byte
+//   changed must not be seen as parsed
+// Usage: args_host bench <loops> < hex lines
+//   parse + lookups as a handler does, versus lookups only (cached)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "esp3d_args.h"
+
+static bool fromHex(const char* hex, std::string& out) {
+  out.clear();
+  size_t len = strlen(hex);
+  while (len > 0 && (hex[len - 1] == '\n' || hex[len - 1] == '\r')) {
+    len--;
+  }
+  if (len % 2) {
+    return false;
+  }
+  for (size_t i = 0; i < len; i += 2) {
+    char byte[3] = {hex[i], hex[i + 1], 0};
+    out += (char)strtol(byte, nullptr, 16);
+  }
+  return true;
+}
+
+static void printHex(const char* s) {
+  if (!*s) {
+    fputc('-', stdout);
+  }
+  for (; *s; s++) {
+    printf("%02x", (uint8_t)*s);
+  }
+}
+
+static std::vector<std::string> readLines() {
+  std::vector<std::string> lines;
+  static char hex[8192];
+  std::string line;
+  while (fgets(hex, sizeof(hex), stdin)) {
+    if (fromHex(hex, line)) {
+      lines.push_back(line);
+    }
+  }
+  return lines;
+}
+
+static int check() {
+  int errors = 0;
+  ESP3DArgs args;
+  for (const std::string& line : readLines()) {
+    // parse from heap copy so ASan sees reads past the end
+    size_t size = line.size();
+    char* data = (char*)malloc(size ? size : 1);
+    memcpy(data, line.data(), size);
+    bool ok = args.parse(data, size, 0);
+    if (ok == args.truncated()) {
+      errors++;
+    }
+    int clean = -1;
+    for (uint8_t i = 0; i < args.count(); i++) {
+      if (args.clean() == args.token(i)) {
+        clean = i;
+        break;
+      }
+    }
+    printf("%c %d", args.truncated() ? 'T' : 'F', clean);
+    for (uint8_t i = 0; i < args.count(); i++) {
+      fputc(' ', stdout);
+      printHex(args.token(i));
+    }
+    fputc('\n', stdout);
+    if (!args.isParsed(data, size, 0)) {
+      errors++;
+    }
+    if (size > 0) {
+      data[size / 2] ^= 0x01;
+      if (args.isParsed(data, size, 0)) {
+        fprintf(stderr, "Stale tokens for reused buffer\n");
+        errors++;
+      }
+    }
+    if (args.isParsed(data, size + 1, 0) || args.isParsed(data, size, 1)) {
+      errors++;
+    }
+    free(data);
+  }
+  return errors == 0 ? 0 : 1;
+}
+
+static int bench(int loops) {
+  std::vector<std::string> lines = readLines();
+  if (lines.empty()) {
+    return 1;
+  }
+  const char* labels[] = {"json", "pwd=", "SSID=", "value=", "path="};
+  ESP3DArgs args;
+  size_t hits = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int l = 0; l < loops; l++) {
+    for (const std::string& line : lines) {
+      args.parse(line.data(), line.size(), 0);
+      for (const char* label : labels) {
+        hits += args.isParsed(line.data(), line.size(), 0) &&
+                args.get(label)[0] != 0;
+      }
+    }
+  }
+  double parse = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  start = std::chrono::steady_clock::now();
+  for (int l = 0; l < loops; l++) {
+    for (const std::string& line : lines) {
+      for (const char* label : labels) {
+        hits += args.isParsed(line.data(), line.size(), 0) &&
+                args.get(label)[0] != 0;
+      }
+    }
+  }
+  double lookup = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  double n = (double)loops * lines.size();
+  fprintf(stderr, "parse + 5 lookups: %.0f ns/line, 5 lookups: %.0f ns/line (%zu)\n",
+          parse * 1e9 / n, lookup * 1e9 / n, hits);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+    return bench(argc > 2 ? atoi(argv[2]) : 1000);
+  }
+  return check();
+}
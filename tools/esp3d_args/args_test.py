@@ -0,0 +1,179 @@
+#!/usr/bin/python
+# Fuzz and benchmark [ESPxxx] parameters tokenizer of ESP3D on host
+# Random and limit lines are parsed by esp3d_args.cpp (built with
+# AddressSanitizer) and by the reference below, tokens must be the same
+# Usage: args_test.py [lines] [seed]
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+SOURCES = os.path.join(ROOT, "..", "..", "esp3d", "src")
+
+
+def limits():
+    with open(os.path.join(SOURCES, "include", "esp3d_defines.h")) as f:
+        text = f.read()
+    tokens = int(re.search(r"#define ESP3D_ARGS_MAX_TOKENS (\d+)", text).group(1))
+    size = int(re.search(r"#define ESP3D_ARGS_BUFFER_SIZE (\d+)", text).group(1))
+    return tokens, size
+
+
+MAX_TOKENS, BUFFER_SIZE = limits()
+
+
+def build(tmp, flags):
+    # tokenizer only needs limits and empty logs
+    core = os.path.join(tmp, "src", "core")
+    include = os.path.join(tmp, "src", "include")
+    os.makedirs(core, exist_ok=True)
+    os.makedirs(include, exist_ok=True)
+    with open(os.path.join(tmp, "Arduino.h"), "w") as f:
+        f.write("#include <ctype.h>\n#include <stdint.h>\n"
+                "#include <string.h>\n#include <strings.h>\n")
+    with open(os.path.join(include, "esp3d_config.h"), "w") as f:
+        f.write("#define ESP3D_ARGS_MAX_TOKENS {}\n"
+                "#define ESP3D_ARGS_BUFFER_SIZE {}\n".format(MAX_TOKENS, BUFFER_SIZE))
+    with open(os.path.join(core, "esp3d_log.h"), "w") as f:
+        f.write("#define esp3d_log(...)\n#define esp3d_log_e(...)\n")
+    for name in ["esp3d_args.h", "esp3d_args.cpp"]:
+        shutil.copy(os.path.join(SOURCES, "core", name), core)
+    exe = os.path.join(tmp, "args_host" + flags[0])
+    cxx = os.environ.get("CXX", "g++")
+    subprocess.check_call([cxx, "-std=c++11", "-Wall", "-I", tmp, "-I", core] +
+                          flags[1:] + [os.path.join(ROOT, "args_host.cpp"),
+                                       os.path.join(core, "esp3d_args.cpp"), "-o", exe])
+    return exe
+
+
+# Same rules as ESP3DArgs::parse, return (truncated, clean index, tokens)
+def reference(data):
+    tokens = []
+    pos = 0
+    i = 0
+    n = len(data)
+    truncated = False
+    space = b" \t\n\v\f\r"
+    while i < n and not truncated:
+        while i < n and data[i] in space:
+            i += 1
+        if i >= n:
+            break
+        if len(tokens) == MAX_TOKENS or pos >= BUFFER_SIZE - 1:
+            truncated = True
+            break
+        token = bytearray()
+        inQuote = False
+        hasKey = False
+        quoteAllowed = True
+        while i < n:
+            c = data[i]
+            if c == ord("\\") and i + 1 < n:
+                i += 1
+                c = data[i]
+                quoteAllowed = False
+            elif c == ord('"') and (inQuote or quoteAllowed):
+                inQuote = not inQuote
+                quoteAllowed = False
+                i += 1
+                continue
+            elif not inQuote and c in space:
+                break
+            elif c == ord("=") and not hasKey and not inQuote:
+                hasKey = True
+                quoteAllowed = True
+                token.append(c)
+                pos += 1
+                i += 1
+                if pos >= BUFFER_SIZE - 1:
+                    truncated = True
+                    break
+                continue
+            else:
+                quoteAllowed = False
+            if pos >= BUFFER_SIZE - 1:
+                truncated = True
+                break
+            token.append(c)
+            pos += 1
+            i += 1
+        pos += 1
+        # handlers see tokens as C strings
+        tokens.append(bytes(token).split(b"\0")[0])
+    clean = -1
+    for index, token in enumerate(tokens):
+        if token != b"json" and not token.startswith(b"json=") \
+                and not token.startswith(b"pwd="):
+            clean = index
+            break
+    return truncated, clean, tokens
+
+
+PIECES = [b" ", b"  ", b"\t", b"\"", b"\\", b"=", b"a", b"SSID", b"json",
+          b"json=yes", b"pwd=", b"value=\"", b"\xc3\xa9", b"\x85", b"\x00"]
+
+
+def randomLine(rng):
+    kind = rng.random()
+    if kind < 0.05:
+        # more tokens than limit
+        return b" ".join(b"t%d=%d" % (i, i) for i in range(rng.randint(MAX_TOKENS - 1, MAX_TOKENS + 3)))
+    if kind < 0.10:
+        # around buffer size
+        size = rng.randint(BUFFER_SIZE - 20, BUFFER_SIZE + 20)
+        return b"value=\"" + b"x" * size + b"\" json"
+    return b"".join(rng.choice(PIECES) for _ in range(rng.randint(0, 40)))
+
+
+def parseResult(line):
+    fields = line.split(" ")
+    tokens = [b"" if t == "-" else bytes.fromhex(t) for t in fields[2:]]
+    return fields[0] == "T", int(fields[1]), tokens
+
+
+def main():
+    count = int(sys.argv[1]) if len(sys.argv) > 1 else 20000
+    seed = int(sys.argv[2]) if len(sys.argv) > 2 else 1
+    rng = random.Random(seed)
+    lines = [b"", b"json", b"pwd=admin json=yes SSID=\"my box\" \\\"x",
+             b"path=\"/a b/c.gco\" value=a\\ b"] + \
+        [randomLine(rng) for _ in range(count)]
+    stdin = "".join(line.hex() + "\n" for line in lines).encode()
+    tmp = tempfile.mkdtemp()
+    try:
+        check = build(tmp, ["_asan", "-O1", "-g", "-fsanitize=address,undefined",
+                            "-fno-sanitize-recover=all"])
+        bench = build(tmp, ["", "-O2"])
+        out = subprocess.run([check, "check"], input=stdin, capture_output=True)
+        results = out.stdout.decode().split("\n")[:-1]
+        errors = 0
+        if out.returncode != 0 or len(results) != len(lines):
+            print(out.stderr.decode())
+            errors += 1
+        truncated = 0
+        for line, result in zip(lines, results):
+            expected = reference(line)
+            truncated += expected[0]
+            if parseResult(result) != expected:
+                errors += 1
+                if errors < 10:
+                    print("{!r}: {} expected {}".format(line, result, expected))
+        print("{} lines, {} truncated, {}".format(
+            len(lines), truncated, "OK" if errors == 0 else "{} errors".format(errors)))
+        # typical commands for speed
+        typical = [b"SSID=\"my box\" pwd=admin json", b"value=1 json=yes",
+                   b"path=/sd/file.gco", b"", b"ON pwd=user"]
+        out = subprocess.run([bench, "bench", "200000"],
+                             input="".join(l.hex() + "\n" for l in typical).encode(),
+                             capture_output=True, check=True)
+        print(out.stderr.decode().strip())
+    finally:
+        shutil.rmtree(tmp)
+    sys.exit(0 if errors == 0 else 1)
+
+
+main()
@@ -1,5 +1,7 @@
 #!/usr/bin/python
 #Common ESP3D snippets
+import os
+import select
 import time
 
 class bcolors:
@@ -28,4 +30,54 @@ def wait(durationms, ser):
 def send_echo(ser, msg):
     ser.write((msg + "\n").encode('utf-8'))
     ser.flush()
-    print(bcolors.END_COL + msg + bcolors.END_COL)
\ No newline at end of file
+    print(bcolors.END_COL + msg + bcolors.END_COL)
+
+# Pseudo terminal with same API as serial.Serial used by simulators
+# host side programs can open slave_name like a real serial port
+class PtyPort:
+    def __init__(self):
+        self.master, self.slave = os.openpty()
+        self.slave_name = os.ttyname(self.slave)
+        try:
+            import tty
+            tty.setraw(self.slave)
+        except Exception:
+            pass
+        self._pending = bytearray()
+
+    def _fill(self, timeout=0):
+        ready, _, _ = select.select([self.master], [], [], timeout)
+        if ready:
+            try:
+                self._pending.extend(os.read(self.master, 1024))
+            except OSError:
+                pass
+
+    @property
+    def in_waiting(self):
+        if not self._pending:
+            self._fill()
+        return len(self._pending)
+
+    def read(self, size=1):
+        if not self._pending:
+            self._fill(1)
+        data = bytes(self._pending[:size])
+        del self._pending[:size]
+        return data
+
+    def readline(self):
+        while b'\n' not in self._pending:
+            before = len(self._pending)
+            self._fill(1)
+            if len(self._pending) == before:
+                break
+        index = self._pending.find(b'\n')
+        size = index + 1 if index != -1 else len(self._pending)
+        return self.read(size)
+
+    def write(self, data):
+        return os.write(self.master, data)
+
+    def flush(self):
+        pass
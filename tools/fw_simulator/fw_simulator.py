@@ -1,13 +1,18 @@
 #!/usr/bin/python
 import sys
-import serial
-import serial.tools.list_ports
+# pyserial is only needed for real ports, pseudo terminal works without it
+try:
+    import serial
+    import serial.tools.list_ports
+except ImportError:
+    serial = None
 import esp3d_common as common
 import marlin 
 import grbl
 import grblhal
 import repetier
 import smoothieware
+import meatpack
 
 def isRealTimeCommand(c: int) -> bool:
     # Convertit en entier si ce n'est pas déjà le cas
@@ -26,9 +31,31 @@ def isRealTimeCommand(c: int) -> bool:
         
     return False
 
+def openDetectedPort():
+    if serial is None:
+        print(common.bcolors.COL_RED+"pyserial is not installed, use pty"+common.bcolors.END_COL)
+        return None
+    ports = serial.tools.list_ports.comports()
+    portBoard = ""
+    print(common.bcolors.COL_GREEN+"Serial ports detected: "+common.bcolors.END_COL)
+    for port, desc, hwid in sorted(ports):
+        print(common.bcolors.COL_GREEN+" - {}: {} ".format(port, desc)+common.bcolors.END_COL)
+        desc.capitalize()
+        if (desc.find("SERIAL") != -1 or desc.find("UART") != -1):
+            portBoard = port
+            print(common.bcolors.COL_GREEN +
+                  "Found " + portBoard + " for ESP3D"+common.bcolors.END_COL)
+            break
+    if (portBoard == ""):
+        print(common.bcolors.COL_RED+"No serial port found"+common.bcolors.END_COL)
+        return None
+    print(common.bcolors.COL_GREEN+"Open port " + str(portBoard)+common.bcolors.END_COL)
+    return serial.Serial(portBoard, 115200, timeout=1)
+
 def main():
     if len(sys.argv) < 2:
         print("Please use one of the follwowing FW: marlin, repetier, smoothieware, grbl or grblhal.")
+        print("Usage: fw_simulator.py <fw> [port|pty]")
         return
 
     fw_name = sys.argv[1].lower()
@@ -46,26 +73,29 @@ def main():
     else:
         print("Firmware not supported : {}".format(fw_name))
         return
-    ports = serial.tools.list_ports.comports()
-    portBoard = ""
-    print(common.bcolors.COL_GREEN+"Serial ports detected: "+common.bcolors.END_COL)
-    for port, desc, hwid in sorted(ports):
-        print(common.bcolors.COL_GREEN+" - {}: {} ".format(port, desc)+common.bcolors.END_COL)
-        desc.capitalize()
-        if (desc.find("SERIAL") != -1 or desc.find("UART") != -1):
-            portBoard = port
-            print(common.bcolors.COL_GREEN +
-                  "Found " + portBoard + " for ESP3D"+common.bcolors.END_COL)
-            break
-    print(common.bcolors.COL_GREEN+"Open port " + str(port)+common.bcolors.END_COL)
-    if (portBoard == ""):
-        print(common.bcolors.COL_RED+"No serial port found"+common.bcolors.END_COL)
-        exit(0)
-    ser = serial.Serial(portBoard, 115200, timeout=1)
+    # optional second parameter: serial port name or "pty"
+    portArg = sys.argv[2] if len(sys.argv) > 2 else ""
+    if portArg.lower() == "pty":
+        ser = common.PtyPort()
+        print(common.bcolors.COL_GREEN+"Pseudo terminal ready: " + ser.slave_name+common.bcolors.END_COL)
+    elif portArg != "":
+        if serial is None:
+            print(common.bcolors.COL_RED+"pyserial is not installed, use pty"+common.bcolors.END_COL)
+            return
+        print(common.bcolors.COL_GREEN+"Open port " + portArg+common.bcolors.END_COL)
+        ser = serial.Serial(portArg, 115200, timeout=1)
+    else:
+        ser = openDetectedPort()
+        if ser is None:
+            exit(0)
     print(common.bcolors.COL_GREEN+"Now Simulating: " + fw_name + common.bcolors.END_COL)
     starttime = common.current_milli_time()
+    nbLines = 0
     # loop forever, just unplug the port to stop the program or do ctrl-c
     buffer = bytearray()
+    # Marlin can receive MeatPack packed G-code
+    decoder = meatpack.Decoder() if fw_name == "marlin" else None
+    nbBytes = 0
     while True:
         try:
             if ser.in_waiting:
@@ -74,8 +104,24 @@ def main():
                 if not char:  # Timeout
                     continue
                     
+                nbBytes += 1
+                if decoder:
+                    data, report = decoder.feed(char[0])
+                    if report:
+                        common.send_echo(ser, report)
+                    for c in data:
+                        buffer.append(c)
+                        if c == ord('\n'):
+                            line = buffer.decode('utf-8').strip()
+                            print(common.bcolors.COL_BLUE + line + common.bcolors.END_COL)
+                            nbLines += 1
+                            if len(line) > 0 and not line.startswith("["):
+                                response = fw.processLine(line, ser)
+                                if response:
+                                    common.send_echo(ser, response)
+                            buffer.clear()
                 # Vérifier si c'est une commande temps réel
-                if isRealTimeCommand(char[0]) and (fw_name == "grbl" or fw_name == "grblhal"):
+                elif isRealTimeCommand(char[0]) and (fw_name == "grbl" or fw_name == "grblhal"):
                     # Traiter immédiatement la commande temps réel
                     cmd = char.decode('utf-8', errors='replace')
                     print(common.bcolors.COL_BLUE + f"RealTime command: {cmd}" + common.bcolors.END_COL)
@@ -89,6 +135,7 @@ def main():
                     if char == b'\n':
                         line = buffer.decode('utf-8').strip()
                         print(common.bcolors.COL_BLUE + line + common.bcolors.END_COL)
+                        nbLines += 1
                         if not line.startswith("["):
                             response = fw.processLine(line, ser)
                             if response:
@@ -96,6 +143,10 @@ def main():
                         buffer.clear()
                         
         except KeyboardInterrupt:
+            duration = (common.current_milli_time() - starttime) / 1000
+            if duration > 0:
+                print(common.bcolors.COL_GREEN + "{} lines in {:.1f}s: {:.1f} lines/s, {} bytes received".format(
+                    nbLines, duration, nbLines / duration, nbBytes) + common.bcolors.END_COL)
             break
         except Exception as e:
             print(f"Error: {e}")
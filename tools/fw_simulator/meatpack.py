@@ -0,0 +1,111 @@
+#!/usr/bin/python
+# MeatPack packing / unpacking, same algorithm as Marlin feature/meatpack
+# and ESP3D modules/meatpack
+
+SIGNAL_BYTE = 0xFF
+ENABLE_PACKING = 0xFB
+DISABLE_PACKING = 0xFA
+RESET_ALL = 0xF9
+QUERY_CONFIG = 0xF8
+NOT_PACKED = 0x0F
+
+# 4 bits code of the 15 most used G-code characters
+PACKED_CHARS = "0123456789. \nGX"
+
+
+def packedCode(c):
+    p = PACKED_CHARS.find(chr(c))
+    return p if p != -1 else NOT_PACKED
+
+
+class Encoder:
+    def __init__(self):
+        self.pending = -1
+
+    def packPair(self, first, second):
+        firstCode = packedCode(first)
+        secondCode = packedCode(second)
+        out = bytearray([firstCode | (secondCode << 4)])
+        if firstCode == NOT_PACKED:
+            out.append(first)
+        if secondCode == NOT_PACKED:
+            out.append(second)
+        return out
+
+    def pack(self, data):
+        out = bytearray()
+        for c in data:
+            if self.pending != -1:
+                out += self.packPair(self.pending, c)
+                self.pending = -1
+            elif c == ord('\n'):
+                # decoder ignores the character after an end of line
+                out += self.packPair(c, c)
+            else:
+                self.pending = c
+        return bytes(out)
+
+
+class Decoder:
+    def __init__(self):
+        self.active = False
+        self.signalCount = 0
+        self.commandIsNext = False
+        self.literalCount = 0
+        self.secondChar = None
+
+    def report(self):
+        return "[MP] PV01 " + ("ON" if self.active else "OFF") + " ESP"
+
+    # Feed one byte from host, return (decoded bytes, state report or None)
+    def feed(self, c):
+        if c == SIGNAL_BYTE:
+            if self.signalCount:
+                self.commandIsNext = True
+                self.signalCount = 0
+            else:
+                self.signalCount = 1
+            return b"", None
+        if self.commandIsNext:
+            self.commandIsNext = False
+            if c == ENABLE_PACKING:
+                self.active = True
+            elif c == DISABLE_PACKING or c == RESET_ALL:
+                self.active = False
+            return b"", self.report()
+        out = bytearray()
+        if self.signalCount:
+            # a single signal byte is a pair of full characters
+            self.signalCount = 0
+            out += self.unpack(SIGNAL_BYTE)
+        out += self.unpack(c)
+        return bytes(out), None
+
+    def unpack(self, c):
+        if not self.active:
+            return bytes([c])
+        out = bytearray()
+        if self.literalCount:
+            out.append(c)
+            if self.secondChar is not None:
+                out.append(self.secondChar)
+                self.secondChar = None
+            self.literalCount -= 1
+            return bytes(out)
+        firstCode = c & 0x0F
+        secondCode = (c >> 4) & 0x0F
+        if firstCode == NOT_PACKED:
+            self.literalCount += 1
+            if secondCode == NOT_PACKED:
+                self.literalCount += 1
+            else:
+                self.secondChar = ord(PACKED_CHARS[secondCode])
+        else:
+            first = ord(PACKED_CHARS[firstCode])
+            out.append(first)
+            if first != ord('\n'):
+                if secondCode == NOT_PACKED:
+                    self.literalCount += 1
+                else:
+                    out.append(ord(PACKED_CHARS[secondCode]))
+        return bytes(out)
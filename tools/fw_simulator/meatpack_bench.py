@@ -0,0 +1,99 @@
+#!/usr/bin/python
+# Compare bytes on wire and lines/s of plain and MeatPack G-code
+# Usage: meatpack_bench.py [file.gcode] [baudrate]
+import contextlib
+import io
+import math
+import sys
+import time
+import esp3d_common as common
+import marlin
+import meatpack
+
+
+# Serial stub for marlin.processLine, answers are dropped
+class NullPort:
+    in_waiting = 0
+
+    def write(self, data):
+        return len(data)
+
+    def flush(self):
+        pass
+
+    def readline(self):
+        return b""
+
+
+# Dense curved print: small segments along circles, like sliced arcs
+def generateGcode(nbLines):
+    lines = ["G28", "G90", "M83"]
+    for i in range(nbLines):
+        angle = i * 2 * math.pi / 360
+        radius = 40 + (i % 720) / 36
+        e = 0.03125 + (i % 7) * 0.00113
+        lines.append("G1 X{:.3f} Y{:.3f} E{:.5f}".format(
+            100 + radius * math.cos(angle), 100 + radius * math.sin(angle), e))
+    return lines
+
+
+# Same cleaning as GcodeHost: no comment, no empty line
+def loadGcode(filename):
+    lines = []
+    with open(filename, "r", errors="replace") as f:
+        for line in f:
+            line = line.split(";")[0].strip()
+            if len(line) > 0:
+                lines.append(line)
+    return lines
+
+
+def main():
+    baudrate = 115200
+    if len(sys.argv) > 1:
+        lines = loadGcode(sys.argv[1])
+        name = sys.argv[1]
+    else:
+        lines = generateGcode(20000)
+        name = "generated arcs"
+    if len(sys.argv) > 2:
+        baudrate = int(sys.argv[2])
+    plain = "".join(line + "\n" for line in lines).encode("utf-8")
+    packed = meatpack.Encoder().pack(plain)
+
+    # Check printer side gets back the same G-code
+    decoder = meatpack.Decoder()
+    decoder.active = True
+    decoded = bytearray()
+    for c in packed:
+        data, report = decoder.feed(c)
+        decoded += data
+    if bytes(decoded) != plain:
+        print(common.bcolors.COL_RED + "Decoded G-code differs from original" +
+              common.bcolors.END_COL)
+        sys.exit(1)
+
+    # 8N1: 10 bits per byte on wire
+    bytesPerSecond = baudrate / 10
+    plainRate = len(lines) / (len(plain) / bytesPerSecond)
+    packedRate = len(lines) / (len(packed) / bytesPerSecond)
+
+    # Firmware simulator speed with decoded lines
+    sample = bytes(decoded).decode("utf-8").splitlines()[:200]
+    port = NullPort()
+    start = time.time()
+    with contextlib.redirect_stdout(io.StringIO()):
+        for line in sample:
+            marlin.processLine(line, port)
+    simRate = len(sample) / (time.time() - start)
+
+    print(common.bcolors.COL_GREEN + "G-code: {} ({} lines)".format(
+        name, len(lines)) + common.bcolors.END_COL)
+    print("Bytes on wire: plain {}, packed {} ({:.1f}%)".format(
+        len(plain), len(packed), 100.0 * len(packed) / len(plain)))
+    print("Wire limit at {} bauds: plain {:.1f} lines/s, packed {:.1f} lines/s".format(
+        baudrate, plainRate, packedRate))
+    print("marlin.py simulator: {:.1f} lines/s".format(simRate))
+
+
+main()
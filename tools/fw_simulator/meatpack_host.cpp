@@ -0,0 +1,101 @@
+// Host driver for esp3d/src/modules/meatpack/meatpack.cpp
+// Usage: meatpack_host pack <chunk> <loops> < input > packed
+//        meatpack_host stream <chunk> < input > serial bytes
+// pack: only ESP3DMeatPack::pack(), input is split in chunks of <chunk> bytes
+// stream: negotiation, write() and end() as GcodeHost does, output is all
+// bytes sent to the serial stub
+// Packing speed (MB/s) goes to stderr
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "meatpack.h"
+#include "serial_service.h"
+
+static uint32_t now = 0;
+uint32_t millis() { return now; }
+
+SerialStub esp3d_serial_service;
+
+size_t SerialStub::writeBytes(const uint8_t* data, size_t size) {
+  return fwrite(data, 1, size, stdout);
+}
+
+static void parse(ESP3DMeatPack& meatpack, const char* answer) {
+  meatpack.parse((const uint8_t*)answer, strlen(answer));
+}
+
+static int stream(const std::vector<uint8_t>& data, size_t chunk) {
+  ESP3DMeatPack meatpack;
+  if (!meatpack.begin() ||
+      meatpack.state() != ESP3DMeatPackState::probing) {
+    fprintf(stderr, "begin failed\n");
+    return 1;
+  }
+  // printer answers to reset and query, then to enable
+  parse(meatpack, "[MP] PV01 OFF\n");
+  if (meatpack.state() != ESP3DMeatPackState::enabling) {
+    fprintf(stderr, "enable not sent\n");
+    return 1;
+  }
+  parse(meatpack, "[MP] PV01 ON\n");
+  if (!meatpack.isActive()) {
+    fprintf(stderr, "packing not active\n");
+    return 1;
+  }
+  for (size_t pos = 0; pos < data.size(); pos += chunk) {
+    size_t len = data.size() - pos > chunk ? chunk : data.size() - pos;
+    if (meatpack.write(&data[pos], len) != len) {
+      fprintf(stderr, "write failed\n");
+      return 1;
+    }
+  }
+  meatpack.end();
+  return meatpack.state() == ESP3DMeatPackState::off ? 0 : 1;
+}
+
+static int pack(const std::vector<uint8_t>& data, size_t chunk, int loops) {
+  std::vector<uint8_t> out(chunk * 3 / 2 + 2);
+  ESP3DMeatPack meatpack;
+  for (size_t pos = 0; pos < data.size(); pos += chunk) {
+    size_t len = data.size() - pos > chunk ? chunk : data.size() - pos;
+    fwrite(out.data(), 1, meatpack.pack(&data[pos], len, out.data()), stdout);
+  }
+  auto start = std::chrono::steady_clock::now();
+  size_t total = 0;
+  for (int i = 0; i < loops; i++) {
+    for (size_t pos = 0; pos < data.size(); pos += chunk) {
+      size_t len = data.size() - pos > chunk ? chunk : data.size() - pos;
+      total += meatpack.pack(&data[pos], len, out.data());
+    }
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  fprintf(stderr, "%.1f\n",
+          seconds > 0 ? (data.size() * loops) / seconds / 1e6 : 0);
+  return total > 0 || loops == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: meatpack_host pack|stream <chunk> [loops]\n");
+    return 1;
+  }
+  size_t chunk = (size_t)atoi(argv[2]);
+  int loops = argc > 3 ? atoi(argv[3]) : 0;
+  if (chunk == 0) {
+    return 1;
+  }
+  std::vector<uint8_t> data;
+  int c;
+  while ((c = getchar()) != EOF) {
+    data.push_back((uint8_t)c);
+  }
+  if (strcmp(argv[1], "stream") == 0) {
+    return stream(data, chunk);
+  }
+  return pack(data, chunk, loops);
+}
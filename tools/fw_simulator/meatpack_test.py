@@ -0,0 +1,152 @@
+#!/usr/bin/python
+# Check MeatPack packing of ESP3D on host against meatpack.py, which follows
+# Marlin feature/meatpack decoder
+# Packed bytes must be the same as meatpack.Encoder for any chunk size, and
+# the serial stream (negotiation, packed G-code, end) must decode to the
+# original G-code, bytes saved and packing speed are reported
+# Usage: meatpack_test.py [file ...]  (default: ../gcode_minifier/corpus/*)
+import glob
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import meatpack
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+SOURCES = os.path.join(ROOT, "..", "..", "esp3d", "src", "modules", "meatpack")
+
+PACK_CHUNKS = [1, 2, 7, 64, 4096]
+STREAM_CHUNKS = [1, 7, 63, 4096]
+
+# meatpack.cpp only needs these from ESP3D
+STUBS = {
+    os.path.join("include", "esp3d_config.h"): """#pragma once
+#define MEATPACK_FEATURE
+#define MARLIN 20
+#define esp3d_log(format, ...)
+#define esp3d_log_e(format, ...)
+""",
+    os.path.join("core", "esp3d_settings.h"): """#pragma once
+#include <Arduino.h>
+class ESP3DSettings {
+ public:
+  static uint8_t GetFirmwareTarget() { return MARLIN; }
+};
+""",
+    os.path.join("modules", "serial", "serial_service.h"): """#pragma once
+#include <Arduino.h>
+class SerialStub {
+ public:
+  size_t writeBytes(const uint8_t* data, size_t size);
+};
+extern SerialStub esp3d_serial_service;
+""",
+    os.path.join("arduino", "Arduino.h"): """#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+uint32_t millis();
+""",
+}
+
+
+def build(tmp):
+    src = os.path.join(tmp, "src", "modules", "meatpack")
+    os.makedirs(src)
+    for name, content in STUBS.items():
+        path = os.path.join(tmp, "src", name)
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        with open(path, "w") as f:
+            f.write(content)
+    for name in ["meatpack.h", "meatpack.cpp"]:
+        shutil.copy(os.path.join(SOURCES, name), src)
+    exe = os.path.join(tmp, "meatpack_host")
+    cxx = os.environ.get("CXX", "g++")
+    subprocess.check_call([cxx, "-O2", "-std=c++11", "-Wall",
+                           "-I", src,
+                           "-I", os.path.join(tmp, "src", "arduino"),
+                           "-I", os.path.join(tmp, "src", "modules", "serial"),
+                           os.path.join(ROOT, "meatpack_host.cpp"),
+                           os.path.join(src, "meatpack.cpp"), "-o", exe])
+    return exe
+
+
+# Same cleaning as GcodeHost: no comment, no empty line
+def loadGcode(filename):
+    lines = []
+    with open(filename, "r", errors="replace") as f:
+        for line in f:
+            line = line.split(";")[0].strip()
+            if len(line) > 0:
+                lines.append(line)
+    return lines
+
+
+def decode(data):
+    decoder = meatpack.Decoder()
+    out = bytearray()
+    reports = []
+    for c in data:
+        decoded, report = decoder.feed(c)
+        out += decoded
+        if report:
+            reports.append(report)
+    return bytes(out), reports, decoder.active
+
+
+def check(exe, filename):
+    lines = loadGcode(filename)
+    data = ("\n".join(lines) + "\n").encode("utf-8")
+    expected = meatpack.Encoder().pack(data)
+    errors = 0
+    speed = 0
+    for chunk in PACK_CHUNKS:
+        out = subprocess.run([exe, "pack", str(chunk), "200" if chunk == 4096 else "0"],
+                             input=data, capture_output=True, check=True)
+        if chunk == 4096:
+            speed = float(out.stderr.decode().strip())
+        if out.stdout != expected:
+            errors += 1
+            size = min(len(out.stdout), len(expected))
+            first = next((i for i in range(size) if out.stdout[i] != expected[i]), size)
+            print("  pack chunk {}: differs from meatpack.py at byte {}".format(
+                chunk, first))
+    for chunk in STREAM_CHUNKS:
+        out = subprocess.run([exe, "stream", str(chunk)], input=data,
+                             capture_output=True)
+        if out.returncode != 0:
+            errors += 1
+            print("  stream chunk {}: {}".format(chunk, out.stderr.decode().strip()))
+            continue
+        decoded, reports, active = decode(out.stdout)
+        got = [l for l in decoded.decode("utf-8", errors="replace").split("\n") if len(l) > 0]
+        # reset, query, enable and disable are all answered
+        if got != lines or len(reports) != 4 or active:
+            errors += 1
+            print("  stream chunk {}: {} lines decoded of {}, {} reports, {}".format(
+                chunk, len(got), len(lines), len(reports),
+                "still packing" if active else "packing off"))
+    saved = len(data) - len(expected)
+    print("  {:>7} -> {:>7} bytes, {:5.1f}% saved, {:.1f} MB/s, {}".format(
+        len(data), len(expected), 100.0 * saved / len(data) if data else 0,
+        speed, "OK" if errors == 0 else "{} errors".format(errors)))
+    return errors == 0
+
+
+def main():
+    files = sys.argv[1:] or sorted(glob.glob(
+        os.path.join(ROOT, "..", "gcode_minifier", "corpus", "*")))
+    tmp = tempfile.mkdtemp()
+    try:
+        exe = build(tmp)
+        success = True
+        for filename in files:
+            print(os.path.basename(filename))
+            success = check(exe, filename) and success
+    finally:
+        shutil.rmtree(tmp)
+    sys.exit(0 if success else 1)
+
+
+main()
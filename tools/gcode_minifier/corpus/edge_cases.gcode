@@ -0,0 +1,32 @@
+G1 X10.000 Y-0.000 Z+5
+G01 X007.50 Y.5 E-00.0100
+G1	X1.	Y-.0
+  G1 X1 ; trailing comment  
+; full line comment
+
+G1 X
+G28 X Y
+M117 Hello  World 0.500
+M23 FILE~1.GCO
+M118 E1 Temp 00.10
+N10 G1 X10.000*91
+M550 P"my printer"
+$J=G91 X10.000 F100
+g1 x1.500 y2.000
+G1 X1 (inline paren) Y2
+G1 X1 (unclosed
+T0
+M104 T1 S200.0
+G4 P500
+G1 X5 G90
+G1 X1
+G1 X2
+M400
+G1 X3
+G10 P0
+G1 X4
+G1
+G0 X1
+G0 X2
+G1 F1500
+G1 X-0.10 Y0.0 E0
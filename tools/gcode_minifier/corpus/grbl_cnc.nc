@@ -0,0 +1,225 @@
+%
+(Job: pocket corpus)
+(Tool: 3mm flat end mill)
+G21 G90 G94
+G17
+M3 S12000
+G0 Z5.0000
+G0 X0.0000 Y0.0000
+G1 Z-1.0000 F300.0
+G1 X20.0000 Y0.0000 F800.0000 (pass 0)
+G1 X20.0401 Y0.6298
+G1 X20.0603 Y1.2621
+G1 X20.0606 Y1.8963
+G1 X20.0407 Y2.5317
+G1 X20.0007 Y3.1678
+G1 X19.9404 Y3.8038
+G1 X19.8599 Y4.4392
+G1 X19.7591 Y5.0733
+G1 X19.6380 Y5.7054
+G1 X19.4967 Y6.3348
+G1 X19.3351 Y6.9611
+G1 X19.1534 Y7.5834
+G1 X18.9516 Y8.2011
+G1 X18.7299 Y8.8136
+G1 X18.4884 Y9.4203
+G1 X18.2272 Y10.0205
+G1 X17.9465 Y10.6135
+G1 X17.6465 Y11.1988
+G1 X17.3273 Y11.7756
+G1 X16.9894 Y12.3435
+G1 X16.6328 Y12.9017
+G1 X16.2578 Y13.4496
+G1 X15.8648 Y13.9867
+G1 X15.4541 Y14.5124
+G1 X15.0260 Y15.0260 F800.0000 (pass 25)
+G1 X14.5809 Y15.5270
+G1 X14.1190 Y16.0149
+G1 X13.6409 Y16.4890
+G1 X13.1469 Y16.9488
+G1 X12.6374 Y17.3939
+G1 X12.1129 Y17.8236
+G1 X11.5739 Y18.2375
+G1 X11.0207 Y18.6351
+G1 X10.4541 Y19.0159
+G1 X9.8743 Y19.3794
+G1 X9.2820 Y19.7252
+G1 X8.6777 Y20.0529
+G1 X8.0619 Y20.3621
+G1 X7.4353 Y20.6523
+G1 X6.7984 Y20.9232
+G1 X6.1518 Y21.1745
+G1 X5.4960 Y21.4057
+G1 X4.8319 Y21.6166
+G1 X4.1599 Y21.8068
+G1 X3.4807 Y21.9761
+G1 X2.7949 Y22.1242
+G1 X2.1033 Y22.2508
+G1 X1.4065 Y22.3558
+G1 X0.7052 Y22.4389
+G2 X-4.2948 Y22.4389 I-2.5000 J0.0000
+X-4.2948 Y23.4389
+G1 X0.0000 Y22.5000 F800.0000 (pass 50)
+G1 X-0.7083 Y22.5389
+G1 X-1.4191 Y22.5554
+G1 X-2.1316 Y22.5495
+G1 X-2.8451 Y22.5210
+G1 X-3.5589 Y22.4699
+G1 X-4.2723 Y22.3961
+G1 X-4.9846 Y22.2997
+G1 X-5.6950 Y22.1806
+G1 X-6.4028 Y22.0387
+G1 X-7.1074 Y21.8743
+G1 X-7.8079 Y21.6873
+G1 X-8.5037 Y21.4778
+G1 X-9.1940 Y21.2460
+G1 X-9.8781 Y20.9920
+G1 X-10.5553 Y20.7159
+G1 X-11.2249 Y20.4179
+G1 X-11.8861 Y20.0983
+G1 X-12.5383 Y19.7573
+G1 X-13.1809 Y19.3950
+G1 X-13.8130 Y19.0119
+G1 X-14.4340 Y18.6082
+G1 X-15.0432 Y18.1841
+G1 X-15.6400 Y17.7401
+G1 X-16.2238 Y17.2766
+G1 X-16.7938 Y16.7938 F800.0000 (pass 75)
+G1 X-17.3495 Y16.2922
+G1 X-17.8901 Y15.7723
+G1 X-18.4153 Y15.2344
+G1 X-18.9242 Y14.6791
+G1 X-19.4164 Y14.1068
+G1 X-19.8913 Y13.5181
+G1 X-20.3483 Y12.9134
+G1 X-20.7869 Y12.2934
+G1 X-21.2066 Y11.6584
+G1 X-21.6069 Y11.0093
+G1 X-21.9873 Y10.3464
+G1 X-22.3473 Y9.6706
+G1 X-22.6865 Y8.9822
+G1 X-23.0045 Y8.2821
+G1 X-23.3009 Y7.5709
+G1 X-23.5752 Y6.8492
+G1 X-23.8271 Y6.1178
+G1 X-24.0563 Y5.3772
+G1 X-24.2625 Y4.6283
+G1 X-24.4453 Y3.8718
+G1 X-24.6044 Y3.1083
+G1 X-24.7397 Y2.3386
+G1 X-24.8509 Y1.5635
+G1 X-24.9377 Y0.7837
+G2 X-29.9377 Y0.7837 I-2.5000 J0.0000
+X-29.9377 Y1.7837
+G1 X-25.0000 Y0.0000 F800.0000 (pass 100)
+G1 X-25.0376 Y-0.7868
+G1 X-25.0505 Y-1.5760
+G1 X-25.0384 Y-2.3668
+G1 X-25.0013 Y-3.1584
+G1 X-24.9391 Y-3.9500
+G1 X-24.8519 Y-4.7407
+G1 X-24.7395 Y-5.5299
+G1 X-24.6020 Y-6.3167
+G1 X-24.4395 Y-7.1003
+G1 X-24.2519 Y-7.8799
+G1 X-24.0395 Y-8.6548
+G1 X-23.8023 Y-9.4240
+G1 X-23.5404 Y-10.1868
+G1 X-23.2541 Y-10.9425
+G1 X-22.9434 Y-11.6903
+G1 X-22.6087 Y-12.4292
+G1 X-22.2502 Y-13.1587
+G1 X-21.8681 Y-13.8779
+G1 X-21.4627 Y-14.5861
+G1 X-21.0344 Y-15.2824
+G1 X-20.5835 Y-15.9662
+G1 X-20.1104 Y-16.6368
+G1 X-19.6154 Y-17.2933
+G1 X-19.0990 Y-17.9351
+G1 X-18.5616 Y-18.5616 F800.0000 (pass 125)
+G1 X-18.0036 Y-19.1719
+G1 X-17.4256 Y-19.7654
+G1 X-16.8280 Y-20.3415
+G1 X-16.2114 Y-20.8996
+G1 X-15.5763 Y-21.4390
+G1 X-14.9233 Y-21.9590
+G1 X-14.2530 Y-22.4591
+G1 X-13.5660 Y-22.9388
+G1 X-12.8628 Y-23.3974
+G1 X-12.1442 Y-23.8344
+G1 X-11.4109 Y-24.2494
+G1 X-10.6634 Y-24.6417
+G1 X-9.9026 Y-25.0110
+G1 X-9.1290 Y-25.3567
+G1 X-8.3435 Y-25.6785
+G1 X-7.5467 Y-25.9759
+G1 X-6.7395 Y-26.2486
+G1 X-5.9226 Y-26.4961
+G1 X-5.0968 Y-26.7182
+G1 X-4.2628 Y-26.9145
+G1 X-3.4216 Y-27.0847
+G1 X-2.5739 Y-27.2286
+G1 X-1.7205 Y-27.3459
+G1 X-0.8622 Y-27.4365
+G2 X-5.8622 Y-27.4365 I-2.5000 J0.0000
+X-5.8622 Y-26.4365
+G1 X-0.0000 Y-27.5000 F800.0000 (pass 150)
+G1 X0.8654 Y-27.5364
+G1 X1.7330 Y-27.5455
+G1 X2.6021 Y-27.5273
+G1 X3.4717 Y-27.4816
+G1 X4.3411 Y-27.4084
+G1 X5.2092 Y-27.3076
+G1 X6.0753 Y-27.1793
+G1 X6.9384 Y-27.0235
+G1 X7.7978 Y-26.8402
+G1 X8.6525 Y-26.6296
+G1 X9.5016 Y-26.3917
+G1 X10.3443 Y-26.1267
+G1 X11.1797 Y-25.8348
+G1 X12.0070 Y-25.5161
+G1 X12.8252 Y-25.1709
+G1 X13.6336 Y-24.7995
+G1 X14.4313 Y-24.4020
+G1 X15.2175 Y-23.9789
+G1 X15.9913 Y-23.5304
+G1 X16.7519 Y-23.0570
+G1 X17.4985 Y-22.5589
+G1 X18.2303 Y-22.0367
+G1 X18.9466 Y-21.4907
+G1 X19.6465 Y-20.9214
+G1 X20.3293 Y-20.3293 F800.0000 (pass 175)
+G1 X20.9943 Y-19.7150
+G1 X21.6407 Y-19.0788
+G1 X22.2678 Y-18.4216
+G1 X22.8750 Y-17.7437
+G1 X23.4615 Y-17.0458
+G1 X24.0267 Y-16.3285
+G1 X24.5699 Y-15.5926
+G1 X25.0906 Y-14.8386
+G1 X25.5882 Y-14.0672
+G1 X26.0619 Y-13.2792
+G1 X26.5114 Y-12.4753
+G1 X26.9361 Y-11.6563
+G1 X27.3354 Y-10.8229
+G1 X27.7089 Y-9.9758
+G1 X28.0562 Y-9.1160
+G1 X28.3767 Y-8.2442
+G1 X28.6701 Y-7.3612
+G1 X28.9359 Y-6.4679
+G1 X29.1739 Y-5.5652
+G1 X29.3837 Y-4.6539
+G1 X29.5650 Y-3.7349
+G1 X29.7175 Y-2.8091
+G1 X29.8410 Y-1.8774
+G1 X29.9352 Y-0.9408
+G2 X24.9352 Y-0.9408 I-2.5000 J0.0000
+X24.9352 Y0.0592
+G0 Z5.0000
+$H
+G38.2 Z-10 F100
+G10 L20 P1 Z0
+M5
+G0 X0 Y0
+M30
+%
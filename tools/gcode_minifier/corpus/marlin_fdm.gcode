@@ -0,0 +1,783 @@
+;FLAVOR:Marlin
+;Generated for corpus
+M140 S60
+M105
+M190 S60
+M104 S210
+M109 S210
+M82 ;absolute extrusion mode
+G28 ;Home
+G92 E0
+G1 Z2.0 F3000 ;Move Z Axis up
+G1 X10.1 Y20 Z0.28 F5000.0 ;Move to start position
+G1 X10.1 Y200.0 Z0.28 F1500.0 E15 ;Draw the first line
+G92 E0
+M117 Printing corpus...
+M106 S255
+;LAYER:0
+G0 F6000 X80.000 Y80.000 Z0.200
+;LAYER:0
+G0 X130.000 Y100.000 Z0.200
+G1 X130.000 Y100.000 E0.05341
+G1 X130.113 Y101.578 E0.10681
+G1 X130.128 Y103.167 E0.16022
+G1 X130.030 Y104.756 E0.21363
+G1 X129.810 Y106.336 E0.26704
+G1 X129.461 Y107.894 E0.32044
+G1 X128.984 Y109.417 E0.37385
+G1 X128.385 Y110.896 E0.42726
+G1 X127.675 Y112.322 E0.48066
+G1 X126.868 Y113.690 E0.53407
+G1 X125.981 Y115.000 E0.58748
+G1 X125.031 Y116.255 E0.64088
+G1 X124.033 Y117.461 E0.69429
+G1 X123.000 Y118.625 E0.74770
+G1 X121.941 Y119.756 E0.80111
+G1 X120.860 Y120.860 E0.85451
+G1 X119.756 Y121.941 E0.90792
+G1 X118.625 Y123.000 E0.96133
+G1 X117.461 Y124.033 E1.01473
+G1 X116.255 Y125.031 E1.06814
+G1 X115.000 Y125.981 E1.12155
+G1 X113.690 Y126.868 E1.17495
+G1 X112.322 Y127.675 E1.22836
+G1 X110.896 Y128.385 E1.28177
+G1 X109.417 Y128.984 E1.33518
+G1 X107.894 Y129.461 E1.38858
+G1 X106.336 Y129.810 E1.44199
+G1 X104.756 Y130.030 E1.49540
+G1 X103.167 Y130.128 E1.54880
+G1 X101.578 Y130.113 E1.60221
+G1 X100.000 Y130.000 E1.65562
+G1 X98.438 Y129.805 E1.70902
+G1 X96.895 Y129.543 E1.76243
+G1 X95.370 Y129.231 E1.81584
+G1 X93.862 Y128.879 E1.86925
+G1 X92.365 Y128.495 E1.92265
+G1 X90.876 Y128.079 E1.97606
+G1 X89.394 Y127.630 E2.02947
+G1 X87.917 Y127.138 E2.08287
+G1 X86.450 Y126.593 E2.13628
+G1 X85.000 Y125.981 E2.18969
+G1 X83.577 Y125.290 E2.24310
+G1 X82.194 Y124.508 E2.29650
+G1 X80.866 Y123.629 E2.34991
+G1 X79.608 Y122.648 E2.40332
+G1 X78.433 Y121.567 E2.45672
+G1 X77.352 Y120.392 E2.51013
+G1 X76.371 Y119.134 E2.56354
+G1 X75.492 Y117.806 E2.61694
+G1 X74.710 Y116.423 E2.67035
+G1 X74.019 Y115.000 E2.72376
+G1 X73.407 Y113.550 E2.77717
+G1 X72.862 Y112.083 E2.83057
+G1 X72.370 Y110.606 E2.88398
+G1 X71.921 Y109.124 E2.93739
+G1 X71.505 Y107.635 E2.99079
+G1 X71.121 Y106.138 E3.04420
+G1 X70.769 Y104.630 E3.09761
+G1 X70.457 Y103.105 E3.15101
+G1 X70.195 Y101.562 E3.20442
+G1 X70.000 Y100.000 E3.25783
+G1 X69.887 Y98.422 E3.31124
+G1 X69.872 Y96.833 E3.36464
+G1 X69.970 Y95.244 E3.41805
+G1 X70.190 Y93.664 E3.47146
+G1 X70.539 Y92.106 E3.52486
+G1 X71.016 Y90.583 E3.57827
+G1 X71.615 Y89.104 E3.63168
+G1 X72.325 Y87.678 E3.68509
+G1 X73.132 Y86.310 E3.73849
+G1 X74.019 Y85.000 E3.79190
+G1 X74.969 Y83.745 E3.84531
+G1 X75.967 Y82.539 E3.89871
+G1 X77.000 Y81.375 E3.95212
+G1 X78.059 Y80.244 E4.00553
+G1 X79.140 Y79.140 E4.05893
+G1 X80.244 Y78.059 E4.11234
+G1 X81.375 Y77.000 E4.16575
+G1 X82.539 Y75.967 E4.21916
+G1 X83.745 Y74.969 E4.27256
+G1 X85.000 Y74.019 E4.32597
+G1 X86.310 Y73.132 E4.37938
+G1 X87.678 Y72.325 E4.43278
+G1 X89.104 Y71.615 E4.48619
+G1 X90.583 Y71.016 E4.53960
+G1 X92.106 Y70.539 E4.59300
+G1 X93.664 Y70.190 E4.64641
+G1 X95.244 Y69.970 E4.69982
+G1 X96.833 Y69.872 E4.75323
+G1 X98.422 Y69.887 E4.80663
+G1 X100.000 Y70.000 E4.86004
+G1 X101.562 Y70.195 E4.91345
+G1 X103.105 Y70.457 E4.96685
+G1 X104.630 Y70.769 E5.02026
+G1 X106.138 Y71.121 E5.07367
+G1 X107.635 Y71.505 E5.12707
+G1 X109.124 Y71.921 E5.18048
+G1 X110.606 Y72.370 E5.23389
+G1 X112.083 Y72.862 E5.28730
+G1 X113.550 Y73.407 E5.34070
+G1 X115.000 Y74.019 E5.39411
+G1 X116.423 Y74.710 E5.44752
+G1 X117.806 Y75.492 E5.50092
+G1 X119.134 Y76.371 E5.55433
+G1 X120.392 Y77.352 E5.60774
+G1 X121.567 Y78.433 E5.66115
+G1 X122.648 Y79.608 E5.71455
+G1 X123.629 Y80.866 E5.76796
+G1 X124.508 Y82.194 E5.82137
+G1 X125.290 Y83.577 E5.87477
+G1 X125.981 Y85.000 E5.92818
+G1 X126.593 Y86.450 E5.98159
+G1 X127.138 Y87.917 E6.03499
+G1 X127.630 Y89.394 E6.08840
+G1 X128.079 Y90.876 E6.14181
+G1 X128.495 Y92.365 E6.19522
+G1 X128.879 Y93.862 E6.24862
+G1 X129.231 Y95.370 E6.30203
+G1 X129.543 Y96.895 E6.35544
+G1 X129.805 Y98.438 E6.40884
+G1 X130.000 Y100.000 E6.46225
+G1 F2700 E1.46225
+G0 F9000 X120.500 Y95.250
+G1 F2700 E6.46225
+;LAYER:1
+G0 X130.000 Y100.000 Z0.400
+G1 X130.000 Y100.000 E6.51566
+G1 X130.113 Y101.578 E6.56906
+G1 X130.128 Y103.167 E6.62247
+G1 X130.030 Y104.756 E6.67588
+G1 X129.810 Y106.336 E6.72929
+G1 X129.461 Y107.894 E6.78269
+G1 X128.984 Y109.417 E6.83610
+G1 X128.385 Y110.896 E6.88951
+G1 X127.675 Y112.322 E6.94291
+G1 X126.868 Y113.690 E6.99632
+G1 X125.981 Y115.000 E7.04973
+G1 X125.031 Y116.255 E7.10313
+G1 X124.033 Y117.461 E7.15654
+G1 X123.000 Y118.625 E7.20995
+G1 X121.941 Y119.756 E7.26336
+G1 X120.860 Y120.860 E7.31676
+G1 X119.756 Y121.941 E7.37017
+G1 X118.625 Y123.000 E7.42358
+G1 X117.461 Y124.033 E7.47698
+G1 X116.255 Y125.031 E7.53039
+G1 X115.000 Y125.981 E7.58380
+G1 X113.690 Y126.868 E7.63721
+G1 X112.322 Y127.675 E7.69061
+G1 X110.896 Y128.385 E7.74402
+G1 X109.417 Y128.984 E7.79743
+G1 X107.894 Y129.461 E7.85083
+G1 X106.336 Y129.810 E7.90424
+G1 X104.756 Y130.030 E7.95765
+G1 X103.167 Y130.128 E8.01105
+G1 X101.578 Y130.113 E8.06446
+G1 X100.000 Y130.000 E8.11787
+G1 X98.438 Y129.805 E8.17128
+G1 X96.895 Y129.543 E8.22468
+G1 X95.370 Y129.231 E8.27809
+G1 X93.862 Y128.879 E8.33150
+G1 X92.365 Y128.495 E8.38490
+G1 X90.876 Y128.079 E8.43831
+G1 X89.394 Y127.630 E8.49172
+G1 X87.917 Y127.138 E8.54512
+G1 X86.450 Y126.593 E8.59853
+G1 X85.000 Y125.981 E8.65194
+G1 X83.577 Y125.290 E8.70535
+G1 X82.194 Y124.508 E8.75875
+G1 X80.866 Y123.629 E8.81216
+G1 X79.608 Y122.648 E8.86557
+G1 X78.433 Y121.567 E8.91897
+G1 X77.352 Y120.392 E8.97238
+G1 X76.371 Y119.134 E9.02579
+G1 X75.492 Y117.806 E9.07920
+G1 X74.710 Y116.423 E9.13260
+G1 X74.019 Y115.000 E9.18601
+G1 X73.407 Y113.550 E9.23942
+G1 X72.862 Y112.083 E9.29282
+G1 X72.370 Y110.606 E9.34623
+G1 X71.921 Y109.124 E9.39964
+G1 X71.505 Y107.635 E9.45304
+G1 X71.121 Y106.138 E9.50645
+G1 X70.769 Y104.630 E9.55986
+G1 X70.457 Y103.105 E9.61327
+G1 X70.195 Y101.562 E9.66667
+G1 X70.000 Y100.000 E9.72008
+G1 X69.887 Y98.422 E9.77349
+G1 X69.872 Y96.833 E9.82689
+G1 X69.970 Y95.244 E9.88030
+G1 X70.190 Y93.664 E9.93371
+G1 X70.539 Y92.106 E9.98711
+G1 X71.016 Y90.583 E10.04052
+G1 X71.615 Y89.104 E10.09393
+G1 X72.325 Y87.678 E10.14734
+G1 X73.132 Y86.310 E10.20074
+G1 X74.019 Y85.000 E10.25415
+G1 X74.969 Y83.745 E10.30756
+G1 X75.967 Y82.539 E10.36096
+G1 X77.000 Y81.375 E10.41437
+G1 X78.059 Y80.244 E10.46778
+G1 X79.140 Y79.140 E10.52118
+G1 X80.244 Y78.059 E10.57459
+G1 X81.375 Y77.000 E10.62800
+G1 X82.539 Y75.967 E10.68141
+G1 X83.745 Y74.969 E10.73481
+G1 X85.000 Y74.019 E10.78822
+G1 X86.310 Y73.132 E10.84163
+G1 X87.678 Y72.325 E10.89503
+G1 X89.104 Y71.615 E10.94844
+G1 X90.583 Y71.016 E11.00185
+G1 X92.106 Y70.539 E11.05526
+G1 X93.664 Y70.190 E11.10866
+G1 X95.244 Y69.970 E11.16207
+G1 X96.833 Y69.872 E11.21548
+G1 X98.422 Y69.887 E11.26888
+G1 X100.000 Y70.000 E11.32229
+G1 X101.562 Y70.195 E11.37570
+G1 X103.105 Y70.457 E11.42910
+G1 X104.630 Y70.769 E11.48251
+G1 X106.138 Y71.121 E11.53592
+G1 X107.635 Y71.505 E11.58933
+G1 X109.124 Y71.921 E11.64273
+G1 X110.606 Y72.370 E11.69614
+G1 X112.083 Y72.862 E11.74955
+G1 X113.550 Y73.407 E11.80295
+G1 X115.000 Y74.019 E11.85636
+G1 X116.423 Y74.710 E11.90977
+G1 X117.806 Y75.492 E11.96317
+G1 X119.134 Y76.371 E12.01658
+G1 X120.392 Y77.352 E12.06999
+G1 X121.567 Y78.433 E12.12340
+G1 X122.648 Y79.608 E12.17680
+G1 X123.629 Y80.866 E12.23021
+G1 X124.508 Y82.194 E12.28362
+G1 X125.290 Y83.577 E12.33702
+G1 X125.981 Y85.000 E12.39043
+G1 X126.593 Y86.450 E12.44384
+G1 X127.138 Y87.917 E12.49725
+G1 X127.630 Y89.394 E12.55065
+G1 X128.079 Y90.876 E12.60406
+G1 X128.495 Y92.365 E12.65747
+G1 X128.879 Y93.862 E12.71087
+G1 X129.231 Y95.370 E12.76428
+G1 X129.543 Y96.895 E12.81769
+G1 X129.805 Y98.438 E12.87109
+G1 X130.000 Y100.000 E12.92450
+G1 F2700 E7.92450
+G0 F9000 X120.500 Y95.250
+G1 F2700 E12.92450
+;LAYER:2
+G0 X130.000 Y100.000 Z0.600
+G1 X130.000 Y100.000 E12.97791
+G1 X130.113 Y101.578 E13.03132
+G1 X130.128 Y103.167 E13.08472
+G1 X130.030 Y104.756 E13.13813
+G1 X129.810 Y106.336 E13.19154
+G1 X129.461 Y107.894 E13.24494
+G1 X128.984 Y109.417 E13.29835
+G1 X128.385 Y110.896 E13.35176
+G1 X127.675 Y112.322 E13.40516
+G1 X126.868 Y113.690 E13.45857
+G1 X125.981 Y115.000 E13.51198
+G1 X125.031 Y116.255 E13.56539
+G1 X124.033 Y117.461 E13.61879
+G1 X123.000 Y118.625 E13.67220
+G1 X121.941 Y119.756 E13.72561
+G1 X120.860 Y120.860 E13.77901
+G1 X119.756 Y121.941 E13.83242
+G1 X118.625 Y123.000 E13.88583
+G1 X117.461 Y124.033 E13.93923
+G1 X116.255 Y125.031 E13.99264
+G1 X115.000 Y125.981 E14.04605
+G1 X113.690 Y126.868 E14.09946
+G1 X112.322 Y127.675 E14.15286
+G1 X110.896 Y128.385 E14.20627
+G1 X109.417 Y128.984 E14.25968
+G1 X107.894 Y129.461 E14.31308
+G1 X106.336 Y129.810 E14.36649
+G1 X104.756 Y130.030 E14.41990
+G1 X103.167 Y130.128 E14.47331
+G1 X101.578 Y130.113 E14.52671
+G1 X100.000 Y130.000 E14.58012
+G1 X98.438 Y129.805 E14.63353
+G1 X96.895 Y129.543 E14.68693
+G1 X95.370 Y129.231 E14.74034
+G1 X93.862 Y128.879 E14.79375
+G1 X92.365 Y128.495 E14.84715
+G1 X90.876 Y128.079 E14.90056
+G1 X89.394 Y127.630 E14.95397
+G1 X87.917 Y127.138 E15.00738
+G1 X86.450 Y126.593 E15.06078
+G1 X85.000 Y125.981 E15.11419
+G1 X83.577 Y125.290 E15.16760
+G1 X82.194 Y124.508 E15.22100
+G1 X80.866 Y123.629 E15.27441
+G1 X79.608 Y122.648 E15.32782
+G1 X78.433 Y121.567 E15.38122
+G1 X77.352 Y120.392 E15.43463
+G1 X76.371 Y119.134 E15.48804
+G1 X75.492 Y117.806 E15.54145
+G1 X74.710 Y116.423 E15.59485
+G1 X74.019 Y115.000 E15.64826
+G1 X73.407 Y113.550 E15.70167
+G1 X72.862 Y112.083 E15.75507
+G1 X72.370 Y110.606 E15.80848
+G1 X71.921 Y109.124 E15.86189
+G1 X71.505 Y107.635 E15.91529
+G1 X71.121 Y106.138 E15.96870
+G1 X70.769 Y104.630 E16.02211
+G1 X70.457 Y103.105 E16.07552
+G1 X70.195 Y101.562 E16.12892
+G1 X70.000 Y100.000 E16.18233
+G1 X69.887 Y98.422 E16.23574
+G1 X69.872 Y96.833 E16.28914
+G1 X69.970 Y95.244 E16.34255
+G1 X70.190 Y93.664 E16.39596
+G1 X70.539 Y92.106 E16.44937
+G1 X71.016 Y90.583 E16.50277
+G1 X71.615 Y89.104 E16.55618
+G1 X72.325 Y87.678 E16.60959
+G1 X73.132 Y86.310 E16.66299
+G1 X74.019 Y85.000 E16.71640
+G1 X74.969 Y83.745 E16.76981
+G1 X75.967 Y82.539 E16.82321
+G1 X77.000 Y81.375 E16.87662
+G1 X78.059 Y80.244 E16.93003
+G1 X79.140 Y79.140 E16.98344
+G1 X80.244 Y78.059 E17.03684
+G1 X81.375 Y77.000 E17.09025
+G1 X82.539 Y75.967 E17.14366
+G1 X83.745 Y74.969 E17.19706
+G1 X85.000 Y74.019 E17.25047
+G1 X86.310 Y73.132 E17.30388
+G1 X87.678 Y72.325 E17.35728
+G1 X89.104 Y71.615 E17.41069
+G1 X90.583 Y71.016 E17.46410
+G1 X92.106 Y70.539 E17.51751
+G1 X93.664 Y70.190 E17.57091
+G1 X95.244 Y69.970 E17.62432
+G1 X96.833 Y69.872 E17.67773
+G1 X98.422 Y69.887 E17.73113
+G1 X100.000 Y70.000 E17.78454
+G1 X101.562 Y70.195 E17.83795
+G1 X103.105 Y70.457 E17.89136
+G1 X104.630 Y70.769 E17.94476
+G1 X106.138 Y71.121 E17.99817
+G1 X107.635 Y71.505 E18.05158
+G1 X109.124 Y71.921 E18.10498
+G1 X110.606 Y72.370 E18.15839
+G1 X112.083 Y72.862 E18.21180
+G1 X113.550 Y73.407 E18.26520
+G1 X115.000 Y74.019 E18.31861
+G1 X116.423 Y74.710 E18.37202
+G1 X117.806 Y75.492 E18.42543
+G1 X119.134 Y76.371 E18.47883
+G1 X120.392 Y77.352 E18.53224
+G1 X121.567 Y78.433 E18.58565
+G1 X122.648 Y79.608 E18.63905
+G1 X123.629 Y80.866 E18.69246
+G1 X124.508 Y82.194 E18.74587
+G1 X125.290 Y83.577 E18.79927
+G1 X125.981 Y85.000 E18.85268
+G1 X126.593 Y86.450 E18.90609
+G1 X127.138 Y87.917 E18.95950
+G1 X127.630 Y89.394 E19.01290
+G1 X128.079 Y90.876 E19.06631
+G1 X128.495 Y92.365 E19.11972
+G1 X128.879 Y93.862 E19.17312
+G1 X129.231 Y95.370 E19.22653
+G1 X129.543 Y96.895 E19.27994
+G1 X129.805 Y98.438 E19.33334
+G1 X130.000 Y100.000 E19.38675
+G1 F2700 E14.38675
+G0 F9000 X120.500 Y95.250
+G1 F2700 E19.38675
+;LAYER:3
+G0 X130.000 Y100.000 Z0.800
+G1 X130.000 Y100.000 E19.44016
+G1 X130.113 Y101.578 E19.49357
+G1 X130.128 Y103.167 E19.54697
+G1 X130.030 Y104.756 E19.60038
+G1 X129.810 Y106.336 E19.65379
+G1 X129.461 Y107.894 E19.70719
+G1 X128.984 Y109.417 E19.76060
+G1 X128.385 Y110.896 E19.81401
+G1 X127.675 Y112.322 E19.86742
+G1 X126.868 Y113.690 E19.92082
+G1 X125.981 Y115.000 E19.97423
+G1 X125.031 Y116.255 E20.02764
+G1 X124.033 Y117.461 E20.08104
+G1 X123.000 Y118.625 E20.13445
+G1 X121.941 Y119.756 E20.18786
+G1 X120.860 Y120.860 E20.24126
+G1 X119.756 Y121.941 E20.29467
+G1 X118.625 Y123.000 E20.34808
+G1 X117.461 Y124.033 E20.40149
+G1 X116.255 Y125.031 E20.45489
+G1 X115.000 Y125.981 E20.50830
+G1 X113.690 Y126.868 E20.56171
+G1 X112.322 Y127.675 E20.61511
+G1 X110.896 Y128.385 E20.66852
+G1 X109.417 Y128.984 E20.72193
+G1 X107.894 Y129.461 E20.77533
+G1 X106.336 Y129.810 E20.82874
+G1 X104.756 Y130.030 E20.88215
+G1 X103.167 Y130.128 E20.93556
+G1 X101.578 Y130.113 E20.98896
+G1 X100.000 Y130.000 E21.04237
+G1 X98.438 Y129.805 E21.09578
+G1 X96.895 Y129.543 E21.14918
+G1 X95.370 Y129.231 E21.20259
+G1 X93.862 Y128.879 E21.25600
+G1 X92.365 Y128.495 E21.30940
+G1 X90.876 Y128.079 E21.36281
+G1 X89.394 Y127.630 E21.41622
+G1 X87.917 Y127.138 E21.46963
+G1 X86.450 Y126.593 E21.52303
+G1 X85.000 Y125.981 E21.57644
+G1 X83.577 Y125.290 E21.62985
+G1 X82.194 Y124.508 E21.68325
+G1 X80.866 Y123.629 E21.73666
+G1 X79.608 Y122.648 E21.79007
+G1 X78.433 Y121.567 E21.84348
+G1 X77.352 Y120.392 E21.89688
+G1 X76.371 Y119.134 E21.95029
+G1 X75.492 Y117.806 E22.00370
+G1 X74.710 Y116.423 E22.05710
+G1 X74.019 Y115.000 E22.11051
+G1 X73.407 Y113.550 E22.16392
+G1 X72.862 Y112.083 E22.21732
+G1 X72.370 Y110.606 E22.27073
+G1 X71.921 Y109.124 E22.32414
+G1 X71.505 Y107.635 E22.37755
+G1 X71.121 Y106.138 E22.43095
+G1 X70.769 Y104.630 E22.48436
+G1 X70.457 Y103.105 E22.53777
+G1 X70.195 Y101.562 E22.59117
+G1 X70.000 Y100.000 E22.64458
+G1 X69.887 Y98.422 E22.69799
+G1 X69.872 Y96.833 E22.75139
+G1 X69.970 Y95.244 E22.80480
+G1 X70.190 Y93.664 E22.85821
+G1 X70.539 Y92.106 E22.91162
+G1 X71.016 Y90.583 E22.96502
+G1 X71.615 Y89.104 E23.01843
+G1 X72.325 Y87.678 E23.07184
+G1 X73.132 Y86.310 E23.12524
+G1 X74.019 Y85.000 E23.17865
+G1 X74.969 Y83.745 E23.23206
+G1 X75.967 Y82.539 E23.28547
+G1 X77.000 Y81.375 E23.33887
+G1 X78.059 Y80.244 E23.39228
+G1 X79.140 Y79.140 E23.44569
+G1 X80.244 Y78.059 E23.49909
+G1 X81.375 Y77.000 E23.55250
+G1 X82.539 Y75.967 E23.60591
+G1 X83.745 Y74.969 E23.65931
+G1 X85.000 Y74.019 E23.71272
+G1 X86.310 Y73.132 E23.76613
+G1 X87.678 Y72.325 E23.81954
+G1 X89.104 Y71.615 E23.87294
+G1 X90.583 Y71.016 E23.92635
+G1 X92.106 Y70.539 E23.97976
+G1 X93.664 Y70.190 E24.03316
+G1 X95.244 Y69.970 E24.08657
+G1 X96.833 Y69.872 E24.13998
+G1 X98.422 Y69.887 E24.19338
+G1 X100.000 Y70.000 E24.24679
+G1 X101.562 Y70.195 E24.30020
+G1 X103.105 Y70.457 E24.35361
+G1 X104.630 Y70.769 E24.40701
+G1 X106.138 Y71.121 E24.46042
+G1 X107.635 Y71.505 E24.51383
+G1 X109.124 Y71.921 E24.56723
+G1 X110.606 Y72.370 E24.62064
+G1 X112.083 Y72.862 E24.67405
+G1 X113.550 Y73.407 E24.72745
+G1 X115.000 Y74.019 E24.78086
+G1 X116.423 Y74.710 E24.83427
+G1 X117.806 Y75.492 E24.88768
+G1 X119.134 Y76.371 E24.94108
+G1 X120.392 Y77.352 E24.99449
+G1 X121.567 Y78.433 E25.04790
+G1 X122.648 Y79.608 E25.10130
+G1 X123.629 Y80.866 E25.15471
+G1 X124.508 Y82.194 E25.20812
+G1 X125.290 Y83.577 E25.26153
+G1 X125.981 Y85.000 E25.31493
+G1 X126.593 Y86.450 E25.36834
+G1 X127.138 Y87.917 E25.42175
+G1 X127.630 Y89.394 E25.47515
+G1 X128.079 Y90.876 E25.52856
+G1 X128.495 Y92.365 E25.58197
+G1 X128.879 Y93.862 E25.63537
+G1 X129.231 Y95.370 E25.68878
+G1 X129.543 Y96.895 E25.74219
+G1 X129.805 Y98.438 E25.79560
+G1 X130.000 Y100.000 E25.84900
+G1 F2700 E20.84900
+G0 F9000 X120.500 Y95.250
+G1 F2700 E25.84900
+;LAYER:4
+G0 X130.000 Y100.000 Z1.000
+G1 X130.000 Y100.000 E25.90241
+G1 X130.113 Y101.578 E25.95582
+G1 X130.128 Y103.167 E26.00922
+G1 X130.030 Y104.756 E26.06263
+G1 X129.810 Y106.336 E26.11604
+G1 X129.461 Y107.894 E26.16944
+G1 X128.984 Y109.417 E26.22285
+G1 X128.385 Y110.896 E26.27626
+G1 X127.675 Y112.322 E26.32967
+G1 X126.868 Y113.690 E26.38307
+G1 X125.981 Y115.000 E26.43648
+G1 X125.031 Y116.255 E26.48989
+G1 X124.033 Y117.461 E26.54329
+G1 X123.000 Y118.625 E26.59670
+G1 X121.941 Y119.756 E26.65011
+G1 X120.860 Y120.860 E26.70351
+G1 X119.756 Y121.941 E26.75692
+G1 X118.625 Y123.000 E26.81033
+G1 X117.461 Y124.033 E26.86374
+G1 X116.255 Y125.031 E26.91714
+G1 X115.000 Y125.981 E26.97055
+G1 X113.690 Y126.868 E27.02396
+G1 X112.322 Y127.675 E27.07736
+G1 X110.896 Y128.385 E27.13077
+G1 X109.417 Y128.984 E27.18418
+G1 X107.894 Y129.461 E27.23759
+G1 X106.336 Y129.810 E27.29099
+G1 X104.756 Y130.030 E27.34440
+G1 X103.167 Y130.128 E27.39781
+G1 X101.578 Y130.113 E27.45121
+G1 X100.000 Y130.000 E27.50462
+G1 X98.438 Y129.805 E27.55803
+G1 X96.895 Y129.543 E27.61143
+G1 X95.370 Y129.231 E27.66484
+G1 X93.862 Y128.879 E27.71825
+G1 X92.365 Y128.495 E27.77166
+G1 X90.876 Y128.079 E27.82506
+G1 X89.394 Y127.630 E27.87847
+G1 X87.917 Y127.138 E27.93188
+G1 X86.450 Y126.593 E27.98528
+G1 X85.000 Y125.981 E28.03869
+G1 X83.577 Y125.290 E28.09210
+G1 X82.194 Y124.508 E28.14550
+G1 X80.866 Y123.629 E28.19891
+G1 X79.608 Y122.648 E28.25232
+G1 X78.433 Y121.567 E28.30573
+G1 X77.352 Y120.392 E28.35913
+G1 X76.371 Y119.134 E28.41254
+G1 X75.492 Y117.806 E28.46595
+G1 X74.710 Y116.423 E28.51935
+G1 X74.019 Y115.000 E28.57276
+G1 X73.407 Y113.550 E28.62617
+G1 X72.862 Y112.083 E28.67958
+G1 X72.370 Y110.606 E28.73298
+G1 X71.921 Y109.124 E28.78639
+G1 X71.505 Y107.635 E28.83980
+G1 X71.121 Y106.138 E28.89320
+G1 X70.769 Y104.630 E28.94661
+G1 X70.457 Y103.105 E29.00002
+G1 X70.195 Y101.562 E29.05342
+G1 X70.000 Y100.000 E29.10683
+G1 X69.887 Y98.422 E29.16024
+G1 X69.872 Y96.833 E29.21365
+G1 X69.970 Y95.244 E29.26705
+G1 X70.190 Y93.664 E29.32046
+G1 X70.539 Y92.106 E29.37387
+G1 X71.016 Y90.583 E29.42727
+G1 X71.615 Y89.104 E29.48068
+G1 X72.325 Y87.678 E29.53409
+G1 X73.132 Y86.310 E29.58749
+G1 X74.019 Y85.000 E29.64090
+G1 X74.969 Y83.745 E29.69431
+G1 X75.967 Y82.539 E29.74772
+G1 X77.000 Y81.375 E29.80112
+G1 X78.059 Y80.244 E29.85453
+G1 X79.140 Y79.140 E29.90794
+G1 X80.244 Y78.059 E29.96134
+G1 X81.375 Y77.000 E30.01475
+G1 X82.539 Y75.967 E30.06816
+G1 X83.745 Y74.969 E30.12156
+G1 X85.000 Y74.019 E30.17497
+G1 X86.310 Y73.132 E30.22838
+G1 X87.678 Y72.325 E30.28179
+G1 X89.104 Y71.615 E30.33519
+G1 X90.583 Y71.016 E30.38860
+G1 X92.106 Y70.539 E30.44201
+G1 X93.664 Y70.190 E30.49541
+G1 X95.244 Y69.970 E30.54882
+G1 X96.833 Y69.872 E30.60223
+G1 X98.422 Y69.887 E30.65564
+G1 X100.000 Y70.000 E30.70904
+G1 X101.562 Y70.195 E30.76245
+G1 X103.105 Y70.457 E30.81586
+G1 X104.630 Y70.769 E30.86926
+G1 X106.138 Y71.121 E30.92267
+G1 X107.635 Y71.505 E30.97608
+G1 X109.124 Y71.921 E31.02948
+G1 X110.606 Y72.370 E31.08289
+G1 X112.083 Y72.862 E31.13630
+G1 X113.550 Y73.407 E31.18971
+G1 X115.000 Y74.019 E31.24311
+G1 X116.423 Y74.710 E31.29652
+G1 X117.806 Y75.492 E31.34993
+G1 X119.134 Y76.371 E31.40333
+G1 X120.392 Y77.352 E31.45674
+G1 X121.567 Y78.433 E31.51015
+G1 X122.648 Y79.608 E31.56355
+G1 X123.629 Y80.866 E31.61696
+G1 X124.508 Y82.194 E31.67037
+G1 X125.290 Y83.577 E31.72378
+G1 X125.981 Y85.000 E31.77718
+G1 X126.593 Y86.450 E31.83059
+G1 X127.138 Y87.917 E31.88400
+G1 X127.630 Y89.394 E31.93740
+G1 X128.079 Y90.876 E31.99081
+G1 X128.495 Y92.365 E32.04422
+G1 X128.879 Y93.862 E32.09763
+G1 X129.231 Y95.370 E32.15103
+G1 X129.543 Y96.895 E32.20444
+G1 X129.805 Y98.438 E32.25785
+G1 X130.000 Y100.000 E32.31125
+G1 F2700 E27.31125
+G0 F9000 X120.500 Y95.250
+G1 F2700 E32.31125
+;LAYER:5
+G0 X130.000 Y100.000 Z1.200
+G1 X130.000 Y100.000 E32.36466
+G1 X130.113 Y101.578 E32.41807
+G1 X130.128 Y103.167 E32.47147
+G1 X130.030 Y104.756 E32.52488
+G1 X129.810 Y106.336 E32.57829
+G1 X129.461 Y107.894 E32.63170
+G1 X128.984 Y109.417 E32.68510
+G1 X128.385 Y110.896 E32.73851
+G1 X127.675 Y112.322 E32.79192
+G1 X126.868 Y113.690 E32.84532
+G1 X125.981 Y115.000 E32.89873
+G1 X125.031 Y116.255 E32.95214
+G1 X124.033 Y117.461 E33.00554
+G1 X123.000 Y118.625 E33.05895
+G1 X121.941 Y119.756 E33.11236
+G1 X120.860 Y120.860 E33.16577
+G1 X119.756 Y121.941 E33.21917
+G1 X118.625 Y123.000 E33.27258
+G1 X117.461 Y124.033 E33.32599
+G1 X116.255 Y125.031 E33.37939
+G1 X115.000 Y125.981 E33.43280
+G1 X113.690 Y126.868 E33.48621
+G1 X112.322 Y127.675 E33.53961
+G1 X110.896 Y128.385 E33.59302
+G1 X109.417 Y128.984 E33.64643
+G1 X107.894 Y129.461 E33.69984
+G1 X106.336 Y129.810 E33.75324
+G1 X104.756 Y130.030 E33.80665
+G1 X103.167 Y130.128 E33.86006
+G1 X101.578 Y130.113 E33.91346
+G1 X100.000 Y130.000 E33.96687
+G1 X98.438 Y129.805 E34.02028
+G1 X96.895 Y129.543 E34.07369
+G1 X95.370 Y129.231 E34.12709
+G1 X93.862 Y128.879 E34.18050
+G1 X92.365 Y128.495 E34.23391
+G1 X90.876 Y128.079 E34.28731
+G1 X89.394 Y127.630 E34.34072
+G1 X87.917 Y127.138 E34.39413
+G1 X86.450 Y126.593 E34.44753
+G1 X85.000 Y125.981 E34.50094
+G1 X83.577 Y125.290 E34.55435
+G1 X82.194 Y124.508 E34.60776
+G1 X80.866 Y123.629 E34.66116
+G1 X79.608 Y122.648 E34.71457
+G1 X78.433 Y121.567 E34.76798
+G1 X77.352 Y120.392 E34.82138
+G1 X76.371 Y119.134 E34.87479
+G1 X75.492 Y117.806 E34.92820
+G1 X74.710 Y116.423 E34.98160
+G1 X74.019 Y115.000 E35.03501
+G1 X73.407 Y113.550 E35.08842
+G1 X72.862 Y112.083 E35.14183
+G1 X72.370 Y110.606 E35.19523
+G1 X71.921 Y109.124 E35.24864
+G1 X71.505 Y107.635 E35.30205
+G1 X71.121 Y106.138 E35.35545
+G1 X70.769 Y104.630 E35.40886
+G1 X70.457 Y103.105 E35.46227
+G1 X70.195 Y101.562 E35.51567
+G1 X70.000 Y100.000 E35.56908
+G1 X69.887 Y98.422 E35.62249
+G1 X69.872 Y96.833 E35.67590
+G1 X69.970 Y95.244 E35.72930
+G1 X70.190 Y93.664 E35.78271
+G1 X70.539 Y92.106 E35.83612
+G1 X71.016 Y90.583 E35.88952
+G1 X71.615 Y89.104 E35.94293
+G1 X72.325 Y87.678 E35.99634
+G1 X73.132 Y86.310 E36.04975
+G1 X74.019 Y85.000 E36.10315
+G1 X74.969 Y83.745 E36.15656
+G1 X75.967 Y82.539 E36.20997
+G1 X77.000 Y81.375 E36.26337
+G1 X78.059 Y80.244 E36.31678
+G1 X79.140 Y79.140 E36.37019
+G1 X80.244 Y78.059 E36.42359
+G1 X81.375 Y77.000 E36.47700
+G1 X82.539 Y75.967 E36.53041
+G1 X83.745 Y74.969 E36.58382
+G1 X85.000 Y74.019 E36.63722
+G1 X86.310 Y73.132 E36.69063
+G1 X87.678 Y72.325 E36.74404
+G1 X89.104 Y71.615 E36.79744
+G1 X90.583 Y71.016 E36.85085
+G1 X92.106 Y70.539 E36.90426
+G1 X93.664 Y70.190 E36.95766
+G1 X95.244 Y69.970 E37.01107
+G1 X96.833 Y69.872 E37.06448
+G1 X98.422 Y69.887 E37.11789
+G1 X100.000 Y70.000 E37.17129
+G1 X101.562 Y70.195 E37.22470
+G1 X103.105 Y70.457 E37.27811
+G1 X104.630 Y70.769 E37.33151
+G1 X106.138 Y71.121 E37.38492
+G1 X107.635 Y71.505 E37.43833
+G1 X109.124 Y71.921 E37.49174
+G1 X110.606 Y72.370 E37.54514
+G1 X112.083 Y72.862 E37.59855
+G1 X113.550 Y73.407 E37.65196
+G1 X115.000 Y74.019 E37.70536
+G1 X116.423 Y74.710 E37.75877
+G1 X117.806 Y75.492 E37.81218
+G1 X119.134 Y76.371 E37.86558
+G1 X120.392 Y77.352 E37.91899
+G1 X121.567 Y78.433 E37.97240
+G1 X122.648 Y79.608 E38.02581
+G1 X123.629 Y80.866 E38.07921
+G1 X124.508 Y82.194 E38.13262
+G1 X125.290 Y83.577 E38.18603
+G1 X125.981 Y85.000 E38.23943
+G1 X126.593 Y86.450 E38.29284
+G1 X127.138 Y87.917 E38.34625
+G1 X127.630 Y89.394 E38.39965
+G1 X128.079 Y90.876 E38.45306
+G1 X128.495 Y92.365 E38.50647
+G1 X128.879 Y93.862 E38.55988
+G1 X129.231 Y95.370 E38.61328
+G1 X129.543 Y96.895 E38.66669
+G1 X129.805 Y98.438 E38.72010
+G1 X130.000 Y100.000 E38.77350
+G1 F2700 E33.77350
+G0 F9000 X120.500 Y95.250
+G1 F2700 E38.77350
+M107
+G91 ;relative
+G1 E-2 F2700
+G1 Z10.000
+G90
+M104 S0
+M140 S0
+M84 X Y E ;disable steppers
+M30 print.gco
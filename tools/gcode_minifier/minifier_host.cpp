@@ -0,0 +1,49 @@
+// Host driver for esp3d/src/modules/gcode_host/gcode_minifier.cpp
+// Usage: minifier_host <options> <loops> < input > output
+// Minified lines go to stdout, speed goes to stderr
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gcode_minifier.h"
+
+int main(int argc, char** argv) {
+  uint8_t options = argc > 1 ? (uint8_t)atoi(argv[1]) : 0;
+  int loops = argc > 2 ? atoi(argv[2]) : 1;
+  std::vector<std::string> lines;
+  char buffer[512];
+  while (fgets(buffer, sizeof(buffer), stdin)) {
+    size_t size = strlen(buffer);
+    while (size > 0 && (buffer[size - 1] == '\n' || buffer[size - 1] == '\r')) {
+      size--;
+    }
+    lines.push_back(std::string(buffer, size));
+  }
+  ESP3DGcodeMinifier minifier;
+  minifier.setOptions(options);
+  // same cleaning as GcodeHost::isCommand before minifier
+  for (const std::string& line : lines) {
+    size_t size = line.size();
+    memcpy(buffer, line.c_str(), size);
+    size = minifier.minify(buffer, size);
+    fwrite(buffer, 1, size, stdout);
+    fputc('\n', stdout);
+  }
+  auto start = std::chrono::steady_clock::now();
+  size_t total = 0;
+  for (int i = 0; i < loops; i++) {
+    minifier.reset();
+    for (const std::string& line : lines) {
+      memcpy(buffer, line.c_str(), line.size());
+      total += minifier.minify(buffer, line.size());
+    }
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  fprintf(stderr, "%.0f\n", seconds > 0 ? (lines.size() * loops) / seconds : 0);
+  return total > 0 ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+#!/usr/bin/python
+# Check G-code minifier of ESP3D on host with a corpus of G-code files
+# Each minified line must give exactly the same words and values as the
+# original line, bytes saved and minified lines/s are reported
+# Usage: minifier_test.py [file ...]  (default: corpus/*)
+import glob
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+from decimal import Decimal, InvalidOperation
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+SOURCES = os.path.join(ROOT, "..", "..", "esp3d", "src", "modules", "gcode_host")
+
+# Same values as gcode_minifier.h
+MODAL_MOTION = 0x01
+PAREN_COMMENTS = 0x02
+
+# Options tested for each file
+OPTION_SETS = [
+    ("plain", 0),
+    ("paren comments", PAREN_COMMENTS),
+    ("grbl modal", PAREN_COMMENTS | MODAL_MOTION),
+]
+
+WORD = re.compile(r"([A-Za-z])([+-]?(?:\d+\.?\d*|\.\d+))?")
+
+
+def build(tmp):
+    # minifier only needs esp3d_config.h to enable it
+    src = os.path.join(tmp, "src", "modules", "gcode_host")
+    include = os.path.join(tmp, "src", "include")
+    os.makedirs(src)
+    os.makedirs(include)
+    with open(os.path.join(include, "esp3d_config.h"), "w") as f:
+        f.write("#define GCODE_MINIFIER_FEATURE\n")
+    for name in ["gcode_minifier.h", "gcode_minifier.cpp"]:
+        shutil.copy(os.path.join(SOURCES, name), src)
+    exe = os.path.join(tmp, "minifier_host")
+    cxx = os.environ.get("CXX", "g++")
+    subprocess.check_call([cxx, "-O2", "-std=c++11", "-Wall", "-I", src,
+                           os.path.join(ROOT, "minifier_host.cpp"),
+                           os.path.join(src, "gcode_minifier.cpp"), "-o", exe])
+    return exe
+
+
+# Line as GcodeHost sends it without minifier, None if not sent
+def hostLine(line):
+    line = line.split(";")[0].strip()
+    return line if len(line) > 0 else None
+
+
+def removeParen(line):
+    return re.sub(r"\([^)]*\)", " ", line)
+
+
+# Words of line, None if line is not only letters and numbers
+def words(line):
+    result = []
+    pos = 0
+    line = line.strip()
+    while pos < len(line):
+        if line[pos] in " \t":
+            pos += 1
+            continue
+        m = WORD.match(line, pos)
+        if not m:
+            return None
+        value = None
+        if m.group(2) is not None:
+            try:
+                value = Decimal(m.group(2))
+            except InvalidOperation:
+                return None
+        result.append((m.group(1), value))
+        pos = m.end()
+        if pos < len(line) and not (line[pos] in " \t(" or line[pos].isalpha()):
+            return None
+    return result
+
+
+def isMotion(word):
+    return word[0] in "Gg" and word[1] is not None and word[1] in (Decimal(0), Decimal(1))
+
+
+def check(exe, filename, name, options):
+    with open(filename, "rb") as f:
+        data = f.read()
+    out = subprocess.run([exe, str(options), "200"], input=data,
+                         capture_output=True, check=True)
+    speed = float(out.stderr.decode().strip())
+    original = data.decode("utf-8").split("\n")
+    if original[-1] == "":
+        original.pop()
+    minified = out.stdout.decode("utf-8").split("\n")[:-1]
+    if len(original) != len(minified):
+        print("  line count differs")
+        return False
+    errors = 0
+    plainSize = 0
+    minifiedSize = 0
+    # motion mode known by printer, as tracked by minifier
+    motion = None
+    for n, (src, dst) in enumerate(zip(original, minified), 1):
+        line = hostLine(src)
+        if line is None:
+            continue
+        plainSize += len(line) + 1
+        if options & PAREN_COMMENTS:
+            line = removeParen(line).strip()
+        if len(dst) > 0:
+            minifiedSize += len(dst) + 1
+        expected = words(line)
+        got = words(dst) if expected is not None else None
+        if expected is None or got is None:
+            # raw line, only trimmed
+            ok = (dst == line)
+            motion = None
+        else:
+            if options & MODAL_MOTION:
+                gWords = [w for w in expected if w[0] in "Gg"]
+                # G0/G1 can only be dropped when already the motion mode
+                if len(got) == len(expected) - 1 and len(expected) > 1 \
+                        and isMotion(expected[0]) and expected[0][1] == motion:
+                    got.insert(0, expected[0])
+                if len(gWords) == 1 and gWords[0] is expected[0] and isMotion(expected[0]):
+                    motion = expected[0][1]
+                elif len(gWords) > 0:
+                    motion = None
+            ok = (expected == got)
+        if not ok:
+            errors += 1
+            print("  line {}: '{}' => '{}'".format(n, src, dst))
+    saved = plainSize - minifiedSize
+    print("  {:<15} {:>7} -> {:>7} bytes, {:5.1f}% saved, {:.0f} lines/s, {}".format(
+        name, plainSize, minifiedSize, 100.0 * saved / plainSize if plainSize else 0,
+        speed, "OK" if errors == 0 else "{} errors".format(errors)))
+    return errors == 0
+
+
+def main():
+    files = sys.argv[1:] or sorted(glob.glob(os.path.join(ROOT, "corpus", "*")))
+    tmp = tempfile.mkdtemp()
+    try:
+        exe = build(tmp)
+        success = True
+        for filename in files:
+            print(os.path.basename(filename))
+            for name, options in OPTION_SETS:
+                success = check(exe, filename, name, options) and success
+    finally:
+        shutil.rmtree(tmp)
+    sys.exit(0 if success else 1)
+
+
+main()
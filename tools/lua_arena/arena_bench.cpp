@@ -0,0 +1,225 @@
+// Host benchmark for EspLuaArena of libraries/EspLuaEngine
+// System heap is modeled by an arena shared by Lua and by other services
+// (HTTP chunks, serial lines, 8 KB response buffers), services allocate and
+// free while script runs (count hook)
+// - shared: Lua allocates in system heap (previous behavior)
+// - arena: Lua allocates in its own pool, taken from system heap
+// For each case: services allocation failures, smallest largest free block
+// and fragmentation (1 - largest free / free) of system heap seen by
+// services, and what happens when a script does not stop allocating
+// Build (LIB=../../libraries/EspLuaEngine-1.0.3/src):
+//   gcc -O2 -c -DLUA_USE_C89 $LIB/lua-5.4.7/src/*.c
+//   g++ -O2 -I $LIB -I $LIB/lua-5.4.7/src arena_bench.cpp
+//     $LIB/EspLuaArena.cpp *.o -lm -o arena_bench
+// Usage: arena_bench <heap size> <lua pool size> <runs>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "EspLuaArena.h"
+
+extern "C" {
+#include "lauxlib.h"
+#include "lua.h"
+#include "lualib.h"
+}
+
+// builds strings and tables like a script formatting status messages
+static const char* workScript =
+    "local t = {}\n"
+    "for i = 1, 400 do\n"
+    "  local s = string.format('M117 step %d temp %.1f', i, i * 0.7)\n"
+    "  t[#t + 1] = s .. string.rep('#', i % 64)\n"
+    "  if #t > 60 then t = {} end\n"
+    "  local parts = {}\n"
+    "  for w in s:gmatch('%S+') do parts[#parts + 1] = w end\n"
+    "  local j = table.concat(parts, ',')\n"
+    "end\n";
+
+// never stops allocating
+static const char* runawayScript =
+    "local t = {}\n"
+    "local i = 0\n"
+    "while true do\n"
+    "  i = i + 1\n"
+    "  t[i] = string.rep('x', 100) .. i\n"
+    "end\n";
+
+struct Buffer {
+  void* ptr;
+  uint32_t expire;
+};
+
+struct Services {
+  EspLuaArena* heap;
+  std::vector<Buffer> buffers;
+  uint32_t step;
+  uint32_t requests;
+  uint32_t failures;
+  size_t minLargest;
+  double maxFragmentation;
+
+  void begin(EspLuaArena* h) {
+    heap = h;
+    buffers.clear();
+    step = 0;
+    requests = 0;
+    failures = 0;
+    minLargest = heap->largestFree();
+    maxFragmentation = 0;
+  }
+  void request(size_t size, uint32_t lifetime) {
+    requests++;
+    void* ptr = heap->allocate(size);
+    if (!ptr) {
+      failures++;
+      return;
+    }
+    memset(ptr, 0xA5, size);
+    buffers.push_back({ptr, step + lifetime});
+  }
+  void run() {
+    step++;
+    for (size_t i = 0; i < buffers.size();) {
+      if (buffers[i].expire <= step) {
+        heap->release(buffers[i].ptr);
+        buffers[i] = buffers.back();
+        buffers.pop_back();
+      } else {
+        i++;
+      }
+    }
+    // serial lines and HTTP chunks
+    request(64 + rand() % 512, 1 + rand() % 40);
+    if (step % 3 == 0) {
+      request(1024 + rand() % 1024, 1 + rand() % 10);
+    }
+    // response buffer
+    if (step % 25 == 0) {
+      request(8192, 3);
+    }
+    size_t largest = heap->largestFree();
+    if (largest < minLargest) {
+      minLargest = largest;
+    }
+    if (heap->freeSize() > 0) {
+      double fragmentation = 1.0 - (double)largest / heap->freeSize();
+      if (fragmentation > maxFragmentation) {
+        maxFragmentation = fragmentation;
+      }
+    }
+  }
+  void end() {
+    for (auto& b : buffers) {
+      heap->release(b.ptr);
+    }
+    buffers.clear();
+  }
+};
+
+static Services services;
+
+// bytes used by Lua state whatever the arena
+struct LuaUsage {
+  EspLuaArena* arena;
+  size_t used;
+  size_t peak;
+};
+
+static void* countedAlloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+  LuaUsage* usage = (LuaUsage*)ud;
+  void* res = EspLuaArena::luaAlloc(usage->arena, ptr, osize, nsize);
+  if (nsize == 0 || res) {
+    usage->used += nsize;
+    usage->used -= ptr ? osize : 0;
+    if (usage->used > usage->peak) {
+      usage->peak = usage->used;
+    }
+  }
+  return res;
+}
+
+static void hook(lua_State* L, lua_Debug* ar) {
+  (void)L;
+  (void)ar;
+  services.run();
+}
+
+static lua_State* newState(LuaUsage* usage) {
+  lua_State* L = lua_newstate(countedAlloc, usage);
+  if (!L) {
+    return nullptr;
+  }
+  luaL_requiref(L, LUA_GNAME, luaopen_base, 1);
+  luaL_requiref(L, LUA_STRLIBNAME, luaopen_string, 1);
+  luaL_requiref(L, LUA_TABLIBNAME, luaopen_table, 1);
+  luaL_requiref(L, LUA_MATHLIBNAME, luaopen_math, 1);
+  lua_settop(L, 0);
+  lua_sethook(L, hook, LUA_MASKCOUNT, 500);
+  return L;
+}
+
+static void runCase(const char* name, size_t heapSize, size_t poolSize,
+                    int runs) {
+  EspLuaArena heap;
+  EspLuaArena pool;
+  heap.begin(heapSize);
+  // pool is taken from system heap
+  void* reserved = nullptr;
+  if (poolSize > 0) {
+    reserved = heap.allocate(poolSize);
+    pool.begin(poolSize);
+  }
+  LuaUsage usage = {poolSize > 0 ? &pool : &heap, 0, 0};
+  srand(1);
+  services.begin(&heap);
+  int scriptErrors = 0;
+  for (int r = 0; r < runs; r++) {
+    lua_State* L = newState(&usage);
+    if (!L || luaL_dostring(L, workScript) != LUA_OK) {
+      scriptErrors++;
+    }
+    if (L) {
+      lua_close(L);
+    }
+  }
+  uint32_t requests = services.requests;
+  uint32_t failures = services.failures;
+  size_t minLargest = services.minLargest;
+  double fragmentation = services.maxFragmentation;
+  services.end();
+  printf("%-7s work   : %d runs, %d script errors, services %u/%u failed, "
+         "min largest free %zu, max fragmentation %.1f%%, lua peak %zu\n",
+         name, runs, scriptErrors, failures, requests, minLargest,
+         fragmentation * 100, usage.peak);
+
+  // runaway script
+  services.begin(&heap);
+  lua_State* L = newState(&usage);
+  const char* error = "none";
+  if (L && luaL_dostring(L, runawayScript) != LUA_OK) {
+    error = lua_tostring(L, -1);
+  }
+  printf("%-7s runaway: error '%s', lua used %zu, services %u/%u failed, "
+         "min largest free %zu\n",
+         name, error ? error : "?", usage.used, services.failures,
+         services.requests, services.minLargest);
+  if (L) {
+    lua_close(L);
+  }
+  services.end();
+  if (reserved) {
+    heap.release(reserved);
+  }
+}
+
+int main(int argc, char** argv) {
+  size_t heapSize = argc > 1 ? atoi(argv[1]) : 163840;
+  size_t poolSize = argc > 2 ? atoi(argv[2]) : 65536;
+  int runs = argc > 3 ? atoi(argv[3]) : 200;
+  printf("heap %zu bytes, lua pool %zu bytes\n", heapSize, poolSize);
+  runCase("shared", heapSize, 0, runs);
+  runCase("arena", heapSize, poolSize, runs);
+  return 0;
+}
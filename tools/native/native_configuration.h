@@ -0,0 +1,40 @@
+/*
+  native_configuration.h - ESP3D configuration of host build
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef _CONFIGURATION_H
+#define _CONFIGURATION_H
+
+// Same meaning as esp3d/configuration.h, only features which do not need
+// network or board peripherals, flash filesystem is native_filesystem.cpp
+
+#define COMMUNICATION_PROTOCOL RAW_SERIAL
+#define ESP_SERIAL_OUTPUT USE_SERIAL_0
+#define SERIAL_RX_BUFFER_SIZE 512
+#define DEFAULT_FW MARLIN
+
+#define SERIAL_COMMAND_FEATURE
+#define AUTHENTICATION_FEATURE
+#define GCODE_HOST_FEATURE
+#define PRINT_QUEUE_FEATURE
+
+#define FILESYSTEM_FEATURE ESP_LITTLEFS_FILESYSTEM
+
+#define ESP_SAVE_SETTINGS SETTINGS_IN_EEPROM
+
+#endif  //_CONFIGURATION_H
@@ -0,0 +1,380 @@
+/*
+  native_filesystem.cpp - ESP3D flash filesystem class for host build
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+// Replaces src/modules/filesystem: flash is a temporary directory of host,
+// blank at each run as EEPROM, same handle slots as flash/*.cpp
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+
+#include "../../esp3d/src/include/esp3d_config.h"
+#include "../../esp3d/src/modules/filesystem/esp_filesystem.h"
+
+#define NATIVE_FS_SIZE (1024 * 1024)
+
+struct NativeHandle {
+  FILE *file;
+  DIR *dir;
+  std::string path;
+};
+
+static NativeHandle tFile_handle[ESP_MAX_OPENHANDLE];
+static std::string fsRoot;
+
+bool ESP_FileSystem::_started = false;
+volatile uint32_t ESP_FileSystem::_generation = 0;
+
+static std::string hostPath(const char *path) {
+  std::string p = fsRoot;
+  if (path[0] != '/') {
+    p += '/';
+  }
+  p += path;
+  return p;
+}
+
+static void closeHandle(NativeHandle &handle) {
+  if (handle.file) {
+    fclose(handle.file);
+  }
+  if (handle.dir) {
+    closedir(handle.dir);
+  }
+  handle = NativeHandle();
+}
+
+bool ESP_FileSystem::begin() {
+  if (!_started) {
+    char tmp[] = "/tmp/esp3d_fsXXXXXX";
+    if (mkdtemp(tmp)) {
+      fsRoot = tmp;
+      _started = true;
+    }
+  }
+  return _started;
+}
+
+void ESP_FileSystem::end() {
+  if (!_started) {
+    return;
+  }
+  closeAll();
+  std::error_code ec;
+  std::filesystem::remove_all(fsRoot, ec);
+  _started = false;
+}
+
+bool ESP_FileSystem::accessFS(uint8_t FS) {
+  (void)FS;
+  return _started;
+}
+
+void ESP_FileSystem::releaseFS(uint8_t FS) { (void)FS; }
+
+size_t ESP_FileSystem::totalBytes() { return NATIVE_FS_SIZE; }
+
+size_t ESP_FileSystem::usedBytes() {
+  size_t used = 0;
+  std::error_code ec;
+  for (const auto &entry :
+       std::filesystem::recursive_directory_iterator(fsRoot, ec)) {
+    if (entry.is_regular_file()) {
+      used += entry.file_size();
+    }
+  }
+  return used;
+}
+
+size_t ESP_FileSystem::freeBytes() {
+  size_t used = usedBytes();
+  return used < NATIVE_FS_SIZE ? NATIVE_FS_SIZE - used : 0;
+}
+
+uint ESP_FileSystem::maxPathLength() { return 32; }
+
+size_t ESP_FileSystem::max_update_size() { return 0; }
+
+const char *ESP_FileSystem::FilesystemName() { return "Native"; }
+
+bool ESP_FileSystem::format() {
+  ESP_FileSystemChange change;
+  closeAll();
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator(fsRoot, ec)) {
+    std::filesystem::remove_all(entry.path(), ec);
+  }
+  return !ec;
+}
+
+ESP_File ESP_FileSystem::open(const char *path, uint8_t mode) {
+  ESP_FileSystemChange change(mode != ESP_FILE_READ);
+  if (!_started || strlen(path) == 0 || path[0] != '/' ||
+      ((strcmp(path, "/") == 0) && (mode != ESP_FILE_READ))) {
+    esp3d_log("reject  %s", path);
+    return ESP_File();
+  }
+  std::string p = hostPath(path);
+  struct stat st;
+  bool isdir = stat(p.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+  NativeHandle tmp = NativeHandle();
+  tmp.path = path;
+  if (isdir) {
+    if (mode != ESP_FILE_READ) {
+      return ESP_File();
+    }
+    tmp.dir = opendir(p.c_str());
+  } else {
+    tmp.file = fopen(p.c_str(), (mode == ESP_FILE_READ)    ? "rb"
+                                : (mode == ESP_FILE_WRITE) ? "wb"
+                                                           : "ab");
+  }
+  if (!tmp.file && !tmp.dir) {
+    esp3d_log("open %s failed", path);
+    return ESP_File();
+  }
+  return ESP_File(&tmp, isdir, mode != ESP_FILE_READ, path);
+}
+
+bool ESP_FileSystem::exists(const char *path) {
+  if (strcmp(path, "/") == 0) {
+    return _started;
+  }
+  struct stat st;
+  return _started && stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool ESP_FileSystem::remove(const char *path) {
+  ESP_FileSystemChange change;
+  return _started && unlink(hostPath(path).c_str()) == 0;
+}
+
+bool ESP_FileSystem::mkdir(const char *path) {
+  ESP_FileSystemChange change;
+  return _started && ::mkdir(hostPath(path).c_str(), 0775) == 0;
+}
+
+bool ESP_FileSystem::rmdir(const char *path) {
+  ESP_FileSystemChange change;
+  if (!exists(path) || strcmp(path, "/") == 0) {
+    return false;
+  }
+  std::error_code ec;
+  std::filesystem::remove_all(hostPath(path), ec);
+  return !ec;
+}
+
+bool ESP_FileSystem::rename(const char *oldpath, const char *newpath) {
+  ESP_FileSystemChange change;
+  return _started &&
+         ::rename(hostPath(oldpath).c_str(), hostPath(newpath).c_str()) == 0;
+}
+
+void ESP_FileSystem::closeAll() {
+  for (uint8_t i = 0; i < ESP_MAX_OPENHANDLE; i++) {
+    closeHandle(tFile_handle[i]);
+  }
+}
+
+uint8_t ESP_FileSystem::getFSType(const char *path) {
+  (void)path;
+  return FS_FLASH;
+}
+
+ESP_File::ESP_File(void *handle, bool isdir, bool iswritemode,
+                   const char *path) {
+  _isdir = isdir;
+  _dirlist = "";
+  _isfakedir = false;
+  _index = -1;
+  _filename = path ? path : "";
+  _name = "";
+  _lastwrite = 0;
+  _iswritemode = iswritemode;
+  _size = 0;
+  _timeout = 0;
+  if (!handle) {
+    return;
+  }
+  NativeHandle *tmp = (NativeHandle *)handle;
+  for (uint8_t i = 0; i < ESP_MAX_OPENHANDLE; i++) {
+    if (!tFile_handle[i].file && !tFile_handle[i].dir) {
+      tFile_handle[i] = *tmp;
+      _index = i;
+      break;
+    }
+  }
+  if (_index == -1) {
+    esp3d_log("No handle available");
+    closeHandle(*tmp);
+    _filename = "";
+    return;
+  }
+  _name = _filename == "/" ? "/" : _filename.substring(
+                                       _filename.lastIndexOf('/') + 1);
+  struct stat st;
+  if (stat(hostPath(_filename.c_str()).c_str(), &st) == 0) {
+    _size = _isdir ? 0 : st.st_size;
+    _lastwrite = st.st_mtime;
+  }
+}
+
+ESP_File::ESP_File(const char *name, const char *filename, bool isdir,
+                   size_t size) {
+  _isdir = isdir;
+  _dirlist = "";
+  _isfakedir = isdir;
+  _index = -1;
+  _filename = filename;
+  _name = name;
+  _lastwrite = 0;
+  _iswritemode = false;
+  _size = size;
+  _timeout = 0;
+}
+
+// As on device, copies share the handle, which is released by close()
+ESP_File::~ESP_File() {}
+
+ESP_File::operator bool() const {
+  return (_index != -1) || (_filename.length() > 0);
+}
+
+bool ESP_File::isOpen() { return _index != -1; }
+
+const char *ESP_File::name() const { return _name.c_str(); }
+
+const char *ESP_File::filename() const { return _filename.c_str(); }
+
+bool ESP_File::isDirectory() { return _isdir; }
+
+size_t ESP_File::size() {
+  if (_index != -1 && !_isdir) {
+    fflush(tFile_handle[_index].file);
+    struct stat st;
+    if (fstat(fileno(tFile_handle[_index].file), &st) == 0) {
+      _size = st.st_size;
+    }
+  }
+  return _size;
+}
+
+time_t ESP_File::getLastWrite() { return _lastwrite; }
+
+int ESP_File::available() {
+  if (_index == -1 || _isdir) {
+    return 0;
+  }
+  long pos = ftell(tFile_handle[_index].file);
+  size_t total = size();
+  return pos >= 0 && (size_t)pos < total ? total - pos : 0;
+}
+
+size_t ESP_File::write(uint8_t i) { return write(&i, 1); }
+
+size_t ESP_File::write(const uint8_t *buf, size_t size) {
+  if (_index == -1 || _isdir || !_iswritemode) {
+    return 0;
+  }
+  return fwrite(buf, 1, size, tFile_handle[_index].file);
+}
+
+int ESP_File::read() {
+  if (_index == -1 || _isdir) {
+    return -1;
+  }
+  return fgetc(tFile_handle[_index].file);
+}
+
+size_t ESP_File::read(uint8_t *buf, size_t size) {
+  if (_index == -1 || _isdir) {
+    return 0;
+  }
+  return fread(buf, 1, size, tFile_handle[_index].file);
+}
+
+void ESP_File::flush() {
+  if (_index != -1 && !_isdir) {
+    fflush(tFile_handle[_index].file);
+  }
+}
+
+bool ESP_File::seek(uint32_t pos, uint8_t mode) {
+  if (_index == -1 || _isdir) {
+    return false;
+  }
+  int whence = mode == ESP_SEEK_END   ? SEEK_END
+               : mode == ESP_SEEK_CUR ? SEEK_CUR
+                                      : SEEK_SET;
+  return fseek(tFile_handle[_index].file, pos, whence) == 0;
+}
+
+void ESP_File::close() {
+  ESP_FileSystemChange change(_index != -1 && _iswritemode);
+  if (_index == -1) {
+    return;
+  }
+  closeHandle(tFile_handle[_index]);
+  _index = -1;
+  struct stat st;
+  if (_iswritemode && !_isdir &&
+      stat(hostPath(_filename.c_str()).c_str(), &st) == 0) {
+    _size = st.st_size;
+    _lastwrite = st.st_mtime;
+  }
+}
+
+ESP_File &ESP_File::operator=(const ESP_File &other) {
+  _isdir = other._isdir;
+  _isfakedir = other._isfakedir;
+  _index = other._index;
+  _filename = other._filename;
+  _name = other._name;
+  _size = other._size;
+  _iswritemode = other._iswritemode;
+  _dirlist = other._dirlist;
+  _lastwrite = other._lastwrite;
+  _timeout = other._timeout;
+  return *this;
+}
+
+ESP_File ESP_File::openNextFile() {
+  if (_index == -1 || !_isdir) {
+    return ESP_File();
+  }
+  struct dirent *entry;
+  while ((entry = readdir(tFile_handle[_index].dir)) != nullptr) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+    String path = _filename;
+    if (!path.endsWith("/")) {
+      path += "/";
+    }
+    path += entry->d_name;
+    ESP_File tmp = ESP_FileSystem::open(path.c_str());
+    tmp.close();
+    return tmp;
+  }
+  return ESP_File();
+}
@@ -0,0 +1,59 @@
+/*
+  native_hal.cpp - ESP3D hal class for host build
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+// Replaces src/core/esp3d_hal.cpp: no wifi, no pins, no watchdog
+#include "../../esp3d/src/core/esp3d_hal.h"
+
+#include "../../esp3d/src/include/esp3d_config.h"
+
+TaskHandle_t ESP3DHal::xHandle = nullptr;
+uint32_t ESP3DHal::_analogRange = 255;
+uint32_t ESP3DHal::_analogWriteFreq = 1000;
+
+bool ESP3DHal::begin() { return true; }
+
+void ESP3DHal::end() {}
+
+void ESP3DHal::checkTWDT() {}
+
+void ESP3DHal::wdtFeed() { vTaskDelay(1); }
+
+void ESP3DHal::wait(uint32_t milliseconds) { delay(milliseconds); }
+
+uint16_t ESP3DHal::getChipID() { return 0xE3D; }
+
+bool ESP3DHal::has_temperature_sensor() { return false; }
+
+float ESP3DHal::temperature() { return 0; }
+
+bool ESP3DHal::is_pin_usable(uint pin) { return false; }
+
+void ESP3DHal::clearAnalogChannels() {}
+
+void ESP3DHal::pinMode(uint8_t pin, uint8_t mode) { ::pinMode(pin, mode); }
+
+int ESP3DHal::analogRead(uint8_t pin) { return ::analogRead(pin); }
+
+bool ESP3DHal::analogWrite(uint8_t pin, uint value) { return false; }
+
+void ESP3DHal::analogWriteFreq(uint32_t freq) { _analogWriteFreq = freq; }
+
+void ESP3DHal::analogRange(uint32_t range) { _analogRange = range; }
+
+const char* ESP3DHal::arduinoVersion() { return "native"; }
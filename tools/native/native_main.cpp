@@ -0,0 +1,493 @@
+/*
+  native_main.cpp - ESP3D host harness and benchmarks
+
+  Copyright (c) 2023 Luc Lebosse. All rights reserved.
+
+  This code is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with This code; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+// Runs the real Esp3D loop (settings, serial service, commands, gcode host,
+// print queue on native_filesystem.cpp) against a serial port stub:
+//  - loopback (default): an in-process printer answers "ok" to each G-code
+//    line and command answers are captured, so everything is measured here
+//  - pty: serial is a pseudo terminal, e.g. the one printed by
+//    tools/fw_simulator/fw_simulator.py marlin pty
+//
+// Usage: esp3d_native [--pty <path>] [--commands N] [--lines N] [--trace]
+#include <fcntl.h>
+#include <malloc.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../../esp3d/src/core/esp3d.h"
+#include "../../esp3d/src/core/esp3d_args.h"
+#include "../../esp3d/src/core/esp3d_commands.h"
+#include "../../esp3d/src/core/esp3d_settings.h"
+#include "../../esp3d/src/include/esp3d_config.h"
+#include "../../esp3d/src/modules/filesystem/esp_filesystem.h"
+#include "../../esp3d/src/modules/gcode_host/gcode_host.h"
+#include "../../esp3d/src/modules/serial/serial_service.h"
+
+// Allocation counters, harness own allocations are not counted
+static std::atomic<uint64_t> allocCount(0);
+static std::atomic<uint64_t> freeCount(0);
+static std::atomic<int64_t> liveBytes(0);
+static thread_local bool inHarness = false;
+static bool trace = false;
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* p, size_t size);
+void __libc_free(void* p);
+}
+
+static void countAlloc(void* p) {
+  if (p && !inHarness) {
+    allocCount++;
+    liveBytes += malloc_usable_size(p);
+  }
+}
+
+static void countFree(void* p) {
+  if (p && !inHarness) {
+    freeCount++;
+    liveBytes -= malloc_usable_size(p);
+  }
+}
+
+// Messages use malloc/free and other objects new/delete, both are counted
+extern "C" void* malloc(size_t size) {
+  void* p = __libc_malloc(size);
+  countAlloc(p);
+  return p;
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+  void* p = __libc_calloc(count, size);
+  countAlloc(p);
+  return p;
+}
+
+extern "C" void* realloc(void* p, size_t size) {
+  // failed realloc keeps original block, so it is only counted on success
+  size_t previous = p ? malloc_usable_size(p) : 0;
+  void* r = __libc_realloc(p, size);
+  if (r && !inHarness) {
+    allocCount++;
+    liveBytes += (int64_t)malloc_usable_size(r) - (int64_t)previous;
+  } else if (!r && !size && p) {
+    countFree(p);
+  }
+  return r;
+}
+
+extern "C" void free(void* p) {
+  countFree(p);
+  __libc_free(p);
+}
+
+void* operator new(size_t size) {
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return malloc(size ? size : 1);
+}
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+  return operator new(size, tag);
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+uint32_t EspClass::getFreeHeap() {
+  int64_t used = liveBytes.load();
+  return used < getHeapSize() ? getHeapSize() - used : 0;
+}
+
+// Scope where allocations belong to harness
+class HarnessScope {
+ public:
+  HarnessScope() : _previous(inHarness) { inHarness = true; }
+  ~HarnessScope() { inHarness = _previous; }
+
+ private:
+  bool _previous;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedUs(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+}
+
+// In-process printer: acknowledges G-code lines, keeps other lines as
+// answers of ESP3D commands
+class LoopbackPrinter {
+ public:
+  void attach(HardwareSerial& serial) {
+    _serial = &serial;
+    serial.onTransmit([this](const uint8_t* data, size_t size) {
+      HarnessScope scope;
+      received(data, size);
+    });
+  }
+  void clearAnswer() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _answer.clear();
+    _answers = 0;
+  }
+  size_t answers() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _answers;
+  }
+  std::string answer() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _answer;
+  }
+  uint64_t gcodeLines() { return _gcodeLines; }
+
+ private:
+  void received(const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      char c = (char)data[i];
+      // json answers have no end of line, they end with their last brace
+      if (_line.empty() && c == '{') {
+        _jsonDepth = 0;
+        _inString = false;
+        _escape = false;
+        _isJson = true;
+      }
+      if (_isJson) {
+        _line += c;
+        if (_escape) {
+          _escape = false;
+        } else if (c == '\\') {
+          _escape = _inString;
+        } else if (c == '"') {
+          _inString = !_inString;
+        } else if (!_inString && c == '{') {
+          _jsonDepth++;
+        } else if (!_inString && c == '}' && --_jsonDepth == 0) {
+          _isJson = false;
+          endLine();
+        }
+        continue;
+      }
+      if (c != '\n') {
+        _line += c;
+        continue;
+      }
+      endLine();
+    }
+  }
+  void endLine() {
+    if (trace) {
+      fprintf(stderr, "%10u TX %s\n", micros(), _line.c_str());
+    }
+    if (isGcode(_line)) {
+      _gcodeLines++;
+      static const uint8_t ok[] = "ok\n";
+      _serial->inject(ok, sizeof(ok) - 1);
+    } else {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _answer += _line;
+      _answer += '\n';
+      // json answer is one object, text answer ends with "ok" line
+      if (_line[0] == '{' || _line == "ok") {
+        _answers++;
+      }
+    }
+    _line.clear();
+  }
+  static bool isGcode(const std::string& line) {
+    size_t pos = line.find_first_not_of(" \r");
+    if (pos == std::string::npos) {
+      return false;
+    }
+    char c = toupper(line[pos]);
+    return c == 'G' || c == 'M' || c == 'T' || c == 'N';
+  }
+  HardwareSerial* _serial = nullptr;
+  std::string _line;
+  bool _isJson = false;
+  bool _inString = false;
+  bool _escape = false;
+  int _jsonDepth = 0;
+  std::string _answer;
+  size_t _answers = 0;
+  std::atomic<uint64_t> _gcodeLines{0};
+  std::mutex _mutex;
+};
+
+static Esp3D myesp3d;
+static LoopbackPrinter printer;
+
+// Run ESP3D loop until condition is true, false on timeout
+static bool runUntil(const std::function<bool()>& done, uint32_t timeoutMs) {
+  Clock::time_point start = Clock::now();
+  while (!done()) {
+    myesp3d.handle();
+    if (elapsedUs(start) > timeoutMs * 1000.0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static double percentile(std::vector<double>& values, double p) {
+  if (values.empty()) {
+    return 0;
+  }
+  std::sort(values.begin(), values.end());
+  size_t index = (size_t)(p * (values.size() - 1));
+  return values[index];
+}
+
+static void injectLine(const char* line) {
+  HarnessScope scope;
+  std::string s = line;
+  s += '\n';
+  if (trace) {
+    fprintf(stderr, "%10u RX %s", micros(), s.c_str());
+  }
+  Serial.inject((const uint8_t*)s.c_str(), s.size());
+}
+
+// Command sent on serial until its whole answer is written back
+static bool benchCommand(const char* command, int count) {
+  std::vector<double> latencies;
+  latencies.reserve(count);
+  uint64_t allocs = 0;
+  int64_t leaked = 0;
+  for (int i = 0; i < count; i++) {
+    printer.clearAnswer();
+    uint64_t allocStart = allocCount;
+    int64_t liveStart = liveBytes;
+    Clock::time_point start = Clock::now();
+    injectLine(command);
+    if (!runUntil([] { return printer.answers() > 0; }, 2000)) {
+      printf("%-24s no answer\n", command);
+      return false;
+    }
+    latencies.push_back(elapsedUs(start));
+    allocs += allocCount - allocStart;
+    leaked += liveBytes - liveStart;
+  }
+  std::string answer = printer.answer();
+  bool ok = answer.find("\"status\":\"error\"") == std::string::npos &&
+            answer.find("error:") != 0;
+  printf("%-24s p50 %8.1f us  p99 %8.1f us  %6.1f allocs/cmd  %6lld bytes "
+         "kept/cmd%s\n",
+         command, percentile(latencies, 0.5), percentile(latencies, 0.99),
+         (double)allocs / count, (long long)(leaked / count),
+         ok ? "" : "  (error answer)");
+  return ok;
+}
+
+// Splitting of parameters, once per executed command
+static void benchParse(int count) {
+  static const char* lines[] = {
+      "[ESP800]json time=2023-10-18T12:00:00 tz=+02:00 version=3.0.0 "
+      "setup=1",
+      "[ESP401]P=1 T=B V=115200 json pwd=admin",
+      "[ESP700]/FS/macros/start.gco",
+  };
+  const size_t nbLines = sizeof(lines) / sizeof(lines[0]);
+  ESP3DArgs args;
+  Clock::time_point start = Clock::now();
+  uint64_t allocStart = allocCount;
+  size_t found = 0;
+  for (int i = 0; i < count; i++) {
+    const char* line = lines[i % nbLines];
+    args.parse(line, strlen(line), 8);
+    found += args.hasTag("json") + strlen(args.get("T="));
+  }
+  printf("%-24s %8.1f ns/line  %6.1f allocs/line (%zu)\n", "ESP3DArgs parse",
+         elapsedUs(start) * 1000 / count,
+         (double)(allocCount - allocStart) / count, found);
+}
+
+// G-code script streamed by gcode host, each line waits printer "ok"
+static bool benchStream(int count, bool ptyMode, uint32_t timeoutMs) {
+  std::string script;
+  {
+    HarnessScope scope;
+    script.reserve(count * 24);
+    char line[32];
+    for (int i = 0; i < count; i++) {
+      snprintf(line, sizeof(line), "G1 X%d Y%d F3000;", i % 200,
+               (i * 7) % 200);
+      script += line;
+    }
+  }
+  uint64_t linesStart = printer.gcodeLines();
+  uint64_t allocStart = allocCount;
+  Clock::time_point start = Clock::now();
+  esp3d_gcode_host.processScript(script.c_str(),
+                                 ESP3DAuthenticationLevel::admin);
+  uint32_t id = esp3d_gcode_host.lastScriptId();
+  bool done = runUntil([id] { return esp3d_gcode_host.isScriptDone(id); },
+                       timeoutMs);
+  double us = elapsedUs(start);
+  // loopback printer counts what it received, pty printer counts itself
+  bool ok = done && esp3d_gcode_host.getErrorNum() == ERROR_NO_ERROR &&
+            (ptyMode || printer.gcodeLines() - linesStart == (uint64_t)count);
+  printf("%-24s %d lines in %.1f ms: %.0f lines/s  %.1f allocs/line%s\n",
+         "G-code stream", count, us / 1000, count * 1e6 / us,
+         (double)(allocCount - allocStart) / count,
+         ok ? "" : "  (stream failed)");
+  return ok;
+}
+
+// ESP401 needs admin level, so a byte setting which is not used by host
+// build shows at which level an ESP command of a stream was run
+static const ESP3DSettingIndex authSetting = ESP3DSettingIndex::esp3d_http_on;
+
+static std::string authCommand(uint8_t value) {
+  return "[ESP401]P=" + std::to_string(static_cast<int>(authSetting)) +
+         " T=B V=" + std::to_string(value);
+}
+
+static void setAuthSetting(uint8_t value) {
+  ESP3DSettings::writeByte(static_cast<int>(authSetting), value);
+}
+
+static bool isAuthSetting(uint8_t value) {
+  return ESP3DSettings::readByte(static_cast<int>(authSetting)) == value;
+}
+
+// Script is what POST /batch sends for an authenticated request, its ESP
+// command runs at level of the request
+static bool checkScriptAuth() {
+  setAuthSetting(0);
+  std::string script = "G1 X1;" + authCommand(1) + ";G1 X2";
+  esp3d_gcode_host.processScript(script.c_str(),
+                                 ESP3DAuthenticationLevel::admin);
+  uint32_t id = esp3d_gcode_host.lastScriptId();
+  bool ok = runUntil([id] { return esp3d_gcode_host.isScriptDone(id); },
+                     2000) &&
+            isAuthSetting(1);
+  printf("%-24s %s\n", "ESP command of script", ok ? "ok" : "failed");
+  return ok;
+}
+
+// Queued file is started by gcode host loop with level stored in job
+static bool checkQueuedFileAuth() {
+  setAuthSetting(0);
+  ESP_File f = ESP_FileSystem::open("/auth.gco", ESP_FILE_WRITE);
+  std::string content = "G1 X1\n" + authCommand(1) + "\nG1 X2\n";
+  bool ok = f && f.write((const uint8_t*)content.c_str(), content.size()) ==
+                     content.size();
+  f.close();
+  uint64_t linesStart = printer.gcodeLines();
+  ok = ok && esp3d_gcode_host.queueFile(ESP_FLASH_FS_HEADER "/auth.gco",
+                                        ESP3DAuthenticationLevel::admin) != 0;
+  ok = ok &&
+       runUntil(
+           [linesStart] {
+             return printer.gcodeLines() - linesStart == 2 &&
+                    esp3d_gcode_host.getStatus() == HOST_NO_STREAM;
+           },
+           2000) &&
+       isAuthSetting(1);
+  ESP_FileSystem::remove("/auth.gco");
+  printf("%-24s %s\n", "ESP command of job", ok ? "ok" : "failed");
+  return ok;
+}
+
+static int openPty(const char* path) {
+  int fd = open(path, O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    perror(path);
+    return -1;
+  }
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  return fd;
+}
+
+int main(int argc, char** argv) {
+  const char* ptyPath = nullptr;
+  int commands = 200;
+  int lines = 2000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--pty") && i + 1 < argc) {
+      ptyPath = argv[++i];
+    } else if (!strcmp(argv[i], "--trace")) {
+      trace = true;
+    } else if (!strcmp(argv[i], "--commands") && i + 1 < argc) {
+      commands = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--lines") && i + 1 < argc) {
+      lines = atoi(argv[++i]);
+    } else {
+      printf("Usage: %s [--pty <path>] [--commands N] [--lines N] [--trace]\n",
+             argv[0]);
+      return 2;
+    }
+  }
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+  if (ptyPath) {
+    int fd = openPty(ptyPath);
+    if (fd < 0) {
+      return 1;
+    }
+    Serial.attach(fd);
+  } else {
+    printer.attach(Serial);
+  }
+  // EEPROM is blank at each run: do the reset a first boot does before
+  // restarting, instead of exiting on restart
+  if (!ESP3DSettings::begin()) {
+    Esp3D::reset();
+  }
+  if (!myesp3d.begin()) {
+    printf("ESP3D begin failed\n");
+    return 1;
+  }
+  // let boot messages go
+  runUntil([] { return false; }, 200);
+  bool res = true;
+  if (!ptyPath) {
+    benchParse(100000);
+    res = benchCommand("[ESP800]json", commands) && res;
+    res = benchCommand("[ESP420]json", commands) && res;
+    res = benchCommand("[ESP400]json", commands) && res;
+    res = benchCommand("[ESP0]", commands) && res;
+    res = checkScriptAuth() && res;
+    res = checkQueuedFileAuth() && res;
+  }
+  res = benchStream(lines, ptyPath != nullptr, ptyPath ? 600000 : 60000) && res;
+  myesp3d.end();
+  printf("%s\n", res ? "PASS" : "FAIL");
+  return res ? 0 : 1;
+}
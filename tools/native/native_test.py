@@ -0,0 +1,67 @@
+#!/usr/bin/python
+# Build ESP3D core (settings, serial service, commands, gcode host, print
+# queue) for host with stubs of tools/native/stubs and run native_main.cpp harness
+# Same sources as [env:native] of platformio.ini
+# Usage: native_test.py [harness arguments, e.g. --commands 500 --lines 5000]
+import glob
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+SOURCES = os.path.abspath(os.path.join(ROOT, "..", "..", "esp3d", "src"))
+
+
+def sources():
+    files = [f for f in glob.glob(os.path.join(SOURCES, "core", "*.cpp"))
+             if not f.endswith("esp3d_hal.cpp")]
+    for module in ["core/commands", "modules/serial", "modules/authentication",
+                   "modules/gcode_host", "modules/boot_delay"]:
+        files += glob.glob(os.path.join(SOURCES, module, "*.cpp"))
+    files += [os.path.join(ROOT, "native_hal.cpp"),
+              os.path.join(ROOT, "native_filesystem.cpp"),
+              os.path.join(ROOT, "native_main.cpp"),
+              os.path.join(ROOT, "stubs", "native_arduino.cpp")]
+    return sorted(files)
+
+
+def build(tmp):
+    cxx = os.environ.get("CXX", "g++")
+    flags = ["-std=gnu++17", "-O2", "-DARDUINO_ARCH_ESP32",
+             "-DESP3D_NATIVE_CONFIGURATION=\"{}\"".format(
+                 os.path.join(ROOT, "native_configuration.h")),
+             "-I", os.path.join(ROOT, "stubs")]
+    jobs = os.cpu_count() or 1
+    objects = []
+    running = []
+    for index, source in enumerate(sources()):
+        obj = os.path.join(tmp, "{}_{}.o".format(
+            index, os.path.splitext(os.path.basename(source))[0]))
+        objects.append(obj)
+        running.append(subprocess.Popen([cxx] + flags + ["-c", source, "-o", obj]))
+        if len(running) >= jobs:
+            if running.pop(0).wait() != 0:
+                return None
+    if any(p.wait() != 0 for p in running):
+        return None
+    exe = os.path.join(tmp, "esp3d_native")
+    subprocess.check_call([cxx] + objects + ["-o", exe, "-lpthread"])
+    return exe
+
+
+def main():
+    tmp = tempfile.mkdtemp()
+    try:
+        exe = build(tmp)
+        if not exe:
+            print("build failed")
+            sys.exit(1)
+        out = subprocess.run([exe] + sys.argv[1:], timeout=600)
+    finally:
+        shutil.rmtree(tmp)
+    sys.exit(out.returncode)
+
+
+main()
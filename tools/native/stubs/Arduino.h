@@ -0,0 +1,89 @@
+// Host version of Arduino core for ESP32, enough for ESP3D core units
+#ifndef _NATIVE_ARDUINO_H
+#define _NATIVE_ARDUINO_H
+
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include <algorithm>
+
+#include "WString.h"
+
+using std::max;
+using std::min;
+
+typedef unsigned int uint;
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr) (*(void* const*)(addr))
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define IRAM_ATTR
+#define ICACHE_FLASH_ATTR
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+
+#define DEC 10
+#define HEX 16
+
+#define SERIAL_8N1 0x800001c
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void yield();
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+#include "HardwareSerial.h"
+
+// Heap counters are the ones of host allocator hooks (see native_main.cpp)
+class EspClass {
+ public:
+  uint32_t getFreeHeap();
+  uint32_t getHeapSize() { return 320 * 1024; }
+  uint32_t getMinFreeHeap() { return getFreeHeap(); }
+  uint32_t getMaxAllocHeap() { return getFreeHeap(); }
+  uint32_t getPsramSize() { return 0; }
+  uint32_t getFreePsram() { return 0; }
+  uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint32_t getSketchSize() { return 0; }
+  uint32_t getFreeSketchSpace() { return 0; }
+  uint64_t getEfuseMac() { return 0x0000deadbeef0000ULL; }
+  const char* getSdkVersion() { return "native"; }
+  const char* getChipModel() { return "native"; }
+  uint8_t getChipRevision() { return 0; }
+  uint8_t getChipCores() { return 2; }
+  void restart();
+};
+extern EspClass ESP;
+
+#endif  // _NATIVE_ARDUINO_H
@@ -0,0 +1,30 @@
+// Host EEPROM kept in RAM, ESP3DSettings starts from erased (0xFF) content
+#ifndef _NATIVE_EEPROM_H
+#define _NATIVE_EEPROM_H
+
+#include <stdint.h>
+#include <string.h>
+
+class EEPROMClass {
+ public:
+  EEPROMClass() { memset(_data, 0xFF, sizeof(_data)); }
+  bool begin(size_t size) { return size <= sizeof(_data); }
+  uint8_t read(int address) { return valid(address) ? _data[address] : 0; }
+  void write(int address, uint8_t value) {
+    if (valid(address)) {
+      _data[address] = value;
+    }
+  }
+  bool commit() { return true; }
+  bool end() { return true; }
+
+ private:
+  bool valid(int address) {
+    return address >= 0 && (size_t)address < sizeof(_data);
+  }
+  uint8_t _data[4096];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif  // _NATIVE_EEPROM_H
@@ -0,0 +1,9 @@
+// Host build has no web server, only declarations used by headers
+#ifndef _NATIVE_ESP_ASYNC_WEB_SERVER_H
+#define _NATIVE_ESP_ASYNC_WEB_SERVER_H
+
+class AsyncWebServer;
+class AsyncWebServerRequest;
+class AsyncWebServerResponse;
+
+#endif  // _NATIVE_ESP_ASYNC_WEB_SERVER_H
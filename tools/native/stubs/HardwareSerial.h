@@ -0,0 +1,91 @@
+// Host serial port: bytes come from a pseudo terminal or are injected by
+// the harness (loopback), onReceive callback runs in its own thread like
+// UART event task of ESP32
+#ifndef _NATIVE_HARDWARE_SERIAL_H
+#define _NATIVE_HARDWARE_SERIAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "WString.h"
+
+// Received bytes not yet read by ESP3D, fixed so stub never allocates
+#define NATIVE_SERIAL_RX_SIZE 65536
+
+class HardwareSerial {
+ public:
+  typedef std::function<void(void)> OnReceiveCb;
+  typedef std::function<void(const uint8_t*, size_t)> OnTransmitCb;
+  explicit HardwareSerial(int index) : _index(index) {}
+  ~HardwareSerial() { end(); }
+  void begin(unsigned long baud, uint32_t config = 0, int8_t rxPin = -1,
+             int8_t txPin = -1);
+  void end();
+  void updateBaudRate(unsigned long baud) { _baud = baud; }
+  unsigned long baudRate() { return _baud; }
+  size_t setRxBufferSize(size_t size) { return _rxSize = size; }
+  size_t setTxBufferSize(size_t size) { return _txSize = size; }
+  void onReceive(OnReceiveCb cb, bool onlyOnTimeout = false);
+  int available();
+  int availableForWrite();
+  int read();
+  int peek();
+  size_t readBytes(uint8_t* buffer, size_t length);
+  size_t readBytes(char* buffer, size_t length) {
+    return readBytes((uint8_t*)buffer, length);
+  }
+  size_t write(uint8_t c) { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  size_t println(const char* s = "") { return print(s) + write("\r\n"); }
+  size_t println(const String& s) { return println(s.c_str()); }
+  size_t printf(const char* format, ...);
+  void flush() {}
+  operator bool() const { return true; }
+
+  // host side
+  // pseudo terminal or any file descriptor, -1 for loopback
+  void attach(int fd);
+  // loopback: bytes as if received from printer
+  void inject(const uint8_t* data, size_t size);
+  // loopback: bytes sent to printer
+  void onTransmit(OnTransmitCb cb) { _onTransmit = cb; }
+  uint64_t rxBytes() const { return _rxBytes; }
+  uint64_t txBytes() const { return _txBytes; }
+
+ private:
+  void rxTask();
+  void fdTask();
+  int _index;
+  int _fd = -1;
+  unsigned long _baud = 0;
+  size_t _rxSize = 256;
+  size_t _txSize = 256;
+  std::atomic<bool> _running{false};
+  uint64_t _rxBytes = 0;
+  uint64_t _txBytes = 0;
+  uint8_t _rx[NATIVE_SERIAL_RX_SIZE];
+  size_t _rxHead = 0;
+  size_t _rxCount = 0;
+  std::mutex _rxMutex;
+  std::mutex _txMutex;
+  std::condition_variable _rxEvent;
+  std::thread _thread;
+  std::thread _fdThread;
+  OnReceiveCb _onReceive;
+  OnTransmitCb _onTransmit;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif  // _NATIVE_HARDWARE_SERIAL_H
@@ -0,0 +1,265 @@
+// Host version of Arduino String, same API subset as used by ESP3D
+#ifndef _NATIVE_WSTRING_H
+#define _NATIVE_WSTRING_H
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <string>
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+class String {
+ public:
+  String() {}
+  String(const char* s) : _s(s ? s : "") {}
+  String(const __FlashStringHelper* s)
+      : _s(s ? reinterpret_cast<const char*>(s) : "") {}
+  String(const std::string& s) : _s(s) {}
+  String(const String& s) = default;
+  String(String&& s) = default;
+  explicit String(char c) : _s(1, c) {}
+  explicit String(unsigned char v, unsigned char base = 10) {
+    fromULong(v, base);
+  }
+  explicit String(int v, unsigned char base = 10) { fromLong(v, base); }
+  explicit String(unsigned int v, unsigned char base = 10) {
+    fromULong(v, base);
+  }
+  explicit String(long v, unsigned char base = 10) { fromLong(v, base); }
+  explicit String(unsigned long v, unsigned char base = 10) {
+    fromULong(v, base);
+  }
+  explicit String(long long v, unsigned char base = 10) { fromLong(v, base); }
+  explicit String(unsigned long long v, unsigned char base = 10) {
+    fromULong(v, base);
+  }
+  explicit String(float v, unsigned int decimals = 2) {
+    fromDouble(v, decimals);
+  }
+  explicit String(double v, unsigned int decimals = 2) {
+    fromDouble(v, decimals);
+  }
+
+  String& operator=(const String& s) = default;
+  String& operator=(String&& s) = default;
+  String& operator=(const char* s) {
+    _s = s ? s : "";
+    return *this;
+  }
+
+  unsigned int length() const { return _s.size(); }
+  bool isEmpty() const { return _s.empty(); }
+  const char* c_str() const { return _s.c_str(); }
+  char* begin() { return &_s[0]; }
+  char* end() { return &_s[0] + _s.size(); }
+  bool reserve(unsigned int size) {
+    _s.reserve(size);
+    return true;
+  }
+
+  bool concat(const String& s) {
+    _s += s._s;
+    return true;
+  }
+  bool concat(const char* s) {
+    if (s) _s += s;
+    return true;
+  }
+  bool concat(const char* s, unsigned int len) {
+    _s.append(s, len);
+    return true;
+  }
+  bool concat(char c) {
+    _s += c;
+    return true;
+  }
+  template <typename T>
+  bool concat(T v) {
+    return concat(String(v));
+  }
+  String& operator+=(const String& s) {
+    concat(s);
+    return *this;
+  }
+  String& operator+=(const char* s) {
+    concat(s);
+    return *this;
+  }
+  String& operator+=(char c) {
+    concat(c);
+    return *this;
+  }
+  template <typename T>
+  String& operator+=(T v) {
+    concat(String(v));
+    return *this;
+  }
+
+  char operator[](unsigned int index) const {
+    return index < _s.size() ? _s[index] : 0;
+  }
+  char& operator[](unsigned int index) { return _s[index]; }
+  char charAt(unsigned int index) const { return (*this)[index]; }
+  void setCharAt(unsigned int index, char c) {
+    if (index < _s.size()) _s[index] = c;
+  }
+
+  bool equals(const String& s) const { return _s == s._s; }
+  bool equals(const char* s) const { return _s == (s ? s : ""); }
+  bool equalsIgnoreCase(const String& s) const {
+    return strcasecmp(_s.c_str(), s.c_str()) == 0;
+  }
+  int compareTo(const String& s) const { return _s.compare(s._s); }
+  bool operator==(const String& s) const { return equals(s); }
+  bool operator==(const char* s) const { return equals(s); }
+  bool operator!=(const String& s) const { return !equals(s); }
+  bool operator!=(const char* s) const { return !equals(s); }
+  bool operator<(const String& s) const { return _s < s._s; }
+  bool startsWith(const String& s, unsigned int offset = 0) const {
+    return _s.size() >= offset + s._s.size() &&
+           _s.compare(offset, s._s.size(), s._s) == 0;
+  }
+  bool endsWith(const String& s) const {
+    return _s.size() >= s._s.size() &&
+           _s.compare(_s.size() - s._s.size(), s._s.size(), s._s) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const {
+    return toIndex(_s.find(c, from));
+  }
+  int indexOf(const String& s, unsigned int from = 0) const {
+    return toIndex(_s.find(s._s, from));
+  }
+  int indexOf(const char* s, unsigned int from = 0) const {
+    return toIndex(_s.find(s, from));
+  }
+  int lastIndexOf(char c) const { return toIndex(_s.rfind(c)); }
+  int lastIndexOf(char c, unsigned int from) const {
+    return toIndex(_s.rfind(c, from));
+  }
+  int lastIndexOf(const String& s) const { return toIndex(_s.rfind(s._s)); }
+  String substring(unsigned int from) const {
+    return from < _s.size() ? String(_s.substr(from)) : String();
+  }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+      unsigned int tmp = from;
+      from = to;
+      to = tmp;
+    }
+    if (from >= _s.size()) {
+      return String();
+    }
+    return String(_s.substr(from, to - from));
+  }
+
+  void replace(char from, char to) {
+    for (char& c : _s) {
+      if (c == from) c = to;
+    }
+  }
+  void replace(const String& from, const String& to) {
+    if (from._s.empty()) return;
+    size_t pos = 0;
+    while ((pos = _s.find(from._s, pos)) != std::string::npos) {
+      _s.replace(pos, from._s.size(), to._s);
+      pos += to._s.size();
+    }
+  }
+  void remove(unsigned int index) {
+    if (index < _s.size()) _s.erase(index);
+  }
+  void remove(unsigned int index, unsigned int count) {
+    if (index < _s.size()) _s.erase(index, count);
+  }
+  void toLowerCase() {
+    for (char& c : _s) c = tolower((unsigned char)c);
+  }
+  void toUpperCase() {
+    for (char& c : _s) c = toupper((unsigned char)c);
+  }
+  void trim() {
+    size_t first = _s.find_first_not_of(" \t\r\n\v\f");
+    if (first == std::string::npos) {
+      _s.clear();
+      return;
+    }
+    size_t last = _s.find_last_not_of(" \t\r\n\v\f");
+    _s = _s.substr(first, last - first + 1);
+  }
+  long toInt() const { return atol(_s.c_str()); }
+  float toFloat() const { return atof(_s.c_str()); }
+  double toDouble() const { return atof(_s.c_str()); }
+  void toCharArray(char* buf, unsigned int size,
+                   unsigned int index = 0) const {
+    getBytes((unsigned char*)buf, size, index);
+  }
+  void getBytes(unsigned char* buf, unsigned int size,
+                unsigned int index = 0) const {
+    if (!size || !buf) return;
+    size_t n = index < _s.size() ? _s.size() - index : 0;
+    if (n > size - 1) n = size - 1;
+    memcpy(buf, _s.c_str() + (index < _s.size() ? index : 0), n);
+    buf[n] = 0;
+  }
+
+  friend String operator+(const String& a, const String& b) {
+    return String(a._s + b._s);
+  }
+  friend String operator+(const String& a, const char* b) {
+    return String(a._s + (b ? b : ""));
+  }
+  friend String operator+(const char* a, const String& b) {
+    return String((a ? a : "") + b._s);
+  }
+  friend String operator+(const String& a, char b) {
+    return String(a._s + b);
+  }
+  template <typename T>
+  friend String operator+(const String& a, T b) {
+    return a + String(b);
+  }
+
+ private:
+  static int toIndex(size_t pos) {
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+  void fromLong(long long v, unsigned char base) {
+    if (v < 0 && base == 10) {
+      _s = "-";
+      fromULong((unsigned long long)(-v), base, true);
+    } else {
+      fromULong((unsigned long long)v, base);
+    }
+  }
+  void fromULong(unsigned long long v, unsigned char base,
+                 bool append = false) {
+    char buf[72];
+    int pos = sizeof(buf) - 1;
+    buf[pos] = 0;
+    do {
+      int digit = v % base;
+      buf[--pos] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+      v /= base;
+    } while (v);
+    if (append) {
+      _s += &buf[pos];
+    } else {
+      _s = &buf[pos];
+    }
+  }
+  void fromDouble(double v, unsigned int decimals) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    _s = buf;
+  }
+  std::string _s;
+};
+
+#endif  // _NATIVE_WSTRING_H
@@ -0,0 +1,11 @@
+// Host build has no network, ESP3D network features must be disabled
+#ifndef _NATIVE_WIFI_H
+#define _NATIVE_WIFI_H
+
+#include <Arduino.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#endif  // _NATIVE_WIFI_H
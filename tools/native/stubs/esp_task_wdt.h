@@ -0,0 +1,16 @@
+// Host version of task watchdog: nothing to feed
+#ifndef _NATIVE_ESP_TASK_WDT_H
+#define _NATIVE_ESP_TASK_WDT_H
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+inline esp_err_t esp_task_wdt_reset() { return ESP_OK; }
+inline esp_err_t esp_task_wdt_add(TaskHandle_t) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_delete(TaskHandle_t) { return ESP_OK; }
+
+#endif  // _NATIVE_ESP_TASK_WDT_H
@@ -0,0 +1,20 @@
+// Host version of FreeRTOS tasks
+#ifndef _NATIVE_TASK_H
+#define _NATIVE_TASK_H
+
+#include "FreeRTOS.h"
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name,
+                                   uint32_t stackSize, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name,
+                       uint32_t stackSize, void* param, UBaseType_t priority,
+                       TaskHandle_t* handle);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+TickType_t xTaskGetTickCount();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+#endif  // _NATIVE_TASK_H
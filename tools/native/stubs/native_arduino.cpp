@@ -0,0 +1,319 @@
+// Host implementation of Arduino core, FreeRTOS and EEPROM stubs
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <base64.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+static const std::chrono::steady_clock::time_point bootTime =
+    std::chrono::steady_clock::now();
+
+uint32_t millis() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - bootTime)
+      .count();
+}
+
+uint32_t micros() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - bootTime)
+      .count();
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield() { std::this_thread::yield(); }
+
+static std::minstd_rand randomGenerator;
+
+void randomSeed(unsigned long seed) { randomGenerator.seed(seed); }
+
+long random(long max) { return max > 0 ? randomGenerator() % max : 0; }
+
+long random(long min, long max) {
+  return max > min ? min + random(max - min) : min;
+}
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return LOW; }
+int analogRead(uint8_t) { return 0; }
+
+EspClass ESP;
+
+void EspClass::restart() {
+  fprintf(stderr, "ESP restart requested\n");
+  exit(0);
+}
+
+EEPROMClass EEPROM;
+
+String base64::encode(const uint8_t* data, size_t length) {
+  static const char table[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  String res;
+  for (size_t i = 0; i < length; i += 3) {
+    uint32_t n = data[i] << 16;
+    if (i + 1 < length) n |= data[i + 1] << 8;
+    if (i + 2 < length) n |= data[i + 2];
+    res += table[(n >> 18) & 0x3F];
+    res += table[(n >> 12) & 0x3F];
+    res += i + 1 < length ? table[(n >> 6) & 0x3F] : '=';
+    res += i + 2 < length ? table[n & 0x3F] : '=';
+  }
+  return res;
+}
+
+// FreeRTOS
+
+struct NativeMutex {
+  std::timed_mutex mutex;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new NativeMutex(); }
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+  return new NativeMutex();
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) {
+  delete static_cast<NativeMutex*>(sem);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+  NativeMutex* m = static_cast<NativeMutex*>(sem);
+  if (!m) {
+    return pdFALSE;
+  }
+  if (ticks == portMAX_DELAY) {
+    m->mutex.lock();
+    return pdTRUE;
+  }
+  return m->mutex.try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE
+                                                                 : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+  NativeMutex* m = static_cast<NativeMutex*>(sem);
+  if (!m) {
+    return pdFALSE;
+  }
+  m->mutex.unlock();
+  return pdTRUE;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char*, uint32_t,
+                                   void* param, UBaseType_t,
+                                   TaskHandle_t* handle, BaseType_t) {
+  std::thread* t = new std::thread(task, param);
+  t->detach();
+  if (handle) {
+    *handle = t;
+  }
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name,
+                       uint32_t stackSize, void* param, UBaseType_t priority,
+                       TaskHandle_t* handle) {
+  return xTaskCreatePinnedToCore(task, name, stackSize, param, priority,
+                                 handle, tskNO_AFFINITY);
+}
+
+// Detached threads end by themselves, a task deleting itself just returns
+void vTaskDelete(TaskHandle_t) {}
+
+void vTaskDelay(TickType_t ticks) {
+  if (ticks == 0) {
+    std::this_thread::yield();
+  } else {
+    delay(ticks);
+  }
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  static thread_local int id;
+  return &id;
+}
+
+TickType_t xTaskGetTickCount() { return millis(); }
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 0; }
+
+// Serial ports
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+void HardwareSerial::begin(unsigned long baud, uint32_t, int8_t, int8_t) {
+  _baud = baud;
+  if (_running) {
+    return;
+  }
+  _running = true;
+  _thread = std::thread(&HardwareSerial::rxTask, this);
+  if (_fd != -1) {
+    _fdThread = std::thread(&HardwareSerial::fdTask, this);
+  }
+}
+
+void HardwareSerial::end() {
+  if (!_running) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(_rxMutex);
+    _running = false;
+  }
+  _rxEvent.notify_all();
+  if (_thread.joinable()) {
+    _thread.join();
+  }
+  if (_fdThread.joinable()) {
+    _fdThread.join();
+  }
+}
+
+void HardwareSerial::onReceive(OnReceiveCb cb, bool) { _onReceive = cb; }
+
+void HardwareSerial::attach(int fd) { _fd = fd; }
+
+int HardwareSerial::available() {
+  size_t count;
+  {
+    std::lock_guard<std::mutex> lock(_rxMutex);
+    count = _rxCount;
+  }
+  // receive callback polls until idle timeout, leave cpu to main loop
+  if (count == 0) {
+    std::this_thread::yield();
+  }
+  return count;
+}
+
+int HardwareSerial::availableForWrite() { return _txSize; }
+
+int HardwareSerial::read() {
+  std::lock_guard<std::mutex> lock(_rxMutex);
+  if (_rxCount == 0) {
+    return -1;
+  }
+  int c = _rx[_rxHead];
+  _rxHead = (_rxHead + 1) % NATIVE_SERIAL_RX_SIZE;
+  _rxCount--;
+  _rxEvent.notify_all();
+  return c;
+}
+
+int HardwareSerial::peek() {
+  std::lock_guard<std::mutex> lock(_rxMutex);
+  return _rxCount == 0 ? -1 : _rx[_rxHead];
+}
+
+size_t HardwareSerial::readBytes(uint8_t* buffer, size_t length) {
+  size_t n = 0;
+  int c;
+  while (n < length && (c = read()) != -1) {
+    buffer[n++] = c;
+  }
+  return n;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  std::lock_guard<std::mutex> lock(_txMutex);
+  _txBytes += size;
+  if (_fd != -1) {
+    size_t done = 0;
+    while (done < size) {
+      ssize_t n = ::write(_fd, buffer + done, size - done);
+      if (n < 0) {
+        if (errno == EAGAIN || errno == EINTR) {
+          continue;
+        }
+        break;
+      }
+      done += n;
+    }
+    return done;
+  }
+  if (_onTransmit) {
+    _onTransmit(buffer, size);
+  }
+  return size;
+}
+
+size_t HardwareSerial::printf(const char* format, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (len < 0) {
+    return 0;
+  }
+  return write((const uint8_t*)buffer,
+               (size_t)len < sizeof(buffer) ? len : sizeof(buffer) - 1);
+}
+
+void HardwareSerial::inject(const uint8_t* data, size_t size) {
+  std::unique_lock<std::mutex> lock(_rxMutex);
+  for (size_t i = 0; i < size; i++) {
+    // like UART with flow control: wait for room
+    _rxEvent.wait(lock, [this] {
+      return _rxCount < NATIVE_SERIAL_RX_SIZE || !_running;
+    });
+    _rx[(_rxHead + _rxCount) % NATIVE_SERIAL_RX_SIZE] = data[i];
+    _rxCount++;
+  }
+  _rxBytes += size;
+  _rxEvent.notify_all();
+}
+
+// UART driver: bytes of attached terminal go to rx buffer while receive
+// callback is running, like UART fifo filled by interrupt
+void HardwareSerial::fdTask() {
+  uint8_t buffer[256];
+  while (_running) {
+    struct pollfd p = {_fd, POLLIN, 0};
+    if (poll(&p, 1, 10) > 0 && (p.revents & POLLIN)) {
+      ssize_t n = ::read(_fd, buffer, sizeof(buffer));
+      if (n > 0) {
+        inject(buffer, n);
+      }
+    }
+  }
+}
+
+// UART event task: call onReceive when bytes are waiting
+void HardwareSerial::rxTask() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(_rxMutex);
+      _rxEvent.wait_for(lock, std::chrono::milliseconds(10), [this] {
+        return _rxCount > 0 || !_running;
+      });
+      if (!_running) {
+        return;
+      }
+      if (_rxCount == 0) {
+        continue;
+      }
+    }
+    if (_onReceive) {
+      _onReceive();
+    }
+  }
+}
@@ -0,0 +1,14 @@
+// tools/native/stubs/Arduino.h plus what arduinoWebSockets needs on ESP32
+#ifndef _WS_BENCH_ARDUINO_H
+#define _WS_BENCH_ARDUINO_H
+
+#include_next <Arduino.h>
+
+#ifndef bit
+#define bit(b) (1UL << (b))
+#endif  // bit
+
+// hardware random register, read for randomSeed() only
+#define READ_PERI_REG(addr) ((uint32_t)millis())
+
+#endif  // _WS_BENCH_ARDUINO_H
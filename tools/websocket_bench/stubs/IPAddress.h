@@ -0,0 +1,23 @@
+// Host stub of Arduino IPAddress
+#ifndef _WS_BENCH_IPADDRESS_H
+#define _WS_BENCH_IPADDRESS_H
+
+#include <Arduino.h>
+
+class IPAddress {
+ public:
+  IPAddress() : _address{0, 0, 0, 0} {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _address{a, b, c, d} {}
+  uint8_t operator[](int index) const { return _address[index]; }
+  String toString() const {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", _address[0], _address[1],
+             _address[2], _address[3]);
+    return String(buffer);
+  }
+
+ private:
+  uint8_t _address[4];
+};
+
+#endif  // _WS_BENCH_IPADDRESS_H
@@ -0,0 +1,66 @@
+// Host WiFiClient / WiFiServer for ws_bench_host.cpp: a client writes to a
+// connected socket, server side is not used
+#ifndef _WS_BENCH_WIFI_H
+#define _WS_BENCH_WIFI_H
+
+#include <Arduino.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "IPAddress.h"
+
+class WiFiClient {
+ public:
+  WiFiClient() : _fd(-1) {}
+  explicit WiFiClient(int fd) : _fd(fd) {}
+  virtual ~WiFiClient() {}
+  virtual uint8_t connected() { return _fd >= 0; }
+  virtual operator bool() { return _fd >= 0; }
+  virtual size_t write(const uint8_t* data, size_t size) {
+    size_t done = 0;
+    while (_fd >= 0 && done < size) {
+      ssize_t sent = send(_fd, data + done, size - done, 0);
+      if (sent <= 0) {
+        break;
+      }
+      done += sent;
+    }
+    return done;
+  }
+  size_t write(const char* data) { return write((const uint8_t*)data, strlen(data)); }
+  size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  virtual int read(uint8_t*, size_t) { return -1; }
+  size_t readBytes(uint8_t*, size_t) { return 0; }
+  String readStringUntil(char) { return String(); }
+  virtual void flush() {}
+  virtual void stop() {
+    if (_fd >= 0) {
+      shutdown(_fd, SHUT_WR);
+      close(_fd);
+    }
+    _fd = -1;
+  }
+  int setNoDelay(bool) { return 0; }
+  int setTimeout(uint32_t) { return 0; }
+  IPAddress remoteIP() { return IPAddress(127, 0, 0, 1); }
+  uint16_t remotePort() { return 0; }
+
+ private:
+  int _fd;
+};
+
+class WiFiServer {
+ public:
+  WiFiServer(uint16_t port = 80, uint8_t = 4) { (void)port; }
+  void begin() {}
+  void end() {}
+  void close() {}
+  bool hasClient() { return false; }
+  WiFiClient available() { return WiFiClient(); }
+  WiFiClient accept() { return WiFiClient(); }
+  void setNoDelay(bool) {}
+};
+
+#endif  // _WS_BENCH_WIFI_H
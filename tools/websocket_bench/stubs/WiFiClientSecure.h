@@ -0,0 +1,15 @@
+// Host stub, SSL is not benchmarked
+#ifndef _WS_BENCH_WIFI_CLIENT_SECURE_H
+#define _WS_BENCH_WIFI_CLIENT_SECURE_H
+
+#include "WiFi.h"
+
+class WiFiClientSecure : public WiFiClient {
+ public:
+  void setCACert(const char*) {}
+  void setCertificate(const char*) {}
+  void setPrivateKey(const char*) {}
+  void setInsecure() {}
+};
+
+#endif  // _WS_BENCH_WIFI_CLIENT_SECURE_H
@@ -0,0 +1 @@
+// Host stub, ESP_IDF_VERSION_MAJOR is not defined so hwcrypto/sha.h is used
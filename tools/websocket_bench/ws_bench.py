@@ -0,0 +1,52 @@
+#!/usr/bin/python
+# Build ws_bench_host.cpp with WebSockets.cpp and WebSocketsServer.cpp of
+# libraries/arduinoWebSockets as for ESP32, then run it
+# Network and Arduino parts come from stubs/ and ../native/stubs/
+# Usage: ws_bench.py [clients] [frames] [frame size] [runs]
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+LIBRARY = os.path.join(ROOT, "..", "..", "libraries", "arduinoWebSockets-2.6.1",
+                       "src")
+NATIVE_STUBS = os.path.join(ROOT, "..", "native", "stubs")
+
+
+def build(tmp):
+    exe = os.path.join(tmp, "ws_bench_host")
+    cc = os.environ.get("CC", "gcc")
+    cxx = os.environ.get("CXX", "g++")
+    # libb64 is C, only used by handshake
+    objects = []
+    for name in ["cencode.c", "cdecode.c"]:
+        objects.append(os.path.join(tmp, name + ".o"))
+        subprocess.check_call([cc, "-O2", "-c",
+                               os.path.join(LIBRARY, "libb64", name),
+                               "-o", objects[-1]])
+    subprocess.check_call([cxx, "-O2", "-std=gnu++17", "-pthread",
+                           "-DESP32", "-DNODEBUG_WEBSOCKETS",
+                           "-I", os.path.join(ROOT, "stubs"),
+                           "-I", NATIVE_STUBS,
+                           "-I", LIBRARY,
+                           os.path.join(ROOT, "ws_bench_host.cpp"),
+                           os.path.join(LIBRARY, "WebSockets.cpp"),
+                           os.path.join(LIBRARY, "WebSocketsServer.cpp"),
+                           os.path.join(NATIVE_STUBS, "native_arduino.cpp")]
+                          + objects + ["-o", exe])
+    return exe
+
+
+def main():
+    tmp = tempfile.mkdtemp()
+    try:
+        exe = build(tmp)
+        result = subprocess.call([exe] + sys.argv[1:])
+    finally:
+        shutil.rmtree(tmp)
+    sys.exit(result)
+
+
+main()
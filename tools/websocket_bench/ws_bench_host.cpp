@@ -0,0 +1,266 @@
+// Host benchmark for WebSocket changes of libraries/arduinoWebSockets
+// - websocketsMask (WebSocketsMask.h) is checked against byte by byte XOR
+//   and both are timed
+// - WebSocketsServerCore of the library (built for ESP32) broadcasts frames
+//   of WebSocket_Server::flushTXbuffer to loopback TCP clients with:
+//   sendBIN per client (old broadcastBIN), broadcastBIN without reserved
+//   header room, broadcastBIN with reserved header room as ESP3D does
+// Each measure is repeated, median, min, max and standard deviation of runs
+// are reported
+// Build and run: ws_bench.py [clients] [frames] [frame size] [runs]
+// Usage: ws_bench_host <clients> <frames> <frame size> <runs>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "WebSocketsMask.h"
+#include "WebSocketsServer.h"
+
+// tools/native/native_main.cpp is not linked, heap is not tracked here
+uint32_t EspClass::getFreeHeap() { return 200000; }
+
+static double now() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct Stats {
+  std::vector<double> values;
+
+  void add(double value) { values.push_back(value); }
+
+  void print(const char* unit) {
+    std::vector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    size_t count = sorted.size();
+    double median = count % 2 ? sorted[count / 2]
+                              : (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+    double mean = 0;
+    for (double value : sorted) {
+      mean += value;
+    }
+    mean /= count;
+    double variance = 0;
+    for (double value : sorted) {
+      variance += (value - mean) * (value - mean);
+    }
+    double stddev = count > 1 ? sqrt(variance / (count - 1)) : 0;
+    printf("median %9.1f %s, min %9.1f, max %9.1f, stddev %7.1f (%4.1f%%)\n",
+           median, unit, sorted[0], sorted[count - 1], stddev,
+           mean > 0 ? 100.0 * stddev / mean : 0);
+  }
+};
+
+static void maskBytes(uint8_t* data, size_t length, const uint8_t* maskKey) {
+  for (size_t i = 0; i < length; i++) {
+    data[i] = (data[i] ^ maskKey[i % 4]);
+  }
+}
+
+static bool checkMask() {
+  uint8_t data[160], expected[160];
+  for (size_t offset = 0; offset < 4; offset++) {
+    for (size_t length = 0; length < 150; length++) {
+      uint8_t key[4] = {(uint8_t)rand(), (uint8_t)rand(), (uint8_t)rand(),
+                        (uint8_t)rand()};
+      for (size_t i = 0; i < length; i++) {
+        data[offset + i] = expected[i] = (uint8_t)rand();
+      }
+      websocketsMask(data + offset, length, key);
+      maskBytes(expected, length, key);
+      if (memcmp(data + offset, expected, length) != 0) {
+        printf("mask error: offset %zu length %zu\n", offset, length);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// MB/s of mask function on payloads of size
+template <typename F>
+static double maskSpeed(F mask, size_t size) {
+  std::vector<uint8_t> data(size + 1);
+  uint8_t key[4] = {0x12, 0x34, 0x56, 0x78};
+  size_t loops = (16 << 20) / size + 1;
+  double start = now();
+  for (size_t i = 0; i < loops; i++) {
+    // payload of arduinoWebSockets is malloc'ed, so it is aligned
+    mask(data.data(), size, key);
+  }
+  double seconds = now() - start;
+  volatile uint8_t sink = data[size / 2];
+  (void)sink;
+  return (double)size * loops / seconds / (1 << 20);
+}
+
+// Server side of each connection is given to the library as WiFiClient,
+// client side is read by a thread
+struct Loopback {
+  std::vector<int> servers;
+  std::vector<std::thread> readers;
+  std::atomic<size_t> received{0};
+
+  bool open(int clients) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(listener, clients) != 0 ||
+        getsockname(listener, (sockaddr*)&addr, &len) != 0) {
+      close(listener);
+      return false;
+    }
+    for (int i = 0; i < clients; i++) {
+      int client = socket(AF_INET, SOCK_STREAM, 0);
+      if (connect(client, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(client);
+        close(listener);
+        return false;
+      }
+      // same as WiFiClient of ESP32 core: Nagle enabled
+      servers.push_back(accept(listener, nullptr, nullptr));
+      readers.emplace_back([this, client]() {
+        uint8_t buffer[16384];
+        ssize_t size;
+        while ((size = recv(client, buffer, sizeof(buffer), 0)) > 0) {
+          received += size;
+        }
+        close(client);
+      });
+    }
+    close(listener);
+    return true;
+  }
+
+  void join() {
+    for (std::thread& t : readers) {
+      t.join();
+    }
+  }
+};
+
+class BenchServer : public WebSocketsServerCore {
+ public:
+  // Connected clients as after handshake, closed by library on close()
+  void attach(const std::vector<int>& fds) {
+    for (size_t i = 0; i < fds.size(); i++) {
+      _clients[i].num = i;
+      _clients[i].tcp = new WiFiClient(fds[i]);
+      _clients[i].status = WSC_CONNECTED;
+    }
+  }
+};
+
+enum BroadcastMode { sendPerClient, broadcastCopy, broadcastReserved };
+
+static const char* modeNames[] = {"sendBIN per client", "broadcastBIN copy",
+                                  "broadcastBIN reserved"};
+
+// frames/s of one run, false if frames were not all received
+static bool broadcastRun(BroadcastMode mode, int clients, int frames,
+                         size_t size, double& framesPerSecond) {
+  Loopback lb;
+  if (!lb.open(clients)) {
+    printf("cannot open loopback clients\n");
+    return false;
+  }
+  std::vector<uint8_t> buffer(WEBSOCKETS_MAX_HEADER_SIZE + size, 'a');
+  uint8_t* payload = buffer.data() + WEBSOCKETS_MAX_HEADER_SIZE;
+  bool success = true;
+  double seconds;
+  {
+    BenchServer server;
+    server.attach(lb.servers);
+    double start = now();
+    for (int f = 0; f < frames && success; f++) {
+      switch (mode) {
+        case sendPerClient:
+          for (int i = 0; i < clients; i++) {
+            success = server.sendBIN(i, payload, size) && success;
+          }
+          break;
+        case broadcastCopy:
+          success = server.broadcastBIN(payload, size, false);
+          break;
+        case broadcastReserved:
+          success = server.broadcastBIN(buffer.data(), size, true);
+          break;
+      }
+    }
+    seconds = now() - start;
+    server.close();
+  }
+  lb.join();
+  size_t headerSize = size < 126 ? 2 : (size < 65536 ? 4 : 10);
+  // close() sends a close frame with status code to each client
+  size_t expected = ((size + headerSize) * frames + 4) * clients;
+  if (!success || lb.received != expected) {
+    printf("%s: %zu bytes received, %zu expected\n", modeNames[mode],
+           (size_t)lb.received, expected);
+    return false;
+  }
+  framesPerSecond = frames / seconds;
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int clients = argc > 1 ? atoi(argv[1]) : 4;
+  int frames = argc > 2 ? atoi(argv[2]) : 20000;
+  size_t size = argc > 3 ? atoi(argv[3]) : 1200;
+  int runs = argc > 4 ? atoi(argv[4]) : 7;
+  if (clients < 1 || clients > WEBSOCKETS_SERVER_CLIENT_MAX || frames < 1 ||
+      runs < 1) {
+    printf("clients must be 1 to %d, frames and runs at least 1\n",
+           WEBSOCKETS_SERVER_CLIENT_MAX);
+    return 1;
+  }
+  if (!checkMask()) {
+    return 1;
+  }
+  printf("mask: ok\n");
+  for (size_t s : {(size_t)64, (size_t)1200, (size_t)65536}) {
+    Stats bytewise, word;
+    for (int r = 0; r < runs; r++) {
+      bytewise.add(maskSpeed(maskBytes, s));
+      word.add(maskSpeed(websocketsMask, s));
+    }
+    printf("mask %6zu bytes, byte:  ", s);
+    bytewise.print("MB/s");
+    printf("mask %6zu bytes, word:  ", s);
+    word.print("MB/s");
+  }
+  printf("broadcast %d clients x %d frames of %zu bytes, %d runs\n", clients,
+         frames, size, runs);
+  Stats stats[3];
+  // modes are interleaved so drift of the host is spread on all of them
+  for (int r = 0; r < runs; r++) {
+    for (int mode = sendPerClient; mode <= broadcastReserved; mode++) {
+      double framesPerSecond;
+      if (!broadcastRun((BroadcastMode)mode, clients, frames, size,
+                        framesPerSecond)) {
+        return 1;
+      }
+      stats[mode].add(framesPerSecond);
+    }
+  }
+  for (int mode = sendPerClient; mode <= broadcastReserved; mode++) {
+    printf("%-22s ", modeNames[mode]);
+    stats[mode].print("frames/s");
+  }
+  return 0;
+}